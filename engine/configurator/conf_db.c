@@ -151,6 +151,470 @@ static cfg_orphan *orphaned_objects;
  */
 static cfg_object *topological_order;
 
+/** Minimum size of the children lookup hash tables (power of 2) */
+#define CFG_HASH_SIZE_MIN   256
+
+/** Size of the OID string to handle cache (power of 2) */
+#define CFG_OID_CACHE_SIZE  1024
+
+/**
+ * Children lookup hash table of objects: objects are hashed by
+ * father and own sub-identifier.
+ */
+static cfg_object **cfg_obj_hash = NULL;
+static unsigned int cfg_obj_hash_size = 0;  /**< Number of buckets */
+static unsigned int cfg_obj_hash_num = 0;   /**< Number of objects */
+
+/**
+ * Children lookup hash table of instances: instances are hashed by
+ * father, object and own name.
+ */
+static cfg_instance **cfg_inst_hash = NULL;
+static unsigned int cfg_inst_hash_size = 0; /**< Number of buckets */
+static unsigned int cfg_inst_hash_num = 0;  /**< Number of instances */
+
+/** Entry of the OID string to handle cache */
+typedef struct cfg_oid_cache_entry {
+    char           *oid;    /**< OID string */
+    cfg_handle      handle; /**< Handle of the object or instance */
+    unsigned int    gen;    /**< Database generation the entry is
+                                 valid for */
+} cfg_oid_cache_entry;
+
+/** OID string to handle cache */
+static cfg_oid_cache_entry cfg_oid_cache[CFG_OID_CACHE_SIZE];
+
+/**
+ * Database generation: it is incremented when objects or instances
+ * are added or deleted, so that all OID cache entries become stale.
+ */
+static unsigned int cfg_db_gen = 1;
+
+/**
+ * Calculate hash of a child in the objects or instances tree.
+ *
+ * @param father    Father object or instance
+ * @param obj       Object of the instance or @c NULL
+ * @param name      Object sub-identifier or instance name
+ *
+ * @return Hash value.
+ */
+static unsigned int
+cfg_db_hash(const void *father, const void *obj, const char *name)
+{
+    uint32_t hash = 2166136261U;
+
+    hash = (hash ^ (uint32_t)((uintptr_t)father >> 4)) * 16777619U;
+    hash = (hash ^ (uint32_t)((uintptr_t)obj >> 4)) * 16777619U;
+    for (; *name != '\0'; name++)
+        hash = (hash ^ (uint8_t)*name) * 16777619U;
+
+    return hash;
+}
+
+/**
+ * Insert the object into the children lookup hash table.
+ *
+ * @param obj       Object with father
+ */
+static void
+cfg_obj_hash_insert(cfg_object *obj)
+{
+    unsigned int bucket;
+
+    bucket = cfg_db_hash(obj->father, NULL, obj->subid) &
+             (cfg_obj_hash_size - 1);
+    obj->hash_next = cfg_obj_hash[bucket];
+    cfg_obj_hash[bucket] = obj;
+    cfg_obj_hash_num++;
+}
+
+/**
+ * Rebuild the children lookup hash table of objects from the pool
+ * of objects.
+ *
+ * @param size      Number of buckets (power of 2)
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_obj_hash_rebuild(unsigned int size)
+{
+    cfg_object    **hash = calloc(size, sizeof(*hash));
+    int             i;
+
+    if (hash == NULL)
+        return TE_ENOMEM;
+
+    free(cfg_obj_hash);
+    cfg_obj_hash = hash;
+    cfg_obj_hash_size = size;
+    cfg_obj_hash_num = 0;
+
+    for (i = 0; i < cfg_all_obj_size; i++)
+    {
+        if (cfg_all_obj[i] != NULL && cfg_all_obj[i]->father != NULL)
+            cfg_obj_hash_insert(cfg_all_obj[i]);
+    }
+
+    return 0;
+}
+
+/**
+ * Add just linked object to the children lookup hash table.
+ *
+ * @param obj       Object added to the pool and the tree
+ */
+static void
+cfg_obj_hash_add(cfg_object *obj)
+{
+    if (cfg_obj_hash_num >= cfg_obj_hash_size &&
+        cfg_obj_hash_rebuild(MAX(cfg_obj_hash_size * 2,
+                                 CFG_HASH_SIZE_MIN)) == 0)
+    {
+        /* The object is added by the rebuild */
+        return;
+    }
+
+    /* Lookup falls back to brothers traversal without the table */
+    if (cfg_obj_hash != NULL)
+        cfg_obj_hash_insert(obj);
+}
+
+/**
+ * Remove the object from the children lookup hash table.
+ *
+ * @param obj       Object which is still linked to its father
+ */
+static void
+cfg_obj_hash_del(cfg_object *obj)
+{
+    cfg_object **p;
+
+    if (cfg_obj_hash == NULL)
+        return;
+
+    p = &cfg_obj_hash[cfg_db_hash(obj->father, NULL, obj->subid) &
+                      (cfg_obj_hash_size - 1)];
+    for (; *p != NULL; p = &(*p)->hash_next)
+    {
+        if (*p == obj)
+        {
+            *p = obj->hash_next;
+            obj->hash_next = NULL;
+            cfg_obj_hash_num--;
+            break;
+        }
+    }
+}
+
+/**
+ * Find a son of the object by its sub-identifier.
+ *
+ * @param father    Father object
+ * @param subid     Sub-identifier of the son
+ *
+ * @return Object or @c NULL.
+ */
+static cfg_object *
+cfg_obj_find_son(const cfg_object *father, const char *subid)
+{
+    cfg_object *obj;
+
+    if (cfg_obj_hash == NULL)
+    {
+        for (obj = father->son;
+             obj != NULL && strcmp(obj->subid, subid) != 0;
+             obj = obj->brother);
+
+        return obj;
+    }
+
+    for (obj = cfg_obj_hash[cfg_db_hash(father, NULL, subid) &
+                            (cfg_obj_hash_size - 1)];
+         obj != NULL &&
+         (obj->father != father || strcmp(obj->subid, subid) != 0);
+         obj = obj->hash_next);
+
+    return obj;
+}
+
+/**
+ * Insert the instance into the children lookup hash table.
+ *
+ * @param inst      Instance with father
+ */
+static void
+cfg_inst_hash_insert(cfg_instance *inst)
+{
+    unsigned int bucket;
+
+    bucket = cfg_db_hash(inst->father, inst->obj, inst->name) &
+             (cfg_inst_hash_size - 1);
+    inst->hash_next = cfg_inst_hash[bucket];
+    cfg_inst_hash[bucket] = inst;
+    cfg_inst_hash_num++;
+}
+
+/**
+ * Rebuild the children lookup hash table of instances from the pool
+ * of instances.
+ *
+ * @param size      Number of buckets (power of 2)
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_inst_hash_rebuild(unsigned int size)
+{
+    cfg_instance  **hash = calloc(size, sizeof(*hash));
+    int             i;
+
+    if (hash == NULL)
+        return TE_ENOMEM;
+
+    free(cfg_inst_hash);
+    cfg_inst_hash = hash;
+    cfg_inst_hash_size = size;
+    cfg_inst_hash_num = 0;
+
+    for (i = 0; i < cfg_all_inst_size; i++)
+    {
+        if (cfg_all_inst[i] != NULL && cfg_all_inst[i]->father != NULL)
+            cfg_inst_hash_insert(cfg_all_inst[i]);
+    }
+
+    return 0;
+}
+
+/**
+ * Add just linked instance to the children lookup hash table.
+ *
+ * @param inst      Instance added to the pool and the tree
+ */
+static void
+cfg_inst_hash_add(cfg_instance *inst)
+{
+    if (cfg_inst_hash_num >= cfg_inst_hash_size &&
+        cfg_inst_hash_rebuild(MAX(cfg_inst_hash_size * 2,
+                                  CFG_HASH_SIZE_MIN)) == 0)
+    {
+        /* The instance is added by the rebuild */
+        return;
+    }
+
+    /* Lookup falls back to brothers traversal without the table */
+    if (cfg_inst_hash != NULL)
+        cfg_inst_hash_insert(inst);
+}
+
+/**
+ * Remove the instance from the children lookup hash table.
+ *
+ * @param inst      Instance which is still linked to its father
+ */
+static void
+cfg_inst_hash_del(cfg_instance *inst)
+{
+    cfg_instance **p;
+
+    if (cfg_inst_hash == NULL)
+        return;
+
+    p = &cfg_inst_hash[cfg_db_hash(inst->father, inst->obj, inst->name) &
+                       (cfg_inst_hash_size - 1)];
+    for (; *p != NULL; p = &(*p)->hash_next)
+    {
+        if (*p == inst)
+        {
+            *p = inst->hash_next;
+            inst->hash_next = NULL;
+            cfg_inst_hash_num--;
+            break;
+        }
+    }
+}
+
+/**
+ * Find a son of the instance by its sub-identifier and name.
+ * Instances scheduled for removal after commit are skipped.
+ *
+ * @param father    Father instance
+ * @param subid     Sub-identifier of the son object
+ * @param name      Name of the son
+ *
+ * @return Instance or @c NULL.
+ */
+static cfg_instance *
+cfg_inst_find_son(const cfg_instance *father, const char *subid,
+                  const char *name)
+{
+    cfg_object     *obj = cfg_obj_find_son(father->obj, subid);
+    cfg_instance   *inst;
+
+    if (obj == NULL)
+        return NULL;
+
+    if (cfg_inst_hash == NULL)
+    {
+        for (inst = father->son;
+             inst != NULL &&
+             (inst->obj != obj || strcmp(inst->name, name) != 0 ||
+              inst->remove);
+             inst = inst->brother);
+
+        return inst;
+    }
+
+    for (inst = cfg_inst_hash[cfg_db_hash(father, obj, name) &
+                              (cfg_inst_hash_size - 1)];
+         inst != NULL &&
+         (inst->father != father || inst->obj != obj ||
+          strcmp(inst->name, name) != 0 || inst->remove);
+         inst = inst->hash_next);
+
+    return inst;
+}
+
+/**
+ * Find the root instance matching the first OID element.
+ *
+ * @param ids       Instance OID elements
+ *
+ * @return Root instance or @c NULL.
+ */
+static cfg_instance *
+cfg_inst_find_root(const cfg_inst_subid *ids)
+{
+    if (strcmp(cfg_inst_root.obj->subid, ids->subid) != 0 ||
+        strcmp(cfg_inst_root.name, ids->name) != 0 ||
+        cfg_inst_root.remove)
+    {
+        return NULL;
+    }
+
+    return &cfg_inst_root;
+}
+
+/**
+ * Make all entries of the OID string to handle cache stale.
+ */
+static void
+cfg_oid_cache_flush(void)
+{
+    cfg_db_gen++;
+}
+
+/**
+ * Get slot of the OID string to handle cache.
+ *
+ * @param oid_s     OID string
+ *
+ * @return Cache entry.
+ */
+static cfg_oid_cache_entry *
+cfg_oid_cache_slot(const char *oid_s)
+{
+    return &cfg_oid_cache[cfg_db_hash(NULL, NULL, oid_s) &
+                          (CFG_OID_CACHE_SIZE - 1)];
+}
+
+/**
+ * Look up the OID string in the cache.
+ *
+ * @param oid_s     OID string
+ * @param handle    Location for handle of the object or instance
+ *
+ * @return @c TRUE if the valid entry is found.
+ */
+static te_bool
+cfg_oid_cache_get(const char *oid_s, cfg_handle *handle)
+{
+    cfg_oid_cache_entry *entry = cfg_oid_cache_slot(oid_s);
+    cfg_instance        *inst;
+
+    if (entry->gen != cfg_db_gen || entry->oid == NULL ||
+        strcmp(entry->oid, oid_s) != 0)
+    {
+        return FALSE;
+    }
+
+    if (!CFG_IS_INST(entry->handle))
+    {
+        if (!CFG_OBJ_HANDLE_VALID(entry->handle))
+            return FALSE;
+    }
+    else
+    {
+        if (!CFG_INST_HANDLE_VALID(entry->handle))
+            return FALSE;
+
+        /*
+         * Instances may be scheduled for removal without database
+         * modification, such instances are not found by OID.
+         */
+        for (inst = CFG_GET_INST(entry->handle); inst != NULL;
+             inst = inst->father)
+        {
+            if (inst->remove)
+                return FALSE;
+        }
+    }
+
+    *handle = entry->handle;
+    return TRUE;
+}
+
+/**
+ * Remember the handle found by the OID string.
+ *
+ * @param oid_s     OID string
+ * @param handle    Handle of the object or instance
+ */
+static void
+cfg_oid_cache_put(const char *oid_s, cfg_handle handle)
+{
+    cfg_oid_cache_entry *entry = cfg_oid_cache_slot(oid_s);
+
+    if (entry->oid == NULL || strcmp(entry->oid, oid_s) != 0)
+    {
+        char *oid = strdup(oid_s);
+
+        if (oid == NULL)
+            return;
+
+        free(entry->oid);
+        entry->oid = oid;
+    }
+
+    entry->handle = handle;
+    entry->gen = cfg_db_gen;
+}
+
+/**
+ * Release children lookup hash tables and OID string cache.
+ */
+static void
+cfg_db_hash_destroy(void)
+{
+    unsigned int i;
+
+    free(cfg_obj_hash);
+    cfg_obj_hash = NULL;
+    cfg_obj_hash_size = cfg_obj_hash_num = 0;
+
+    free(cfg_inst_hash);
+    cfg_inst_hash = NULL;
+    cfg_inst_hash_size = cfg_inst_hash_num = 0;
+
+    for (i = 0; i < CFG_OID_CACHE_SIZE; i++)
+    {
+        free(cfg_oid_cache[i].oid);
+        cfg_oid_cache[i].oid = NULL;
+    }
+    cfg_oid_cache_flush();
+}
+
 static te_errno
 get_value_for_substitution(const char *oid, char **value)
 {
@@ -466,6 +930,8 @@ cfg_destroy_deps(cfg_dependency *deps)
 int
 cfg_db_init(void)
 {
+    te_errno rc;
+
     cfg_db_destroy();
     if ((cfg_all_obj = (cfg_object **)calloc(CFG_OBJ_NUM,
                                              sizeof(void *))) == NULL)
@@ -506,7 +972,18 @@ cfg_db_init(void)
     cfg_create_dep(&cfg_obj_agent_rsrc, &cfg_obj_agent_rsrc_fallback_shared,
                    TRUE);
 
-    return cfg_ta_add_agent_instances();
+    rc = cfg_ta_add_agent_instances();
+    if (rc != 0)
+        return rc;
+
+    /*
+     * Lookup tables are optional: if they cannot be allocated,
+     * brothers lists are traversed.
+     */
+    (void)cfg_obj_hash_rebuild(CFG_HASH_SIZE_MIN);
+    (void)cfg_inst_hash_rebuild(CFG_HASH_SIZE_MIN);
+
+    return 0;
 }
 
 /**
@@ -517,6 +994,8 @@ cfg_db_destroy(void)
 {
     int i;
 
+    cfg_db_hash_destroy();
+
     if (cfg_all_obj == NULL)
         return;
 
@@ -609,18 +1088,14 @@ cfg_process_msg_register(cfg_register_msg *msg)
     }
 
     /* Look for the father first */
-    while (TRUE)
-    {
-       for (;
-            father != NULL &&
-            strcmp(father->subid,
-                   ((cfg_object_subid *)(oid->ids))[i].subid) != 0;
-            father = father->brother);
+    if (strcmp(father->subid,
+               ((cfg_object_subid *)(oid->ids))[i].subid) != 0)
+        father = NULL;
 
-       if (++i == oid->len - 1 || father == NULL)
-           break;
-
-       father = father->son;
+    for (i++; father != NULL && i < oid->len - 1; i++)
+    {
+        father = cfg_obj_find_son(father,
+                                  ((cfg_object_subid *)(oid->ids))[i].subid);
     }
 
     if (father == NULL)
@@ -640,11 +1115,8 @@ cfg_process_msg_register(cfg_register_msg *msg)
     }
 
     /* Check for an obj with the same name */
-    for (obj = father->son;
-         obj != NULL && \
-         strcmp(obj->subid,
-                ((cfg_object_subid *)(oid->ids))[i].subid) != 0;
-         obj = obj->brother);
+    obj = cfg_obj_find_son(father,
+                           ((cfg_object_subid *)(oid->ids))[i].subid);
 
     if (obj != NULL)
     {
@@ -718,6 +1190,8 @@ cfg_process_msg_register(cfg_register_msg *msg)
     cfg_all_obj[i]->son = NULL;
     cfg_all_obj[i]->brother = father->son;
     father->son = cfg_all_obj[i];
+    cfg_obj_hash_add(cfg_all_obj[i]);
+    cfg_oid_cache_flush();
 
     cfg_all_obj[i]->substitution = msg->substitution;
 
@@ -953,6 +1427,8 @@ cfg_db_unregister_obj_by_id_str(char *id,
     }
 
     /* Remove the obj from the obj tree: */
+    cfg_obj_hash_del(obj);
+    cfg_oid_cache_flush();
     father = obj->father;
     if (father->son == obj)
         father->son = obj->brother;
@@ -1142,251 +1618,450 @@ cfg_process_msg_family(cfg_family_msg *msg)
 #undef RET
 }
 
+/** Context of the pattern request processing */
+typedef struct cfg_pattern_msg_ctx {
+    cfg_pattern_msg    *msg;        /**< Original message */
+    cfg_pattern_msg    *tmp;        /**< Message to be answered */
+    unsigned int        num;        /**< Number of handles */
+    unsigned int        num_max;    /**< Maximum number of handles in
+                                         the message */
+} cfg_pattern_msg_ctx;
+
+/* Number of slots in additional allocation chunks */
+#define CFG_PATTERN_ALLOC_STEP  32
+
 /**
- * Process a user request to find all objects or object instances
- * matching a pattern.
+ * Put a handle matching the pattern into the array of handles
+ * of the message.
  *
- * @param msg   message pointer
+ * @param handle    Object or instance handle
+ * @param opaque    Pattern request context
  *
- * @return message pointer of pointer to newly allocated message if the
- *         resulting message length > CFG_BUF_LEN
+ * @return Status code.
  */
-cfg_pattern_msg *
-cfg_process_msg_pattern(cfg_pattern_msg *msg)
+static te_errno
+cfg_pattern_msg_put(cfg_handle handle, void *opaque)
 {
-    cfg_pattern_msg *tmp = msg;
+    cfg_pattern_msg_ctx *ctx = opaque;
 
-    int num_max = (CFG_BUF_LEN - sizeof(*msg)) / sizeof(cfg_handle);
-    int num = 0;
+    if (ctx->num == ctx->num_max)
+    {
+        void *tmp;
 
-    cfg_handle *matches = NULL;
-    int         nof_matches;
-    te_errno    rc;
-
-/* Number of slots in additional allocation chunks */
-#define ALLOC_STEP  32
+        ctx->num_max += CFG_PATTERN_ALLOC_STEP;
+        if (ctx->tmp == ctx->msg)
+        {
+            tmp = malloc(sizeof(*ctx->msg) +
+                         ctx->num_max * sizeof(cfg_handle));
+            if (tmp == NULL)
+                return TE_RC(TE_CS, TE_ENOMEM);
 
-/* Put a handle into the array of handles of the message */
-#define PUT_HANDLE(_handle) \
-    do {                                                            \
-        if (num == num_max)                                         \
-        {                                                           \
-            num_max += ALLOC_STEP;                                  \
-            if (tmp == msg)                                         \
-            {                                                       \
-                tmp = (cfg_pattern_msg *)malloc(sizeof(*msg) +      \
-                    num_max * sizeof(cfg_handle));                  \
-                if (tmp == NULL)                                    \
-                {                                                   \
-                    msg->rc = TE_RC(TE_CS, TE_ENOMEM);              \
-                    return msg;                                     \
-                }                                                   \
-                memcpy(tmp, msg, sizeof(*msg) +                     \
-                    (num_max - ALLOC_STEP) * sizeof(cfg_handle));   \
-            }                                                       \
-            else                                                    \
-            {                                                       \
-                void *tmp1 = realloc(tmp,                           \
-                    sizeof(*msg) + num_max * sizeof(cfg_handle));   \
-                if (tmp1 == NULL)                                   \
-                {                                                   \
-                    free(tmp);                                      \
-                    msg->rc = TE_RC(TE_CS, TE_ENOMEM);              \
-                    return msg;                                     \
-                }                                                   \
-                tmp = (cfg_pattern_msg *)tmp1;                      \
-            }                                                       \
-        }                                                           \
-        tmp->handles[num] = _handle;                                \
-    } while(0)
+            memcpy(tmp, ctx->msg, sizeof(*ctx->msg) +
+                   ctx->num * sizeof(cfg_handle));
+        }
+        else
+        {
+            tmp = realloc(ctx->tmp, sizeof(*ctx->msg) +
+                          ctx->num_max * sizeof(cfg_handle));
+            if (tmp == NULL)
+                return TE_RC(TE_CS, TE_ENOMEM);
+        }
+        ctx->tmp = (cfg_pattern_msg *)tmp;
+    }
+    ctx->tmp->handles[ctx->num++] = handle;
 
-#define RETERR(_rc) \
-    do {                        \
-        if (tmp != msg)         \
-            free(tmp);          \
-        msg->rc = _rc;          \
-        return msg;             \
-    } while (0)
+    return 0;
+}
 
-    rc = cfg_db_find_pattern(msg->pattern, (unsigned int *)&nof_matches,
-                                            &matches);
-    if (rc != 0)
-        RETERR(rc);
+#undef CFG_PATTERN_ALLOC_STEP
 
-    for (num = 0; num < nof_matches; num++)
-        PUT_HANDLE(matches[num]);
+/**
+ * Process a user request to find all objects or object instances
+ * matching a pattern.
+ *
+ * @param msg   message pointer
+ *
+ * @return message pointer of pointer to newly allocated message if the
+ *         resulting message length > CFG_BUF_LEN
+ */
+cfg_pattern_msg *
+cfg_process_msg_pattern(cfg_pattern_msg *msg)
+{
+    cfg_pattern_msg_ctx ctx;
+    te_errno            rc;
 
-    free(matches);
+    ctx.msg = ctx.tmp = msg;
+    ctx.num = 0;
+    ctx.num_max = (CFG_BUF_LEN - sizeof(*msg)) / sizeof(cfg_handle);
 
-    VERB("Found %d OIDs by pattern", num);
-    tmp->len = sizeof(*msg) + sizeof(cfg_handle) * num;
-    return tmp;
+    rc = cfg_db_find_pattern_iter(msg->pattern, cfg_pattern_msg_put, &ctx);
+    if (rc != 0)
+    {
+        if (ctx.tmp != msg)
+            free(ctx.tmp);
+        msg->rc = rc;
+        return msg;
+    }
 
-#undef ALLOC_STEP
-#undef PUT_HANDLE
-#undef RETERR
+    VERB("Found %u OIDs by pattern", ctx.num);
+    ctx.tmp->len = sizeof(*msg) + sizeof(cfg_handle) * ctx.num;
+    return ctx.tmp;
 }   /* cfg_process_msg_pattern() */
 
 /**
- * Find all objects or object instances matching a pattern.
+ * Check whether the sub-identifier or name matches the pattern
+ * element.
  *
- * @param pattern       string object identifier possibly containing '*'
- *                      (see Configurator documentation for details)
- * @param p_nmatches    OUT: number of found objects or object instances
- * @param p_matches     OUT: array of object/(object instance) handles;
- *                      memory for the array is allocated using malloc()
+ * @param pattern   Pattern element
+ * @param str       Sub-identifier or name
  *
- * @return  0 or
- *          TE_EINVAL if a pattern format is incorrect or
- *                    some argument is NULL.
+ * @return @c TRUE if matches.
  */
-te_errno
-cfg_db_find_pattern(const char *pattern,
-                    unsigned int *p_nmatches,
-                    cfg_handle **p_matches)
+static te_bool
+cfg_pattern_elm_match(const char *pattern, const char *str)
 {
-    cfg_handle  *matches = NULL;
-    cfg_handle  *result_matches = NULL;
-    int         nof_matches = 0;
-    cfg_oid     *idsplit = NULL;
-    int         i, k;
+    return pattern[0] == '*' ||
+           pattern_match((char *)pattern, (char *)str) == 0;
+}
 
-    te_bool     all = FALSE;
-    te_bool     inst;
+/**
+ * Find objects matching the pattern in the subtree of an object
+ * which matches the pattern up to the given level.
+ *
+ * @param obj       Object matching the pattern element at @p level
+ * @param ids       Pattern elements
+ * @param level     Level of the object
+ * @param len       Number of pattern elements
+ * @param cb        Callback to be called for each match
+ * @param opaque    Opaque data passed to @p cb
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_pattern_descend_obj(cfg_object *obj, const cfg_object_subid *ids,
+                        int level, int len,
+                        cfg_db_pattern_cb cb, void *opaque)
+{
+    const char *subid;
+    te_errno    rc;
 
-#define RETERR(_rc) \
-    do {                            \
-        if (idsplit)                \
-            cfg_free_oid(idsplit);  \
-        return TE_RC(TE_CS, _rc);   \
-    } while (0)
+    if (level == len - 1)
+        return cb(obj->handle, opaque);
 
-    if (strcmp(pattern, "*") == 0)
+    subid = ids[level + 1].subid;
+
+    /* Jump directly through exact levels */
+    if (strchr(subid, '*') == NULL)
     {
-        all = TRUE;
-        inst = FALSE;
-        RING("pattern: %s, file: %s, line: %d\n",
-             pattern, __FILE__, __LINE__);
+        obj = cfg_obj_find_son(obj, subid);
+        if (obj == NULL)
+            return 0;
+
+        return cfg_pattern_descend_obj(obj, ids, level + 1, len,
+                                       cb, opaque);
     }
-    else if (strcmp(pattern, "*:*") == 0)
+
+    for (obj = obj->son; obj != NULL; obj = obj->brother)
     {
-        all = TRUE;
-        inst = TRUE;
+        if (!cfg_pattern_elm_match(subid, obj->subid))
+            continue;
+
+        rc = cfg_pattern_descend_obj(obj, ids, level + 1, len, cb, opaque);
+        if (rc != 0)
+            return rc;
     }
-    else if ((idsplit = cfg_convert_oid_str(pattern)) == NULL)
-        return TE_RC(TE_CS, TE_EINVAL);
-    else
-        inst = idsplit->inst;
 
-    if (inst)
-    {
-        matches = calloc(cfg_all_inst_size, sizeof(cfg_handle));
-        if (matches == NULL)
-            RETERR(TE_ENOMEM);
+    return 0;
+}
 
-        for (i = 0; i < cfg_all_inst_size; i++)
-        {
-            cfg_inst_subid *s1;
-            cfg_inst_subid *s2;
-            cfg_oid        *tmp_idsplit;
+/**
+ * Find instances matching the pattern in the subtree of an instance
+ * which matches the pattern up to the given level.
+ *
+ * Instances scheduled for removal are matched as well.
+ *
+ * @param inst      Instance matching the pattern element at @p level
+ * @param ids       Pattern elements
+ * @param level     Level of the instance
+ * @param len       Number of pattern elements
+ * @param cb        Callback to be called for each match
+ * @param opaque    Opaque data passed to @p cb
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_pattern_descend_inst(cfg_instance *inst, const cfg_inst_subid *ids,
+                         int level, int len,
+                         cfg_db_pattern_cb cb, void *opaque)
+{
+    const cfg_inst_subid   *next;
+    cfg_instance           *son;
+    te_errno                rc;
 
-            if (cfg_all_inst[i] == NULL)
-                continue;
+    if (level == len - 1)
+        return cb(inst->handle, opaque);
 
-            if (all)
-            {
-                matches[nof_matches++] = cfg_all_inst[i]->handle;
-                continue;
-            }
+    next = &ids[level + 1];
 
-            tmp_idsplit = cfg_convert_oid_str(cfg_all_inst[i]->oid);
-            if (tmp_idsplit == NULL)
-                RETERR(TE_ENOMEM);
+    /* Jump directly through exact levels */
+    if (cfg_inst_hash != NULL &&
+        strchr(next->subid, '*') == NULL && strchr(next->name, '*') == NULL)
+    {
+        cfg_object *obj = cfg_obj_find_son(inst->obj, next->subid);
+
+        if (obj == NULL)
+            return 0;
 
-            if (tmp_idsplit->len != idsplit->len)
+        for (son = cfg_inst_hash[cfg_db_hash(inst, obj, next->name) &
+                                 (cfg_inst_hash_size - 1)];
+             son != NULL; son = son->hash_next)
+        {
+            if (son->father != inst || son->obj != obj ||
+                strcmp(son->name, next->name) != 0)
             {
-                cfg_free_oid(tmp_idsplit);
                 continue;
             }
-            s1 = (cfg_inst_subid *)(idsplit->ids);
-            s2 = (cfg_inst_subid *)(tmp_idsplit->ids);
-            for (k = 0; k < idsplit->len; k++, s1++, s2++)
-            {
-                if ((s1->subid[0] != '*' &&
-                     pattern_match(s1->subid, s2->subid) != 0) ||
-                    (s1->name[0] != '*' &&
-                     pattern_match(s1->name, s2->name) != 0))
-                {
-                    break;
-                }
-            }
-            cfg_free_oid(tmp_idsplit);
-            if (k == idsplit->len)
-                matches[nof_matches++] = cfg_all_inst[i]->handle;
+
+            rc = cfg_pattern_descend_inst(son, ids, level + 1, len,
+                                          cb, opaque);
+            if (rc != 0)
+                return rc;
         }
+
+        return 0;
     }
-    else
+
+    for (son = inst->son; son != NULL; son = son->brother)
+    {
+        if (!cfg_pattern_elm_match(next->subid, son->obj->subid) ||
+            !cfg_pattern_elm_match(next->name, son->name))
+        {
+            continue;
+        }
+
+        rc = cfg_pattern_descend_inst(son, ids, level + 1, len, cb, opaque);
+        if (rc != 0)
+            return rc;
+    }
+
+    return 0;
+}
+
+/**
+ * Call a function for all objects or object instances matching
+ * a pattern in the order of the tree descent.
+ *
+ * @param pattern   Pattern
+ * @param cb        Callback to be called for each match
+ * @param opaque    Opaque data passed to @p cb
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_pattern_walk(const char *pattern, cfg_db_pattern_cb cb, void *opaque)
+{
+    cfg_oid    *idsplit;
+    te_errno    rc = 0;
+    int         i;
+
+    if (pattern == NULL || cb == NULL)
+        return TE_RC(TE_CS, TE_EINVAL);
+
+    if (strcmp(pattern, "*") == 0)
     {
-        matches = calloc(cfg_all_obj_size, sizeof(cfg_handle));
-        if (matches == NULL)
-            RETERR(TE_ENOMEM);
+        RING("pattern: %s, file: %s, line: %d\n",
+             pattern, __FILE__, __LINE__);
 
-        for (i = 0; i < cfg_all_obj_size; i++)
+        for (i = 0; i < cfg_all_obj_size && rc == 0; i++)
         {
-            cfg_object_subid *s1;
-            cfg_object_subid *s2;
-            cfg_oid          *tmp_idsplit;
+            if (cfg_all_obj[i] != NULL)
+                rc = cb(cfg_all_obj[i]->handle, opaque);
+        }
+        return rc;
+    }
 
-            if (cfg_all_obj[i] == NULL)
-                continue;
+    if (strcmp(pattern, "*:*") == 0)
+    {
+        for (i = 0; i < cfg_all_inst_size && rc == 0; i++)
+        {
+            if (cfg_all_inst[i] != NULL)
+                rc = cb(cfg_all_inst[i]->handle, opaque);
+        }
+        return rc;
+    }
 
-            if (all)
-            {
-                matches[nof_matches++] = cfg_all_obj[i]->handle;
-                continue;
-            }
+    if ((idsplit = cfg_convert_oid_str(pattern)) == NULL)
+        return TE_RC(TE_CS, TE_EINVAL);
 
-            tmp_idsplit = cfg_convert_oid_str(cfg_all_obj[i]->oid);
-            if (tmp_idsplit == NULL)
-                RETERR(TE_ENOMEM);
+    if (idsplit->inst)
+    {
+        cfg_inst_subid *ids = (cfg_inst_subid *)(idsplit->ids);
 
-            if (tmp_idsplit->len != idsplit->len)
-            {
-                cfg_free_oid(tmp_idsplit);
-                continue;
-            }
-            s1 = (cfg_object_subid *)(idsplit->ids);
-            s2 = (cfg_object_subid *)(tmp_idsplit->ids);
-            for (k = 0; k < idsplit->len; k++, s1++, s2++)
-            {
-                if (s1->subid[0] != '*' &&
-                    pattern_match(s1->subid, s2->subid) != 0)
-                {
-                    break;
-                }
-            }
-            cfg_free_oid(tmp_idsplit);
-            if (k == idsplit->len)
-                matches[nof_matches++] = cfg_all_obj[i]->handle;
+        if (cfg_pattern_elm_match(ids->subid, cfg_inst_root.obj->subid) &&
+            cfg_pattern_elm_match(ids->name, cfg_inst_root.name))
+        {
+            rc = cfg_pattern_descend_inst(&cfg_inst_root, ids, 0,
+                                          idsplit->len, cb, opaque);
+        }
+    }
+    else
+    {
+        cfg_object_subid *ids = (cfg_object_subid *)(idsplit->ids);
+
+        if (cfg_pattern_elm_match(ids->subid, cfg_obj_root.subid))
+        {
+            rc = cfg_pattern_descend_obj(&cfg_obj_root, ids, 0,
+                                         idsplit->len, cb, opaque);
         }
     }
 
     cfg_free_oid(idsplit);
 
-    result_matches = realloc(matches, nof_matches * sizeof(cfg_handle));
-    if (result_matches == NULL)
+    return rc;
+}
+
+/** Array of handles matching a pattern */
+typedef struct cfg_pattern_matches {
+    cfg_handle     *handles;    /**< Array of handles */
+    unsigned int    num;        /**< Number of handles */
+    unsigned int    size;       /**< Size of the array */
+} cfg_pattern_matches;
+
+/**
+ * Append a handle matching the pattern to the array.
+ *
+ * @param handle    Object or instance handle
+ * @param opaque    Array of handles
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_pattern_matches_add(cfg_handle handle, void *opaque)
+{
+    cfg_pattern_matches *matches = opaque;
+
+    if (matches->num == matches->size)
     {
-        if (nof_matches != 0)
-        {
-            free(matches);
+        unsigned int    size = MAX(matches->size * 2, 16);
+        cfg_handle     *handles = realloc(matches->handles,
+                                          size * sizeof(*handles));
+
+        if (handles == NULL)
             return TE_RC(TE_CS, TE_ENOMEM);
-        }
+
+        matches->handles = handles;
+        matches->size = size;
     }
+    matches->handles[matches->num++] = handle;
 
-    *p_matches = result_matches;
-    *p_nmatches = nof_matches;
     return 0;
-#undef RETERR
+}
+
+/**
+ * Compare handles by their indices in the database.
+ *
+ * @param a         The first handle
+ * @param b         The second handle
+ *
+ * @return Result of comparison as required by qsort().
+ */
+static int
+cfg_pattern_handle_cmp(const void *a, const void *b)
+{
+    unsigned int ia = CFG_INST_HANDLE_TO_INDEX(*(const cfg_handle *)a);
+    unsigned int ib = CFG_INST_HANDLE_TO_INDEX(*(const cfg_handle *)b);
+
+    return (ia > ib) - (ia < ib);
+}
+
+/**
+ * Collect all objects or object instances matching a pattern in the
+ * order of their indices in the database.
+ *
+ * @param pattern   Pattern
+ * @param matches   Array of handles to be filled in
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_pattern_collect(const char *pattern, cfg_pattern_matches *matches)
+{
+    te_errno rc;
+
+    rc = cfg_pattern_walk(pattern, cfg_pattern_matches_add, matches);
+    if (rc != 0)
+    {
+        free(matches->handles);
+        matches->handles = NULL;
+        matches->num = matches->size = 0;
+        return rc;
+    }
+
+    /*
+     * Tree descent visits matches in the order of siblings, while
+     * users rely on the order of creation given by the database scan.
+     */
+    if (matches->num > 1)
+    {
+        qsort(matches->handles, matches->num, sizeof(*matches->handles),
+              cfg_pattern_handle_cmp);
+    }
+
+    return 0;
+}
+
+/* See the description in conf_db.h */
+te_errno
+cfg_db_find_pattern_iter(const char *pattern,
+                         cfg_db_pattern_cb cb, void *opaque)
+{
+    cfg_pattern_matches matches = { NULL, 0, 0 };
+    unsigned int        i;
+    te_errno            rc;
+
+    if (pattern == NULL || cb == NULL)
+        return TE_RC(TE_CS, TE_EINVAL);
+
+    rc = cfg_pattern_collect(pattern, &matches);
+    for (i = 0; i < matches.num && rc == 0; i++)
+        rc = cb(matches.handles[i], opaque);
+
+    free(matches.handles);
+
+    return rc;
+}
+
+/**
+ * Find all objects or object instances matching a pattern.
+ *
+ * @param pattern       string object identifier possibly containing '*'
+ *                      (see Configurator documentation for details)
+ * @param p_nmatches    OUT: number of found objects or object instances
+ * @param p_matches     OUT: array of object/(object instance) handles;
+ *                      memory for the array is allocated using malloc()
+ *
+ * @return  0 or
+ *          TE_EINVAL if a pattern format is incorrect or
+ *                    some argument is NULL.
+ */
+te_errno
+cfg_db_find_pattern(const char *pattern,
+                    unsigned int *p_nmatches,
+                    cfg_handle **p_matches)
+{
+    cfg_pattern_matches matches = { NULL, 0, 0 };
+    te_errno            rc;
+
+    if (pattern == NULL || p_nmatches == NULL || p_matches == NULL)
+        return TE_RC(TE_CS, TE_EINVAL);
+
+    rc = cfg_pattern_collect(pattern, &matches);
+    if (rc != 0)
+        return rc;
+
+    *p_matches = matches.handles;
+    *p_nmatches = matches.num;
+    return 0;
 }   /* cfg_db_find_pattern() */
 
 /*
@@ -1482,6 +2157,8 @@ cfg_add_with_obj_and_parent(cfg_instance *par_inst, cfg_object *obj,
     cfg_all_inst[i]->son = NULL;
     cfg_all_inst[i]->brother = par_inst->son;
     par_inst->son =  cfg_all_inst[i];
+    cfg_inst_hash_add(cfg_all_inst[i]);
+    cfg_oid_cache_flush();
     *inst = cfg_all_inst[i];
 
     return 0;
@@ -1627,30 +2304,15 @@ cfg_db_add(const char *oid_s, cfg_handle *handle,
     s = (cfg_inst_subid *)(oid->ids);
 
     /* Look for the father first */
-    while (TRUE)
-    {
-        for (;
-             father != NULL &&
-                 (strcmp(father->obj->subid, s->subid) != 0 ||
-                  strcmp(father->name, s->name) != 0 ||
-                  father->remove);
-             father = father->brother);
-
-        s++;
-
-        if (++i == oid->len - 1 || father == NULL)
-            break;
-
-        father = father->son;
-    }
+    father = cfg_inst_find_root(s);
+    for (s++, i++; father != NULL && i < oid->len - 1; s++, i++)
+        father = cfg_inst_find_son(father, s->subid, s->name);
 
     if (father == NULL)
         RET(TE_ENOENT);
 
     /* Find an object for the instance */
-    for (obj = father->obj->son;
-         obj != NULL && strcmp(obj->subid, s->subid) != 0;
-         obj = obj->brother);
+    obj = cfg_obj_find_son(father->obj, s->subid);
 
     if (obj == NULL)
         RET(TE_ENOENT);
@@ -1760,6 +2422,8 @@ cfg_db_add(const char *oid_s, cfg_handle *handle,
         inst->brother = father->son;
         father->son = inst;
     }
+    cfg_inst_hash_add(inst);
+    cfg_oid_cache_flush();
 
     *handle = inst->handle;
     if (cfg_all_inst_max < i)
@@ -1836,6 +2500,9 @@ delete_son(cfg_instance *father, cfg_instance *son)
         delete_son(son, tmp);
     }
 
+    cfg_inst_hash_del(son);
+    cfg_oid_cache_flush();
+
     if (father->son == son)
     {
         father->son = son->brother;
@@ -1956,14 +2623,18 @@ cfg_db_find(const char *oid_s, cfg_handle *handle)
     cfg_oid *oid = NULL;
     int      i = 0;
 
+    if (cfg_oid_cache_get(oid_s, handle))
+        return 0;
+
     if ((oid = cfg_convert_oid_str(oid_s)) == NULL)
        return TE_EINVAL;
 
 #define RET(_handle) \
-    do {                   \
-        cfg_free_oid(oid); \
-        *handle = _handle; \
-        return 0;          \
+    do {                                    \
+        cfg_free_oid(oid);                  \
+        *handle = _handle;                  \
+        cfg_oid_cache_put(oid_s, *handle);  \
+        return 0;                           \
     } while (0)
 
 #define RETERR(_rc) \
@@ -1974,37 +2645,24 @@ cfg_db_find(const char *oid_s, cfg_handle *handle)
 
     if (oid->inst)
     {
-        cfg_instance *tmp = &cfg_inst_root;
+        cfg_inst_subid *ids = (cfg_inst_subid *)(oid->ids);
+        cfg_instance *tmp = cfg_inst_find_root(ids);
         cfg_instance *last_subinst = NULL;
         te_bool not_added_ancestor = FALSE;
 
-        while (TRUE)
+        /*
+         * Instance which is scheduled for removal after commit
+         * is skipped here. It does not make sense to perform
+         * some operations on a deleted instance.
+         */
+        for (i++; tmp != NULL && i < oid->len; i++)
         {
-            /*
-             * Instance which is scheduled for removal after commit
-             * is skipped here. It does not make sense to perform
-             * some operations on a deleted instance.
-             */
-            for (;
-                 tmp != NULL &&
-                 (!(strcmp(tmp->obj->subid,
-                           ((cfg_inst_subid *)(oid->ids))[i].subid) == 0 &&
-                    strcmp(tmp->name,
-                           ((cfg_inst_subid *)(oid->ids))[i].name) == 0)
-                  || tmp->remove);
-                 tmp = tmp->brother);
-
-            if (++i == oid->len || tmp == NULL)
-            {
-                break;
-            }
-
             if (tmp->obj->access == CFG_READ_CREATE && !tmp->added)
                 not_added_ancestor = TRUE;
 
             last_subinst = tmp;
 
-            tmp = tmp->son;
+            tmp = cfg_inst_find_son(tmp, ids[i].subid, ids[i].name);
         }
         if (tmp == NULL)
         {
@@ -2018,20 +2676,10 @@ cfg_db_find(const char *oid_s, cfg_handle *handle)
             if (not_added_ancestor && i == oid->len)
             {
                 int         rc;
-                const char *subobj_name =
-                    ((cfg_inst_subid *)(oid->ids))[oid->len - 1].subid;
-                cfg_object *subobj_tmp = last_subinst->obj->son;
+                const char *subobj_name = ids[oid->len - 1].subid;
 
                 /* Check that configuration DB accepts such object name */
-                while (subobj_tmp != NULL)
-                {
-                    if (strcmp(subobj_tmp->subid, subobj_name) == 0)
-                        break;
-
-                    subobj_tmp = subobj_tmp->brother;
-                }
-
-                if (subobj_tmp == NULL)
+                if (cfg_obj_find_son(last_subinst->obj, subobj_name) == NULL)
                 {
                     ERROR("Instance %s cannot be added into configurator "
                           "tree as child name '%s' has not been registered",
@@ -2059,20 +2707,15 @@ cfg_db_find(const char *oid_s, cfg_handle *handle)
     }
     else
     {
+        cfg_object_subid *ids = (cfg_object_subid *)(oid->ids);
         cfg_object *tmp = &cfg_obj_root;
-        while (TRUE)
-        {
-           for (;
-                tmp != NULL &&
-                strcmp(tmp->subid,
-                       ((cfg_object_subid *)(oid->ids))[i].subid) != 0;
-                tmp = tmp->brother);
 
-           if (++i == oid->len || tmp == NULL)
-               break;
+        if (strcmp(tmp->subid, ids[i].subid) != 0)
+            tmp = NULL;
+
+        for (i++; tmp != NULL && i < oid->len; i++)
+            tmp = cfg_obj_find_son(tmp, ids[i].subid);
 
-           tmp = tmp->son;
-        }
         if (tmp == NULL)
             RETERR(TE_ENOENT);
         else
@@ -2108,19 +2751,11 @@ cfg_get_object(const char *oid_s)
 
     s = (cfg_inst_subid *)(oid->ids);
 
-    while (TRUE)
-    {
-       for (;
-            tmp != NULL &&
-            strcmp(tmp->subid, s->subid) != 0;
-            tmp = tmp->brother);
+    if (strcmp(tmp->subid, s->subid) != 0)
+        tmp = NULL;
 
-       if (++i == oid->len || tmp == NULL)
-           break;
-
-       tmp = tmp->son;
-       s++;
-    }
+    for (i++, s++; tmp != NULL && i < oid->len; i++, s++)
+        tmp = cfg_obj_find_son(tmp, s->subid);
 
     cfg_free_oid(oid);
 
@@ -2137,11 +2772,16 @@ cfg_get_object(const char *oid_s)
 cfg_object *
 cfg_get_obj_by_obj_id_str(const char *obj_id_str)
 {
-    cfg_oid             *idsplit = cfg_convert_oid_str(obj_id_str);
+    cfg_oid             *idsplit;
     cfg_object          *obj = &cfg_obj_root;
     cfg_object_subid    *ids;
+    cfg_handle           handle;
     int                 i;
 
+    if (cfg_oid_cache_get(obj_id_str, &handle) && !CFG_IS_INST(handle))
+        return CFG_GET_OBJ(handle);
+
+    idsplit = cfg_convert_oid_str(obj_id_str);
     if (idsplit == NULL)
         return NULL;
 
@@ -2153,18 +2793,17 @@ cfg_get_obj_by_obj_id_str(const char *obj_id_str)
 
     ids = (cfg_object_subid *)(idsplit->ids);
 
-    for (i = 0;;)
-    {
-        while (obj != NULL && strcmp(obj->subid, ids->subid) != 0)
-            obj = obj->brother;
-        if (++i == idsplit->len || obj == NULL)
-            break;
+    if (strcmp(obj->subid, ids->subid) != 0)
+        obj = NULL;
 
-        obj = obj->son;
-        ids++;
-    }
+    for (i = 1, ids++; obj != NULL && i < idsplit->len; i++, ids++)
+        obj = cfg_obj_find_son(obj, ids->subid);
 
     cfg_free_oid(idsplit);
+
+    if (obj != NULL)
+        cfg_oid_cache_put(obj_id_str, obj->handle);
+
     return obj;
 }
 
@@ -2178,11 +2817,16 @@ cfg_get_obj_by_obj_id_str(const char *obj_id_str)
 cfg_instance *
 cfg_get_ins_by_ins_id_str(const char *ins_id_str)
 {
-    cfg_oid             *idsplit = cfg_convert_oid_str(ins_id_str);
-    cfg_instance        *ins = &cfg_inst_root;
+    cfg_oid             *idsplit;
+    cfg_instance        *ins;
     cfg_inst_subid      *ids;
+    cfg_handle           handle;
     int                 i;
 
+    if (cfg_oid_cache_get(ins_id_str, &handle) && CFG_IS_INST(handle))
+        return CFG_GET_INST(handle);
+
+    idsplit = cfg_convert_oid_str(ins_id_str);
     if (idsplit == NULL)
         return NULL;
 
@@ -2194,29 +2838,20 @@ cfg_get_ins_by_ins_id_str(const char *ins_id_str)
 
     ids = (cfg_inst_subid *)(idsplit->ids);
 
-    for (i = 0;;)
-    {
-        /*
-         * Instance which is scheduled for removal after commit
-         * is skipped here. It does not make sense to perform
-         * some operations on a deleted instance.
-         */
-        while (ins != NULL &&
-               (strcmp(ins->obj->subid, ids->subid) != 0 ||
-                strcmp(ins->name, ids->name ) != 0 ||
-                ins->remove))
-        {
-            ins = ins->brother;
-        }
+    /*
+     * Instance which is scheduled for removal after commit
+     * is skipped here. It does not make sense to perform
+     * some operations on a deleted instance.
+     */
+    ins = cfg_inst_find_root(ids);
+    for (i = 1, ids++; ins != NULL && i < idsplit->len; i++, ids++)
+        ins = cfg_inst_find_son(ins, ids->subid, ids->name);
 
-        if (++i == idsplit->len || ins == NULL)
-            break;
+    cfg_free_oid(idsplit);
 
-        ins = ins->son;
-        ids++;
-    }
+    if (ins != NULL)
+        cfg_oid_cache_put(ins_id_str, ins->handle);
 
-    cfg_free_oid(idsplit);
     return ins;
 }
 
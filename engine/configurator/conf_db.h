@@ -70,6 +70,8 @@ typedef struct cfg_object {
     te_bool unit_part; /**< @c TRUE means the object is a descendant of an
                             object having unit=TRUE */
 
+    struct cfg_object *hash_next; /**< Next object in the hash chain
+                                       of children lookup table */
 } cfg_object;
 
 #define CFG_DEP_INITIALIZER  0, NULL, NULL, NULL, NULL
@@ -115,6 +117,9 @@ typedef struct cfg_instance {
     struct cfg_instance *bkp_next;  /**< Pointer to the next instance
                                          in a list of instances to
                                          be restored from backup */
+    struct cfg_instance *hash_next; /**< Next instance in the hash
+                                         chain of children lookup
+                                         table */
 
     union  cfg_inst_val  val;
 } cfg_instance;
@@ -326,6 +331,37 @@ extern int cfg_db_find(const char *oid_s, cfg_handle *handle);
 extern te_errno cfg_db_find_pattern(const char *pattern,
                                     unsigned int *p_nmatches,
                                     cfg_handle **p_matches);
+
+/**
+ * Callback for objects or object instances matching a pattern.
+ *
+ * @param handle        object or object instance handle
+ * @param opaque        opaque data passed to cfg_db_find_pattern_iter()
+ *
+ * @return Status code: non-zero value stops the search.
+ */
+typedef te_errno (*cfg_db_pattern_cb)(cfg_handle handle, void *opaque);
+
+/**
+ * Call a function for all objects or object instances matching
+ * a pattern. Only subtrees matching the pattern are visited, exact
+ * pattern elements are looked up directly. Matches are reported in
+ * the order of their indices in the database (i.e. in the order of
+ * creation unless entries were deleted), as the whole database scan
+ * used to do.
+ *
+ * @param pattern       string object identifier possibly containing '*'
+ *                      (see Configurator documentation for details)
+ * @param cb            callback to be called for each match
+ * @param opaque        opaque data passed to @p cb
+ *
+ * @return  0, TE_EINVAL if a pattern format is incorrect or
+ *          some argument is NULL, or status code returned by @p cb.
+ */
+extern te_errno cfg_db_find_pattern_iter(const char *pattern,
+                                         cfg_db_pattern_cb cb,
+                                         void *opaque);
+
 /**
  * Initialize the database during startup or re-initialization.
  *
@@ -164,24 +164,25 @@ cfg_ta_log_syncing(te_bool flag)
 }
 
 /**
- * Synchronize one object instance on the TA.
+ * Put the value of one object instance obtained from the TA to
+ * the local database.
  *
  * @param ta      Test Agent name
+ * @param obj     object of the instance
  * @param oid     object instance identifier
+ * @param value   value obtained from the TA (ignored for objects
+ *                without value)
  *
  * @return status code (see te_errno.h)
  */
 static int
-sync_ta_instance(const char *ta, const char *oid)
+sync_ta_instance_value(const char *ta, cfg_object *obj, const char *oid,
+                       char *value)
 {
-    cfg_object   *obj = cfg_get_object(oid);
     cfg_handle    handle = CFG_HANDLE_INVALID;
     cfg_inst_val  val;
     int           rc;
 
-    if (obj == NULL)
-        return 0;
-
     rc = cfg_db_find(oid, &handle);
     if (rc != 0 && TE_RC_GET_ERROR(rc) != TE_ENOENT)
         return rc;
@@ -207,48 +208,15 @@ sync_ta_instance(const char *ta, const char *oid)
         return rc;
     }
 
-    while (TRUE)
-    {
-        rc = rcf_ta_cfg_get(ta, 0, oid, cfg_get_buf, cfg_get_buf_len);
-        if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
-        {
-            cfg_get_buf_len <<= 1;
-
-            cfg_get_buf = (char *)realloc(cfg_get_buf, cfg_get_buf_len);
-            if (cfg_get_buf == NULL)
-            {
-                ERROR("Memory allocation failure");
-                return TE_ENOMEM;
-            }
-        }
-        else if (TE_RC_GET_ERROR(rc) == TE_ENOENT || rc == 0 ||
-                 (TE_RC_GET_ERROR(rc) == TE_ENOENT && obj->vol))
-        {
-            break;
-        }
-        else
-        {
-            ERROR("Failed(%r) to get '%s' from TA '%s'", rc, oid, ta);
-            return rc;
-        }
-    }
-
-    if (rc != 0)
-    {
-        if (handle != CFG_HANDLE_INVALID)
-            cfg_db_del(handle);
-        return 0;
-    }
-
     if (do_log_syncing)
     {
-        RING("Syncing %s on %s -> %s", ta, oid, cfg_get_buf);
+        RING("Syncing %s on %s -> %s", ta, oid, value);
     }
 
-    if ((rc = cfg_types[obj->type].str2val(cfg_get_buf, &val)) != 0)
+    if ((rc = cfg_types[obj->type].str2val(value, &val)) != 0)
     {
         ERROR("Conversion of '%s' to value type %s(%d) for OID '%s' "
-                "failed", cfg_get_buf,
+                "failed", value,
                 te_enum_map_from_any_value(cfg_cvt_mapping, obj->type,
                                            "unknown type"),
                 obj->type, oid);
@@ -278,6 +246,63 @@ sync_ta_instance(const char *ta, const char *oid)
     return rc;
 }
 
+/**
+ * Synchronize one object instance on the TA.
+ *
+ * @param ta      Test Agent name
+ * @param oid     object instance identifier
+ *
+ * @return status code (see te_errno.h)
+ */
+static int
+sync_ta_instance(const char *ta, const char *oid)
+{
+    cfg_object   *obj = cfg_get_object(oid);
+    cfg_handle    handle;
+    int           rc;
+
+    if (obj == NULL)
+        return 0;
+
+    if (obj->type == CVT_NONE)
+        return sync_ta_instance_value(ta, obj, oid, NULL);
+
+    while (TRUE)
+    {
+        rc = rcf_ta_cfg_get(ta, 0, oid, cfg_get_buf, cfg_get_buf_len);
+        if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
+        {
+            cfg_get_buf_len <<= 1;
+
+            cfg_get_buf = (char *)realloc(cfg_get_buf, cfg_get_buf_len);
+            if (cfg_get_buf == NULL)
+            {
+                ERROR("Memory allocation failure");
+                return TE_ENOMEM;
+            }
+        }
+        else if (TE_RC_GET_ERROR(rc) == TE_ENOENT || rc == 0 ||
+                 (TE_RC_GET_ERROR(rc) == TE_ENOENT && obj->vol))
+        {
+            break;
+        }
+        else
+        {
+            ERROR("Failed(%r) to get '%s' from TA '%s'", rc, oid, ta);
+            return rc;
+        }
+    }
+
+    if (rc != 0)
+    {
+        if (cfg_db_find(oid, &handle) == 0)
+            cfg_db_del(handle);
+        return 0;
+    }
+
+    return sync_ta_instance_value(ta, obj, oid, cfg_get_buf);
+}
+
 /* Remove entries, which do not mention in the list, from database */
 static void
 remove_excessive(cfg_instance *inst, char *list)
@@ -350,16 +375,219 @@ free_list(olist *list)
     }
 }
 
+/** Instance obtained from the TA by bulk get request */
+typedef struct bulk_entry {
+    const char *oid;    /**< Object instance identifier */
+    char       *value;  /**< Object instance value */
+} bulk_entry;
+
+/** Number of subtrees synchronized using bulk get requests */
+static unsigned int bulk_sync_num = 0;
+/** Number of instances obtained by bulk get requests */
+static unsigned int bulk_sync_inst_num = 0;
+/** Number of get requests to TAs avoided due to bulk get requests */
+static unsigned int bulk_sync_saved_num = 0;
+
+/** Compare bulk get entries by instance identifier */
+static int
+bulk_entry_cmp(const void *a, const void *b)
+{
+    return strcmp(((const bulk_entry *)a)->oid,
+                  ((const bulk_entry *)b)->oid);
+}
+
+/**
+ * Remove instances which are not obtained from the TA from database.
+ *
+ * @param inst      root of the subtree to be checked
+ * @param root_oid  identifier of the synchronized subtree root
+ * @param entries   sorted array of instances obtained from the TA
+ * @param num       number of entries
+ */
+static void
+remove_missing(cfg_instance *inst, const char *root_oid,
+               const bulk_entry *entries, size_t num)
+{
+    cfg_instance *tmp;
+    cfg_instance *next;
+    bulk_entry    key;
+
+    for (tmp = inst->son; tmp != NULL; tmp = next)
+    {
+        next = tmp->brother;
+        remove_missing(tmp, root_oid, entries, num);
+    }
+
+    if (cfg_inst_agent(inst) || strcmp(inst->oid, root_oid) == 0)
+        return;
+
+    key.oid = inst->oid;
+    if (bsearch(&key, entries, num, sizeof(*entries),
+                bulk_entry_cmp) == NULL)
+    {
+        cfg_db_del(inst->handle);
+    }
+}
+
 /**
- * Synchronize tree of object instances on the TA.
+ * Synchronize tree of object instances on the TA using single bulk get
+ * request which returns all instances of the subtree with their values.
  *
  * @param ta      Test Agent name
  * @param oid     root object instance identifier
  *
  * @return status code (see te_errno.h)
+ * @retval TE_EFMT      the TA does not support bulk get request
  */
 static int
-sync_ta_subtree(const char *ta, const char *oid)
+sync_ta_subtree_bulk(const char *ta, const char *oid)
+{
+    bulk_entry *entries = NULL;
+    size_t      num = 0;
+    size_t      len;
+    size_t      i;
+    unsigned int saved = 0;
+    te_bool     root_found = FALSE;
+    char       *tmp;
+    char       *limit;
+    cfg_handle *handles = NULL;
+    int         h_num;
+    int         rc;
+
+    while (TRUE)
+    {
+        len = cfg_get_buf_len;
+        rc = rcf_ta_cfg_get_bulk(ta, 0, oid, cfg_get_buf, &len);
+        if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
+        {
+            cfg_get_buf_len <<= 1;
+
+            cfg_get_buf = (char *)realloc(cfg_get_buf, cfg_get_buf_len);
+            if (cfg_get_buf == NULL)
+            {
+                ERROR("Memory allocation failure");
+                return TE_ENOMEM;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (rc != 0)
+        return rc;
+
+    /* The answer is a sequence of "<oid>\0<value>\0" pairs */
+    limit = cfg_get_buf + len;
+    for (tmp = cfg_get_buf; tmp < limit; tmp++)
+        num += (*tmp == '\0');
+
+    if ((entries = calloc(num / 2 + 1, sizeof(*entries))) == NULL)
+    {
+        ERROR("Memory allocation failure");
+        return TE_ENOMEM;
+    }
+
+    for (tmp = cfg_get_buf, num = 0; tmp < limit; )
+    {
+        const char *inst_oid = tmp;
+
+        tmp += strnlen(tmp, limit - tmp) + 1;
+        if (*inst_oid == '\0')
+            continue;
+        if (tmp >= limit)
+        {
+            ERROR("Malformed answer on bulk get request for '%s' "
+                  "from TA '%s'", oid, ta);
+            free(entries);
+            return TE_EFMT;
+        }
+
+        entries[num].oid = inst_oid;
+        entries[num].value = tmp;
+        num++;
+        tmp += strnlen(tmp, limit - tmp) + 1;
+    }
+
+    /* Sorting guarantees that parents are processed before children */
+    qsort(entries, num, sizeof(*entries), bulk_entry_cmp);
+
+    VERB("%s: %u instances of '%s' are obtained by bulk get",
+         ta, (unsigned int)num, oid);
+
+    rc = cfg_db_find_pattern(oid, (unsigned int *)&h_num, &handles);
+    if (rc != 0)
+    {
+        free(entries);
+        return rc;
+    }
+
+    for (i = 0; i < (size_t)h_num; i++)
+        remove_missing(CFG_GET_INST(handles[i]), oid, entries, num);
+    free(handles);
+
+    for (i = 0; i < num; i++)
+    {
+        cfg_object *obj = cfg_get_object(entries[i].oid);
+
+        if (strcmp(entries[i].oid, oid) == 0)
+            root_found = TRUE;
+
+        if (obj == NULL)
+            continue;
+
+        if (obj->type != CVT_NONE)
+            saved++;
+
+        rc = sync_ta_instance_value(ta, obj, entries[i].oid,
+                                    entries[i].value);
+        if (rc != 0)
+            break;
+    }
+    free(entries);
+
+    /*
+     * Entries point to the buffer which may be reused by
+     * sync_ta_instance(), so the root is processed at the end.
+     */
+    if (rc == 0 && !root_found && strchr(oid, '*') == NULL)
+        rc = sync_ta_instance(ta, oid);
+
+    bulk_sync_num++;
+    bulk_sync_inst_num += num;
+    bulk_sync_saved_num += saved;
+
+    if (do_log_syncing)
+    {
+        RING("TA '%s' subtree '%s' is synchronized by bulk get: "
+             "%u instances, %u get requests saved (total %u subtrees, "
+             "%u instances, %u get requests saved)", ta, oid,
+             (unsigned int)num, saved, bulk_sync_num, bulk_sync_inst_num,
+             bulk_sync_saved_num);
+    }
+    else
+    {
+        INFO("TA '%s' subtree '%s' is synchronized by bulk get: "
+             "%u instances, %u get requests saved (total %u subtrees, "
+             "%u instances, %u get requests saved)", ta, oid,
+             (unsigned int)num, saved, bulk_sync_num, bulk_sync_inst_num,
+             bulk_sync_saved_num);
+    }
+
+    return rc;
+}
+
+/**
+ * Synchronize tree of object instances on the TA getting list of
+ * instances and then value of each instance separately.
+ *
+ * @param ta      Test Agent name
+ * @param oid     root object instance identifier
+ *
+ * @return status code (see te_errno.h)
+ */
+static int
+sync_ta_subtree_list(const char *ta, const char *oid)
 {
     char  *tmp;
     char  *next;
@@ -373,9 +601,6 @@ sync_ta_subtree(const char *ta, const char *oid)
     int         h_num;
     int         i;
 
-    if (do_log_syncing)
-        RING("Synchronize TA '%s' subtree '%s'", ta, oid);
-
     /* Take all instances from the TA */
     if ((wildcard_oid = malloc(strlen(oid) + sizeof("/..."))) == NULL)
     {
@@ -384,14 +609,6 @@ sync_ta_subtree(const char *ta, const char *oid)
     }
     sprintf(wildcard_oid, "%s/...", oid);
 
-    rc = rcf_ta_cfg_group(ta, 0, TRUE);
-    if (rc != 0)
-    {
-        ERROR("rcf_ta_cfg_group() failed");
-        free(wildcard_oid);
-        return TE_ENOMEM;
-    }
-
     cfg_get_buf[0] = 0;
     while (TRUE)
     {
@@ -405,7 +622,6 @@ sync_ta_subtree(const char *ta, const char *oid)
             if (cfg_get_buf == NULL)
             {
                 ERROR("Memory allocation failure");
-                rcf_ta_cfg_group(ta, 0, FALSE);
                 free(wildcard_oid);
                 return TE_ENOMEM;
             }
@@ -415,7 +631,6 @@ sync_ta_subtree(const char *ta, const char *oid)
         else
         {
             ERROR("rcf_ta_cfg_get() failed: TA=%s, error=%r", ta, rc);
-            rcf_ta_cfg_group(ta, 0, FALSE);
             free(wildcard_oid);
             return rc;
         }
@@ -426,10 +641,7 @@ sync_ta_subtree(const char *ta, const char *oid)
 
     rc = cfg_db_find_pattern(oid, (unsigned int *)&h_num, &handles);
     if (rc != 0)
-    {
-        rcf_ta_cfg_group(ta, 0, FALSE);
         return rc;
-    }
 
     if (cfg_get_buf_len < (int)strlen(cfg_get_buf) + (int)strlen(oid) + 2)
     {
@@ -439,7 +651,6 @@ sync_ta_subtree(const char *ta, const char *oid)
         if (cfg_get_buf == NULL)
         {
             ERROR("Memory allocation failure");
-            rcf_ta_cfg_group(ta, 0, FALSE);
             free(handles);
             return TE_ENOMEM;
         }
@@ -472,14 +683,59 @@ sync_ta_subtree(const char *ta, const char *oid)
         if ((rc = sync_ta_instance(ta, entry->oid)) != 0)
             break;
 
-    rcf_ta_cfg_group(ta, 0, FALSE);
-
     free_list(list);
     free(handles);
 
     return rc;
 }
 
+/**
+ * Synchronize tree of object instances on the TA.
+ *
+ * @param ta      Test Agent name
+ * @param oid     root object instance identifier
+ *
+ * @return status code (see te_errno.h)
+ */
+static int
+sync_ta_subtree(const char *ta, const char *oid)
+{
+    int rc;
+
+    if (do_log_syncing)
+        RING("Synchronize TA '%s' subtree '%s'", ta, oid);
+
+    rc = rcf_ta_cfg_group(ta, 0, TRUE);
+    if (rc != 0)
+    {
+        ERROR("rcf_ta_cfg_group() failed");
+        return TE_ENOMEM;
+    }
+
+    rc = sync_ta_subtree_bulk(ta, oid);
+    switch (TE_RC_GET_ERROR(rc))
+    {
+        case TE_EFMT:
+        case TE_EOPNOTSUPP:
+            /* The TA does not support bulk get, use old way */
+            VERB("TA '%s' does not support bulk get: %r", ta, rc);
+            rc = sync_ta_subtree_list(ta, oid);
+            break;
+
+        case 0:
+            break;
+
+        default:
+            ERROR("Bulk synchronization of TA '%s' subtree '%s' "
+                  "failed: %r", ta, oid, rc);
+            break;
+    }
+
+    rcf_ta_cfg_group(ta, 0, FALSE);
+
+    return rc;
+}
+
 /**
  * Synchronize object instances tree with Test Agents.
  *
@@ -0,0 +1,272 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Configurator Tester
+ *
+ * Benchmark of the Configurator database lookups
+ *
+ * The benchmark is linked with conf_db.c and conf_print.c. It fills
+ * the database with a large number of instances and compares
+ * cfg_db_find() with the traversal of brothers lists which was used
+ * before children lookup tables and OID cache were introduced.
+ *
+ * Usage: db_find_bench [<number of instances> [<number of rounds>]]
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "conf_defs.h"
+#include "logger_file.h"
+
+/** Default number of instances per object */
+#define BENCH_INST_NUM      4096
+
+/** Default number of lookup rounds */
+#define BENCH_ROUNDS        16
+
+/** Name of the Test Agent instance */
+#define BENCH_TA            "Agt_bench"
+
+/** Objects instances of which are created */
+static const char *bench_objs[] = {
+    "/agent/interface",
+    "/agent/rsrc",
+    "/agent/ip_rule",
+    "/local",
+};
+
+/**
+ * There are no Test Agents in the benchmark, /agent instance is added
+ * explicitly.
+ */
+int
+cfg_ta_add_agent_instances(void)
+{
+    return 0;
+}
+
+/**
+ * Register an object in the database.
+ *
+ * @param oid       Object identifier
+ *
+ * @return Status code.
+ */
+static te_errno
+bench_register(const char *oid)
+{
+    uint8_t             buf[CFG_BUF_LEN];
+    cfg_register_msg   *msg = (cfg_register_msg *)buf;
+    cfg_handle          handle;
+
+    /* Some objects are registered by Configurator itself */
+    if (cfg_db_find(oid, &handle) == 0)
+        return 0;
+
+    memset(buf, 0, sizeof(buf));
+    msg->type = CFG_REGISTER;
+    msg->len = sizeof(*msg) + strlen(oid) + 1;
+    msg->val_type = CVT_NONE;
+    msg->access = CFG_READ_CREATE;
+    msg->no_parent_dep = TRUE;
+    strcpy(msg->oid, oid);
+
+    cfg_process_msg_register(msg);
+
+    return msg->rc;
+}
+
+/**
+ * Find instance by traversal of brothers lists.
+ *
+ * @param oid_s     Instance identifier
+ * @param handle    Location for the instance handle
+ *
+ * @return Status code.
+ */
+static te_errno
+bench_find_traverse(const char *oid_s, cfg_handle *handle)
+{
+    cfg_oid        *oid = cfg_convert_oid_str(oid_s);
+    cfg_inst_subid *ids;
+    cfg_instance   *inst = &cfg_inst_root;
+    int             i;
+
+    if (oid == NULL)
+        return TE_EINVAL;
+
+    ids = (cfg_inst_subid *)(oid->ids);
+    for (i = 0;;)
+    {
+        while (inst != NULL &&
+               (strcmp(inst->obj->subid, ids[i].subid) != 0 ||
+                strcmp(inst->name, ids[i].name) != 0 || inst->remove))
+        {
+            inst = inst->brother;
+        }
+
+        if (++i == oid->len || inst == NULL)
+            break;
+
+        inst = inst->son;
+    }
+
+    cfg_free_oid(oid);
+    if (inst == NULL)
+        return TE_ENOENT;
+
+    *handle = inst->handle;
+    return 0;
+}
+
+/**
+ * Look up all instances several times and print the average time.
+ *
+ * @param name      Name of the lookup method
+ * @param find      Lookup function
+ * @param oids      Instance identifiers
+ * @param num       Number of identifiers
+ * @param rounds    Number of rounds
+ *
+ * @return Status code.
+ */
+static te_errno
+bench_run(const char *name, int (*find)(const char *, cfg_handle *),
+          char **oids, unsigned int num, unsigned int rounds)
+{
+    struct timespec start;
+    struct timespec end;
+    cfg_handle      handle;
+    unsigned int    r;
+    unsigned int    i;
+    te_errno        rc;
+    double          ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (r = 0; r < rounds; r++)
+    {
+        for (i = 0; i < num; i++)
+        {
+            rc = find(oids[i], &handle);
+            if (rc != 0)
+            {
+                fprintf(stderr, "%s: failed to find %s: %s\n",
+                        name, oids[i], te_rc_err2str(rc));
+                return rc;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("%-24s %10.1f ns/lookup\n", name, ns / ((double)num * rounds));
+
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    unsigned int    inst_num = BENCH_INST_NUM;
+    unsigned int    rounds = BENCH_ROUNDS;
+    unsigned int    num = 0;
+    unsigned int    i;
+    unsigned int    j;
+    char          **oids = NULL;
+    cfg_handle      handle;
+    te_errno        rc;
+    int             result = EXIT_FAILURE;
+
+    te_log_init("db_find_bench", te_log_message_file);
+
+    if (argc > 1)
+        inst_num = strtoul(argv[1], NULL, 0);
+    if (argc > 2)
+        rounds = strtoul(argv[2], NULL, 0);
+    if (inst_num == 0 || rounds == 0)
+    {
+        fprintf(stderr, "Usage: %s [<instances> [<rounds>]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if ((rc = cfg_db_init()) != 0)
+    {
+        fprintf(stderr, "cfg_db_init() failed: %s\n", te_rc_err2str(rc));
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < TE_ARRAY_LEN(bench_objs); i++)
+    {
+        if ((rc = bench_register(bench_objs[i])) != 0)
+        {
+            fprintf(stderr, "Failed to register %s: %s\n", bench_objs[i],
+                    te_rc_err2str(rc));
+            goto cleanup;
+        }
+    }
+
+    if ((rc = cfg_db_add(CFG_TA_PREFIX BENCH_TA, &handle, CVT_NONE,
+                         (cfg_inst_val)0)) != 0)
+    {
+        fprintf(stderr, "Failed to add Test Agent: %s\n",
+                te_rc_err2str(rc));
+        goto cleanup;
+    }
+
+    num = inst_num * TE_ARRAY_LEN(bench_objs);
+    oids = calloc(num, sizeof(*oids));
+    if (oids == NULL)
+        goto cleanup;
+
+    for (i = 0; i < TE_ARRAY_LEN(bench_objs); i++)
+    {
+        const char *subid = strrchr(bench_objs[i], '/') + 1;
+        te_bool     local = strcmp_start("/agent/", bench_objs[i]) != 0;
+
+        for (j = 0; j < inst_num; j++)
+        {
+            char **oid = &oids[i * inst_num + j];
+            int    len;
+
+            if (local)
+                len = asprintf(oid, "/%s:inst%u", subid, j);
+            else
+                len = asprintf(oid, CFG_TA_PREFIX BENCH_TA "/%s:inst%u",
+                               subid, j);
+
+            if (len < 0)
+            {
+                *oid = NULL;
+                goto cleanup;
+            }
+
+            if ((rc = cfg_db_add(*oid, &handle, CVT_NONE,
+                                 (cfg_inst_val)0)) != 0)
+            {
+                fprintf(stderr, "Failed to add %s: %s\n", *oid,
+                        te_rc_err2str(rc));
+                goto cleanup;
+            }
+        }
+    }
+
+    printf("%u instances, %u rounds\n", num, rounds);
+    if (bench_run("brothers traversal", bench_find_traverse,
+                  oids, num, rounds) != 0 ||
+        bench_run("cfg_db_find()", cfg_db_find, oids, num, rounds) != 0)
+    {
+        goto cleanup;
+    }
+
+    result = EXIT_SUCCESS;
+
+cleanup:
+    if (oids != NULL)
+    {
+        for (i = 0; i < num; i++)
+            free(oids[i]);
+        free(oids);
+    }
+    cfg_db_destroy();
+
+    return result;
+}
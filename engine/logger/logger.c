@@ -12,6 +12,9 @@
 #if HAVE_SYS_TIME_H
 #include <sys/time.h>
 #endif
+#if HAVE_SYS_POLL_H
+#include <sys/poll.h>
+#endif
 #if HAVE_TIME_H
 #include <time.h>
 #endif
@@ -38,6 +41,12 @@
 
 #define LGR_TA_MAX_BUF      0x4000 /* FIXME */
 
+/**
+ * Maximum amount of log data in bytes a TA may send in one answer
+ * in log streaming mode.
+ */
+#define LGR_TA_STREAM_CREDIT    0x10000
+
 /** Initial (minimum) Logger message buffer size */
 #define LGR_MSG_BUF_MIN     0x100
 
@@ -309,6 +318,43 @@ wait_for_finished_insts(void)
 /** Forward declaration */
 static void * ta_handler(void *ta);
 
+/**
+ * Register log messages received in one batch.
+ *
+ * @param buf       Messages prefixed by their lengths
+ * @param len       Length of the batch
+ */
+static void
+te_handler_batch(const uint8_t *buf, size_t len)
+{
+    uint32_t msg_len;
+
+    while (len > 0)
+    {
+        if (len < sizeof(msg_len))
+        {
+            ERROR("Truncated batch of log messages, %u bytes lost",
+                  (unsigned int)len);
+            return;
+        }
+        memcpy(&msg_len, buf, sizeof(msg_len));
+        msg_len = ntohl(msg_len);
+        buf += sizeof(msg_len);
+        len -= sizeof(msg_len);
+
+        if (msg_len > len)
+        {
+            ERROR("Invalid length %u of log message in batch, "
+                  "%u bytes left", msg_len, (unsigned int)len);
+            return;
+        }
+
+        lgr_register_message(buf, msg_len);
+        buf += msg_len;
+        len -= msg_len;
+    }
+}
+
 /**
  * This is an entry point of logger message server.
  * This server should be run as separate thread.
@@ -380,18 +426,22 @@ te_handler(void)
             len = buf_len - received;
             rc = ipc_receive_message(srv, (uint8_t *)buf + received,
                                      &len, &ipcsc_p);
+            /*
+             * Failures of a client (e.g. closed connection) do not
+             * prevent receiving messages from others.
+             */
             if (rc != 0)
             {
                 ERROR("Failed to receive the rest of the message "
                       "from client, rest=%u: %r", len, rc);
-                break;
+                continue;
             }
             if (received + len != total)
             {
                 ERROR("Invalid length of the rest of the message "
                       "in comparison with declared first: total=%u, "
                       "first=%u, rest=%u", total, received, len);
-                break;
+                continue;
             }
             /* 'len' should contain full length of the message */
             len = total;
@@ -479,6 +529,13 @@ te_handler(void)
                           err_buf);
                 }
             }
+            /* Check whether several messages are sent at once */
+            else if (ml == strlen(LGR_SRV_BATCH) &&
+                     strncmp(msg, LGR_SRV_BATCH, ml) == 0)
+            {
+                te_handler_batch((uint8_t *)msg + ml,
+                                 len - sizeof(te_log_nfl) - ml);
+            }
             else
             {
                 lgr_register_message(buf, len);
@@ -530,6 +587,11 @@ ta_flush_done(struct ipc_server *srv)
  * This routine periodically polls appropriate TA to get
  * TA local log. Besides, log is solicited if flush is requested.
  *
+ * In streaming mode log is passed in memory instead of temporary files,
+ * TA is polled again immediately while it reports pending messages and
+ * it is polled with short idle period otherwise. If TA does not
+ * support streaming, the routine falls back to polling mode.
+ *
  * @param  ta   Location of TA parameters.
  *
  * @return NULL
@@ -542,7 +604,7 @@ ta_handler(void *ta)
     char                srv_name[LGR_MAX_NAME];
     struct ipc_server  *srv = NULL;
     int                 fd_server;
-    fd_set              rfds;
+    struct pollfd       pfd;
     int                 rc;
     pthread_t           sniffer_thread;
     char                err_buf[BUFSIZ];
@@ -568,10 +630,15 @@ ta_handler(void *ta)
     FILE               *ta_file;
     uint8_t             buf[LGR_TA_MAX_BUF];
 
+    /* Log streaming variables */
+    uint8_t            *stream_buf = NULL;
+    size_t              stream_len;
+    te_bool             more = FALSE;
+
 
     /* Register IPC Server for the TA */
     TE_SPRINTF(srv_name, "%s%s", LGR_SRV_FOR_TA_PREFIX, inst->agent);
-    rc = ipc_register_server(srv_name, LOGGER_IPC, &srv);
+    rc = ipc_register_server(srv_name, LOGGER_TA_IPC, &srv);
     if (rc != 0)
     {
         ERROR("Failed to register IPC server '%s': %r", srv_name, rc);
@@ -584,9 +651,23 @@ ta_handler(void *ta)
     /* Do not allow to poll in flood mode */
     if (inst->polling == 0)
         inst->polling = LGR_TA_POLL_DEF;
+    if (inst->stream_idle == 0)
+        inst->stream_idle = LGR_TA_STREAM_IDLE_DEF;
+
+    if (inst->streaming)
+    {
+        stream_buf = malloc(LGR_TA_STREAM_CREDIT);
+        if (stream_buf == NULL)
+        {
+            ERROR("TA %s: failed to allocate log streaming buffer, "
+                  "fall back to polling mode", inst->agent);
+            inst->streaming = FALSE;
+        }
+    }
 
     /* Recalculate polling timeout in microseconds */
-    polling = TE_MS2US(inst->polling);
+    polling = TE_MS2US(inst->streaming ? inst->stream_idle :
+                                         inst->polling);
 
     /* It not so important to poll at start up */
     gettimeofday(&poll_ts, NULL);
@@ -611,10 +692,10 @@ ta_handler(void *ta)
         }
 
         /*
-         * If we are not flushing, wait for polling timeout or
-         * flush request
+         * If we are not flushing and TA has no pending messages,
+         * wait for polling timeout or flush request
          */
-        if (!do_flush)
+        if (!do_flush && !more)
         {
             struct timeval delay = { 0, 0 };
 
@@ -649,17 +730,19 @@ ta_handler(void *ta)
                 }
             }
 
-            FD_ZERO(&rfds);
-            FD_SET(fd_server, &rfds);
+            pfd.fd = fd_server;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
 
-            rc = select(fd_server + 1, &rfds, NULL, NULL, &delay);
+            rc = poll(&pfd, 1, delay.tv_sec * 1000 +
+                               (delay.tv_usec + 999) / 1000);
             if (rc < 0)
             {
                 break;
             }
             else if (rc > 0)
             {
-                if (FD_ISSET(fd_server, &rfds))
+                if (pfd.revents & POLLIN)
                 {
                     /* Go into the logs flush mode */
                     do_flush = TRUE;
@@ -668,7 +751,7 @@ ta_handler(void *ta)
                 }
                 else
                 {
-                    ERROR("FATAL ERROR: TA %s: select() returns %d, "
+                    ERROR("FATAL ERROR: TA %s: poll() returns %d, "
                           "but server fd is not readable",
                           inst->agent, rc);
                     break;
@@ -682,7 +765,32 @@ ta_handler(void *ta)
         gettimeofday(&poll_ts, NULL);
 
         *log_file = '\0';
-        if ((rc = rcf_ta_get_log(inst->agent, log_file)) != 0)
+        if (inst->streaming)
+        {
+            stream_len = LGR_TA_STREAM_CREDIT;
+            more = FALSE;
+            rc = rcf_ta_get_log_data(inst->agent, stream_buf, &stream_len,
+                                     &more);
+            /*
+             * Agents without streaming support reject the credit
+             * argument of 'get_log' as a bad protocol command.
+             */
+            if (rc == TE_RC(TE_RCF_PCH, TE_EFMT) ||
+                TE_RC_GET_ERROR(rc) == TE_EOPNOTSUPP)
+            {
+                WARN("TA %s does not support log streaming (%r), "
+                     "fall back to polling mode", inst->agent, rc);
+                inst->streaming = FALSE;
+                polling = TE_MS2US(inst->polling);
+                continue;
+            }
+        }
+        else
+        {
+            rc = rcf_ta_get_log(inst->agent, log_file);
+        }
+
+        if (rc != 0)
         {
             /* Any error interrupts flush operation */
             if (do_flush)
@@ -706,45 +814,60 @@ ta_handler(void *ta)
             else
             {
                 /* The rest of errors are considered as fatal */
-                ERROR("rcf_ta_get_log(ta_name='%s') returned fatal error "
+                ERROR("Getting log of TA '%s' returned fatal error "
                       "%r, stop gathering logs from this TA",
                       inst->agent, rc);
                 break;
             }
         }
 
-        rc = stat(log_file, &log_file_stat);
-        if (rc < 0)
+        if (inst->streaming)
         {
-            ERROR("FATAL ERROR: TA %s: log file '%s' stat() failure: "
-                  "errno=%d", inst->agent, log_file, errno);
-            break;
+            ta_file = fmemopen(stream_buf, stream_len, "r");
+            if (ta_file == NULL)
+            {
+                ERROR("FATAL ERROR: TA %s: fmemopen() failure: errno=%d",
+                      inst->agent, errno);
+                break;
+            }
+            te_strlcpy(log_file, "<stream>", sizeof(log_file));
         }
-        else if (log_file_stat.st_size == 0)
+        else
         {
-            /* File is empty */
-            ERROR("TA %s: log file '%s' is empty", inst->agent, log_file);
-
-            if (remove(log_file) != 0)
+            rc = stat(log_file, &log_file_stat);
+            if (rc < 0)
             {
-                ERROR("Failed to delete log file '%s': errno=%d",
-                      log_file, errno);
-                /* Continue */
+                ERROR("FATAL ERROR: TA %s: log file '%s' stat() failure: "
+                      "errno=%d", inst->agent, log_file, errno);
+                break;
             }
-            if (do_flush)
+            else if (log_file_stat.st_size == 0)
             {
-                do_flush = FALSE;
-                flush_done = TRUE;
+                /* File is empty */
+                ERROR("TA %s: log file '%s' is empty",
+                      inst->agent, log_file);
+
+                if (remove(log_file) != 0)
+                {
+                    ERROR("Failed to delete log file '%s': errno=%d",
+                          log_file, errno);
+                    /* Continue */
+                }
+                if (do_flush)
+                {
+                    do_flush = FALSE;
+                    flush_done = TRUE;
+                }
+                continue;
             }
-            continue;
-        }
 
-        ta_file = fopen(log_file, "r");
-        if (ta_file == NULL)
-        {
-            ERROR("FATAL ERROR: TA %s: fopen(%s) failure: errno=%d",
-                  inst->agent, log_file, errno);
-            break;
+            ta_file = fopen(log_file, "r");
+            if (ta_file == NULL)
+            {
+                ERROR("FATAL ERROR: TA %s: fopen(%s) failure: errno=%d",
+                      inst->agent, log_file, errno);
+                break;
+            }
         }
 
         do { /* messages reading loop */
@@ -870,7 +993,7 @@ ta_handler(void *ta)
                   inst->agent, log_file, errno);
             /* Continue */
         }
-        if (remove(log_file) != 0)
+        if (!inst->streaming && remove(log_file) != 0)
         {
             ERROR("TA %s: Failed to delete file '%s': errno=%d",
                   inst->agent, log_file, errno);
@@ -890,6 +1013,8 @@ ta_handler(void *ta)
         (void)ta_flush_done(srv);
     }
 
+    free(stream_buf);
+
     rc = ipc_close_server(srv);
     if (rc != 0)
     {
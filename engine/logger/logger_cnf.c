@@ -54,6 +54,8 @@ struct ta_cfg {
     ta_rule *rules;           /**< Array of rules */
     int      rules_num;       /**< Size of the rules array */
     int      polling_default; /**< Default polling setting */
+    te_bool  no_streaming;    /**< Disable log streaming mode */
+    int      stream_idle;     /**< Polling setting in streaming mode */
 } ta_cfg;
 
 /*
@@ -340,6 +342,80 @@ handle_polling(yaml_document_t *d, yaml_node_t *section)
     return 0;
 }
 
+/**
+ * Parse the "streaming" section of the config file.
+ *
+ * @param d         YAML document
+ * @param section   YAML node for this section
+ *
+ * @return Status information
+ *
+ * @retval 0            Success.
+ * @retval Negative     Failure.
+ */
+static int
+handle_streaming(yaml_document_t *d, yaml_node_t *section)
+{
+    te_errno          rc;
+    te_bool           enable;
+    yaml_node_pair_t *pair;
+
+    if (section->type != YAML_MAPPING_NODE)
+    {
+        ERROR("%s: Expected a mapping, got something else", __FUNCTION__);
+        return -1;
+    }
+
+    for (pair = section->data.mapping.pairs.start;
+         pair < section->data.mapping.pairs.top; pair++)
+    {
+        yaml_node_t *k = yaml_document_get_node(d, pair->key);
+        yaml_node_t *v = yaml_document_get_node(d, pair->value);
+        const char  *key   = te_yaml_scalar_value(k);
+        const char  *value = te_yaml_scalar_value(v);
+
+        if (key == NULL)
+        {
+            ERROR("%s: Non-scalar key in mapping", __FUNCTION__);
+            return -1;
+        }
+
+        if (value == NULL)
+        {
+            ERROR("%s: Non-scalar value for key %s", __FUNCTION__, key);
+            return -1;
+        }
+
+        if (strcmp(key, "enable") == 0)
+        {
+            rc = te_strtol_bool(value, &enable);
+            if (rc != 0)
+            {
+                ERROR("%s: Invalid value for \"enable\": %s",
+                      __FUNCTION__, value);
+                return -1;
+            }
+            ta_cfg.no_streaming = !enable;
+        }
+        else if (strcmp(key, "idle") == 0)
+        {
+            rc = te_strtoi(value, 0, &ta_cfg.stream_idle);
+            if (rc != 0 || ta_cfg.stream_idle < 0)
+            {
+                ERROR("%s: Invalid value for \"idle\": %s",
+                      __FUNCTION__, value);
+                return -1;
+            }
+        }
+        else
+        {
+            WARN("%s: Unknown streaming setting: %s", __FUNCTION__, key);
+        }
+    }
+
+    return 0;
+}
+
 /**
  * Parse the "sniffers" section of the config file.
  *
@@ -1179,6 +1255,7 @@ config_parser_yaml(const char *filename)
     yaml_document_t   document;
     yaml_node_t      *root             = NULL;
     yaml_node_t      *polling          = NULL;
+    yaml_node_t      *streaming        = NULL;
     yaml_node_t      *sniffers_default = NULL;
     yaml_node_t      *sniffers         = NULL;
     yaml_node_t      *threads          = NULL;
@@ -1245,6 +1322,8 @@ config_parser_yaml(const char *filename)
 
         if (strcmp(key, "polling") == 0)
             polling = v;
+        else if (strcmp(key, "streaming") == 0)
+            streaming = v;
         else if (strcmp(key, "sniffers_default") == 0)
             sniffers_default = v;
         else if (strcmp(key, "sniffers") == 0)
@@ -1260,6 +1339,9 @@ config_parser_yaml(const char *filename)
     if (res == 0 && polling != NULL)
         res = handle_polling(&document, polling);
 
+    if (res == 0 && streaming != NULL)
+        res = handle_streaming(&document, streaming);
+
     if (res == 0 && sniffers_default != NULL)
         res = handle_sniffers(&document, sniffers_default);
 
@@ -1361,6 +1443,8 @@ config_ta(ta_inst *ta)
     regmatch_t     pmatch[1];
 
     ta->polling = ta_cfg.polling_default;
+    ta->streaming = !ta_cfg.no_streaming;
+    ta->stream_idle = ta_cfg.stream_idle;
     for (; rule < last; rule++)
     {
         if (rule->name)
@@ -58,6 +58,12 @@ extern "C" {
 /** Default TA polling timeout in milliseconds */
 #define LGR_TA_POLL_DEF         1000     /* 1 second */
 
+/**
+ * Default timeout in milliseconds to poll TA which has no pending
+ * messages in log streaming mode.
+ */
+#define LGR_TA_STREAM_IDLE_DEF  10
+
 /**
  * Maximum number of messages to be get during flush.
  * It is required to cope with permanent logging on TA
@@ -109,6 +115,11 @@ typedef struct ta_inst {
                                               nmbr */
     int             polling;             /**< Polling parameter value
                                               (in milliseconds) */
+    te_bool         streaming;           /**< Get TA log in streaming
+                                              mode */
+    int             stream_idle;         /**< Polling timeout in
+                                              streaming mode (in
+                                              milliseconds) */
     te_bool         thread_run;          /**< Is thread running? */
     pthread_t       thread;              /**< Thread identifier */
     int             flush_log;           /**< 0 - normal processing;
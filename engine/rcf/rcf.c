@@ -101,6 +101,9 @@ static const char *tce_conf_file = NULL;    /**< The TCE configuration file. */
 static rcf_tce_conf_t *tce_conf = NULL;     /**< The TCE configuration. */
 
 static const char *cfg_file;    /**< Configuration file name */
+static int cmd_window = RCF_CMD_WINDOW_DEFAULT; /**< Default maximum
+                                                     number of outstanding
+                                                     commands per TA */
 static ta *agents = NULL;       /**< List of Test Agents */
 static int ta_num = 0;          /**< Number of Test Agents */
 static int shutdown_num = 0;    /**< Number of TA which should be
@@ -405,6 +408,24 @@ parse_config_ta(xmlNodePtr ta_node)
     if (attribute_contains_yes(ta_node, "fake"))
         agent->flags |= TA_FAKE;
 
+    agent->window = cmd_window;
+    attr = xmlGetProp_exp(ta_node, (const xmlChar *)"cmd_window");
+    if (attr != NULL)
+    {
+        int window;
+
+        if (te_strtoi(attr, 10, &window) != 0 ||
+            window < 1 || window > RCF_CMD_WINDOW_MAX)
+        {
+            ERROR("Invalid cmd_window '%s' of TA '%s', it should be "
+                  "from 1 to %u", attr, agent->name, RCF_CMD_WINDOW_MAX);
+            free(attr);
+            return TE_RC(TE_RCF, TE_EINVAL);
+        }
+        agent->window = window;
+        free(attr);
+    }
+
     te_kvpair_init(&agent->conf);
 
     attr = xmlGetProp_exp(ta_node, (const xmlChar *)"confstr");
@@ -969,7 +990,7 @@ rcf_set_ta_dead(ta *agent)
             ERROR("Failed to close connection with TA '%s': rc=%r",
                   agent->name, rc);
         agent->flags |= TA_DEAD;
-        agent->conn_locked = FALSE;
+        agent->in_window = 0;
     }
 }
 
@@ -1071,7 +1092,7 @@ rcf_init_agent(ta *agent)
     if (rc != 0)
         rcf_set_ta_unrecoverable(agent);
     else
-        agent->conn_locked = FALSE;
+        agent->in_window = 0;
 
     return rc;
 }
@@ -1171,6 +1192,320 @@ save_attachment(ta *agent, rcf_msg *msg, size_t cmdlen, char *ba)
 }
 
 
+/**
+ * Put binary attachment to the data of the user request message.
+ * The message is reallocated to fit the attachment.
+ *
+ * @param agent         Test Agent structure
+ * @param req           user request
+ * @param cmdlen        command length (including binary attachment)
+ * @param ba            pointer to the first byte after end marker
+ * @param maxlen        maximum attachment length accepted by the user
+ *
+ * @return Status code.
+ */
+static te_errno
+read_attachment_data(ta *agent, usrreq *req, size_t cmdlen, char *ba,
+                     size_t maxlen)
+{
+    rcf_msg *new_msg;
+    size_t   len;
+    size_t   copy_len;
+    size_t   offset;
+
+    assert((ba - cmd) >= 0);
+    assert(cmdlen >= (size_t)(ba - cmd));
+    len = cmdlen - (ba - cmd);
+    VERB("Read attachment length=%u", (unsigned)len);
+
+    new_msg = realloc(req->message, sizeof(rcf_msg) + len);
+    if (new_msg == NULL)
+        return TE_RC(TE_RCF, TE_ENOMEM);
+    req->message = new_msg;
+
+    copy_len = MIN(len, sizeof(cmd) - (size_t)(ba - cmd));
+    memcpy(new_msg->data, ba, copy_len);
+
+    for (offset = copy_len; offset < len; offset += copy_len)
+    {
+        size_t   chunk_len = sizeof(cmd);
+        te_errno rc;
+
+        rc = (agent->m.receive)(agent->handle, cmd, &chunk_len, NULL);
+        if (rc != 0 && rc != TE_RC(TE_COMM, TE_EPENDING))
+        {
+            ERROR("Failed receive rest of binary attachment TA %s",
+                  agent->name);
+            return TE_RC(TE_RCF, TE_EIO);
+        }
+        copy_len = MIN(len - offset, sizeof(cmd));
+        memcpy(new_msg->data + offset, cmd, copy_len);
+    }
+
+    if (len > maxlen)
+    {
+        ERROR("TA %s sent %u bytes of attachment, but only %u are "
+              "expected", agent->name, (unsigned)len, (unsigned)maxlen);
+        return TE_RC(TE_RCF, TE_ESMALLBUF);
+    }
+
+    new_msg->data_len = len;
+
+    return 0;
+}
+
+
+/**
+ * Get time interval between two moments in microseconds.
+ *
+ * @param from          start of the interval
+ * @param to            end of the interval
+ *
+ * @return Interval length or 0 if @p to precedes @p from.
+ */
+static uint64_t
+rcf_tv_diff_us(const struct timeval *from, const struct timeval *to)
+{
+    int64_t diff = ((int64_t)to->tv_sec - from->tv_sec) * 1000000 +
+                   (to->tv_usec - from->tv_usec);
+
+    return diff > 0 ? (uint64_t)diff : 0;
+}
+
+/**
+ * Update commands processing statistics of the TA when the final answer
+ * on the request is received.
+ *
+ * @param agent         Test Agent structure
+ * @param req           user request
+ */
+static void
+rcf_cmd_stats_update(ta *agent, const usrreq *req)
+{
+    ta_cmd_stats   *stats = &agent->stats;
+    struct timeval  now;
+    uint64_t        latency;
+    uint64_t        ms;
+    unsigned int    i;
+
+    gettimeofday(&now, NULL);
+    latency = rcf_tv_diff_us(&req->received, &now);
+
+    stats->cmds++;
+    stats->latency_sum += latency;
+    stats->latency_max = MAX(stats->latency_max, latency);
+    stats->queued_sum += rcf_tv_diff_us(&req->received, &req->transmitted);
+
+    for (i = 0, ms = latency / 1000;
+         ms > 0 && i < RCF_LATENCY_HIST_SIZE - 1;
+         ms >>= 1, i++);
+    stats->latency_hist[i]++;
+
+    if (req->rpc_stats != NULL)
+    {
+        te_hist_add(&req->rpc_stats->latency, latency);
+        te_hist_add(&req->rpc_stats->queued,
+                    rcf_tv_diff_us(&req->received, &req->transmitted));
+    }
+}
+
+/**
+ * Find statistics of RPC function called by the request, creating
+ * them if necessary.
+ *
+ * @param agent         Test Agent structure
+ * @param msg           RCFOP_RPC message with encoded call
+ *
+ * @return Statistics or @c NULL if the name of the function cannot
+ *         be extracted from the call.
+ */
+static ta_rpc_stats *
+rcf_rpc_stats_find(ta *agent, const rcf_msg *msg)
+{
+    const uint8_t *data = (const uint8_t *)msg->file;
+    ta_rpc_stats  *stats;
+    uint32_t       len;
+
+    /*
+     * Calls encoded in XDR start with the routine name encoded as
+     * a 32-bit length (including null byte) and the name itself.
+     */
+    if (msg->intparm < (int)sizeof(len) || data[0] == '<')
+        return NULL;
+
+    len = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+          ((uint32_t)data[2] << 8) | data[3];
+    if (len < 2 || len > RCF_MAX_NAME ||
+        len > (uint32_t)msg->intparm - sizeof(len) ||
+        data[sizeof(len) + len - 1] != '\0')
+        return NULL;
+
+    for (stats = agent->rpc_stats; stats != NULL; stats = stats->next)
+    {
+        if (strcmp(stats->name, (const char *)data + sizeof(len)) == 0)
+            return stats;
+    }
+
+    if ((stats = malloc(sizeof(*stats))) == NULL)
+        return NULL;
+
+    memcpy(stats->name, data + sizeof(len), len);
+    te_hist_init(&stats->latency);
+    te_hist_init(&stats->queued);
+    stats->next = agent->rpc_stats;
+    agent->rpc_stats = stats;
+
+    return stats;
+}
+
+/**
+ * Log per-function RPC statistics of the TA as MI measurements and
+ * release them.
+ *
+ * @param agent         Test Agent structure
+ */
+static void
+rcf_rpc_stats_log(ta *agent)
+{
+    ta_rpc_stats *stats;
+    te_mi_logger *logger = NULL;
+    te_string     name = TE_STRING_INIT;
+
+    if (agent->rpc_stats == NULL)
+        return;
+
+    if (te_mi_logger_meas_create("rcf", &logger) == 0)
+        te_mi_logger_add_meas_key(logger, NULL, "ta", "%s", agent->name);
+
+    while ((stats = agent->rpc_stats) != NULL)
+    {
+        if (logger != NULL)
+        {
+            te_string_reset(&name);
+            te_string_append(&name, "%s latency", stats->name);
+            te_hist_mi_add(logger, NULL, &stats->latency,
+                           TE_MI_MEAS_LATENCY, name.ptr,
+                           TE_MI_MEAS_MULTIPLIER_MICRO);
+
+            te_string_reset(&name);
+            te_string_append(&name, "%s queued", stats->name);
+            te_hist_mi_add(logger, NULL, &stats->queued,
+                           TE_MI_MEAS_LATENCY, name.ptr,
+                           TE_MI_MEAS_MULTIPLIER_MICRO);
+        }
+
+        agent->rpc_stats = stats->next;
+        free(stats);
+    }
+
+    te_string_free(&name);
+    te_mi_logger_destroy(logger);
+}
+
+/**
+ * Log commands processing statistics of the TA.
+ *
+ * @param agent         Test Agent structure
+ */
+static void
+rcf_cmd_stats_log(ta *agent)
+{
+    const ta_cmd_stats *stats = &agent->stats;
+    te_string           hist = TE_STRING_INIT;
+    unsigned int        i;
+
+    if (stats->cmds == 0)
+        return;
+
+    for (i = 0; i < RCF_LATENCY_HIST_SIZE; i++)
+    {
+        if (stats->latency_hist[i] == 0)
+            continue;
+
+        if (i < RCF_LATENCY_HIST_SIZE - 1)
+            te_string_append(&hist, " <%ums:%u", 1U << i,
+                             stats->latency_hist[i]);
+        else
+            te_string_append(&hist, " >=%ums:%u", 1U << (i - 1),
+                             stats->latency_hist[i]);
+    }
+
+    RING("TA '%s' commands statistics: window %u (max used %u), "
+         "%u commands, latency avg %llu us max %llu us, "
+         "queued in RCF avg %llu us, %u commands waited for the window "
+         "(max queue depth %u), latency histogram:%s",
+         agent->name, agent->window, stats->window_max, stats->cmds,
+         (unsigned long long)(stats->latency_sum / stats->cmds),
+         (unsigned long long)stats->latency_max,
+         (unsigned long long)(stats->queued_sum / stats->cmds),
+         stats->waiting_num, stats->waiting_max,
+         hist.ptr == NULL ? "" : hist.ptr);
+
+    te_string_free(&hist);
+}
+
+/**
+ * Release the slot of the TA command window occupied by the request
+ * when the first answer (final or acknowledgement) on it is received.
+ *
+ * The TA processes commands one by one, so commands transmitted after
+ * the answered one could not be started yet: their timeouts are
+ * restarted to avoid false timeouts when the window is wider than one
+ * command.
+ *
+ * @param agent         Test Agent structure
+ * @param req           user request
+ */
+static void
+rcf_cmd_window_release(ta *agent, usrreq *req)
+{
+    usrreq *tmp;
+    time_t  now;
+
+    if (!req->in_window)
+        return;
+
+    req->in_window = FALSE;
+    if (agent->in_window > 0)
+        agent->in_window--;
+
+    if (agent->in_window == 0)
+        return;
+
+    now = time(NULL);
+    for (tmp = agent->sent.next; tmp != &agent->sent; tmp = tmp->next)
+    {
+        if (tmp->in_window)
+            tmp->sent = now;
+    }
+}
+
+/**
+ * Send commands from the waiting queue while there are free slots
+ * in the TA command window.
+ *
+ * New requests are inserted to the head of the queue. With the window
+ * of one command the most recent request is sent first as it has
+ * always been done; wider window serves the queue in the order of
+ * arrival.
+ *
+ * @param agent         Test Agent structure
+ */
+static void
+rcf_cmd_window_push(ta *agent)
+{
+    usrreq *req;
+
+    while (agent->in_window < agent->window &&
+           agent->waiting.next != &agent->waiting)
+    {
+        req = (agent->window == 1) ? agent->waiting.next :
+                                     agent->waiting.prev;
+        QEL_DELETE(req);
+        rcf_send_cmd(agent, req);
+    }
+}
+
 /**
  * Send pending command for specified SID.
  *
@@ -1380,6 +1715,8 @@ process_reply(ta *agent)
 
     READ_INT(error);
 
+    rcf_cmd_window_release(agent, req);
+
     if (TE_RC_GET_ERROR(error) == TE_EACK)
     {
         ack = TRUE;
@@ -1430,6 +1767,7 @@ process_reply(ta *agent)
                 break;
 
             case RCFOP_CONFGET:
+            case RCFOP_CONFGET_BULK:
                 if (ba != NULL)
                     save_attachment(agent, msg, len, ba);
                 else
@@ -1490,6 +1828,24 @@ process_reply(ta *agent)
             }
 
             case RCFOP_GET_LOG:
+                if (msg->intparm > 0)
+                {
+                    /* Streaming mode: pass the data in the answer */
+                    msg->num = 0;
+                    if (isdigit(*ptr))
+                        READ_INT(msg->num);
+                    if (ba == NULL)
+                        goto bad_protocol;
+
+                    rc = read_attachment_data(agent, req, len, ba,
+                                              msg->intparm);
+                    msg = req->message;
+                    if (rc != 0)
+                        msg->error = rc;
+                    break;
+                }
+                /*@fallthrough@*/
+
             case RCFOP_FGET:
                 if (ba == NULL)
                     goto bad_protocol;
@@ -1608,24 +1964,15 @@ process_reply(ta *agent)
 
     /* This value is necessary for the reboot state machine */
     last_opcode = msg->opcode;
+    rcf_cmd_stats_update(agent, req);
     rcf_answer_user_request(req);
 
     if (rcf_ta_reboot_on_req_reply(agent, last_opcode))
         return;
 
-    /* Push next waiting request */
+    /* Push next waiting requests */
 push:
-    if (agent->conn_locked && sid == agent->lock_sid)
-    {
-        agent->conn_locked = FALSE;
-        req = agent->waiting.next;
-
-        if (req != &agent->waiting)
-        {
-            QEL_DELETE(req);
-            rcf_send_cmd(agent, req);
-        }
-    }
+    rcf_cmd_window_push(agent);
 
     if (!ack)
         send_pending_command(agent, sid);
@@ -1736,8 +2083,11 @@ transmit_cmd(ta *agent, usrreq *req)
 
     VERB("The command is transmitted to %s", agent->name);
     req->sent = time(NULL);
-    agent->conn_locked = TRUE;
-    agent->lock_sid = req->message->sid;
+    gettimeofday(&req->transmitted, NULL);
+    req->in_window = TRUE;
+    agent->in_window++;
+    agent->stats.window_max = MAX(agent->stats.window_max,
+                                  agent->in_window);
 
     return 0;
 }
@@ -1866,14 +2216,22 @@ rcf_send_cmd(ta *agent, usrreq *req)
         return -1;
     }
 
-    if (agent->conn_locked)
+    if (agent->in_window >= agent->window)
     {
+        unsigned int  depth = 1;
+        usrreq       *tmp;
+
         if (req->message->opcode == RCFOP_REBOOT)
             return -1;
 
         INFO("Command '%s' is placed to waiting queue of TA %s",
              rcf_op_to_string(req->message->opcode), agent->name);
         QEL_INSERT(&(agent->waiting), req);
+
+        for (tmp = req->next; tmp != &agent->waiting; tmp = tmp->next)
+            depth++;
+        agent->stats.waiting_num++;
+        agent->stats.waiting_max = MAX(agent->stats.waiting_max, depth);
         return 0;
     }
 
@@ -1909,6 +2267,11 @@ rcf_send_cmd(ta *agent, usrreq *req)
             req->timeout = RCF_CMD_TIMEOUT;
             break;
 
+        case RCFOP_CONFGET_BULK:
+            PUT(TE_PROTO_CONFGET_BULK " %s", msg->id);
+            req->timeout = RCF_CMD_TIMEOUT;
+            break;
+
         case RCFOP_CONFDEL:
             PUT(TE_PROTO_CONFDEL " %s", msg->id);
             req->timeout = RCF_CMD_TIMEOUT;
@@ -1963,7 +2326,10 @@ rcf_send_cmd(ta *agent, usrreq *req)
                 rcf_answer_user_request(req);
                 return -1;
             }
-            PUT(TE_PROTO_GET_LOG);
+            if (msg->intparm > 0)
+                PUT(TE_PROTO_GET_LOG " %d", msg->intparm);
+            else
+                PUT(TE_PROTO_GET_LOG);
             req->timeout = RCF_CMD_TIMEOUT_HUGE;
             break;
 
@@ -2117,6 +2483,8 @@ rcf_send_cmd(ta *agent, usrreq *req)
 
         case RCFOP_RPC:
         {
+            req->rpc_stats = rcf_rpc_stats_find(agent, msg);
+
             PUT("%s %s %u ",
                 TE_PROTO_RPC, msg->id, (unsigned)msg->timeout);
 
@@ -2180,6 +2548,7 @@ rcf_alloc_usrreq(void)
         free(req);
         return NULL;
     }
+    gettimeofday(&req->received, NULL);
 
     return req;
 }
@@ -2499,6 +2868,7 @@ process_user_request(usrreq *req)
                 }
 
                 agent->enable_synch_time = msg->intparm ? TRUE : FALSE;
+                agent->window = cmd_window;
 
                 agent->sent.prev = agent->sent.next = &agent->sent;
                 agent->pending.prev = agent->pending.next = &agent->pending;
@@ -2858,6 +3228,9 @@ rcf_shutdown(void)
     }
     for (agent = agents; agent != NULL; agent = agent->next)
     {
+        rcf_cmd_stats_log(agent);
+        rcf_rpc_stats_log(agent);
+
         if ((agent->flags & TA_DOWN) == 0)
             ERROR("Soft shutdown of TA '%s' failed", agent->name);
         if (agent->handle != NULL)
@@ -2894,6 +3267,9 @@ process_cmd_line_opts(int argc, const char **argv)
           "Run in foreground (useful for debugging).", NULL },
         { "tce-conf", '\0', POPT_ARG_STRING, &tce_conf_file, 0,
           "Specify file with TCE configuration.", NULL },
+        { "cmd-window", '\0', POPT_ARG_INT, &cmd_window, 0,
+          "Default maximum number of commands sent to a Test Agent "
+          "without answer.", "NUM" },
 
         POPT_AUTOHELP
         POPT_TABLEEND
@@ -2915,6 +3291,14 @@ process_cmd_line_opts(int argc, const char **argv)
         return EXIT_FAILURE;
     }
 
+    if (cmd_window < 1 || cmd_window > RCF_CMD_WINDOW_MAX)
+    {
+        ERROR("Invalid commands window %d, it should be from 1 to %u",
+              cmd_window, RCF_CMD_WINDOW_MAX);
+        poptFreeContext(optCon);
+        return EXIT_FAILURE;
+    }
+
     cfg_file = poptGetArg(optCon);
     if (cfg_file == NULL)
     {
@@ -24,6 +24,7 @@
 #include "rcf_methods.h"
 #include "rcf_api.h"
 #include "rcf_internal.h"
+#include "te_hist.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -59,6 +60,18 @@ extern "C" {
  */
 #define RCF_CONFSET_TIMEOUT (RCF_CMD_TIMEOUT * 3)
 
+/**
+ * Default maximum number of commands transmitted to the TA and not
+ * answered (or acknowledged) yet. Value 1 means that commands are
+ * sent one by one.
+ */
+#define RCF_CMD_WINDOW_DEFAULT  1
+/** Upper limit for the number of outstanding commands */
+#define RCF_CMD_WINDOW_MAX      64
+
+/** Number of buckets in the histogram of commands latency */
+#define RCF_LATENCY_HIST_SIZE   16
+
 /** Special session identifiers */
 enum {
     /** Session used for Log gathering */
@@ -84,6 +97,16 @@ typedef struct usrreq usrreq;
  */
 typedef te_errno (* userreq_callback)(ta *agent, usrreq *req);
 
+/** Latency statistics of one RPC function called via the Test Agent */
+typedef struct ta_rpc_stats {
+    struct ta_rpc_stats *next;          /**< Next function in the list */
+    char                 name[RCF_MAX_NAME]; /**< RPC function name */
+    te_hist              latency;       /**< Latencies (from request
+                                             receiving to answer), usec */
+    te_hist              queued;        /**< Time spent in RCF queues
+                                             before transmission, usec */
+} ta_rpc_stats;
+
 /** One request from the user */
 struct usrreq {
     struct usrreq            *next;
@@ -93,8 +116,38 @@ struct usrreq {
     uint32_t                  timeout;  /**< Timeout in seconds */
     time_t                    sent;
     userreq_callback          cb;
+    te_bool                   in_window; /**< Request occupies a slot of
+                                              the TA command window */
+    struct timeval            received;  /**< Time when the request is
+                                              received from the user */
+    struct timeval            transmitted; /**< Time when the command is
+                                                transmitted to the TA */
+    ta_rpc_stats             *rpc_stats; /**< Statistics of the called
+                                              RPC function or @c NULL */
 };
 
+/** Statistics of commands processing for one Test Agent */
+typedef struct ta_cmd_stats {
+    unsigned int    cmds;           /**< Number of answered commands */
+    uint64_t        latency_sum;    /**< Sum of latencies (from request
+                                         receiving to answer), usec */
+    uint64_t        latency_max;    /**< Maximum latency, usec */
+    uint64_t        queued_sum;     /**< Sum of time spent in RCF
+                                         queues before transmission,
+                                         usec */
+    unsigned int    latency_hist[RCF_LATENCY_HIST_SIZE];
+                                    /**< Histogram of latencies:
+                                         bucket i counts commands with
+                                         latency less than 2^i ms (the
+                                         last one counts the rest) */
+    unsigned int    window_max;     /**< Maximum number of outstanding
+                                         commands */
+    unsigned int    waiting_num;    /**< Number of commands placed to
+                                         the waiting queue */
+    unsigned int    waiting_max;    /**< Maximum depth of the waiting
+                                         queue */
+} ta_cmd_stats;
+
 /** A description for a task/thread to be executed at TA startup */
 typedef struct ta_initial_task {
     rcf_execute_mode        mode;          /**< Task execution mode */
@@ -225,11 +278,20 @@ struct ta {
                                                  sending (in seconds) */
     int                 sid;                /**< Free session identifier
                                                  (starts from 2) */
-    te_bool             conn_locked;        /**< Connection is locked until
-                                                 the response from TA
-                                                 is received */
-    int                 lock_sid;           /**< SID of the command
-                                                 locked the connection */
+    unsigned int        window;             /**< Maximum number of
+                                                 commands transmitted
+                                                 to the TA without
+                                                 answer */
+    unsigned int        in_window;          /**< Number of commands
+                                                 transmitted to the TA
+                                                 and not answered (or
+                                                 acknowledged) yet; if
+                                                 it reaches @a window,
+                                                 new commands wait */
+    ta_cmd_stats        stats;              /**< Commands processing
+                                                 statistics */
+    ta_rpc_stats       *rpc_stats;          /**< Per-function statistics
+                                                 of RPCs */
     void               *dlhandle;           /**< Dynamic library handle */
     ta_initial_task    *initial_tasks;      /**< Startup tasks */
     char               *cold_reboot_ta;     /**< Cold reboot TA name */
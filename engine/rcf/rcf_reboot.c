@@ -217,7 +217,7 @@ log_flush_state_handler(ta *agent)
         if (req != NULL)
             return 0;
 
-        agent->conn_locked = FALSE;
+        agent->in_window = 0;
 
         if (agent->reboot_ctx.current_type == TA_REBOOT_TYPE_AGENT)
             rcf_set_ta_reboot_state(agent, TA_REBOOT_STATE_REBOOTING);
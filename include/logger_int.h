@@ -44,6 +44,14 @@ extern "C" {
 #endif
 
 #define LGR_SRV_SNIFFER_MARK "LGR-SNIFFER_MARK"
+
+/**
+ * Marker of the message which carries several raw log messages.
+ * The marker (prefixed by its length as usual control messages) is
+ * followed by raw log messages, each of them is prefixed by its
+ * length (32-bit, network byte order).
+ */
+#define LGR_SRV_BATCH "LGR-BATCH"
 #define SNIFFER_MIN_MARK_SIZE 512
 
 /* ==== Test Agent Logger lib definitions */
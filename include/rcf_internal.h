@@ -97,6 +97,8 @@ typedef enum {
     RCFOP_TADEAD,           /**< Inform RCF that TA is dead */
     RCFOP_GET_SNIFFERS,     /**< Obtain the list of sniffers */
     RCFOP_GET_SNIF_DUMP,    /**< Pull out capture logs of the sniffer */
+    RCFOP_CONFGET_BULK,     /**< Get all instances of the subtree
+                                 together with their values */
 } rcf_op_t;
 
 
@@ -195,6 +197,7 @@ rcf_op_to_string(rcf_op_t op)
         case RCFOP_CONFDEL:         return "configure delete";
         case RCFOP_CONFGRP_START:   return "configure group start";
         case RCFOP_CONFGRP_END:     return "configure group end";
+        case RCFOP_CONFGET_BULK:    return "configure bulk get";
         case RCFOP_GET_LOG:         return "get log";
         case RCFOP_VREAD:           return "vread";
         case RCFOP_VWRITE:          return "vwrite";
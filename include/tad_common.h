@@ -49,6 +49,8 @@
 #define CSAP_PARAM_FIRST_PACKET_TIME    "first_pkt_time"
 #define CSAP_PARAM_LAST_PACKET_TIME     "last_pkt_time"
 #define CSAP_PARAM_NO_MATCH_PKTS        "no_match_pkts"
+#define CSAP_PARAM_KERN_NO_MATCH_PKTS   "kern_no_match_pkts"
+#define CSAP_PARAM_SEND_CALLS           "send_calls"
 
 /**
  * Type for CSAP handle, should have semantic unsigned integer,
@@ -196,6 +198,24 @@ enum tad_eth_recv_mode {
 /** Receive nothing */
 #define TAD_ETH_RECV_NO     (0)
 
+/**
+ * Modes of spreading received packets over receive workers of CSAP
+ * (CSAP parameter 'receive-fanout').
+ */
+typedef enum tad_recv_fanout {
+    TAD_RECV_FANOUT_HASH = 0,   /**< By hash of the flow, packets of
+                                     the same flow are received by
+                                     the same worker (IP fragments
+                                     are not reassembled, so they
+                                     may be received by different
+                                     workers) */
+    TAD_RECV_FANOUT_CPU,        /**< By CPU which packet is received
+                                     on */
+} tad_recv_fanout;
+
+/** Maximum number of receive workers of CSAP */
+#define TAD_RECV_WORKERS_MAX    64
+
 /** Default IPv4 header size (without options) */
 #define TAD_IP4_HDR_LEN     20
 /** Default IPv6 header size (without options) */
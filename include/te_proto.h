@@ -21,6 +21,7 @@
 #define TE_PROTO_CONFDEL        "configure del"
 #define TE_PROTO_CONFGRP_START  "configure group start"
 #define TE_PROTO_CONFGRP_END    "configure group end"
+#define TE_PROTO_CONFGET_BULK   "configure bulkget"
 #define TE_PROTO_GET_LOG        "get_log"
 #define TE_PROTO_VREAD          "vread"
 #define TE_PROTO_VWRITE         "vwrite"
@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief ASN.1 library
+ *
+ * Implementation of arenas to allocate ASN.1 values from.
+ *
+ * Arena is a list of memory chunks, memory is carved from the current
+ * chunk sequentially and is never released separately. Arena counts
+ * references: one is held while the arena is open, one is held by each
+ * value of the arena which is not a child of another value of the same
+ * arena. The arena with all its chunks is freed when the last reference
+ * is dropped.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "asn_impl.h"
+
+/** Alignment of memory carved from arena */
+#define ASN_ARENA_ALIGN         sizeof(uint64_t)
+
+/** Size of the first chunk of arena (allocated together with arena) */
+#define ASN_ARENA_CHUNK_MIN     4096
+
+/** Maximum size of regular chunks of arena */
+#define ASN_ARENA_CHUNK_MAX     65536
+
+/** Chunk of arena memory */
+struct asn_arena_chunk {
+    struct asn_arena_chunk *next;   /**< Next chunk in the list */
+    uint64_t                data[]; /**< Memory of the chunk */
+};
+
+/** Offset of the first chunk allocated together with arena */
+#define ASN_ARENA_FIRST_OFFSET \
+    ((sizeof(asn_arena) + ASN_ARENA_ALIGN - 1) & ~(ASN_ARENA_ALIGN - 1))
+
+/** The first chunk of arena */
+#define ASN_ARENA_FIRST(_arena) \
+    ((struct asn_arena_chunk *)((uint8_t *)(_arena) + ASN_ARENA_FIRST_OFFSET))
+
+/** Arena values created in the thread are allocated from */
+static __thread asn_arena *asn_arena_cur = NULL;
+
+/* See description in asn_usr.h */
+asn_arena *
+asn_arena_open(void)
+{
+    asn_arena *arena;
+
+    arena = malloc(ASN_ARENA_FIRST_OFFSET + sizeof(struct asn_arena_chunk) +
+                   ASN_ARENA_CHUNK_MIN);
+    if (arena == NULL)
+        return NULL;
+
+    arena->prev = asn_arena_cur;
+    arena->refs = 1;
+    arena->foreign = FALSE;
+
+    /* The first chunk follows the arena itself */
+    arena->chunks = ASN_ARENA_FIRST(arena);
+    arena->chunks->next = NULL;
+    arena->ptr = (uint8_t *)arena->chunks->data;
+    arena->avail = ASN_ARENA_CHUNK_MIN;
+    arena->chunk_size = ASN_ARENA_CHUNK_MIN * 2;
+
+    asn_arena_cur = arena;
+
+    return arena;
+}
+
+/* See description in asn_usr.h */
+void
+asn_arena_close(asn_arena *arena)
+{
+    if (arena == NULL)
+        return;
+
+    if (asn_arena_cur == arena)
+        asn_arena_cur = arena->prev;
+    arena->prev = NULL;
+
+    asn_arena_unref(arena);
+}
+
+/* See description in asn_impl.h */
+asn_arena *
+asn_arena_current(void)
+{
+    return asn_arena_cur;
+}
+
+/* See description in asn_impl.h */
+void *
+asn_arena_alloc(asn_arena *arena, size_t size)
+{
+    struct asn_arena_chunk *chunk;
+    void                   *ptr;
+
+    size = (size + ASN_ARENA_ALIGN - 1) & ~(ASN_ARENA_ALIGN - 1);
+
+    if (size > arena->avail)
+    {
+        if (size > arena->chunk_size / 4)
+        {
+            /*
+             * Big block gets a chunk of its own which is linked after
+             * the current one, so the rest of the current is not lost.
+             */
+            chunk = malloc(sizeof(*chunk) + size);
+            if (chunk == NULL)
+                return NULL;
+
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+
+            return chunk->data;
+        }
+
+        chunk = malloc(sizeof(*chunk) + arena->chunk_size);
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->ptr = (uint8_t *)chunk->data;
+        arena->avail = arena->chunk_size;
+
+        if (arena->chunk_size < ASN_ARENA_CHUNK_MAX)
+            arena->chunk_size *= 2;
+    }
+
+    ptr = arena->ptr;
+    arena->ptr += size;
+    arena->avail -= size;
+
+    return ptr;
+}
+
+/* See description in asn_impl.h */
+te_bool
+asn_arena_grow(asn_arena *arena, void *ptr, size_t old_size, size_t size)
+{
+    size_t  grow;
+
+    old_size = (old_size + ASN_ARENA_ALIGN - 1) & ~(ASN_ARENA_ALIGN - 1);
+    size = (size + ASN_ARENA_ALIGN - 1) & ~(ASN_ARENA_ALIGN - 1);
+    grow = size - old_size;
+
+    /* Only the last block carved from the current chunk can grow */
+    if ((uint8_t *)ptr + old_size != arena->ptr || grow > arena->avail)
+        return FALSE;
+
+    arena->ptr += grow;
+    arena->avail -= grow;
+
+    return TRUE;
+}
+
+/* See description in asn_impl.h */
+void
+asn_arena_ref(asn_arena *arena)
+{
+    __atomic_add_fetch(&arena->refs, 1, __ATOMIC_RELAXED);
+}
+
+/* See description in asn_impl.h */
+void
+asn_arena_unref(asn_arena *arena)
+{
+    struct asn_arena_chunk *first = ASN_ARENA_FIRST(arena);
+    struct asn_arena_chunk *chunk;
+
+    if (__atomic_sub_fetch(&arena->refs, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+
+    while ((chunk = arena->chunks) != NULL)
+    {
+        arena->chunks = chunk->next;
+        if (chunk != first)
+            free(chunk);
+    }
+    free(arena);
+}
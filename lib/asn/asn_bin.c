@@ -0,0 +1,628 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief ASN.1 library
+ *
+ * Implementation of compact binary encoding of ASN.1 values.
+ *
+ * Encoding is driven by ASN.1 type known to both sides (like textual
+ * ASN.1 value notation), so neither names nor tags are transferred.
+ * Encoded value starts with ASN_BIN_MAGIC octet and version octet,
+ * then the value follows. Each value is encoded as its syntax octet
+ * followed by syntax-specific contents:
+ *  - BOOL: one octet, 0 or 1;
+ *  - INTEGER, ENUMERATED: zigzag-encoded variable length integer;
+ *  - UINTEGER: variable length integer;
+ *  - NULL: nothing;
+ *  - CHAR_STRING, OCT_STRING: length and octets;
+ *  - OID: number of sub-identifiers and zigzag-encoded sub-identifiers;
+ *  - SEQUENCE, SET: number of present children and pairs of index of
+ *    the child in the type named entries and the child value;
+ *  - CHOICE: index of the chosen entry and the child value;
+ *  - SEQUENCE_OF, SET_OF: number of elements and elements;
+ *  - TAGGED: the child value.
+ *
+ * Variable length integers are 32-bit values split into 7-bit groups,
+ * least significant first, with the most significant bit of each octet
+ * set if more octets follow.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "te_errno.h"
+#include "te_stdint.h"
+#include "te_defs.h"
+
+#include "asn_impl.h"
+
+#include "logger_api.h"
+
+/*
+ * Declarations of functions defined in asn_text.c.
+ */
+size_t number_of_digits(int value);
+
+size_t number_of_digits_unsigned(unsigned int value);
+
+/** Maximum length of variable length 32-bit integer */
+#define ASN_BIN_UINT_MAX_LEN    5
+
+/** Buffer to encode a value to */
+typedef struct asn_bin_wbuf {
+    uint8_t    *buf;    /**< Buffer or @c NULL to count length only */
+    size_t      size;   /**< Size of the buffer */
+    size_t      used;   /**< Number of octets required so far */
+} asn_bin_wbuf;
+
+/** Buffer to decode a value from */
+typedef struct asn_bin_rbuf {
+    const uint8_t  *p;      /**< Current position */
+    const uint8_t  *end;    /**< End of data */
+} asn_bin_rbuf;
+
+
+/**
+ * Put octets to the encoding buffer. Only length is counted if
+ * there is no space in the buffer.
+ *
+ * @param wb            Encoding buffer
+ * @param data          Octets to put
+ * @param len           Number of octets
+ */
+static inline void
+asn_bin_put_data(asn_bin_wbuf *wb, const void *data, size_t len)
+{
+    if (wb->used + len <= wb->size && len > 0)
+        memcpy(wb->buf + wb->used, data, len);
+    wb->used += len;
+}
+
+/**
+ * Put an octet to the encoding buffer.
+ *
+ * @param wb            Encoding buffer
+ * @param octet         Octet to put
+ */
+static inline void
+asn_bin_put_octet(asn_bin_wbuf *wb, uint8_t octet)
+{
+    if (wb->used < wb->size)
+        wb->buf[wb->used] = octet;
+    wb->used++;
+}
+
+/**
+ * Put variable length unsigned integer to the encoding buffer.
+ *
+ * @param wb            Encoding buffer
+ * @param value         Value to put
+ */
+static inline void
+asn_bin_put_uint(asn_bin_wbuf *wb, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        asn_bin_put_octet(wb, (value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    asn_bin_put_octet(wb, value);
+}
+
+/**
+ * Put variable length signed integer to the encoding buffer. Zigzag
+ * mapping is used to keep small negative numbers short.
+ *
+ * @param wb            Encoding buffer
+ * @param value         Value to put
+ */
+static inline void
+asn_bin_put_int(asn_bin_wbuf *wb, int32_t value)
+{
+    asn_bin_put_uint(wb, ((uint32_t)value << 1) ^
+                         (uint32_t)(value < 0 ? -1 : 0));
+}
+
+/**
+ * Find index of the chosen entry in CHOICE value.
+ *
+ * @param value         CHOICE value
+ * @param child         Chosen child value
+ * @param index         Location for the index
+ *
+ * @return Status code.
+ */
+static te_errno
+asn_bin_choice_index(const asn_value *value, const asn_value *child,
+                     unsigned int *index)
+{
+    const asn_named_entry_t *ne = value->asn_type->sp.named_entries;
+    unsigned int             i;
+
+    if (child->name == NULL)
+        return TE_EASNWRONGLABEL;
+
+    for (i = 0; i < value->asn_type->len; i++)
+    {
+        if (strcmp(ne[i].name, child->name) == 0)
+        {
+            *index = i;
+            return 0;
+        }
+    }
+
+    return TE_EASNWRONGLABEL;
+}
+
+/**
+ * Encode ASN.1 value to the buffer.
+ *
+ * @param value         ASN.1 value
+ * @param wb            Encoding buffer
+ *
+ * @return Status code.
+ */
+static te_errno
+asn_bin_put_value(const asn_value *value, asn_bin_wbuf *wb)
+{
+    const asn_value    *child;
+    unsigned int        num;
+    unsigned int        i;
+    te_errno            rc;
+
+    asn_bin_put_octet(wb, value->syntax);
+
+    switch (value->syntax)
+    {
+        case BOOL:
+            asn_bin_put_octet(wb, value->data.integer != 0);
+            break;
+
+        case INTEGER:
+        case ENUMERATED:
+            asn_bin_put_int(wb, value->data.integer);
+            break;
+
+        case UINTEGER:
+            asn_bin_put_uint(wb, (uint32_t)value->data.integer);
+            break;
+
+        case PR_ASN_NULL:
+            break;
+
+        case CHAR_STRING:
+            num = value->data.other == NULL ? 0 :
+                  strlen((const char *)value->data.other);
+            asn_bin_put_uint(wb, num);
+            asn_bin_put_data(wb, value->data.other, num);
+            break;
+
+        case OCT_STRING:
+            num = value->data.other == NULL ? 0 : value->len;
+            asn_bin_put_uint(wb, num);
+            asn_bin_put_data(wb, value->data.other, num);
+            break;
+
+        case OID:
+            num = value->data.other == NULL ? 0 : value->len;
+            asn_bin_put_uint(wb, num);
+            for (i = 0; i < num; i++)
+                asn_bin_put_int(wb, ((const int *)value->data.other)[i]);
+            break;
+
+        case SEQUENCE:
+        case SET:
+            for (i = 0, num = 0; i < value->len; i++)
+                num += (value->data.array[i] != NULL);
+
+            asn_bin_put_uint(wb, num);
+            for (i = 0; i < value->len; i++)
+            {
+                if ((child = value->data.array[i]) == NULL)
+                    continue;
+
+                asn_bin_put_uint(wb, i);
+                if ((rc = asn_bin_put_value(child, wb)) != 0)
+                    return rc;
+            }
+            break;
+
+        case SEQUENCE_OF:
+        case SET_OF:
+            for (i = 0, num = 0; i < value->len; i++)
+                num += (value->data.array[i] != NULL);
+
+            asn_bin_put_uint(wb, num);
+            for (i = 0; i < value->len; i++)
+            {
+                if ((child = value->data.array[i]) == NULL)
+                    continue;
+
+                if ((rc = asn_bin_put_value(child, wb)) != 0)
+                    return rc;
+            }
+            break;
+
+        case CHOICE:
+            if ((child = value->data.array[0]) == NULL)
+                return TE_EASNINCOMPLVAL;
+
+            if ((rc = asn_bin_choice_index(value, child, &num)) != 0)
+                return rc;
+
+            asn_bin_put_uint(wb, num);
+            return asn_bin_put_value(child, wb);
+
+        case TAGGED:
+            if ((child = value->data.array[0]) == NULL)
+                return TE_EASNINCOMPLVAL;
+
+            return asn_bin_put_value(child, wb);
+
+        default:
+            return TE_EOPNOTSUPP;
+    }
+
+    return 0;
+}
+
+/**
+ * Get variable length unsigned integer from the decoding buffer.
+ *
+ * @param rb            Decoding buffer
+ * @param value         Location for the value
+ *
+ * @return Status code.
+ */
+static inline te_errno
+asn_bin_get_uint(asn_bin_rbuf *rb, uint32_t *value)
+{
+    uint32_t        result = 0;
+    unsigned int    i;
+
+    for (i = 0; i < ASN_BIN_UINT_MAX_LEN && rb->p < rb->end; i++)
+    {
+        uint8_t octet = *rb->p++;
+
+        result |= (uint32_t)(octet & 0x7f) << (7 * i);
+        if ((octet & 0x80) == 0)
+        {
+            *value = result;
+            return 0;
+        }
+    }
+
+    return TE_EASNDERPARSE;
+}
+
+/**
+ * Get variable length signed integer from the decoding buffer.
+ *
+ * @param rb            Decoding buffer
+ * @param value         Location for the value
+ *
+ * @return Status code.
+ */
+static inline te_errno
+asn_bin_get_int(asn_bin_rbuf *rb, int32_t *value)
+{
+    uint32_t    zz;
+    te_errno    rc;
+
+    if ((rc = asn_bin_get_uint(rb, &zz)) != 0)
+        return rc;
+
+    *value = (int32_t)((zz >> 1) ^ -(zz & 1));
+
+    return 0;
+}
+
+/**
+ * Get number of octets or elements which must be present in the rest
+ * of the decoding buffer.
+ *
+ * @param rb            Decoding buffer
+ * @param value         Location for the number
+ *
+ * @return Status code.
+ */
+static inline te_errno
+asn_bin_get_len(asn_bin_rbuf *rb, uint32_t *value)
+{
+    te_errno rc = asn_bin_get_uint(rb, value);
+
+    if (rc == 0 && *value > (size_t)(rb->end - rb->p))
+        return TE_EASNDERPARSE;
+
+    return rc;
+}
+
+/**
+ * Decode ASN.1 value of specified type from the buffer.
+ *
+ * Values are built in the same way as by asn_parse_value_text(),
+ * so decoded value is exactly the same as parsed from the text.
+ *
+ * @param rb            Decoding buffer
+ * @param type          Expected ASN.1 type
+ * @param parsed        Location for the decoded value
+ *
+ * @return Status code.
+ */
+static te_errno
+asn_bin_get_value(asn_bin_rbuf *rb, const asn_type *type,
+                  asn_value **parsed)
+{
+    asn_value  *value;
+    asn_value  *child;
+    uint32_t    num;
+    uint32_t    idx;
+    uint32_t    i;
+    int32_t     integer;
+    te_errno    rc = 0;
+
+    if (rb->p == rb->end)
+        return TE_EASNDERPARSE;
+    if (*rb->p++ != type->syntax)
+    {
+        ERROR("%s(): value does not match type '%s'", __FUNCTION__,
+              type->name);
+        return TE_EASNWRONGTYPE;
+    }
+
+    value = asn_init_value(type);
+    if (value == NULL)
+        return TE_ENOMEM;
+
+    switch (type->syntax)
+    {
+        case BOOL:
+            if (rb->p == rb->end)
+            {
+                rc = TE_EASNDERPARSE;
+                break;
+            }
+            if (*rb->p++ != 0)
+            {
+                value->data.integer = ASN_TRUE;
+                value->txt_len = strlen("TRUE");
+            }
+            else
+            {
+                value->data.integer = ASN_FALSE;
+                value->txt_len = strlen("FALSE");
+            }
+            break;
+
+        case INTEGER:
+            if ((rc = asn_bin_get_int(rb, &integer)) != 0)
+                break;
+            value->data.integer = integer;
+            value->txt_len = number_of_digits(integer);
+            break;
+
+        case ENUMERATED:
+            if ((rc = asn_bin_get_int(rb, &integer)) != 0)
+                break;
+            value->data.integer = integer;
+            break;
+
+        case UINTEGER:
+            if ((rc = asn_bin_get_uint(rb, &num)) != 0)
+                break;
+            value->data.integer = (int)num;
+            value->txt_len = number_of_digits_unsigned(num);
+            break;
+
+        case PR_ASN_NULL:
+            value->data.integer = 0;
+            value->txt_len = strlen("NULL");
+            break;
+
+        case CHAR_STRING:
+        case OCT_STRING:
+            if ((rc = asn_bin_get_len(rb, &num)) != 0)
+                break;
+            rc = asn_write_primitive(value, rb->p, num);
+            rb->p += num;
+            break;
+
+        case OID:
+        {
+            int *subids;
+
+            if ((rc = asn_bin_get_len(rb, &num)) != 0 || num == 0)
+                break;
+
+            subids = malloc(num * sizeof(*subids));
+            if (subids == NULL)
+            {
+                rc = TE_ENOMEM;
+                break;
+            }
+            for (i = 0; i < num && rc == 0; i++)
+            {
+                rc = asn_bin_get_int(rb, &integer);
+                subids[i] = integer;
+            }
+            if (rc == 0)
+                rc = asn_write_primitive(value, subids, num);
+            free(subids);
+            break;
+        }
+
+        case SEQUENCE:
+        case SET:
+            if ((rc = asn_bin_get_len(rb, &num)) != 0)
+                break;
+
+            for (i = 0; i < num && rc == 0; i++)
+            {
+                if ((rc = asn_bin_get_uint(rb, &idx)) != 0)
+                    break;
+                if (idx >= type->len)
+                {
+                    rc = TE_EASNWRONGLABEL;
+                    break;
+                }
+
+                rc = asn_bin_get_value(rb, type->sp.named_entries[idx].type,
+                                       &child);
+                if (rc == 0)
+                    rc = asn_put_child_by_index(value, child, idx);
+            }
+            break;
+
+        case CHOICE:
+            if ((rc = asn_bin_get_uint(rb, &idx)) != 0)
+                break;
+            if (idx >= type->len)
+            {
+                rc = TE_EASNWRONGLABEL;
+                break;
+            }
+
+            rc = asn_bin_get_value(rb, type->sp.named_entries[idx].type,
+                                   &child);
+            if (rc == 0)
+                rc = asn_put_child_by_index(value, child, idx);
+            break;
+
+        case SEQUENCE_OF:
+        case SET_OF:
+            if ((rc = asn_bin_get_len(rb, &num)) != 0 || num == 0)
+                break;
+
+            /*
+             * Number of elements is known in advance, so the array
+             * is allocated at once instead of asn_insert_indexed()
+             * one by one.
+             */
+            value->data.array = asn_impl_alloc(value,
+                                    num * sizeof(*value->data.array));
+            if (value->data.array == NULL)
+            {
+                rc = TE_ENOMEM;
+                break;
+            }
+            for (i = 0; i < num; i++)
+            {
+                rc = asn_bin_get_value(rb, type->sp.subtype,
+                                       &value->data.array[i]);
+                if (rc != 0)
+                    break;
+                asn_impl_link_value(value, value->data.array[i]);
+                value->len = i + 1;
+            }
+            break;
+
+        case TAGGED:
+            rc = asn_bin_get_value(rb, type->sp.subtype,
+                                   &value->data.array[0]);
+            if (rc == 0)
+                asn_impl_link_value(value, value->data.array[0]);
+            break;
+
+        default:
+            rc = TE_EOPNOTSUPP;
+            break;
+    }
+
+    if (rc != 0)
+    {
+        asn_free_value(value);
+        return rc;
+    }
+
+    *parsed = value;
+
+    return 0;
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_count_bin_len(const asn_value *value, size_t *len)
+{
+    asn_bin_wbuf    wb = { .buf = NULL, .size = 0, .used = 0 };
+    te_errno        rc;
+
+    if (value == NULL || len == NULL)
+        return TE_EWRONGPTR;
+
+    asn_bin_put_octet(&wb, ASN_BIN_MAGIC);
+    asn_bin_put_octet(&wb, ASN_BIN_VERSION);
+    rc = asn_bin_put_value(value, &wb);
+    if (rc != 0)
+        return rc;
+
+    *len = wb.used;
+
+    return 0;
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_encode_bin(const asn_value *value, void *buf, size_t *len)
+{
+    asn_bin_wbuf    wb;
+    te_errno        rc;
+
+    if (value == NULL || buf == NULL || len == NULL)
+        return TE_EWRONGPTR;
+
+    wb.buf = buf;
+    wb.size = *len;
+    wb.used = 0;
+
+    asn_bin_put_octet(&wb, ASN_BIN_MAGIC);
+    asn_bin_put_octet(&wb, ASN_BIN_VERSION);
+    rc = asn_bin_put_value(value, &wb);
+    if (rc != 0)
+        return rc;
+
+    *len = wb.used;
+
+    return wb.used > wb.size ? TE_ESMALLBUF : 0;
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_decode_bin(const void *buf, size_t len, const asn_type *type,
+               asn_value **parsed, size_t *used)
+{
+    asn_bin_rbuf    rb;
+    te_errno        rc;
+
+    if (buf == NULL || type == NULL || parsed == NULL)
+        return TE_EWRONGPTR;
+
+    if (!asn_is_bin(buf, len))
+        return TE_EASNDERPARSE;
+
+    rb.p = buf;
+    rb.end = rb.p + len;
+
+    if (rb.p[1] == 0 || rb.p[1] > ASN_BIN_VERSION)
+    {
+        ERROR("%s(): unsupported version %u of binary encoding",
+              __FUNCTION__, rb.p[1]);
+        return TE_EPROTONOSUPPORT;
+    }
+    rb.p += 2;
+
+    rc = asn_bin_get_value(&rb, type, parsed);
+    if (rc == 0 && used != NULL)
+        *used = rb.p - (const uint8_t *)buf;
+
+    return rc;
+}
+
+/* See description in asn_usr.h */
+te_bool
+asn_is_bin(const void *buf, size_t len)
+{
+    return buf != NULL && len >= 2 &&
+           *(const uint8_t *)buf == ASN_BIN_MAGIC;
+}
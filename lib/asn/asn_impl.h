@@ -98,6 +98,26 @@ struct asn_type {
     } sp; /* syntax specific info */
 };
 
+/**
+ * Arena to allocate ASN.1 values from, see asn_arena.c.
+ */
+struct asn_arena {
+    asn_arena              *prev;       /**< Arena which was current in
+                                             the thread before this one
+                                             was opened */
+    unsigned int            refs;       /**< Number of references */
+    te_bool                 foreign;    /**< Values which are not from
+                                             the arena were put into
+                                             values of the arena */
+    struct asn_arena_chunk *chunks;     /**< List of memory chunks,
+                                             the current one first */
+    uint8_t                *ptr;        /**< Free memory of the current
+                                             chunk */
+    size_t                  avail;      /**< Size of free memory of
+                                             the current chunk */
+    size_t                  chunk_size; /**< Size of the next chunk */
+};
+
 /**
  * ASN.1 Value internal presentation
  */
@@ -148,6 +168,11 @@ struct asn_value
                         Root container is a container which was passed to
                         asn_walk_depth. Use asn_get_value_path from
                         walk_func to obtain this path */
+    te_bool         name_static; /**< Name is the label from ASN.1 type
+                                      which is shared, not owned */
+    asn_arena      *arena;    /**< Arena the value, its name and data
+                                   are allocated from or @c NULL if
+                                   they are allocated on heap */
 };
 
 /* See description in 'asn_usr.h' */
@@ -271,6 +296,125 @@ extern te_errno asn_get_child_by_index(const asn_value *container,
 
 extern te_bool asn_clean_count(asn_value *value);
 
+/**
+ * Get arena values created in the calling thread are allocated from.
+ *
+ * @return Arena or @c NULL if values are allocated on heap.
+ */
+extern asn_arena *asn_arena_current(void);
+
+/**
+ * Allocate memory from arena. The memory is released together
+ * with the arena.
+ *
+ * @param arena         Arena
+ * @param size          Size of memory
+ *
+ * @return Pointer to allocated memory or @c NULL.
+ */
+extern void *asn_arena_alloc(asn_arena *arena, size_t size);
+
+/**
+ * Try to grow memory block allocated from arena in place.
+ *
+ * @param arena         Arena
+ * @param ptr           Memory block
+ * @param old_size      Size of the block
+ * @param size          New size of the block (not less than old one)
+ *
+ * @return @c TRUE if the block is grown.
+ */
+extern te_bool asn_arena_grow(asn_arena *arena, void *ptr,
+                              size_t old_size, size_t size);
+
+/**
+ * Take reference to arena.
+ *
+ * @param arena         Arena
+ */
+extern void asn_arena_ref(asn_arena *arena);
+
+/**
+ * Drop reference to arena, the arena is freed when the last one
+ * is dropped.
+ *
+ * @param arena         Arena
+ */
+extern void asn_arena_unref(asn_arena *arena);
+
+/**
+ * Init empty ASN.1 value of specified type in the arena.
+ *
+ * @param arena         Arena or @c NULL to allocate value on heap
+ * @param type          ASN.1 type of the value
+ *
+ * @return New value or @c NULL if error occurred.
+ */
+extern asn_value *asn_impl_init_value(asn_arena *arena,
+                                      const asn_type *type);
+
+/**
+ * Make a copy of ASN.1 value in the arena.
+ *
+ * @param arena         Arena or @c NULL to allocate copy on heap
+ * @param value         Value to be copied
+ *
+ * @return Copy of the value or @c NULL if error occurred.
+ */
+extern asn_value *asn_impl_copy_value(asn_arena *arena,
+                                      const asn_value *value);
+
+/**
+ * Account the value put as a child into container: it is owned by
+ * the container from now on.
+ *
+ * @param container     Container
+ * @param value         New child of the container, may be @c NULL
+ */
+extern void asn_impl_link_value(asn_value *container, asn_value *value);
+
+/**
+ * Free the value which is removed from the container.
+ *
+ * @param value         Value to be freed
+ * @param container     Container which owned the value or @c NULL
+ *                      if the value is not owned by any other value
+ */
+extern void asn_impl_free_value(asn_value *value,
+                                const asn_value *container);
+
+/**
+ * Allocate memory for data of the value (from its arena or on heap).
+ *
+ * @param value         ASN.1 value
+ * @param size          Size of memory
+ *
+ * @return Pointer to allocated memory or @c NULL.
+ */
+extern void *asn_impl_alloc(const asn_value *value, size_t size);
+
+/**
+ * Change size of memory allocated for data of the value.
+ *
+ * @param value         ASN.1 value
+ * @param ptr           Memory allocated by asn_impl_alloc() or @c NULL
+ * @param old_size      Size of the memory
+ * @param size          New size of the memory
+ *
+ * @return Pointer to reallocated memory or @c NULL.
+ */
+extern void *asn_impl_realloc(const asn_value *value, void *ptr,
+                              size_t old_size, size_t size);
+
+/**
+ * Release memory allocated for data of the value. Memory from arena
+ * is released together with the arena.
+ *
+ * @param value         ASN.1 value
+ * @param ptr           Memory allocated by asn_impl_alloc() or @c NULL
+ */
+extern void asn_impl_release(const asn_value *value, void *ptr);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -1808,7 +1808,17 @@ asn_parse_dvalue_in_file(const char *filename, const asn_type *type,
         return TE_EIO;
     }
 
-    rc = asn_parse_value_text(buf, type, parsed_value, syms_parsed);
+    if (asn_is_bin(buf, flen))
+    {
+        size_t used = 0;
+
+        rc = asn_decode_bin(buf, flen, type, parsed_value, &used);
+        *syms_parsed = used;
+    }
+    else
+    {
+        rc = asn_parse_value_text(buf, type, parsed_value, syms_parsed);
+    }
 
     free(buf);
 
@@ -320,6 +320,41 @@ extern te_errno asn_assign_value(asn_value *dst, const asn_value *src);
  */
 extern void asn_free_value(asn_value *value);
 
+/**
+ * Arena to allocate ASN.1 values from.
+ */
+typedef struct asn_arena asn_arena;
+
+/**
+ * Open arena and make it current in the calling thread.
+ *
+ * Values created in the thread while the arena is current
+ * (by asn_init_value(), asn_copy_value(), parsing and decoding
+ * functions), children created in these values later, their names
+ * and data are carved from big memory chunks of the arena instead of
+ * being allocated one by one. Names of children are shared with
+ * labels of ASN.1 types.
+ *
+ * asn_free_value() does not release memory of values of the arena
+ * separately: all memory of the arena is released at once when
+ * the arena is closed and all values created in it are freed
+ * (children are freed together with their containers as usual).
+ * Values of one arena must not be modified from different threads
+ * concurrently.
+ *
+ * @return Arena or @c NULL if memory allocation failed.
+ */
+extern asn_arena *asn_arena_open(void);
+
+/**
+ * Close arena: values created in the calling thread are allocated
+ * from the arena which was current when this one was opened.
+ * Arenas must be closed in the reverse order of opening.
+ *
+ * @param arena     Arena opened by asn_arena_open() (may be @c NULL)
+ */
+extern void asn_arena_close(asn_arena *arena);
+
 
 /**
  * Obtain ASN.1 type to which specified value belongs.
@@ -366,12 +401,15 @@ extern te_errno asn_parse_value_text(const char *string,
                                      int *parsed_syms);
 
 /**
- * Read ASN.1 text file, parse DefinedValue of specified ASN.1 type
+ * Read ASN.1 text file, parse DefinedValue of specified ASN.1 type.
+ * File with value in binary encoding (see asn_encode_bin()) is
+ * decoded as well.
  *
  * @param filename      name of file to be parsed
  * @param type          expected type of value
  * @param parsed_value  parsed value (OUT)
- * @param syms_parsed   quantity of parsed symbols in 'text' (OUT)
+ * @param syms_parsed   quantity of parsed symbols in 'text' or decoded
+ *                      octets (OUT)
  *
  * @return zero on success, otherwise error code.
  */
@@ -449,6 +487,76 @@ extern te_errno asn_encode(void *buf, size_t *buf_len, asn_value *value);
 extern asn_value *asn_decode(const void *data);
 
 
+/*
+ * Compact binary encoding used instead of textual ASN.1 value notation
+ * to transfer values between Test Engine and Test Agents.
+ */
+
+/**
+ * First octet of binary encoded ASN.1 value. It never starts textual
+ * ASN.1 value notation, so it may be used to distinguish encodings.
+ */
+#define ASN_BIN_MAGIC       0xa5
+
+/** Version of binary encoding of ASN.1 values supported by the library */
+#define ASN_BIN_VERSION     1
+
+/**
+ * Count length of binary encoding of ASN.1 value.
+ *
+ * @param value         ASN.1 value
+ * @param len           Location for the length
+ *
+ * @return Status code.
+ */
+extern te_errno asn_count_bin_len(const asn_value *value, size_t *len);
+
+/**
+ * Encode ASN.1 value in the compact binary form. Decoding of the result
+ * by asn_decode_bin() produces the same value as parsing of the text
+ * printed by asn_sprint_value().
+ *
+ * @param value         ASN.1 value
+ * @param buf           Buffer for encoded value
+ * @param len           Size of the buffer (IN), length of encoded value
+ *                      or required size of the buffer (OUT)
+ *
+ * @return Status code.
+ * @retval TE_ESMALLBUF     Buffer is too small
+ * @retval TE_EOPNOTSUPP    Value contains syntax which is not supported
+ *                          (the same as by textual ASN.1 value notation)
+ */
+extern te_errno asn_encode_bin(const asn_value *value, void *buf,
+                               size_t *len);
+
+/**
+ * Decode ASN.1 value of specified type encoded by asn_encode_bin().
+ *
+ * @param buf           Encoded value
+ * @param len           Length of data in @p buf
+ * @param type          Expected type of value
+ * @param parsed        Location for decoded value
+ * @param used          Location for number of decoded octets
+ *                      (may be @c NULL)
+ *
+ * @return Status code.
+ * @retval TE_EPROTONOSUPPORT   Unsupported version of encoding
+ */
+extern te_errno asn_decode_bin(const void *buf, size_t len,
+                               const asn_type *type, asn_value **parsed,
+                               size_t *used);
+
+/**
+ * Check whether data look like ASN.1 value in binary encoding.
+ *
+ * @param buf           Data
+ * @param len           Length of data
+ *
+ * @return @c TRUE if data start with binary encoding header.
+ */
+extern te_bool asn_is_bin(const void *buf, size_t len);
+
+
 
 
 
@@ -908,6 +1016,90 @@ extern te_errno asn_read_value_field_fmt(const asn_value  *container,
                                          ...)
                                          __attribute__((format(printf, 4, 5)));
 
+/**
+ * Path to a descendant of ASN.1 value of the specified type with labels
+ * resolved to indices of children, see asn_path_compile().
+ */
+typedef struct asn_path asn_path;
+
+/**
+ * Compile textual labels of a descendant of ASN.1 value of the
+ * specified type to a path object. Labels are resolved to indices of
+ * children once, so the descendant of a value of this type is found
+ * by the path without comparing labels.
+ *
+ * If some `CHOICE` specifier is absent in labels, the rest of labels
+ * is resolved by name in the choice present in the value (as
+ * asn_find_descendant() does).
+ *
+ * @param type          ASN.1 type of the root value
+ * @param labels        textual ASN.1 labels of subvalue; see
+ *                      asn_free_subvalue method for more description
+ * @param path          Location for the path, should be released using
+ *                      asn_path_free()
+ *
+ * @return Status code.
+ */
+extern te_errno asn_path_compile(const asn_type *type, const char *labels,
+                                 asn_path **path);
+
+/**
+ * Release path compiled by asn_path_compile().
+ *
+ * @param path          Path or @c NULL
+ */
+extern void asn_path_free(asn_path *path);
+
+/**
+ * Get ASN.1 type of the root value the path is compiled for.
+ *
+ * @param path          Path or @c NULL
+ *
+ * @return ASN.1 type or @c NULL.
+ */
+extern const asn_type *asn_path_type(const asn_path *path);
+
+/**
+ * Find descendant value in ASN.1 value tree by compiled path, see
+ * asn_find_descendant(). If @p value is not of the type the path is
+ * compiled for, the path labels are resolved by name.
+ *
+ * @param value         Root of ASN.1 value tree
+ * @param path          Compiled path
+ * @param status        Location of status of operation,
+ *                      always changed unless @c NULL (OUT)
+ *
+ * @return pointer to found subvalue.
+ */
+extern asn_value *asn_path_find(const asn_value *value,
+                                const asn_path *path, te_errno *status);
+
+/**
+ * Version of asn_read_value_field() with compiled path.
+ */
+extern te_errno asn_read_value_field_path(const asn_value *container,
+                                          void *data, size_t *d_len,
+                                          const asn_path *path);
+
+/**
+ * Version of asn_write_value_field() with compiled path.
+ */
+extern te_errno asn_write_value_field_path(asn_value *container,
+                                           const void *data, size_t d_len,
+                                           const asn_path *path);
+
+/**
+ * Version of asn_read_int32() with compiled path.
+ */
+extern te_errno asn_read_int32_path(const asn_value *container,
+                                    int32_t *value, const asn_path *path);
+
+/**
+ * Version of asn_write_int32() with compiled path.
+ */
+extern te_errno asn_write_int32_path(asn_value *container, int32_t value,
+                                     const asn_path *path);
+
 /**
  * Get primitive value of enumeration type from ASN.1 value.
  *
@@ -127,22 +127,85 @@ asn_tag_equal(asn_tag_t l, asn_tag_t r)
 }
 
 
+/* See description in asn_impl.h */
+void *
+asn_impl_alloc(const asn_value *value, size_t size)
+{
+    if (value->arena != NULL)
+        return asn_arena_alloc(value->arena, size);
+
+    return malloc(size);
+}
+
+/* See description in asn_impl.h */
+void *
+asn_impl_realloc(const asn_value *value, void *ptr,
+                 size_t old_size, size_t size)
+{
+    void *new_ptr;
+
+    if (value->arena == NULL)
+        return realloc(ptr, size);
+
+    if (size == 0)
+        return NULL;
+    if (size <= old_size ||
+        (ptr != NULL && asn_arena_grow(value->arena, ptr, old_size, size)))
+        return ptr;
+
+    new_ptr = asn_arena_alloc(value->arena, size);
+    if (new_ptr != NULL && ptr != NULL)
+        memcpy(new_ptr, ptr, old_size);
+
+    return new_ptr;
+}
+
+/* See description in asn_impl.h */
+void
+asn_impl_release(const asn_value *value, void *ptr)
+{
+    if (value->arena == NULL)
+        free(ptr);
+}
+
 /**
- * Init empty ASN.1 value of specified type.
+ * Make a copy of the name for the value.
  *
- * @param type       ASN.1 type to which value should belong.
+ * @param value       ASN.1 value the name is for.
+ * @param name        Name to be copied.
  *
- * @return pointer to new ASN_value instance or NULL if error occurred.
+ * @return Copy of the name or NULL.
  */
+static char *
+asn_impl_strdup(const asn_value *value, const char *name)
+{
+    size_t  len;
+    char   *res;
+
+    if (name == NULL)
+        return NULL;
+
+    len = strlen(name) + 1;
+    res = asn_impl_alloc(value, len);
+    if (res != NULL)
+        memcpy(res, name, len);
+
+    return res;
+}
+
+/* See description in asn_impl.h */
 asn_value *
-asn_init_value(const asn_type * type)
+asn_impl_init_value(asn_arena *arena, const asn_type *type)
 {
     asn_value *new_value;
     int arr_len;
 
     if (type == NULL) return NULL;
 
-    new_value = malloc(sizeof(asn_value));
+    if (arena != NULL)
+        new_value = asn_arena_alloc(arena, sizeof(asn_value));
+    else
+        new_value = malloc(sizeof(asn_value));
     if (new_value == NULL)
         return NULL;
 
@@ -151,6 +214,7 @@ asn_init_value(const asn_type * type)
     new_value->asn_type = type;
     new_value->syntax   = type->syntax;
     new_value->tag      = type->tag;
+    new_value->arena    = arena;
 
     new_value->txt_len  = -1;
 
@@ -166,7 +230,13 @@ asn_init_value(const asn_type * type)
         case SET:
             {
                 size_t  sz = arr_len * sizeof(asn_value *);
-                void   *ptr = malloc(sz);
+                void   *ptr = asn_impl_alloc(new_value, sz);
+
+                if (ptr == NULL && sz > 0)
+                {
+                    asn_impl_release(new_value, new_value);
+                    return NULL;
+                }
 
                 new_value->len = arr_len;
                 new_value->data.array = ptr;
@@ -182,9 +252,26 @@ asn_init_value(const asn_type * type)
             new_value->data.integer = 0;
     }
 
+    /* The value is not owned by any other value of the arena yet */
+    if (arena != NULL)
+        asn_arena_ref(arena);
+
     return new_value;
 }
 
+/**
+ * Init empty ASN.1 value of specified type.
+ *
+ * @param type       ASN.1 type to which value should belong.
+ *
+ * @return pointer to new ASN_value instance or NULL if error occurred.
+ */
+asn_value *
+asn_init_value(const asn_type * type)
+{
+    return asn_impl_init_value(asn_arena_current(), type);
+}
+
 /**
  * Init empty ASN.1 value of specified type with certain ASN.1 tag.
  *
@@ -238,11 +325,12 @@ asn_assign_value(asn_value *dst, const asn_value *src)
         if (dst->data.array != NULL)
         {
             for (i = 0; i < (int)dst->len; i++)
-                 asn_free_value(dst->data.array[i]);
-            free(dst->data.array);
+                 asn_impl_free_value(dst->data.array[i], dst);
+            asn_impl_release(dst, dst->data.array);
         }
 
-        arr = dst->data.array = malloc(len * sizeof(asn_value *));
+        arr = dst->data.array = asn_impl_alloc(dst,
+                                               len * sizeof(asn_value *));
 
         if (arr==NULL)
         {
@@ -255,12 +343,17 @@ asn_assign_value(asn_value *dst, const asn_value *src)
         {
             if ((src_elem = src->data.array[i])!= NULL)
             {
-                if ((*arr = asn_copy_value(src_elem))==NULL)
+                if ((*arr = asn_impl_copy_value(dst->arena,
+                                                src_elem)) == NULL)
                 { /* ERROR! */
-                    free(dst->data.array);
+                    while (arr-- != dst->data.array)
+                        asn_impl_free_value(*arr, dst);
+                    asn_impl_release(dst, dst->data.array);
                     dst->data.array = NULL;
+                    dst->len = 0;
                     return ENOMEM;
                 }
+                asn_impl_link_value(dst, *arr);
             }
             else /* data is not specified yet, value is incomplete.*/
                 *arr = NULL;
@@ -274,7 +367,7 @@ asn_assign_value(asn_value *dst, const asn_value *src)
         if(src->syntax == BIT_STRING)
             len = (len + 7) >> 3;
 
-        free(dst->data.other);
+        asn_impl_release(dst, dst->data.other);
 
         if ((src->data.other == NULL) || (len == 0))
         { /* data is not specified yet, value is incomplete.*/
@@ -291,7 +384,7 @@ asn_assign_value(asn_value *dst, const asn_value *src)
             return 0;
         }
 
-        if ((dst->data.other = malloc (len))==NULL)
+        if ((dst->data.other = asn_impl_alloc(dst, len)) == NULL)
             return ENOMEM;
 
         memcpy (dst->data.other, src->data.other, len);
@@ -308,35 +401,51 @@ asn_assign_value(asn_value *dst, const asn_value *src)
 }
 
 
-/**
- * Make a copy of ASN.1 value instance.
- *
- * @param value       ASN.1 value to be copied.
- *
- * @return pointer to new ASN_value instance or NULL if error occurred.
- */
+/* See description in asn_impl.h */
 asn_value *
-asn_copy_value(const asn_value *value)
+asn_impl_copy_value(asn_arena *arena, const asn_value *value)
 {
     asn_value *new_value;
-#if 1
+
     if (value == NULL)
         return NULL;
 
-    new_value = asn_init_value(value->asn_type);
+    new_value = asn_impl_init_value(arena, value->asn_type);
+    if (new_value == NULL)
+        return NULL;
 
     if (asn_assign_value(new_value, value) != 0)
+    {
+        asn_free_value(new_value);
         return NULL;
+    }
 
-    if (value->name)
-        new_value->name = asn_strdup(value->name);
+    if (value->name_static)
+        new_value->name = value->name;
     else
-        new_value->name = NULL;
+        new_value->name = asn_impl_strdup(new_value, value->name);
+    new_value->name_static = value->name_static;
 
     new_value->tag = value->tag;
 
     return new_value;
+}
+
+/**
+ * Make a copy of ASN.1 value instance.
+ *
+ * @param value       ASN.1 value to be copied.
+ *
+ * @return pointer to new ASN_value instance or NULL if error occurred.
+ */
+asn_value *
+asn_copy_value(const asn_value *value)
+{
+#if 1
+    return asn_impl_copy_value(asn_arena_current(), value);
 #else
+    asn_value *new_value;
+
     int len;
 
     if (!value) { /* ERROR! */ return NULL; }
@@ -420,38 +529,80 @@ asn_copy_value(const asn_value *value)
 #endif
 }
 
-/**
- * Free memory allocalted by ASN.1 value instance.
- *
- * @param value       ASN.1 value to be destroyed.
- *
- * @return nothing
- */
+/* See description in asn_impl.h */
 void
-asn_free_value(asn_value *value)
+asn_impl_link_value(asn_value *container, asn_value *value)
+{
+    if (value == NULL)
+        return;
+
+    if (value->arena == container->arena)
+    {
+        /* Reference of the value is not needed, container holds one */
+        if (value->arena != NULL)
+            asn_arena_unref(value->arena);
+    }
+    else if (container->arena != NULL)
+    {
+        container->arena->foreign = TRUE;
+    }
+}
+
+/* See description in asn_impl.h */
+void
+asn_impl_free_value(asn_value *value, const asn_value *container)
 {
+    asn_arena *arena;
+
     if (!value) return;
 
-    if (value->syntax & COMPOUND)
+    arena = value->arena;
+
+    /*
+     * Values of the arena may contain values allocated elsewhere
+     * only if some were put there.
+     */
+    if ((value->syntax & COMPOUND) &&
+        (arena == NULL || arena->foreign))
     {
         unsigned int i;
         asn_value **arr = value->data.array;
         for (i = 0; i < value->len; i++, arr++)
         {
-            asn_free_value(*arr);
+            asn_impl_free_value(*arr, value);
         }
+    }
 
-        free(value->data.array);
+    if (arena != NULL)
+    {
+        if (container == NULL || container->arena != arena)
+            asn_arena_unref(arena);
+        return;
     }
+
+    if (value->syntax & COMPOUND)
+        free(value->data.array);
     else if (value->syntax & PRIMITIVE_VAR_LEN)
-    {
         free(value->data.other);
-    }
 
-    free(value->name);
+    if (!value->name_static)
+        free(value->name);
     free(value);
 }
 
+/**
+ * Free memory allocalted by ASN.1 value instance.
+ *
+ * @param value       ASN.1 value to be destroyed.
+ *
+ * @return nothing
+ */
+void
+asn_free_value(asn_value *value)
+{
+    asn_impl_free_value(value, NULL);
+}
+
 
 /* See description in 'asn_usr.h' */
 te_errno
@@ -594,7 +745,7 @@ asn_free_child(asn_value *value,
     }
 
     value->txt_len = -1;
-    asn_free_value(value->data.array[index]);
+    asn_impl_free_value(value->data.array[index], value);
     value->data.array[index] = NULL;
 
     return 0;
@@ -1022,7 +1173,7 @@ asn_retrieve_descendant(asn_value *value, te_errno *status,
             if (rc != 0)
                 break;
 
-            new_value = asn_init_value(new_type);
+            new_value = asn_impl_init_value(tmp_value->arena, new_type);
             rc = asn_put_child_by_index(tmp_value, new_value, subval_index);
         }
         tmp_value = new_value;
@@ -1199,8 +1350,9 @@ asn_put_child_by_index(asn_value *container, asn_value *new_value,
 
                 new_len = leaf_type_index + 1;
                 if ((container->data.array =
-                      realloc(container->data.array,
-                              new_len * sizeof(asn_value *)))
+                      asn_impl_realloc(container, container->data.array,
+                                       container->len * sizeof(asn_value *),
+                                       new_len * sizeof(asn_value *)))
                      == NULL)
                     return TE_ENOMEM;
 
@@ -1213,15 +1365,17 @@ asn_put_child_by_index(asn_value *container, asn_value *new_value,
             if (new_value == NULL)
             {
                 unsigned int i = leaf_type_index;
-                asn_free_value(container->data.array[i]);
+                asn_impl_free_value(container->data.array[i], container);
                 container->len--;
 
                 for (; i < container->len; i++)
                     container->data.array[i] = container->data.array[i+1];
 
                 container->data.array =
-                    realloc(container->data.array,
-                            container->len * sizeof(asn_value *));
+                    asn_impl_realloc(container, container->data.array,
+                                     (container->len + 1) *
+                                         sizeof(asn_value *),
+                                     container->len * sizeof(asn_value *));
 
                 return 0;
             }
@@ -1236,9 +1390,11 @@ asn_put_child_by_index(asn_value *container, asn_value *new_value,
         case CHOICE:
 
             if (container->data.array[index] != NULL)
-                asn_free_value(container->data.array[index]);
+                asn_impl_free_value(container->data.array[index],
+                                    container);
 
             container->data.array[index] = new_value;
+            asn_impl_link_value(container, new_value);
             break;
 
         default:
@@ -1254,8 +1410,11 @@ asn_put_child_by_index(asn_value *container, asn_value *new_value,
         if (new_value->syntax & COMPOUND)
             new_value->txt_len = -1;
 
-        free(new_value->name);
-        new_value->name = asn_strdup(ne->name);
+        /* Label of the type is shared instead of copying it */
+        if (!new_value->name_static)
+            asn_impl_release(new_value, new_value->name);
+        new_value->name = ne->name;
+        new_value->name_static = TRUE;
         new_value->tag  = ne->tag;
     }
 
@@ -1386,7 +1545,7 @@ asn_put_descendent(asn_value *container, asn_value *subval,
                     else
                         new_type = par_value->asn_type->sp.subtype;
 
-                    tmp = asn_init_value(new_type);
+                    tmp = asn_impl_init_value(par_value->arena, new_type);
 
                     rc = asn_put_child_by_index(par_value, tmp, index);
                     par_value = tmp;
@@ -1609,7 +1768,7 @@ asn_write_primitive(asn_value *value, const void *data, size_t d_len)
         break;
 
     case CHAR_STRING:
-        free(value->data.other);
+        asn_impl_release(value, value->data.other);
         if (d_len == 0 || data == NULL)
         {
             value->data.other = NULL;
@@ -1618,7 +1777,8 @@ asn_write_primitive(asn_value *value, const void *data, size_t d_len)
         }
         else
         {
-            char *str = value->data.other = malloc(d_len + 1);
+            char *str = value->data.other = asn_impl_alloc(value,
+                                                        d_len + 1);
             strncpy(str, data, d_len);
             str[d_len] = '\0';
             value->len = d_len + 1; /* quantity of ALL used octets */
@@ -1643,12 +1803,13 @@ asn_write_primitive(asn_value *value, const void *data, size_t d_len)
     case OCT_STRING:
         if (d_len == 0 || data == NULL)
         {
+            asn_impl_release(value, value->data.other);
             value->data.other = NULL;
             value->len = 0;
         }
         else
         {
-            void * val = malloc(m_len);
+            void * val;
 
             if (value->asn_type->len > 0 &&
                 value->asn_type->len != d_len)
@@ -1656,8 +1817,10 @@ asn_write_primitive(asn_value *value, const void *data, size_t d_len)
                 return TE_EASNWRONGSIZE;
             }
 
-            if (value->data.other)
-                free (value->data.other);
+            if ((val = asn_impl_alloc(value, m_len)) == NULL)
+                return TE_ENOMEM;
+
+            asn_impl_release(value, value->data.other);
             value->data.other = val;
             memcpy(val,  data, m_len);
             value->len = d_len;
@@ -1847,7 +2010,7 @@ asn_impl_write_value_field(asn_value *container,
 
     case CHAR_STRING:
 
-        free(container->data.other);
+        asn_impl_release(container, container->data.other);
         if (d_len == 0)
         {
             container->data.other = NULL;
@@ -1856,7 +2019,8 @@ asn_impl_write_value_field(asn_value *container,
         }
         else
         {
-            char *str = container->data.other = malloc(d_len + 1);
+            char *str = container->data.other =
+                            asn_impl_alloc(container, d_len + 1);
             strncpy(str, data, d_len);
             str[d_len] = '\0';
             container->len = d_len + 1; /* quantity of ALL used octets */
@@ -1881,12 +2045,13 @@ asn_impl_write_value_field(asn_value *container,
     case OCT_STRING:
         if (d_len == 0)
         {
+            asn_impl_release(container, container->data.other);
             container->data.other = NULL;
             container->len = 0;
         }
         else
         {
-            void * val = malloc(m_len);
+            void * val;
 
             if (container->asn_type->len > 0 &&
                 container->asn_type->len != d_len)
@@ -1894,8 +2059,10 @@ asn_impl_write_value_field(asn_value *container,
                 return TE_EASNGENERAL;
             }
 
-            if (container->data.other)
-                free (container->data.other);
+            if ((val = asn_impl_alloc(container, m_len)) == NULL)
+                return TE_ENOMEM;
+
+            asn_impl_release(container, container->data.other);
             container->data.other = val;
             memcpy(val,  data, m_len);
             container->len = d_len;
@@ -1944,7 +2111,8 @@ asn_impl_write_value_field(asn_value *container,
                                                cur_label, &subtype);
                     if (rc) break;
 
-                    subvalue = asn_init_value(subtype);
+                    subvalue = asn_impl_init_value(container->arena,
+                                                   subtype);
 
                     rc = asn_impl_write_value_field(subvalue, data, d_len,
                                                     rest_field_labels);
@@ -2052,6 +2220,329 @@ asn_impl_read_value_field(const asn_value *container,  void *data,
 }
 
 
+/*
+ * ======================= Compiled paths ==========================
+ */
+
+/** Step of compiled path: a child of value of the known type */
+typedef struct asn_path_step {
+    const asn_type *type;       /**< Type of the container */
+    const asn_type *child_type; /**< Type of the child */
+    asn_tag_t       tag;        /**< Tag of the named child */
+    int             index;      /**< Index of the child in the type
+                                     named entries or in the array */
+} asn_path_step;
+
+/** Compiled path to a descendant of ASN.1 value */
+struct asn_path {
+    const asn_type *type;       /**< Type of the root value */
+    char           *labels;     /**< Labels the path is compiled from */
+    const char     *tail;       /**< Labels which cannot be resolved by
+                                     type (fall into the present choice)
+                                     and are resolved by name after the
+                                     steps, or @c NULL */
+    unsigned int    n_steps;    /**< Number of steps */
+    asn_path_step   steps[];    /**< Steps from the root */
+};
+
+/* See description in asn_usr.h */
+te_errno
+asn_path_compile(const asn_type *type, const char *labels, asn_path **path)
+{
+    const char     *rest = labels;
+    const char     *p;
+    asn_path       *res;
+    asn_path_step  *step;
+    unsigned int    max_steps;
+    te_errno        rc = 0;
+    int             index;
+
+    if (type == NULL || labels == NULL || path == NULL)
+        return TE_EWRONGPTR;
+
+    for (max_steps = 1, p = labels; *p != '\0'; p++)
+    {
+        if (*p == '.')
+            max_steps++;
+    }
+
+    res = calloc(1, sizeof(*res) + max_steps * sizeof(res->steps[0]));
+    if (res == NULL)
+        return TE_ENOMEM;
+
+    res->type = type;
+    res->labels = asn_strdup(labels);
+    if (res->labels == NULL)
+    {
+        free(res);
+        return TE_ENOMEM;
+    }
+    rest = res->labels;
+
+    while (rest != NULL && *rest != '\0')
+    {
+        if (rest[0] == '#' && rest[1] == '\001')
+            break;
+
+        index = -1;
+        rc = asn_child_named_index(type, rest, &index, &p);
+        if (rc == 0 && (type->syntax & ASN_SYN_NAMED) &&
+            (index < 0 || (unsigned int)index >= type->len))
+            rc = TE_EASNWRONGLABEL;
+        if (rc == TE_EASNWRONGLABEL && type->syntax == CHOICE)
+        {
+            /* Fall into the choice present in the value */
+            rc = 0;
+            break;
+        }
+        if (rc != 0)
+            break;
+
+        step = &res->steps[res->n_steps++];
+        step->type = type;
+        step->index = index;
+        if (type->syntax & ASN_SYN_NAMED)
+        {
+            step->tag = type->sp.named_entries[index].tag;
+            step->child_type = type->sp.named_entries[index].type;
+        }
+        else
+        {
+            step->child_type = type->sp.subtype;
+        }
+
+        type = step->child_type;
+        rest = p;
+    }
+
+    if (rc != 0)
+    {
+        asn_path_free(res);
+        return rc;
+    }
+
+    if (rest != NULL && *rest != '\0')
+        res->tail = rest;
+
+    *path = res;
+    return 0;
+}
+
+/* See description in asn_usr.h */
+void
+asn_path_free(asn_path *path)
+{
+    if (path == NULL)
+        return;
+
+    free(path->labels);
+    free(path);
+}
+
+/* See description in asn_usr.h */
+const asn_type *
+asn_path_type(const asn_path *path)
+{
+    return path == NULL ? NULL : path->type;
+}
+
+/**
+ * Get child of the value by compiled path step. It is the same as
+ * asn_get_child_by_index(), but named children are checked by tag only.
+ *
+ * @param value         Container
+ * @param step          Path step
+ * @param child         Location for the child
+ *
+ * @return Status code.
+ */
+static te_errno
+asn_path_child(const asn_value *value, const asn_path_step *step,
+               asn_value **child)
+{
+    int index = step->index;
+
+    switch (value->syntax)
+    {
+        case CHOICE:
+            *child = value->data.array[0];
+            if (*child == NULL)
+                return TE_EASNINCOMPLVAL;
+            if (!asn_tag_equal((*child)->tag, step->tag))
+                return TE_EASNOTHERCHOICE;
+            break;
+
+        case SEQUENCE:
+        case SET:
+            *child = value->data.array[index];
+            if (*child == NULL)
+                return TE_EASNINCOMPLVAL;
+            if (!asn_tag_equal((*child)->tag, step->tag))
+                return TE_EASNGENERAL;
+            break;
+
+        case SEQUENCE_OF:
+        case SET_OF:
+            if (index < 0)
+                index += value->len;
+            if (index < 0)
+                return TE_EINVAL;
+            if ((unsigned int)index >= value->len)
+                return TE_EASNINCOMPLVAL;
+            *child = value->data.array[index];
+            break;
+
+        default:
+            return TE_EASNWRONGTYPE;
+    }
+
+    return 0;
+}
+
+/* See description in asn_usr.h */
+asn_value *
+asn_path_find(const asn_value *value, const asn_path *path,
+              te_errno *status)
+{
+    asn_value      *tmp_value = (asn_value *)value;
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    if (value == NULL || path == NULL)
+    {
+        if (status != NULL)
+            *status = TE_EWRONGPTR;
+        return NULL;
+    }
+
+    if (value->asn_type != path->type)
+        return asn_find_descendant(value, status, "%s", path->labels);
+
+    for (i = 0; i < path->n_steps && rc == 0; i++)
+    {
+        if (tmp_value->asn_type != path->steps[i].type)
+        {
+            /* Value of unexpected type is put, resolve by name */
+            return asn_find_descendant(value, status, "%s", path->labels);
+        }
+        rc = asn_path_child(tmp_value, &path->steps[i], &tmp_value);
+    }
+
+    if (rc == 0 && path->tail != NULL)
+        return asn_find_descendant(tmp_value, status, "%s", path->tail);
+
+    if (status != NULL)
+        *status = rc;
+
+    return (rc == 0) ? tmp_value : NULL;
+}
+
+/**
+ * Find descendant value by compiled path and create it with all
+ * ancestors if it is absent, like asn_retrieve_descendant() does.
+ *
+ * @param value         Root of ASN.1 value tree
+ * @param path          Compiled path
+ * @param status        Location for status of operation
+ *
+ * @return Pointer to found subvalue or @c NULL.
+ */
+static asn_value *
+asn_path_retrieve(asn_value *value, const asn_path *path, te_errno *status)
+{
+    asn_value      *tmp_value = value;
+    asn_value      *new_value;
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    if (value->asn_type != path->type)
+        return asn_retrieve_descendant(value, status, "%s", path->labels);
+
+    asn_clean_count(value);
+
+    for (i = 0; i < path->n_steps && rc == 0; i++)
+    {
+        if (tmp_value->asn_type != path->steps[i].type)
+        {
+            return asn_retrieve_descendant(value, status, "%s",
+                                           path->labels);
+        }
+
+        rc = asn_path_child(tmp_value, &path->steps[i], &new_value);
+        if (rc == TE_EASNINCOMPLVAL)
+        {
+            new_value = asn_impl_init_value(tmp_value->arena,
+                                            path->steps[i].child_type);
+            rc = asn_put_child_by_index(tmp_value, new_value,
+                                        path->steps[i].index);
+        }
+        tmp_value = new_value;
+    }
+
+    if (rc == 0 && path->tail != NULL)
+        return asn_retrieve_descendant(tmp_value, status, "%s", path->tail);
+
+    *status = rc;
+
+    return (rc == 0) ? tmp_value : NULL;
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_read_value_field_path(const asn_value *container, void *data,
+                          size_t *d_len, const asn_path *path)
+{
+    const asn_value *value;
+    te_errno         rc;
+
+    value = asn_path_find(container, path, &rc);
+    if (value == NULL)
+        return rc;
+
+    return asn_read_primitive(value, data, d_len);
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_write_value_field_path(asn_value *container, const void *data,
+                           size_t d_len, const asn_path *path)
+{
+    asn_value  *subvalue;
+    te_errno    rc;
+
+    if (container == NULL || path == NULL)
+        return TE_EWRONGPTR;
+
+    subvalue = asn_path_retrieve(container, path, &rc);
+    if (subvalue == NULL)
+        return rc;
+
+    container->txt_len = -1;
+    asn_clean_count(container);
+
+    return asn_write_primitive(subvalue, data, d_len);
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_read_int32_path(const asn_value *container, int32_t *value,
+                    const asn_path *path)
+{
+    size_t len = sizeof(*value);
+
+    return asn_read_value_field_path(container, value, &len, path);
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_write_int32_path(asn_value *container, int32_t value,
+                     const asn_path *path)
+{
+    return asn_write_value_field_path(container, &value, sizeof(value),
+                                      path);
+}
+
+
 /* see description in asn_usr.h */
 te_errno
 asn_write_int32(asn_value *container, int32_t value, const char *labels)
@@ -2302,7 +2793,8 @@ asn_impl_write_component_value(asn_value *container,
                     if ((subtype->syntax == CHOICE) &&
                         (elem_value->syntax != CHOICE))
                     {
-                        new_value = asn_init_value(subtype);
+                        new_value = asn_impl_init_value(container->arena,
+                                                        subtype);
                         rc = asn_impl_write_component_value
                                         (new_value, elem_value, "");
                         if (rc)
@@ -2314,7 +2806,8 @@ asn_impl_write_component_value(asn_value *container,
                 }
 
                 if (new_value == NULL)
-                    new_value = asn_copy_value(elem_value);
+                    new_value = asn_impl_copy_value(container->arena,
+                                                    elem_value);
 
                 if (new_value == NULL)
                 {
@@ -2564,8 +3057,10 @@ asn_write_indexed(asn_value *container, const asn_value *elem_value,
     {
         case SEQUENCE_OF:
         case SET_OF:
-            asn_free_value(value->data.array[index]);
-            value->data.array[index] = asn_copy_value(elem_value);
+            asn_impl_free_value(value->data.array[index], value);
+            value->data.array[index] = asn_impl_copy_value(value->arena,
+                                                           elem_value);
+            asn_impl_link_value(value, value->data.array[index]);
             break;
 
         default:
@@ -2657,25 +3152,20 @@ asn_insert_indexed(asn_value *container, asn_value *elem_value,
         return TE_EASNWRONGTYPE;
 
     {
-        asn_value **arr = malloc(new_len * sizeof(asn_value *));
-
-        unsigned int i;
+        asn_value **arr = asn_impl_realloc(value, value->data.array,
+                                           value->len * sizeof(asn_value *),
+                                           new_len * sizeof(asn_value *));
 
         if (arr == NULL)
             return TE_ENOMEM;
 
-        for (i = 0; i < (unsigned)index; i++)
-            arr[i] = value->data.array[i];
-
+        memmove(arr + index + 1, arr + index,
+                (value->len - index) * sizeof(asn_value *));
         arr[index] = elem_value;
 
-        for (; i < value->len; i++)
-            arr[i+1] = value->data.array[i];
-
-        if (value->data.array)
-            free(value->data.array);
         value->data.array = arr;
         value->len = new_len;
+        asn_impl_link_value(value, elem_value);
     }
 
     return 0;
@@ -2721,7 +3211,8 @@ asn_remove_indexed(asn_value * container, int index, const char *subval_labels)
 
         if (value->len > 1)
         {
-            arr = malloc((value->len - 1) * sizeof(asn_value *));
+            arr = asn_impl_alloc(value,
+                                 (value->len - 1) * sizeof(asn_value *));
             if (arr == NULL) return TE_ENOMEM;
         }
 
@@ -2730,12 +3221,12 @@ asn_remove_indexed(asn_value * container, int index, const char *subval_labels)
         for (i = 0; i < (unsigned)index; i++)
             arr[i] = value->data.array[i];
 
-        asn_free_value(value->data.array[index]);
+        asn_impl_free_value(value->data.array[index], value);
 
         for (; i < value->len; i++)
             arr[i] = value->data.array[i+1];
 
-        free(value->data.array);
+        asn_impl_release(value, value->data.array);
         value->data.array = arr;
     }
 
@@ -3876,13 +4367,14 @@ asn_insert_value_extended_path(asn_value *root_node,
         {
             if (dst->data.array[i] != NULL)
             {
-                free(dst->data.array[i]);
+                asn_impl_free_value(dst->data.array[i], dst);
             }
 #if 0
             RING("%s(): Copying item #%d (label=%s)", __FUNCTION__,
                  i, temp_dst->asn_type->sp.named_entries[i]);
 #endif
-            dst->data.array[i] = asn_copy_value(src_elem);
+            dst->data.array[i] = asn_impl_copy_value(dst->arena, src_elem);
+            asn_impl_link_value(dst, dst->data.array[i]);
             if (dst->data.array[i] == NULL)
             {
                 ERROR("%s(): Failed to copy item #%d of ASN.1 value "
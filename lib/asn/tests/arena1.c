@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/**
+ * Test for ASN library.
+ *
+ * Build, modify, copy, decode and free values allocated from arenas,
+ * mix them with values allocated on heap. Run it under valgrind or
+ * with AddressSanitizer to check that no memory is leaked or used
+ * after free.
+ *
+ * Copyright (C) 2006-2022 OKTET Labs Ltd. All rights reserved.
+ */
+#include "te_config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "asn_usr.h"
+#include "ndn.h"
+#include "ndn_eth.h"
+#include "ndn_ipstack.h"
+
+char packet_asn_string[] =
+"{\
+  received {\
+    seconds 1140892564,\
+    micro-seconds 426784\
+  },\
+  pdus {\
+    tcp:{\
+      src-port plain:20587,\
+      dst-port plain:20586,\
+      checksum plain:7001\
+    },\
+    ip4:{\
+      version plain:4,\
+      time-to-live plain:64,\
+      src-addr plain:'0A 12 0A 02 'H,\
+      dst-addr plain:'0A 12 0A 03 'H\
+    },\
+    eth:{\
+      src-addr plain:'00 0E A6 41 D5 2E 'H,\
+      length-type plain:2048\
+    }\
+  },\
+  payload bytes:'01 02 03 04 05 06 07 08 'H\
+}";
+
+char buf_heap[10000];
+char buf_arena[10000];
+uint8_t buf_bin[10000];
+
+/**
+ * Check that two values are printed the same.
+ *
+ * @param what      What is checked
+ * @param a         The first value
+ * @param b         The second value
+ *
+ * @return 0 if values are the same.
+ */
+static int
+check_same(const char *what, const asn_value *a, const asn_value *b)
+{
+    asn_sprint_value(a, buf_heap, sizeof(buf_heap), 0);
+    asn_sprint_value(b, buf_arena, sizeof(buf_arena), 0);
+    if (strcmp(buf_heap, buf_arena) != 0)
+    {
+        printf("%s: values differ:\n<%s>\n<%s>\n", what,
+               buf_heap, buf_arena);
+        return 1;
+    }
+    return 0;
+}
+
+int
+main(void)
+{
+    asn_arena  *arena;
+    asn_value  *heap_val;
+    asn_value  *arena_val;
+    asn_value  *decoded;
+    asn_value  *pdu;
+    asn_value  *copy;
+    size_t      len = sizeof(buf_bin);
+    te_errno    rc;
+    int         s_parsed;
+    int         i;
+
+    rc = asn_parse_value_text(packet_asn_string, ndn_raw_packet,
+                              &heap_val, &s_parsed);
+    if (rc != 0)
+    {
+        printf("parse on heap failed rc %x, syms: %d\n", rc, s_parsed);
+        return 1;
+    }
+
+    /* Parse and modify in arena, the arena is closed before free */
+    arena = asn_arena_open();
+    rc = asn_parse_value_text(packet_asn_string, ndn_raw_packet,
+                              &arena_val, &s_parsed);
+    asn_arena_close(arena);
+    if (rc != 0)
+    {
+        printf("parse in arena failed rc %x, syms: %d\n", rc, s_parsed);
+        return 1;
+    }
+    if (check_same("parse", heap_val, arena_val) != 0)
+        return 1;
+
+    for (i = 0; i < 100; i++)
+    {
+        rc = asn_write_int32(heap_val, i, "pdus.1.#ip4.h-checksum.#plain");
+        if (rc == 0)
+            rc = asn_write_int32(arena_val, i,
+                                 "pdus.1.#ip4.h-checksum.#plain");
+        if (rc == 0)
+            rc = asn_write_value_field(heap_val, buf_bin, i,
+                                       "payload.#bytes");
+        if (rc == 0)
+            rc = asn_write_value_field(arena_val, buf_bin, i,
+                                       "payload.#bytes");
+        if (rc != 0)
+        {
+            printf("write failed rc %x\n", rc);
+            return 1;
+        }
+    }
+
+    /* Heap values put into the arena tree are freed with it */
+    for (i = 0; i < 20; i++)
+    {
+        pdu = asn_copy_value(heap_val);
+        rc = asn_insert_indexed(pdu, asn_init_value(ndn_generic_pdu), -1,
+                                "pdus");
+        if (rc == 0)
+            rc = asn_insert_indexed(arena_val,
+                                    asn_copy_value(
+                                        asn_find_descendant(pdu, NULL,
+                                                            "pdus.0")),
+                                    -1, "pdus");
+        asn_free_value(pdu);
+        if (rc == 0)
+            rc = asn_remove_indexed(arena_val, 0, "pdus");
+        if (rc == 0)
+            rc = asn_insert_indexed(heap_val,
+                                    asn_copy_value(
+                                        asn_find_descendant(heap_val, NULL,
+                                                            "pdus.0")),
+                                    -1, "pdus");
+        if (rc == 0)
+            rc = asn_remove_indexed(heap_val, 0, "pdus");
+        if (rc != 0)
+        {
+            printf("insert/remove failed rc %x\n", rc);
+            return 1;
+        }
+    }
+    if (check_same("modify", heap_val, arena_val) != 0)
+        return 1;
+
+    /* Copy of the arena value outside of arena is on heap */
+    copy = asn_copy_value(arena_val);
+    if (check_same("copy", arena_val, copy) != 0)
+        return 1;
+
+    /* Decode in another arena and put its subtree into heap copy */
+    rc = asn_encode_bin(arena_val, buf_bin, &len);
+    if (rc == 0)
+    {
+        arena = asn_arena_open();
+        rc = asn_decode_bin(buf_bin, len, ndn_raw_packet, &decoded, NULL);
+        asn_arena_close(arena);
+    }
+    if (rc != 0)
+    {
+        printf("binary encoding failed rc %x\n", rc);
+        return 1;
+    }
+    if (check_same("decode", arena_val, decoded) != 0)
+        return 1;
+
+    rc = asn_get_descendent(decoded, &pdu, "pdus");
+    if (rc == 0)
+        rc = asn_put_descendent(copy, asn_copy_value(pdu), "pdus");
+    if (rc == 0)
+    {
+        /* Value of the arena created in it is owned by heap value */
+        arena = asn_arena_open();
+        pdu = asn_copy_value(pdu);
+        asn_arena_close(arena);
+        rc = asn_put_descendent(copy, pdu, "pdus");
+    }
+    if (rc != 0)
+    {
+        printf("put failed rc %x\n", rc);
+        return 1;
+    }
+    asn_free_value(decoded);
+    if (check_same("put", arena_val, copy) != 0)
+        return 1;
+
+    asn_free_value(arena_val);
+    asn_free_value(copy);
+    asn_free_value(heap_val);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief ASN.1 library benchmark
+ *
+ * Benchmark of encoding and decoding of captured packets in textual
+ * ASN.1 value notation and in binary encoding, the way Test Agent
+ * reports packets and Test Engine parses them.
+ *
+ * Usage: asn_bin_bench [<number of iterations>]
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "asn_usr.h"
+#include "ndn.h"
+
+/** Default number of iterations */
+#define BENCH_ITERATIONS    200000
+
+/** Packet reported by Test Agent */
+static const char *bench_packet =
+"{\
+  received {\
+    seconds 1140892564,\
+    micro-seconds 426784\
+  },\
+  pdus {\
+    tcp:{\
+      src-port plain:20587,\
+      dst-port plain:20586,\
+      seqn plain:-281709452,\
+      ackn plain:1284566196,\
+      hlen plain:6,\
+      flags plain:18,\
+      win-size plain:5840,\
+      checksum plain:7001,\
+      urg-p plain:0\
+    },\
+    ip4:{\
+      version plain:4,\
+      h-length plain:5,\
+      type-of-service plain:0,\
+      total-length plain:84,\
+      ip-ident plain:0,\
+      dont-frag plain:1,\
+      frag-offset plain:0,\
+      time-to-live plain:64,\
+      protocol plain:6,\
+      h-checksum plain:4772,\
+      src-addr plain:'0A 12 0A 02 'H,\
+      dst-addr plain:'0A 12 0A 03 'H\
+    },\
+    eth:{\
+      src-addr plain:'00 0E A6 41 D5 2E 'H,\
+      dst-addr plain:'01 02 03 04 05 06 'H,\
+      length-type plain:2048\
+    }\
+  },\
+  payload bytes:'00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F\
+                 10 11 12 13 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F\
+                 20 21 22 23 24 25 26 27 'H\
+}";
+
+/**
+ * Get seconds elapsed since the moment.
+ *
+ * @param start     Start moment
+ *
+ * @return Number of seconds.
+ */
+static double
+bench_elapsed(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) +
+           (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Print result of the benchmark.
+ *
+ * @param name      Name of the operation
+ * @param n         Number of iterations
+ * @param sec       Elapsed time
+ */
+static void
+bench_report(const char *name, unsigned int n, double sec)
+{
+    printf("%-14s %12.0f values/sec\n", name, n / sec);
+}
+
+int
+main(int argc, char *argv[])
+{
+    unsigned int    n = BENCH_ITERATIONS;
+    unsigned int    i;
+    asn_value      *pkt;
+    asn_value      *parsed;
+    char           *txt;
+    uint8_t        *bin;
+    size_t          txt_len;
+    size_t          bin_len;
+    size_t          len;
+    int             syms;
+    struct timespec start;
+    te_errno        rc;
+
+    if (argc > 1)
+        n = strtoul(argv[1], NULL, 0);
+    if (n == 0)
+    {
+        fprintf(stderr, "Usage: %s [<iterations>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    rc = asn_parse_value_text(bench_packet, ndn_raw_packet, &pkt, &syms);
+    if (rc != 0)
+    {
+        fprintf(stderr, "Failed to parse packet: %x, symbol %d\n",
+                rc, syms);
+        return EXIT_FAILURE;
+    }
+
+    txt_len = asn_count_txt_len(pkt, 0) + 1;
+    if ((rc = asn_count_bin_len(pkt, &bin_len)) != 0)
+    {
+        fprintf(stderr, "Failed to count binary length: %x\n", rc);
+        return EXIT_FAILURE;
+    }
+    txt = malloc(txt_len);
+    bin = malloc(bin_len);
+    if (txt == NULL || bin == NULL)
+        return EXIT_FAILURE;
+
+    printf("%u iterations, text %u octets, binary %u octets\n",
+           n, (unsigned)txt_len, (unsigned)bin_len);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < n; i++)
+    {
+        len = asn_count_txt_len(pkt, 0) + 1;
+        asn_sprint_value(pkt, txt, len, 0);
+    }
+    bench_report("text encode", n, bench_elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < n; i++)
+    {
+        rc = asn_parse_value_text(txt, ndn_raw_packet, &parsed, &syms);
+        if (rc != 0)
+            return EXIT_FAILURE;
+        asn_free_value(parsed);
+    }
+    bench_report("text decode", n, bench_elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < n; i++)
+    {
+        asn_count_bin_len(pkt, &len);
+        asn_encode_bin(pkt, bin, &len);
+    }
+    bench_report("binary encode", n, bench_elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < n; i++)
+    {
+        rc = asn_decode_bin(bin, bin_len, ndn_raw_packet, &parsed, NULL);
+        if (rc != 0)
+            return EXIT_FAILURE;
+        asn_free_value(parsed);
+    }
+    bench_report("binary decode", n, bench_elapsed(&start));
+
+    free(txt);
+    free(bin);
+    asn_free_value(pkt);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,194 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/**
+ * Test for ASN library.
+ *
+ * Check that binary encoding of values round-trips exactly with
+ * textual ASN.1 value notation.
+ *
+ * Copyright (C) 2005-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asn_usr.h"
+#include "ndn.h"
+#include "ndn_eth.h"
+
+#include "test_types.h"
+
+
+char txt_buffer[10000];
+char bin_txt_buffer[10000];
+uint8_t bin_buffer[10000];
+uint8_t bin_buffer2[10000];
+
+int result = 0;
+
+void
+test_bin_codec(const char *string, const asn_type *type)
+{
+    int         rc;
+    int         s_parsed;
+    size_t      len;
+    size_t      len2;
+    size_t      used;
+    asn_value  *val;
+    asn_value  *decoded;
+
+    rc = asn_parse_value_text(string, type, &val, &s_parsed);
+    if (rc != 0)
+    {
+        printf("parse of '%s', type %s: \n  rc %6x, syms: %d\n",
+               string, type->name, rc, s_parsed);
+        result = 1;
+        return;
+    }
+    asn_sprint_value(val, txt_buffer, sizeof(txt_buffer), 0);
+
+    rc = asn_count_bin_len(val, &len);
+    if (rc != 0)
+    {
+        printf("count of binary length, type %s: rc %6x\n",
+               type->name, rc);
+        result = 1;
+        return;
+    }
+
+    len2 = len - 1;
+    rc = asn_encode_bin(val, bin_buffer, &len2);
+    if (rc != TE_ESMALLBUF || len2 != len)
+    {
+        printf("encode to short buffer, type %s: rc %6x, len %u\n",
+               type->name, rc, (unsigned)len2);
+        result = 1;
+    }
+
+    len2 = sizeof(bin_buffer);
+    rc = asn_encode_bin(val, bin_buffer, &len2);
+    if (rc != 0 || len2 != len)
+    {
+        printf("encode, type %s: rc %6x, len %u, counted %u\n",
+               type->name, rc, (unsigned)len2, (unsigned)len);
+        result = 1;
+        return;
+    }
+
+    rc = asn_decode_bin(bin_buffer, len, type, &decoded, &used);
+    if (rc != 0 || used != len)
+    {
+        printf("decode, type %s: rc %6x, used %u of %u\n",
+               type->name, rc, (unsigned)used, (unsigned)len);
+        result = 1;
+        return;
+    }
+    asn_sprint_value(decoded, bin_txt_buffer, sizeof(bin_txt_buffer), 0);
+
+    if (strcmp(txt_buffer, bin_txt_buffer) != 0 ||
+        asn_count_txt_len(val, 0) != asn_count_txt_len(decoded, 0))
+    {
+        printf("type %s, decoded value differs:\n--\n%s\n--\n%s\n--\n",
+               type->name, txt_buffer, bin_txt_buffer);
+        result = 1;
+    }
+
+    len2 = sizeof(bin_buffer2);
+    rc = asn_encode_bin(decoded, bin_buffer2, &len2);
+    if (rc != 0 || len2 != len || memcmp(bin_buffer, bin_buffer2, len) != 0)
+    {
+        printf("type %s, encoding of decoded value differs\n", type->name);
+        result = 1;
+    }
+
+    for (len2 = 0; len2 < len; len2++)
+    {
+        asn_value *partial = NULL;
+
+        if (asn_decode_bin(bin_buffer, len2, type, &partial, NULL) == 0)
+        {
+            printf("type %s, truncated to %u octets value is decoded\n",
+                   type->name, (unsigned)len2);
+            asn_free_value(partial);
+            result = 1;
+            break;
+        }
+    }
+
+    printf("type %s: text %u, binary %u octets\n", type->name,
+           (unsigned)strlen(txt_buffer), (unsigned)len);
+
+    asn_free_value(decoded);
+    asn_free_value(val);
+}
+
+int
+main(void)
+{
+    test_bin_codec("\"berb\\\"erber\"", asn_base_charstring);
+    test_bin_codec("\"\"", asn_base_charstring);
+    test_bin_codec("'00 01 03 05 23 5F 8A 5B CC 00 00 0 0 'H",
+                   asn_base_octstring);
+    test_bin_codec("''H", asn_base_octstring);
+    test_bin_codec("0", asn_base_integer);
+    test_bin_codec("-2000001", asn_base_integer);
+    test_bin_codec("4294967295", asn_base_uinteger);
+    test_bin_codec("TRUE", asn_base_boolean);
+    test_bin_codec("NULL", asn_base_null);
+    test_bin_codec("thor", &at_our_names);
+    test_bin_codec("{1 3 6 1 2 1 -5 }", asn_base_objid);
+    test_bin_codec("{ number 16, string \"lalala\" }", &at_plain_seq1);
+    test_bin_codec("{ name \"uuu\" , array {1, 2, 35  , 55 } }",
+                   &at_named_int_array);
+    test_bin_codec("{ name \"uuu\" , array { } }", &at_named_int_array);
+    test_bin_codec("number:222", &at_plain_choice1);
+    test_bin_codec("{ pdus { }, "
+                   "arg-sets {simple-for:{ begin 1, end 10 } },"
+                   " payload function:\"eth_udp_payload64\" }",
+                   ndn_traffic_template);
+    test_bin_codec(
+"{\
+  received {\
+    seconds 1140892564,\
+    micro-seconds 426784\
+  },\
+  pdus {\
+    tcp:{\
+      src-port plain:20587,\
+      dst-port plain:20586,\
+      seqn plain:-281709452,\
+      ackn plain:1284566196,\
+      hlen plain:6,\
+      flags plain:18,\
+      win-size plain:5840,\
+      checksum plain:7001,\
+      urg-p plain:0\
+    },\
+    ip4:{\
+      version plain:4,\
+      h-length plain:5,\
+      type-of-service plain:0,\
+      total-length plain:44,\
+      ip-ident plain:0,\
+      dont-frag plain:1,\
+      frag-offset plain:0,\
+      time-to-live plain:64,\
+      protocol plain:6,\
+      h-checksum plain:4772,\
+      src-addr plain:'0A 12 0A 02 'H,\
+      dst-addr plain:'0A 12 0A 03 'H\
+    },\
+    eth:{\
+      src-addr plain:'00 0E A6 41 D5 2E 'H,\
+      dst-addr plain:'01 02 03 04 05 06 'H,\
+      length-type plain:2048\
+    }\
+  },\
+  payload bytes:'00 01 02 03 04 05 06 07 'H\
+}",
+                   ndn_raw_packet);
+
+    return result;
+}
@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/**
+ * Test for ASN library.
+ *
+ * Read and write fields by compiled paths and compare with access
+ * by textual labels.
+ *
+ * Copyright (C) 2006-2022 OKTET Labs Ltd. All rights reserved.
+ */
+#include "te_config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "asn_usr.h"
+#include "ndn.h"
+#include "ndn_eth.h"
+
+char packet_asn_string[] =
+"{\
+  received {\
+    seconds 1140892564,\
+    micro-seconds 426784\
+  },\
+  pdus {\
+    tcp:{\
+      src-port plain:20587,\
+      dst-port plain:20586,\
+      checksum plain:7001\
+    },\
+    ip4:{\
+      version plain:4,\
+      time-to-live plain:64,\
+      src-addr plain:'0A 12 0A 02 'H,\
+      dst-addr plain:'0A 12 0A 03 'H\
+    },\
+    eth:{\
+      src-addr plain:'00 0E A6 41 D5 2E 'H,\
+      length-type plain:2048\
+    }\
+  },\
+  payload bytes:''H\
+}";
+
+/** Labels to check, each is read by path and by labels */
+static const char *labels[] = {
+    "",
+    "received.seconds",
+    "pdus.0.#tcp.src-port.#plain",
+    "pdus.1.#ip4.time-to-live.#plain",
+    "pdus.1.#ip4.src-addr.#plain",
+    "pdus.1.ip4.dst-addr",
+    "pdus.2.#eth.length-type",
+    "pdus.-1.#eth.src-addr.#plain",
+    "pdus.0.#ip4.version",
+    "pdus.3.#eth.src-addr",
+    "pdus.1.#ip4.h-checksum.#plain",
+};
+
+char buf_path[1000];
+
+int
+main(void)
+{
+    asn_value  *val;
+    asn_value  *by_path;
+    asn_value  *by_labels;
+    asn_path   *path;
+    te_errno    rc_path;
+    te_errno    rc_labels;
+    te_errno    rc = 0;
+    int32_t     i32;
+    int         s_parsed;
+    unsigned    i;
+
+    rc = asn_parse_value_text(packet_asn_string, ndn_raw_packet,
+                              &val, &s_parsed);
+    if (rc != 0)
+    {
+        printf("parse failed rc %x, syms: %d\n", rc, s_parsed);
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(labels) / sizeof(labels[0]); i++)
+    {
+        rc = asn_path_compile(ndn_raw_packet, labels[i], &path);
+        if (rc != 0)
+        {
+            printf("compile '%s' failed rc %x\n", labels[i], rc);
+            return 1;
+        }
+
+        by_path = asn_path_find(val, path, &rc_path);
+        by_labels = asn_find_descendant(val, &rc_labels, "%s", labels[i]);
+        asn_path_free(path);
+
+        if (by_path != by_labels || rc_path != rc_labels)
+        {
+            printf("'%s': by path %p (rc %x), by labels %p (rc %x)\n",
+                   labels[i], by_path, rc_path, by_labels, rc_labels);
+            return 1;
+        }
+        printf("'%s': rc %x\n", labels[i], rc_path);
+    }
+
+    /* Write absent field by path and read it back by labels */
+    rc = asn_path_compile(ndn_raw_packet, "pdus.1.#ip4.h-checksum.#plain",
+                          &path);
+    if (rc == 0)
+        rc = asn_write_int32_path(val, 4772, path);
+    asn_path_free(path);
+    if (rc == 0)
+        rc = asn_read_int32(val, &i32, "pdus.1.#ip4.h-checksum.#plain");
+    if (rc != 0 || i32 != 4772)
+    {
+        printf("write by path failed rc %x, read %d\n", rc, i32);
+        return 1;
+    }
+
+    /* Path compiled for another type is resolved by labels */
+    rc = asn_path_compile(ndn_generic_pdu, "#ip4.time-to-live.#plain",
+                          &path);
+    if (rc == 0)
+    {
+        by_labels = asn_find_descendant(val, NULL, "pdus.1");
+        rc = asn_read_int32_path(by_labels, &i32, path);
+    }
+    asn_path_free(path);
+    if (rc != 0 || i32 != 64)
+    {
+        printf("read by path failed rc %x, read %d\n", rc, i32);
+        return 1;
+    }
+
+    asn_sprint_value(val, buf_path, sizeof(buf_path), 0);
+    printf("got value: <%s>\n", buf_path);
+
+    asn_free_value(val);
+
+    return 0;
+}
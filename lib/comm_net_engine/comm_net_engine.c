@@ -25,6 +25,9 @@
 #if HAVE_SYS_SOCKET_H
 #include <sys/socket.h>
 #endif
+#if HAVE_SYS_POLL_H
+#include <sys/poll.h>
+#endif
 #if HAVE_SYS_ERRNO_H
 #include <sys/errno.h>
 #endif
@@ -294,8 +297,7 @@ rcf_net_engine_transmit(struct rcf_net_connection *rnc,
 te_bool
 rcf_net_engine_is_ready(struct rcf_net_connection *rnc)
 {
-    fd_set          rfds;
-    struct timeval  tv;
+    struct pollfd pfd;
 
     if (rnc == NULL)
         return FALSE;
@@ -303,14 +305,14 @@ rcf_net_engine_is_ready(struct rcf_net_connection *rnc)
     if (rnc->bytes_to_read > 0)
         return TRUE;
 
-    FD_ZERO(&rfds);
-    FD_SET(rnc->socket, &rfds);
-    tv.tv_sec = 0;
-    tv.tv_usec = 0;
+    pfd.fd = rnc->socket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
 
-    select(rnc->socket + 1, &rfds, NULL, NULL, &tv);
+    if (poll(&pfd, 1, 0) <= 0)
+        return FALSE;
 
-    return FD_ISSET(rnc->socket, &rfds) ? TRUE : FALSE;
+    return (pfd.revents & (POLLIN | POLLHUP | POLLERR)) ? TRUE : FALSE;
 }
 
 /**
@@ -50,6 +50,7 @@
 #include "te_defs.h"
 #include "te_errno.h"
 #include "ipc_client.h"
+#include "ipc_shm.h"
 
 
 /** @name IPC Client retry parameters */
@@ -129,6 +130,8 @@ struct ipc_client_server {
                                      left to read from the socket and
                                      to return to user.
                                      This field MUST be 4-octets long. */
+            ipc_shm_chan *shm;  /**< Shared memory channel or @c NULL
+                                     if data are sent over socket */
 
         } stream;
     };
@@ -211,6 +214,29 @@ ipc_client_name(const struct ipc_client *ipcc)
 }
 
 
+/* See description in ipc_client.h */
+te_bool
+ipc_client_shm_used(const struct ipc_client *ipcc, const char *server_name)
+{
+    const struct ipc_client_server *ipccs;
+
+    if (ipcc == NULL || !ipcc->conn || server_name == NULL)
+        return FALSE;
+
+    for (ipccs = ipcc->pool; ipccs != NULL; ipccs = ipccs->next)
+    {
+#ifdef TE_IPC_AF_UNIX
+        if (strcmp(ipccs->sa.sun_path + 1, server_name) == 0)
+#else
+        if (strcmp(ipccs->name, server_name) == 0)
+#endif
+            return ipccs->stream.shm != NULL;
+    }
+
+    return FALSE;
+}
+
+
 /**
  * Search in pool for the item with specified server name and return
  * pointer to this item. Allocate a new entry if entry not found.
@@ -297,6 +323,11 @@ ipc_free_client_server_pool(struct ipc_client *ipcc)
         tmp = ipccs->next;
         if (ipcc->conn)
         {
+            if (ipccs->stream.shm != NULL)
+            {
+                ipc_shm_close(ipccs->stream.shm);
+                free(ipccs->stream.shm);
+            }
             if (ipccs->stream.socket >= 0)
                 close(ipccs->stream.socket);
         }
@@ -1278,6 +1309,82 @@ ipc_dgram_receive_rest_answer(struct ipc_client *ipcc,
 }
 
 
+#ifdef TE_IPC_AF_UNIX
+/**
+ * Check whether shared memory transport is enabled for
+ * connection-oriented clients.
+ *
+ * @return @c TRUE if enabled.
+ */
+static te_bool
+ipc_client_shm_enabled(void)
+{
+    const char *value = getenv(IPC_SHM_ENV);
+
+    return value != NULL && strcmp(value, "yes") == 0;
+}
+
+/**
+ * Ask the server to switch just established connection to shared
+ * memory transport. The socket is used if it is impossible.
+ *
+ * @param server        The server
+ *
+ * @return Status code (failure to use shared memory is not an error).
+ */
+static int
+ipc_client_shm_setup(struct ipc_client_server *server)
+{
+    int             fds[IPC_SHM_FDS_NUM];
+    ipc_shm_chan   *chan;
+    size_t          status = 0;
+    int             rc;
+
+    chan = calloc(1, sizeof(*chan));
+    if (chan == NULL)
+        return 0;
+
+    if (ipc_shm_create(chan, server->stream.socket, fds) != 0)
+    {
+        free(chan);
+        return 0;
+    }
+
+    rc = ipc_shm_send_fds(server->stream.socket, fds);
+    if (rc == 0)
+        rc = read_socket(server->stream.socket, &status, sizeof(status));
+
+    if (rc == 0 && status == 0)
+    {
+        server->stream.shm = chan;
+        return 0;
+    }
+
+    ipc_shm_close(chan);
+    free(chan);
+
+    return rc;
+}
+#endif /* TE_IPC_AF_UNIX */
+
+/**
+ * Read specified number of octets from the connection with server.
+ *
+ * @param server        The server
+ * @param buf           Buffer for data
+ * @param len           Number of octets to read
+ *
+ * @return Status code.
+ */
+static int
+ipc_client_read(struct ipc_client_server *server, void *buf, size_t len)
+{
+    if (server->stream.shm != NULL)
+        return ipc_shm_read(server->stream.shm, buf, len);
+
+    return read_socket(server->stream.socket, buf, len);
+}
+
 /* See description in ipc_client.h */
 static int
 ipc_stream_send_message(struct ipc_client *ipcc, const char *server_name,
@@ -1352,10 +1459,32 @@ ipc_stream_send_message(struct ipc_client *ipcc, const char *server_name,
                 sleep(IPC_SLEEP);
             }
         }
+
+#ifdef TE_IPC_AF_UNIX
+        if (ipc_client_shm_enabled())
+        {
+            int rc = ipc_client_shm_setup(server);
+
+            if (rc != 0)
+                return rc;
+        }
+#endif
     }
 
     /* At this point we have established connection. Send data */
 
+    if (server->stream.shm != NULL)
+    {
+        size_t len = msg_len;
+        int    rc;
+
+        rc = ipc_shm_write(server->stream.shm, &len, sizeof(len));
+        if (rc == 0)
+            rc = ipc_shm_write(server->stream.shm, msg, msg_len);
+
+        return rc;
+    }
+
     if (msg_len + 8 > IPC_TCP_CLIENT_BUFFER_SIZE)
     {
         /* Message is too long to fit into the internal buffer */
@@ -1410,7 +1539,7 @@ ipc_client_int_receive(struct ipc_client_server *server,
     octets_to_read = MIN(*p_buf_len, server->stream.pending);
     if (octets_to_read > 0)
     {
-        int rc = read_socket(server->stream.socket, buf, octets_to_read);
+        int rc = ipc_client_read(server, buf, octets_to_read);
 
         /* If we have something to read */
         if (rc != 0)
@@ -1469,8 +1598,8 @@ ipc_stream_receive_answer(struct ipc_client *ipcc, const char *server_name,
      * Let's read the length of the message and call
      * ipc_receive_rest_answer.
      */
-    rc = read_socket(server->stream.socket, &server->stream.pending,
-                     sizeof(server->stream.pending));
+    rc = ipc_client_read(server, &server->stream.pending,
+                         sizeof(server->stream.pending));
     if (rc != 0)
     {
         /* ECONNRESET errno is set when server closes its socket */
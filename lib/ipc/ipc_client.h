@@ -28,6 +28,13 @@ struct ipc_client;
 typedef struct ipc_client ipc_client;
 /*@}*/
 
+/**
+ * Name of the environment variable which enables shared memory
+ * transport for connection-oriented IPC clients (it is used if set
+ * to "yes" and the server runs on the same host).
+ */
+#define IPC_SHM_ENV             "TE_IPC_SHM"
+
 
 /**
  * Initialize IPC library for the client.
@@ -54,6 +61,21 @@ extern int ipc_init_client(const char *client_name, te_bool conn,
 extern const char *ipc_client_name(const struct ipc_client *ipcc);
 
 
+/**
+ * Check whether the connection with the server is switched to shared
+ * memory transport.
+ *
+ * @param ipcc          Pointer to the ipc_client structure returned
+ *                      by ipc_init_client()
+ * @param server_name   Name of the server
+ *
+ * @return @c TRUE if messages to the server and answers from it are
+ *         passed via shared memory.
+ */
+extern te_bool ipc_client_shm_used(const struct ipc_client *ipcc,
+                                   const char *server_name);
+
+
 /**
  * Send the message to the server with specified name.
  *
@@ -0,0 +1,398 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief IPC library
+ *
+ * Implementation of the event loop based on epoll(). If epoll() is not
+ * supported, poll() over all registered file descriptors is used.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#if HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#elif HAVE_SYS_POLL_H
+#include <sys/poll.h>
+#else
+#error epoll() or poll() is required for IPC event loop
+#endif
+#if HAVE_SYS_SELECT_H
+#include <sys/select.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "ipc_evloop.h"
+
+
+/** Maximum number of events retrieved by one epoll_wait() call */
+#define IPC_EVLOOP_MAX_EVENTS   64
+
+/** Registered file descriptor */
+typedef struct ipc_evloop_entry {
+    int                         fd;         /**< File descriptor */
+    ipc_evloop_handler          handler;    /**< Readiness handler */
+    void                       *opaque;     /**< Handler opaque data */
+    struct ipc_evloop_entry    *next_free;  /**< Next entry to be freed
+                                                 after dispatching */
+} ipc_evloop_entry;
+
+/** Event loop */
+struct ipc_evloop {
+#if HAVE_SYS_EPOLL_H
+    int                 epfd;       /**< epoll file descriptor */
+#else
+    struct pollfd      *pfds;       /**< poll() array of registered
+                                         file descriptors */
+    unsigned int        pfds_num;   /**< Number of used elements
+                                         in pfds */
+    unsigned int        pfds_size;  /**< Size of the pfds array */
+    te_bool             pfds_stale; /**< pfds should be rebuilt since
+                                         registered set is changed */
+#endif
+    ipc_evloop_entry  **entries;    /**< Entries indexed by file
+                                         descriptor */
+    unsigned int        entries_num; /**< Size of the entries array */
+    te_bool             dispatching; /**< Handlers are being called */
+    ipc_evloop_entry   *to_free;    /**< Entries unregistered during
+                                         dispatching */
+};
+
+
+/* See description in ipc_evloop.h */
+te_errno
+ipc_evloop_create(ipc_evloop **p_loop)
+{
+    ipc_evloop *loop;
+
+    if (p_loop == NULL)
+        return TE_RC(TE_IPC, TE_EINVAL);
+
+    loop = calloc(1, sizeof(*loop));
+    if (loop == NULL)
+        return TE_RC(TE_IPC, TE_ENOMEM);
+
+#if HAVE_SYS_EPOLL_H
+    loop->epfd = epoll_create(IPC_EVLOOP_MAX_EVENTS);
+    if (loop->epfd < 0)
+    {
+        int rc = errno;
+
+        perror("ipc_evloop_create(): epoll_create() error");
+        free(loop);
+        return TE_OS_RC(TE_IPC, rc);
+    }
+
+#if HAVE_FCNTL_H
+    (void)fcntl(loop->epfd, F_SETFD, FD_CLOEXEC);
+#endif
+#endif /* HAVE_SYS_EPOLL_H */
+
+    *p_loop = loop;
+
+    return 0;
+}
+
+/* See description in ipc_evloop.h */
+void
+ipc_evloop_destroy(ipc_evloop *loop)
+{
+    unsigned int i;
+
+    if (loop == NULL)
+        return;
+
+    for (i = 0; i < loop->entries_num; i++)
+        free(loop->entries[i]);
+    free(loop->entries);
+
+#if HAVE_SYS_EPOLL_H
+    close(loop->epfd);
+#else
+    free(loop->pfds);
+#endif
+    free(loop);
+}
+
+/* See description in ipc_evloop.h */
+int
+ipc_evloop_fd(const ipc_evloop *loop)
+{
+#if HAVE_SYS_EPOLL_H
+    return loop == NULL ? -1 : loop->epfd;
+#else
+    UNUSED(loop);
+    return -1;
+#endif
+}
+
+/* See description in ipc_evloop.h */
+int
+ipc_evloop_fd_set(const ipc_evloop *loop, fd_set *set)
+{
+    int max_fd = -1;
+
+    if (loop == NULL || set == NULL)
+        return -1;
+
+#if HAVE_SYS_EPOLL_H
+    max_fd = loop->epfd;
+    FD_SET(max_fd, set);
+#else
+    {
+        unsigned int i;
+
+        for (i = 0; i < loop->entries_num && i < FD_SETSIZE; i++)
+        {
+            if (loop->entries[i] != NULL)
+            {
+                FD_SET(i, set);
+                max_fd = i;
+            }
+        }
+    }
+#endif
+
+    return max_fd;
+}
+
+/* See description in ipc_evloop.h */
+te_errno
+ipc_evloop_add(ipc_evloop *loop, int fd, unsigned int flags,
+               ipc_evloop_handler handler, void *opaque)
+{
+#if HAVE_SYS_EPOLL_H
+    struct epoll_event  ev;
+    int                 rc;
+#endif
+    ipc_evloop_entry   *entry;
+
+    if (loop == NULL || fd < 0 || handler == NULL)
+        return TE_RC(TE_IPC, TE_EINVAL);
+
+    if ((unsigned int)fd >= loop->entries_num)
+    {
+        unsigned int       num = MAX(loop->entries_num * 2,
+                                     (unsigned int)fd + 1);
+        ipc_evloop_entry **entries;
+
+        entries = realloc(loop->entries, num * sizeof(*entries));
+        if (entries == NULL)
+            return TE_RC(TE_IPC, TE_ENOMEM);
+
+        memset(entries + loop->entries_num, 0,
+               (num - loop->entries_num) * sizeof(*entries));
+        loop->entries = entries;
+        loop->entries_num = num;
+    }
+
+    if (loop->entries[fd] != NULL)
+        return TE_RC(TE_IPC, TE_EEXIST);
+
+    entry = calloc(1, sizeof(*entry));
+    if (entry == NULL)
+        return TE_RC(TE_IPC, TE_ENOMEM);
+
+    entry->fd = fd;
+    entry->handler = handler;
+    entry->opaque = opaque;
+
+#if HAVE_SYS_EPOLL_H
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    if (flags & IPC_EVLOOP_EDGE)
+        ev.events |= EPOLLET;
+    ev.data.ptr = entry;
+
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        rc = errno;
+        perror("ipc_evloop_add(): epoll_ctl() error");
+        free(entry);
+        return TE_OS_RC(TE_IPC, rc);
+    }
+#else
+    /* poll() is level-triggered, edge-triggered handlers tolerate it */
+    UNUSED(flags);
+    loop->pfds_stale = TRUE;
+#endif
+
+    loop->entries[fd] = entry;
+
+    return 0;
+}
+
+/* See description in ipc_evloop.h */
+te_errno
+ipc_evloop_del(ipc_evloop *loop, int fd)
+{
+    ipc_evloop_entry *entry;
+
+    if (loop == NULL || fd < 0 || (unsigned int)fd >= loop->entries_num ||
+        (entry = loop->entries[fd]) == NULL)
+    {
+        return TE_RC(TE_IPC, TE_ENOENT);
+    }
+
+    loop->entries[fd] = NULL;
+#if HAVE_SYS_EPOLL_H
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_DEL, fd, NULL) != 0)
+        perror("ipc_evloop_del(): epoll_ctl() error");
+#else
+    loop->pfds_stale = TRUE;
+#endif
+
+    if (loop->dispatching)
+    {
+        /* Events for the entry may be retrieved already */
+        entry->handler = NULL;
+        entry->next_free = loop->to_free;
+        loop->to_free = entry;
+    }
+    else
+    {
+        free(entry);
+    }
+
+    return 0;
+}
+
+#if !HAVE_SYS_EPOLL_H
+/**
+ * Rebuild poll() array from registered entries.
+ *
+ * @param loop          Event loop handle
+ *
+ * @return Status code.
+ */
+static te_errno
+ipc_evloop_pfds_rebuild(ipc_evloop *loop)
+{
+    unsigned int i;
+
+    if (loop->pfds_size < loop->entries_num)
+    {
+        struct pollfd *pfds;
+
+        pfds = realloc(loop->pfds, loop->entries_num * sizeof(*pfds));
+        if (pfds == NULL)
+            return TE_RC(TE_IPC, TE_ENOMEM);
+
+        loop->pfds = pfds;
+        loop->pfds_size = loop->entries_num;
+    }
+
+    loop->pfds_num = 0;
+    for (i = 0; i < loop->entries_num; i++)
+    {
+        if (loop->entries[i] == NULL)
+            continue;
+
+        loop->pfds[loop->pfds_num].fd = i;
+        loop->pfds[loop->pfds_num].events = POLLIN;
+        loop->pfds[loop->pfds_num].revents = 0;
+        loop->pfds_num++;
+    }
+    loop->pfds_stale = FALSE;
+
+    return 0;
+}
+#endif
+
+/* See description in ipc_evloop.h */
+te_errno
+ipc_evloop_dispatch(ipc_evloop *loop, int timeout, unsigned int *p_num)
+{
+#if HAVE_SYS_EPOLL_H
+    struct epoll_event  events[IPC_EVLOOP_MAX_EVENTS];
+#endif
+    ipc_evloop_entry   *entry;
+    unsigned int        num = 0;
+    int                 n;
+    int                 i;
+
+    if (loop == NULL)
+        return TE_RC(TE_IPC, TE_EINVAL);
+
+#if HAVE_SYS_EPOLL_H
+    n = epoll_wait(loop->epfd, events, TE_ARRAY_LEN(events), timeout);
+    if (n < 0)
+    {
+        int rc = errno;
+
+        if (rc != EINTR)
+            perror("ipc_evloop_dispatch(): epoll_wait() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+#else
+    if (loop->pfds_stale)
+    {
+        te_errno rc = ipc_evloop_pfds_rebuild(loop);
+
+        if (rc != 0)
+            return rc;
+    }
+
+    n = poll(loop->pfds, loop->pfds_num, timeout);
+    if (n < 0)
+    {
+        int rc = errno;
+
+        if (rc != EINTR)
+            perror("ipc_evloop_dispatch(): poll() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+    /* Handlers may change registered entries, but not the array */
+    n = loop->pfds_num;
+#endif
+
+    loop->dispatching = TRUE;
+    for (i = 0; i < n; i++)
+    {
+#if HAVE_SYS_EPOLL_H
+        entry = events[i].data.ptr;
+#else
+        if (loop->pfds[i].revents == 0)
+            continue;
+        /* Entries unregistered by handlers are NULL already */
+        entry = loop->entries[loop->pfds[i].fd];
+        if (entry == NULL)
+            continue;
+#endif
+        if (entry->handler == NULL)
+            continue;
+
+        entry->handler(entry->fd, entry->opaque);
+        num++;
+    }
+    loop->dispatching = FALSE;
+
+    while ((entry = loop->to_free) != NULL)
+    {
+        loop->to_free = entry->next_free;
+        free(entry);
+    }
+
+    if (p_num != NULL)
+        *p_num = num;
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief IPC library
+ *
+ * Event loop based on epoll() used by IPC server and Test Engine
+ * daemons to wait for readiness of many file descriptors without
+ * FD_SETSIZE limit and without scanning of all descriptors.
+ * If epoll() is not supported, poll() over all registered descriptors
+ * is used: edge-triggered descriptors become level-triggered and the
+ * cost of dispatching depends on the number of descriptors.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_IPC_EVLOOP_H__
+#define __TE_IPC_EVLOOP_H__
+
+#if HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @name Event loop handle */
+struct ipc_evloop;
+typedef struct ipc_evloop ipc_evloop;
+/*@}*/
+
+/** Flags of file descriptors registered in the event loop */
+typedef enum ipc_evloop_flags {
+    IPC_EVLOOP_LEVEL = 0,       /**< Level-triggered readiness: handler
+                                     is called on each dispatch while
+                                     there are data to read */
+    IPC_EVLOOP_EDGE = (1 << 0), /**< Edge-triggered readiness: handler
+                                     is called once when new data arrive,
+                                     user must remember the readiness
+                                     until all data are read; handler
+                                     must tolerate repeated calls
+                                     since poll() fallback is
+                                     level-triggered */
+} ipc_evloop_flags;
+
+/**
+ * Handler of readiness of file descriptor.
+ *
+ * It is allowed to call ipc_evloop_del() for any file descriptor
+ * (including @p fd) from the handler.
+ *
+ * @param fd            Ready file descriptor
+ * @param opaque        Opaque data specified on registration
+ */
+typedef void (*ipc_evloop_handler)(int fd, void *opaque);
+
+/**
+ * Create an event loop.
+ *
+ * @param p_loop        Location for the event loop handle
+ *
+ * @return Status code.
+ */
+extern te_errno ipc_evloop_create(ipc_evloop **p_loop);
+
+/**
+ * Destroy the event loop. Registered file descriptors are not closed.
+ *
+ * @param loop          Event loop handle (may be @c NULL)
+ */
+extern void ipc_evloop_destroy(ipc_evloop *loop);
+
+/**
+ * Get file descriptor which becomes readable when any of file
+ * descriptors registered in the event loop is ready. It allows to
+ * wait for the event loop in select() or poll() together with other
+ * file descriptors.
+ *
+ * @param loop          Event loop handle
+ *
+ * @return File descriptor or @c -1 (e.g. if epoll() is not supported,
+ *         see ipc_evloop_fd_set()).
+ */
+extern int ipc_evloop_fd(const ipc_evloop *loop);
+
+/**
+ * Add file descriptors to wait for the event loop in select() to
+ * the set: the descriptor returned by ipc_evloop_fd() or, if there is
+ * no such descriptor, all registered descriptors less than FD_SETSIZE.
+ * In the latter case ipc_evloop_dispatch() with zero timeout should be
+ * called regardless of the select() result.
+ *
+ * @param loop          Event loop handle
+ * @param set           Set of file descriptors
+ *
+ * @return Maximum added file descriptor or @c -1.
+ */
+extern int ipc_evloop_fd_set(const ipc_evloop *loop, fd_set *set);
+
+/**
+ * Register file descriptor in the event loop to wait for reading
+ * readiness (or connection closing).
+ *
+ * @param loop          Event loop handle
+ * @param fd            File descriptor
+ * @param flags         Flags (see ipc_evloop_flags)
+ * @param handler       Readiness handler
+ * @param opaque        Opaque data passed to @p handler
+ *
+ * @return Status code.
+ */
+extern te_errno ipc_evloop_add(ipc_evloop *loop, int fd,
+                               unsigned int flags,
+                               ipc_evloop_handler handler, void *opaque);
+
+/**
+ * Unregister file descriptor from the event loop. It should be
+ * called before the file descriptor is closed.
+ *
+ * @param loop          Event loop handle
+ * @param fd            File descriptor
+ *
+ * @return Status code.
+ */
+extern te_errno ipc_evloop_del(ipc_evloop *loop, int fd);
+
+/**
+ * Wait for readiness of registered file descriptors and call handlers
+ * of ready ones. Cost of the call does not depend on the number of
+ * registered file descriptors.
+ *
+ * @param loop          Event loop handle
+ * @param timeout       Timeout in milliseconds, @c 0 to return
+ *                      immediately, @c -1 to wait infinitely
+ * @param p_num         Location for number of called handlers
+ *                      (may be @c NULL)
+ *
+ * @return Status code.
+ * @retval TE_EINTR     Waiting is interrupted by a signal
+ */
+extern te_errno ipc_evloop_dispatch(ipc_evloop *loop, int timeout,
+                                    unsigned int *p_num);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_IPC_EVLOOP_H__ */
@@ -79,6 +79,10 @@ extern int ipc_get_server_fd(const struct ipc_server *ipcs);
  * @param set           Set to be updated
  *
  * @return Maximum file descriptor number or -1.
+ *
+ * @note The descriptor of connection-oriented server remains readable
+ *       while there are requests to be received, so it is safe to block
+ *       in select() on it after ipc_is_server_ready() returns @c FALSE.
  */
 extern int ipc_get_server_fds(const struct ipc_server *ipcs,
                               fd_set *set);
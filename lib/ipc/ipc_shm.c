@@ -0,0 +1,534 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief IPC library
+ *
+ * Implementation of shared memory transport of connection-oriented IPC.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#if HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#if HAVE_SYS_POLL_H
+#include <sys/poll.h>
+#endif
+#if HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "ipc_shm.h"
+
+
+#if HAVE_SYS_MMAN_H && HAVE_SYS_EVENTFD_H && defined(MFD_CLOEXEC)
+/** Shared memory channel may be created */
+#define IPC_SHM_SUPPORTED 1
+#endif
+
+#ifdef MSG_CMSG_CLOEXEC
+/** Flags of recvmsg() receiving file descriptors */
+#define IPC_SHM_RECV_FLAGS  MSG_CMSG_CLOEXEC
+#else
+#define IPC_SHM_RECV_FLAGS  0
+#endif
+
+/** Magic number in the header of the shared memory */
+#define IPC_SHM_MAGIC   0x54454950
+
+/** Size of cache line used to separate positions of peers */
+#define IPC_SHM_CACHE_LINE  64
+
+/**
+ * Byte stream ring. Positions are incremented infinitely, offset in
+ * the data is a position modulo the ring size.
+ */
+struct ipc_shm_ring {
+    /** Position of the next octet to write (changed by writer) */
+    uint64_t head __attribute__((aligned(IPC_SHM_CACHE_LINE)));
+    /** Writer waits for free space */
+    uint32_t writer_waiting;
+
+    /** Position of the next octet to read (changed by reader) */
+    uint64_t tail __attribute__((aligned(IPC_SHM_CACHE_LINE)));
+    /** Reader waits for data */
+    uint32_t reader_waiting;
+};
+
+/** Header of the shared memory */
+typedef struct ipc_shm_hdr {
+    uint32_t            magic;      /**< IPC_SHM_MAGIC */
+    uint32_t            size;       /**< Size of each ring */
+    /** Rings: client to server and server to client */
+    struct ipc_shm_ring rings[2];
+} ipc_shm_hdr;
+
+/** Offset of rings data in the shared memory */
+#define IPC_SHM_DATA_OFFSET \
+    ((sizeof(ipc_shm_hdr) + IPC_SHM_CACHE_LINE - 1) & \
+     ~(size_t)(IPC_SHM_CACHE_LINE - 1))
+
+
+/**
+ * Fill in channel fields using mapped memory.
+ *
+ * @param chan      Channel
+ * @param client    Is it client side?
+ * @param size      Size of each ring
+ */
+static void
+ipc_shm_setup(ipc_shm_chan *chan, te_bool client, size_t size)
+{
+    ipc_shm_hdr *hdr = chan->mem;
+    uint8_t     *data = (uint8_t *)chan->mem + IPC_SHM_DATA_OFFSET;
+
+    chan->size = size;
+    chan->tx = &hdr->rings[client ? 0 : 1];
+    chan->rx = &hdr->rings[client ? 1 : 0];
+    chan->tx_data = data + (client ? 0 : chan->size);
+    chan->rx_data = data + (client ? chan->size : 0);
+}
+
+/**
+ * Wake up the peer.
+ *
+ * @param chan      Channel
+ */
+static void
+ipc_shm_kick(ipc_shm_chan *chan)
+{
+    uint64_t one = 1;
+
+    if (write(chan->peer_efd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        perror("ipc_shm_kick(): write() error");
+}
+
+/**
+ * Wait until the peer wakes up the own eventfd or closes the
+ * connection.
+ *
+ * @param chan      Channel
+ *
+ * @return Status code.
+ */
+static te_errno
+ipc_shm_wait(ipc_shm_chan *chan)
+{
+    struct pollfd pfd[2];
+    int           rc;
+
+    pfd[0].fd = chan->own_efd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = chan->socket;
+    pfd[1].events = POLLIN;
+
+    do {
+        pfd[0].revents = pfd[1].revents = 0;
+        rc = poll(pfd, TE_ARRAY_LEN(pfd), -1);
+    } while (rc < 0 && errno == EINTR);
+
+    if (rc < 0)
+    {
+        rc = errno;
+        perror("ipc_shm_wait(): poll() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+
+    if (pfd[0].revents & POLLIN)
+    {
+        ipc_shm_drain(chan);
+        return 0;
+    }
+
+    /* Nothing is sent over the socket after switching to shared memory */
+    if (ipc_shm_peer_closed(chan))
+        return TE_RC(TE_IPC, TE_ECONNRESET);
+
+    fprintf(stderr, "ipc_shm_wait(): unexpected data in the socket\n");
+    return TE_RC(TE_IPC, TE_ESYNCFAILED);
+}
+
+/* See description in ipc_shm.h */
+te_errno
+ipc_shm_create(ipc_shm_chan *chan, int socket, int fds[IPC_SHM_FDS_NUM])
+{
+#ifdef IPC_SHM_SUPPORTED
+    ipc_shm_hdr *hdr;
+    te_errno     rc;
+
+    memset(chan, 0, sizeof(*chan));
+    chan->mem = MAP_FAILED;
+    chan->own_efd = chan->peer_efd = -1;
+    chan->socket = socket;
+    chan->mem_len = IPC_SHM_DATA_OFFSET + 2 * IPC_SHM_RING_SIZE;
+
+    chan->mem_fd = memfd_create("te_ipc", MFD_CLOEXEC);
+    if (chan->mem_fd < 0 ||
+        ftruncate(chan->mem_fd, chan->mem_len) != 0 ||
+        (chan->mem = mmap(NULL, chan->mem_len, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, chan->mem_fd, 0)) == MAP_FAILED ||
+        (chan->own_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0 ||
+        (chan->peer_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        rc = TE_OS_RC(TE_IPC, errno);
+        perror("ipc_shm_create() failed");
+        if (chan->mem == MAP_FAILED)
+            chan->mem = NULL;
+        ipc_shm_close(chan);
+        return rc;
+    }
+
+    hdr = chan->mem;
+    hdr->magic = IPC_SHM_MAGIC;
+    hdr->size = IPC_SHM_RING_SIZE;
+    ipc_shm_setup(chan, TRUE, IPC_SHM_RING_SIZE);
+
+    fds[0] = chan->mem_fd;
+    fds[1] = chan->own_efd;
+    fds[2] = chan->peer_efd;
+
+    return 0;
+#else
+    UNUSED(chan);
+    UNUSED(socket);
+    UNUSED(fds);
+    return TE_RC(TE_IPC, TE_EOPNOTSUPP);
+#endif
+}
+
+/* See description in ipc_shm.h */
+te_errno
+ipc_shm_attach(ipc_shm_chan *chan, int socket,
+               const int fds[IPC_SHM_FDS_NUM])
+{
+    ipc_shm_hdr *hdr;
+    off_t        len;
+    uint32_t     size;
+    te_errno     rc;
+
+    memset(chan, 0, sizeof(*chan));
+
+    len = lseek(fds[0], 0, SEEK_END);
+    if (len < (off_t)IPC_SHM_DATA_OFFSET)
+    {
+        fprintf(stderr, "ipc_shm_attach(): too small shared memory\n");
+        return TE_RC(TE_IPC, TE_EINVAL);
+    }
+
+    chan->mem_len = len;
+    chan->mem = mmap(NULL, chan->mem_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fds[0], 0);
+    if (chan->mem == MAP_FAILED)
+    {
+        rc = TE_OS_RC(TE_IPC, errno);
+        perror("ipc_shm_attach(): mmap() error");
+        chan->mem = NULL;
+        return rc;
+    }
+
+    /*
+     * Positions are reduced modulo the ring size, so it must be a power
+     * of 2 to keep offsets continuous when positions wrap around.
+     * The size is read once since the peer may change the memory.
+     */
+    hdr = chan->mem;
+    size = __atomic_load_n(&hdr->size, __ATOMIC_RELAXED);
+    if (hdr->magic != IPC_SHM_MAGIC || size == 0 ||
+        (size & (size - 1)) != 0 ||
+        IPC_SHM_DATA_OFFSET + 2 * (size_t)size > chan->mem_len)
+    {
+        fprintf(stderr, "ipc_shm_attach(): invalid shared memory\n");
+        munmap(chan->mem, chan->mem_len);
+        chan->mem = NULL;
+        return TE_RC(TE_IPC, TE_EINVAL);
+    }
+
+    /* Memory stays mapped after closing its descriptor */
+    close(fds[0]);
+    chan->mem_fd = -1;
+    chan->own_efd = fds[2];
+    chan->peer_efd = fds[1];
+    chan->socket = socket;
+    ipc_shm_setup(chan, FALSE, size);
+
+    return 0;
+}
+
+/* See description in ipc_shm.h */
+void
+ipc_shm_close(ipc_shm_chan *chan)
+{
+    if (chan->mem != NULL)
+        munmap(chan->mem, chan->mem_len);
+    if (chan->mem_fd >= 0)
+        close(chan->mem_fd);
+    if (chan->own_efd >= 0)
+        close(chan->own_efd);
+    if (chan->peer_efd >= 0)
+        close(chan->peer_efd);
+
+    chan->mem = NULL;
+    chan->mem_fd = chan->own_efd = chan->peer_efd = -1;
+}
+
+/* See description in ipc_shm.h */
+size_t
+ipc_shm_avail(const ipc_shm_chan *chan)
+{
+    return __atomic_load_n(&chan->rx->head, __ATOMIC_ACQUIRE) -
+           chan->rx->tail;
+}
+
+/* See description in ipc_shm.h */
+te_bool
+ipc_shm_arm(ipc_shm_chan *chan)
+{
+    __atomic_store_n(&chan->rx->reader_waiting, 1, __ATOMIC_SEQ_CST);
+    if (ipc_shm_avail(chan) == 0)
+        return FALSE;
+
+    __atomic_store_n(&chan->rx->reader_waiting, 0, __ATOMIC_RELAXED);
+    return TRUE;
+}
+
+/* See description in ipc_shm.h */
+void
+ipc_shm_drain(ipc_shm_chan *chan)
+{
+    uint64_t cnt;
+
+    __atomic_store_n(&chan->rx->reader_waiting, 0, __ATOMIC_RELAXED);
+    (void)read(chan->own_efd, &cnt, sizeof(cnt));
+}
+
+/* See description in ipc_shm.h */
+te_errno
+ipc_shm_read(ipc_shm_chan *chan, void *buf, size_t len)
+{
+    struct ipc_shm_ring *ring = chan->rx;
+    uint8_t             *p = buf;
+    size_t               avail;
+    size_t               off;
+    size_t               n;
+    te_errno             rc;
+
+    while (len > 0)
+    {
+        avail = ipc_shm_avail(chan);
+        if (avail == 0)
+        {
+            if (!ipc_shm_arm(chan) && (rc = ipc_shm_wait(chan)) != 0)
+                return rc;
+            continue;
+        }
+
+        n = MIN(avail, len);
+        off = ring->tail % chan->size;
+        if (off + n > chan->size)
+        {
+            memcpy(p, chan->rx_data + off, chan->size - off);
+            memcpy(p + chan->size - off, chan->rx_data,
+                   n - (chan->size - off));
+        }
+        else
+        {
+            memcpy(p, chan->rx_data + off, n);
+        }
+        __atomic_store_n(&ring->tail, ring->tail + n, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&ring->writer_waiting, __ATOMIC_SEQ_CST))
+            ipc_shm_kick(chan);
+
+        p += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+/* See description in ipc_shm.h */
+te_errno
+ipc_shm_write(ipc_shm_chan *chan, const void *buf, size_t len)
+{
+    struct ipc_shm_ring *ring = chan->tx;
+    const uint8_t       *p = buf;
+    size_t               space;
+    size_t               off;
+    size_t               n;
+    te_errno             rc;
+
+    while (len > 0)
+    {
+        space = chan->size - (ring->head -
+                              __atomic_load_n(&ring->tail,
+                                              __ATOMIC_ACQUIRE));
+        if (space == 0)
+        {
+            __atomic_store_n(&ring->writer_waiting, 1, __ATOMIC_SEQ_CST);
+            if (ring->head - __atomic_load_n(&ring->tail,
+                                             __ATOMIC_SEQ_CST) ==
+                    chan->size)
+            {
+                rc = ipc_shm_wait(chan);
+                if (rc != 0)
+                    return rc;
+            }
+            __atomic_store_n(&ring->writer_waiting, 0, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        n = MIN(space, len);
+        off = ring->head % chan->size;
+        if (off + n > chan->size)
+        {
+            memcpy(chan->tx_data + off, p, chan->size - off);
+            memcpy(chan->tx_data, p + chan->size - off,
+                   n - (chan->size - off));
+        }
+        else
+        {
+            memcpy(chan->tx_data + off, p, n);
+        }
+        __atomic_store_n(&ring->head, ring->head + n, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&ring->reader_waiting, __ATOMIC_SEQ_CST))
+            ipc_shm_kick(chan);
+
+        p += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+/* See description in ipc_shm.h */
+te_bool
+ipc_shm_peer_closed(const ipc_shm_chan *chan)
+{
+    char c;
+    int  r = recv(chan->socket, &c, sizeof(c), MSG_PEEK | MSG_DONTWAIT);
+
+    return r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+                      errno != EINTR);
+}
+
+/* See description in ipc_shm.h */
+te_errno
+ipc_shm_send_fds(int socket, const int fds[IPC_SHM_FDS_NUM])
+{
+    size_t          len = IPC_SHM_HANDSHAKE;
+    struct iovec    iov = { .iov_base = &len, .iov_len = sizeof(len) };
+    union {
+        char            buf[CMSG_SPACE(sizeof(int) * IPC_SHM_FDS_NUM)];
+        struct cmsghdr  align;
+    } ctl;
+    struct msghdr   msg;
+    struct cmsghdr *cmsg;
+    ssize_t         r;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&ctl, 0, sizeof(ctl));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctl.buf;
+    msg.msg_controllen = sizeof(ctl.buf);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * IPC_SHM_FDS_NUM);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * IPC_SHM_FDS_NUM);
+
+    r = sendmsg(socket, &msg, 0);
+    if (r != (ssize_t)sizeof(len))
+    {
+        te_errno rc = r < 0 ? TE_OS_RC(TE_IPC, errno) :
+                              TE_RC(TE_IPC, TE_EIO);
+
+        perror("ipc_shm_send_fds(): sendmsg() error");
+        return rc;
+    }
+
+    return 0;
+}
+
+/* See description in ipc_shm.h */
+te_errno
+ipc_shm_recv_fds(int socket, void *buf, size_t len,
+                 int fds[IPC_SHM_FDS_NUM])
+{
+    struct iovec    iov;
+    union {
+        char            buf[CMSG_SPACE(sizeof(int) * IPC_SHM_FDS_NUM)];
+        struct cmsghdr  align;
+    } ctl;
+    struct msghdr   msg;
+    struct cmsghdr *cmsg;
+    unsigned int    i;
+    ssize_t         r;
+
+    for (i = 0; i < IPC_SHM_FDS_NUM; i++)
+        fds[i] = -1;
+
+    while (len > 0)
+    {
+        memset(&msg, 0, sizeof(msg));
+        iov.iov_base = buf;
+        iov.iov_len = len;
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctl.buf;
+        msg.msg_controllen = sizeof(ctl.buf);
+
+        r = recvmsg(socket, &msg, IPC_SHM_RECV_FLAGS);
+        if (r < 0)
+        {
+            perror("ipc_shm_recv_fds(): recvmsg() error");
+            return TE_OS_RC(TE_IPC, errno);
+        }
+        else if (r == 0)
+        {
+            return TE_RC(TE_IPC, TE_ECONNABORTED);
+        }
+
+        for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET &&
+                cmsg->cmsg_type == SCM_RIGHTS &&
+                cmsg->cmsg_len == CMSG_LEN(sizeof(int) * IPC_SHM_FDS_NUM) &&
+                fds[0] < 0)
+            {
+                memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * IPC_SHM_FDS_NUM);
+            }
+        }
+
+        len -= r;
+        buf = (uint8_t *)buf + r;
+    }
+
+    return 0;
+}
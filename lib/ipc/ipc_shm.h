@@ -0,0 +1,188 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief IPC library
+ *
+ * Shared memory transport of connection-oriented IPC between processes
+ * on the same host. Two byte stream rings (one per direction) are
+ * placed in a memory file descriptor which is passed to the server over
+ * the connection socket together with wakeup eventfd descriptors of both
+ * peers. The connection socket is kept to detect termination of the peer.
+ *
+ * Internal definitions shared by IPC client and server.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_IPC_SHM_H__
+#define __TE_IPC_SHM_H__
+
+#include "te_defs.h"
+#include "te_stdint.h"
+#include "te_errno.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Value sent by the client instead of message length to request
+ * switching the connection to shared memory transport.
+ */
+#define IPC_SHM_HANDSHAKE       ((size_t)-2)
+
+/** Number of file descriptors passed in the handshake */
+#define IPC_SHM_FDS_NUM         3
+
+/** Size of the ring of each direction */
+#define IPC_SHM_RING_SIZE       (1 << 18)
+
+struct ipc_shm_ring;
+
+/** Endpoint of the shared memory channel */
+typedef struct ipc_shm_chan {
+    void                   *mem;        /**< Mapped memory */
+    size_t                  mem_len;    /**< Length of mapped memory */
+    struct ipc_shm_ring    *tx;         /**< Ring to write to */
+    struct ipc_shm_ring    *rx;         /**< Ring to read from */
+    uint8_t                *tx_data;    /**< Data of the ring to write */
+    uint8_t                *rx_data;    /**< Data of the ring to read */
+    uint32_t                size;       /**< Size of each ring */
+    int                     mem_fd;     /**< Memory file descriptor or
+                                             @c -1 */
+    int                     own_efd;    /**< Eventfd to wait on */
+    int                     peer_efd;   /**< Eventfd to wake up peer */
+    int                     socket;     /**< Connection socket used to
+                                             detect peer termination */
+} ipc_shm_chan;
+
+/**
+ * Create the shared memory channel on the client side.
+ *
+ * @param chan          Channel to initialize
+ * @param socket        Connection socket
+ * @param fds           Location for file descriptors to be passed to
+ *                      the server; they are owned by the channel
+ *
+ * @return Status code.
+ * @retval TE_EOPNOTSUPP    Shared memory transport is not supported
+ */
+extern te_errno ipc_shm_create(ipc_shm_chan *chan, int socket,
+                               int fds[IPC_SHM_FDS_NUM]);
+
+/**
+ * Attach to the shared memory channel on the server side.
+ *
+ * @param chan          Channel to initialize
+ * @param socket        Connection socket
+ * @param fds           File descriptors received from the client;
+ *                      they are owned by the channel on success
+ *
+ * @return Status code.
+ */
+extern te_errno ipc_shm_attach(ipc_shm_chan *chan, int socket,
+                               const int fds[IPC_SHM_FDS_NUM]);
+
+/**
+ * Release resources of the channel. Connection socket is not closed.
+ *
+ * @param chan          Channel
+ */
+extern void ipc_shm_close(ipc_shm_chan *chan);
+
+/**
+ * Get number of octets available for reading.
+ *
+ * @param chan          Channel
+ *
+ * @return Number of octets.
+ */
+extern size_t ipc_shm_avail(const ipc_shm_chan *chan);
+
+/**
+ * Ask the peer to wake up the own eventfd when data are written.
+ * After the call the caller should wait for the eventfd only if
+ * @c FALSE is returned.
+ *
+ * @param chan          Channel
+ *
+ * @return @c TRUE if data are available and the caller should not wait.
+ */
+extern te_bool ipc_shm_arm(ipc_shm_chan *chan);
+
+/**
+ * Reset the counter of the own eventfd after wakeup and stop asking
+ * the peer for wakeups.
+ *
+ * @param chan          Channel
+ */
+extern void ipc_shm_drain(ipc_shm_chan *chan);
+
+/**
+ * Read specified number of octets (not less), wait for the peer
+ * if necessary.
+ *
+ * @param chan          Channel
+ * @param buf           Buffer for data
+ * @param len           Number of octets to read
+ *
+ * @return Status code.
+ * @retval TE_ECONNRESET    Peer closed the connection
+ */
+extern te_errno ipc_shm_read(ipc_shm_chan *chan, void *buf, size_t len);
+
+/**
+ * Write specified number of octets (not less), wait for the peer
+ * to free space in the ring if necessary.
+ *
+ * @param chan          Channel
+ * @param buf           Data to write
+ * @param len           Number of octets to write
+ *
+ * @return Status code.
+ * @retval TE_ECONNRESET    Peer closed the connection
+ */
+extern te_errno ipc_shm_write(ipc_shm_chan *chan, const void *buf,
+                              size_t len);
+
+/**
+ * Check whether the peer closed connection socket. It does not block.
+ *
+ * @param chan          Channel
+ *
+ * @return @c TRUE if connection is closed.
+ */
+extern te_bool ipc_shm_peer_closed(const ipc_shm_chan *chan);
+
+/**
+ * Send file descriptors of the channel over the connection socket
+ * together with handshake length value.
+ *
+ * @param socket        Connection socket
+ * @param fds           File descriptors
+ *
+ * @return Status code.
+ */
+extern te_errno ipc_shm_send_fds(int socket,
+                                 const int fds[IPC_SHM_FDS_NUM]);
+
+/**
+ * Receive specified number of octets from the connection socket.
+ * File descriptors attached to the data are returned if any.
+ *
+ * @param socket        Connection socket
+ * @param buf           Buffer for data
+ * @param len           Number of octets to read
+ * @param fds           Location for file descriptors (filled in by
+ *                      @c -1 if there are no descriptors)
+ *
+ * @return Status code.
+ */
+extern te_errno ipc_shm_recv_fds(int socket, void *buf, size_t len,
+                                 int fds[IPC_SHM_FDS_NUM]);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_IPC_SHM_H__ */
@@ -38,6 +38,9 @@
 #if HAVE_SYS_POLL_H
 #include <sys/poll.h>
 #endif
+#if HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
 
 #ifndef TE_IPC_AF_UNIX
 #if HAVE_NETINET_IN_H
@@ -55,6 +58,8 @@
 #include "te_errno.h"
 #include "te_queue.h"
 #include "ipc_server.h"
+#include "ipc_evloop.h"
+#include "ipc_shm.h"
 
 #include "ipc_internal.h"
 
@@ -102,8 +107,13 @@ struct ipc_server_client {
         } dgram;
         struct {
             int         socket;     /**< Connected socket to client */
-            te_bool     is_ready;   /**< Is client socket ready for
-                                         reading? */
+            ipc_shm_chan *shm;      /**< Shared memory channel or @c NULL
+                                         if data are sent over socket */
+            struct ipc_server *server;  /**< Server of the client */
+            te_bool     is_ready;   /**< Is client in the queue of
+                                         ready clients? */
+            /** Links in the queue of ready clients */
+            TAILQ_ENTRY(ipc_server_client) ready_links;
             size_t      pending;    /**< Number of octets in current
                                          message left to read from
                                          socket and to return to user.
@@ -135,7 +145,18 @@ struct ipc_server {
             struct ipc_datagrams    datagrams;  /**< Delayed datagrams */
         } dgram;
         struct {
-            char   *out_buffer;    /**< Buffer for outgoing messages */
+            char       *out_buffer; /**< Buffer for outgoing messages */
+            ipc_evloop *evloop;     /**< Event loop with server and
+                                         clients sockets */
+            /** Queue of clients with data to read */
+            TAILQ_HEAD(ipc_server_ready_clients, ipc_server_client) ready;
+            int         ready_fds[2]; /**< Read and write ends of
+                                           descriptor registered in
+                                           the event loop which is
+                                           signalled while the queue
+                                           of ready clients is not
+                                           empty (the same eventfd or
+                                           a pipe) */
         } stream;
     };
 
@@ -173,6 +194,9 @@ static int ipc_int_get_datagram(struct ipc_server *ipcs,
                                 struct ipc_server_client **p_ipcsc);
 
 
+static void ipc_server_accept_ready(int fd, void *opaque);
+static void ipc_server_queue_wakeup(int fd, void *opaque);
+
 static int read_socket(int socket, void *buffer, size_t len);
 static int write_socket(int socket, const void *buffer, size_t len);
 
@@ -194,6 +218,86 @@ static int ipc_stream_send_answer(struct ipc_server *ipcs,
  * Global functions implementation
  */
 
+/**
+ * Create descriptor to be signalled while the queue of ready clients
+ * is not empty: eventfd if it is supported, pipe otherwise.
+ *
+ * @param fds       Location for read and write ends
+ *
+ * @return Status code.
+ */
+static te_errno
+ipc_server_ready_fds_open(int fds[2])
+{
+#if HAVE_SYS_EVENTFD_H
+    fds[0] = fds[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fds[0] < 0)
+    {
+        int rc = errno;
+
+        perror("ipc_register_server(): eventfd() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+#else
+    if (pipe(fds) != 0)
+    {
+        int rc = errno;
+
+        perror("ipc_register_server(): pipe() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+#if HAVE_FCNTL_H
+    (void)fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    (void)fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    (void)fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    (void)fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+#endif
+
+    return 0;
+}
+
+/**
+ * Close descriptor created by ipc_server_ready_fds_open().
+ *
+ * @param fds       Read and write ends
+ */
+static void
+ipc_server_ready_fds_close(int fds[2])
+{
+    close(fds[0]);
+    if (fds[1] != fds[0])
+        close(fds[1]);
+}
+
+/**
+ * Set or reset descriptor created by ipc_server_ready_fds_open().
+ * It is set when the queue becomes not empty and reset when it becomes
+ * empty, so a pipe never has more than one octet in it.
+ *
+ * @param fds       Read and write ends
+ * @param set       Set if @c TRUE, reset otherwise
+ */
+static void
+ipc_server_ready_fds_signal(int fds[2], te_bool set)
+{
+#if HAVE_SYS_EVENTFD_H
+    eventfd_t value;
+
+    if (set)
+        (void)eventfd_write(fds[1], 1);
+    else
+        (void)eventfd_read(fds[0], &value);
+#else
+    char c = 0;
+
+    if (set)
+        (void)write(fds[1], &c, sizeof(c));
+    else
+        (void)read(fds[0], &c, sizeof(c));
+#endif
+}
+
 /* See description in ipc_server.h */
 int
 ipc_register_server(const char *name, te_bool conn,
@@ -322,6 +426,43 @@ ipc_register_server(const char *name, te_bool conn,
                 return TE_OS_RC(TE_IPC, rc);
             }
         }
+        TAILQ_INIT(&ipcs->stream.ready);
+        rc = ipc_server_ready_fds_open(ipcs->stream.ready_fds);
+        if (rc != 0)
+        {
+            free(ipcs->stream.out_buffer);
+            close(ipcs->socket);
+            free(ipcs);
+            return rc;
+        }
+        rc = ipc_evloop_create(&ipcs->stream.evloop);
+        if (rc == 0)
+        {
+            rc = ipc_evloop_add(ipcs->stream.evloop, ipcs->socket,
+                                IPC_EVLOOP_LEVEL, ipc_server_accept_ready,
+                                ipcs);
+        }
+        /*
+         * Clients in the queue of ready clients do not make the event
+         * loop descriptor readable since they are edge-triggered, so
+         * the queue keeps it readable itself while it is not empty.
+         */
+        if (rc == 0)
+        {
+            rc = ipc_evloop_add(ipcs->stream.evloop,
+                                ipcs->stream.ready_fds[0],
+                                IPC_EVLOOP_LEVEL, ipc_server_queue_wakeup,
+                                ipcs);
+        }
+        if (rc != 0)
+        {
+            ipc_evloop_destroy(ipcs->stream.evloop);
+            ipc_server_ready_fds_close(ipcs->stream.ready_fds);
+            free(ipcs->stream.out_buffer);
+            close(ipcs->socket);
+            free(ipcs);
+            return rc;
+        }
         ipcs->recv = ipc_stream_receive_message;
         ipcs->send = ipc_stream_send_answer;
     }
@@ -359,89 +500,411 @@ ipc_get_server_fd(const struct ipc_server *ipcs)
 int
 ipc_get_server_fds(const struct ipc_server *ipcs, fd_set *set)
 {
-    int                             max_fd;
-    const struct ipc_server_client *client;
+    int max_fd;
 
     if (ipcs == NULL)
         return -1;
 
-    FD_SET(ipcs->socket, set);
-    max_fd = ipcs->socket;
+    /*
+     * Server and clients sockets of connection-oriented server are
+     * watched by the event loop, so the only descriptor is required
+     * regardless of the number of clients (if epoll() is supported).
+     */
     if (ipcs->conn)
-    {
-        LIST_FOREACH(client, &ipcs->clients, links)
-        {
-            FD_SET(client->stream.socket, set);
-            max_fd = MAX(max_fd, client->stream.socket);
-        }
-    }
+        return ipc_evloop_fd_set(ipcs->stream.evloop, set);
+
+    max_fd = ipcs->socket;
+    FD_SET(max_fd, set);
 
     return max_fd;
 }
 
+/**
+ * Remove the client from the queue of ready clients if it is there.
+ *
+ * @param ipcs      IPC server
+ * @param ipcsc     IPC server client
+ */
+static void
+ipc_server_unset_ready(struct ipc_server *ipcs,
+                       struct ipc_server_client *ipcsc)
+{
+    if (!ipcsc->stream.is_ready)
+        return;
+
+    ipcsc->stream.is_ready = FALSE;
+    TAILQ_REMOVE(&ipcs->stream.ready, ipcsc, stream.ready_links);
+    if (TAILQ_EMPTY(&ipcs->stream.ready))
+        ipc_server_ready_fds_signal(ipcs->stream.ready_fds, FALSE);
+}
+
 /**
  * Close IPC server association with client.
  *
+ * @param ipcs      IPC server
  * @param ipcsc     IPC server client
- * @param conn      Is connection-oriented server client or not?
  */
 static void
-ipc_server_close_client(struct ipc_server_client *ipcsc, te_bool conn)
+ipc_server_close_client(struct ipc_server *ipcs,
+                        struct ipc_server_client *ipcsc)
 {
     LIST_REMOVE(ipcsc, links);
-    if (conn)
+    if (ipcs->conn)
+    {
+        ipc_server_unset_ready(ipcs, ipcsc);
+        if (ipcsc->stream.shm != NULL)
+        {
+            (void)ipc_evloop_del(ipcs->stream.evloop,
+                                 ipcsc->stream.shm->own_efd);
+            ipc_shm_close(ipcsc->stream.shm);
+            free(ipcsc->stream.shm);
+        }
+        (void)ipc_evloop_del(ipcs->stream.evloop, ipcsc->stream.socket);
         close(ipcsc->stream.socket);
+    }
     else
+    {
         free(ipcsc->dgram.buffer);
+    }
     free(ipcsc);
 }
 
-/* See description in ipc_server.h */
-te_bool
-ipc_is_server_ready(struct ipc_server *ipcs, const fd_set *set, int max_fd)
+/**
+ * Put the client to the tail of the queue of ready clients.
+ *
+ * @param ipcs      IPC server
+ * @param ipcsc     IPC server client
+ */
+static void
+ipc_server_set_ready(struct ipc_server *ipcs,
+                     struct ipc_server_client *ipcsc)
 {
-    te_bool                     is_ready = FALSE;
-    struct ipc_server_client   *client, *next;
+    if (!ipcsc->stream.is_ready)
+    {
+        if (TAILQ_EMPTY(&ipcs->stream.ready))
+            ipc_server_ready_fds_signal(ipcs->stream.ready_fds, TRUE);
+        ipcsc->stream.is_ready = TRUE;
+        TAILQ_INSERT_TAIL(&ipcs->stream.ready, ipcsc, stream.ready_links);
+    }
+}
 
-    if (ipcs == NULL || set == NULL)
-        return is_ready;
+/**
+ * Check whether the client has closed the connection. It should be
+ * checked when there are no data to read, since closing may be
+ * reported by the same readiness event as the last data.
+ *
+ * @param ipcsc     IPC server client
+ *
+ * @return @c TRUE if the connection is closed or broken.
+ */
+static te_bool
+ipc_server_client_closed(const struct ipc_server_client *ipcsc)
+{
+    char    c;
+    ssize_t r;
+
+    if (ipcsc->stream.shm != NULL)
+        return ipc_shm_peer_closed(ipcsc->stream.shm);
+
+    r = recv(ipcsc->stream.socket, &c, sizeof(c), MSG_PEEK | MSG_DONTWAIT);
+
+    return r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+                      errno != EINTR);
+}
+
+/**
+ * Put the client to the queue of ready clients if it has sent more
+ * data or has closed the connection. Readiness is edge-triggered, so
+ * it should be checked when the message is read since no new event
+ * comes for data and closing which have happened already.
+ *
+ * A closed connection is not closed here, since the user may still
+ * send an answer to the message which has just been read. It is
+ * closed by the receiver when it takes the client from the queue.
+ *
+ * @param ipcs      IPC server
+ * @param ipcsc     IPC server client
+ */
+static void
+ipc_server_requeue_client(struct ipc_server *ipcs,
+                          struct ipc_server_client *ipcsc)
+{
+    int available = 0;
 
-    if (ipcs->socket <= max_fd)
+    if (ipcsc->stream.is_ready || ipcsc->stream.pending != 0)
+        return;
+
+    if (ipcsc->stream.shm != NULL)
     {
-        is_ready = is_ready ||
-            (ipcs->is_ready = FD_ISSET(ipcs->socket, set));
+        if (!ipc_shm_arm(ipcsc->stream.shm) &&
+            !ipc_server_client_closed(ipcsc))
+            return;
     }
-    if (ipcs->conn)
+    else if ((ioctl(ipcsc->stream.socket, FIONREAD, &available) != 0 ||
+              available == 0) && !ipc_server_client_closed(ipcsc))
+    {
+        return;
+    }
+
+    ipc_server_set_ready(ipcs, ipcsc);
+}
+
+/**
+ * Put the client to the tail of the queue of ready clients if
+ * there are data to read in its connection. The connection is
+ * closed if the client has closed it.
+ *
+ * @param ipcs      IPC server
+ * @param ipcsc     IPC server client
+ */
+static void
+ipc_server_check_client(struct ipc_server *ipcs,
+                        struct ipc_server_client *ipcsc)
+{
+    int available = 0;
+
+    if (ipcsc->stream.is_ready)
+        return;
+
+    if (ipcsc->stream.shm != NULL)
     {
-        LIST_FOREACH_SAFE(client, &ipcs->clients, links, next)
+        ipc_shm_drain(ipcsc->stream.shm);
+        if (ipc_shm_avail(ipcsc->stream.shm) > 0 ||
+            ipc_shm_arm(ipcsc->stream.shm))
         {
-            if (client->stream.socket <= max_fd)
-            {
-                client->stream.is_ready =
-                    FD_ISSET(client->stream.socket, set);
-                if (client->stream.is_ready)
-                {
-                    int available = 0;
+            ipc_server_set_ready(ipcs, ipcsc);
+        }
+        else if (ipc_shm_peer_closed(ipcsc->stream.shm))
+        {
+            ipc_server_close_client(ipcs, ipcsc);
+        }
+        return;
+    }
 
-                    /*
-                     * select() returns read event when data are
-                     * available and when client closes its socket.
-                     */
+    /*
+     * Readiness is reported when data are available and when client
+     * closes its socket. Data reported by the event may be read
+     * already if the client has been requeued after the previous
+     * message, so the connection is closed only if it is really
+     * closed.
+     */
+    if (ioctl(ipcsc->stream.socket, FIONREAD, &available) < 0)
+        perror("FIONREAD ioctl() failed");
 
-                    if (ioctl(client->stream.socket, FIONREAD,
-                              &available) < 0)
-                        perror("FIONREAD ioctl() failed");
+    if (available > 0)
+        ipc_server_set_ready(ipcs, ipcsc);
+    else if (ipc_server_client_closed(ipcsc))
+        ipc_server_close_client(ipcs, ipcsc);
+}
 
-                    if (available > 0)
-                        is_ready = TRUE;
-                    else
-                        ipc_server_close_client(client, ipcs->conn);
-                }
-            }
+/**
+ * Event loop handler of connected client socket and shared memory
+ * channel wakeups (edge-triggered).
+ *
+ * @param fd        Client socket or eventfd
+ * @param opaque    IPC server client
+ */
+static void
+ipc_server_client_ready(int fd, void *opaque)
+{
+    struct ipc_server_client *ipcsc = opaque;
+
+    UNUSED(fd);
+
+    /*
+     * If the message is partially read, the rest is read by the user
+     * and readiness is checked after that.
+     */
+    if (ipcsc->stream.pending == 0)
+        ipc_server_check_client(ipcsc->stream.server, ipcsc);
+}
+
+/**
+ * Switch the client connection to shared memory transport and
+ * report the result to the client over the socket.
+ *
+ * @param ipcs      IPC server
+ * @param ipcsc     IPC server client
+ * @param fds       File descriptors passed by the client
+ *
+ * @return Status code.
+ */
+static int
+ipc_server_shm_attach(struct ipc_server *ipcs,
+                      struct ipc_server_client *ipcsc,
+                      const int fds[IPC_SHM_FDS_NUM])
+{
+    ipc_shm_chan   *chan;
+    size_t          status;
+    unsigned int    i;
+    te_errno        rc;
+
+    chan = calloc(1, sizeof(*chan));
+    if (chan == NULL)
+        rc = TE_RC(TE_IPC, TE_ENOMEM);
+    else if (fds[0] < 0)
+        rc = TE_RC(TE_IPC, TE_EINVAL);
+    else
+        rc = ipc_shm_attach(chan, ipcsc->stream.socket, fds);
+
+    if (rc != 0)
+    {
+        for (i = 0; i < IPC_SHM_FDS_NUM; i++)
+        {
+            if (fds[i] >= 0)
+                close(fds[i]);
         }
     }
+    else
+    {
+        rc = ipc_evloop_add(ipcs->stream.evloop, chan->own_efd,
+                            IPC_EVLOOP_EDGE, ipc_server_client_ready,
+                            ipcsc);
+        if (rc != 0)
+            ipc_shm_close(chan);
+    }
+
+    if (rc != 0)
+    {
+        fprintf(stderr, "IPC server '%s': failed to use shared memory "
+                "for client: %s\n", ipcs->name, te_rc_err2str(rc));
+        free(chan);
+    }
+    else
+    {
+        ipcsc->stream.shm = chan;
+    }
+
+    /* Client falls back to the socket if the status is not zero */
+    status = rc;
+    return write_socket(ipcsc->stream.socket, &status, sizeof(status));
+}
+
+/**
+ * Read specified number of octets from the client connection.
+ *
+ * @param ipcsc     IPC server client
+ * @param buf       Buffer for data
+ * @param len       Number of octets to read
+ *
+ * @return Status code.
+ * @retval TE_ECONNABORTED  Client closed the connection
+ */
+static int
+ipc_server_client_read(struct ipc_server_client *ipcsc,
+                       void *buf, size_t len)
+{
+    te_errno rc;
+
+    if (ipcsc->stream.shm == NULL)
+        return read_socket(ipcsc->stream.socket, buf, len);
+
+    rc = ipc_shm_read(ipcsc->stream.shm, buf, len);
+    if (TE_RC_GET_ERROR(rc) == TE_ECONNRESET)
+        rc = TE_RC(TE_IPC, TE_ECONNABORTED);
+
+    return rc;
+}
+
+/**
+ * Read length of the next message from the client. Request to
+ * switch the connection to shared memory transport is processed
+ * here as well.
+ *
+ * @param ipcs      IPC server
+ * @param ipcsc     IPC server client
+ *
+ * @return Status code.
+ * @retval TE_EAGAIN        Switching request is processed, there is
+ *                          no message yet
+ * @retval TE_ECONNABORTED  Client closed the connection
+ */
+static int
+ipc_server_read_length(struct ipc_server *ipcs,
+                       struct ipc_server_client *ipcsc)
+{
+    int             fds[IPC_SHM_FDS_NUM];
+    unsigned int    i;
+    int             rc;
+
+    if (ipcsc->stream.shm != NULL)
+    {
+        return ipc_server_client_read(ipcsc, &ipcsc->stream.pending,
+                                      sizeof(ipcsc->stream.pending));
+    }
+
+    rc = ipc_shm_recv_fds(ipcsc->stream.socket, &ipcsc->stream.pending,
+                          sizeof(ipcsc->stream.pending), fds);
+    if (rc == 0 && ipcsc->stream.pending == IPC_SHM_HANDSHAKE)
+    {
+        ipcsc->stream.pending = 0;
+        rc = ipc_server_shm_attach(ipcs, ipcsc, fds);
+        return rc != 0 ? rc : TE_RC(TE_IPC, TE_EAGAIN);
+    }
+
+    /* File descriptors are not expected with usual messages */
+    for (i = 0; i < IPC_SHM_FDS_NUM; i++)
+    {
+        if (fds[i] >= 0)
+            close(fds[i]);
+    }
 
-    return is_ready;
+    return rc;
+}
+
+/**
+ * Event loop handler of the listening socket (level-triggered).
+ *
+ * @param fd        Server socket
+ * @param opaque    IPC server
+ */
+static void
+ipc_server_accept_ready(int fd, void *opaque)
+{
+    struct ipc_server *ipcs = opaque;
+
+    UNUSED(fd);
+    ipcs->is_ready = TRUE;
+}
+
+/**
+ * Event loop handler of the descriptor signalled while the queue of
+ * ready clients is not empty (level-triggered). Nothing is done here:
+ * the queue is processed by the receiver and the descriptor is reset
+ * when the queue becomes empty.
+ *
+ * @param fd        Read end of the descriptor
+ * @param opaque    IPC server
+ */
+static void
+ipc_server_queue_wakeup(int fd, void *opaque)
+{
+    UNUSED(fd);
+    UNUSED(opaque);
+}
+
+/* See description in ipc_server.h */
+te_bool
+ipc_is_server_ready(struct ipc_server *ipcs, const fd_set *set, int max_fd)
+{
+    int fd;
+
+    if (ipcs == NULL || set == NULL)
+        return FALSE;
+
+    if (!ipcs->conn)
+    {
+        if (ipcs->socket <= max_fd)
+            ipcs->is_ready = FD_ISSET(ipcs->socket, set);
+        return ipcs->is_ready;
+    }
+
+    /* Without epoll() registered descriptors are polled themselves */
+    fd = ipc_evloop_fd(ipcs->stream.evloop);
+    if (fd < 0 || (fd <= max_fd && FD_ISSET(fd, set)))
+        (void)ipc_evloop_dispatch(ipcs->stream.evloop, 0, NULL);
+
+    return ipcs->is_ready || !TAILQ_EMPTY(&ipcs->stream.ready);
 }
 
 /* See description in ipc_server.h */
@@ -468,6 +931,7 @@ ipc_close_server(struct ipc_server *ipcs)
     if (ipcs->conn)
     {
         free(ipcs->stream.out_buffer);
+        /* Clients are unregistered when they are closed below */
     }
     else
     {
@@ -486,7 +950,13 @@ ipc_close_server(struct ipc_server *ipcs)
     /* Free the pool */
     while ((ipcsc = LIST_FIRST(&ipcs->clients)) != NULL)
     {
-        ipc_server_close_client(ipcsc, ipcs->conn);
+        ipc_server_close_client(ipcs, ipcsc);
+    }
+
+    if (ipcs->conn)
+    {
+        ipc_evloop_destroy(ipcs->stream.evloop);
+        ipc_server_ready_fds_close(ipcs->stream.ready_fds);
     }
 
     /* Free instance */
@@ -777,7 +1247,7 @@ ipc_stream_server_receive(struct ipc_server *ipcs,
     assert(ipcsc != NULL);
 
     octets_to_read = MIN(*p_buf_len, ipcsc->stream.pending);
-    rc = read_socket(ipcsc->stream.socket, buf, octets_to_read);
+    rc = ipc_server_client_read(ipcsc, buf, octets_to_read);
     if (rc != 0)
     {
         fprintf(stderr, "ipc_stream_server_receive(): read_socket() "
@@ -793,6 +1263,8 @@ ipc_stream_server_receive(struct ipc_server *ipcs,
     }
     else
     {
+        ipc_server_requeue_client(ipcs, ipcsc);
+
         *p_buf_len = octets_to_read;
         return 0;
     }
@@ -804,10 +1276,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
                            void *buf, size_t *p_buf_len,
                            struct ipc_server_client **p_ipcsc)
 {
-    fd_set                    my_set;
     struct ipc_server_client *client;
-    struct ipc_server_client *next_client;
-    int                       max_fd;
     int                       rc;
 
     if ((ipcs == NULL) || (buf == NULL) || (p_ipcsc == NULL) ||
@@ -822,9 +1291,12 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
 
         if (client->stream.pending == 0)
         {
-            rc = read_socket(client->stream.socket,
-                             &(client->stream.pending),
-                             sizeof(client->stream.pending));
+            /* The message is read explicitly, not via the queue */
+            ipc_server_unset_ready(ipcs, client);
+
+            do {
+                rc = ipc_server_read_length(ipcs, client);
+            } while (rc == TE_RC(TE_IPC, TE_EAGAIN));
             if (rc != 0)
             {
                 if (rc != TE_RC(TE_IPC, TE_ECONNABORTED))
@@ -833,7 +1305,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
                 }
                 else
                 {
-                    ipc_server_close_client(client, ipcs->conn);
+                    ipc_server_close_client(ipcs, client);
                     return rc;
                 }
             }
@@ -845,50 +1317,52 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
     while (TRUE)
     {
         /* Data in the connection? */
-        LIST_FOREACH_SAFE(client, &ipcs->clients, links, next_client)
+        client = TAILQ_FIRST(&ipcs->stream.ready);
+        if (client != NULL)
         {
-            if (client->stream.is_ready)
+            ipc_server_unset_ready(ipcs, client);
+
+            /*
+             * Connection with data found. Check that no pending data
+             * for them exists.
+             */
+            if (client->stream.pending != 0)
             {
-                client->stream.is_ready = FALSE;
+                fprintf(stderr, "IPC(%d): Unexpected client "
+                        "connection state, pending=%u\n",
+                        (int)getpid(),
+                        (unsigned)client->stream.pending);
+                return TE_RC(TE_IPC, TE_ESYNCFAILED);
+            }
 
-                /*
-                 * Connection with data found. Check that no pending data
-                 * for them exists.
-                 */
-                if (client->stream.pending != 0)
+            /*
+             * Let's read the length of the message and call
+             * ipc_receive_rest_message.
+             */
+            rc = ipc_server_read_length(ipcs, client);
+            if (rc == TE_RC(TE_IPC, TE_EAGAIN))
+            {
+                /* Messages may be sent after switching request */
+                ipc_server_requeue_client(ipcs, client);
+                continue;
+            }
+            else if (rc != 0)
+            {
+                if (rc != TE_RC(TE_IPC, TE_ECONNABORTED))
                 {
-                    fprintf(stderr, "IPC(%d): Unexpected client "
-                            "connection state, pending=%u\n",
-                            (int)getpid(),
-                            (unsigned)client->stream.pending);
-                    return TE_RC(TE_IPC, TE_ESYNCFAILED);
+                    return rc;
                 }
-
-                /*
-                 * Let's read the length of the message and call
-                 * ipc_receive_rest_message.
-                 */
-                rc = read_socket(client->stream.socket,
-                                 &(client->stream.pending),
-                                 sizeof(client->stream.pending));
-                if (rc != 0)
+                else
                 {
-                    if (rc != TE_RC(TE_IPC, TE_ECONNABORTED))
-                    {
-                        return rc;
-                    }
-                    else
-                    {
-                        ipc_server_close_client(client, ipcs->conn);
-                        continue;
-                    }
+                    ipc_server_close_client(ipcs, client);
+                    continue;
                 }
+            }
 
-                *p_ipcsc = client;
+            *p_ipcsc = client;
 
-                return ipc_stream_server_receive(ipcs, buf, p_buf_len,
-                                                 client);
-            }
+            return ipc_stream_server_receive(ipcs, buf, p_buf_len,
+                                             client);
         }
 
         if (ipcs->is_ready)
@@ -918,13 +1392,26 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
             }
             else
             {
-                LIST_INSERT_HEAD(&ipcs->clients, client, links);
+                client->stream.server = ipcs;
+                rc = ipc_evloop_add(ipcs->stream.evloop,
+                                    client->stream.socket, IPC_EVLOOP_EDGE,
+                                    ipc_server_client_ready, client);
+                if (rc != 0)
+                {
+                    close(client->stream.socket);
+                    free(client);
+                }
+                else
+                {
+                    LIST_INSERT_HEAD(&ipcs->clients, client, links);
+                }
             }
 
             /*
              * We've accepted the connection but have not receive any
-             * message. So we have to repeat select.
+             * message. So we have to wait for events again.
              */
+            continue;
         }
 
         /*
@@ -932,18 +1419,9 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
          *  - client tries to establish connection
          *  - client sends data via established connection
          */
-        FD_ZERO(&my_set);
-        max_fd = ipc_get_server_fds(ipcs, &my_set);
-
-        /* Waiting forever */
-        rc = select(max_fd + 1, &my_set, NULL, NULL, NULL);
-        if (rc <= 0) /* Error? */
-        {
-            perror("select() error");
-            return TE_OS_RC(TE_IPC, errno);
-        }
-
-        (void)ipc_is_server_ready(ipcs, &my_set, max_fd);
+        rc = ipc_evloop_dispatch(ipcs->stream.evloop, -1, NULL);
+        if (rc != 0 && rc != TE_OS_RC(TE_IPC, EINTR))
+            return rc;
     }
     /* Unreachable */
 }
@@ -962,6 +1440,23 @@ ipc_stream_send_answer(struct ipc_server *ipcs,
         return TE_RC(TE_IPC, TE_EINVAL);
     }
 
+    if (ipcsc->stream.shm != NULL)
+    {
+        te_errno rc;
+
+        rc = ipc_shm_write(ipcsc->stream.shm, &len, sizeof(len));
+        if (rc == 0)
+            rc = ipc_shm_write(ipcsc->stream.shm, msg, msg_len);
+
+        /*
+         * Wakeup of the eventfd may be consumed while waiting for
+         * free space, so check for new messages from the client.
+         */
+        ipc_server_requeue_client(ipcs, ipcsc);
+
+        return rc;
+    }
+
     if ((msg_len + sizeof(len)) > IPC_TCP_SERVER_BUFFER_SIZE)
     {
         /* Message is too long to fit into the internal buffer */
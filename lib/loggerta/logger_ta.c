@@ -29,44 +29,64 @@
 #include "logger_ta.h"
 
 
-/*
- * Following macros are auxiliary for routine providing slow logging.
- */
-
-#define LGR_PUT_MD_LIST(_mdl, _narg, _addr, _len, _add_zero) \
-    do {                                                          \
-            md_list *tmp_list =                                   \
-                (struct md_list *)malloc(sizeof(struct md_list)); \
-            (_mdl).last->next = tmp_list;                         \
-            (_mdl).last = tmp_list;                               \
-            tmp_list->narg = (_narg);                             \
-            tmp_list->addr = (_addr);                             \
-            tmp_list->length = (_len);                            \
-            tmp_list->next = &(_mdl);                             \
-            tmp_list->add_zero = (_add_zero);                     \
-    } while (0)
-
-#define LGR_FREE_MD_LIST(_mdl) \
-    do {                                       \
-        while ((_mdl).next != &(_mdl))         \
-        {                                      \
-            (_mdl).last = (_mdl).next;         \
-            (_mdl).next = (_mdl).next->next;   \
-            free((_mdl).last);                 \
-        }                                      \
-        (_mdl).next = &(_mdl);                 \
-        (_mdl).last = &(_mdl);                 \
-    } while (0)
-
-typedef struct md_list {
-    struct md_list *next;
-    struct md_list *last;
-    uint32_t        narg;
-    void           *addr;
-    uint32_t        length;
-    te_bool         add_zero;
-} md_list;
+/** Size of the format string descriptors cache (power of 2) */
+#define TA_LOG_FMT_CACHE_SIZE   1024
+
+/** Maximum number of probes to find format string descriptor in cache */
+#define TA_LOG_FMT_CACHE_PROBES 8
+
+/** Kinds of format string conversions */
+typedef enum ta_log_fmt_kind {
+    TA_LOG_FMT_NONE = 0,    /**< Unsupported conversion (argument slot
+                                 is reserved, but not filled in) */
+    TA_LOG_FMT_INT,         /**< Integer (d, i, o, x, X, u, r) */
+    TA_LOG_FMT_CHAR,        /**< Character (c) */
+    TA_LOG_FMT_PTR,         /**< Pointer (p) */
+    TA_LOG_FMT_STR,         /**< String (s), copied to the log buffer */
+    TA_LOG_FMT_MEM,         /**< Memory dump (Tm), two argument slots:
+                                 address and length */
+} ta_log_fmt_kind;
+
+/** @name Format string conversion flags */
+#define TA_LOG_FMT_WIDTH_ARG    0x1 /**< Width is passed as argument */
+#define TA_LOG_FMT_PREC_ARG     0x2 /**< Precision is passed as argument */
+/*@}*/
+
+/** Format string conversion specification */
+typedef struct ta_log_fmt_conv {
+    uint8_t     kind;       /**< Conversion kind (ta_log_fmt_kind) */
+    uint8_t     flags;      /**< Conversion flags */
+    uint8_t     narg;       /**< Index of the argument slot */
+} ta_log_fmt_conv;
 
+/**
+ * Precompiled format string descriptor.
+ *
+ * Descriptors are cached by format string pointer, since format strings
+ * are expected to be located in static memory (they are anyway accessed
+ * when the message is passed to the Test Engine).
+ */
+typedef struct ta_log_fmt_desc {
+    const char     *fmt;        /**< Format string */
+    te_bool         too_many;   /**< Format string requires more than
+                                     TA_LOG_ARGS_MAX arguments */
+    unsigned int    n_convs;    /**< Number of conversions */
+    ta_log_fmt_conv convs[TA_LOG_ARGS_MAX + 1]; /**< Conversions */
+    size_t          clean_len;  /**< Length of the cleaned format */
+    char           *clean_fmt;  /**< Format string without width and
+                                     precision arguments or @c NULL */
+} ta_log_fmt_desc;
+
+/** Argument to be copied to the log buffer */
+typedef struct ta_log_copy_arg {
+    uint32_t        narg;       /**< Index of the argument slot */
+    const void     *addr;       /**< Data location */
+    uint32_t        length;     /**< Data length */
+    te_bool         add_zero;   /**< Append terminating zero byte */
+} ta_log_copy_arg;
+
+/** Cache of format string descriptors */
+static ta_log_fmt_desc *fmt_cache[TA_LOG_FMT_CACHE_SIZE];
 
 /** Local log buffer instance */
 struct lgr_rb log_buffer;
@@ -84,9 +104,356 @@ pthread_mutex_t ta_log_mutex;
 sem_t           ta_log_sem;
 #endif
 
+/** Per-thread ring buffers */
+static lgr_thread_rb thread_rbs[TA_LOG_THREADS_MAX];
+
+/** Number of initialized per-thread ring buffers (accessed atomically) */
+static unsigned int thread_rbs_num = 0;
+
+#if HAVE_PTHREAD_H
+/**
+ * Fake per-thread ring buffer which is assigned to threads using
+ * the shared ring buffer.
+ */
+static lgr_thread_rb no_thread_rb;
+
+/** Key of the current thread ring buffer */
+static pthread_key_t thread_rb_key;
+#endif
+
 static const char  *skip_flags = "#-+ 0";
 static const char  *skip_width = "*0123456789";
 
+/**
+ * Delete width and precision symbols from format string.
+ *
+ * @param  fmt          Initial format string.
+ * @param  clean_fmt    Output format string with deleted '*'
+ *                      symbols for width and precision.
+ *
+ * @return Length of the output format string.
+ */
+static size_t
+clear_fmt(const char *fmt, uint8_t *clean_fmt)
+{
+    int                 i;
+    size_t              outlen = 0;
+    te_bool             in_fmt = FALSE;
+
+    for (i = 0; fmt[i] != '\0'; i++)
+    {
+        if (!in_fmt)
+        {
+            in_fmt = (fmt[i] == '%');
+        }
+        else if (isalpha(fmt[i]) || fmt[i] == '%')
+        {
+            in_fmt = FALSE;
+        }
+        else if (fmt[i] == '*')
+        {
+            continue;
+        }
+        else if (fmt[i] == '.' && fmt[i + 1] == '*')
+        {
+            i++;
+            continue;
+        }
+        clean_fmt[outlen++] = fmt[i];
+    }
+
+    clean_fmt[outlen] = '\0';
+
+    return outlen;
+}
+
+/**
+ * Parse format string.
+ *
+ * @param fmt       Format string
+ * @param desc      Descriptor to fill in (cleaned format is not filled)
+ */
+static void
+ta_log_fmt_parse(const char *fmt, ta_log_fmt_desc *desc)
+{
+    const char     *p_str;
+    unsigned int    narg = 0;
+
+    memset(desc, 0, sizeof(*desc));
+    desc->fmt = fmt;
+
+    for (p_str = fmt; *p_str != '\0'; p_str++)
+    {
+        ta_log_fmt_conv conv = { TA_LOG_FMT_NONE, 0, narg };
+
+        if (*p_str != '%')
+            continue;
+
+        if (*++p_str == '%')
+            continue;
+
+        /* skip the flags field  */
+        for (; *p_str != '\0' && index(skip_flags, *p_str); ++p_str);
+
+        /* get width from argument */
+        if (*p_str == '*')
+        {
+            conv.flags |= TA_LOG_FMT_WIDTH_ARG;
+            ++p_str;
+        }
+
+        /* skip to possible '.', get following precision */
+        for (; *p_str != '\0' && index(skip_width, *p_str); ++p_str);
+        if (*p_str == '.')
+        {
+            ++p_str;
+
+            /* get precision from argument */
+            if (*p_str == '*')
+            {
+                conv.flags |= TA_LOG_FMT_PREC_ARG;
+                ++p_str;
+            }
+        }
+
+        /* skip to conversion char */
+        for (; *p_str != '\0' && index(skip_width, *p_str); ++p_str);
+
+        switch (*p_str)
+        {
+            case 'd':
+            case 'i':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'u':
+            case 'r':   /* TE-specific specifier for error codes */
+                conv.kind = TA_LOG_FMT_INT;
+                break;
+
+            case 'c':
+                conv.kind = TA_LOG_FMT_CHAR;
+                break;
+
+            case 'p':
+                conv.kind = TA_LOG_FMT_PTR;
+                break;
+
+            case 's':
+                conv.kind = TA_LOG_FMT_STR;
+                break;
+
+            case 'T':
+                if (p_str[1] != '\0' && *++p_str == 'm')
+                {
+                    conv.kind = TA_LOG_FMT_MEM;
+                    narg++;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        desc->convs[desc->n_convs++] = conv;
+        if ((++narg) > TA_LOG_ARGS_MAX)
+        {
+            desc->too_many = TRUE;
+            break;
+        }
+
+        if (*p_str == '\0')
+            break;
+    }
+}
+
+/**
+ * Get format string descriptor from the cache. A new descriptor is
+ * created and cached if the format string is met for the first time.
+ *
+ * @param fmt       Format string
+ * @param tmp       Location for the descriptor to be used if it cannot
+ *                  be cached
+ *
+ * @return Format string descriptor.
+ */
+static const ta_log_fmt_desc *
+ta_log_fmt_desc_get(const char *fmt, ta_log_fmt_desc *tmp)
+{
+    uintptr_t           hash;
+    unsigned int        i;
+    ta_log_fmt_desc    *desc;
+    ta_log_fmt_desc    *new_desc = NULL;
+
+    hash = ((uintptr_t)fmt >> 3) * 2654435761U;
+
+    for (i = 0; i < TA_LOG_FMT_CACHE_PROBES; i++)
+    {
+        ta_log_fmt_desc **slot;
+
+        slot = &fmt_cache[(hash + i) & (TA_LOG_FMT_CACHE_SIZE - 1)];
+        desc = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+
+        if (desc == NULL)
+        {
+            if (new_desc == NULL)
+            {
+                size_t len = strlen(fmt);
+
+                new_desc = malloc(sizeof(*new_desc) + len + 1);
+                if (new_desc == NULL)
+                    break;
+
+                ta_log_fmt_parse(fmt, new_desc);
+                new_desc->clean_fmt = (char *)(new_desc + 1);
+                new_desc->clean_len = clear_fmt(fmt,
+                                          (uint8_t *)new_desc->clean_fmt);
+            }
+
+            if (__atomic_compare_exchange_n(slot, &desc, new_desc, FALSE,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_ACQUIRE))
+            {
+                return new_desc;
+            }
+            /* Another thread has filled in the slot */
+        }
+
+        if (desc->fmt == fmt)
+        {
+            free(new_desc);
+            return desc;
+        }
+    }
+
+    free(new_desc);
+
+    ta_log_fmt_parse(fmt, tmp);
+    tmp->clean_fmt = NULL;
+
+    return tmp;
+}
+
+#if HAVE_PTHREAD_H
+/**
+ * Release the ring buffer of the exiting thread. Messages remaining in
+ * the ring buffer are passed to the Test Engine as usual.
+ *
+ * @param arg       Ring buffer of the thread
+ */
+static void
+ta_log_thread_rb_release(void *arg)
+{
+    lgr_thread_rb  *trb = (lgr_thread_rb *)arg;
+    ta_log_lock_key key;
+
+    if (trb == &no_thread_rb)
+        return;
+
+    if (ta_log_lock(&key) != 0)
+        return;
+    trb->in_use = FALSE;
+    (void)ta_log_unlock(&key);
+}
+
+/**
+ * Assign a ring buffer to the current thread.
+ *
+ * @return Ring buffer or @c NULL if there is no free ring buffers.
+ */
+static lgr_thread_rb *
+ta_log_thread_rb_register(void)
+{
+    lgr_thread_rb  *trb = NULL;
+    ta_log_lock_key key;
+    unsigned int    i;
+
+    if (ta_log_lock(&key) != 0)
+        return NULL;
+
+    /*
+     * Reuse ring buffer of an exited thread when all its messages
+     * have been passed to the Test Engine.
+     */
+    for (i = 0; i < thread_rbs_num; i++)
+    {
+        if (!thread_rbs[i].in_use && LGR_RB_EMPTY(&thread_rbs[i].rb) &&
+            thread_rbs[i].reported ==
+                __atomic_load_n(&thread_rbs[i].dropped, __ATOMIC_RELAXED))
+        {
+            trb = &thread_rbs[i];
+            break;
+        }
+    }
+
+    if (trb == NULL && thread_rbs_num < TA_LOG_THREADS_MAX)
+    {
+        trb = &thread_rbs[thread_rbs_num];
+        if (lgr_rb_init(&trb->rb, LGR_THREAD_RB_EL) != 0)
+            trb = NULL;
+        else
+            __atomic_store_n(&thread_rbs_num, thread_rbs_num + 1,
+                             __ATOMIC_RELEASE);
+    }
+
+    if (trb != NULL)
+        trb->in_use = TRUE;
+
+    (void)ta_log_unlock(&key);
+
+    return trb;
+}
+#endif
+
+/* See the description in logger_ta_internal.h */
+struct lgr_rb *
+ta_log_rb_get(ta_log_lock_key *key)
+{
+#if HAVE_PTHREAD_H
+    lgr_thread_rb *trb = pthread_getspecific(thread_rb_key);
+
+    if (trb == NULL)
+    {
+        trb = ta_log_thread_rb_register();
+        if (trb == NULL)
+            trb = &no_thread_rb;
+        (void)pthread_setspecific(thread_rb_key, trb);
+    }
+
+    if (trb != &no_thread_rb)
+        return &trb->rb;
+#endif
+
+    /* Without threads support everything goes to the shared buffer */
+
+    if (ta_log_lock(key) != 0)
+        return NULL;
+
+    return &log_buffer;
+}
+
+/* See the description in logger_ta_internal.h */
+void
+ta_log_rb_put(struct lgr_rb *rb, te_bool commit, ta_log_lock_key *key)
+{
+    if (commit)
+    {
+        lgr_rb_commit(rb);
+    }
+    else
+    {
+        lgr_rb_rollback(rb);
+        if (rb != &log_buffer)
+        {
+            __atomic_add_fetch(&((lgr_thread_rb *)rb)->dropped, 1,
+                               __ATOMIC_RELAXED);
+        }
+    }
+
+    if (rb == &log_buffer)
+        (void)ta_log_unlock(key);
+}
+
 static te_errno
 ta_log_add_ptr_argument(struct lgr_rb *ring_buffer, uint32_t position,
                         const void *start, uint32_t length,
@@ -117,7 +484,7 @@ ta_log_dynamic_user_ts(te_log_ts_sec sec, te_log_ts_usec usec,
                        unsigned int level, const char *user, const char *msg)
 {
     const char *args[] = { user, msg };
-    struct lgr_rb lgr_rb_old;
+    struct lgr_rb *rb;
     lgr_mess_header *hdr_addr = NULL;
     lgr_mess_header header;
     ta_log_lock_key key;
@@ -127,38 +494,32 @@ ta_log_dynamic_user_ts(te_log_ts_sec sec, te_log_ts_usec usec,
 
     lgr_rb_init_header(&header, level, NULL, "%s", TRUE, sec, usec);
 
-    if (ta_log_lock(&key) != 0)
+    rb = ta_log_rb_get(&key);
+    if (rb == NULL)
         return;
 
-    lgr_rb_old = log_buffer;
-
-    res = lgr_rb_allocate_head(&log_buffer, TA_LOG_FORCE_NEW, &position);
+    res = lgr_rb_allocate_head(rb, TA_LOG_RB_FORCE_NEW(rb), &position);
     if (res == 0)
     {
-        log_buffer = lgr_rb_old;
-        (void)ta_log_unlock(&key);
-        goto resume;
+        ta_log_rb_put(rb, FALSE, &key);
+        return;
     }
 
-    hdr_addr = (struct lgr_mess_header *)(log_buffer.rb) + position;
+    hdr_addr = (struct lgr_mess_header *)(rb->rb) + position;
     lgr_rb_fill_allocated_header(hdr_addr, &header);
 
     for (i = 0; i < TE_ARRAY_LEN(args); i++)
     {
-        if (ta_log_add_ptr_argument(&log_buffer, position,
+        if (ta_log_add_ptr_argument(rb, position,
                                     args[i], strlen(args[i]) + 1,
                                     hdr_addr->args + i, FALSE) != 0)
         {
-            log_buffer = lgr_rb_old;
-            (void)ta_log_unlock(&key);
-            goto resume;
+            ta_log_rb_put(rb, FALSE, &key);
+            return;
         }
     }
 
-    (void)ta_log_unlock(&key);
-
-resume:
-    ;
+    ta_log_rb_put(rb, TRUE, &key);
 }
 
 /**
@@ -173,15 +534,15 @@ ta_log_message(const char *file, unsigned int line,
                unsigned int level, const char *entity, const char *user,
                const char *fmt, va_list ap)
 {
-    ta_log_lock_key     key;
-    uint32_t            position;
-    int                 res;
-    const char         *p_str;
-    md_list             cp_list = {&cp_list, &cp_list, 0, NULL, 0};
-    md_list            *tmp_list = NULL;
-    uint32_t            narg = 0;
-    struct lgr_rb       lgr_rb_old;
-    int                 precision;
+    ta_log_lock_key         key;
+    uint32_t                position;
+    int                     res;
+    const ta_log_fmt_desc  *desc;
+    ta_log_fmt_desc         tmp_desc;
+    ta_log_copy_arg         copies[TA_LOG_ARGS_MAX];
+    unsigned int            n_copies = 0;
+    unsigned int            i;
+    struct lgr_rb          *rb;
 
     lgr_mess_header header;
     lgr_mess_header *hdr_addr = NULL;
@@ -194,153 +555,108 @@ ta_log_message(const char *file, unsigned int line,
 
     lgr_rb_init_header(&header, level, (user != NULL) ? user : null_str,
                        (fmt != NULL) ? fmt : null_str, FALSE, sec, usec);
-    for (p_str = header.fmt; *p_str; p_str++)
-    {
-        if (*p_str != '%')
-            continue;
 
-        precision = -1;
-
-        if (*++p_str == '%')
-            continue;
+    desc = ta_log_fmt_desc_get(header.fmt, &tmp_desc);
+    if (desc->too_many)
+        return;
 
-        /* skip the flags field  */
-        for (; index(skip_flags, *p_str); ++p_str);
+    for (i = 0; i < desc->n_convs; i++)
+    {
+        const ta_log_fmt_conv  *conv = &desc->convs[i];
+        int                     precision = -1;
 
-        /* get width from argument */
-        if (*p_str == '*')
-        {
+        if (conv->flags & TA_LOG_FMT_WIDTH_ARG)
             va_arg(ap, int);
-            ++p_str;
-        }
-
-        /* skip to possible '.', get following precision */
-        for (; index(skip_width, *p_str); ++p_str);
-        if (*p_str == '.')
-        {
-            ++p_str;
-
-            /* get precision from argument */
-            if (*p_str == '*')
-            {
-                precision = va_arg(ap, int);
-                ++p_str;
-            }
-        }
-
-        /* skip to conversion char */
-        for (; index(skip_width, *p_str); ++p_str);
+        if (conv->flags & TA_LOG_FMT_PREC_ARG)
+            precision = va_arg(ap, int);
 
-        switch (*p_str)
+        switch (conv->kind)
         {
-            case 'd':
-            case 'i':
-            case 'o':
-            case 'x':
-            case 'X':
-            case 'u':
-            case 'c':
-            case 'r':   /* TE-specific specifier for error codes */
+            case TA_LOG_FMT_INT:
+            case TA_LOG_FMT_CHAR:
             {
                 int tmp = va_arg(ap, int);
 
-                LGR_SET_ARG(header, narg, tmp);
+                LGR_SET_ARG(header, conv->narg, tmp);
                 break;
             }
 
-            case 'p':
+            case TA_LOG_FMT_PTR:
             {
                 void *tmp = va_arg(ap, void *);
 
-                LGR_SET_ARG(header, narg, (ta_log_arg)tmp);
+                LGR_SET_ARG(header, conv->narg, (ta_log_arg)tmp);
                 break;
             }
 
-            case 's':
+            case TA_LOG_FMT_STR:
             {
-                size_t  length;
-                char   *addr = va_arg(ap, char *);
+                ta_log_copy_arg    *copy = &copies[n_copies++];
+                const char         *addr = va_arg(ap, char *);
 
                 if (addr == NULL)
                     addr = null_str;
 
+                copy->narg = conv->narg;
+                copy->addr = addr;
                 if (precision >= 0)
                 {
-                    length = precision + 1;
-                    cp_list.length += length;
-                    LGR_PUT_MD_LIST(cp_list, narg, addr, length, TRUE);
+                    copy->length = strnlen(addr, precision) + 1;
+                    copy->add_zero = TRUE;
                 }
                 else
                 {
-                    length = strlen(addr) + 1;
-                    cp_list.length += length;
-                    LGR_PUT_MD_LIST(cp_list, narg, addr, length, FALSE);
+                    copy->length = strlen(addr) + 1;
+                    copy->add_zero = FALSE;
                 }
                 break;
             }
 
-            case 'T':
-                if ((*++p_str != 0) && (*p_str == 'm'))
-                {
-                    uint8_t    *addr;
-                    size_t      length;
-
-                    addr = va_arg(ap, uint8_t *);
-                    length = va_arg(ap, size_t);
-
-                    cp_list.length += length;
-                    LGR_PUT_MD_LIST(cp_list, narg, addr, length, FALSE);
-                    if ((++narg) > TA_LOG_ARGS_MAX)
-                        goto resume;
-                    LGR_SET_ARG(header, narg, length);
-                }
+            case TA_LOG_FMT_MEM:
+            {
+                ta_log_copy_arg    *copy = &copies[n_copies++];
+                size_t              length;
+
+                copy->narg = conv->narg;
+                copy->addr = va_arg(ap, uint8_t *);
+                length = va_arg(ap, size_t);
+                copy->length = length;
+                copy->add_zero = FALSE;
+                LGR_SET_ARG(header, conv->narg + 1, length);
                 break;
+            }
 
             default:
                 break;
         }
-
-        if ((++narg) > TA_LOG_ARGS_MAX)
-            goto resume;
     }
 
-    UNUSED(precision);
-
-    if (ta_log_lock(&key) != 0)
+    rb = ta_log_rb_get(&key);
+    if (rb == NULL)
         return;
 
-    lgr_rb_old = log_buffer;
-
-    res = lgr_rb_allocate_head(&log_buffer, TA_LOG_FORCE_NEW, &position);
+    res = lgr_rb_allocate_head(rb, TA_LOG_RB_FORCE_NEW(rb), &position);
     if (res == 0)
     {
-        log_buffer = lgr_rb_old;
-        (void)ta_log_unlock(&key);
-        goto resume;
+        ta_log_rb_put(rb, FALSE, &key);
+        return;
     }
 
-    hdr_addr = (struct lgr_mess_header *)(log_buffer.rb) + position;
+    hdr_addr = (struct lgr_mess_header *)(rb->rb) + position;
     lgr_rb_fill_allocated_header(hdr_addr, &header);
 
-    tmp_list = cp_list.next;
-    while (tmp_list != &cp_list)
+    for (i = 0; i < n_copies; i++)
     {
-        if (ta_log_add_ptr_argument(&log_buffer, position,
-                                    tmp_list->addr, tmp_list->length,
-                                    hdr_addr->args + tmp_list->narg,
-                                    tmp_list->add_zero) != 0)
+        if (ta_log_add_ptr_argument(rb, position,
+                                    copies[i].addr, copies[i].length,
+                                    hdr_addr->args + copies[i].narg,
+                                    copies[i].add_zero) != 0)
         {
-            log_buffer = lgr_rb_old;
-            (void)ta_log_unlock(&key);
-            goto resume;
+            ta_log_rb_put(rb, FALSE, &key);
+            return;
         }
-
-        tmp_list = tmp_list->next;
     }
-    (void)ta_log_unlock(&key);
-
-resume:
-    LGR_FREE_MD_LIST(cp_list);
+    ta_log_rb_put(rb, TRUE, &key);
 }
 
 
@@ -362,96 +678,131 @@ log_nfl_hton(te_log_nfl val)
 }
 
 /**
- * Delete width and precision symbols from format string.
+ * Get the ring buffer with the oldest message.
  *
- * @param  fmt          Initial format string.
- * @param  clean_fmt    Output format string with deleted '*'
- *                      symbols for width and precision.
- *
- * @return Length of the output format string.
+ * @return Ring buffer or @c NULL if all ring buffers are empty.
  */
-static size_t
-clear_fmt(const char *fmt, uint8_t *clean_fmt)
+static struct lgr_rb *
+log_get_next_rb(void)
 {
-    int                 i;
-    size_t              outlen = 0;
-    te_bool             in_fmt = FALSE;
+    struct lgr_rb  *next = NULL;
+    uint32_t        next_seq = 0;
+    unsigned int    num = __atomic_load_n(&thread_rbs_num,
+                                          __ATOMIC_ACQUIRE);
+    unsigned int    i;
 
-    for (i = 0; fmt[i] != '\0'; i++)
+    if (!LGR_RB_EMPTY(&log_buffer))
     {
-        if (!in_fmt)
-        {
-            in_fmt = (fmt[i] == '%');
-        }
-        else if (isalpha(fmt[i]) || fmt[i] == '%')
-        {
-            in_fmt = FALSE;
-        }
-        else if (fmt[i] == '*')
-        {
+        next = &log_buffer;
+        next_seq = LGR_GET_SEQUENCE_FIELD(next, next->head);
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        struct lgr_rb  *rb = &thread_rbs[i].rb;
+        uint32_t        seq;
+
+        if (LGR_RB_EMPTY(rb))
             continue;
-        }
-        else if (fmt[i] == '.' && fmt[i + 1] == '*')
+
+        seq = LGR_GET_SEQUENCE_FIELD(rb, rb->head);
+        if (next == NULL || (int32_t)(seq - next_seq) < 0)
         {
-            i++;
-            continue;
+            next = rb;
+            next_seq = seq;
         }
-        clean_fmt[outlen++] = fmt[i];
     }
 
-    clean_fmt[outlen] = '\0';
+    return next;
+}
 
-    return outlen;
+/**
+ * Report messages dropped because of per-thread ring buffers overflow.
+ */
+static void
+log_report_dropped(void)
+{
+    unsigned int    num = __atomic_load_n(&thread_rbs_num,
+                                          __ATOMIC_ACQUIRE);
+    unsigned int    i;
+
+    for (i = 0; i < num; i++)
+    {
+        lgr_thread_rb  *trb = &thread_rbs[i];
+        uint32_t        dropped = __atomic_load_n(&trb->dropped,
+                                                  __ATOMIC_RELAXED);
+
+        if (dropped == trb->reported)
+            continue;
+
+        TE_LOG(TE_LL_WARN, NULL, "Logger",
+               "Log buffer of thread #%u is overfilled, %u messages "
+               "are dropped", i, dropped - trb->reported);
+        trb->reported = dropped;
+    }
 }
 
 /**
  * Get message from log buffer.
  * On success the processed message will be removed from log buffer.
  *
+ * @param rb        Ring buffer to get message from
+ * @param length    Length of the buffer
+ * @param buffer    Buffer for the message
+ *
  * @return  Length of processed message.
  */
 static uint32_t
-log_get_message(uint32_t length, uint8_t *buffer)
+log_get_message(struct lgr_rb *rb, uint32_t length, uint8_t *buffer)
 {
     uint32_t            argn = 0;
+    uint32_t            arg_base;
     const char         *fs;
+    const ta_log_fmt_desc *desc;
+    ta_log_fmt_desc     tmp_desc;
+    unsigned int        i;
     uint32_t            mess_length = 0;
     uint32_t            tmp_length;
     ta_log_lock_key     key;
     uint8_t            *tmp_buf;
     lgr_mess_header     header;
-    uint8_t            *ring_last = log_buffer.rb + LGR_TOTAL_RB_BYTES;
+    uint8_t            *ring_last = rb->rb + rb->size * LGR_RB_ELEMENT_LEN;
+    te_bool             shared = (rb == &log_buffer);
 
     if (length < LGR_RB_ELEMENT_LEN)
         return 0;
 
-    if (ta_log_lock(&key) != 0)
+    /*
+     * Only the shared ring buffer may be accessed by several producers
+     * and its oldest message may be removed by a producer.
+     */
+    if (shared && ta_log_lock(&key) != 0)
         return 0;
 
-    if (LGR_RB_UNUSED(&log_buffer) == LGR_TOTAL_RB_EL)
+    if (LGR_RB_EMPTY(rb))
     {
-        (void)ta_log_unlock(&key);
+        if (shared)
+            (void)ta_log_unlock(&key);
         return 0;
     }
 
-    LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 1);
-    if (ta_log_unlock(&key) != 0)
+    LGR_SET_MARK_FIELD(rb, rb->head, 1);
+    if (shared && ta_log_unlock(&key) != 0)
     {
-        LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);
+        LGR_SET_MARK_FIELD(rb, rb->head, 0);
         return 0;
     }
 
     tmp_buf = buffer;
 
-    lgr_rb_get_elements(&log_buffer, LGR_RB_HEAD(&log_buffer),
-                        1, (uint8_t *)&header);
+    lgr_rb_get_elements(rb, LGR_RB_HEAD(rb), 1, (uint8_t *)&header);
 
 
 #define LGR_CHECK_LENGTH(_field_length) \
     do {                                                            \
         if (mess_length + (_field_length) > length)                 \
         {                                                           \
-            LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);    \
+            LGR_SET_MARK_FIELD(rb, rb->head, 0);                    \
             return 0;                                               \
         }                                                           \
         mess_length += (_field_length);                             \
@@ -500,45 +851,36 @@ log_get_message(uint32_t length, uint8_t *buffer)
     tmp_buf += sizeof(te_log_nfl);
     memcpy(tmp_buf, fs, tmp_length);
     tmp_buf += tmp_length;
+    arg_base = argn;
 
     /* Write format string and corresponding NFL */
-    fs = header.fmt;
-    tmp_length = strlen(fs);
-    LGR_CHECK_LENGTH(sizeof(te_log_nfl) + tmp_length);
-    tmp_buf += sizeof(te_log_nfl);
-    tmp_length = clear_fmt(fs, tmp_buf);
-    ((te_log_nfl *)tmp_buf)[-1] = log_nfl_hton(tmp_length);
+    desc = ta_log_fmt_desc_get(header.fmt, &tmp_desc);
+    if (desc->clean_fmt != NULL)
+    {
+        tmp_length = desc->clean_len;
+        LGR_CHECK_LENGTH(sizeof(te_log_nfl) + tmp_length);
+        *((te_log_nfl *)tmp_buf) = log_nfl_hton(tmp_length);
+        tmp_buf += sizeof(te_log_nfl);
+        memcpy(tmp_buf, desc->clean_fmt, tmp_length);
+    }
+    else
+    {
+        tmp_length = strlen(header.fmt);
+        LGR_CHECK_LENGTH(sizeof(te_log_nfl) + tmp_length);
+        tmp_buf += sizeof(te_log_nfl);
+        tmp_length = clear_fmt(header.fmt, tmp_buf);
+        ((te_log_nfl *)tmp_buf)[-1] = log_nfl_hton(tmp_length);
+    }
     tmp_buf += tmp_length;
 
-    /* Parse format string */
-    for (; *fs; fs++)
+    /* Write arguments as described by the format string */
+    for (i = 0; i < desc->n_convs; i++)
     {
-        if (*fs != '%')
-            continue;
-
-        if (*++fs == '%') /* double %*/
-            continue;
-
-        /* skip the flags field  */
-        for (; index(skip_flags, *fs); ++fs);
-
-        /* skip to possible '.', get following precision */
-        for (; index(skip_width, *fs); ++fs);
-        if (*fs == '.')
-            ++fs;
-
-        /* skip to conversion char */
-        for (; index(skip_width, *fs); ++fs);
+        argn = arg_base + desc->convs[i].narg;
 
-        switch (*fs)
+        switch (desc->convs[i].kind)
         {
-            case 'd':
-            case 'i':
-            case 'o':
-            case 'x':
-            case 'X':
-            case 'u':
-            case 'r':   /* TE-specific specifier for error codes */
+            case TA_LOG_FMT_INT:
             {
                 int32_t val;
 
@@ -551,7 +893,7 @@ log_get_message(uint32_t length, uint8_t *buffer)
                 break;
             }
 
-            case 'p':
+            case TA_LOG_FMT_PTR:
             {
                 void       *val;
                 uint32_t    tmp;
@@ -584,7 +926,7 @@ log_get_message(uint32_t length, uint8_t *buffer)
                 break;
             }
 
-            case 'c':
+            case TA_LOG_FMT_CHAR:
                 LGR_CHECK_LENGTH(sizeof(te_log_nfl) + sizeof(char));
                 *((te_log_nfl *)tmp_buf) = log_nfl_hton(sizeof(char));
                 tmp_buf += sizeof(te_log_nfl);
@@ -592,7 +934,7 @@ log_get_message(uint32_t length, uint8_t *buffer)
                 tmp_buf++;
                 break;
 
-            case 's':
+            case TA_LOG_FMT_STR:
             {
                 te_log_nfl *arglen_location;
                 char       *arg_str = (char *)LGR_GET_ARG(header, argn++);
@@ -612,47 +954,46 @@ log_get_message(uint32_t length, uint8_t *buffer)
                     tmp_buf++; arg_str++; tmp_length++;
 
                     if ((uint8_t *)arg_str == ring_last)
-                        arg_str = (char *)log_buffer.rb;
+                        arg_str = (char *)rb->rb;
                 } while (*arg_str != '\0');
 
                 *arglen_location = log_nfl_hton(tmp_length);
                 break;
             }
 
-            case 'T': /* %Tm - args order: dumped memory address, length */
-                if ((*++fs != 0) && (*fs == 'm'))
+            case TA_LOG_FMT_MEM: /* args order: address, length */
+            {
+                uint8_t *mem_addr;
+
+                mem_addr = (uint8_t *)LGR_GET_ARG(header, argn++);
+                tmp_length = LGR_GET_ARG(header, argn++);
+
+                LGR_CHECK_LENGTH(sizeof(te_log_nfl) + tmp_length);
+
+                *((te_log_nfl *)tmp_buf) = log_nfl_hton(tmp_length);
+                tmp_buf += sizeof(te_log_nfl);
+
+                if (tmp_length == 0)
+                    break;
+
+                if ((mem_addr + tmp_length) > ring_last)
+                {
+                    uint32_t piece1, piece2;
+
+                    piece1 = (uint32_t)(ring_last - mem_addr);
+                    piece2 = tmp_length - piece1;
+                    memcpy(tmp_buf, mem_addr, piece1);
+                    tmp_buf += piece1;
+                    memcpy(tmp_buf, rb->rb, piece2);
+                    tmp_buf += piece2;
+                }
+                else
                 {
-                    uint8_t *mem_addr;
-
-                    mem_addr = (uint8_t *)LGR_GET_ARG(header, argn++);
-                    tmp_length = LGR_GET_ARG(header, argn++);
-
-                    LGR_CHECK_LENGTH(sizeof(te_log_nfl) + tmp_length);
-
-                    *((te_log_nfl *)tmp_buf) = log_nfl_hton(tmp_length);
-                    tmp_buf += sizeof(te_log_nfl);
-
-                    if (tmp_length == 0)
-                        break;
-
-                    if ((mem_addr + tmp_length) > ring_last)
-                    {
-                        uint32_t piece1, piece2;
-
-                        piece1 = (uint32_t)(ring_last - mem_addr);
-                        piece2 = tmp_length - piece1;
-                        memcpy(tmp_buf, mem_addr, piece1);
-                        tmp_buf += piece1;
-                        memcpy(tmp_buf, log_buffer.rb, piece2);
-                        tmp_buf += piece2;
-                    }
-                    else
-                    {
-                        memcpy(tmp_buf, mem_addr, tmp_length);
-                        tmp_buf += tmp_length;
-                    }
+                    memcpy(tmp_buf, mem_addr, tmp_length);
+                    tmp_buf += tmp_length;
                 }
                 break;
+            }
 
             default:
                 break;
@@ -664,15 +1005,16 @@ log_get_message(uint32_t length, uint8_t *buffer)
 
 #undef LGR_CHECK_LENGTH
 
-    if (ta_log_lock(&key) != 0)
+    if (shared && ta_log_lock(&key) != 0)
     {
         /* TODO: Is it safe to do it without lock? */
-        LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);
+        LGR_SET_MARK_FIELD(rb, rb->head, 0);
         return 0;
     }
-    LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);
-    lgr_rb_remove_oldest(&log_buffer);
-    (void)ta_log_unlock(&key);
+    LGR_SET_MARK_FIELD(rb, rb->head, 0);
+    lgr_rb_remove_oldest(rb);
+    if (shared)
+        (void)ta_log_unlock(&key);
 
     return mess_length;
 }
@@ -698,7 +1040,12 @@ ta_log_init(const char *lgr_entity)
     if (ta_log_lock_init() != 0)
         return -1;
 
-    if (lgr_rb_init(&log_buffer) != 0)
+#if HAVE_PTHREAD_H
+    if (pthread_key_create(&thread_rb_key, ta_log_thread_rb_release) != 0)
+        return -1;
+#endif
+
+    if (lgr_rb_init(&log_buffer, LGR_TOTAL_RB_EL) != 0)
         return -1;
 
     te_log_init(lgr_entity, ta_log_message);
@@ -740,20 +1087,22 @@ ta_log_get(uint32_t buf_length, uint8_t *transfer_buf)
     uint32_t log_length = 0;
     uint32_t mess_length, rest_length;
     uint8_t *tmp_buf = transfer_buf;
+    struct lgr_rb *rb;
 
 
     if ((buf_length <= 0) || (transfer_buf == NULL))
         goto ret;
 
     do {
-        if (LGR_RB_UNUSED(&log_buffer) == LGR_TOTAL_RB_EL)
+        rb = log_get_next_rb();
+        if (rb == NULL)
             goto ret;
 
         rest_length = buf_length - log_length;
         if (rest_length == 0)
             goto ret;
 
-        mess_length = log_get_message(rest_length, tmp_buf);
+        mess_length = log_get_message(rb, rest_length, tmp_buf);
         if (mess_length == 0)
             goto ret;
 
@@ -763,5 +1112,13 @@ ta_log_get(uint32_t buf_length, uint8_t *transfer_buf)
     } while (1);
 
 ret:
+    log_report_dropped();
     return log_length;
 }
+
+/* See the description in logger_ta.h */
+te_bool
+ta_log_pending(void)
+{
+    return log_get_next_rb() != NULL;
+}
@@ -24,6 +24,7 @@
 #ifndef __TE_LOGGER_TA_H__
 #define __TE_LOGGER_TA_H__
 
+#include "te_defs.h"
 #include "te_stdint.h"
 #include "te_errno.h"
 
@@ -83,6 +84,14 @@ extern void ta_log_dynamic_user_ts(te_log_ts_sec sec, te_log_ts_usec usec,
  */
 extern uint32_t ta_log_get(uint32_t buf_length, uint8_t *transfer_buf);
 
+/**
+ * Check whether there are messages in the Test Agent local log buffer
+ * which have not been passed to the Test Engine yet.
+ *
+ * @return @c TRUE if there are pending messages
+ */
+extern te_bool ta_log_pending(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
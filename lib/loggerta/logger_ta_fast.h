@@ -188,23 +188,20 @@ ta_log_message_fast(unsigned int level, const char *user, const char *fmt,
     int                 res;
 
     struct lgr_mess_header *msg;
-    struct lgr_rb lgr_rb_old;
+    struct lgr_rb *rb;
 
-    if (ta_log_lock(&key) != 0)
+    rb = ta_log_rb_get(&key);
+    if (rb == NULL)
         return;
 
-    lgr_rb_old = log_buffer;
-
-    res = lgr_rb_allocate_head(&log_buffer, TA_LOG_FORCE_NEW, &position);
+    res = lgr_rb_allocate_head(rb, TA_LOG_RB_FORCE_NEW(rb), &position);
     if (res == 0)
     {
-        log_buffer = lgr_rb_old;
-        (void)ta_log_unlock(&key);
+        ta_log_rb_put(rb, FALSE, &key);
         return;
     }
 
-    msg = (struct lgr_mess_header *)LGR_GET_MESSAGE_ARRAY(&log_buffer,
-                                                          position);
+    msg = (struct lgr_mess_header *)LGR_GET_MESSAGE_ARRAY(rb, position);
 
     ta_log_timestamp(&msg->sec, &msg->usec);
     msg->level  = level;
@@ -264,7 +261,7 @@ ta_log_message_fast(unsigned int level, const char *user, const char *fmt,
         }
     }
 
-    (void)ta_log_unlock(&key);
+    ta_log_rb_put(rb, TRUE, &key);
 }
 
 #ifdef __cplusplus
@@ -81,17 +81,36 @@ extern "C" {
 /* Total of the ring buffer bytes */
 #define LGR_TOTAL_RB_BYTES (uint32_t)(LGR_TOTAL_RB_EL * LGR_RB_ELEMENT_LEN)
 
+/**
+ * Maximum number of threads which have their own ring buffers.
+ * Messages of the rest threads are put into the shared ring buffer.
+ */
+#define TA_LOG_THREADS_MAX      32
+
+/* Total of the per-thread ring buffer elements */
+#define LGR_THREAD_RB_EL        (LGR_TOTAL_RB_EL / 16)
+
 /** This macro corrects head/tail value on ring buffer physical border */
-#define LGR_RB_CORRECTION(_val, _res) \
+#define LGR_RB_CORRECTION(_rb, _val, _res) \
     do {                                        \
-        if ((_val) < LGR_TOTAL_RB_EL)           \
+        if ((_val) < (_rb)->size)               \
             (_res) = (_val);                    \
         else                                    \
-            (_res) = (_val) - LGR_TOTAL_RB_EL;  \
+            (_res) = (_val) - (_rb)->size;      \
     } while (0)
 
-/** Get ring buffer unused elements */
-#define LGR_RB_UNUSED(_rb)  ((_rb)->unused)
+/**
+ * Get ring buffer unused elements.
+ *
+ * Unused elements counter is increased by the consumer only and
+ * decreased by the producer only, so acquire semantics is required to
+ * see the data published by the other side.
+ */
+#define LGR_RB_UNUSED(_rb) \
+    __atomic_load_n(&(_rb)->unused, __ATOMIC_ACQUIRE)
+
+/** Check whether the ring buffer has no messages */
+#define LGR_RB_EMPTY(_rb)   (LGR_RB_UNUSED(_rb) == (_rb)->size)
 
 /** Get ring buffer head element */
 #define LGR_RB_HEAD(_rb)    ((_rb)->head)
@@ -186,37 +205,90 @@ ta_log_timestamp(te_log_ts_sec *sec, te_log_ts_usec *usec)
 /**
  * The main ring buffer structure.
  * Element of the ring buffer is multiple to the struct lgr_mess_header
+ *
+ * A ring buffer is safe to be used by one producer and one consumer
+ * concurrently: the producer owns @a tail and @a reserved, the consumer
+ * owns @a head, and a message becomes visible to the consumer only when
+ * it is completely written and committed with lgr_rb_commit().
  */
 struct lgr_rb {
-    uint32_t head;    /**< Head ring buffer element number */
-    uint32_t tail;    /**< Tail ring buffer element number */
-    uint32_t unused;  /**< Number of unused ring buffer elements */
-    uint8_t *rb;      /**< Pointer to the ring buffer location */
+    uint32_t head;     /**< Head ring buffer element number */
+    uint32_t tail;     /**< Tail ring buffer element number */
+    uint32_t unused;   /**< Number of unused ring buffer elements
+                            (accessed atomically) */
+    uint32_t reserved; /**< Number of elements allocated for
+                            the message which is not committed yet */
+    uint32_t size;     /**< Total number of ring buffer elements */
+    uint8_t *rb;       /**< Pointer to the ring buffer location */
 };
 
+/** Per-thread ring buffer */
+typedef struct lgr_thread_rb {
+    struct lgr_rb   rb;         /**< Ring buffer */
+    te_bool         in_use;     /**< Ring buffer is owned by a thread */
+    uint32_t        dropped;    /**< Number of messages dropped because
+                                     of the lack of space (accessed
+                                     atomically) */
+    uint32_t        reported;   /**< Number of dropped messages already
+                                     reported to the Test Engine */
+} lgr_thread_rb;
+
 extern struct lgr_rb log_buffer;
 extern uint32_t      log_sequence;
 
+/**
+ * Force flag to allocate message in the ring buffer.
+ * The oldest message may be removed by the producer from the shared
+ * ring buffer only, since per-thread ring buffers are not locked.
+ */
+#define TA_LOG_RB_FORCE_NEW(_rb) \
+    (((_rb) == &log_buffer) ? TA_LOG_FORCE_NEW : 0)
+
+/**
+ * Get the ring buffer to register a message of the current thread.
+ * If the thread has no own ring buffer, the shared ring buffer is
+ * returned locked.
+ *
+ * @param key       Lock key
+ *
+ * @return Ring buffer or @c NULL in the case of failure.
+ */
+extern struct lgr_rb *ta_log_rb_get(ta_log_lock_key *key);
+
+/**
+ * Finish registration of a message in the ring buffer obtained by
+ * ta_log_rb_get().
+ *
+ * @param rb        Ring buffer
+ * @param commit    If @c TRUE, the message is made visible to the
+ *                  consumer, otherwise it is dropped
+ * @param key       Lock key
+ */
+extern void ta_log_rb_put(struct lgr_rb *rb, te_bool commit,
+                          ta_log_lock_key *key);
+
 
 /**
  * Initialize ring buffer.
  *
  * @param ring_buffer Ring buffer location.
+ * @param size        Number of ring buffer elements.
  *
  * @retval  0 Success.
  * @retval -1 Failure.
  */
 static inline int
-lgr_rb_init(struct lgr_rb *ring_buffer)
+lgr_rb_init(struct lgr_rb *ring_buffer, uint32_t size)
 {
     memset(ring_buffer, 0, sizeof(struct lgr_rb));
 
     ring_buffer->rb =
-        (uint8_t *)calloc(1, LGR_TOTAL_RB_BYTES * sizeof(uint8_t));
+        (uint8_t *)calloc(size, LGR_RB_ELEMENT_LEN * sizeof(uint8_t));
     if (ring_buffer->rb == NULL)
         return -1;
 
-    ring_buffer->unused = LGR_TOTAL_RB_EL;
+    ring_buffer->size = size;
+    ring_buffer->unused = size;
     ring_buffer->head = ring_buffer->tail = 0;
 
     return 0;
@@ -267,17 +339,57 @@ lgr_rb_remove_oldest(struct lgr_rb *ring_buffer)
     uint32_t mess_len;
     uint32_t head;
 
-    if (ring_buffer->unused == LGR_TOTAL_RB_EL)
-        return LGR_TOTAL_RB_EL;
+    if (LGR_RB_EMPTY(ring_buffer))
+        return ring_buffer->size;
 
     head = LGR_RB_HEAD(ring_buffer);
     mess_len = LGR_GET_ELEMENTS_FIELD(ring_buffer, head);
     head += mess_len;
 
-    LGR_RB_CORRECTION(head, LGR_RB_HEAD(ring_buffer));
+    LGR_RB_CORRECTION(ring_buffer, head, LGR_RB_HEAD(ring_buffer));
+
+    return __atomic_add_fetch(&ring_buffer->unused, mess_len,
+                              __ATOMIC_RELEASE);
+}
 
-    ring_buffer->unused += mess_len;
-    return ring_buffer->unused;
+/**
+ * Get number of ring buffer elements which may be allocated
+ * by the producer.
+ *
+ * @param ring_buffer Ring buffer location.
+ *
+ * @return Number of free elements.
+ */
+static inline uint32_t
+lgr_rb_free(struct lgr_rb *ring_buffer)
+{
+    return LGR_RB_UNUSED(ring_buffer) - ring_buffer->reserved;
+}
+
+/**
+ * Make the message allocated in the ring buffer visible to the consumer.
+ *
+ * @param ring_buffer Ring buffer location.
+ */
+static inline void
+lgr_rb_commit(struct lgr_rb *ring_buffer)
+{
+    __atomic_sub_fetch(&ring_buffer->unused, ring_buffer->reserved,
+                       __ATOMIC_RELEASE);
+    ring_buffer->reserved = 0;
+}
+
+/**
+ * Release the space allocated for the message which is not committed.
+ *
+ * @param ring_buffer Ring buffer location.
+ */
+static inline void
+lgr_rb_rollback(struct lgr_rb *ring_buffer)
+{
+    ring_buffer->tail = (ring_buffer->tail + ring_buffer->size -
+                         ring_buffer->reserved) % ring_buffer->size;
+    ring_buffer->reserved = 0;
 }
 
 
@@ -296,7 +408,7 @@ lgr_rb_allocate_space(struct lgr_rb *ring_buffer,
 {
     uint32_t tail;
 
-    if (ring_buffer->unused < nmbr)
+    if (lgr_rb_free(ring_buffer) < nmbr)
     {
         return 0;
     }
@@ -304,8 +416,8 @@ lgr_rb_allocate_space(struct lgr_rb *ring_buffer,
     tail = *position = ring_buffer->tail;
     tail += nmbr;
 
-    LGR_RB_CORRECTION(tail, ring_buffer->tail);
-    ring_buffer->unused -= nmbr;
+    LGR_RB_CORRECTION(ring_buffer, tail, ring_buffer->tail);
+    ring_buffer->reserved += nmbr;
 
     return nmbr;
 }
@@ -313,7 +425,8 @@ lgr_rb_allocate_space(struct lgr_rb *ring_buffer,
 /**
  * Allocate ring buffer space for head element of message.
  * If force flag is turn on and ring buffer does not have an unused space
- * the oldest message will be removed to allocate new one.
+ * the oldest message will be removed to allocate new one (the ring
+ * buffer consumer must be locked out in this case).
  *
  * @param ring_buffer Ring buffer location.
  * @param force       Remove oldest message if unused space is absent.
@@ -325,23 +438,24 @@ static inline uint32_t
 lgr_rb_allocate_head(struct lgr_rb *ring_buffer,
                      uint32_t force, uint32_t *position)
 {
-    log_sequence++;
+    uint32_t sequence = __atomic_add_fetch(&log_sequence, 1,
+                                           __ATOMIC_RELAXED);
 
-    if ((ring_buffer->unused == 0) &&
+    if ((lgr_rb_free(ring_buffer) == 0) &&
         ((force == 0) ||
          (LGR_GET_MARK_FIELD(ring_buffer, ring_buffer->head) == 1)))
     {
         return 0;
     }
 
-    if (ring_buffer->unused == 0)
+    if (lgr_rb_free(ring_buffer) == 0)
         lgr_rb_remove_oldest(ring_buffer);
 
     lgr_rb_allocate_space(ring_buffer, 1, position);
 
     LGR_SET_ELEMENTS_FIELD(ring_buffer, *position, 1);
     LGR_SET_MARK_FIELD(ring_buffer, *position, 0);
-    LGR_SET_SEQUENCE_FIELD(ring_buffer, *position, log_sequence);
+    LGR_SET_SEQUENCE_FIELD(ring_buffer, *position, sequence);
 
     return 1;
 }
@@ -415,7 +529,7 @@ lgr_rb_allocate_and_copy(struct lgr_rb *ring_buffer,
 
     *arg_addr = LGR_GET_MESSAGE_ARRAY(ring_buffer, start_pos);
 
-    if ((start_pos + need_elements) <= LGR_TOTAL_RB_EL)
+    if ((start_pos + need_elements) <= ring_buffer->size)
     {
         if (add_zero)
         {
@@ -432,7 +546,7 @@ lgr_rb_allocate_and_copy(struct lgr_rb *ring_buffer,
         uint32_t  length_aux;
         const uint8_t *start_aux = start;
 
-        length_aux = (LGR_TOTAL_RB_EL - start_pos) * LGR_RB_ELEMENT_LEN;
+        length_aux = (ring_buffer->size - start_pos) * LGR_RB_ELEMENT_LEN;
         memcpy(*arg_addr, start_aux, length_aux);
 
         start_aux += length_aux;
@@ -462,7 +576,7 @@ lgr_rb_get_elements(struct lgr_rb *ring_buffer, uint32_t position,
     length_aux = length * LGR_RB_ELEMENT_LEN;
     pos_aux += length;
 
-    if (pos_aux <= LGR_TOTAL_RB_EL)
+    if (pos_aux <= ring_buffer->size)
     {
         memcpy(destination, LGR_GET_MESSAGE_ARRAY(ring_buffer, position),
                length_aux);
@@ -471,7 +585,7 @@ lgr_rb_get_elements(struct lgr_rb *ring_buffer, uint32_t position,
     {
         uint8_t  *start_aux = LGR_GET_MESSAGE_ARRAY(ring_buffer, position);
 
-        length_aux = (LGR_TOTAL_RB_EL - position) * LGR_RB_ELEMENT_LEN;
+        length_aux = (ring_buffer->size - position) * LGR_RB_ELEMENT_LEN;
 
         memcpy(destination, start_aux, length_aux);
 
@@ -479,7 +593,7 @@ lgr_rb_get_elements(struct lgr_rb *ring_buffer, uint32_t position,
 
         destination += length_aux;
 
-        length_aux = (pos_aux - LGR_TOTAL_RB_EL) * LGR_RB_ELEMENT_LEN;
+        length_aux = (pos_aux - ring_buffer->size) * LGR_RB_ELEMENT_LEN;
 
         memcpy(destination, start_aux, length_aux);
    }
@@ -48,28 +48,70 @@
 #include "logger_ten_int.h"
 
 
-/** Maximum logger message length */
-#define LGR_TEN_MSG_BUF_INIT    0x1000
+/** Maximum length of the batch of messages sent to Logger at once */
+#define LGR_TEN_BATCH_MAX       0x8000
+
+/**
+ * Name of the environment variable which makes log messages to be
+ * sent synchronously from the thread which logs (if set to "yes").
+ */
+#define LGR_TEN_SYNC_ENV        "TE_LOGGER_TEN_SYNC"
 
 
-#ifdef HAVE_PTHREAD_H
-/** Mutual exclusion execution lock */
+/** Log message queued to be sent by the flusher thread */
+typedef struct lgr_ten_msg {
+    struct lgr_ten_msg *next;   /**< Next message */
+    size_t              len;    /**< Length of the message */
+    uint8_t             data[]; /**< Raw log message */
+} lgr_ten_msg;
+
+/** Lock to send messages synchronously and to close IPC client */
 static pthread_mutex_t  lgr_lock = PTHREAD_MUTEX_INITIALIZER;
-#endif
+
+/** Control of initialization of the library */
+static pthread_once_t   lgr_once = PTHREAD_ONCE_INIT;
+
+/** Key of per-thread logging output interface */
+static pthread_key_t    lgr_out_key;
 
 /**
  * Handle of Logger IPC client.
  *
- * @note It should be used under lgr_lock only.
+ * @note It is used by the flusher thread only if messages are sent
+ *       asynchronously and under lgr_lock otherwise.
  */
 static struct ipc_client *lgr_client = NULL;
 
+/** Are messages sent by the flusher thread? */
+static te_bool          lgr_async = FALSE;
+
 /**
- * Logging output interface.
- *
- * @note It should be used under lgr_lock only.
+ * Stack of queued messages (in reverse order). Messages are pushed
+ * by logging threads without locks and the whole stack is taken by
+ * the flusher thread at once.
  */
-static te_log_msg_raw_data lgr_out;
+static lgr_ten_msg     *lgr_queue = NULL;
+
+/** Number of messages pushed to the queue */
+static uint64_t         lgr_queued = 0;
+
+/** Flusher thread */
+static pthread_t        lgr_flusher;
+
+/** Lock protecting flusher state below */
+static pthread_mutex_t  lgr_flusher_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Condition to wake up the flusher thread */
+static pthread_cond_t   lgr_flusher_wakeup = PTHREAD_COND_INITIALIZER;
+
+/** Condition signalled when a portion of messages is sent */
+static pthread_cond_t   lgr_flusher_sent_cond = PTHREAD_COND_INITIALIZER;
+
+/** Number of messages sent (or dropped) by the flusher thread */
+static uint64_t         lgr_sent = 0;
+
+/** Flusher thread should terminate */
+static te_bool          lgr_flusher_stop = FALSE;
 
 
 /**
@@ -88,6 +130,356 @@ log_message_ipc(const void *msg, size_t len)
     }
 }
 
+/**
+ * Create Logger IPC client.
+ *
+ * @return Status code.
+ */
+static int
+lgr_client_open(void)
+{
+    char name[32];
+
+    if (snprintf(name, sizeof(name), "lgr_client_%u",
+                 (unsigned int)getpid()) >= (int)sizeof(name))
+    {
+        fprintf(stderr, "ERROR: Logger client name truncated");
+    }
+
+    return ipc_init_client(name, LOGGER_IPC, &lgr_client);
+}
+
+/**
+ * Log message via IPC in the context of the logging thread.
+ *
+ * @param msg       Message to be logged
+ * @param len       Length of the message to be logged
+ */
+static void
+log_message_sync(const void *msg, size_t len)
+{
+    pthread_mutex_lock(&lgr_lock);
+    /* Messages may be logged after closing of the client at exit */
+    if (lgr_client != NULL || lgr_client_open() == 0)
+        log_message_ipc(msg, len);
+    pthread_mutex_unlock(&lgr_lock);
+}
+
+/**
+ * Put log message to the queue of the flusher thread.
+ *
+ * @param msg       Message to be logged
+ * @param len       Length of the message to be logged
+ */
+static void
+log_message_queue(const void *msg, size_t len)
+{
+    lgr_ten_msg *item = malloc(sizeof(*item) + len);
+    lgr_ten_msg *head;
+
+    if (item == NULL)
+    {
+        fprintf(stderr, "Failed to allocate memory for log message\n");
+        return;
+    }
+    item->len = len;
+    memcpy(item->data, msg, len);
+
+    head = __atomic_load_n(&lgr_queue, __ATOMIC_RELAXED);
+    do {
+        item->next = head;
+    } while (!__atomic_compare_exchange_n(&lgr_queue, &head, item, TRUE,
+                                          __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED));
+    __atomic_add_fetch(&lgr_queued, 1, __ATOMIC_RELEASE);
+
+    /* The flusher may sleep only if the queue was empty */
+    if (head == NULL)
+    {
+        pthread_mutex_lock(&lgr_flusher_lock);
+        pthread_cond_signal(&lgr_flusher_wakeup);
+        pthread_mutex_unlock(&lgr_flusher_lock);
+    }
+}
+
+/**
+ * Release messages taken from the queue without sending.
+ *
+ * @param list      Messages to be released
+ *
+ * @return Number of released messages.
+ */
+static unsigned int
+lgr_flusher_drop(lgr_ten_msg *list)
+{
+    unsigned int    num;
+    lgr_ten_msg    *item;
+
+    for (num = 0; list != NULL; num++)
+    {
+        item = list;
+        list = item->next;
+        free(item);
+    }
+
+    return num;
+}
+
+/**
+ * Send messages taken from the queue packing them into batches.
+ *
+ * @param list      Messages in the order of logging
+ * @param batch     Buffer for the batch of LGR_TEN_BATCH_MAX length
+ *
+ * @return Number of processed messages.
+ */
+static unsigned int
+lgr_flusher_send(lgr_ten_msg *list, uint8_t *batch)
+{
+    size_t const    hdr_len = sizeof(te_log_nfl) + strlen(LGR_SRV_BATCH);
+    unsigned int    batched = 0;
+    unsigned int    num = 0;
+    size_t          len = hdr_len;
+    lgr_ten_msg    *item;
+    uint8_t        *p;
+
+    p = batch;
+    LGR_NFL_PUT(strlen(LGR_SRV_BATCH), p);
+    memcpy(p, LGR_SRV_BATCH, strlen(LGR_SRV_BATCH));
+
+    while (list != NULL)
+    {
+        item = list;
+        list = item->next;
+        num++;
+
+        if (len + sizeof(uint32_t) + item->len > LGR_TEN_BATCH_MAX)
+        {
+            if (batched > 0)
+            {
+                log_message_ipc(batch, len);
+                batched = 0;
+                len = hdr_len;
+            }
+
+            /* Too long message is sent as is */
+            if (len + sizeof(uint32_t) + item->len > LGR_TEN_BATCH_MAX)
+            {
+                log_message_ipc(item->data, item->len);
+                free(item);
+                continue;
+            }
+        }
+
+        LGR_32_TO_NET(item->len, batch + len);
+        memcpy(batch + len + sizeof(uint32_t), item->data, item->len);
+        len += sizeof(uint32_t) + item->len;
+        batched++;
+        free(item);
+
+        /* Batch of the only message is not required */
+        if (list == NULL && batched == 1)
+        {
+            log_message_ipc(batch + hdr_len + sizeof(uint32_t),
+                            len - hdr_len - sizeof(uint32_t));
+            batched = 0;
+        }
+    }
+
+    if (batched > 0)
+        log_message_ipc(batch, len);
+
+    return num;
+}
+
+/**
+ * Entry point of the flusher thread which sends queued messages
+ * to Logger.
+ *
+ * @param arg       Unused
+ *
+ * @return @c NULL
+ */
+static void *
+lgr_flusher_thread(void *arg)
+{
+    uint8_t        *batch = malloc(LGR_TEN_BATCH_MAX);
+    lgr_ten_msg    *list;
+    lgr_ten_msg    *reversed;
+    lgr_ten_msg    *item;
+    unsigned int    num;
+    te_bool         stop;
+
+    UNUSED(arg);
+
+    while (TRUE)
+    {
+        pthread_mutex_lock(&lgr_flusher_lock);
+        while (!lgr_flusher_stop &&
+               __atomic_load_n(&lgr_queue, __ATOMIC_ACQUIRE) == NULL)
+        {
+            pthread_cond_wait(&lgr_flusher_wakeup, &lgr_flusher_lock);
+        }
+        stop = lgr_flusher_stop;
+        pthread_mutex_unlock(&lgr_flusher_lock);
+
+        list = __atomic_exchange_n(&lgr_queue, NULL, __ATOMIC_ACQUIRE);
+
+        /* Restore the order of logging */
+        for (reversed = NULL; list != NULL; reversed = item)
+        {
+            item = list;
+            list = item->next;
+            item->next = reversed;
+        }
+
+        /*
+         * Logger may be not ready yet when the first message is logged,
+         * so connection is established by the first portion which
+         * may be sent. Messages are dropped until it succeeds.
+         */
+        if (lgr_client == NULL && lgr_client_open() != 0)
+        {
+            num = lgr_flusher_drop(reversed);
+        }
+        else if (batch != NULL)
+        {
+            num = lgr_flusher_send(reversed, batch);
+        }
+        else
+        {
+            for (num = 0; reversed != NULL; num++)
+            {
+                item = reversed;
+                reversed = item->next;
+                log_message_ipc(item->data, item->len);
+                free(item);
+            }
+        }
+
+        pthread_mutex_lock(&lgr_flusher_lock);
+        lgr_sent += num;
+        pthread_cond_broadcast(&lgr_flusher_sent_cond);
+        pthread_mutex_unlock(&lgr_flusher_lock);
+
+        if (stop && __atomic_load_n(&lgr_queue, __ATOMIC_ACQUIRE) == NULL)
+            break;
+    }
+
+    free(batch);
+
+    return NULL;
+}
+
+/**
+ * Child process cannot use the flusher thread of the parent,
+ * so messages are sent synchronously. Messages queued by the
+ * parent are sent by the parent.
+ *
+ * Connection of the parent cannot be shared since messages of the
+ * parent and the child would be mixed in it, so the child closes its
+ * copy (it does not affect the parent) and opens its own one.
+ */
+static void
+lgr_atfork_child(void)
+{
+    (void)ipc_close_client(lgr_client);
+    lgr_client = NULL;
+    lgr_async = FALSE;
+    te_log_message_tx = log_message_sync;
+    lgr_queue = NULL;
+    lgr_queued = lgr_sent = 0;
+    pthread_mutex_init(&lgr_lock, NULL);
+    pthread_mutex_init(&lgr_flusher_lock, NULL);
+    pthread_cond_init(&lgr_flusher_wakeup, NULL);
+    pthread_cond_init(&lgr_flusher_sent_cond, NULL);
+}
+
+/**
+ * Release per-thread logging output interface.
+ *
+ * @param ptr       Output interface
+ */
+static void
+lgr_out_free(void *ptr)
+{
+    te_log_msg_raw_data *out = ptr;
+
+    free(out->buf);
+    free(out->args);
+    free(out);
+}
+
+/**
+ * Get logging output interface of the current thread.
+ *
+ * @return Output interface or @c NULL.
+ */
+static te_log_msg_raw_data *
+lgr_out_get(void)
+{
+    te_log_msg_raw_data *out = pthread_getspecific(lgr_out_key);
+
+    if (out == NULL)
+    {
+        out = calloc(1, sizeof(*out));
+        if (out == NULL)
+            return NULL;
+
+        out->common = te_log_msg_out_raw;
+        out->buf = out->end = NULL;
+        out->args_max = 0;
+        out->args = NULL;
+
+        if (pthread_setspecific(lgr_out_key, out) != 0)
+        {
+            free(out);
+            return NULL;
+        }
+    }
+
+    return out;
+}
+
+/**
+ * Initialize the library state and start the flusher thread.
+ *
+ * IPC client is not created here: it is done by the first attempt to
+ * send a message and retried by the next ones if it fails, so a
+ * failure to connect to Logger does not disable logging forever.
+ */
+static void
+lgr_init(void)
+{
+    const char *sync_mode = getenv(LGR_TEN_SYNC_ENV);
+    int         rc;
+
+    if (pthread_key_create(&lgr_out_key, lgr_out_free) != 0)
+    {
+        fprintf(stderr, "ERROR: Logger pthread_key_create() failed\n");
+        return;
+    }
+
+    te_log_message_tx = log_message_sync;
+    if (sync_mode == NULL || strcmp(sync_mode, "yes") != 0)
+    {
+        rc = pthread_create(&lgr_flusher, NULL, lgr_flusher_thread, NULL);
+        if (rc != 0)
+        {
+            fprintf(stderr, "Failed to create Logger flusher thread: %s\n",
+                    strerror(rc));
+        }
+        else
+        {
+            lgr_async = TRUE;
+            te_log_message_tx = log_message_queue;
+        }
+    }
+
+    pthread_atfork(NULL, NULL, lgr_atfork_child);
+    atexit(log_client_close);
+}
+
 
 /**
  * Compose log message and send it to TE Logger.
@@ -102,47 +494,46 @@ ten_log_message(const char *file, unsigned int line,
                 const char *entity, const char *user,
                 const char *fmt, va_list ap)
 {
-#ifdef HAVE_PTHREAD_H
-    pthread_mutex_lock(&lgr_lock);
-#endif
-
-    if (lgr_client == NULL)
-    {
-        int  rc;
-        char name[32];
+    te_log_msg_raw_data *out;
 
-        if (snprintf(name, sizeof(name), "lgr_client_%u",
-                     (unsigned int)getpid()) >= (int)sizeof(name))
-        {
-            fprintf(stderr, "ERROR: Logger client name truncated");
-        }
-        rc = ipc_init_client(name, LOGGER_IPC, &lgr_client);
-        if (rc != 0)
-        {
-#ifdef HAVE_PTHREAD_H
-            pthread_mutex_unlock(&lgr_lock);
-#endif
-            return;
-        }
-        assert(lgr_client != NULL);
-        te_log_message_tx = log_message_ipc;
-        atexit(log_client_close);
+    pthread_once(&lgr_once, lgr_init);
+    if (te_log_message_tx == NULL)
+        return;
 
-        /* Initialize backend */
-        lgr_out.common = te_log_msg_out_raw;
-        lgr_out.buf = lgr_out.end = NULL;
-        lgr_out.args_max = 0;
-        lgr_out.args = NULL;
-    }
+    out = lgr_out_get();
+    if (out == NULL)
+        return;
 
-    log_message_va(&lgr_out, file, line, sec, usec, level, entity, user,
+    log_message_va(out, file, line, sec, usec, level, entity, user,
                    fmt, ap);
 
-#ifdef HAVE_PTHREAD_H
-    pthread_mutex_unlock(&lgr_lock);
-#endif
+    /*
+     * Errors and warnings often precede abnormal termination of the
+     * process which would lose the queue, so do not return until they
+     * (and everything logged before) are passed to Logger.
+     */
+    if (level & (TE_LL_ERROR | TE_LL_WARN))
+        ten_log_flush();
 }
 
+/* See description in logger_ten.h */
+void
+ten_log_flush(void)
+{
+    uint64_t target;
+
+    /* The flusher cannot wait for itself */
+    if (!lgr_async || pthread_equal(pthread_self(), lgr_flusher))
+        return;
+
+    target = __atomic_load_n(&lgr_queued, __ATOMIC_ACQUIRE);
+
+    pthread_mutex_lock(&lgr_flusher_lock);
+    pthread_cond_signal(&lgr_flusher_wakeup);
+    while (lgr_sent < target)
+        pthread_cond_wait(&lgr_flusher_sent_cond, &lgr_flusher_lock);
+    pthread_mutex_unlock(&lgr_flusher_lock);
+}
 
 /* See description in logger_ten.h */
 void
@@ -150,14 +541,31 @@ log_client_close(void)
 {
     int res;
 
-#ifdef HAVE_PTHREAD_H
+    if (lgr_async)
+    {
+        /* Send all queued messages and stop the flusher thread */
+        pthread_mutex_lock(&lgr_flusher_lock);
+        lgr_flusher_stop = TRUE;
+        pthread_cond_signal(&lgr_flusher_wakeup);
+        pthread_mutex_unlock(&lgr_flusher_lock);
+
+        res = pthread_join(lgr_flusher, NULL);
+        if (res != 0)
+        {
+            fprintf(stderr, "%s(): pthread_join() failed: %s\n",
+                    __FUNCTION__, strerror(res));
+            return;
+        }
+        lgr_async = FALSE;
+        te_log_message_tx = log_message_sync;
+    }
+
     if ((res = pthread_mutex_trylock(&lgr_lock)) != 0)
     {
         fprintf(stderr, "%s(): pthread_mutex_trylock() failed: %s\n",
                 __FUNCTION__, strerror(res));
         return;
     }
-#endif
     res = ipc_close_client(lgr_client);
     if (res != 0)
     {
@@ -168,18 +576,11 @@ log_client_close(void)
     {
         lgr_client = NULL;
     }
-    free(lgr_out.buf);
-    lgr_out.buf = lgr_out.end = NULL;
-    free(lgr_out.args);
-    lgr_out.args = NULL;
-    lgr_out.args_max = 0;
-#ifdef HAVE_PTHREAD_H
     if ((res = pthread_mutex_unlock(&lgr_lock)) != 0)
     {
         fprintf(stderr, "%s(): pthread_mutex_unlock() failed: %s\n",
                 __FUNCTION__, strerror(res));
     }
-#endif
 }
 
 
@@ -204,9 +605,12 @@ log_flush_ten(const char *ta_name)
         return TE_EINVAL;
     }
 
+    /* Messages of this process should not be behind TA messages */
+    ten_log_flush();
+
     snprintf(clnt_name, sizeof(clnt_name), "LOGGER_FLUSH_%s", ta_name);
 
-    rc = ipc_init_client(clnt_name, LOGGER_IPC, &log_client);
+    rc = ipc_init_client(clnt_name, LOGGER_TA_IPC, &log_client);
     if (rc != 0)
     {
         ERROR("Failed to initialize log flush client: %r", rc);
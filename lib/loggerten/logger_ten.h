@@ -48,8 +48,15 @@ logger_server_name(void)
 /** Name of the Logger server */
 #define LGR_SRV_NAME            (logger_server_name())
 
-/** Type of IPC used for Logger TEN API <-> Logger server */
-#define LOGGER_IPC              (FALSE) /* Connectionless IPC */
+/**
+ * Type of IPC used for Logger TEN API <-> Logger server.
+ * Connection-oriented IPC allows to use shared memory transport
+ * (see IPC_SHM_ENV).
+ */
+#define LOGGER_IPC              (TRUE)  /* Connection-oriented IPC */
+
+/** Type of IPC used for Logger TEN API <-> Logger server for TA */
+#define LOGGER_TA_IPC           (FALSE) /* Connectionless IPC */
 
 
 /** Discover name of the Logger client for TA */
@@ -98,6 +105,19 @@ logger_flush_name(void)
  */
 extern void log_client_close(void);
 
+/**
+ * Wait until all messages logged by the process before the call
+ * are sent to Logger. Messages are sent by a background thread
+ * in batches unless @c TE_LOGGER_TEN_SYNC environment variable is
+ * set to @c yes.
+ *
+ * It is called automatically on exit, before TA logs flushing and
+ * after logging of each error or warning. Messages of other levels
+ * logged after the last such point are lost if the process terminates
+ * without exit handlers (killed by a signal, _exit(), crash).
+ */
+extern void ten_log_flush(void);
+
 /**
  * Pump out all log messages (only older than time of
  * this procedure calling) accumulated into the Test Agent local log
@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Logger TEN library benchmark
+ *
+ * Benchmark of the rate of logging from engine-side processes.
+ *
+ * The benchmark registers its own Logger IPC server (TE_LOGGER
+ * environment variable is set to its name) which counts received raw
+ * log messages. Child processes log messages in synchronous mode
+ * (as before the flusher thread was introduced) and in asynchronous
+ * batched mode, and report number of messages per second including
+ * the time required to deliver all messages to the server.
+ *
+ * Usage: ten_log_bench [<number of messages> [<number of threads>]]
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Bench"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <arpa/inet.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_raw_log.h"
+#include "logger_api.h"
+#include "logger_int.h"
+#include "logger_ten.h"
+#include "ipc_server.h"
+
+/** Default number of messages logged by each thread */
+#define BENCH_MSG_NUM       200000
+
+/** Default number of logging threads */
+#define BENCH_THREADS       1
+
+/** Size of the buffer to receive messages */
+#define BENCH_BUF_LEN       0x20000
+
+/** Number of messages to be logged by each thread */
+static unsigned int msg_num = BENCH_MSG_NUM;
+
+/**
+ * Log messages.
+ *
+ * @param arg       Unused
+ *
+ * @return @c NULL
+ */
+static void *
+bench_log_thread(void *arg)
+{
+    unsigned int i;
+
+    UNUSED(arg);
+
+    for (i = 0; i < msg_num; i++)
+        RING("Benchmark message %u of %u: %s", i, msg_num, "payload");
+
+    return NULL;
+}
+
+/**
+ * Log messages from several threads and wait for their delivery.
+ *
+ * @param mode      Name of the mode
+ * @param threads   Number of threads
+ *
+ * @return Exit status.
+ */
+static int
+bench_child(const char *mode, unsigned int threads)
+{
+    pthread_t       tids[threads];
+    struct timespec start;
+    struct timespec end;
+    unsigned int    i;
+    double          sec;
+
+    te_log_init("ten_log_bench", ten_log_message);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < threads; i++)
+    {
+        if (pthread_create(&tids[i], NULL, bench_log_thread, NULL) != 0)
+        {
+            fprintf(stderr, "pthread_create() failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+    for (i = 0; i < threads; i++)
+        pthread_join(tids[i], NULL);
+    ten_log_flush();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    sec = (end.tv_sec - start.tv_sec) +
+          (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%-8s %12.0f messages/sec\n", mode,
+           (double)msg_num * threads / sec);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Count raw log messages in the received IPC message.
+ *
+ * @param buf       IPC message
+ * @param len       Length of the message
+ *
+ * @return Number of raw log messages.
+ */
+static unsigned int
+bench_count(const uint8_t *buf, size_t len)
+{
+    size_t const    hdr_len = sizeof(te_log_nfl) + strlen(LGR_SRV_BATCH);
+    unsigned int    num = 0;
+    uint32_t        msg_len;
+
+    if (len <= hdr_len ||
+        memcmp(buf + sizeof(te_log_nfl), LGR_SRV_BATCH,
+               strlen(LGR_SRV_BATCH)) != 0)
+    {
+        return 1;
+    }
+
+    for (buf += hdr_len, len -= hdr_len; len >= sizeof(msg_len);
+         num++, buf += msg_len, len -= msg_len)
+    {
+        memcpy(&msg_len, buf, sizeof(msg_len));
+        msg_len = ntohl(msg_len);
+        buf += sizeof(msg_len);
+        len -= sizeof(msg_len);
+        if (msg_len > len)
+            break;
+    }
+
+    return num;
+}
+
+/**
+ * Run the child process in the specified mode and receive its messages.
+ *
+ * @param srv       Logger IPC server
+ * @param mode      Name of the mode
+ * @param sync      Should messages be sent synchronously?
+ * @param threads   Number of logging threads
+ *
+ * @return Status code.
+ */
+static te_errno
+bench_run(struct ipc_server *srv, const char *mode, te_bool sync,
+          unsigned int threads)
+{
+    static uint8_t              buf[BENCH_BUF_LEN];
+    struct ipc_server_client   *ipcsc;
+    unsigned int                received = 0;
+    size_t                      len;
+    pid_t                       pid;
+    int                         status;
+    te_errno                    rc;
+
+    /* Do not duplicate buffered output in the child */
+    fflush(stdout);
+
+    pid = fork();
+    if (pid < 0)
+        return TE_OS_RC(TE_IPC, errno);
+
+    if (pid == 0)
+    {
+        if (sync)
+            setenv("TE_LOGGER_TEN_SYNC", "yes", 1);
+        else
+            unsetenv("TE_LOGGER_TEN_SYNC");
+        exit(bench_child(mode, threads));
+    }
+
+    while (received < msg_num * threads)
+    {
+        len = sizeof(buf);
+        ipcsc = NULL;
+        rc = ipc_receive_message(srv, buf, &len, &ipcsc);
+        if (rc != 0)
+        {
+            fprintf(stderr, "ipc_receive_message() failed: %s\n",
+                    te_rc_err2str(rc));
+            break;
+        }
+        received += bench_count(buf, len);
+    }
+
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+        fprintf(stderr, "%s: logging process failed\n", mode);
+        return TE_EFAIL;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct ipc_server  *srv;
+    unsigned int        threads = BENCH_THREADS;
+    char                name[64];
+    te_errno            rc;
+
+    if (argc > 1)
+        msg_num = strtoul(argv[1], NULL, 0);
+    if (argc > 2)
+        threads = strtoul(argv[2], NULL, 0);
+    if (msg_num == 0 || threads == 0)
+    {
+        fprintf(stderr, "Usage: %s [<messages> [<threads>]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    snprintf(name, sizeof(name), "ten_log_bench_%u",
+             (unsigned int)getpid());
+    setenv("TE_LOGGER", name, 1);
+
+    rc = ipc_register_server(LGR_SRV_NAME, LOGGER_IPC, &srv);
+    if (rc != 0)
+    {
+        fprintf(stderr, "Failed to register IPC server: %s\n",
+                te_rc_err2str(rc));
+        return EXIT_FAILURE;
+    }
+
+    printf("%u messages, %u threads\n", msg_num, threads);
+    if (bench_run(srv, "sync", TRUE, threads) != 0 ||
+        bench_run(srv, "batched", FALSE, threads) != 0)
+    {
+        ipc_close_server(srv);
+        return EXIT_FAILURE;
+    }
+
+    ipc_close_server(srv);
+
+    return EXIT_SUCCESS;
+}
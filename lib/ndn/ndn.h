@@ -33,6 +33,9 @@ typedef enum {
     NDN_CSAP_PARAMS,
     NDN_CSAP_RECV_TIMEOUT,
     NDN_CSAP_STOP_LATENCY_TIMEOUT,
+    NDN_CSAP_BIN_REPORTS,
+    NDN_CSAP_RECV_WORKERS,
+    NDN_CSAP_RECV_FANOUT,
 } ndn_message_tags_t;
 
 
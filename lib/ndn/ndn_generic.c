@@ -188,6 +188,12 @@ static asn_named_entry_t _ndn_csap_params_ne_array[] = {
       { PRIVATE, NDN_CSAP_RECV_TIMEOUT } },
     { "stop-latency-timeout-ms", &asn_base_integer_s,
       { PRIVATE, NDN_CSAP_STOP_LATENCY_TIMEOUT } },
+    { "binary-reports", &asn_base_integer_s,
+      { PRIVATE, NDN_CSAP_BIN_REPORTS } },
+    { "receive-workers", &asn_base_integer_s,
+      { PRIVATE, NDN_CSAP_RECV_WORKERS } },
+    { "receive-fanout", &asn_base_integer_s,
+      { PRIVATE, NDN_CSAP_RECV_FANOUT } },
 };
 
 static asn_type ndn_csap_params_s = {
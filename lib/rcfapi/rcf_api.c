@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <limits.h>
 
 #ifdef HAVE_SYS_TYPES_H
 #include <sys/types.h>
@@ -1127,10 +1128,23 @@ rcf_log_cfg_changes(te_bool enable)
         ctx_handle->log_cfg_changes = enable;
 }
 
-/* See description in rcf_api.h */
-te_errno
-rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
-               char *val_buf, size_t len)
+/**
+ * Implementation of rcf_ta_cfg_get and rcf_ta_cfg_get_bulk functionality -
+ * see description of these functions for details.
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param oid           object instance identifier
+ * @param val_buf       location for the answer
+ * @param len           location length (IN) / length of the data
+ *                      (including trailing zero) put to it (OUT)
+ * @param opcode        RCFOP_CONFGET or RCFOP_CONFGET_BULK
+ *
+ * @return error code
+ */
+static te_errno
+conf_get(const char *ta_name, int session, const char *oid,
+         char *val_buf, size_t *len, int opcode)
 {
     rcf_msg     msg;
     size_t      anslen = sizeof(msg);
@@ -1138,8 +1152,8 @@ rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
 
     RCF_API_INIT;
 
-    if (oid == NULL || val_buf == NULL || strlen(oid) >= RCF_MAX_ID ||
-        BAD_TA)
+    if (oid == NULL || val_buf == NULL || len == NULL ||
+        strlen(oid) >= RCF_MAX_ID || BAD_TA)
     {
         return TE_RC(TE_RCF_API, TE_EINVAL);
     }
@@ -1147,7 +1161,7 @@ rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
     memset(&msg, 0, sizeof(msg));
     te_strlcpy(msg.id, oid, sizeof(msg.id));
     te_strlcpy(msg.ta, ta_name, sizeof(msg.ta));
-    msg.opcode = RCFOP_CONFGET;
+    msg.opcode = opcode;
     msg.sid = session;
 
     rc = send_recv_rcf_ipc_message(ctx_handle, &msg, sizeof(msg),
@@ -1166,14 +1180,14 @@ rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
             ERROR("Cannot open file %s saved by RCF process", msg.file);
             return TE_RC(TE_RCF_API, TE_ENOENT);
         }
-        if ((n = read(fd, val_buf, len)) < 0)
+        if ((n = read(fd, val_buf, *len)) < 0)
         {
             ERROR("Cannot read from file %s saved by RCF process",
                   msg.file);
             close(fd);
             return TE_RC(TE_RCF_API, TE_EIPC);
         }
-        if (len == (size_t)n)
+        if (*len == (size_t)n)
         {
             char tmp;
 
@@ -1188,17 +1202,35 @@ rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
         close(fd);
         if (unlink(msg.file) != 0)
             ERROR("Cannot unlink file %s saved by RCF process", msg.file);
+        *len = n;
     }
     else
     {
-        if (len <= strlen(msg.value))
+        if (*len <= strlen(msg.value))
             return TE_RC(TE_RCF_API, TE_ESMALLBUF);
-        te_strlcpy(val_buf, msg.value, len);
+        te_strlcpy(val_buf, msg.value, *len);
+        *len = strlen(msg.value) + 1;
     }
 
     return 0;
 }
 
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
+               char *val_buf, size_t len)
+{
+    return conf_get(ta_name, session, oid, val_buf, &len, RCFOP_CONFGET);
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_cfg_get_bulk(const char *ta_name, int session, const char *oid,
+                    char *buf, size_t *len)
+{
+    return conf_get(ta_name, session, oid, buf, len, RCFOP_CONFGET_BULK);
+}
+
 /**
  * Implementation of rcf_ta_cfg_set and rcf_ta_cfg_add functionality -
  * see description of these functions for details.
@@ -1454,6 +1486,45 @@ rcf_ta_get_log(const char *ta_name, char *log_file)
     return rc;
 }
 
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_get_log_data(const char *ta_name, void *buf, size_t *len,
+                    te_bool *more)
+{
+    rcf_msg    *msg;
+    size_t      anslen;
+    te_errno    rc;
+
+    RCF_API_INIT;
+
+    if (buf == NULL || len == NULL || *len == 0 || *len > INT_MAX ||
+        more == NULL || BAD_TA)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    anslen = sizeof(*msg) + *len;
+    msg = calloc(1, anslen);
+    if (msg == NULL)
+        return TE_RC(TE_RCF_API, TE_ENOMEM);
+
+    te_strlcpy(msg->ta, ta_name, sizeof(msg->ta));
+    msg->opcode = RCFOP_GET_LOG;
+    msg->sid = RCF_TA_GET_LOG_SID;
+    msg->intparm = *len;
+
+    rc = send_recv_rcf_ipc_message(ctx_handle, msg, sizeof(*msg),
+                                   msg, &anslen, NULL);
+
+    if (rc == 0 && (rc = msg->error) == 0)
+    {
+        memcpy(buf, msg->data, msg->data_len);
+        *len = msg->data_len;
+        *more = (msg->num != 0);
+    }
+
+    free(msg);
+    return rc;
+}
+
 /* See description in rcf_api.h */
 te_errno
 rcf_ta_get_var(const char *ta_name, int session, const char *var_name,
@@ -297,6 +297,40 @@ extern te_errno rcf_ta_cfg_get(const char *ta_name, int session,
                                const char *oid,
                                char *val_buf, size_t len);
 
+/**
+ * This function is used to obtain all object instances of the subtree
+ * together with their values using single request to the Test Agent.
+ * The function may be called by Configurator only.
+ *
+ * The answer is a sequence of pairs of zero-terminated strings:
+ * object instance identifier followed by its value (empty for
+ * instances of objects without value or get method).
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param oid           identifier of the subtree root instance (may
+ *                      contain wildcards)
+ * @param buf           location for the answer
+ * @param len           location length (IN) / length of the
+ *                      answer (OUT)
+ *
+ * @return error code
+ *
+ * @retval 0            success
+ * @retval TE_EINVAL       name of non-running TN Test Agent or non-existent
+ *                      session identifier is provided or OID string is
+ *                      too long
+ * @retval TE_EIPC      cannot interact with RCF
+ * @retval TE_ESMALLBUF the buffer is too small
+ * @retval TE_ETAREBOOTED  Test Agent is rebooted
+ * @retval TE_ENOMEM       out of memory
+ * @retval TE_EFMT      the Test Agent does not support the request
+ * @retval other        error returned by command handler on the TA
+ */
+extern te_errno rcf_ta_cfg_get_bulk(const char *ta_name, int session,
+                                    const char *oid,
+                                    char *buf, size_t *len);
+
 /**
  * This function is used to change value of object instance.
  * The function may be called by Configurator only.
@@ -458,6 +492,34 @@ extern te_errno rcf_ta_get_sniffers(const char *ta_name,
  */
 extern te_errno rcf_ta_get_log(const char *ta_name, char *log_file);
 
+/**
+ * This function is used to get bulk of log from the Test Agent directly
+ * in memory, without intermediate files (log streaming mode).
+ * The function may be called by Logger only.
+ *
+ * @param ta_name       Test Agent name
+ * @param buf           buffer for the log data
+ * @param len           location of the buffer length (credit, i.e.
+ *                      the maximum number of bytes the Test Agent may
+ *                      send) on input, and of the obtained data length
+ *                      on output
+ * @param more          location for the flag which is set to @c TRUE
+ *                      if the Test Agent has more messages to be
+ *                      obtained
+ *
+ * @return error code
+ *
+ * @retval 0                success
+ * @retval TE_EINVAL        name of non-running TN Test Agent or bad
+ *                          buffer is provided
+ * @retval TE_EIPC          cannot interact with RCF
+ * @retval TE_ETAREBOOTED   Test Agent is rebooted
+ * @retval TE_ENOMEM        out of memory
+ * @retval other            error returned by command handler on the TA
+ */
+extern te_errno rcf_ta_get_log_data(const char *ta_name, void *buf,
+                                    size_t *len, te_bool *more);
+
 /**
  * This function is used to obtain value of the variable from the Test Agent
  * or NUT served by it.
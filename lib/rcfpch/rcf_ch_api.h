@@ -191,6 +191,7 @@ typedef enum {
     RCF_CH_CFG_DEL,
     RCF_CH_CFG_GRP_START,
     RCF_CH_CFG_GRP_END,
+    RCF_CH_CFG_GET_BULK,
 } rcf_ch_cfg_op_t;
 
 /**
@@ -350,6 +350,7 @@ get_opcode(char **ptr, rcf_op_t *opcode)
     TRY_CMD(CONFDEL);
     TRY_CMD(CONFGRP_START);
     TRY_CMD(CONFGRP_END);
+    TRY_CMD(CONFGET_BULK);
     TRY_CMD(GET_LOG);
     TRY_CMD(VREAD);
     TRY_CMD(VWRITE);
@@ -382,27 +383,49 @@ get_opcode(char **ptr, rcf_op_t *opcode)
 /**
  * Transmit log to the Test Engine.
  *
+ * If @p credit is not zero, the Test Engine works in the log streaming
+ * mode: no more than @p credit bytes are sent and the answer carries
+ * the flag telling whether there are more messages to be fetched, so
+ * that the Test Engine may request them immediately.
+ *
  * @param cbuf          command buffer
  * @param conn          connection handle
  * @param answer_plen   number of bytes to be copied from the command
  *                      to answer
+ * @param credit        maximum number of bytes the Test Engine is ready
+ *                      to accept or @c 0
  *
  * @return 0 or error returned by communication library
  */
 static te_errno
 transmit_log(struct rcf_comm_connection *conn, char *cbuf,
-             size_t buflen, size_t answer_plen)
+             size_t buflen, size_t answer_plen, size_t credit)
 {
     size_t      len;
     te_errno    rc;
     int         ret;
 
-    len = ta_log_get(sizeof(log_data), log_data);
+    if (credit == 0 || credit > sizeof(log_data))
+        len = ta_log_get(sizeof(log_data), log_data);
+    else
+        len = ta_log_get(credit, log_data);
 
-    ret = snprintf(cbuf + answer_plen, buflen - answer_plen,
-                   (len == 0) ? "%u" : "0 attach %u",
-                   (len == 0) ? (unsigned)TE_RC(TE_RCF_PCH, TE_ENOENT) :
-                                (unsigned)len);
+    if (len == 0)
+    {
+        ret = snprintf(cbuf + answer_plen, buflen - answer_plen, "%u",
+                       (unsigned)TE_RC(TE_RCF_PCH, TE_ENOENT));
+    }
+    else if (credit != 0)
+    {
+        ret = snprintf(cbuf + answer_plen, buflen - answer_plen,
+                       "0 %d attach %u", ta_log_pending() ? 1 : 0,
+                       (unsigned)len);
+    }
+    else
+    {
+        ret = snprintf(cbuf + answer_plen, buflen - answer_plen,
+                       "0 attach %u", (unsigned)len);
+    }
     if ((size_t)ret >= (buflen - answer_plen))
     {
         ERROR("Command buffer too small");
@@ -660,10 +683,13 @@ rcf_pch_run(const char *confstr, const char *info)
             case RCFOP_CONFSET:
             case RCFOP_CONFADD:
             case RCFOP_CONFDEL:
+            case RCFOP_CONFGET_BULK:
             {
                 int op = opcode == RCFOP_CONFGET ? RCF_CH_CFG_GET :
                          opcode == RCFOP_CONFSET ? RCF_CH_CFG_SET :
                          opcode == RCFOP_CONFADD ? RCF_CH_CFG_ADD :
+                         opcode == RCFOP_CONFGET_BULK ?
+                             RCF_CH_CFG_GET_BULK :
                          RCF_CH_CFG_DEL;
                 char *oid,
                      *val = NULL;
@@ -671,7 +697,8 @@ rcf_pch_run(const char *confstr, const char *info)
                 if (*ptr == 0 || transform_str(&ptr, &oid) != 0)
                     goto bad_protocol;
 
-                if (opcode == RCFOP_CONFGET || opcode == RCFOP_CONFDEL)
+                if (opcode == RCFOP_CONFGET || opcode == RCFOP_CONFDEL ||
+                    opcode == RCFOP_CONFGET_BULK)
                 {
                     if (*ptr != 0)
                         goto bad_protocol;
@@ -752,14 +779,28 @@ rcf_pch_run(const char *confstr, const char *info)
             }
 
             case RCFOP_GET_LOG:
-                if (*ptr != 0 || ba != NULL)
+            {
+                unsigned long credit = 0;
+
+                if (ba != NULL)
                     goto bad_protocol;
 
-                rc = transmit_log(conn, cmd, cmd_buf_len, answer_plen);
+                if (*ptr != 0)
+                {
+                    char *end;
+
+                    credit = strtoul(ptr, &end, 10);
+                    if (end == ptr || *end != 0)
+                        goto bad_protocol;
+                }
+
+                rc = transmit_log(conn, cmd, cmd_buf_len, answer_plen,
+                                  credit);
                 if (rc != 0)
                     goto communication_problem;
 
                 break;
+            }
 
             case RCFOP_VREAD:
             case RCFOP_VWRITE:
@@ -74,8 +74,9 @@
 
 /** Structure for temporary storing of instances/objects identifiers */
 typedef struct olist {
-    struct olist *next;             /**< Pointer to the next element */
-    char          oid[CFG_OID_MAX]; /**< Element OID */
+    struct olist       *next;             /**< Pointer to the next element */
+    rcf_pch_cfg_object *obj;              /**< Object of the instance */
+    char                oid[CFG_OID_MAX]; /**< Element OID */
 } olist;
 
 /** Postponed configuration commit operation */
@@ -375,6 +376,7 @@ create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
                 }
 
                 strcpy(new_entry->oid, tmp_parsed);
+                new_entry->obj = obj;
 
                 new_entry->next = *list;
                 *list = new_entry;
@@ -473,6 +475,7 @@ create_wildcard_obj_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
                 RET(TE_ENOMEM);
 
             strcpy(new_entry->oid, tmp_parsed);
+            new_entry->obj = obj;
             new_entry->next = *list;
             *list = new_entry;
         }
@@ -967,6 +970,173 @@ out:
     return rc;
 }
 
+/**
+ * Append zero-terminated string to the answer on bulk get request.
+ *
+ * @param buf       location of the answer buffer pointer
+ * @param size      location of the answer buffer size
+ * @param len       location of the answer length
+ * @param str       string to be appended
+ *
+ * @return Status code
+ */
+static te_errno
+bulk_answer_append(char **buf, size_t *size, size_t *len, const char *str)
+{
+    size_t str_len = strlen(str) + 1;
+
+    if (*len + str_len > *size)
+    {
+        size_t  new_size = MAX(*size * 2, *len + str_len);
+        char   *new_buf = realloc(*buf, new_size);
+
+        if (new_buf == NULL)
+            return TE_ENOMEM;
+
+        *buf = new_buf;
+        *size = new_size;
+    }
+
+    memcpy(*buf + *len, str, str_len);
+    *len += str_len;
+
+    return 0;
+}
+
+/**
+ * Get value of the instance found by wildcard request taking
+ * substitutions into account.
+ *
+ * @param entry     list entry with the instance identifier and object
+ * @param value     location for the value (RCF_MAX_VAL bytes)
+ *
+ * @return Status code
+ */
+static te_errno
+bulk_get_value(const olist *entry, char *value)
+{
+    cfg_oid    *p_oid;
+    te_errno    rc;
+
+    *value = '\0';
+    if (entry->obj->get == NULL)
+        return 0;
+
+    rc = get_object_value(entry->obj, entry->oid, value);
+    if (rc != 0 || entry->obj->subst == NULL)
+        return rc;
+
+    p_oid = cfg_convert_oid_str(entry->oid);
+    if (p_oid == NULL)
+        return TE_EINVAL;
+
+    rc = do_substitutions(entry->obj, value,
+                          ((cfg_inst_subid *)p_oid->ids)[p_oid->len - 1].name,
+                          (cfg_inst_subid *)p_oid->ids);
+    if (rc != 0)
+        ERROR("Failed to replace value in %s rc=%r", value, rc);
+
+    cfg_free_oid(p_oid);
+
+    return rc;
+}
+
+/**
+ * Process bulk configure get request: get all instances of the subtree
+ * together with their values. The answer is sent as binary attachment
+ * which consists of pairs of zero-terminated strings: instance identifier
+ * followed by its value.
+ *
+ * @param conn            connection handle
+ * @param cbuf            command buffer
+ * @param buflen          length of the command buffer
+ * @param answer_plen     number of bytes in the command buffer
+ *                        to be copied to the answer
+ * @param oid             identifier of the subtree root instance
+ *                        (may contain wildcards)
+ *
+ * @return 0 or error returned by communication library
+ */
+static te_errno
+process_bulk_get(struct rcf_comm_connection *conn, char *cbuf,
+                 size_t buflen, size_t answer_plen, const char *oid)
+{
+    char    copy[CFG_OID_MAX];
+    char    value[RCF_MAX_VAL];
+    olist  *list = NULL;
+    olist  *entry;
+    char   *ans = NULL;
+    size_t  ans_size = 0;
+    size_t  ans_len = 0;
+    int     rc;
+
+    ENTRY("OID='%s'", oid);
+
+    if (strchr(oid, ':') == NULL || strstr(oid, OID_ETC) != NULL ||
+        (size_t)snprintf(copy, sizeof(copy), "%s" OID_ETC, oid) >=
+            sizeof(copy))
+    {
+        ERROR("Bad subtree root identifier '%s'", oid);
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EINVAL));
+    }
+
+    rc = create_wildcard_inst_list(rcf_pch_conf_root(), NULL, copy, oid,
+                                   &list);
+    if (rc != 0)
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
+
+    for (entry = list; entry != NULL; entry = entry->next)
+    {
+        rc = bulk_get_value(entry, value);
+        if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+        {
+            /* The instance has disappeared after listing */
+            rc = 0;
+            continue;
+        }
+        if (rc != 0 ||
+            (rc = bulk_answer_append(&ans, &ans_size, &ans_len,
+                                     entry->oid)) != 0 ||
+            (rc = bulk_answer_append(&ans, &ans_size, &ans_len,
+                                     value)) != 0)
+        {
+            break;
+        }
+    }
+    free_list(list);
+
+    if (rc == 0 && ans_len == 0)
+        rc = bulk_answer_append(&ans, &ans_size, &ans_len, "");
+
+    if (rc != 0)
+    {
+        free(ans);
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
+    }
+
+    if ((size_t)snprintf(cbuf + answer_plen, buflen - answer_plen,
+                         "0 attach %u", (unsigned int)ans_len) >=
+            (buflen - answer_plen))
+    {
+        free(ans);
+        ERROR("Command buffer too small for reply");
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_E2BIG));
+    }
+
+    RCF_CH_LOCK;
+    rc = rcf_comm_agent_reply(conn, cbuf, strlen(cbuf) + 1);
+    if (rc == 0)
+        rc = rcf_comm_agent_reply(conn, ans, ans_len);
+    RCF_CH_UNLOCK;
+
+    VERB("Sent answer to bulk get request '%s' len=%u rc=%d",
+         oid, (unsigned int)ans_len, rc);
+
+    free(ans);
+
+    return rc;
+}
+
 /* See description in rcf_pch.h */
 int
 rcf_pch_configure(struct rcf_comm_connection *conn,
@@ -998,6 +1168,15 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
                                         (val == NULL) ? "NULL" : val);
     VERB("Default configuration handler is executed");
 
+    if (op == RCF_CH_CFG_GET_BULK)
+    {
+        rc = process_bulk_get(conn, cbuf, buflen, answer_plen, oid);
+
+        EXIT("%r", rc);
+
+        return rc;
+    }
+
     if (oid != 0)
     {
         /* Now parse the oid and look for the object */
@@ -61,6 +61,8 @@
 #include "agentlib.h"
 #include "te_sleep.h"
 #include "te_alloc.h"
+#include "te_string.h"
+#include "te_hist.h"
 
 /** How long wait for a process termination, milliseconds. */
 #define WAITPID_TIMEOUT 10000
@@ -88,6 +90,16 @@ do {                                                                       \
 
 
 
+/** Latency statistics of one RPC function called on an RPC server */
+typedef struct rpcserver_stats {
+    struct rpcserver_stats *next;   /**< Next function in the list */
+    const rpc_info         *info;   /**< RPC function */
+    te_hist                 agent;  /**< Time from receiving a request
+                                         to sending the answer, us */
+    te_hist                 call;   /**< Duration of the call in
+                                         RPC server, us */
+} rpcserver_stats;
+
 /** Data corresponding to one RPC server */
 typedef struct rpcserver {
     struct rpcserver *next;   /**< Next server in the list */
@@ -121,6 +133,13 @@ typedef struct rpcserver {
 
     rcf_rpc_op  last_rpc_op; /** Operation type of last rpc call **/
     char        last_rpc_name[RCF_MAX_NAME]; /** Name of last rpc call **/
+
+    rpcserver_stats *stats;     /**< Per-function latency statistics */
+    rpcserver_stats *cur_stats; /**< Statistics to update on the answer
+                                     or @c NULL if the call in progress
+                                     is not accounted */
+    struct timeval   sent_tv;   /**< Time of the last request receiving
+                                     from RCF */
 } rpcserver;
 
 static rpcserver *list;        /**< List of all RPC servers */
@@ -177,6 +196,22 @@ static te_errno rpcserver_sid_get(unsigned int, const char *, char *,
                                   const char *);
 static te_errno rpcserver_sid_set(unsigned int, const char *, const char *,
                                   const char *);
+static te_errno rpcserver_stats_get(unsigned int, const char *, char *,
+                                    const char *, const char *);
+static te_errno rpcserver_stats_list(unsigned int, const char *,
+                                     const char *, char **, const char *);
+static te_errno rpcserver_stats_call_get(unsigned int, const char *, char *,
+                                         const char *, const char *);
+
+static rcf_pch_cfg_object node_rpcserver_stats_call =
+    { "call", 0, NULL, NULL,
+      (rcf_ch_cfg_get)rpcserver_stats_call_get,
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+
+static rcf_pch_cfg_object node_rpcserver_stats =
+    { "stats", 0, &node_rpcserver_stats_call, NULL,
+      (rcf_ch_cfg_get)rpcserver_stats_get, NULL, NULL, NULL,
+      (rcf_ch_cfg_list)rpcserver_stats_list, NULL, NULL, NULL};
 
 static rcf_pch_cfg_object node_rpcprovider =
     { "rpcprovider", 0, NULL, NULL,
@@ -191,7 +226,7 @@ static rcf_pch_cfg_object node_rpc_default_timeout =
       NULL, NULL, NULL, NULL, NULL, NULL};
 
 static rcf_pch_cfg_object node_rpcserver_sid =
-    { "sid", 0, NULL, NULL,
+    { "sid", 0, NULL, &node_rpcserver_stats,
       (rcf_ch_cfg_get)rpcserver_sid_get,
       (rcf_ch_cfg_set)rpcserver_sid_set,
       NULL, NULL, NULL, NULL, NULL, NULL};
@@ -682,6 +717,119 @@ send_response(const rpcserver *rpcs, struct rcf_comm_connection *conn,
     }
 }
 
+/**
+ * Find statistics of RPC function on RPC server.
+ * Should be called under the lock.
+ *
+ * @param rpcs          RPC server
+ * @param rpc_name      Name of RPC function
+ * @param create        Create empty statistics if they are not found
+ *
+ * @return Statistics or @c NULL.
+ */
+static rpcserver_stats *
+rpcserver_stats_find(rpcserver *rpcs, const char *rpc_name, te_bool create)
+{
+    const rpc_info  *info = rpc_find_info(rpc_name);
+    rpcserver_stats *stats;
+
+    if (info == NULL)
+        return NULL;
+
+    for (stats = rpcs->stats; stats != NULL; stats = stats->next)
+    {
+        if (stats->info == info)
+            return stats;
+    }
+
+    if (!create)
+        return NULL;
+
+    if ((stats = malloc(sizeof(*stats))) == NULL)
+    {
+        ERROR("Cannot allocate statistics of RPC %s", rpc_name);
+        return NULL;
+    }
+
+    stats->info = info;
+    te_hist_init(&stats->agent);
+    te_hist_init(&stats->call);
+    stats->next = rpcs->stats;
+    rpcs->stats = stats;
+
+    return stats;
+}
+
+/**
+ * Account the answer to the call in progress in RPC server statistics.
+ * Should be called under the lock.
+ *
+ * @param rpcs          RPC server
+ * @param duration      Duration of the call reported by RPC server, us
+ */
+static void
+rpcserver_stats_update(rpcserver *rpcs, uint32_t duration)
+{
+    struct timeval now;
+    int64_t        agent;
+
+    if (rpcs->cur_stats == NULL)
+        return;
+
+    gettimeofday(&now, NULL);
+    agent = TE_SEC2US((int64_t)now.tv_sec - rpcs->sent_tv.tv_sec) +
+            now.tv_usec - rpcs->sent_tv.tv_usec;
+
+    te_hist_add(&rpcs->cur_stats->agent, MAX(agent, 0));
+    te_hist_add(&rpcs->cur_stats->call, duration);
+    rpcs->cur_stats = NULL;
+}
+
+/**
+ * Release statistics of RPC server, logging them as MI measurements
+ * beforehand if requested.
+ *
+ * @param rpcs          RPC server
+ * @param log           Whether statistics should be logged
+ */
+static void
+rpcserver_stats_free(rpcserver *rpcs, te_bool log)
+{
+    rpcserver_stats *stats;
+    te_mi_logger    *logger = NULL;
+    te_string        name = TE_STRING_INIT;
+
+    rpcs->cur_stats = NULL;
+    if (rpcs->stats == NULL)
+        return;
+
+    if (log && te_mi_logger_meas_create("rpcserver", &logger) == 0)
+        te_mi_logger_add_meas_key(logger, NULL, "rpcserver", "%s",
+                                  rpcs->name);
+
+    while ((stats = rpcs->stats) != NULL)
+    {
+        if (logger != NULL)
+        {
+            te_string_reset(&name);
+            te_string_append(&name, "%s agent", stats->info->name);
+            te_hist_mi_add(logger, NULL, &stats->agent, TE_MI_MEAS_LATENCY,
+                           name.ptr, TE_MI_MEAS_MULTIPLIER_MICRO);
+
+            te_string_reset(&name);
+            te_string_append(&name, "%s call", stats->info->name);
+            te_hist_mi_add(logger, NULL, &stats->call, TE_MI_MEAS_LATENCY,
+                           name.ptr, TE_MI_MEAS_MULTIPLIER_MICRO);
+        }
+
+        rpcs->stats = stats->next;
+        free(stats);
+    }
+
+    te_string_free(&name);
+    te_mi_logger_destroy(logger);
+}
+
 /**
  * Get some properties of common out argument.
  *
@@ -689,12 +837,13 @@ send_response(const rpcserver *rpcs, struct rcf_comm_connection *conn,
  * @param len           Buffer length.
  * @param jobid         Where to save jobid property.
  * @param unsolicited   Where to save unsolicited property.
+ * @param duration      Where to save duration property.
  *
  * @return Status code.
  */
 static te_errno
-get_out_arg_props(void *rpc_buf, size_t len,
-                  uint64_t *jobid, te_bool *unsolicited)
+get_out_arg_props(void *rpc_buf, size_t len, uint64_t *jobid,
+                  te_bool *unsolicited, uint32_t *duration)
 {
     XDR           xdr;
     tarpc_out_arg out_arg;
@@ -708,6 +857,7 @@ get_out_arg_props(void *rpc_buf, size_t len,
     {
         *jobid = out_arg.jobid;
         *unsolicited = out_arg.unsolicited;
+        *duration = out_arg.duration;
     }
 
     xdr.x_op = XDR_FREE;
@@ -757,6 +907,7 @@ dispatch(void *arg)
         {
             uint64_t jobid;
             te_bool  unsolicited;
+            uint32_t duration;
 
             if (rpcs->dead || (rpcs->sent == 0 && !rpcs->async_call))
                 continue;
@@ -798,7 +949,8 @@ dispatch(void *arg)
                 continue;
             }
 
-            rc = get_out_arg_props(rpc_buf, len, &jobid, &unsolicited);
+            rc = get_out_arg_props(rpc_buf, len, &jobid, &unsolicited,
+                                   &duration);
             if (rc != 0)
             {
                 ERROR("Cannot get out argument properties: %r", rc);
@@ -821,6 +973,7 @@ dispatch(void *arg)
             }
 
             send_response(rpcs, conn_saved, rpc_buf, len);
+            rpcserver_stats_update(rpcs, duration);
 
             if (rpcs->timeout == 0xFFFFFFFF) /* execve() */
             {
@@ -911,6 +1064,7 @@ rcf_pch_rpc_atfork(void)
     for (rpcs = list; rpcs != NULL; rpcs = next)
     {
         next = rpcs->next;
+        rpcserver_stats_free(rpcs, FALSE);
         free(rpcs);
     }
     list = NULL;
@@ -936,6 +1090,7 @@ rcf_pch_rpc_shutdown(void)
         next = rpcs->next;
         if (rpcs->tid == 0)
             rcf_ch_kill_process(rpcs->pid);
+        rpcserver_stats_free(rpcs, TRUE);
         free(rpcs);
     }
     list = NULL;
@@ -1379,6 +1534,131 @@ rpcserver_sid_set(unsigned int gid, const char *oid, const char *value,
     return rc;
 }
 
+/**
+ * Get summary of RPC function latency statistics.
+ *
+ * @param value         value location
+ * @param name          RPC server name
+ * @param rpc_name      RPC function name
+ * @param call          Whether duration of calls in RPC server should
+ *                      be reported instead of time spent on TA
+ *
+ * @return Status code
+ */
+static te_errno
+rpcserver_stats_summary(char *value, const char *name,
+                        const char *rpc_name, te_bool call)
+{
+    te_string        str = TE_STRING_EXT_BUF_INIT(value, RCF_MAX_VAL);
+    rpcserver       *rpcs;
+    rpcserver_stats *stats = NULL;
+    te_errno         rc;
+
+    pthread_mutex_lock(&lock);
+
+    rpcs = rcf_pch_find_rpcserver(name);
+    if (rpcs != NULL)
+        stats = rpcserver_stats_find(rpcs, rpc_name, FALSE);
+    if (stats == NULL)
+    {
+        pthread_mutex_unlock(&lock);
+        return TE_RC(TE_RCF_PCH, TE_ENOENT);
+    }
+
+    rc = te_hist_summary(call ? &stats->call : &stats->agent, &str);
+
+    pthread_mutex_unlock(&lock);
+
+    return rc;
+}
+
+/**
+ * Get latency statistics of RPC function on TA.
+ *
+ * @param gid           group identifier (unused)
+ * @param oid           full object instance identifier (unused)
+ * @param value         value location
+ * @param name          RPC server name
+ * @param rpc_name      RPC function name
+ *
+ * @return Status code
+ */
+static te_errno
+rpcserver_stats_get(unsigned int gid, const char *oid, char *value,
+                    const char *name, const char *rpc_name)
+{
+    UNUSED(gid);
+    UNUSED(oid);
+
+    return rpcserver_stats_summary(value, name, rpc_name, FALSE);
+}
+
+/**
+ * Get statistics of RPC function duration in RPC server.
+ *
+ * @param gid           group identifier (unused)
+ * @param oid           full object instance identifier (unused)
+ * @param value         value location
+ * @param name          RPC server name
+ * @param rpc_name      RPC function name
+ *
+ * @return Status code
+ */
+static te_errno
+rpcserver_stats_call_get(unsigned int gid, const char *oid, char *value,
+                         const char *name, const char *rpc_name)
+{
+    UNUSED(gid);
+    UNUSED(oid);
+
+    return rpcserver_stats_summary(value, name, rpc_name, TRUE);
+}
+
+/**
+ * Get list of RPC functions which have latency statistics.
+ *
+ * @param gid           group identifier (unused)
+ * @param oid           full object instance identifier (unused)
+ * @param sub_id        ID of the object to be listed (unused)
+ * @param list          location for the list pointer
+ * @param name          RPC server name
+ *
+ * @return Status code
+ */
+static te_errno
+rpcserver_stats_list(unsigned int gid, const char *oid, const char *sub_id,
+                     char **list, const char *name)
+{
+    te_string        str = TE_STRING_INIT;
+    rpcserver       *rpcs;
+    rpcserver_stats *stats;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(sub_id);
+
+    pthread_mutex_lock(&lock);
+
+    rpcs = rcf_pch_find_rpcserver(name);
+    if (rpcs == NULL)
+    {
+        pthread_mutex_unlock(&lock);
+        return TE_RC(TE_RCF_PCH, TE_ENOENT);
+    }
+
+    for (stats = rpcs->stats; stats != NULL; stats = stats->next)
+    {
+        te_string_append(&str, "%s%s", str.len == 0 ? "" : " ",
+                         stats->info->name);
+    }
+
+    pthread_mutex_unlock(&lock);
+
+    te_string_move(list, &str);
+
+    return 0;
+}
+
 
 /**
  * Get RPC server value (father name).
@@ -1748,6 +2028,7 @@ rpcserver_del(unsigned int gid, const char *oid, const char *name)
     rpc_transport_close(rpcs->handle);
     pthread_mutex_unlock(&lock);
 
+    rpcserver_stats_free(rpcs, TRUE);
     free(rpcs);
 
     return rc;
@@ -1833,12 +2114,15 @@ rcf_pch_rpc(struct rcf_comm_connection *conn, int sid,
     int        n;
     te_errno   rc;
 
+    struct timeval received;
+
     char         rpc_name[RCF_MAX_NAME];
     tarpc_in_arg common_arg;
     char enc_result[RCF_MAX_VAL];
     size_t enc_len = sizeof(enc_result);
 
     conn_saved = conn;
+    gettimeofday(&received, NULL);
 
 #define RETERR(_rc) \
     do {                                                        \
@@ -1906,6 +2190,16 @@ rcf_pch_rpc(struct rcf_comm_connection *conn, int sid,
         te_strlcpy(rpcs->last_rpc_name, rpc_name, RCF_MAX_NAME);
     }
 
+    if (common_arg.op == RCF_RPC_CALL_WAIT && !is_special_rpc(rpc_name))
+    {
+        rpcs->cur_stats = rpcserver_stats_find(rpcs, rpc_name, TRUE);
+        rpcs->sent_tv = received;
+    }
+    else
+    {
+        rpcs->cur_stats = NULL;
+    }
+
     rpcs->sent = time(NULL);
     rpcs->last_sid = sid;
     rpcs->timeout = timeout == 0xFFFFFFFF ? timeout : timeout / 1000;
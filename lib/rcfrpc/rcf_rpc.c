@@ -63,10 +63,128 @@
 #include "rpc_xdr.h"
 #include "tarpc.h"
 #include "te_rpc_errno.h"
+#include "rcf_rpc_direct.h"
+#include "rcf_rpc_shm.h"
+#include "te_hist.h"
 
+/**
+ * Name of the environment variable which enables collection of RPC
+ * latency statistics in the test process.
+ */
+#define RCF_RPC_STATS_ENV   "TE_RCF_RPC_STATS"
+
+/** Latency statistics of one RPC function called by the test */
+typedef struct rcf_rpc_stats {
+    struct rcf_rpc_stats *next;                 /**< Next function */
+    char                  name[RCF_MAX_NAME];   /**< RPC function name */
+    te_hist               hist;                 /**< Time of blocking
+                                                     calls, usec */
+} rcf_rpc_stats;
+
+/** Per-function RPC latency statistics */
+static rcf_rpc_stats *rpc_stats;
+
+#ifdef HAVE_PTHREAD_H
+/** Lock protecting RPC latency statistics */
+static pthread_mutex_t rpc_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 static rcf_rpc_server_hooks rcf_rpc_server_hooks_list;
 
+/**
+ * Log RPC latency statistics as MI measurements and release them.
+ * It is called at exit.
+ */
+static void
+rcf_rpc_stats_log(void)
+{
+    rcf_rpc_stats *stats;
+    te_mi_logger  *logger = NULL;
+
+    if (rpc_stats == NULL)
+        return;
+
+    if (te_mi_logger_meas_create("rcfrpc", &logger) != 0)
+        logger = NULL;
+
+    while ((stats = rpc_stats) != NULL)
+    {
+        if (logger != NULL)
+        {
+            te_hist_mi_add(logger, NULL, &stats->hist, TE_MI_MEAS_LATENCY,
+                           stats->name, TE_MI_MEAS_MULTIPLIER_MICRO);
+        }
+
+        rpc_stats = stats->next;
+        free(stats);
+    }
+
+    te_mi_logger_destroy(logger);
+}
+
+/**
+ * Check whether RPC latency statistics should be collected.
+ *
+ * @return @c TRUE if statistics are enabled.
+ */
+static te_bool
+rcf_rpc_stats_enabled(void)
+{
+    static int enabled = -1;
+
+    if (enabled < 0)
+    {
+        const char *env = getenv(RCF_RPC_STATS_ENV);
+
+        enabled = (env != NULL && strcmp(env, "yes") == 0);
+        if (enabled)
+            atexit(rcf_rpc_stats_log);
+    }
+
+    return enabled;
+}
+
+/**
+ * Account time of a blocking RPC in latency statistics.
+ *
+ * @param proc          RPC function name
+ * @param start         Time when the call was started
+ */
+static void
+rcf_rpc_stats_add(const char *proc, const struct timeval *start)
+{
+    struct timeval  now;
+    int64_t         usec;
+    rcf_rpc_stats  *stats;
+
+    gettimeofday(&now, NULL);
+    usec = TE_SEC2US((int64_t)now.tv_sec - start->tv_sec) +
+           now.tv_usec - start->tv_usec;
+
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&rpc_stats_lock);
+#endif
+    for (stats = rpc_stats; stats != NULL; stats = stats->next)
+    {
+        if (strcmp(stats->name, proc) == 0)
+            break;
+    }
+
+    if (stats == NULL && (stats = malloc(sizeof(*stats))) != NULL)
+    {
+        te_strlcpy(stats->name, proc, sizeof(stats->name));
+        te_hist_init(&stats->hist);
+        stats->next = rpc_stats;
+        rpc_stats = stats;
+    }
+
+    if (stats != NULL)
+        te_hist_add(&stats->hist, MAX(usec, 0));
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&rpc_stats_lock);
+#endif
+}
+
 
 /** Initialize mutex and forwarding semaphore for RPC server */
 static int
@@ -306,6 +424,8 @@ rcf_rpc_server_get(const char *ta, const char *name,
          */
         save_sid = TRUE;
         /* Restart it */
+        rcf_rpc_direct_close(ta, name);
+        rcf_rpc_shm_forget(ta, name);
         if ((rc = cfg_del_instance_fmt(FALSE, "/agent:%s/rpcserver:%s",
                                        ta, name)) != 0)
         {
@@ -610,6 +730,9 @@ rcf_rpc_server_destroy(rcf_rpc_server *rpcs)
         ERROR("%s(): pthread_mutex_lock() failed", __FUNCTION__);
 #endif
 
+    rcf_rpc_direct_close(rpcs->ta, rpcs->name);
+    rcf_rpc_shm_forget(rpcs->ta, rpcs->name);
+
     if ((rc = cfg_del_instance_fmt(FALSE, "/agent:%s/rpcserver:%s",
                                    rpcs->ta, rpcs->name)) != 0 &&
         TE_RC_GET_ERROR(rc) != TE_ENOENT)
@@ -643,6 +766,9 @@ rcf_rpc_call(rcf_rpc_server *rpcs, const char *proc,
 
     te_bool     op_is_done;
     te_bool     is_alive;
+    te_bool     account;
+
+    struct timeval  start;
 
     if (rpcs == NULL)
     {
@@ -727,9 +853,17 @@ rcf_rpc_call(rcf_rpc_server *rpcs, const char *proc,
     if (!op_is_done && !is_alive)
         strcpy(rpcs->proc, proc);
 
+    account = (!op_is_done && !is_alive && rpcs->op == RCF_RPC_CALL_WAIT &&
+               rcf_rpc_stats_enabled());
+    if (account)
+        gettimeofday(&start, NULL);
+
     rpcs->_errno = rcf_ta_call_rpc(rpcs->ta, rpcs->sid, rpcs->name,
                                    rpcs->timeout, proc, in, out);
 
+    if (account && rpcs->_errno == 0)
+        rcf_rpc_stats_add(proc, &start);
+
     if (rpcs->op != RCF_RPC_CALL)
         rpcs->timeout = RCF_RPC_UNSPEC_TIMEOUT;
     rpcs->start = 0;
@@ -950,6 +1084,25 @@ rcf_ta_call_rpc(const char *ta_name, int session,
         }
     }
 
+    if (rcf_rpc_direct_applicable(rpc_name, timeout, in))
+    {
+        rc = rcf_rpc_direct_call(ta_name, session, rpcserver, timeout,
+                                 rpc_name, (uint8_t *)msg->file, len, out);
+        if (TE_RC_GET_ERROR(rc) != TE_ENOTCONN)
+        {
+            if ((char *)msg != msg_buf)
+                free(msg);
+            return rc;
+        }
+    }
+    else if (strcmp(rpc_name, "execve") == 0 ||
+             strcmp(rpc_name, "execve_gen") == 0)
+    {
+        /* The direct stream and buffers do not survive the new image */
+        rcf_rpc_direct_close(ta_name, rpcserver);
+        rcf_rpc_shm_forget(ta_name, rpcserver);
+    }
+
     memset(msg, 0, PREFIX_LEN);
     msg->opcode = RCFOP_RPC;
     msg->sid = session;
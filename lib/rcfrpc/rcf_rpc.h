@@ -505,6 +505,52 @@ extern te_errno rcf_rpc_server_is_op_done(rcf_rpc_server *rpcs,
  */
 extern te_bool rcf_rpc_server_is_alive(rcf_rpc_server *rpcs);
 
+/**
+ * Map a buffer of RPC server backed by a shared memory object to the
+ * test address space. It is possible only if the test and RPC server
+ * run on the same host; the object name is unlinked on success.
+ *
+ * @param rpcs          RPC server handle
+ * @param ptr           Buffer identifier in RPC server
+ * @param shm_name      Name of the shared memory object
+ * @param size          Size of the buffer
+ *
+ * @return Status code
+ */
+extern te_errno rcf_rpc_shm_map(rcf_rpc_server *rpcs, rpc_ptr ptr,
+                                const char *shm_name, size_t size);
+
+/**
+ * Unmap a buffer of RPC server mapped by rcf_rpc_shm_map().
+ * It does nothing if the buffer is not mapped.
+ *
+ * @param rpcs          RPC server handle
+ * @param ptr           Buffer identifier in RPC server
+ */
+extern void rcf_rpc_shm_unmap(rcf_rpc_server *rpcs, rpc_ptr ptr);
+
+/**
+ * Copy data to or from a buffer of RPC server mapped by
+ * rcf_rpc_shm_map() without calling RPC. RPC server handle is updated
+ * as if @p proc was called by rcf_rpc_call(). Nothing is done if
+ * the buffer is not mapped, the range is out of its bounds or the
+ * operation is not blocking.
+ *
+ * @param rpcs          RPC server handle
+ * @param proc          Name of RPC which is substituted
+ * @param ptr           Buffer identifier in RPC server
+ * @param off           Offset in the buffer
+ * @param buf           Local buffer
+ * @param len           Number of bytes to copy
+ * @param to_rpcs       Copy from @p buf to RPC server buffer if @c TRUE,
+ *                      in the opposite direction otherwise
+ *
+ * @return @c TRUE if data is copied, @c FALSE if RPC should be called.
+ */
+extern te_bool rcf_rpc_shm_copy(rcf_rpc_server *rpcs, const char *proc,
+                                rpc_ptr ptr, size_t off, void *buf,
+                                size_t len, te_bool to_rpcs);
+
 /** Free memory allocated by rcf_rpc_call */
 static inline void
 rcf_rpc_free_result(void *out_arg, xdrproc_t out_proc)
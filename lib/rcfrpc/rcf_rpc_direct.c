@@ -0,0 +1,631 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief SUN RPC control interface
+ *
+ * Direct streams from Test Engine to RPC servers. Blocking calls are
+ * sent to RPC server over a separate TCP connection without RCF and
+ * Test Agent in the middle; RCF is still used to create, fork and kill
+ * RPC servers and to track their state.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "RCF RPC"
+#include "te_config.h"
+
+#include <stdio.h>
+
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#ifdef HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif
+#ifdef HAVE_NETINET_TCP_H
+#include <netinet/tcp.h>
+#endif
+#ifdef HAVE_NETDB_H
+#include <netdb.h>
+#endif
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "te_defs.h"
+#include "te_stdint.h"
+#include "te_errno.h"
+#include "te_str.h"
+#include "logger_api.h"
+#include "conf_api.h"
+#include "rcf_api.h"
+#include "rcf_rpc.h"
+#include "rpc_xdr.h"
+#include "tarpc.h"
+#include "rcf_rpc_direct.h"
+
+/** Timeout of connecting the direct stream, in milliseconds */
+#define RCF_RPC_DIRECT_CONNECT_TIMEOUT  10000
+
+/** Direct stream to RPC server */
+typedef struct rcf_rpc_direct {
+    struct rcf_rpc_direct  *next;           /**< Next stream in the list */
+
+    char        ta[RCF_MAX_NAME];           /**< Test Agent name */
+    char        name[RCF_MAX_NAME];         /**< RPC server name */
+    int         sock;                       /**< Connected socket or -1 */
+    te_bool     unavailable;                /**< Direct stream may not be
+                                                 established, calls go
+                                                 via RCF */
+    pthread_mutex_t lock;                   /**< Serializes calls */
+} rcf_rpc_direct;
+
+/** List of direct streams */
+static rcf_rpc_direct *streams = NULL;
+
+/** Lock protecting the list of direct streams */
+static pthread_mutex_t streams_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Calls which change the set of RPC servers or their state */
+static const char * const control_rpcs[] = {
+    "rpc_is_op_done",
+    "rpc_is_alive",
+    "rpc_direct",
+    "rpc_batch",
+    "create_process",
+    "vfork",
+    "thread_create",
+    "thread_cancel",
+    "thread_join",
+    "execve",
+    "execve_gen",
+    NULL
+};
+
+/* See description in rcf_rpc_direct.h */
+te_bool
+rcf_rpc_direct_applicable(const char *rpc_name, unsigned int timeout,
+                          const void *in)
+{
+    static int enabled = -1;
+
+    const char * const *control;
+
+    if (enabled < 0)
+    {
+        const char *env = getenv(RCF_RPC_DIRECT_ENV);
+
+        enabled = (env != NULL && strcmp(env, "yes") == 0);
+    }
+    if (!enabled)
+        return FALSE;
+
+    if (((const tarpc_in_arg *)in)->op != RCF_RPC_CALL_WAIT ||
+        timeout == 0xFFFFFFFF)
+        return FALSE;
+
+    for (control = control_rpcs; *control != NULL; control++)
+    {
+        if (strcmp(rpc_name, *control) == 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Find the direct stream to RPC server.
+ *
+ * @param ta_name       Test Agent name
+ * @param rpcserver     Name of the RPC server
+ * @param create        Create the entry if it does not exist
+ *
+ * @return Direct stream or @c NULL.
+ */
+static rcf_rpc_direct *
+direct_find(const char *ta_name, const char *rpcserver, te_bool create)
+{
+    rcf_rpc_direct *d;
+
+    pthread_mutex_lock(&streams_lock);
+
+    for (d = streams; d != NULL; d = d->next)
+    {
+        if (strcmp(d->ta, ta_name) == 0 && strcmp(d->name, rpcserver) == 0)
+            break;
+    }
+
+    if (d == NULL && create)
+    {
+        d = calloc(1, sizeof(*d));
+        if (d != NULL)
+        {
+            TE_STRLCPY(d->ta, ta_name, sizeof(d->ta));
+            TE_STRLCPY(d->name, rpcserver, sizeof(d->name));
+            d->sock = -1;
+            pthread_mutex_init(&d->lock, NULL);
+            d->next = streams;
+            streams = d;
+        }
+    }
+
+    pthread_mutex_unlock(&streams_lock);
+
+    return d;
+}
+
+/**
+ * Get the address of the host where Test Agent is running from
+ * its RCF configuration. Agents started via SSH proxy and agents
+ * which are not described in the configuration tree are not reachable
+ * directly.
+ *
+ * @param ta_name       Test Agent name
+ * @param host          Buffer for host name
+ * @param size          Size of the buffer
+ *
+ * @return Status code.
+ */
+static te_errno
+direct_get_host(const char *ta_name, char *host, size_t size)
+{
+    char       *val = NULL;
+    te_errno    rc;
+
+    rc = cfg_get_string(&val, "/rcf:/agent:%s/conf:ssh_proxy", ta_name);
+    if (rc == 0)
+    {
+        te_bool proxy = !te_str_is_null_or_empty(val);
+
+        free(val);
+        if (proxy)
+            return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    rc = cfg_get_string(&val, "/rcf:/agent:%s/conf:connect", ta_name);
+    if (rc != 0 || te_str_is_null_or_empty(val))
+    {
+        free(val);
+        val = NULL;
+        rc = cfg_get_string(&val, "/rcf:/agent:%s/conf:host", ta_name);
+        if (rc != 0)
+            return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    te_strlcpy(host, te_str_is_null_or_empty(val) ? "127.0.0.1" : val,
+               size);
+    free(val);
+
+    return 0;
+}
+
+/**
+ * Send a message framed in the same way as lib/rpctransport does it:
+ * 4-byte length in network byte order followed by data.
+ *
+ * @param sock          Socket
+ * @param buf           Message
+ * @param len           Message length
+ *
+ * @return Status code.
+ */
+static te_errno
+direct_send(int sock, const uint8_t *buf, size_t len)
+{
+    uint32_t        hdr = htonl(len);
+    struct iovec    iov[2];
+    struct msghdr   msg;
+    ssize_t         rc;
+
+    iov[0].iov_base = &hdr;
+    iov[0].iov_len = sizeof(hdr);
+    iov[1].iov_base = (void *)buf;
+    iov[1].iov_len = len;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = TE_ARRAY_LEN(iov);
+
+    while (msg.msg_iovlen > 0)
+    {
+        rc = sendmsg(sock, &msg, MSG_NOSIGNAL);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return TE_OS_RC(TE_RCF_API, errno);
+        }
+
+        while (msg.msg_iovlen > 0 && (size_t)rc >= msg.msg_iov->iov_len)
+        {
+            rc -= msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0)
+        {
+            msg.msg_iov->iov_base = (uint8_t *)msg.msg_iov->iov_base + rc;
+            msg.msg_iov->iov_len -= rc;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Receive exactly @p len bytes before the deadline.
+ *
+ * @param sock          Socket
+ * @param buf           Buffer
+ * @param len           Number of bytes to receive
+ * @param deadline      Deadline (milliseconds since Epoch) or 0
+ *
+ * @return Status code.
+ * @retval TE_ERPCTIMEOUT       Deadline is reached
+ * @retval TE_ECONNRESET        Connection is broken
+ */
+static te_errno
+direct_recv(int sock, uint8_t *buf, size_t len, uint64_t deadline)
+{
+    struct pollfd   pfd;
+    struct timeval  tv;
+    uint64_t        now;
+    ssize_t         rc;
+    int             wait;
+
+    while (len > 0)
+    {
+        wait = -1;
+        if (deadline != 0)
+        {
+            gettimeofday(&tv, NULL);
+            now = (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+            if (now >= deadline)
+                return TE_RC(TE_RCF_API, TE_ERPCTIMEOUT);
+            wait = deadline - now;
+        }
+
+        pfd.fd = sock;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        rc = poll(&pfd, 1, wait);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return TE_OS_RC(TE_RCF_API, errno);
+        }
+        if (rc == 0)
+            continue;
+
+        rc = recv(sock, buf, len, 0);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return TE_RC(TE_RCF_API, TE_ECONNRESET);
+
+        buf += rc;
+        len -= rc;
+    }
+
+    return 0;
+}
+
+/**
+ * Connect the socket with timeout, so that the caller is not blocked
+ * for long by an unreachable RPC server host.
+ *
+ * @param s             Socket
+ * @param addr          Address to connect to
+ * @param addrlen       Length of the address
+ * @param timeout       Timeout in milliseconds
+ *
+ * @return Status code.
+ */
+static te_errno
+direct_connect_sock(int s, const struct sockaddr *addr, socklen_t addrlen,
+                    int timeout)
+{
+    struct pollfd   pfd;
+    socklen_t       optlen = sizeof(int);
+    int             flags;
+    int             err = 0;
+    int             rc;
+
+    flags = fcntl(s, F_GETFL);
+    if (flags < 0 || fcntl(s, F_SETFL, flags | O_NONBLOCK) < 0)
+        return TE_OS_RC(TE_RCF_API, errno);
+
+    if (connect(s, addr, addrlen) != 0)
+    {
+        if (errno != EINPROGRESS)
+            return TE_OS_RC(TE_RCF_API, errno);
+
+        pfd.fd = s;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        do {
+            rc = poll(&pfd, 1, timeout);
+        } while (rc < 0 && errno == EINTR);
+        if (rc < 0)
+            return TE_OS_RC(TE_RCF_API, errno);
+        if (rc == 0)
+            return TE_RC(TE_RCF_API, TE_ETIMEDOUT);
+
+        if (getsockopt(s, SOL_SOCKET, SO_ERROR, &err, &optlen) != 0)
+            return TE_OS_RC(TE_RCF_API, errno);
+        if (err != 0)
+            return TE_OS_RC(TE_RCF_API, err);
+    }
+
+    /* Calls are sent and received over the blocking socket */
+    if (fcntl(s, F_SETFL, flags) < 0)
+        return TE_OS_RC(TE_RCF_API, errno);
+
+    return 0;
+}
+
+/**
+ * Establish the direct stream: ask RPC server to listen for it via RCF,
+ * connect and send the cookie.
+ *
+ * @param d             Direct stream
+ * @param session       TA session
+ *
+ * @return Status code.
+ */
+static te_errno
+direct_connect(rcf_rpc_direct *d, int session)
+{
+    tarpc_rpc_direct_in     in;
+    tarpc_rpc_direct_out    out;
+    struct addrinfo         hints;
+    struct addrinfo        *ai = NULL;
+    char                    host[RCF_MAX_VAL];
+    char                    port[16];
+    uint8_t                 cookie[sizeof(out.cookie)];
+    unsigned int            i;
+    int                     one = 1;
+    int                     s;
+    te_errno                rc;
+
+    rc = direct_get_host(d->ta, host, sizeof(host));
+    if (rc != 0)
+        return rc;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, NULL, &hints, &ai) != 0 || ai == NULL)
+    {
+        WARN("Failed to resolve '%s' to connect direct RPC stream", host);
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+    in.common.op = RCF_RPC_CALL_WAIT;
+    in.common.lib_flags = TARPC_LIB_DEFAULT;
+    /* RPC server listens on the address the agent is connected via */
+    in.addr = ntohl(((struct sockaddr_in *)ai->ai_addr)->sin_addr.s_addr);
+
+    rc = rcf_ta_call_rpc(d->ta, session, d->name,
+                         RCF_RPC_DIRECT_CONNECT_TIMEOUT,
+                         "rpc_direct", &in, &out);
+    if (rc == 0)
+        rc = out.common._errno;
+    if (rc != 0)
+    {
+        WARN("RPC server %s:%s does not provide direct stream: %r",
+             d->ta, d->name, rc);
+        freeaddrinfo(ai);
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    TE_SPRINTF(port, "%u", out.port);
+    ((struct sockaddr_in *)ai->ai_addr)->sin_port = htons(out.port);
+
+    s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (s < 0)
+        rc = TE_OS_RC(TE_RCF_API, errno);
+    else
+        rc = direct_connect_sock(s, ai->ai_addr, ai->ai_addrlen,
+                                 RCF_RPC_DIRECT_CONNECT_TIMEOUT);
+    if (rc != 0)
+    {
+        WARN("Failed to connect direct RPC stream to %s:%s: %r",
+             host, port, rc);
+        if (s >= 0)
+            close(s);
+        freeaddrinfo(ai);
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+    freeaddrinfo(ai);
+
+    (void)fcntl(s, F_SETFD, FD_CLOEXEC);
+    (void)setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    /* Cookie is sent in network byte order */
+    for (i = 0; i < sizeof(cookie); i++)
+        cookie[i] = out.cookie >> (8 * (sizeof(cookie) - 1 - i));
+
+    rc = direct_send(s, cookie, sizeof(cookie));
+    if (rc != 0)
+    {
+        close(s);
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    d->sock = s;
+    RING("Direct stream to RPC server %s:%s is established via %s:%s",
+         d->ta, d->name, host, port);
+
+    return 0;
+}
+
+/**
+ * Close the socket of the direct stream.
+ *
+ * @param d             Direct stream
+ */
+static void
+direct_disconnect(rcf_rpc_direct *d)
+{
+    if (d->sock >= 0)
+    {
+        close(d->sock);
+        d->sock = -1;
+    }
+}
+
+/**
+ * Let Test Agent know that RPC server does not respond on the direct
+ * stream, so that it is restarted in the same way as if the call
+ * timed out in RCF.
+ *
+ * @param d             Direct stream
+ */
+static void
+direct_mark_dead(rcf_rpc_direct *d)
+{
+    te_errno rc;
+
+    rc = cfg_set_instance_fmt(CFG_VAL(INT32, 1),
+                              "/agent:%s/rpcserver:%s/dead:",
+                              d->ta, d->name);
+    if (rc != 0)
+    {
+        ERROR("Failed to mark RPC server %s:%s dead: %r",
+              d->ta, d->name, rc);
+    }
+}
+
+/* See description in rcf_rpc_direct.h */
+te_errno
+rcf_rpc_direct_call(const char *ta_name, int session,
+                    const char *rpcserver, unsigned int timeout,
+                    const char *rpc_name, const uint8_t *buf, size_t len,
+                    void *out)
+{
+    rcf_rpc_direct *d;
+    uint8_t        *ans = NULL;
+    uint32_t        hdr;
+    uint64_t        deadline = 0;
+    struct timeval  tv;
+    te_errno        rc;
+
+    d = direct_find(ta_name, rpcserver, TRUE);
+    if (d == NULL)
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+
+    pthread_mutex_lock(&d->lock);
+
+    if (d->unavailable)
+    {
+        pthread_mutex_unlock(&d->lock);
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    if (d->sock < 0 && direct_connect(d, session) != 0)
+    {
+        d->unavailable = TRUE;
+        pthread_mutex_unlock(&d->lock);
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    /*
+     * Nothing is delivered if sending fails, so the call may be
+     * retried via RCF.
+     */
+    if (direct_send(d->sock, buf, len) != 0)
+    {
+        direct_disconnect(d);
+        pthread_mutex_unlock(&d->lock);
+        return TE_RC(TE_RCF_API, TE_ENOTCONN);
+    }
+
+    if (timeout != 0)
+    {
+        gettimeofday(&tv, NULL);
+        deadline = (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000 +
+                   timeout;
+    }
+
+    rc = direct_recv(d->sock, (uint8_t *)&hdr, sizeof(hdr), deadline);
+    if (rc == 0)
+    {
+        hdr = ntohl(hdr);
+        if (hdr > RCF_RPC_HUGE_BUF_LEN || (ans = malloc(hdr)) == NULL)
+            rc = TE_RC(TE_RCF_API, TE_ENOMEM);
+        else
+            rc = direct_recv(d->sock, ans, hdr, deadline);
+    }
+
+    if (rc != 0)
+    {
+        ERROR("Failed to receive %s() result from RPC server %s:%s "
+              "over direct stream: %r", rpc_name, ta_name, rpcserver, rc);
+        direct_disconnect(d);
+        direct_mark_dead(d);
+        pthread_mutex_unlock(&d->lock);
+        free(ans);
+
+        return TE_RC_GET_ERROR(rc) == TE_ERPCTIMEOUT ?
+                   TE_RC(TE_RCF_API, TE_ERPCTIMEOUT) :
+                   TE_RC(TE_RCF_API, TE_ERPCDEAD);
+    }
+
+    pthread_mutex_unlock(&d->lock);
+
+    rc = rpc_xdr_decode_result(rpc_name, ans, hdr, out);
+    if (rc != 0)
+        ERROR("Decoding of RPC %s output parameters failed: error %r",
+              rpc_name, rc);
+
+    free(ans);
+
+    return rc;
+}
+
+/* See description in rcf_rpc_direct.h */
+void
+rcf_rpc_direct_close(const char *ta_name, const char *rpcserver)
+{
+    rcf_rpc_direct *d = direct_find(ta_name, rpcserver, FALSE);
+
+    if (d == NULL)
+        return;
+
+    pthread_mutex_lock(&d->lock);
+    direct_disconnect(d);
+    /* New RPC server process may support the direct stream */
+    d->unavailable = FALSE;
+    pthread_mutex_unlock(&d->lock);
+}
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief SUN RPC control interface
+ *
+ * Direct streams from Test Engine to RPC servers (internal definitions).
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_RCF_RPC_DIRECT_H__
+#define __TE_RCF_RPC_DIRECT_H__
+
+#include "te_defs.h"
+#include "te_errno.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Name of the environment variable which enables direct streams
+ * to RPC servers.
+ */
+#define RCF_RPC_DIRECT_ENV  "TE_RCF_RPC_DIRECT"
+
+/**
+ * Check whether the call may be sent over the direct stream.
+ * Only blocking calls with finite timeout which do not change
+ * the set of RPC servers go there, everything else is passed via RCF
+ * which tracks RPC servers state.
+ *
+ * @param rpc_name      Name of the RPC
+ * @param timeout       RPC timeout in milliseconds
+ * @param in            Input parameter C structure
+ *
+ * @return @c TRUE if the call may go over the direct stream.
+ */
+extern te_bool rcf_rpc_direct_applicable(const char *rpc_name,
+                                         unsigned int timeout,
+                                         const void *in);
+
+/**
+ * Call RPC over the direct stream to RPC server. The stream is
+ * established on the first call via RCF and kept open.
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session
+ * @param rpcserver     Name of the RPC server
+ * @param timeout       RPC timeout in milliseconds or 0 (unlimited)
+ * @param rpc_name      Name of the RPC (e.g. "bind")
+ * @param buf           Encoded call
+ * @param len           Length of the encoded call
+ * @param out           Output parameter C structure
+ *
+ * @return Status code.
+ * @retval TE_ENOTCONN  Direct stream is not available and the call is
+ *                      not sent, it should be passed via RCF
+ */
+extern te_errno rcf_rpc_direct_call(const char *ta_name, int session,
+                                    const char *rpcserver,
+                                    unsigned int timeout,
+                                    const char *rpc_name,
+                                    const uint8_t *buf, size_t len,
+                                    void *out);
+
+/**
+ * Close the direct stream to RPC server, if any. It should be done
+ * when RPC server is destroyed or replaced by another process.
+ *
+ * @param ta_name       Test Agent name
+ * @param rpcserver     Name of the RPC server
+ */
+extern void rcf_rpc_direct_close(const char *ta_name,
+                                 const char *rpcserver);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_RCF_RPC_DIRECT_H__ */
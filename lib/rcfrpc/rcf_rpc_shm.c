@@ -0,0 +1,269 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief SUN RPC control interface
+ *
+ * Local mappings of RPC server buffers backed by POSIX shared memory
+ * objects. If the test runs on the same host as RPC server, such
+ * buffers are mapped to the test address space and data is copied
+ * to/from them directly instead of passing it via RCF and Test Agent.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "RCF RPC"
+#include "te_config.h"
+
+#include <stdio.h>
+
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "te_defs.h"
+#include "te_stdint.h"
+#include "te_errno.h"
+#include "te_str.h"
+#include "logger_api.h"
+#include "rcf_rpc.h"
+#include "rcf_rpc_shm.h"
+
+/** Buffer of RPC server mapped to the test address space */
+typedef struct rcf_rpc_shm {
+    struct rcf_rpc_shm *next;               /**< Next buffer in the list */
+
+    char        ta[RCF_MAX_NAME];           /**< Test Agent name */
+    char        name[RCF_MAX_NAME];         /**< RPC server name */
+    rpc_ptr     ptr;                        /**< Buffer identifier in
+                                                 RPC server */
+    uint8_t    *addr;                       /**< Local address */
+    size_t      size;                       /**< Size of the buffer */
+} rcf_rpc_shm;
+
+/** List of mapped buffers */
+static rcf_rpc_shm *buffers = NULL;
+
+/** Lock protecting the list of mapped buffers */
+static pthread_mutex_t buffers_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Find mapped buffer and optionally remove it from the list.
+ * Should be called under the lock.
+ *
+ * @param ta_name       Test Agent name
+ * @param rpcserver     Name of the RPC server
+ * @param ptr           Buffer identifier
+ * @param remove        Remove the buffer from the list
+ *
+ * @return Buffer or @c NULL.
+ */
+static rcf_rpc_shm *
+rcf_rpc_shm_find(const char *ta_name, const char *rpcserver, rpc_ptr ptr,
+                 te_bool remove)
+{
+    rcf_rpc_shm **p;
+    rcf_rpc_shm  *shm;
+
+    for (p = &buffers; (shm = *p) != NULL; p = &shm->next)
+    {
+        if (shm->ptr == ptr && strcmp(shm->name, rpcserver) == 0 &&
+            strcmp(shm->ta, ta_name) == 0)
+        {
+            if (remove)
+                *p = shm->next;
+            return shm;
+        }
+    }
+
+    return NULL;
+}
+
+/* See description in rcf_rpc.h */
+te_errno
+rcf_rpc_shm_map(rcf_rpc_server *rpcs, rpc_ptr ptr, const char *shm_name,
+                size_t size)
+{
+    rcf_rpc_shm *shm;
+    struct stat  st;
+    void        *addr;
+    int          fd;
+
+    if (rpcs == NULL || ptr == RPC_NULL || shm_name == NULL || size == 0)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    /* The object does not exist here if RPC server runs on another host */
+    fd = shm_open(shm_name, O_RDWR, 0);
+    if (fd < 0)
+        return TE_OS_RC(TE_RCF_API, errno);
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != size)
+    {
+        close(fd);
+        return TE_RC(TE_RCF_API, TE_ENOENT);
+    }
+
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return TE_OS_RC(TE_RCF_API, errno);
+
+    /*
+     * Nobody else needs the name, so do not leave the object behind
+     * if RPC server is killed.
+     */
+    shm_unlink(shm_name);
+
+    if ((shm = calloc(1, sizeof(*shm))) == NULL)
+    {
+        munmap(addr, size);
+        return TE_RC(TE_RCF_API, TE_ENOMEM);
+    }
+
+    te_strlcpy(shm->ta, rpcs->ta, sizeof(shm->ta));
+    te_strlcpy(shm->name, rpcs->name, sizeof(shm->name));
+    shm->ptr = ptr;
+    shm->addr = addr;
+    shm->size = size;
+
+    pthread_mutex_lock(&buffers_lock);
+    shm->next = buffers;
+    buffers = shm;
+    pthread_mutex_unlock(&buffers_lock);
+
+    return 0;
+}
+
+/* See description in rcf_rpc.h */
+void
+rcf_rpc_shm_unmap(rcf_rpc_server *rpcs, rpc_ptr ptr)
+{
+    rcf_rpc_shm *shm;
+
+    if (rpcs == NULL || ptr == RPC_NULL)
+        return;
+
+    pthread_mutex_lock(&buffers_lock);
+    shm = rcf_rpc_shm_find(rpcs->ta, rpcs->name, ptr, TRUE);
+    pthread_mutex_unlock(&buffers_lock);
+
+    if (shm != NULL)
+    {
+        munmap(shm->addr, shm->size);
+        free(shm);
+    }
+}
+
+/* See description in rcf_rpc.h */
+te_bool
+rcf_rpc_shm_copy(rcf_rpc_server *rpcs, const char *proc, rpc_ptr ptr,
+                 size_t off, void *buf, size_t len, te_bool to_rpcs)
+{
+    rcf_rpc_shm    *shm;
+    uint8_t        *addr = NULL;
+    struct timeval  start;
+    struct timeval  end;
+
+    if (rpcs == NULL || ptr == RPC_NULL)
+        return FALSE;
+
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&rpcs->lock);
+#endif
+
+    /*
+     * Only plain blocking calls are done locally: everything else
+     * needs RPC server to take part.
+     */
+    if (rpcs->op == RCF_RPC_CALL_WAIT && rpcs->jobid0 == 0 &&
+        rpcs->start == 0)
+    {
+        pthread_mutex_lock(&buffers_lock);
+        shm = rcf_rpc_shm_find(rpcs->ta, rpcs->name, ptr, FALSE);
+        if (shm != NULL && off <= shm->size && len <= shm->size - off)
+            addr = shm->addr + off;
+        pthread_mutex_unlock(&buffers_lock);
+    }
+
+    if (addr == NULL)
+    {
+#ifdef HAVE_PTHREAD_H
+        pthread_mutex_unlock(&rpcs->lock);
+#endif
+        return FALSE;
+    }
+
+    gettimeofday(&start, NULL);
+    if (to_rpcs)
+        memcpy(addr, buf, len);
+    else
+        memcpy(buf, addr, len);
+    gettimeofday(&end, NULL);
+
+    /* Leave RPC server handle in the same state as rcf_rpc_call() does */
+    rpcs->_errno = 0;
+    rpcs->err_msg[0] = '\0';
+    rpcs->err_log = FALSE;
+    rpcs->timed_out = FALSE;
+    rpcs->duration = TE_SEC2US(end.tv_sec - start.tv_sec) +
+                     end.tv_usec - start.tv_usec;
+    rpcs->last_op = rpcs->op;
+    rpcs->last_use_libc = rpcs->use_libc_once;
+    rpcs->use_libc_once = FALSE;
+    rpcs->timeout = RCF_RPC_UNSPEC_TIMEOUT;
+    te_strlcpy(rpcs->proc, proc, sizeof(rpcs->proc));
+
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&rpcs->lock);
+#endif
+
+    return TRUE;
+}
+
+/* See description in rcf_rpc_shm.h */
+void
+rcf_rpc_shm_forget(const char *ta_name, const char *rpcserver)
+{
+    rcf_rpc_shm **p;
+    rcf_rpc_shm  *shm;
+
+    pthread_mutex_lock(&buffers_lock);
+    for (p = &buffers; (shm = *p) != NULL; )
+    {
+        if (strcmp(shm->name, rpcserver) == 0 &&
+            strcmp(shm->ta, ta_name) == 0)
+        {
+            *p = shm->next;
+            munmap(shm->addr, shm->size);
+            free(shm);
+        }
+        else
+        {
+            p = &shm->next;
+        }
+    }
+    pthread_mutex_unlock(&buffers_lock);
+}
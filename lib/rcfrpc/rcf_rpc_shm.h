@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief SUN RPC control interface
+ *
+ * Local mappings of RPC server buffers backed by shared memory
+ * (internal definitions).
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_RCF_RPC_SHM_H__
+#define __TE_RCF_RPC_SHM_H__
+
+#include "te_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Forget all local mappings of buffers of RPC server. It should be done
+ * when RPC server is destroyed or replaced by another process, since
+ * buffer identifiers are not valid any longer.
+ *
+ * @param ta_name       Test Agent name
+ * @param rpcserver     Name of the RPC server
+ */
+extern void rcf_rpc_shm_forget(const char *ta_name, const char *rpcserver);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_RCF_RPC_SHM_H__ */
@@ -9,6 +9,9 @@
  */
 
 #include "rpc_server.h"
+#ifdef HAVE_SYS_RANDOM_H
+#include <sys/random.h>
+#endif
 #include "ta_common.h"
 #include "agentlib.h"
 #include "rpc_transport.h"
@@ -393,8 +396,9 @@ tarpc_generic_service(deferred_call_list *async_list, rpc_call_data *call)
 
     if (call->func == NULL)
     {
-        rc = tarpc_find_func(in_common->lib_flags, call->info->funcname,
-                             &call->func);
+        rc = tarpc_find_func_cached(call->info->cache,
+                                    in_common->lib_flags,
+                                    call->info->funcname, &call->func);
         if (rc != 0)
         {
             out_common->_errno = rc;
@@ -683,6 +687,272 @@ rpcserver_plugin_disable(void)
 
 #endif /* ENABLE_RPC_PLUGINS */
 
+/** Invalid direct stream handle */
+#define RPC_DIRECT_NONE ((rpc_transport_handle)-1)
+
+/**
+ * Timeout of receiving the rest of the cookie on the direct stream
+ * when its beginning is received, in seconds
+ */
+#define RPC_DIRECT_COOKIE_TIMEOUT 1
+
+/** Maximum number of accepted connections waiting for the cookie */
+#define RPC_DIRECT_PENDING_MAX 4
+
+/**
+ * Direct stream from Test Engine which bypasses RCF and Test Agent.
+ * Calls received on it are answered on it as well, control messages
+ * are still received from the Test Agent.
+ */
+typedef struct rpc_direct_stream {
+    rpc_transport_handle    listen;     /**< Listening handle */
+    rpc_transport_handle    conn;       /**< Accepted stream */
+    rpc_transport_handle    pending[RPC_DIRECT_PENDING_MAX];
+                                        /**< Accepted connections which
+                                             have not sent the cookie
+                                             yet (the oldest first) */
+    unsigned int            n_pending;  /**< Number of pending
+                                             connections */
+    uint64_t                cookie;     /**< Cookie expected on the
+                                             stream first */
+} rpc_direct_stream;
+
+/**
+ * Close the direct stream, its listening handle and connections
+ * pending for the cookie.
+ *
+ * @param direct        Direct stream
+ */
+static void
+rpc_direct_close(rpc_direct_stream *direct)
+{
+    if (direct->listen != RPC_DIRECT_NONE)
+        rpc_transport_close(direct->listen);
+    if (direct->conn != RPC_DIRECT_NONE)
+        rpc_transport_close(direct->conn);
+    while (direct->n_pending > 0)
+        rpc_transport_close(direct->pending[--direct->n_pending]);
+
+    direct->listen = direct->conn = RPC_DIRECT_NONE;
+}
+
+/**
+ * Remove a connection from the list of connections pending for
+ * the cookie.
+ *
+ * @param direct        Direct stream
+ * @param i             Index of the connection
+ *
+ * @return Removed connection handle.
+ */
+static rpc_transport_handle
+rpc_direct_pending_remove(rpc_direct_stream *direct, unsigned int i)
+{
+    rpc_transport_handle conn = direct->pending[i];
+
+    direct->n_pending--;
+    memmove(&direct->pending[i], &direct->pending[i + 1],
+            (direct->n_pending - i) * sizeof(direct->pending[0]));
+
+    return conn;
+}
+
+/**
+ * Generate unpredictable cookie of the direct stream.
+ *
+ * @param cookie        Location for the cookie
+ *
+ * @return Status code.
+ */
+static te_errno
+rpc_direct_cookie(uint64_t *cookie)
+{
+    ssize_t rc = -1;
+    int     fd;
+
+#ifdef HAVE_SYS_RANDOM_H
+    do {
+        rc = getrandom(cookie, sizeof(*cookie), 0);
+    } while (rc < 0 && errno == EINTR);
+#endif
+    if (rc != (ssize_t)sizeof(*cookie))
+    {
+        fd = open("/dev/urandom", O_RDONLY);
+        if (fd < 0)
+            return TE_OS_RC(TE_TA_UNIX, errno);
+        rc = read(fd, cookie, sizeof(*cookie));
+        close(fd);
+    }
+
+    return rc == (ssize_t)sizeof(*cookie) ? 0 : TE_RC(TE_TA_UNIX, TE_EIO);
+}
+
+/**
+ * Handle rpc_direct() call: start listening for the direct stream.
+ * The previous stream, if any, is closed.
+ *
+ * @param direct        Direct stream
+ * @param in            Input parameters
+ * @param out           Output parameters
+ *
+ * @return TRUE (output is always valid)
+ */
+static te_bool
+rpc_direct_setup(rpc_direct_stream *direct, tarpc_rpc_direct_in *in,
+                 tarpc_rpc_direct_out *out)
+{
+    rpc_direct_close(direct);
+
+    out->common._errno = rpc_direct_cookie(&direct->cookie);
+    if (out->common._errno != 0)
+    {
+        ERROR("Failed to generate cookie of direct RPC stream: %r",
+              out->common._errno);
+        return TRUE;
+    }
+
+    out->common._errno = rpc_transport_direct_listen(in->addr,
+                                                     &direct->listen,
+                                                     &out->port);
+    if (out->common._errno != 0)
+    {
+        direct->listen = RPC_DIRECT_NONE;
+        return TRUE;
+    }
+
+    out->cookie = direct->cookie;
+
+    return TRUE;
+}
+
+/**
+ * Check the cookie received on the connection accepted for the direct
+ * stream and make it the direct stream if the cookie is valid.
+ * Otherwise the connection is closed and the listening goes on.
+ *
+ * @param direct        Direct stream
+ * @param i             Index of the pending connection
+ */
+static void
+rpc_direct_check_cookie(rpc_direct_stream *direct, unsigned int i)
+{
+    rpc_transport_handle    conn = rpc_direct_pending_remove(direct, i);
+    uint8_t                 cookie[sizeof(direct->cookie)];
+    size_t                  cookie_len = sizeof(cookie);
+    uint64_t                value = 0;
+    size_t                  j;
+    te_errno                rc;
+
+    rc = rpc_transport_recv(conn, cookie, &cookie_len,
+                            RPC_DIRECT_COOKIE_TIMEOUT);
+    /* Cookie is sent in network byte order */
+    for (j = 0; j < cookie_len; j++)
+        value = (value << 8) | cookie[j];
+    if (rc != 0 || cookie_len != sizeof(cookie) ||
+        value != direct->cookie)
+    {
+        ERROR("Unexpected connection to direct RPC stream");
+        rpc_transport_close(conn);
+        return;
+    }
+
+    /* The stream is established, nobody else is expected */
+    rpc_direct_close(direct);
+    direct->conn = conn;
+}
+
+/**
+ * Receive the next message either from Test Agent or from the direct
+ * stream. Connections to the direct stream are accepted while
+ * waiting, the first one which presents the cookie becomes the
+ * stream. The stream is dropped silently when it is broken.
+ *
+ * @param handle        Test Agent connection handle
+ * @param direct        Direct stream
+ * @param buf           Buffer for reading
+ * @param p_len         IN: buffer length; OUT: length of received message
+ * @param timeout       Timeout in seconds
+ * @param p_from        Location for the handle the message is received
+ *                      from
+ *
+ * @return Status code.
+ */
+static te_errno
+rpc_direct_recv(rpc_transport_handle handle, rpc_direct_stream *direct,
+                uint8_t *buf, size_t *p_len, int timeout,
+                rpc_transport_handle *p_from)
+{
+    rpc_transport_handle    handles[2 + RPC_DIRECT_PENDING_MAX];
+    rpc_transport_handle    conn;
+    unsigned int            n_handles;
+    unsigned int            ready;
+    unsigned int            i;
+    size_t                  len = *p_len;
+    te_errno                rc;
+
+    *p_from = handle;
+
+    while (direct->listen != RPC_DIRECT_NONE ||
+           direct->conn != RPC_DIRECT_NONE)
+    {
+        n_handles = 0;
+        handles[n_handles++] = handle;
+        if (direct->conn != RPC_DIRECT_NONE)
+        {
+            handles[n_handles++] = direct->conn;
+        }
+        else
+        {
+            handles[n_handles++] = direct->listen;
+            for (i = 0; i < direct->n_pending; i++)
+                handles[n_handles++] = direct->pending[i];
+        }
+
+        rc = rpc_transport_wait(handles, n_handles, timeout, &ready);
+        if (rc != 0)
+            return rc;
+        if (ready == 0)
+            break;
+
+        if (direct->conn == RPC_DIRECT_NONE && ready > 1)
+        {
+            rpc_direct_check_cookie(direct, ready - 2);
+            continue;
+        }
+
+        if (direct->conn == RPC_DIRECT_NONE)
+        {
+            rc = rpc_transport_direct_accept(direct->listen, &conn);
+            if (rc != 0)
+            {
+                rpc_direct_close(direct);
+                continue;
+            }
+
+            /* Too many connections without cookie: drop the oldest */
+            if (direct->n_pending == RPC_DIRECT_PENDING_MAX)
+                rpc_transport_close(rpc_direct_pending_remove(direct, 0));
+            direct->pending[direct->n_pending++] = conn;
+            continue;
+        }
+
+        *p_len = len;
+        rc = rpc_transport_recv(direct->conn, buf, p_len, timeout);
+        if (rc != 0)
+        {
+            RING("Direct RPC stream is closed: %r", rc);
+            rpc_direct_close(direct);
+            continue;
+        }
+
+        *p_from = direct->conn;
+        return 0;
+    }
+
+    *p_len = len;
+    return rpc_transport_recv(handle, buf, p_len, timeout);
+}
+
 
 #ifdef HAVE_SIGNAL_H
 static void
@@ -704,6 +974,9 @@ void *
 rcf_pch_rpc_server(const char *name)
 {
     rpc_transport_handle handle;
+    rpc_transport_handle reply_handle;
+    rpc_direct_stream    direct = { .listen = RPC_DIRECT_NONE,
+                                    .conn = RPC_DIRECT_NONE };
     uint8_t             *buf = NULL;
     int                  pid = getpid();
     int                  tid = thread_self();
@@ -793,13 +1066,15 @@ rcf_pch_rpc_server(const char *name)
         if (!plugin.enable)
 #endif
         {
-            rc = rpc_transport_recv(
-                        handle, buf, &len, RPC_TRANSPORT_RECV_TIMEOUT);
+            rc = rpc_direct_recv(handle, &direct, buf, &len,
+                                 RPC_TRANSPORT_RECV_TIMEOUT,
+                                 &reply_handle);
         }
 #if defined(ENABLE_RPC_PLUGINS)
         else
         {
-            rc = rpc_transport_recv(handle, buf, &len, 0);
+            rc = rpc_direct_recv(handle, &direct, buf, &len, 0,
+                                 &reply_handle);
             if (TE_RC_GET_ERROR(rc) != TE_ETIMEDOUT)
                 plugin_time_restart();
             else if (!plugin_timeout())
@@ -812,7 +1087,7 @@ rcf_pch_rpc_server(const char *name)
         if (rc != 0)
             STOP("Connection with TA is broken!");
 
-        if (strcmp((char *)buf, "FIN") == 0)
+        if (reply_handle == handle && strcmp((char *)buf, "FIN") == 0)
         {
 #ifdef __unix__
             if (rcf_rpc_server_finalize() != 0)
@@ -843,7 +1118,11 @@ rcf_pch_rpc_server(const char *name)
             goto result;
         }
 
-        result = (info->rpc)(in, out, &pseudo_req);
+        /* Direct stream is owned by the loop */
+        if (strcmp(rpc_name, "rpc_direct") == 0)
+            result = rpc_direct_setup(&direct, in, out);
+        else
+            result = (info->rpc)(in, out, &pseudo_req);
 
     result: /* Send an answer */
 
@@ -863,14 +1142,21 @@ rcf_pch_rpc_server(const char *name)
             rpc_xdr_free(info->out, out);
         free(out);
 
-        if (rpc_transport_send(handle, buf, len) != 0)
-            STOP("Sending data failed in main RPC server loop");
+        if (rpc_transport_send(reply_handle, buf, len) != 0)
+        {
+            if (reply_handle == handle)
+                STOP("Sending data failed in main RPC server loop");
+
+            RING("Failed to send reply to direct RPC stream");
+            rpc_direct_close(&direct);
+        }
 
         tarpc_run_deferred(&deferred_calls, handle);
     }
 
 cleanup:
     logfork_delete_user(pid, tid);
+    rpc_direct_close(&direct);
     rpc_transport_close(handle);
     free(buf);
 
@@ -342,6 +342,35 @@ extern te_bool tarpc_dynamic_library_loaded(void);
 extern int tarpc_find_func(tarpc_lib_flags lib_flags, const char *name,
                            api_func *func);
 
+/** Number of distinct combinations of tarpc_lib_flags */
+#define TARPC_LIB_FLAGS_NUM \
+    ((TARPC_LIB_USE_LIBC | TARPC_LIB_USE_SYSCALL) + 1)
+
+/**
+ * Cache of addresses a function name is resolved to with different
+ * tarpc_lib_flags. An entry is valid only if its generation matches
+ * the current one, which is changed by tarpc_setlibname().
+ */
+typedef struct tarpc_func_cache {
+    api_func        func[TARPC_LIB_FLAGS_NUM];  /**< Resolved addresses */
+    unsigned int    gen[TARPC_LIB_FLAGS_NUM];   /**< Generations of
+                                                     resolved addresses */
+} tarpc_func_cache;
+
+/**
+ * Find the function by its name using the cache of previous results.
+ *
+ * @param cache     cache of the function
+ * @param lib_flags how to resolve function name
+ * @param name      function name
+ * @param func      location for function address
+ *
+ * @return status code
+ */
+extern int tarpc_find_func_cached(tarpc_func_cache *cache,
+                                  tarpc_lib_flags lib_flags,
+                                  const char *name, api_func *func);
+
 /**
  * Try to find a function with tarpc_find_func(); in case of failure
  * set RPC error with te_rpc_error_set() and return @c -1.
@@ -652,6 +681,7 @@ typedef struct rpc_func_info {
     size_t out_common_offset;    /**< Offset of #tarpc_in_arg within the
                                   *   input structure (usually 0)
                                   */
+    tarpc_func_cache *cache;     /**< Resolved addresses of the function */
 } rpc_func_info;
 
 /** RPC call activation details */
@@ -856,6 +886,7 @@ extern void tarpc_generic_service(deferred_call_list *list,
                      tarpc_##_func##_out *_out,                         \
                      struct svc_req *_rqstp)                            \
     {                                                                   \
+        static tarpc_func_cache _cache;                                 \
         static const rpc_func_info _info = {                            \
             .funcname = #_func,                                         \
             .wrapper = _func##_wrapper,                                 \
@@ -864,7 +895,8 @@ extern void tarpc_generic_service(deferred_call_list *list,
             .in_size = sizeof(*_in),                                    \
             .in_common_offset = offsetof(tarpc_##_func##_in, common),   \
             .out_size = sizeof(*_out),                                  \
-            .out_common_offset = offsetof(tarpc_##_func##_out, common)  \
+            .out_common_offset = offsetof(tarpc_##_func##_out, common), \
+            .cache = &_cache                                            \
         };                                                              \
                                                                         \
         rpc_call_data _call = {                                         \
@@ -139,6 +139,12 @@ static te_bool   dynamic_library_set = FALSE;
 static char      dynamic_library_name[RCF_MAX_PATH];
 static void     *dynamic_library_handle = NULL;
 
+/**
+ * Generation of function addresses cached by tarpc_find_func_cached().
+ * It starts from 1 so that zeroed cache entries are never valid.
+ */
+static unsigned int tarpc_func_cache_gen = 1;
+
 /* See description in rpc_server.h */
 void
 tarpc_close_fd_hooks_call(int fd)
@@ -321,6 +327,8 @@ tarpc_setlibname(const char *libname)
         return TE_RC(TE_TA_UNIX, TE_ENOSPC);
     }
     dynamic_library_set = TRUE;
+    /* Functions resolved so far may come from another library now */
+    __atomic_add_fetch(&tarpc_func_cache_gen, 1, __ATOMIC_RELEASE);
     TE_STRLCPY(dynamic_library_name, libname,
                sizeof(dynamic_library_name));
     RING("Dynamic library is set to '%s'", libname);
@@ -374,8 +382,8 @@ tarpc_find_func(tarpc_lib_flags lib_flags, const char *name, api_func *func)
 
     *func = NULL;
 
-    tarpc_dl_name = getenv("TARPC_DL_NAME");
-    if (!dynamic_library_set && tarpc_dl_name != NULL &&
+    if (!dynamic_library_set &&
+        (tarpc_dl_name = getenv("TARPC_DL_NAME")) != NULL &&
         (rc = tarpc_setlibname(tarpc_dl_name)) != 0)
     {
         /* Error is always logged from tarpc_setlibname() */
@@ -453,6 +461,41 @@ try_ta_symtbl:
     return 0;
 }
 
+/* See description in rpc_server.h */
+int
+tarpc_find_func_cached(tarpc_func_cache *cache, tarpc_lib_flags lib_flags,
+                       const char *name, api_func *func)
+{
+    unsigned int    idx = lib_flags & (TARPC_LIB_FLAGS_NUM - 1);
+    unsigned int    gen;
+    int             rc;
+
+    if (cache == NULL || idx != lib_flags)
+        return tarpc_find_func(lib_flags, name, func);
+
+    gen = __atomic_load_n(&tarpc_func_cache_gen, __ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&cache->gen[idx], __ATOMIC_ACQUIRE) == gen)
+    {
+        *func = cache->func[idx];
+        return 0;
+    }
+
+    rc = tarpc_find_func(lib_flags, name, func);
+    if (rc != 0)
+        return rc;
+
+    /*
+     * The library may be set during resolution (see TARPC_DL_NAME
+     * handling in tarpc_find_func()), so the address is cached with
+     * the generation it was resolved in.
+     */
+    gen = __atomic_load_n(&tarpc_func_cache_gen, __ATOMIC_ACQUIRE);
+    cache->func[idx] = *func;
+    __atomic_store_n(&cache->gen[idx], gen, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
 /**
  * Log a file descriptor set after call for descriptor monitor functions like
  * select() or poll().
@@ -610,6 +653,28 @@ _setlibname_1_svc(tarpc_setlibname_in *in, tarpc_setlibname_out *out,
     return TRUE;
 }
 
+/*-------------- rpc_direct() ----------------------*/
+
+bool_t
+_rpc_direct_1_svc(tarpc_rpc_direct_in  *in,
+                  tarpc_rpc_direct_out *out,
+                  struct svc_req       *rqstp)
+{
+    UNUSED(in);
+    UNUSED(rqstp);
+
+    memset(out, 0, sizeof(*out));
+
+    /*
+     * The direct stream is owned by the main loop of RPC server,
+     * so the call is handled there and may not be done otherwise
+     * (e.g. in a batch).
+     */
+    out->common._errno = TE_RC(TE_TA_UNIX, TE_EOPNOTSUPP);
+
+    return TRUE;
+}
+
 /*-------------- rpc_find_func() ----------------------*/
 
 bool_t
@@ -628,6 +693,155 @@ _rpc_find_func_1_svc(tarpc_rpc_find_func_in  *in,
     return TRUE;
 }
 
+/*-------------- rpc_batch() ----------------------------*/
+
+/**
+ * Encode result of a call from the batch to a buffer allocated
+ * by the function.
+ *
+ * @param name      RPC name
+ * @param result    Value returned by RPC
+ * @param out       Output parameters of the call
+ * @param enc       Location for the encoded result
+ *
+ * @return Status code.
+ */
+static te_errno
+rpc_batch_encode_result(const char *name, te_bool result, void *out,
+                        struct tarpc_batch_result *enc)
+{
+    size_t  buf_len;
+    size_t  len;
+    char   *buf = NULL;
+    char   *tmp;
+    int     rc = TE_ESUNRPC;
+
+    for (buf_len = RCF_RPC_BUF_LEN;
+         TE_RC_GET_ERROR(rc) == TE_ESUNRPC &&
+         buf_len <= RCF_RPC_HUGE_BUF_LEN;
+         buf_len <<= 1)
+    {
+        tmp = realloc(buf, buf_len);
+        if (tmp == NULL)
+        {
+            free(buf);
+            return TE_RC(TE_TA_UNIX, TE_ENOMEM);
+        }
+        buf = tmp;
+
+        len = buf_len;
+        rc = rpc_xdr_encode_result(name, result, buf, &len, out);
+    }
+    if (rc != 0)
+    {
+        free(buf);
+        return TE_RC(TE_TA_UNIX, TE_E2BIG);
+    }
+
+    enc->result.result_val = buf;
+    enc->result.result_len = len;
+
+    return 0;
+}
+
+bool_t
+_rpc_batch_1_svc(tarpc_rpc_batch_in  *in,
+                 tarpc_rpc_batch_out *out,
+                 struct svc_req      *rqstp)
+{
+    char                        name[RCF_RPC_MAX_NAME];
+    struct tarpc_batch_call    *call;
+    struct tarpc_in_arg        *call_in;
+    struct tarpc_out_arg       *call_out;
+    rpc_info                   *info;
+    te_bool                     result = FALSE;
+    size_t                      total = 0;
+    unsigned int                i;
+    te_errno                    rc = 0;
+
+    memset(out, 0, sizeof(*out));
+
+    out->results.results_val = calloc(in->calls.calls_len,
+                                      sizeof(*out->results.results_val));
+    if (out->results.results_val == NULL && in->calls.calls_len > 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_ENOMEM);
+        return TRUE;
+    }
+
+    for (i = 0; i < in->calls.calls_len; i++)
+    {
+        void *call_in_p = NULL;
+
+        call = &in->calls.calls_val[i];
+        call_out = NULL;
+        info = NULL;
+
+        rc = rpc_xdr_decode_call(call->call.call_val, call->call.call_len,
+                                 name, &call_in_p);
+        if (rc != 0)
+        {
+            ERROR("Decoding of call %u of the batch failed: %r", i, rc);
+            break;
+        }
+        call_in = call_in_p;
+
+        info = rpc_find_info(name);
+        if (strcmp(name, "rpc_batch") == 0 ||
+            call_in->op != RCF_RPC_CALL_WAIT)
+        {
+            ERROR("Call %u of the batch (%s) cannot be executed in "
+                  "the batch", i, name);
+            rc = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        }
+        else if ((call_out = calloc(1, info->out_len)) == NULL)
+        {
+            rc = TE_RC(TE_TA_UNIX, TE_ENOMEM);
+        }
+        else
+        {
+            result = (info->rpc)(call_in, call_out, rqstp);
+            rc = rpc_batch_encode_result(name, result, call_out,
+                                         &out->results.results_val[i]);
+            if (rc == 0)
+            {
+                total += out->results.results_val[i].result.result_len;
+                out->results.results_len = i + 1;
+            }
+        }
+
+        rpc_xdr_free(info->in, call_in);
+        free(call_in);
+
+        if (call_out != NULL)
+        {
+            if (rc == 0 &&
+                (!result || !RPC_IS_ERRNO_RPC(call_out->_errno) ||
+                 (in->stop_on_errno && call_out->errno_changed)))
+            {
+                /* The result is returned, but the rest is skipped */
+                rc = TE_RC(TE_TA_UNIX, TE_ECANCELED);
+            }
+            rpc_xdr_free(info->out, call_out);
+            free(call_out);
+        }
+        if (rc == 0 && total > RCF_RPC_HUGE_BUF_LEN / 2)
+        {
+            ERROR("Results of the batch are too big, it is stopped "
+                  "after %u calls", i + 1);
+            rc = TE_RC(TE_TA_UNIX, TE_E2BIG);
+        }
+        if (rc != 0)
+            break;
+    }
+
+    /* Stop on error of a call is reported in its own result */
+    if (TE_RC_GET_ERROR(rc) != TE_ECANCELED)
+        out->common._errno = rc;
+
+    return TRUE;
+}
+
 /*-------------- sizeof() -------------------------------*/
 #define MAX_TYPE_NAME_SIZE 30
 typedef struct {
@@ -10106,11 +10320,142 @@ TARPC_FUNC(malloc, {},
 }
 )
 
+/*--------------------------- malloc_shm ---------------------------------*/
+
+/** Buffer allocated in POSIX shared memory by malloc_shm() */
+typedef struct shm_buf {
+    SLIST_ENTRY(shm_buf) links;     /**< List links */
+    void                *addr;      /**< Address of the mapping */
+    size_t               size;      /**< Size of the mapping */
+    char                 name[64];  /**< Name of shared memory object */
+} shm_buf;
+
+/** Buffers allocated by malloc_shm() */
+static SLIST_HEAD(, shm_buf) shm_bufs = SLIST_HEAD_INITIALIZER(shm_bufs);
+
+/** Lock protecting the list of buffers allocated by malloc_shm() */
+static pthread_mutex_t shm_bufs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Allocate a buffer in a new POSIX shared memory object, so that
+ * a process on the same host may map it and access the buffer directly.
+ * The object is unlinked when the buffer is freed, the process mapping
+ * it may unlink it earlier.
+ *
+ * @param size      Size of the buffer
+ * @param name      Where to save name of shared memory object
+ *                  (allocated with malloc())
+ *
+ * @return Buffer address or @c NULL (errno is set).
+ */
+static void *
+malloc_shm(size_t size, char **name)
+{
+    static unsigned int counter = 0;
+
+    shm_buf *buf;
+    int      fd;
+    int      err;
+
+    buf = calloc(1, sizeof(*buf));
+    if (buf == NULL)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    pthread_mutex_lock(&shm_bufs_lock);
+    TE_SPRINTF(buf->name, "/te_rpc_%u_%u_%08x", (unsigned int)getpid(),
+               counter++, (unsigned int)rand());
+    pthread_mutex_unlock(&shm_bufs_lock);
+
+    fd = shm_open(buf->name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        err = errno;
+        free(buf);
+        errno = err;
+        return NULL;
+    }
+
+    if (ftruncate(fd, size) != 0 ||
+        (buf->addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          fd, 0)) == MAP_FAILED ||
+        (*name = strdup(buf->name)) == NULL)
+    {
+        err = errno;
+        if (buf->addr != NULL && buf->addr != MAP_FAILED)
+            munmap(buf->addr, size);
+        close(fd);
+        shm_unlink(buf->name);
+        free(buf);
+        errno = err;
+        return NULL;
+    }
+    close(fd);
+    buf->size = size;
+
+    pthread_mutex_lock(&shm_bufs_lock);
+    SLIST_INSERT_HEAD(&shm_bufs, buf, links);
+    pthread_mutex_unlock(&shm_bufs_lock);
+
+    return buf->addr;
+}
+
+/**
+ * Release a buffer if it is allocated by malloc_shm().
+ *
+ * @param addr      Buffer address
+ *
+ * @return @c TRUE if the buffer was allocated by malloc_shm().
+ */
+static te_bool
+free_shm(void *addr)
+{
+    shm_buf *buf;
+
+    pthread_mutex_lock(&shm_bufs_lock);
+    SLIST_FOREACH(buf, &shm_bufs, links)
+    {
+        if (buf->addr == addr)
+            break;
+    }
+    if (buf != NULL)
+        SLIST_REMOVE(&shm_bufs, buf, shm_buf, links);
+    pthread_mutex_unlock(&shm_bufs_lock);
+
+    if (buf == NULL)
+        return FALSE;
+
+    munmap(buf->addr, buf->size);
+    /* It is fine if the object is already unlinked by its user */
+    shm_unlink(buf->name);
+    free(buf);
+
+    return TRUE;
+}
+
+TARPC_FUNC_STATIC(malloc_shm, {},
+{
+    void *buf;
+
+    MAKE_CALL(buf = func_ret_ptr(in->size, &out->name));
+
+    if (buf == NULL)
+        out->name = strdup("");
+    else
+        out->retval = rcf_pch_mem_alloc(buf);
+}
+)
+
 /*--------------------------- free ---------------------------------*/
 TARPC_FUNC(free, {},
 {
+    void *buf = rcf_pch_mem_base_ptr(in->buf);
+
     UNUSED(out);
-    func_ptr(rcf_pch_mem_base_ptr(in->buf));
+    if (!free_shm(buf))
+        func_ptr(buf);
     rcf_pch_mem_free(in->buf);
 }
 )
@@ -574,4 +574,155 @@ rpc_transport_send(rpc_transport_handle handle, const uint8_t *buf,
     return 0;
 }
 
+/**
+ * Backlog of the direct stream listening socket: connections which
+ * do not present the cookie must not prevent the expected one from
+ * being accepted.
+ */
+#define RPC_DIRECT_LISTEN_BACKLOG   8
+
+/**
+ * Open listening TCP socket for the direct stream from Test Engine
+ * to RPC server.
+ *
+ * @param listen_addr   IPv4 address to listen on (in host byte order)
+ * @param p_handle      listening handle location
+ * @param p_port        location for TCP port (in host byte order)
+ *
+ * @return Status code.
+ */
+te_errno
+rpc_transport_direct_listen(uint32_t listen_addr,
+                            rpc_transport_handle *p_handle,
+                            uint16_t *p_port)
+{
+    struct sockaddr_in  addr;
+    socklen_t           len = sizeof(addr);
+    int                 s;
+    te_errno            rc;
+
+    if ((s = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        ERROR("Failed to open listening socket for direct RPC stream");
+        return rc;
+    }
+
+#if HAVE_FCNTL_H
+    (void)fcntl(s, F_SETFD, FD_CLOEXEC);
+#endif
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(listen_addr);
+
+    if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(s, RPC_DIRECT_LISTEN_BACKLOG) < 0 ||
+        getsockname(s, (struct sockaddr *)&addr, &len) < 0)
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        ERROR("Failed to listen for direct RPC stream: %r", rc);
+        close(s);
+        return rc;
+    }
+
+    *p_handle = (rpc_transport_handle)s;
+    *p_port = ntohs(addr.sin_port);
+
+    return 0;
+}
+
+/**
+ * Accept the direct stream from Test Engine.
+ *
+ * @param listen_handle listening handle
+ * @param p_handle      connection handle location
+ *
+ * @return Status code.
+ */
+te_errno
+rpc_transport_direct_accept(rpc_transport_handle listen_handle,
+                            rpc_transport_handle *p_handle)
+{
+    int sock;
+
+    if ((sock = accept((int)listen_handle, NULL, NULL)) < 0)
+    {
+        te_errno rc = TE_OS_RC(TE_RCF_PCH, errno);
+
+        ERROR("Failed to accept direct RPC stream");
+        return rc;
+    }
+
+#if HAVE_FCNTL_H
+    (void)fcntl(sock, F_SETFD, FD_CLOEXEC);
+#endif
+#ifdef TCP_NODELAY
+    {
+        int nodelay = 1;
+
+        /* It is not critical */
+        (void)setsockopt(sock, IPPROTO_TCP, TCP_NODELAY,
+                         (void *)&nodelay, sizeof(nodelay));
+    }
+#endif
+
+    *p_handle = (rpc_transport_handle)sock;
+
+    return 0;
+}
+
+/**
+ * Wait for the read event on one of handles.
+ *
+ * @param handles       connection handles
+ * @param n_handles     number of handles
+ * @param timeout       timeout in seconds
+ * @param p_ready       location for index of the readable handle
+ *
+ * @return Status code.
+ * @retval TE_ETIMEDOUT         Timeout ocurred
+ */
+te_errno
+rpc_transport_wait(const rpc_transport_handle *handles,
+                   unsigned int n_handles, int timeout,
+                   unsigned int *p_ready)
+{
+    fd_set          set;
+    int             max_fd;
+    unsigned int    i;
+    int             rc;
+
+    do {
+        struct timeval tv = { timeout, 0 };
+
+        FD_ZERO(&set);
+        max_fd = -1;
+        for (i = 0; i < n_handles; i++)
+        {
+            FD_SET((int)handles[i], &set);
+            if ((int)handles[i] > max_fd)
+                max_fd = (int)handles[i];
+        }
+
+        rc = select(max_fd + 1, &set, NULL, NULL, &tv);
+    } while (rc < 0 && errno == EINTR);
+
+    if (rc == 0)
+        return TE_RC(TE_RCF_PCH, TE_ETIMEDOUT);
+    else if (rc < 0)
+        return TE_OS_RC(TE_RCF_PCH, errno);
+
+    for (i = 0; i < n_handles; i++)
+    {
+        if (FD_ISSET((int)handles[i], &set))
+        {
+            *p_ready = i;
+            break;
+        }
+    }
+
+    return 0;
+}
+
 #endif /* !CYGWIN && !WINDOWS */
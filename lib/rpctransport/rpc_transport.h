@@ -116,4 +116,47 @@ extern te_errno rpc_transport_recv(rpc_transport_handle handle,
 extern te_errno rpc_transport_send(rpc_transport_handle handle,
                                    const uint8_t *buf, size_t len);
 
+/**
+ * Open listening TCP socket for the direct stream from Test Engine
+ * to RPC server.
+ *
+ * @param addr          IPv4 address to listen on (in host byte order)
+ * @param p_handle      listening handle location
+ * @param p_port        location for TCP port (in host byte order)
+ *
+ * @return Status code.
+ */
+extern te_errno rpc_transport_direct_listen(uint32_t addr,
+                                            rpc_transport_handle *p_handle,
+                                            uint16_t *p_port);
+
+/**
+ * Accept the direct stream from Test Engine.
+ *
+ * @param listen_handle listening handle
+ * @param p_handle      connection handle location
+ *
+ * @return Status code.
+ */
+extern te_errno rpc_transport_direct_accept(
+    rpc_transport_handle listen_handle,
+    rpc_transport_handle *p_handle);
+
+/**
+ * Wait for the read event on one of handles. Unlike
+ * rpc_transport_read_set_wait() it does not use the shared read set
+ * and may be called from RPC server threads.
+ *
+ * @param handles       connection handles
+ * @param n_handles     number of handles
+ * @param timeout       timeout in seconds
+ * @param p_ready       location for index of the readable handle
+ *
+ * @return Status code.
+ * @retval TE_ETIMEDOUT         Timeout ocurred
+ */
+extern te_errno rpc_transport_wait(const rpc_transport_handle *handles,
+                                   unsigned int n_handles, int timeout,
+                                   unsigned int *p_ready);
+
 #endif /* !__RPC_TRANSPORT_H__ */
@@ -761,4 +761,70 @@ rpc_transport_send(rpc_transport_handle handle, const uint8_t *buf,
     return 0;
 }
 
+/**
+ * Direct stream from Test Engine is not supported by WinPIPE transport.
+ *
+ * @param addr          IPv4 address to listen on
+ * @param p_handle      listening handle location
+ * @param p_port        location for TCP port
+ *
+ * @return TE_EOPNOTSUPP
+ */
+te_errno
+rpc_transport_direct_listen(uint32_t addr,
+                            rpc_transport_handle *p_handle,
+                            uint16_t *p_port)
+{
+    UNUSED(addr);
+    UNUSED(p_handle);
+    UNUSED(p_port);
+
+    return TE_RC(TE_RCF_PCH, TE_EOPNOTSUPP);
+}
+
+/**
+ * Direct stream from Test Engine is not supported by WinPIPE transport.
+ *
+ * @param listen_handle listening handle
+ * @param p_handle      connection handle location
+ *
+ * @return TE_EOPNOTSUPP
+ */
+te_errno
+rpc_transport_direct_accept(rpc_transport_handle listen_handle,
+                            rpc_transport_handle *p_handle)
+{
+    UNUSED(listen_handle);
+    UNUSED(p_handle);
+
+    return TE_RC(TE_RCF_PCH, TE_EOPNOTSUPP);
+}
+
+/**
+ * Wait for the read event on one of handles. Only one handle is
+ * supported by WinPIPE transport, the wait is done on receiving.
+ *
+ * @param handles       connection handles
+ * @param n_handles     number of handles
+ * @param timeout       timeout in seconds
+ * @param p_ready       location for index of the readable handle
+ *
+ * @return Status code.
+ */
+te_errno
+rpc_transport_wait(const rpc_transport_handle *handles,
+                   unsigned int n_handles, int timeout,
+                   unsigned int *p_ready)
+{
+    UNUSED(handles);
+    UNUSED(timeout);
+
+    if (n_handles != 1)
+        return TE_RC(TE_RCF_PCH, TE_EOPNOTSUPP);
+
+    *p_ready = 0;
+
+    return 0;
+}
+
 #endif /* CYGWIN || WINDOWS && ENABLE_LOCAL_TRANSPORT */
@@ -64,13 +64,18 @@
 rpc_info *
 rpc_find_info(const char *name)
 {
-    int i;
+    const rpc_info_hash *hash = &tarpc_functions_hash;
 
-    for (i = 0; tarpc_functions[i].name != NULL; i++)
-        if (strcmp(name, tarpc_functions[i].name) == 0)
-            return tarpc_functions + i;
+    uint32_t    h1 = rpc_info_name_hash(0, name);
+    uint32_t    h2 = rpc_info_name_hash(hash->seed, name) | 1;
+    uint32_t    d = hash->disp[h1 & (hash->n_buckets - 1)];
+    unsigned    slot = hash->slots[(h1 + d * h2) & (hash->n_slots - 1)];
 
-    return NULL;
+    /* Names which are not in the table may hash to any slot */
+    if (slot == 0 || strcmp(name, tarpc_functions[slot - 1].name) != 0)
+        return NULL;
+
+    return tarpc_functions + slot - 1;
 }
 
 /**
@@ -14,6 +14,7 @@
 extern "C" {
 #endif
 
+#include "te_stdint.h"
 #include "te_errno.h"
 #include "tarpc.h"
 
@@ -51,6 +52,44 @@ typedef struct {
  */
 extern rpc_info tarpc_functions[];
 
+/**
+ * Perfect hash of RPC functions names, generated automatically together
+ * with the table of functions. A name is looked up as
+ * slots[(h1 + disp[h1 % n_buckets] * h2) % n_slots], where h1 and h2
+ * are computed by rpc_info_name_hash() with seeds @c 0 and @a seed.
+ */
+typedef struct rpc_info_hash {
+    uint32_t        seed;       /**< Seed of the second hash */
+    uint32_t        n_buckets;  /**< Number of displacements
+                                     (power of 2) */
+    uint32_t        n_slots;    /**< Number of slots (power of 2) */
+    const uint16_t *disp;       /**< Displacements of buckets */
+    const uint16_t *slots;      /**< Index in the table of functions
+                                     plus one or @c 0 for empty slot */
+} rpc_info_hash;
+
+/** Perfect hash of tarpc_functions[] */
+extern const rpc_info_hash tarpc_functions_hash;
+
+/**
+ * FNV-1a hash of RPC function name as used by rpc_info_hash.
+ *
+ * @param seed  seed XOR'ed to the offset basis
+ * @param name  RPC function name
+ *
+ * @return Hash value.
+ */
+static inline uint32_t
+rpc_info_name_hash(uint32_t seed, const char *name)
+{
+    uint32_t h = 2166136261U ^ seed;
+
+    for (; *name != '\0'; name++)
+        h = (h ^ (uint8_t)*name) * 16777619U;
+
+    return h;
+}
+
 /**
  * Find information corresponding to RPC function by its name.
  *
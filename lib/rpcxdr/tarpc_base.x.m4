@@ -534,6 +534,22 @@ struct tarpc_rpc_is_op_done_out {
 typedef struct tarpc_void_in  tarpc_rpc_is_alive_in;
 typedef struct tarpc_void_out tarpc_rpc_is_alive_out;
 
+/* rpc_direct() */
+
+struct tarpc_rpc_direct_in {
+    struct tarpc_in_arg common;
+
+    uint32_t    addr;       /**< IPv4 address to listen on
+                                 (in host byte order) */
+};
+
+struct tarpc_rpc_direct_out {
+    struct tarpc_out_arg common;
+
+    uint16_t    port;       /**< TCP port to connect the direct stream */
+    uint64_t    cookie;     /**< Cookie to be sent first on the stream */
+};
+
 /* setlibname() */
 
 struct tarpc_setlibname_in {
@@ -544,6 +560,34 @@ struct tarpc_setlibname_in {
 
 typedef struct tarpc_int_retval_out tarpc_setlibname_out;
 
+/* rpc_batch() */
+
+/** RPC call encoded by rpc_xdr_encode_call() */
+struct tarpc_batch_call {
+    char call<>;
+};
+
+/** RPC result encoded by rpc_xdr_encode_result() */
+struct tarpc_batch_result {
+    char result<>;
+};
+
+struct tarpc_rpc_batch_in {
+    struct tarpc_in_arg common;
+
+    tarpc_bool                  stop_on_errno;  /**< Stop if a call
+                                                     changes errno */
+    struct tarpc_batch_call     calls<>;        /**< Calls to be executed
+                                                     in order */
+};
+
+struct tarpc_rpc_batch_out {
+    struct tarpc_out_arg common;
+
+    struct tarpc_batch_result   results<>;  /**< Results of executed
+                                                 calls */
+};
+
 
 /* socket() */
 
@@ -2198,6 +2242,19 @@ struct tarpc_free_out {
     struct tarpc_out_arg common;
 };
 
+/* malloc_shm */
+struct tarpc_malloc_shm_in {
+    struct tarpc_in_arg  common;
+    tarpc_size_t         size;   /**< Bytes to allocate */
+};
+
+struct tarpc_malloc_shm_out {
+    struct tarpc_out_arg common;
+    tarpc_ptr            retval; /**< A pointer in the TA address space */
+    string               name<>; /**< Name of POSIX shared memory object
+                                      backing the buffer */
+};
+
 /* get_addr_by_id */
 struct tarpc_get_addr_by_id_in {
     struct tarpc_in_arg  common;
@@ -5525,7 +5582,9 @@ program tarpc
         RPC_DEF(rpc_find_func)
         RPC_DEF(rpc_is_op_done)
         RPC_DEF(rpc_is_alive)
+        RPC_DEF(rpc_direct)
         RPC_DEF(setlibname)
+        RPC_DEF(rpc_batch)
 
         RPC_DEF(get_sizeof)
         RPC_DEF(get_addrof)
@@ -5557,6 +5616,7 @@ program tarpc
 
         RPC_DEF(malloc)
         RPC_DEF(free)
+        RPC_DEF(malloc_shm)
         RPC_DEF(get_addr_by_id)
         RPC_DEF(raw2integer)
         RPC_DEF(integer2raw)
@@ -47,12 +47,16 @@ static csap_spt_type_t eth_csap_spt =
 
     .prepare_send_cb     = tad_eth_prepare_send,
     .write_cb            = tad_eth_write_cb,
+    .write_pkts_cb       = tad_eth_write_pkts_cb,
     .shutdown_send_cb    = tad_eth_shutdown_send,
 
     .prepare_recv_cb     = tad_eth_prepare_recv,
     .read_cb             = tad_eth_read_cb,
     .shutdown_recv_cb    = tad_eth_shutdown_recv,
 
+    .prepare_recv_queues_cb = tad_eth_prepare_recv_queues,
+    .read_queue_cb       = tad_eth_read_queue_cb,
+
     .write_read_cb       = tad_common_write_read_cb,
 };
 
@@ -54,6 +54,10 @@ extern "C" {
 typedef struct tad_eth_rw_data {
     tad_eth_sap     sap;        /**< Ethernet service access point */
     unsigned int    recv_mode;  /**< Default receive mode */
+    unsigned int    n_queues;   /**< Number of receive queues */
+    tad_eth_sap    *queues;     /**< Service access points of receive
+                                     queues except the first one which
+                                     is @a sap */
 } tad_eth_rw_data;
 
 
@@ -101,6 +105,14 @@ extern te_errno tad_eth_shutdown_send(csap_p csap);
  */
 extern te_errno tad_eth_write_cb(csap_p csap, const tad_pkt *pkt);
 
+/**
+ * Callback for write a batch of packets to media of Ethernet CSAP.
+ *
+ * The function complies with csap_write_pkts_cb_t prototype.
+ */
+extern te_errno tad_eth_write_pkts_cb(csap_p csap, const tad_pkts *pkts,
+                                      unsigned int *sent);
+
 /**
  * Open receive socket for Ethernet CSAP.
  *
@@ -115,6 +127,25 @@ extern te_errno tad_eth_prepare_recv(csap_p csap);
  */
 extern te_errno tad_eth_shutdown_recv(csap_p csap);
 
+/**
+ * Open receive sockets of additional receive queues for Ethernet CSAP
+ * and join all receive sockets to a PACKET_FANOUT group.
+ *
+ * The function complies with csap_prepare_recv_queues_cb_t prototype.
+ */
+extern te_errno tad_eth_prepare_recv_queues(csap_p       csap,
+                                            unsigned int n_queues,
+                                            unsigned int fanout);
+
+/**
+ * Callback for read data from a receive queue of Ethernet CSAP.
+ *
+ * The function complies with csap_read_queue_cb_t prototype.
+ */
+extern te_errno tad_eth_read_queue_cb(csap_p csap, unsigned int queue,
+                                      unsigned int timeout,
+                                      tad_pkt *pkt, size_t *pkt_len);
+
 
 /**
  * Callback to initialize 'eth' CSAP layer.
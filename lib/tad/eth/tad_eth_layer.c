@@ -255,6 +255,8 @@ tad_eth_init_cb(csap_p csap, unsigned int layer)
     rc = tad_bps_pkt_frag_init(tad_eth_addrs_bps_hdr,
                                TE_ARRAY_LEN(tad_eth_addrs_bps_hdr),
                                layer_nds, &proto_data->eth);
+    if (rc == 0)
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->eth, ndn_eth_header);
     if (rc != 0)
         return rc;
 
@@ -283,12 +285,22 @@ tad_eth_init_cb(csap_p csap, unsigned int layer)
     rc = tad_bps_pkt_frag_init(tad_eth_length_type_bps_hdr,
                                TE_ARRAY_LEN(tad_eth_length_type_bps_hdr),
                                layer_nds, &proto_data->len_type);
+    if (rc == 0)
+    {
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->len_type,
+                                         ndn_eth_header);
+    }
     if (rc != 0)
         return rc;
 
     rc = tad_bps_pkt_frag_init(tad_eth_ether_type_bps_hdr,
                                TE_ARRAY_LEN(tad_eth_ether_type_bps_hdr),
                                layer_nds, &proto_data->ether_type);
+    if (rc == 0)
+    {
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->ether_type,
+                                         ndn_eth_header);
+    }
     if (rc != 0)
         return rc;
 
@@ -424,6 +436,9 @@ tad_eth_init_cb(csap_p csap, unsigned int layer)
     rc = tad_bps_pkt_frag_init(tad_802_1q_tci_bps_hdr,
              TE_ARRAY_LEN(tad_802_1q_tci_bps_hdr),
              NULL, &proto_data->tci);
+    if (rc == 0)
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->tci,
+                                         ndn_vlan_tag_header);
     if (rc != 0)
         return rc;
     rc = tad_bps_pkt_frag_init(tad_802_1q_e_rif_bps_hdr,
@@ -439,11 +454,17 @@ tad_eth_init_cb(csap_p csap, unsigned int layer)
     rc = tad_bps_pkt_frag_init(tad_802_1ad_tci_bps_hdr,
              TE_ARRAY_LEN(tad_802_1ad_tci_bps_hdr),
              NULL, &proto_data->tci_ad_outer);
+    if (rc == 0)
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->tci_ad_outer,
+                                         ndn_vlan_header);
     if (rc != 0)
         return rc;
     rc = tad_bps_pkt_frag_init(tad_802_1ad_tci_bps_hdr,
              TE_ARRAY_LEN(tad_802_1ad_tci_bps_hdr),
              NULL, &proto_data->tci_ad_inner);
+    if (rc == 0)
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->tci_ad_inner,
+                                         ndn_vlan_header);
     if (rc != 0)
         return rc;
     rc = tad_bps_pkt_frag_init(tad_802_2_llc_bps_hdr,
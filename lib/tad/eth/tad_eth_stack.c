@@ -51,6 +51,9 @@
 #include "tad_eth_impl.h"
 
 
+/** Number of fan-out group IDs to try to create a group */
+#define TAD_ETH_FANOUT_GROUP_TRIES  16
+
 
 /* See description tad_eth_impl.h */
 te_errno
@@ -86,15 +89,126 @@ tad_eth_prepare_recv(csap_p csap)
     return tad_eth_sap_recv_open(&spec_data->sap, spec_data->recv_mode);
 }
 
+/**
+ * Close receive sockets of additional receive queues of Ethernet CSAP.
+ *
+ * @param spec_data     Read/write layer data of the CSAP
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_eth_recv_queues_close(tad_eth_rw_data *spec_data)
+{
+    te_errno        result = 0;
+    te_errno        rc;
+    unsigned int    i;
+
+    for (i = 1; i < spec_data->n_queues; i++)
+    {
+        tad_eth_sap *sap = &spec_data->queues[i - 1];
+
+        if (sap->data == NULL)
+            continue;
+
+        rc = tad_eth_sap_recv_close(sap);
+        TE_RC_UPDATE(result, rc);
+        rc = tad_eth_sap_detach(sap);
+        TE_RC_UPDATE(result, rc);
+    }
+
+    free(spec_data->queues);
+    spec_data->queues = NULL;
+    spec_data->n_queues = 0;
+
+    return result;
+}
+
 /* See description tad_eth_impl.h */
 te_errno
 tad_eth_shutdown_recv(csap_p csap)
 {
     tad_eth_rw_data *spec_data = csap_get_rw_data(csap);
+    te_errno         result;
+    te_errno         rc;
 
     assert(spec_data != NULL);
 
-    return tad_eth_sap_recv_close(&spec_data->sap);
+    result = tad_eth_recv_queues_close(spec_data);
+    rc = tad_eth_sap_recv_close(&spec_data->sap);
+    TE_RC_UPDATE(result, rc);
+
+    return result;
+}
+
+/* See description tad_eth_impl.h */
+te_errno
+tad_eth_prepare_recv_queues(csap_p csap, unsigned int n_queues,
+                            unsigned int fanout)
+{
+    tad_eth_rw_data    *spec_data = csap_get_rw_data(csap);
+    unsigned int        group;
+    unsigned int        i;
+    te_errno            rc;
+
+    assert(spec_data != NULL);
+    assert(spec_data->n_queues == 0);
+    assert(n_queues > 1);
+
+    /*
+     * Fan-out group ID is shared by all processes of the host, try
+     * a few ones derived from the process and CSAP IDs. The socket
+     * of the first queue creates the group.
+     */
+    group = (getpid() << 6) ^ csap->id;
+    for (i = 0; i < TAD_ETH_FANOUT_GROUP_TRIES; i++, group++)
+    {
+        rc = tad_eth_sap_recv_fanout(&spec_data->sap, group, fanout);
+        if (TE_RC_GET_ERROR(rc) != TE_EINVAL &&
+            TE_RC_GET_ERROR(rc) != TE_EALREADY)
+            break;
+    }
+    if (rc != 0)
+        return rc;
+
+    spec_data->queues = TE_ALLOC((n_queues - 1) *
+                                 sizeof(*spec_data->queues));
+    if (spec_data->queues == NULL)
+        return TE_RC(TE_TAD_CSAP, TE_ENOMEM);
+    spec_data->n_queues = n_queues;
+
+    for (i = 1; i < n_queues; i++)
+    {
+        tad_eth_sap *sap = &spec_data->queues[i - 1];
+
+        rc = tad_eth_sap_attach(spec_data->sap.name, sap);
+        if (rc != 0)
+            break;
+        sap->csap = csap;
+
+        rc = tad_eth_sap_recv_open(sap, spec_data->recv_mode);
+        if (rc != 0)
+        {
+            /* Detached access point is skipped on close */
+            (void)tad_eth_sap_detach(sap);
+            break;
+        }
+
+        rc = tad_eth_sap_recv_fanout(sap, group, fanout);
+        if (rc != 0)
+            break;
+    }
+    if (rc != 0)
+    {
+        ERROR("Failed to open receive queue %u of Ethernet CSAP: %r",
+              i, rc);
+        (void)tad_eth_recv_queues_close(spec_data);
+        return rc;
+    }
+
+    INFO(CSAP_LOG_FMT "%u receive queues are opened",
+         CSAP_LOG_ARGS(csap), n_queues);
+
+    return 0;
 }
 
 
@@ -110,6 +224,21 @@ tad_eth_read_cb(csap_p csap, unsigned int timeout,
     return tad_eth_sap_recv(&spec_data->sap, timeout, pkt, pkt_len);
 }
 
+/* See description tad_eth_impl.h */
+te_errno
+tad_eth_read_queue_cb(csap_p csap, unsigned int queue, unsigned int timeout,
+                      tad_pkt *pkt, size_t *pkt_len)
+{
+    tad_eth_rw_data *spec_data = csap_get_rw_data(csap);
+
+    assert(spec_data != NULL);
+    assert(queue == 0 || queue < spec_data->n_queues);
+
+    return tad_eth_sap_recv(queue == 0 ? &spec_data->sap :
+                                &spec_data->queues[queue - 1],
+                            timeout, pkt, pkt_len);
+}
+
 
 /* See description tad_eth_impl.h */
 te_errno
@@ -122,6 +251,17 @@ tad_eth_write_cb(csap_p csap, const tad_pkt *pkt)
     return tad_eth_sap_send(&spec_data->sap, pkt);
 }
 
+/* See description tad_eth_impl.h */
+te_errno
+tad_eth_write_pkts_cb(csap_p csap, const tad_pkts *pkts, unsigned int *sent)
+{
+    tad_eth_rw_data *spec_data = csap_get_rw_data(csap);
+
+    assert(spec_data != NULL);
+
+    return tad_eth_sap_send_pkts(&spec_data->sap, pkts, sent);
+}
+
 
 /* See description tad_eth_impl.h */
 te_errno
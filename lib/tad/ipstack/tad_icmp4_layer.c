@@ -164,6 +164,11 @@ tad_icmp4_init_cb(csap_p csap, unsigned int layer)
     rc = tad_bps_pkt_frag_init(tad_icmp4_bps_hdr,
                                TE_ARRAY_LEN(tad_icmp4_bps_hdr),
                                layer_nds, &proto_data->hdr);
+    if (rc == 0)
+    {
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->hdr,
+                                         ndn_icmp4_message);
+    }
     if (rc != 0)
         return rc;
 
@@ -955,25 +955,6 @@ typedef struct per_pdu_ctx {
     uint8_t *msg; /**< ICMPv6 message data */
 } per_pdu_ctx;
 
-/**
- * Calculate checksum of the segment data.
- *
- * This function complies with tad_pkt_seg_enum_cb prototype.
- */
-static te_errno
-csum_seg_cb(const tad_pkt *pkt, tad_pkt_seg *seg,
-            unsigned int seg_num, void *opaque)
-{
-    uint32_t *csum = (uint32_t *)opaque;
-
-    /* Data length is even or it is the last segument */
-    assert(((seg->data_len & 1) == 0) ||
-           (seg_num == tad_pkt_seg_num(pkt) - 1));
-    *csum += calculate_checksum(seg->data_ptr, seg->data_len);
-
-    return 0;
-}
-
 static void
 tad_ip6_fill_pseudo_hdr(uint8_t *pseudo_hdr,
                         uint8_t *src, uint8_t *dst,
@@ -999,7 +980,6 @@ tad_icmp6_gen_bin_cb_per_pdu(tad_pkt *pdu, void *opaque)
     tad_pkt_seg *seg = tad_pkt_first_seg(pdu);
     per_pdu_ctx *ctx = (per_pdu_ctx *)opaque;
     uint8_t      pseudo_hdr[IP6_PSEUDO_HDR_LEN];
-    uint32_t     csum;
     uint16_t     csum_val;
 
     /* Copy header template to packet */
@@ -1014,11 +994,9 @@ tad_icmp6_gen_bin_cb_per_pdu(tad_pkt *pdu, void *opaque)
     tad_ip6_fill_pseudo_hdr(pseudo_hdr, ctx->ip6_src, ctx->ip6_dst,
                             tad_pkt_len(pdu), IPPROTO_ICMPV6);
 
-    csum = calculate_checksum(pseudo_hdr, sizeof(pseudo_hdr));
+    csum_val = calculate_checksum(pseudo_hdr, sizeof(pseudo_hdr));
     /* ICMPv6 message checksum */
-    tad_pkt_enumerate_seg(pdu, csum_seg_cb, &csum);
-    /* Finalize checksum calculation */
-    csum_val = ~((csum & 0xffff) + (csum >> 16));
+    csum_val = ~tad_pkt_csum_part(pdu, csum_val);
 
     memcpy(seg->data_ptr + 2, &csum_val, sizeof(csum_val));
 
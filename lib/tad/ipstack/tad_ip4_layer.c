@@ -124,12 +124,16 @@ tad_ip4_init_cb(csap_p csap, unsigned int layer)
     rc = tad_bps_pkt_frag_init(tad_ip4_bps_hdr,
                                TE_ARRAY_LEN(tad_ip4_bps_hdr),
                                layer_nds, &proto_data->hdr);
+    if (rc == 0)
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->hdr, ndn_ip4_header);
     if (rc != 0)
         return rc;
 
     rc = tad_bps_pkt_frag_init(tad_ip4_bps_opts,
                                TE_ARRAY_LEN(tad_ip4_bps_opts),
                                layer_nds, &proto_data->opts);
+    if (rc == 0)
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->opts, ndn_ip4_header);
     if (rc != 0)
         return rc;
 
@@ -291,71 +295,6 @@ tad_ip4_confirm_tmpl_cb(csap_p csap, unsigned int layer,
 }
 
 
-/**
- * Segment payload checksum calculation data.
- */
-typedef struct tad_ip4_upper_checksum_seg_cb_data {
-    uint32_t        checksum;   /**< Accumulated checksum */
-    const uint8_t  *uncksumed;  /**< Unchecksumed byte in the segment end */
-} tad_ip4_upper_checksum_seg_cb_data;
-
-/**
- * Calculate checksum of the segment data.
- *
- * This function complies with tad_pkt_seg_enum_cb prototype.
- */
-static te_errno
-tad_ip4_upper_checksum_seg_cb(const tad_pkt *pkt, tad_pkt_seg *seg,
-                              unsigned int seg_num, void *opaque)
-{
-    tad_ip4_upper_checksum_seg_cb_data *data = opaque;
-    const uint8_t                      *seg_data_ptr;
-    const uint8_t                      *data_ptr;
-    size_t                              data_len;
-    te_bool                             last_segment;
-
-    if (seg_num == (tad_pkt_seg_num(pkt) - 1))
-        last_segment = TRUE;
-    else
-        last_segment = FALSE;
-
-    if (seg->data_len == 0)
-    {
-        if ((data->uncksumed != NULL) && last_segment)
-            data->checksum += calculate_checksum(data->uncksumed, 1);
-
-        return 0;
-    }
-
-    seg_data_ptr = (const uint8_t *)(seg->data_ptr);
-
-    if (data->uncksumed != NULL)
-    {
-        uint8_t arr[2];
-        arr[0] = *data->uncksumed;
-        arr[1] = seg_data_ptr[0];
-        data->checksum += calculate_checksum(&arr, 2);
-        data->uncksumed = NULL;
-        data_ptr = seg_data_ptr + 1;
-        data_len = seg->data_len - 1;
-    }
-    else
-    {
-        data_ptr = seg_data_ptr;
-        data_len = seg->data_len;
-    }
-
-    if ((data_len & 1) != 0 && !last_segment)
-    {
-        data->uncksumed = &data_ptr[data_len - 1];
-        data_len--;
-    }
-
-    data->checksum += calculate_checksum(data_ptr, data_len);
-
-    return 0;
-}
-
 /** Data to be passed as opaque to tad_ip4_gen_bin_cb_per_sdu() callback. */
 typedef struct tad_ip4_gen_bin_cb_per_sdu_data {
 
@@ -410,8 +349,8 @@ tad_ip4_gen_bin_cb_per_sdu(tad_pkt *sdu, void *opaque)
         }
         else
         {
-            tad_ip4_upper_checksum_seg_cb_data  seg_data;
-            uint16_t                            tmp;
+            uint32_t    checksum;
+            uint16_t    tmp;
 
             if (sdu_len > 0xffff)
             {
@@ -421,11 +360,11 @@ tad_ip4_gen_bin_cb_per_sdu(tad_pkt *sdu, void *opaque)
             }
             tmp = htons(sdu_len);
 
-            seg_data.checksum = data->init_chksm;
+            checksum = data->init_chksm;
             if (data->use_phdr)
             {
                 /* Pseudo-header checksum */
-                seg_data.checksum += calculate_checksum(&tmp, sizeof(tmp));
+                checksum += calculate_checksum(&tmp, sizeof(tmp));
             }
 
             /* Get checksum from template */
@@ -439,14 +378,7 @@ tad_ip4_gen_bin_cb_per_sdu(tad_pkt *sdu, void *opaque)
             if (ntohs(csum) != TE_IP4_UPPER_LAYER_CSUM_ZERO)
             {
                 /* Upper layer data checksum */
-                seg_data.uncksumed = NULL;
-                (void)tad_pkt_enumerate_seg(sdu,
-                                            tad_ip4_upper_checksum_seg_cb,
-                                            &seg_data);
-
-                /* Finalize checksum calculation */
-                tmp = ~((seg_data.checksum & 0xffff) +
-                        (seg_data.checksum >> 16));
+                tmp = ~tad_pkt_csum_part(sdu, checksum);
 
                 /* Corrupt checksum if necessary */
                 if (ntohs(csum) == TE_IP4_UPPER_LAYER_CSUM_BAD)
@@ -308,6 +308,8 @@ tad_ip6_init_cb(csap_p csap, unsigned int layer)
     IF_RC_RETURN(tad_bps_pkt_frag_init(tad_ip6_bps_hdr,
                                TE_ARRAY_LEN(tad_ip6_bps_hdr),
                                layer_nds, &proto_data->hdr));
+    IF_RC_RETURN(tad_bps_pkt_frag_init_paths(&proto_data->hdr,
+                                             ndn_ip6_header));
 
     IF_RC_RETURN(tad_bps_pkt_frag_init(tad_ip6_ext_hdr_opts_bps_hdr,
                                TE_ARRAY_LEN(tad_ip6_ext_hdr_opts_bps_hdr),
@@ -1185,64 +1187,6 @@ tad_ip6_gen_bin_cb_per_sdu(tad_pkt *sdu, void *opaque)
 #undef ASN_READ_FRAG_SPEC
 }
 
-typedef struct tad_ip6_upper_checksum_seg_cb_data {
-    uint32_t        checksum;   /**< Accumulated checksum */
-    const uint8_t  *uncksumed;  /**< Unchecksumed byte in the segment end */
-} tad_ip6_upper_checksum_seg_cb_data;
-
-static te_errno
-tad_ip6_upper_checksum_seg_cb(const tad_pkt *pkt, tad_pkt_seg *seg,
-                              unsigned int seg_num, void *opaque)
-{
-    tad_ip6_upper_checksum_seg_cb_data *data = opaque;
-    const uint8_t                      *seg_data_ptr;
-    const uint8_t                      *data_ptr;
-    size_t                              data_len;
-    te_bool                             last_segment;
-
-    if (seg_num == (tad_pkt_seg_num(pkt) - 1))
-        last_segment = TRUE;
-    else
-        last_segment = FALSE;
-
-    if (seg->data_len == 0)
-    {
-        if ((data->uncksumed != NULL) && last_segment)
-            data->checksum += calculate_checksum(data->uncksumed, 1);
-
-        return 0;
-    }
-
-    seg_data_ptr = (const uint8_t *)(seg->data_ptr);
-
-    if (data->uncksumed != NULL)
-    {
-        uint8_t arr[2];
-
-        arr[0] = *data->uncksumed;
-        arr[1] = seg_data_ptr[0];
-        data->checksum += calculate_checksum(&arr, 2);
-        data->uncksumed = NULL;
-        data_ptr = seg_data_ptr + 1;
-        data_len = seg->data_len - 1;
-    }
-    else
-    {
-        data_ptr = seg_data_ptr;
-        data_len = seg->data_len;
-    }
-
-    if ((data_len & 1) != 0 && !last_segment)
-    {
-        data->uncksumed = &data_ptr[data_len - 1];
-        data_len--;
-    }
-
-    data->checksum += calculate_checksum(data_ptr, data_len);
-
-    return 0;
-}
-
 static te_errno
 tad_ip6_upper_checksum_cb(tad_pkt *sdu, void *opaque)
 {
@@ -1250,7 +1194,7 @@ tad_ip6_upper_checksum_cb(tad_pkt *sdu, void *opaque)
     tad_pkt_seg                        *seg = tad_pkt_first_seg(sdu);
     size_t                              len = tad_pkt_len(sdu);
     uint16_t                            tmp;
-    tad_ip6_upper_checksum_seg_cb_data  seg_data;
+    uint32_t                            checksum;
     uint16_t                            csum;
 
     if (data->upper_checksum_offset == -1)
@@ -1272,12 +1216,12 @@ tad_ip6_upper_checksum_cb(tad_pkt *sdu, void *opaque)
         return TE_RC(TE_TAD_CSAP, TE_EINVAL);
     }
 
-    seg_data.checksum = data->init_checksum;
+    checksum = data->init_checksum;
 
     if (data->use_phdr)
     {
         tmp = htons(len);
-        seg_data.checksum += calculate_checksum(&tmp, sizeof(tmp));
+        checksum += calculate_checksum(&tmp, sizeof(tmp));
     }
 
     /* Get checksum from template */
@@ -1291,14 +1235,7 @@ tad_ip6_upper_checksum_cb(tad_pkt *sdu, void *opaque)
     if (ntohs(csum) != TE_IP6_UPPER_LAYER_CSUM_ZERO)
     {
         /* Upper layer data checksum */
-        seg_data.uncksumed = NULL;
-        (void)tad_pkt_enumerate_seg(sdu,
-                                    tad_ip6_upper_checksum_seg_cb,
-                                    &seg_data);
-
-        /* Finalize checksum calculation */
-        tmp = ~((seg_data.checksum & 0xffff) +
-                (seg_data.checksum >> 16));
+        tmp = ~tad_pkt_csum_part(sdu, checksum);
 
         /* Corrupt checksum if necessary */
         if (ntohs(csum) == TE_IP6_UPPER_LAYER_CSUM_BAD)
@@ -92,6 +92,21 @@ extern "C" {
 #define TCP_HDR_CKSUM_DU_INDEX 7
 
 
+/** Fields of TCP options put to NDS of received packets */
+typedef enum tad_tcp_opt_field {
+    TAD_TCP_OPT_EOL,            /**< End of options list */
+    TAD_TCP_OPT_NOP,            /**< No operation */
+    TAD_TCP_OPT_MSS_LEN,        /**< MSS option length */
+    TAD_TCP_OPT_MSS,            /**< MSS value */
+    TAD_TCP_OPT_WIN_SCALE_LEN,  /**< Window scale option length */
+    TAD_TCP_OPT_WIN_SCALE,      /**< Window scale value */
+    TAD_TCP_OPT_TIMESTAMP_LEN,  /**< Timestamp option length */
+    TAD_TCP_OPT_TIMESTAMP,      /**< Timestamp value */
+    TAD_TCP_OPT_TIMESTAMP_ECHO, /**< Timestamp echo reply */
+
+    TAD_TCP_OPT_FIELDS          /**< Number of fields */
+} tad_tcp_opt_field;
+
 /*
  * TCP CSAP specific data
  */
@@ -117,6 +132,10 @@ typedef struct tcp_csap_specific_data
     tad_data_unit_t  du_checksum;
     tad_data_unit_t  du_urg_p;
 
+    /** Paths to fields of TCP options compiled against ndn_tcp_option
+        (@c NULL if a path cannot be compiled) */
+    asn_path        *opt_paths[TAD_TCP_OPT_FIELDS];
+
 } tcp_csap_specific_data_t;
 
 
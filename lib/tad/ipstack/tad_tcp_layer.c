@@ -34,6 +34,43 @@
 #include "te_alloc.h"
 #include "tad_ipstack_impl.h"
 
+/** Labels of fields of TCP options in ndn_tcp_option */
+static const char * const tad_tcp_opt_labels[TAD_TCP_OPT_FIELDS] = {
+    [TAD_TCP_OPT_EOL] = "#eol",
+    [TAD_TCP_OPT_NOP] = "#nop",
+    [TAD_TCP_OPT_MSS_LEN] = "#mss.length.#plain",
+    [TAD_TCP_OPT_MSS] = "#mss.mss.#plain",
+    [TAD_TCP_OPT_WIN_SCALE_LEN] = "#win-scale.length.#plain",
+    [TAD_TCP_OPT_WIN_SCALE] = "#win-scale.scale.#plain",
+    [TAD_TCP_OPT_TIMESTAMP_LEN] = "#timestamp.length.#plain",
+    [TAD_TCP_OPT_TIMESTAMP] = "#timestamp.value.#plain",
+    [TAD_TCP_OPT_TIMESTAMP_ECHO] = "#timestamp.echo-reply.#plain",
+};
+
+/**
+ * Write field of TCP option of received packet to NDS.
+ *
+ * @param spec_data     TCP CSAP specific data
+ * @param opt           NDS of the option
+ * @param field         Field of the option
+ * @param data          Field value
+ * @param len           Length of the value
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_tcp_write_opt_field(const tcp_csap_specific_data_t *spec_data,
+                        asn_value *opt, tad_tcp_opt_field field,
+                        const void *data, size_t len)
+{
+    if (spec_data->opt_paths[field] != NULL)
+    {
+        return asn_write_value_field_path(opt, data, len,
+                                          spec_data->opt_paths[field]);
+    }
+
+    return asn_write_value_field(opt, data, len, tad_tcp_opt_labels[field]);
+}
 
 /* See description tad_ipstack_impl.h */
 te_errno
@@ -42,8 +79,9 @@ tad_tcp_init_cb(csap_p csap, unsigned int layer)
     tcp_csap_specific_data_t *spec_data;
     const asn_value          *tcp_pdu;
 
-    int32_t value_in_pdu;
-    int     rc = 0;
+    int32_t      value_in_pdu;
+    int          rc = 0;
+    unsigned int i;
 
     spec_data = calloc(1, sizeof(*spec_data));
     if (spec_data == NULL)
@@ -51,6 +89,14 @@ tad_tcp_init_cb(csap_p csap, unsigned int layer)
 
     csap_set_proto_spec_data(csap, layer, spec_data);
 
+    for (i = 0; i < TAD_TCP_OPT_FIELDS; i++)
+    {
+        /* Options are written by labels if compilation fails */
+        if (asn_path_compile(ndn_tcp_option, tad_tcp_opt_labels[i],
+                             &spec_data->opt_paths[i]) != 0)
+            spec_data->opt_paths[i] = NULL;
+    }
+
     tcp_pdu = csap->layers[layer].nds;
 
     /*
@@ -113,10 +159,16 @@ te_errno
 tad_tcp_destroy_cb(csap_p csap, unsigned int layer)
 {
     tcp_csap_specific_data_t *proto_data;
+    unsigned int              i;
 
     proto_data = csap_get_proto_spec_data(csap, layer);
     csap_set_proto_spec_data(csap, layer, NULL);
 
+    if (proto_data != NULL)
+    {
+        for (i = 0; i < TAD_TCP_OPT_FIELDS; i++)
+            asn_path_free(proto_data->opt_paths[i]);
+    }
     free(proto_data);
 
     return 0;
@@ -627,6 +679,9 @@ tad_tcp_match_bin_cb(csap_p           csap,
     tad_cksum_str_code  cksum_str_code;
     te_errno            rc;
 
+    const tcp_csap_specific_data_t *spec_data =
+        csap_get_proto_spec_data(csap, layer);
+
     uint8_t  tmp8;
     size_t   h_len = 0;
 
@@ -722,26 +777,32 @@ tad_tcp_match_bin_cb(csap_p           csap,
             switch (*data)
             {
                 case TE_TCP_OPT_EOL:
-                    rc = asn_write_value_field(opt, NULL, 0, "#eol");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_EOL, NULL, 0);
                     break;
                 case TE_TCP_OPT_NOP:
-                    rc = asn_write_value_field(opt, NULL, 0, "#nop");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_NOP, NULL, 0);
                     break;
                 case TE_TCP_OPT_MSS:
-                    rc = asn_write_value_field(opt, data+1, 1,
-                                               "#mss.length.#plain");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_MSS_LEN,
+                                                 data + 1, 1);
                     if (rc) break;
                     opt_val = ntohs(*((uint16_t *)(data + 2)));
-                    rc = asn_write_value_field(opt, &opt_val, 4,
-                                               "#mss.mss.#plain");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_MSS,
+                                                 &opt_val, 4);
                     data += *(data + 1) - 1;
                     break;
                 case TE_TCP_OPT_WIN_SCALE:
-                    rc = asn_write_value_field(opt, data + 1, 1,
-                                               "#win-scale.length.#plain");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_WIN_SCALE_LEN,
+                                                 data + 1, 1);
                     if (rc) break;
-                    rc = asn_write_value_field(opt, data + 2, 1,
-                                               "#win-scale.scale.#plain");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_WIN_SCALE,
+                                                 data + 2, 1);
                     data += *(data + 1) - 1;
                     break;
 
@@ -754,16 +815,19 @@ tad_tcp_match_bin_cb(csap_p           csap,
                     opt = NULL;
                     break;
                 case TE_TCP_OPT_TIMESTAMP:
-                    rc = asn_write_value_field(opt, data+1, 1,
-                                               "#timestamp.length.#plain");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_TIMESTAMP_LEN,
+                                                 data + 1, 1);
                     if (rc) break;
                     opt_val = ntohl(*((uint32_t *)(data + 2)));
-                    rc = asn_write_value_field(opt, &opt_val, 4,
-                                               "#timestamp.value.#plain");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_TIMESTAMP,
+                                                 &opt_val, 4);
                     if (rc) break;
                     opt_val = ntohl(*((uint32_t *)(data + 6)));
-                    rc = asn_write_value_field(opt, &opt_val, 4,
-                                           "#timestamp.echo-reply.#plain");
+                    rc = tad_tcp_write_opt_field(spec_data, opt,
+                                                 TAD_TCP_OPT_TIMESTAMP_ECHO,
+                                                 &opt_val, 4);
                     data += *(data + 1) - 1;
                     break;
             }
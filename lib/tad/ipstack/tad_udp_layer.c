@@ -80,6 +80,8 @@ tad_udp_init_cb(csap_p csap, unsigned int layer)
     rc = tad_bps_pkt_frag_init(tad_udp_bps_hdr,
                                TE_ARRAY_LEN(tad_udp_bps_hdr),
                                layer_nds, &proto_data->hdr);
+    if (rc == 0)
+        rc = tad_bps_pkt_frag_init_paths(&proto_data->hdr, ndn_udp_header);
 
     assert(tad_bps_pkt_frag_data_bitlen(&proto_data->hdr, NULL) ==
                (TAD_UDP_HDR_LEN << 3));
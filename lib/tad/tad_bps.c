@@ -54,6 +54,7 @@ tad_bps_pkt_frag_init(const tad_bps_pkt_frag *descr,
 
     bps->tx_def = calloc(fields, sizeof(bps->tx_def[0]));
     bps->rx_def = calloc(fields, sizeof(bps->rx_def[0]));
+    bps->paths = NULL;
     if (bps->tx_def == NULL || bps->rx_def == NULL)
     {
         ERROR("%s(): calloc() failed", __FUNCTION__);
@@ -138,6 +139,44 @@ tad_bps_pkt_frag_init(const tad_bps_pkt_frag *descr,
     return 0;
 }
 
+/* See description in tad_bps.h */
+te_errno
+tad_bps_pkt_frag_init_paths(tad_bps_pkt_frag_def *bps,
+                            const asn_type *nds_type)
+{
+    char            tmp[64];
+    unsigned int    i;
+    te_errno        rc;
+
+    if (bps == NULL || nds_type == NULL || bps->paths != NULL)
+    {
+        ERROR("%s(): Invalid arguments", __FUNCTION__);
+        return TE_RC(TE_TAD_BPS, TE_EINVAL);
+    }
+
+    bps->paths = calloc(bps->fields, sizeof(bps->paths[0]));
+    if (bps->paths == NULL)
+    {
+        ERROR("%s(): calloc() failed", __FUNCTION__);
+        return TE_RC(TE_TAD_BPS, TE_ENOMEM);
+    }
+
+    for (i = 0; i < bps->fields; ++i)
+    {
+        snprintf(tmp, sizeof(tmp), "%s.#plain", bps->descr[i].name);
+        rc = asn_path_compile(nds_type, tmp, &bps->paths[i]);
+        if (rc != 0)
+        {
+            /* The field is written by labels then */
+            VERB("%s(): failed to compile path '%s': %r",
+                 __FUNCTION__, tmp, rc);
+            bps->paths[i] = NULL;
+        }
+    }
+
+    return 0;
+}
+
 /* See description in tad_bps.h */
 void
 tad_bps_pkt_frag_free(tad_bps_pkt_frag_def *bps)
@@ -151,9 +190,12 @@ tad_bps_pkt_frag_free(tad_bps_pkt_frag_def *bps)
     {
         tad_data_unit_clear(bps->tx_def + i);
         tad_data_unit_clear(bps->rx_def + i);
+        if (bps->paths != NULL)
+            asn_path_free(bps->paths[i]);
     }
     free(bps->tx_def);
     free(bps->rx_def);
+    free(bps->paths);
 }
 
 /* See description in tad_bps.h */
@@ -634,26 +676,42 @@ tad_bps_pkt_frag_match_do(const tad_bps_pkt_frag_def *def,
     return rc;
 }
 
-/* See description in tad_bps.h */
-te_errno
-tad_data_unit_to_nds(asn_value *nds, const char *name,
-                     tad_data_unit_t *du)
+/**
+ * Put data unit value to NDS. The value is written using compiled path
+ * to the plain value if it is specified, by labels otherwise.
+ *
+ * @param nds       NDS to put value to
+ * @param path      Compiled path or @c NULL
+ * @param name      Name of the field
+ * @param du        Data unit
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_data_unit_to_nds_path(asn_value *nds, const asn_path *path,
+                          const char *name, const tad_data_unit_t *du)
 {
     te_errno    rc;
     char        tmp[64];
 
-    snprintf(tmp, sizeof(tmp), "%s.#plain", name);
+    if (path == NULL)
+        snprintf(tmp, sizeof(tmp), "%s.#plain", name);
 
     switch (du->du_type)
     {
         case TAD_DU_I32:
-            rc = asn_write_int32(nds, du->val_i32, tmp);
+            rc = (path != NULL) ?
+                 asn_write_int32_path(nds, du->val_i32, path) :
+                 asn_write_int32(nds, du->val_i32, tmp);
             break;
         case TAD_DU_I64:
             rc = TE_RC(TE_TAD_CH, TE_EOPNOTSUPP);
             break;
         case TAD_DU_OCTS:
-            rc = asn_write_value_field(nds, du->val_data.oct_str,
+            rc = (path != NULL) ?
+                 asn_write_value_field_path(nds, du->val_data.oct_str,
+                                            du->val_data.len, path) :
+                 asn_write_value_field(nds, du->val_data.oct_str,
                                        du->val_data.len, tmp);
             break;
         default:
@@ -662,11 +720,42 @@ tad_data_unit_to_nds(asn_value *nds, const char *name,
 
     if (rc != 0)
     {
-        WARN("data_unit_to_nds() rc %r, name '%s'", rc, tmp);
+        WARN("data_unit_to_nds() rc %r, name '%s.#plain'", rc, name);
     }
     return rc;
 }
 
+/* See description in tad_bps.h */
+te_errno
+tad_data_unit_to_nds(asn_value *nds, const char *name,
+                     tad_data_unit_t *du)
+{
+    return tad_data_unit_to_nds_path(nds, NULL, name, du);
+}
+
+/**
+ * Get compiled path to plain value of the fragment field in NDS.
+ * Paths are compiled by tad_bps_pkt_frag_init_paths() and never
+ * changed after that, so the function may be called concurrently.
+ *
+ * @param def       Binary PDU fragment definition
+ * @param i         Index of the field
+ * @param nds       NDS to put field value to
+ *
+ * @return Compiled path or @c NULL if there is no path compiled for
+ *         NDS of this type.
+ */
+static const asn_path *
+tad_bps_pkt_frag_path(const tad_bps_pkt_frag_def *def, unsigned int i,
+                      const asn_value *nds)
+{
+    if (def->paths == NULL || def->paths[i] == NULL ||
+        asn_path_type(def->paths[i]) != asn_get_type(nds))
+        return NULL;
+
+    return def->paths[i];
+}
+
 /* See description in tad_bps.h */
 te_errno
 tad_bps_pkt_frag_match_post(const tad_bps_pkt_frag_def *def,
@@ -677,6 +766,7 @@ tad_bps_pkt_frag_match_post(const tad_bps_pkt_frag_def *def,
     te_errno                rc = 0;
     unsigned int            i;
     size_t                  len;
+    const asn_path         *path;
 
     if (nds == NULL)
         return 0;
@@ -707,7 +797,9 @@ tad_bps_pkt_frag_match_post(const tad_bps_pkt_frag_def *def,
         if (len > 0)
             tad_bin_to_data_unit(pkt, *bitoff, len, pkt_data->dus + i);
 
-        rc = tad_data_unit_to_nds(nds, def->descr[i].name, pkt_data->dus + i);
+        path = tad_bps_pkt_frag_path(def, i, nds);
+        rc = tad_data_unit_to_nds_path(nds, path, def->descr[i].name,
+                                       pkt_data->dus + i);
         if (rc != 0)
         {
             WARN("bps_frag_match: rc %r, field idx %d, name '%s'",
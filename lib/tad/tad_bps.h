@@ -62,6 +62,11 @@ typedef struct tad_bps_pkt_frag_def {
                                          fragment fields Tx defaults */
     tad_data_unit_t        *rx_def; /**< Array of TAD data units for
                                          fragment fields Rx defaults */
+    asn_path              **paths;  /**< Array of compiled paths to
+                                         plain values of fragment
+                                         fields in NDS or @c NULL
+                                         (see
+                                         tad_bps_pkt_frag_init_paths()) */
 } tad_bps_pkt_frag_def;
 
 /**
@@ -91,6 +96,26 @@ extern te_errno tad_bps_pkt_frag_init(const tad_bps_pkt_frag *descr,
                                       const asn_value        *layer_spec,
                                       tad_bps_pkt_frag_def   *bps);
 
+/**
+ * Compile paths to plain values of fragment fields in NDS of the given
+ * type, so that tad_bps_pkt_frag_match_post() writes matched fields
+ * to such NDS without resolving labels. Fields of NDS of other types
+ * (and fields which are not found in @p nds_type) are still written
+ * by labels.
+ *
+ * It should be called right after tad_bps_pkt_frag_init() when the
+ * layer is initialized: paths are not changed after that, so the
+ * definition may be shared by receive workers.
+ *
+ * @param bps           BPS internal data initialized by
+ *                      tad_bps_pkt_frag_init()
+ * @param nds_type      Type of NDS passed to tad_bps_pkt_frag_match_post()
+ *
+ * @return Status code.
+ */
+extern te_errno tad_bps_pkt_frag_init_paths(tad_bps_pkt_frag_def *bps,
+                                            const asn_type *nds_type);
+
 /**
  * Free resources allocated by tad_bps_pkt_frag_init().
  *
@@ -322,6 +322,66 @@ tad_csap_create(const char *stack, const char *spec_str, csap_p *new_csap_p)
         goto exit;
     }
 
+    /*
+     * 'binary-reports' parameter processing: it is the maximum version
+     * of binary encoding the Test Engine is able to decode
+     */
+    rc = asn_read_int32(new_csap->nds, &i32_tmp, "params.binary-reports");
+    if (rc == 0)
+    {
+        new_csap->bin_reports = (i32_tmp <= 0) ? 0 :
+                                MIN((unsigned int)i32_tmp, ASN_BIN_VERSION);
+    }
+    else if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        /* Unspecified, report packets in text */
+    }
+    else
+    {
+        ERROR("Failed to read 'binary-reports' from CSAP NDS: %r", rc);
+        goto exit;
+    }
+
+    /* 'receive-workers' parameter processing */
+    rc = asn_read_int32(new_csap->nds, &i32_tmp, "params.receive-workers");
+    if (rc == 0)
+    {
+        new_csap->recv_workers = (i32_tmp <= 0) ? 0 :
+            MIN((unsigned int)i32_tmp, TAD_RECV_WORKERS_MAX);
+    }
+    else if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        /* Unspecified, receive in the Receiver thread */
+    }
+    else
+    {
+        ERROR("Failed to read 'receive-workers' from CSAP NDS: %r", rc);
+        goto exit;
+    }
+
+    /* 'receive-fanout' parameter processing */
+    rc = asn_read_int32(new_csap->nds, &i32_tmp, "params.receive-fanout");
+    if (rc == 0)
+    {
+        if (i32_tmp != TAD_RECV_FANOUT_HASH &&
+            i32_tmp != TAD_RECV_FANOUT_CPU)
+        {
+            ERROR("Invalid 'receive-fanout' %d in CSAP NDS", i32_tmp);
+            rc = TE_RC(TE_TAD_CH, TE_EINVAL);
+            goto exit;
+        }
+        new_csap->recv_fanout = i32_tmp;
+    }
+    else if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        /* Unspecified, spread packets by hash of the flow */
+    }
+    else
+    {
+        ERROR("Failed to read 'receive-fanout' from CSAP NDS: %r", rc);
+        goto exit;
+    }
+
     /* Get layers specification */
     rc = asn_get_child_value(new_csap->nds, &csap_layers,
                              PRIVATE, NDN_CSAP_LAYERS);
@@ -631,7 +691,8 @@ rcf_ch_trsend_start(struct rcf_comm_connection *rcfc,
         goto send_answer_no_csap;
     }
 
-    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen);
+    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen,
+                            csap->bin_reports);
     if (rc != 0)
         goto send_answer_fail_reply_ctx_init;
 
@@ -742,7 +803,8 @@ rcf_ch_trrecv_start(struct rcf_comm_connection *rcfc,
         goto send_answer_no_csap;
     }
 
-    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen);
+    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen,
+                            csap->bin_reports);
     if (rc != 0)
         goto send_answer_fail_reply_ctx_init;
 
@@ -809,7 +871,8 @@ tad_trrecv_op(rcf_comm_connection *rcfc,
     if (rc != 0)
         goto send_answer_fail_command;
 
-    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen);
+    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen,
+                            csap->bin_reports);
     if (rc != 0)
         goto send_answer_fail_reply_ctx_init;
 
@@ -982,7 +1045,8 @@ rcf_ch_trsend_recv(struct rcf_comm_connection *rcfc,
 
     CSAP_UNLOCK(csap);
 
-    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen);
+    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen,
+                            csap->bin_reports);
     if (rc != 0)
         goto send_answer_fail_reply_ctx_init;
 
@@ -1124,7 +1188,8 @@ rcf_ch_trpoll(struct rcf_comm_connection *rcfc,
     if ((rc != TE_ETIMEDOUT) || (timeout == 0))
         goto send_answer_bad_state;
 
-    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen);
+    rc = tad_reply_rcf_init(&reply_ctx, rcfc, cbuf, answer_plen,
+                            csap->bin_reports);
     if (rc != 0)
         goto send_answer_fail_reply_ctx_init;
 
@@ -1274,6 +1339,35 @@ rcf_ch_csap_param(struct rcf_comm_connection *rcfc,
              no_match_pkts);
         SEND_ANSWER("0 %u", no_match_pkts);
     }
+    else if (strcmp(param, CSAP_PARAM_KERN_NO_MATCH_PKTS) == 0)
+    {
+        unsigned int kern_no_match_pkts;
+
+        kern_no_match_pkts =
+            csap_get_recv_context(csap)->kern_no_match_pkts;
+
+        VERB("CSAP get_param, get number of pkts filtered out in "
+             "the kernel %u\n", kern_no_match_pkts);
+        SEND_ANSWER("0 %u", kern_no_match_pkts);
+    }
+    else if (strcmp(param, CSAP_PARAM_TOTAL_SENT) == 0)
+    {
+        VERB("CSAP get_param, get number of sent pkts %u\n",
+             csap->sender.sent_pkts);
+        SEND_ANSWER("0 %u", csap->sender.sent_pkts);
+    }
+    else if (strcmp(param, CSAP_PARAM_TOTAL_BYTES) == 0)
+    {
+        VERB("CSAP get_param, get number of sent bytes %llu\n",
+             (unsigned long long)csap->sender.sent_bytes);
+        SEND_ANSWER("0 %llu", (unsigned long long)csap->sender.sent_bytes);
+    }
+    else if (strcmp(param, CSAP_PARAM_SEND_CALLS) == 0)
+    {
+        VERB("CSAP get_param, get number of write calls %u\n",
+             csap->sender.send_calls);
+        SEND_ANSWER("0 %u", csap->sender.send_calls);
+    }
     else if (strcmp(param, CSAP_PARAM_FIRST_PACKET_TIME) == 0)
     {
         VERB("CSAP get_param, get first pkt, %u.%u\n",
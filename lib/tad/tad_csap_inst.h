@@ -100,6 +100,13 @@ typedef struct csap_layer_t {
                                                   layer tag field in TAD packet
                                                   segment control blocks during
                                                   read-write opearation */
+    unsigned int rw_borrowed_pkt_data;       /**< Number of receive queues
+                                                  of this layer which read
+                                                  packets with segments
+                                                  without data free function
+                                                  referring to memory which
+                                                  is valid until the next
+                                                  read only (if non-zero) */
     asn_value   *nds;                        /**< ASN.1 value with CSAP
                                                   specification layer PDU */
 
@@ -169,6 +176,16 @@ typedef struct csap_instance {
                                                  latency of stop/destroy
                                                  operations) */
     unsigned int    recv_timeout;   /**< Default receive timeout */
+    unsigned int    bin_reports;    /**< Version of binary encoding of
+                                         reported packets or @c 0 to
+                                         report them in text */
+    unsigned int    recv_workers;   /**< Number of threads to receive
+                                         and match packets in parallel,
+                                         @c 0 or @c 1 to do it in
+                                         the Receiver thread */
+    unsigned int    recv_fanout;    /**< Mode of spreading packets over
+                                         receive workers
+                                         (tad_recv_fanout) */
 
     struct timeval  wait_for;   /**< Zero or moment of timeout
                                      current CSAP operation */
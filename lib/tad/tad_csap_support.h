@@ -285,6 +285,39 @@ typedef te_errno (*csap_low_resource_cb_t)(csap_p csap);
 typedef te_errno (*csap_read_cb_t)(csap_p csap, unsigned int timeout,
                                    tad_pkt *pkt, size_t *pkt_len);
 
+/**
+ * Callback type to prepare low-layer resources of CSAP to receive
+ * packets by a number of queues which are read in parallel. Media
+ * spreads received packets over the queues. The queue @c 0 is
+ * the one prepared by csap_low_resource_cb_t prepare_recv_cb,
+ * resources of all queues are released by shutdown_recv_cb.
+ *
+ * @param csap          CSAP instance
+ * @param n_queues      Number of queues
+ * @param fanout        Mode of spreading packets (tad_recv_fanout)
+ *
+ * @return Status code.
+ */
+typedef te_errno (*csap_prepare_recv_queues_cb_t)(csap_p       csap,
+                                                  unsigned int n_queues,
+                                                  unsigned int fanout);
+
+/**
+ * Callback type to read data from a receive queue of media of the CSAP.
+ * It may be called for different queues concurrently.
+ *
+ * @param csap          CSAP instance
+ * @param queue         Index of the queue
+ * @param timeout       Timeout of waiting for data in microseconds
+ * @param pkt           Packet for received data
+ * @param pkt_len       Location for real length of the received packet
+ *
+ * @return Status code.
+ */
+typedef te_errno (*csap_read_queue_cb_t)(csap_p csap, unsigned int queue,
+                                         unsigned int timeout,
+                                         tad_pkt *pkt, size_t *pkt_len);
+
 /**
  * Callback type to write data to media of the CSAP.
  *
@@ -295,6 +328,23 @@ typedef te_errno (*csap_read_cb_t)(csap_p csap, unsigned int timeout,
  */
 typedef te_errno (*csap_write_cb_t)(csap_p csap, const tad_pkt *pkt);
 
+/**
+ * Callback type to write a batch of packets to media of the CSAP.
+ *
+ * Packets are sent in the list order. The callback is optional,
+ * if it is not provided, packets are passed to csap_write_cb_t one
+ * by one.
+ *
+ * @param csap          CSAP instance
+ * @param pkts          Packets to send
+ * @param sent          Location for number of packets sent
+ *                      (from the list head) before the failure
+ *
+ * @return Status code.
+ */
+typedef te_errno (*csap_write_pkts_cb_t)(csap_p csap, const tad_pkts *pkts,
+                                         unsigned int *sent);
+
 /**
  * Callback type to write data to media of CSAP and read
  *  data from media just after write, to get answer to sent request.
@@ -384,12 +434,16 @@ typedef struct csap_spt_type_t {
 
     csap_low_resource_cb_t  prepare_send_cb;
     csap_write_cb_t         write_cb;
+    csap_write_pkts_cb_t    write_pkts_cb;
     csap_low_resource_cb_t  shutdown_send_cb;
 
     csap_low_resource_cb_t  prepare_recv_cb;
     csap_read_cb_t          read_cb;
     csap_low_resource_cb_t  shutdown_recv_cb;
 
+    csap_prepare_recv_queues_cb_t   prepare_recv_queues_cb;
+    csap_read_queue_cb_t            read_queue_cb;
+
     csap_write_read_cb_t    write_read_cb;
 
 } *csap_spt_type_p, csap_spt_type_t;
@@ -404,12 +458,16 @@ typedef struct csap_spt_type_t {
                                 \
     .prepare_send_cb  = NULL,   \
     .write_cb         = NULL,   \
+    .write_pkts_cb    = NULL,   \
     .shutdown_send_cb = NULL,   \
                                 \
     .prepare_recv_cb  = NULL,   \
     .read_cb          = NULL,   \
     .shutdown_recv_cb = NULL,   \
                                 \
+    .prepare_recv_queues_cb = NULL, \
+    .read_queue_cb    = NULL,   \
+                                \
     .write_read_cb    = NULL
 
 
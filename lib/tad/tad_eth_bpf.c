@@ -0,0 +1,750 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD Ethernet in-kernel filter
+ *
+ * Compiler of traffic patterns of Ethernet-based CSAPs to classic BPF
+ * programs to be attached to PF_PACKET sockets.
+ *
+ * The program consists of a prologue which checks the packet type
+ * against the receive mode and passes frames with in-line VLAN tags or
+ * LLC encapsulation to user space, followed by a block per pattern
+ * unit. A unit block is a sequence of checks, each of them jumps to
+ * the next unit block on mismatch, and the block ends with
+ * an instruction which accepts the frame. The program rejects frames
+ * which do not match any unit.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "TAD Ethernet BPF"
+
+#include "te_config.h"
+
+#if HAVE_LINUX_FILTER_H && HAVE_LINUX_IF_PACKET_H
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_ASSERT_H
+#include <assert.h>
+#endif
+#if HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#if HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#if HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#if HAVE_LINUX_IF_ETHER_H
+#include <linux/if_ether.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_alloc.h"
+#include "logger_api.h"
+
+#include "ndn.h"
+#include "ndn_eth.h"
+#include "ndn_ipstack.h"
+
+#include "tad_csap_inst.h"
+#include "tad_bps.h"
+#include "tad_recv.h"
+#include "tad_utils.h"
+#include "tad_eth_bpf.h"
+
+
+/** Value returned by the program for frames passed to user space */
+#define TAD_ETH_BPF_ACCEPT      0xffffffff
+
+/** Maximum number of payload octets matched in the kernel */
+#define TAD_ETH_BPF_PLD_MAX     64
+
+/**
+ * Maximum number of jumps in a unit block which are resolved at
+ * the end of the block. Jump offsets in classic BPF are limited by
+ * 255, so unit blocks are not longer anyway.
+ */
+#define TAD_ETH_BPF_FIXUPS_MAX  512
+
+/** Offset of the network layer header in the frame */
+#define TAD_ETH_BPF_L3_OFF      ETH_HLEN
+
+/** Offset of the transport layer header after IPv6 header */
+#define TAD_ETH_BPF_IP6_L4_OFF  (TAD_ETH_BPF_L3_OFF + 40)
+
+/** Length of the UDP header */
+#define TAD_ETH_BPF_UDP_HLEN    8
+
+/** Maximum length of the field matched in the kernel */
+#define TAD_ETH_BPF_FIELD_MAX   16
+
+/** Jump targets resolved at the end of the unit block */
+enum {
+    TAD_ETH_BPF_FAIL = -1,  /**< Try the next unit */
+    TAD_ETH_BPF_PASS = -2,  /**< Pass the frame to user space */
+};
+
+/** Jump to be resolved at the end of the unit block */
+typedef struct tad_eth_bpf_fixup {
+    unsigned int    pc;     /**< Index of the jump instruction */
+    te_bool         jt;     /**< Jump if true or if false */
+    int             target; /**< TAD_ETH_BPF_FAIL or TAD_ETH_BPF_PASS */
+} tad_eth_bpf_fixup;
+
+/** Program being compiled */
+typedef struct tad_eth_bpf_prog {
+    struct sock_filter *insns;      /**< Instructions */
+    unsigned int        len;        /**< Number of instructions */
+    unsigned int        checks;     /**< Number of checks in the current
+                                         unit block */
+    te_bool             empty_unit; /**< Is there a unit matching any
+                                         frame? */
+    te_bool             too_long;   /**< The program does not fit in
+                                         limits of the classic BPF */
+
+    unsigned int        n_fixups;   /**< Number of unresolved jumps */
+    tad_eth_bpf_fixup   fixups[TAD_ETH_BPF_FIXUPS_MAX]; /**< Unresolved
+                                                             jumps */
+} tad_eth_bpf_prog;
+
+/**
+ * Set the jump target of the instruction.
+ *
+ * @param prog          Program
+ * @param jt            Jump if true or if false
+ * @param target        Forward offset or TAD_ETH_BPF_FAIL/PASS
+ */
+static void
+tad_eth_bpf_target(tad_eth_bpf_prog *prog, te_bool jt, int target)
+{
+    struct sock_filter *insn = prog->insns + prog->len;
+
+    if (target >= 0)
+    {
+        if (target > UINT8_MAX)
+            prog->too_long = TRUE;
+        else if (jt)
+            insn->jt = target;
+        else
+            insn->jf = target;
+        return;
+    }
+
+    if (prog->n_fixups == TE_ARRAY_LEN(prog->fixups))
+    {
+        prog->too_long = TRUE;
+        return;
+    }
+    prog->fixups[prog->n_fixups].pc = prog->len;
+    prog->fixups[prog->n_fixups].jt = jt;
+    prog->fixups[prog->n_fixups].target = target;
+    prog->n_fixups++;
+}
+
+/**
+ * Add an instruction to the program.
+ *
+ * @param prog          Program
+ * @param code          Instruction code
+ * @param k             Generic field of the instruction
+ * @param jt            Jump if true (for conditional jumps only)
+ * @param jf            Jump if false (for conditional jumps only)
+ */
+static void
+tad_eth_bpf_emit(tad_eth_bpf_prog *prog, uint16_t code, uint32_t k,
+                 int jt, int jf)
+{
+    struct sock_filter *insn;
+
+    if (prog->len >= BPF_MAXINSNS)
+    {
+        prog->too_long = TRUE;
+        return;
+    }
+
+    insn = prog->insns + prog->len;
+    insn->code = code;
+    insn->jt = insn->jf = 0;
+    insn->k = k;
+
+    if (BPF_CLASS(code) == BPF_JMP && BPF_OP(code) != BPF_JA)
+    {
+        tad_eth_bpf_target(prog, TRUE, jt);
+        tad_eth_bpf_target(prog, FALSE, jf);
+    }
+
+    prog->len++;
+}
+
+/**
+ * Finish the unit block: add the instruction accepting the frame and
+ * resolve jumps to it and to the next unit block.
+ *
+ * @param prog          Program
+ */
+static void
+tad_eth_bpf_unit_end(tad_eth_bpf_prog *prog)
+{
+    unsigned int    pass = prog->len;
+    unsigned int    i;
+
+    tad_eth_bpf_emit(prog, BPF_RET | BPF_K, TAD_ETH_BPF_ACCEPT, 0, 0);
+
+    for (i = 0; i < prog->n_fixups && !prog->too_long; ++i)
+    {
+        tad_eth_bpf_fixup  *fixup = prog->fixups + i;
+        unsigned int        target;
+        unsigned int        off;
+
+        target = (fixup->target == TAD_ETH_BPF_PASS) ? pass : pass + 1;
+        off = target - fixup->pc - 1;
+        if (off > UINT8_MAX)
+            prog->too_long = TRUE;
+        else if (fixup->jt)
+            prog->insns[fixup->pc].jt = off;
+        else
+            prog->insns[fixup->pc].jf = off;
+    }
+    prog->n_fixups = 0;
+
+    if (prog->checks == 0)
+        prog->empty_unit = TRUE;
+    prog->checks = 0;
+}
+
+/**
+ * Add checks of the frame field value.
+ *
+ * @param prog          Program
+ * @param ind           Is offset relative to the index register?
+ * @param off           Offset of the field
+ * @param value         Expected value of the field
+ * @param mask          Mask of bits to be checked
+ * @param len           Length of the field
+ */
+static void
+tad_eth_bpf_match(tad_eth_bpf_prog *prog, te_bool ind, uint32_t off,
+                  const uint8_t *value, const uint8_t *mask, size_t len)
+{
+    while (len > 0)
+    {
+        size_t      n = (len >= 4) ? 4 : (len >= 2) ? 2 : 1;
+        uint32_t    full = (n == 4) ? UINT32_MAX : (1U << (n * 8)) - 1;
+        uint32_t    v = 0;
+        uint32_t    m = 0;
+        size_t      i;
+
+        for (i = 0; i < n; ++i)
+        {
+            v = (v << 8) | value[i];
+            m = (m << 8) | mask[i];
+        }
+
+        if (m != 0)
+        {
+            tad_eth_bpf_emit(prog, BPF_LD | (ind ? BPF_IND : BPF_ABS) |
+                             ((n == 4) ? BPF_W : (n == 2) ? BPF_H : BPF_B),
+                             off, 0, 0);
+            if (m != full)
+                tad_eth_bpf_emit(prog, BPF_ALU | BPF_AND | BPF_K, m, 0, 0);
+            tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, v & m,
+                             0, TAD_ETH_BPF_FAIL);
+            prog->checks++;
+        }
+
+        value += n;
+        mask += n;
+        off += n;
+        len -= n;
+    }
+}
+
+/**
+ * Add checks of the DATA-UNIT field, if it may be matched in the kernel.
+ *
+ * @param prog          Program
+ * @param pdu           PDU of the pattern unit or @c NULL
+ * @param csap_pdu      CSAP layer specification or @c NULL
+ * @param tag           Tag of the field in the PDU
+ * @param rx_def_tag    Tag of the field in the CSAP layer specification
+ *                      with receive default or @c ASN_TAG_INVALID
+ * @param ind           Is offset relative to the index register?
+ * @param off           Offset of the field
+ * @param len           Length of the field in octets
+ */
+static void
+tad_eth_bpf_field(tad_eth_bpf_prog *prog, const asn_value *pdu,
+                  const asn_value *csap_pdu, asn_tag_value tag,
+                  asn_tag_value rx_def_tag, te_bool ind, uint32_t off,
+                  size_t len)
+{
+    uint8_t value[TAD_ETH_BPF_FIELD_MAX];
+    uint8_t mask[TAD_ETH_BPF_FIELD_MAX];
+
+    assert(len <= TAD_ETH_BPF_FIELD_MAX);
+
+    if (tad_du_get_value_mask(pdu, csap_pdu, tag, rx_def_tag,
+                              value, mask, len))
+        tad_eth_bpf_match(prog, ind, off, value, mask, len);
+}
+
+/**
+ * Add checks of the VLAN tag of Ethernet PDU. In-line tags are passed
+ * to user space by the prologue, so only the tag extracted by the
+ * kernel is checked.
+ *
+ * @param prog          Program
+ * @param pdu           Ethernet PDU of the pattern unit
+ */
+static void
+tad_eth_bpf_vlan(tad_eth_bpf_prog *prog, const asn_value *pdu)
+{
+#if defined(SKF_AD_VLAN_TAG) && defined(SKF_AD_VLAN_TAG_PRESENT)
+    const asn_value    *tagged;
+    asn_value          *tag_hdr;
+    asn_tag_value       tagged_tag;
+    uint8_t             value[2];
+    uint8_t             mask[2];
+    uint16_t            tci = 0;
+    uint16_t            tci_mask = 0;
+
+    if (pdu == NULL ||
+        asn_get_child_value(pdu, &tagged, PRIVATE,
+                            NDN_TAG_VLAN_TAGGED) != 0 ||
+        asn_get_choice_value(tagged, &tag_hdr, NULL, &tagged_tag) != 0 ||
+        tagged_tag != NDN_TAG_VLAN_TAG_HEADER)
+        return;
+
+    if (tad_du_get_value_mask(tag_hdr, NULL, NDN_TAG_VLAN_TAG_HEADER_VID,
+                              ASN_TAG_INVALID, value, mask, sizeof(value)))
+    {
+        tci |= ((value[0] << 8) | value[1]) & 0xfff;
+        tci_mask |= ((mask[0] << 8) | mask[1]) & 0xfff;
+    }
+    if (tad_du_get_value_mask(tag_hdr, NULL, NDN_TAG_VLAN_TAG_HEADER_PRIO,
+                              ASN_TAG_INVALID, value, mask, sizeof(value)))
+    {
+        tci |= (value[1] & 0x7) << 13;
+        tci_mask |= (mask[1] & 0x7) << 13;
+    }
+
+    /* The tag is present if any of its fields is specified */
+    tad_eth_bpf_emit(prog, BPF_LD | BPF_W | BPF_ABS,
+                     SKF_AD_OFF + SKF_AD_VLAN_TAG_PRESENT, 0, 0);
+    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0,
+                     TAD_ETH_BPF_FAIL, 0);
+    prog->checks++;
+
+    /* CFI bit is not reported reliably by old kernels */
+    if (tci_mask != 0)
+    {
+        tad_eth_bpf_emit(prog, BPF_LD | BPF_W | BPF_ABS,
+                         SKF_AD_OFF + SKF_AD_VLAN_TAG, 0, 0);
+        tad_eth_bpf_emit(prog, BPF_ALU | BPF_AND | BPF_K, tci_mask, 0, 0);
+        tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, tci,
+                         0, TAD_ETH_BPF_FAIL);
+    }
+#else
+    UNUSED(prog);
+    UNUSED(pdu);
+#endif
+}
+
+/**
+ * Add checks of the payload mask.
+ *
+ * @param prog          Program
+ * @param spec          Payload specification of the pattern unit
+ * @param udp           Is it payload of UDP datagram?
+ * @param ind           Is offset relative to the index register?
+ * @param off           Offset of the payload
+ */
+static void
+tad_eth_bpf_payload(tad_eth_bpf_prog *prog, const tad_payload_spec_t *spec,
+                    te_bool udp, te_bool ind, uint32_t off)
+{
+    const uint8_t  *value;
+    const uint8_t  *mask = NULL;
+    uint8_t        *ones = NULL;
+    size_t          len;
+
+    switch (spec->type)
+    {
+        case TAD_PLD_MASK:
+            value = spec->mask.value;
+            mask = spec->mask.mask;
+            len = spec->mask.length;
+            break;
+
+        case TAD_PLD_BYTES:
+            value = spec->plain.data;
+            len = spec->plain.length;
+            break;
+
+        default:
+            return;
+    }
+
+    len = MIN(len, TAD_ETH_BPF_PLD_MAX);
+    if (len == 0)
+        return;
+
+    if (mask == NULL)
+    {
+        ones = TE_ALLOC(len);
+        if (ones == NULL)
+            return;
+        memset(ones, 0xff, len);
+        mask = ones;
+    }
+
+    /*
+     * User space matches payload shorter than the mask by its length,
+     * so such frames are passed. Payload over UDP is limited by UDP
+     * length, Ethernet frame payload is up to the end of the frame.
+     */
+    if (udp)
+    {
+        tad_eth_bpf_emit(prog, BPF_LD | BPF_H | (ind ? BPF_IND : BPF_ABS),
+                         off - TAD_ETH_BPF_UDP_HLEN + 4, 0, 0);
+        tad_eth_bpf_emit(prog, BPF_JMP | BPF_JGE | BPF_K,
+                         TAD_ETH_BPF_UDP_HLEN + len, 0, TAD_ETH_BPF_PASS);
+    }
+    else
+    {
+        tad_eth_bpf_emit(prog, BPF_LD | BPF_W | BPF_LEN, 0, 0, 0);
+        tad_eth_bpf_emit(prog, BPF_JMP | BPF_JGE | BPF_K, off + len,
+                         0, TAD_ETH_BPF_PASS);
+    }
+
+    tad_eth_bpf_match(prog, ind, off, value, mask, len);
+
+    free(ones);
+}
+
+/**
+ * Get PDU of the pattern unit.
+ *
+ * @param pdus          Sequence of PDUs of the pattern unit or @c NULL
+ * @param layer         Layer index
+ *
+ * @return PDU or @c NULL.
+ */
+static const asn_value *
+tad_eth_bpf_layer_pdu(const asn_value *pdus, unsigned int layer)
+{
+    asn_value *gen_pdu;
+    asn_value *pdu;
+
+    if (pdus == NULL ||
+        asn_get_indexed(pdus, &gen_pdu, layer, NULL) != 0 ||
+        asn_get_choice_value(gen_pdu, &pdu, NULL, NULL) != 0)
+        return NULL;
+
+    return pdu;
+}
+
+/**
+ * Compile pattern unit block.
+ *
+ * @param csap          CSAP instance
+ * @param prog          Program
+ * @param unit          Pattern unit data
+ */
+static void
+tad_eth_bpf_unit(csap_p csap, tad_eth_bpf_prog *prog,
+                 const tad_recv_ptrn_unit_data *unit)
+{
+    const asn_value    *pdus = NULL;
+    const asn_value    *pdu;
+    const asn_value    *csap_pdu;
+    unsigned int        layer;
+    uint16_t            l3 = 0;
+    uint8_t             l4 = 0;
+    te_bool             pld = FALSE;
+    te_bool             pld_udp = FALSE;
+    te_bool             pld_ind = FALSE;
+    uint32_t            pld_off = 0;
+
+    if (asn_get_child_value(unit->nds, &pdus, PRIVATE, NDN_PU_PDUS) != 0)
+        pdus = NULL;
+
+    for (layer = csap->depth; layer-- > 0; )
+    {
+        pdu = tad_eth_bpf_layer_pdu(pdus, layer);
+        csap_pdu = csap->layers[layer].nds;
+        pld = FALSE;
+
+        switch (csap->layers[layer].proto_tag)
+        {
+            case TE_PROTO_ETH:
+                if (layer != csap->depth - 1)
+                    goto stop;
+
+                tad_eth_bpf_field(prog, pdu, csap_pdu, NDN_TAG_802_3_DST,
+                                  NDN_TAG_ETH_LOCAL, FALSE, 0, ETH_ALEN);
+                tad_eth_bpf_field(prog, pdu, csap_pdu, NDN_TAG_802_3_SRC,
+                                  NDN_TAG_ETH_REMOTE, FALSE, ETH_ALEN,
+                                  ETH_ALEN);
+                tad_eth_bpf_field(prog, pdu, NULL,
+                                  NDN_TAG_802_3_LENGTH_TYPE,
+                                  ASN_TAG_INVALID, FALSE, 2 * ETH_ALEN, 2);
+                tad_eth_bpf_vlan(prog, pdu);
+
+                pld = TRUE;
+                pld_off = TAD_ETH_BPF_L3_OFF;
+                break;
+
+            case TE_PROTO_IP4:
+            case TE_PROTO_IP6:
+                if (layer != csap->depth - 2)
+                    goto stop;
+
+                l3 = (csap->layers[layer].proto_tag == TE_PROTO_IP4) ?
+                         ETH_P_IP : ETH_P_IPV6;
+                tad_eth_bpf_emit(prog, BPF_LD | BPF_H | BPF_ABS,
+                                 2 * ETH_ALEN, 0, 0);
+                tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, l3,
+                                 0, TAD_ETH_BPF_FAIL);
+                prog->checks++;
+
+                if (l3 == ETH_P_IP)
+                {
+                    tad_eth_bpf_field(prog, pdu, NULL,
+                                      NDN_TAG_IP4_PROTOCOL,
+                                      ASN_TAG_INVALID, FALSE,
+                                      TAD_ETH_BPF_L3_OFF + 9, 1);
+                    tad_eth_bpf_field(prog, pdu, csap_pdu,
+                                      NDN_TAG_IP4_SRC_ADDR,
+                                      NDN_TAG_IP4_REMOTE_ADDR, FALSE,
+                                      TAD_ETH_BPF_L3_OFF + 12, 4);
+                    tad_eth_bpf_field(prog, pdu, csap_pdu,
+                                      NDN_TAG_IP4_DST_ADDR,
+                                      NDN_TAG_IP4_LOCAL_ADDR, FALSE,
+                                      TAD_ETH_BPF_L3_OFF + 16, 4);
+                }
+                else
+                {
+                    /*
+                     * Next header is not checked since extension
+                     * headers may be present.
+                     */
+                    tad_eth_bpf_field(prog, pdu, csap_pdu,
+                                      NDN_TAG_IP6_SRC_ADDR,
+                                      NDN_TAG_IP6_REMOTE_ADDR, FALSE,
+                                      TAD_ETH_BPF_L3_OFF + 8, 16);
+                    tad_eth_bpf_field(prog, pdu, csap_pdu,
+                                      NDN_TAG_IP6_DST_ADDR,
+                                      NDN_TAG_IP6_LOCAL_ADDR, FALSE,
+                                      TAD_ETH_BPF_L3_OFF + 24, 16);
+                }
+                break;
+
+            case TE_PROTO_UDP:
+            case TE_PROTO_TCP:
+            {
+                te_bool         udp;
+                te_bool         ind;
+                uint32_t        off;
+
+                if (layer != csap->depth - 3 || l3 == 0)
+                    goto stop;
+
+                udp = (csap->layers[layer].proto_tag == TE_PROTO_UDP);
+                l4 = udp ? IPPROTO_UDP : IPPROTO_TCP;
+
+                if (l3 == ETH_P_IP)
+                {
+                    tad_eth_bpf_emit(prog, BPF_LD | BPF_B | BPF_ABS,
+                                     TAD_ETH_BPF_L3_OFF + 9, 0, 0);
+                    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, l4,
+                                     0, TAD_ETH_BPF_FAIL);
+                    /* Non-first fragments have no transport header */
+                    tad_eth_bpf_emit(prog, BPF_LD | BPF_H | BPF_ABS,
+                                     TAD_ETH_BPF_L3_OFF + 6, 0, 0);
+                    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JSET | BPF_K,
+                                     0x1fff, TAD_ETH_BPF_PASS, 0);
+                    tad_eth_bpf_emit(prog, BPF_LDX | BPF_B | BPF_MSH,
+                                     TAD_ETH_BPF_L3_OFF, 0, 0);
+                    ind = TRUE;
+                    off = TAD_ETH_BPF_L3_OFF;
+                }
+                else
+                {
+                    /*
+                     * Other upper layer protocol means that there is
+                     * no such transport header, extension headers
+                     * are left to user space.
+                     */
+                    tad_eth_bpf_emit(prog, BPF_LD | BPF_B | BPF_ABS,
+                                     TAD_ETH_BPF_L3_OFF + 6, 0, 0);
+                    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, l4,
+                                     3, 0);
+                    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K,
+                                     IPPROTO_TCP, TAD_ETH_BPF_FAIL, 0);
+                    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K,
+                                     IPPROTO_UDP, TAD_ETH_BPF_FAIL, 0);
+                    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K,
+                                     IPPROTO_ICMPV6, TAD_ETH_BPF_FAIL,
+                                     TAD_ETH_BPF_PASS);
+                    ind = FALSE;
+                    off = TAD_ETH_BPF_IP6_L4_OFF;
+                }
+                prog->checks++;
+
+                tad_eth_bpf_field(prog, pdu, csap_pdu,
+                                  udp ? NDN_TAG_UDP_SRC_PORT :
+                                        NDN_TAG_TCP_SRC_PORT,
+                                  udp ? NDN_TAG_UDP_REMOTE_PORT :
+                                        NDN_TAG_TCP_REMOTE_PORT,
+                                  ind, off, 2);
+                tad_eth_bpf_field(prog, pdu, csap_pdu,
+                                  udp ? NDN_TAG_UDP_DST_PORT :
+                                        NDN_TAG_TCP_DST_PORT,
+                                  udp ? NDN_TAG_UDP_LOCAL_PORT :
+                                        NDN_TAG_TCP_LOCAL_PORT,
+                                  ind, off + 2, 2);
+
+                /* TCP header length is variable */
+                pld = udp;
+                pld_udp = TRUE;
+                pld_ind = ind;
+                pld_off = off + TAD_ETH_BPF_UDP_HLEN;
+                break;
+            }
+
+            default:
+                goto stop;
+        }
+    }
+
+    if (pld)
+        tad_eth_bpf_payload(prog, &unit->pld_spec, pld_udp, pld_ind,
+                            pld_off);
+
+stop:
+    tad_eth_bpf_unit_end(prog);
+}
+
+/**
+ * Add checks of the packet type against the receive mode and pass
+ * frames which layout is not known to the compiler to user space.
+ *
+ * @param prog          Program
+ * @param mode          Receive mode
+ */
+static void
+tad_eth_bpf_prologue(tad_eth_bpf_prog *prog, unsigned int mode)
+{
+    static const struct {
+        unsigned int    mode;
+        uint32_t        pkttype;
+    } pkttypes[] = {
+        { TAD_ETH_RECV_HOST,    PACKET_HOST },
+        { TAD_ETH_RECV_BCAST,   PACKET_BROADCAST },
+        { TAD_ETH_RECV_MCAST,   PACKET_MULTICAST },
+        { TAD_ETH_RECV_OTHER,   PACKET_OTHERHOST },
+        { TAD_ETH_RECV_OUT,     PACKET_OUTGOING },
+    };
+    unsigned int    n = 0;
+    unsigned int    i;
+
+    for (i = 0; i < TE_ARRAY_LEN(pkttypes); ++i)
+    {
+        if (mode & pkttypes[i].mode)
+            n++;
+    }
+
+    if (n < TE_ARRAY_LEN(pkttypes))
+    {
+        tad_eth_bpf_emit(prog, BPF_LD | BPF_W | BPF_ABS,
+                         SKF_AD_OFF + SKF_AD_PKTTYPE, 0, 0);
+        for (i = 0; i < TE_ARRAY_LEN(pkttypes); ++i)
+        {
+            if (mode & pkttypes[i].mode)
+            {
+                /* Jump over the rest jumps and the reject */
+                tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K,
+                                 pkttypes[i].pkttype, n, 0);
+                n--;
+            }
+        }
+        tad_eth_bpf_emit(prog, BPF_RET | BPF_K, 0, 0, 0);
+        prog->checks++;
+    }
+
+    tad_eth_bpf_emit(prog, BPF_LD | BPF_H | BPF_ABS, 2 * ETH_ALEN, 0, 0);
+    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, ETH_P_8021Q, 3, 0);
+    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, ETH_P_8021AD, 2, 0);
+    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JEQ | BPF_K, ETH_P_QINQ1, 1, 0);
+    tad_eth_bpf_emit(prog, BPF_JMP | BPF_JGE | BPF_K, ETH_P_802_3_MIN,
+                     1, 0);
+    tad_eth_bpf_emit(prog, BPF_RET | BPF_K, TAD_ETH_BPF_ACCEPT, 0, 0);
+}
+
+/* See description in tad_eth_bpf.h */
+te_errno
+tad_eth_bpf_compile(csap_p csap, unsigned int mode, struct sock_fprog *prog)
+{
+    tad_recv_pattern_data  *ptrn_data;
+    tad_eth_bpf_prog       *bpf;
+    te_bool                 pkttype;
+    unsigned int            i;
+    te_errno                rc;
+
+    if (csap->depth == 0 ||
+        csap->layers[csap->depth - 1].proto_tag != TE_PROTO_ETH ||
+        (csap->state & CSAP_STATE_RECV) == 0)
+        return TE_RC(TE_TAD_CSAP, TE_ENOENT);
+
+    ptrn_data = &csap_get_recv_context(csap)->ptrn_data;
+    if (ptrn_data->n_units == 0)
+        return TE_RC(TE_TAD_CSAP, TE_ENOENT);
+
+    bpf = TE_ALLOC(sizeof(*bpf));
+    if (bpf == NULL)
+        return TE_RC(TE_TAD_CSAP, TE_ENOMEM);
+    bpf->insns = TE_ALLOC(BPF_MAXINSNS * sizeof(*bpf->insns));
+    if (bpf->insns == NULL)
+    {
+        free(bpf);
+        return TE_RC(TE_TAD_CSAP, TE_ENOMEM);
+    }
+
+    tad_eth_bpf_prologue(bpf, mode);
+    pkttype = (bpf->checks != 0);
+    bpf->checks = 0;
+
+    for (i = 0; i < ptrn_data->n_units && !bpf->too_long; ++i)
+        tad_eth_bpf_unit(csap, bpf, ptrn_data->units + i);
+    tad_eth_bpf_emit(bpf, BPF_RET | BPF_K, 0, 0, 0);
+
+    if (bpf->too_long)
+    {
+        rc = TE_RC(TE_TAD_CSAP, TE_E2BIG);
+    }
+    else if (bpf->empty_unit && !pkttype)
+    {
+        rc = TE_RC(TE_TAD_CSAP, TE_ENOENT);
+    }
+    else
+    {
+        prog->len = bpf->len;
+        prog->filter = bpf->insns;
+        bpf->insns = NULL;
+        rc = 0;
+    }
+
+    free(bpf->insns);
+    free(bpf);
+
+    return rc;
+}
+
+#endif /* HAVE_LINUX_FILTER_H && HAVE_LINUX_IF_PACKET_H */
@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD Ethernet in-kernel filter
+ *
+ * Declaration of the compiler of traffic patterns of Ethernet-based
+ * CSAPs to classic BPF programs to be attached to PF_PACKET sockets.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_TAD_ETH_BPF_H__
+#define __TE_TAD_ETH_BPF_H__
+
+#include "te_errno.h"
+#include "tad_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sock_fprog;
+
+/**
+ * Compile traffic pattern of the CSAP prepared for receive to classic
+ * BPF program.
+ *
+ * The program is a prefilter: it drops in the kernel only frames
+ * which cannot match any pattern unit, everything it cannot express
+ * (non-plain values, unknown protocols, frames with in-line VLAN tags
+ * or LLC encapsulation, non-first IPv4 fragments etc.) is passed to
+ * user space and matched there as usual.
+ *
+ * Supported are Ethernet addresses, length/type and VLAN tag fields,
+ * IPv4/IPv6 addresses and IPv4 protocol, UDP/TCP ports and payload
+ * mask over Ethernet and UDP. Fields which are not specified in the
+ * pattern are taken from CSAP layers receive defaults (local/remote
+ * addresses and ports).
+ *
+ * @param csap          CSAP instance with prepared receive context
+ * @param mode          Receive mode (see enum tad_eth_recv_mode)
+ * @param prog          Location for the program; @p prog->filter
+ *                      should be released using free()
+ *
+ * @return Status code.
+ * @retval TE_ENOENT    Nothing may be filtered in the kernel
+ * @retval TE_E2BIG     Pattern is too complex for the classic BPF
+ */
+extern te_errno tad_eth_bpf_compile(csap_p csap, unsigned int mode,
+                                    struct sock_fprog *prog);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_TAD_ETH_BPF_H__ */
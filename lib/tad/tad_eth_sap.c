@@ -43,6 +43,9 @@
 #if HAVE_SYS_IOCTL_H
 #include <sys/ioctl.h>
 #endif
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
 #if HAVE_NET_IF_H
 #include <net/if.h>
 #endif
@@ -62,6 +65,13 @@
 #include <linux/if_ether.h>
 #endif
 
+#if defined(USE_PF_PACKET) && HAVE_LINUX_FILTER_H && HAVE_LINUX_IF_PACKET_H
+#include <stdio.h>
+#include <inttypes.h>
+#include <linux/filter.h>
+#define TAD_ETH_SAP_BPF     1
+#endif
+
 #if defined(USE_PF_PACKET) && defined(WITH_PACKET_MMAP_RX_RING)
 #include <poll.h>
 #include <sys/mman.h>
@@ -84,6 +94,7 @@
 #include "tad_csap_inst.h"
 #include "tad_utils.h"
 #include "tad_eth_sap.h"
+#include "tad_eth_bpf.h"
 #include "te_ethernet.h"
 
 /**
@@ -100,6 +111,16 @@
  */
 #define TAD_WRITE_TIMEOUT_DEFAULT   { 1, 0 }
 
+#if defined(USE_PF_PACKET) && defined(HAVE_SENDMMSG)
+#define TAD_ETH_SAP_SENDMMSG        1
+
+/** Maximum number of frames passed to sendmmsg() at once */
+#define TAD_ETH_SAP_SEND_BATCH      (64)
+
+/** Maximum total number of segments of frames passed to sendmmsg() */
+#define TAD_ETH_SAP_SEND_BATCH_IOV  (8 * TAD_ETH_SAP_SEND_BATCH)
+#endif
+
 #ifdef USE_BPF
 #define TAD_ETH_SAP_FEXP_SIZE       (128)
 #define TAD_ETH_SAP_SNAP_LEN        (0xffff)
@@ -111,11 +132,26 @@ typedef struct tad_eth_sap_data {
     int             in;         /**< Input socket (for receive) */
     int             out;        /**< Output socket (for send) */
     unsigned int    ifindex;    /**< Interface index */
+    struct timeval  recv_start; /**< Time when the input socket has
+                                     been opened */
 #ifdef WITH_PACKET_MMAP_RX_RING
-    struct tpacket_req  rx_ring_conf;       /**< Rx ring configuration */
-    char               *rx_ring;            /**< Rx ring base address */
-    unsigned int        rx_ring_frame_cur;  /**< Next frame to check */
+    struct tpacket_req3 rx_ring_conf;       /**< Rx ring configuration */
+    uint8_t            *rx_ring;            /**< Rx ring base address */
+    unsigned int        rx_ring_block_cur;  /**< Current block */
+    te_bool             rx_ring_block_held; /**< Is the current block
+                                                 owned by user space? */
+    uint8_t            *rx_ring_frame;      /**< Next frame in the current
+                                                 block */
+    unsigned int        rx_ring_frames_left; /**< Number of frames left
+                                                  in the current block */
 #endif /* WITH_PACKET_MMAP_RX_RING */
+#ifdef TAD_ETH_SAP_BPF
+    te_bool         filter;     /**< Is pattern filter attached to
+                                     the input socket? */
+    uint64_t        if_pkts;    /**< Number of frames passed through
+                                     the interface when the filter was
+                                     attached */
+#endif /* TAD_ETH_SAP_BPF */
 #else
     pcap_t         *in;         /**< Input handle (for receive) */
     pcap_t         *out;        /**< Output handle (for send) */
@@ -686,6 +722,177 @@ tad_eth_sap_send(tad_eth_sap *sap, const tad_pkt *pkt)
     return 0;
 }
 
+#ifdef TAD_ETH_SAP_SENDMMSG
+/**
+ * Send frames prepared in messages with sendmmsg(). Retries on
+ * ENOBUFS and waits for write possibility the same way as
+ * tad_eth_sap_send() does.
+ *
+ * @param sap           SAP description structure
+ * @param fd            Output socket
+ * @param msgs          Messages to send
+ * @param n_msgs        Number of messages
+ * @param sent          Location for number of sent messages
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_eth_sap_sendmmsg(tad_eth_sap *sap, int fd, struct mmsghdr *msgs,
+                     unsigned int n_msgs, unsigned int *sent)
+{
+    unsigned int    retries = 0;
+    unsigned int    nobufs = 0;
+    fd_set          write_set;
+    int             ret_val;
+    te_errno        rc;
+
+    *sent = 0;
+    while (*sent < n_msgs)
+    {
+        ret_val = sendmmsg(fd, msgs + *sent, n_msgs - *sent, MSG_DONTWAIT);
+        if (ret_val > 0)
+        {
+            *sent += ret_val;
+            retries = nobufs = 0;
+            continue;
+        }
+
+        rc = (ret_val < 0) ? te_rc_os2te(errno) : TE_EAGAIN;
+        VERB("CSAP #%d, errno %r, retry %u", sap->csap->id, rc, retries);
+        switch (rc)
+        {
+            case TE_ENOBUFS:
+            {
+                /* See tad_eth_sap_send() */
+                struct timeval clr_delay = { 0, rand() & 0x3f };
+
+                if (++nobufs == TAD_WRITE_NOBUFS)
+                {
+                    ERROR("CSAP #%d, too many ENOBUFS, failed",
+                          sap->csap->id);
+                    return TE_RC(TE_TAD_CSAP, TE_ENOBUFS);
+                }
+                select(0, NULL, NULL, NULL, &clr_delay);
+                break;
+            }
+
+            case TE_EAGAIN:
+            {
+                struct timeval timeout = TAD_WRITE_TIMEOUT_DEFAULT;
+
+                if (++retries == TAD_WRITE_RETRIES)
+                {
+                    ERROR("CSAP #%d, too many retries made, failed",
+                          sap->csap->id);
+                    return TE_RC(TE_TAD_CSAP, TE_ENOBUFS);
+                }
+                FD_ZERO(&write_set);
+                FD_SET(fd, &write_set);
+                if (select(fd + 1, NULL, &write_set, NULL, &timeout) == 0)
+                {
+                    F_INFO("%s(): select to write timed out, retry %u",
+                           __FUNCTION__, retries);
+                }
+                break;
+            }
+
+            default:
+                ERROR("%s(CSAP %d): internal error %r, socket %d",
+                      __FUNCTION__, sap->csap->id, rc, fd);
+                return TE_RC(TE_TAD_CSAP, rc);
+        }
+    }
+
+    return 0;
+}
+#endif /* TAD_ETH_SAP_SENDMMSG */
+
+/* See the description in tad_eth_sap.h */
+te_errno
+tad_eth_sap_send_pkts(tad_eth_sap *sap, const tad_pkts *pkts,
+                      unsigned int *sent)
+{
+    tad_pkt            *pkt;
+#ifdef TAD_ETH_SAP_SENDMMSG
+    tad_eth_sap_data   *data;
+    struct mmsghdr      msgs[TAD_ETH_SAP_SEND_BATCH];
+    struct iovec        iov[TAD_ETH_SAP_SEND_BATCH_IOV];
+    unsigned int        n_msgs;
+    unsigned int        n_iov;
+    unsigned int        n_segs;
+    unsigned int        n_sent;
+#endif
+    te_errno            rc = 0;
+
+    assert(sap != NULL);
+    assert(pkts != NULL);
+    assert(sent != NULL);
+
+    *sent = 0;
+
+#ifdef TAD_ETH_SAP_SENDMMSG
+    data = sap->data;
+    assert(data != NULL);
+    if (data->out < 0)
+    {
+        ERROR("%s(): no output socket", __FUNCTION__);
+        return TE_RC(TE_TAD_CSAP, TE_EINVAL);
+    }
+
+    pkt = CIRCLEQ_FIRST(&pkts->pkts);
+    while (pkt != (void *)&pkts->pkts)
+    {
+        /* Fill in as many messages as fit in the batch */
+        for (n_msgs = 0, n_iov = 0;
+             pkt != (void *)&pkts->pkts && n_msgs < TAD_ETH_SAP_SEND_BATCH;
+             pkt = CIRCLEQ_NEXT(pkt, links), n_msgs++, n_iov += n_segs)
+        {
+            n_segs = tad_pkt_seg_num(pkt);
+            if (n_segs > TAD_ETH_SAP_SEND_BATCH_IOV - n_iov)
+                break;
+
+            rc = tad_pkt_segs_to_iov(pkt, iov + n_iov, n_segs);
+            if (rc != 0)
+            {
+                ERROR("Failed to convert segments to I/O vector: %r", rc);
+                return rc;
+            }
+            memset(&msgs[n_msgs], 0, sizeof(msgs[n_msgs]));
+            msgs[n_msgs].msg_hdr.msg_iov = iov + n_iov;
+            msgs[n_msgs].msg_hdr.msg_iovlen = n_segs;
+        }
+
+        if (n_msgs == 0)
+        {
+            /* Too many segments in one frame, send it as usual */
+            rc = tad_eth_sap_send(sap, pkt);
+            if (rc != 0)
+                return rc;
+            (*sent)++;
+            pkt = CIRCLEQ_NEXT(pkt, links);
+            continue;
+        }
+
+        rc = tad_eth_sap_sendmmsg(sap, data->out, msgs, n_msgs, &n_sent);
+        *sent += n_sent;
+        if (rc != 0)
+            return rc;
+
+        F_VERB("CSAP #%d, %u frames sent in a batch", sap->csap->id, n_sent);
+    }
+#else
+    TAD_PKT_FOR_EACH_PKT_FWD(&pkts->pkts, pkt)
+    {
+        rc = tad_eth_sap_send(sap, pkt);
+        if (rc != 0)
+            break;
+        (*sent)++;
+    }
+#endif
+
+    return rc;
+}
+
 /* See the description in tad_eth_sap.h */
 te_errno
 tad_eth_sap_send_close(tad_eth_sap *sap)
@@ -768,11 +975,24 @@ tad_eth_sap_pkt_vlan_tag_valid(uint16_t    tp_vlan_tci,
 #endif /* USE_PF_PACKET */
 
 #ifdef WITH_PACKET_MMAP_RX_RING
+#ifndef TAD_ETH_SAP_RX_RING_BLOCK_SIZE
+/** Size of Rx ring block */
+#define TAD_ETH_SAP_RX_RING_BLOCK_SIZE      (1 << 20)
+#endif
+#ifndef TAD_ETH_SAP_RX_RING_RETIRE_TOV
+/** Timeout in milliseconds to retire partially filled Rx ring block */
+#define TAD_ETH_SAP_RX_RING_RETIRE_TOV      10
+#endif
+
+/** Minimum number of frames to have space in Rx ring for */
 #define ETH_SAP_PKT_RX_RING_NB_FRAMES_MIN   256
-#define ETH_SAP_PKT_RX_RING_NB_FRAMES_MAX   4096
+/** Minimum number of Rx ring blocks */
+#define ETH_SAP_PKT_RX_RING_NB_BLOCKS_MIN   4
+/** Maximum size of Rx ring */
+#define ETH_SAP_PKT_RX_RING_SIZE_MAX        (64 << 20)
+/** Space occupied in Rx ring by a full-sized frame */
 #define ETH_SAP_PKT_RX_RING_FRAME_LEN \
-    te_round_up_pow2(TPACKET2_HDRLEN + ETHER_HDR_LEN + TAD_VLAN_TAG_LEN + \
-                     UINT16_MAX + ETHER_CRC_LEN)
+    te_round_up_pow2(TPACKET3_HDRLEN + TAD_VLAN_TAG_LEN + ETHER_MAX_LEN)
 
 static te_errno
 tad_eth_rx_desc_count_get(const tad_eth_sap_data *sap_data,
@@ -798,17 +1018,34 @@ tad_eth_rx_desc_count_get(const tad_eth_sap_data *sap_data,
     return 0;
 }
 
+/**
+ * Set up TPACKET_V3 Rx ring on the input socket.
+ *
+ * Frames are received in blocks: the kernel fills in a block with
+ * as many frames as fit in it and passes it to user space when it is
+ * full or the retire timeout expires. Frames are not copied from the
+ * ring, they are valid until the next read, so the read-write layer
+ * of the CSAP is marked as lending packet data.
+ *
+ * @param sap           SAP description structure
+ *
+ * @return Status code.
+ */
 static te_errno
 tad_eth_sap_pkt_rx_ring_setup(tad_eth_sap *sap)
 {
-    tad_eth_sap_data   *data;
-    csap_p              csap;
-    tad_recv_context   *rx_ctx;
-    unsigned int        nb_frames_min;
-    unsigned int        nb_frames;
-    int                 version;
-    struct tpacket_req *tp;
-    te_errno            rc;
+    tad_eth_sap_data       *data;
+    csap_p                  csap;
+    tad_recv_context       *rx_ctx;
+    unsigned int            nb_frames_min;
+    unsigned int            nb_frames;
+    unsigned int            nb_blocks;
+    unsigned int            block_size;
+    unsigned int            page_size;
+    int                     version;
+    int                     reserve;
+    struct tpacket_req3    *tp;
+    te_errno                rc;
 
     if (sap == NULL)
         return TE_RC(TE_TAD_PF_PACKET, TE_EINVAL);
@@ -827,12 +1064,24 @@ tad_eth_sap_pkt_rx_ring_setup(tad_eth_sap *sap)
     if (rx_ctx == NULL)
         return TE_RC(TE_TAD_PF_PACKET, TE_EINVAL);
 
-    version = TPACKET_V2;
+    version = TPACKET_V3;
     if (setsockopt(data->in, SOL_PACKET, PACKET_VERSION, &version,
                    sizeof(version)) != 0)
     {
         rc = TE_OS_RC(TE_TAD_PF_PACKET, errno);
-        ERROR("%s(): setsockopt(PACKET_VERSION) failed: %r", rc);
+        ERROR("%s(): setsockopt(PACKET_VERSION) failed: %r",
+              __FUNCTION__, rc);
+        return rc;
+    }
+
+    /* Headroom to insert VLAN tag stripped by the kernel in place */
+    reserve = TAD_VLAN_TAG_LEN;
+    if (setsockopt(data->in, SOL_PACKET, PACKET_RESERVE, &reserve,
+                   sizeof(reserve)) != 0)
+    {
+        rc = TE_OS_RC(TE_TAD_PF_PACKET, errno);
+        ERROR("%s(): setsockopt(PACKET_RESERVE) failed: %r",
+              __FUNCTION__, rc);
         return rc;
     }
 
@@ -840,34 +1089,56 @@ tad_eth_sap_pkt_rx_ring_setup(tad_eth_sap *sap)
     if (rc != 0)
         nb_frames_min = ETH_SAP_PKT_RX_RING_NB_FRAMES_MIN;
 
-    nb_frames = MAX(nb_frames_min, te_round_up_pow2(rx_ctx->ptrn_data.n_units));
-    nb_frames = MIN(nb_frames, ETH_SAP_PKT_RX_RING_NB_FRAMES_MAX);
-    INFO("PACKET_RX_RING: nb_frames=%u", nb_frames);
+    nb_frames = MAX(nb_frames_min, ETH_SAP_PKT_RX_RING_NB_FRAMES_MIN);
+    nb_frames = MAX(nb_frames, te_round_up_pow2(rx_ctx->ptrn_data.n_units));
+
+    page_size = getpagesize();
+    block_size = (TAD_ETH_SAP_RX_RING_BLOCK_SIZE + page_size - 1) /
+                 page_size * page_size;
 
-    tp->tp_frame_nr = nb_frames;
-    tp->tp_frame_size = ETH_SAP_PKT_RX_RING_FRAME_LEN;
-    tp->tp_block_size = tp->tp_frame_nr * tp->tp_frame_size;
-    tp->tp_block_nr = 1;
+    nb_blocks = (nb_frames * ETH_SAP_PKT_RX_RING_FRAME_LEN +
+                 block_size - 1) / block_size;
+    nb_blocks = MIN(nb_blocks, ETH_SAP_PKT_RX_RING_SIZE_MAX / block_size);
+    nb_blocks = MAX(nb_blocks, ETH_SAP_PKT_RX_RING_NB_BLOCKS_MIN);
+
+    memset(tp, 0, sizeof(*tp));
+    tp->tp_block_size = block_size;
+    tp->tp_block_nr = nb_blocks;
+    tp->tp_frame_size = MIN(ETH_SAP_PKT_RX_RING_FRAME_LEN, block_size);
+    tp->tp_frame_nr = tp->tp_block_size / tp->tp_frame_size *
+                      tp->tp_block_nr;
+    tp->tp_retire_blk_tov = TAD_ETH_SAP_RX_RING_RETIRE_TOV;
+
+    INFO("PACKET_RX_RING: %u blocks of %u bytes, retire timeout %u ms",
+         tp->tp_block_nr, tp->tp_block_size, tp->tp_retire_blk_tov);
 
     if (setsockopt(data->in, SOL_PACKET, PACKET_RX_RING,
                    (void *)tp, sizeof(*tp)) != 0)
     {
         rc = TE_OS_RC(TE_TAD_PF_PACKET, errno);
-        ERROR("%s(): setsockopt(PACKET_RX_RING) failed: %r", rc);
+        ERROR("%s(): setsockopt(PACKET_RX_RING) failed: %r",
+              __FUNCTION__, rc);
         return rc;
     }
 
     data->rx_ring = mmap(NULL, tp->tp_block_size * tp->tp_block_nr,
                          PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
                          data->in, 0);
-    if (data->rx_ring == NULL)
+    if (data->rx_ring == MAP_FAILED)
     {
         rc = TE_OS_RC(TE_TAD_PF_PACKET, errno);
-        ERROR("%s(): mmap() failed: %r", rc);
+        ERROR("%s(): mmap() failed: %r", __FUNCTION__, rc);
+        data->rx_ring = NULL;
         return rc;
     }
 
-    data->rx_ring_frame_cur = 0;
+    data->rx_ring_block_cur = 0;
+    data->rx_ring_block_held = FALSE;
+    data->rx_ring_frame = NULL;
+    data->rx_ring_frames_left = 0;
+
+    /* Rings of additional receive queues of the CSAP are counted too */
+    csap->layers[csap_get_rw_layer(csap)].rw_borrowed_pkt_data++;
 
     return 0;
 }
@@ -875,22 +1146,51 @@ tad_eth_sap_pkt_rx_ring_setup(tad_eth_sap *sap)
 static void
 tad_eth_sap_pkt_rx_ring_release(tad_eth_sap *sap)
 {
-    tad_eth_sap_data   *data;
-    struct tpacket_req *tp;
+    tad_eth_sap_data       *data;
+    struct tpacket_req3    *tp;
 
     if (sap == NULL)
         return;
 
     data = sap->data;
-    if (data == NULL)
+    if (data == NULL || data->rx_ring == NULL)
         return;
 
+    if (sap->csap != NULL)
+    {
+        csap_p csap = sap->csap;
+
+        assert(csap->layers[csap_get_rw_layer(csap)].
+                   rw_borrowed_pkt_data > 0);
+        csap->layers[csap_get_rw_layer(csap)].rw_borrowed_pkt_data--;
+    }
+
     tp = &data->rx_ring_conf;
 
     if (munmap(data->rx_ring, tp->tp_block_size * tp->tp_block_nr) != 0)
-        ERROR("%s(): munmap() failed: %r", TE_OS_RC(TE_TAD_PF_PACKET, errno));
+    {
+        ERROR("%s(): munmap() failed: %r", __FUNCTION__,
+              TE_OS_RC(TE_TAD_PF_PACKET, errno));
+    }
+    data->rx_ring = NULL;
 }
 
+/**
+ * Get the next frame from the Rx ring.
+ *
+ * Frames of the current block are returned one by one without any
+ * system calls. The block is returned to the kernel on the next read
+ * after its last frame, so the returned packet segment refers to
+ * the ring until the next read.
+ *
+ * @param sap           SAP description structure
+ * @param timeout       Timeout in microseconds to wait for a block
+ * @param pkt           Packet to put the frame to
+ * @param pkt_len       Location for the frame length
+ * @param from          Location for the frame source address
+ *
+ * @return Status code.
+ */
 static te_errno
 tad_eth_sap_pkt_rx_ring_recv(tad_eth_sap        *sap,
                              unsigned int        timeout,
@@ -898,16 +1198,13 @@ tad_eth_sap_pkt_rx_ring_recv(tad_eth_sap        *sap,
                              size_t             *pkt_len,
                              struct sockaddr_ll *from)
 {
-    tad_eth_sap_data       *data;
-    struct tpacket_req     *tp;
-    struct tpacket2_hdr    *ph;
-    te_bool                 vlan_tag_valid;
-    size_t                  seg_len;
-    uint8_t                *seg_data = NULL;
-    size_t                  copy_len;
-    size_t                  remaining_len;
-    size_t                  data_off;
-    tad_pkt_seg            *seg;
+    tad_eth_sap_data           *data;
+    struct tpacket_req3        *tp;
+    struct tpacket_block_desc  *bd;
+    struct tpacket3_hdr        *ph;
+    uint8_t                    *frame;
+    size_t                      len;
+    tad_pkt_seg                *seg;
 
     if ((sap == NULL) || (pkt == NULL) || (pkt_len == NULL) || (from == NULL))
         return TE_RC(TE_TAD_CSAP, TE_EINVAL);
@@ -917,106 +1214,286 @@ tad_eth_sap_pkt_rx_ring_recv(tad_eth_sap        *sap,
         return TE_RC(TE_TAD_CSAP, TE_EINVAL);
 
     tp = &data->rx_ring_conf;
-    if (tp->tp_frame_nr == 0)
-        return TE_RC(TE_TAD_CSAP, TE_EINVAL);
-
-    ph = (struct tpacket2_hdr *)((uint8_t *)data->rx_ring +
-                                 (data->rx_ring_frame_cur *
-                                  tp->tp_frame_size));
 
-    if ((ph->tp_status & TP_STATUS_USER) == 0)
+    while (data->rx_ring_frames_left == 0)
     {
-        struct pollfd   pollset;
-        int             ret_val;
+        bd = (struct tpacket_block_desc *)(data->rx_ring +
+                 data->rx_ring_block_cur * tp->tp_block_size);
 
-        pollset.fd = data->in;
-        pollset.events = POLLIN;
-        pollset.revents = 0;
+        if (data->rx_ring_block_held)
+        {
+            /* Frames of the block are not referred any more */
+            bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+            __sync_synchronize();
 
-        ret_val = poll(&pollset, 1, TE_US2MS(timeout));
-        if (ret_val == 0)
-            return TE_RC(TE_TAD_CSAP, TE_ETIMEDOUT);
+            data->rx_ring_block_held = FALSE;
+            data->rx_ring_block_cur = (data->rx_ring_block_cur + 1) %
+                                      tp->tp_block_nr;
+            continue;
+        }
 
-        if (ret_val < 0)
-            return TE_OS_RC(TE_TAD_CSAP, errno);
+        if ((bd->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+        {
+            struct pollfd   pollset;
+            int             ret_val;
+
+            pollset.fd = data->in;
+            pollset.events = POLLIN;
+            pollset.revents = 0;
+
+            ret_val = poll(&pollset, 1, TE_US2MS(timeout));
+            if (ret_val < 0)
+                return TE_OS_RC(TE_TAD_CSAP, errno);
+
+            if (ret_val == 0 ||
+                (bd->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+                return TE_RC(TE_TAD_CSAP, TE_ETIMEDOUT);
+        }
+        __sync_synchronize();
+
+        VERB("%s: block %u seq_num=%llu num_pkts=%u", __func__,
+             data->rx_ring_block_cur,
+             (unsigned long long)bd->hdr.bh1.seq_num,
+             bd->hdr.bh1.num_pkts);
+
+        data->rx_ring_block_held = TRUE;
+        data->rx_ring_frames_left = bd->hdr.bh1.num_pkts;
+        data->rx_ring_frame = (uint8_t *)bd +
+                              bd->hdr.bh1.offset_to_first_pkt;
     }
 
-    VERB("%s: tpacket_req tp_frame_nr=%u tp_frame_size=%u",
-         __func__, tp->tp_frame_nr, tp->tp_frame_size);
-    VERB("%s: tpacket2_hdr tp_status=%u tp_len=%u tp_snaplen=%u tp_mac=%u "
+    ph = (struct tpacket3_hdr *)data->rx_ring_frame;
+    data->rx_ring_frame += ph->tp_next_offset;
+    data->rx_ring_frames_left--;
+
+    VERB("%s: tpacket3_hdr tp_status=%u tp_len=%u tp_snaplen=%u tp_mac=%u "
          "tp_net=%u tp_sec=%u tp_nsec=%u tp_vlan_tci=0x%x tp_vlan_tpid=0x%x",
          __func__, ph->tp_status, ph->tp_len, ph->tp_snaplen, ph->tp_mac,
-         ph->tp_net, ph->tp_sec, ph->tp_nsec, ph->tp_vlan_tci,
+         ph->tp_net, ph->tp_sec, ph->tp_nsec, ph->hv1.tp_vlan_tci,
 #ifdef TP_STATUS_VLAN_TPID_VALID
-         ph->tp_vlan_tpid
+         ph->hv1.tp_vlan_tpid
 #else
          UINT16_MAX
 #endif
          );
 
-    vlan_tag_valid = tad_eth_sap_pkt_vlan_tag_valid(ph->tp_vlan_tci,
-                                                    ph->tp_status);
-
-    seg_len = (vlan_tag_valid) ? ph->tp_len + TAD_VLAN_TAG_LEN : ph->tp_len;
-    seg_data = TE_ALLOC(seg_len);
-    if (seg_data == NULL)
-        return TE_RC(TE_TAD_CSAP, TE_ENOMEM);
-
-    remaining_len = seg_len;
+    frame = (uint8_t *)ph + ph->tp_mac;
+    len = ph->tp_snaplen;
 
-    copy_len = MIN(remaining_len, 2 * ETHER_ADDR_LEN);
-    memcpy(seg_data, (uint8_t *)ph + ph->tp_mac, copy_len);
-    data_off = copy_len;
-    remaining_len -= copy_len;
-
-    if (vlan_tag_valid && remaining_len >= TAD_VLAN_TAG_LEN)
+    if (tad_eth_sap_pkt_vlan_tag_valid(ph->hv1.tp_vlan_tci,
+                                       ph->tp_status) &&
+        len >= 2 * ETHER_ADDR_LEN)
     {
         struct tad_vlan_tag *tag;
 
-        tag = (struct tad_vlan_tag *)(seg_data + data_off);
+        /* Insert the tag in place using headroom set by PACKET_RESERVE */
+        memmove(frame - TAD_VLAN_TAG_LEN, frame, 2 * ETHER_ADDR_LEN);
+        frame -= TAD_VLAN_TAG_LEN;
+        len += TAD_VLAN_TAG_LEN;
 
+        tag = (struct tad_vlan_tag *)(frame + 2 * ETHER_ADDR_LEN);
 #ifdef TP_STATUS_VLAN_TPID_VALID
         tag->vlan_tpid = htons((ph->tp_status & TP_STATUS_VLAN_TPID_VALID) ?
-                               ph->tp_vlan_tpid : ETH_P_8021Q);
+                               ph->hv1.tp_vlan_tpid : ETH_P_8021Q);
 #else
         tag->vlan_tpid = htons(ETH_P_8021Q);
 #endif
-        tag->vlan_tci = htons(ph->tp_vlan_tci);
-
-        data_off += TAD_VLAN_TAG_LEN;
-        remaining_len -= TAD_VLAN_TAG_LEN;
+        tag->vlan_tci = htons(ph->hv1.tp_vlan_tci);
     }
 
-    memcpy(seg_data + data_off, (uint8_t *)ph + ph->tp_mac + (2 * ETHER_ADDR_LEN),
-           remaining_len);
-
     /*
-     * It is not guaranteed that the TAD packet consists of exactly one
-     * segment, so it is reasonable to re-allocate the entire packet
+     * Segment refers to the ring and has no data free function, so
+     * the packet must own its data if it is kept after the next read.
      */
-    tad_pkt_free_segs(pkt);
-    seg = tad_pkt_alloc_seg(seg_data, seg_len, tad_pkt_seg_data_free);
-    if (seg == NULL)
+    if (tad_pkt_seg_num(pkt) == 1)
+    {
+        tad_pkt_put_seg_data(pkt, tad_pkt_first_seg(pkt), frame, len, NULL);
+    }
+    else
     {
-        free(seg_data);
-        return TE_RC(TE_TAD_CSAP, TE_ENOMEM);
+        tad_pkt_free_segs(pkt);
+        seg = tad_pkt_alloc_seg(frame, len, NULL);
+        if (seg == NULL)
+            return TE_RC(TE_TAD_CSAP, TE_ENOMEM);
+        tad_pkt_append_seg(pkt, seg);
     }
-    tad_pkt_append_seg(pkt, seg);
-    *pkt_len = seg_len;
+    *pkt_len = len;
 
     memcpy(from, (uint8_t *)ph + TPACKET_ALIGN(sizeof(*ph)), sizeof(*from));
 
-    /* Return the entry to the kernel */
-    ph->tp_status = 0;
-    __sync_synchronize();
-
-    /* Update the ring offset to point to the next entry */
-    data->rx_ring_frame_cur = (data->rx_ring_frame_cur + 1) % tp->tp_frame_nr;
-
     return 0;
 }
 #endif /* WITH_PACKET_MMAP_RX_RING */
 
+#ifdef TAD_ETH_SAP_BPF
+/**
+ * Get number of frames passed through the interface in directions
+ * which may be captured in the receive mode.
+ *
+ * @param sap           SAP description structure
+ * @param mode          Receive mode
+ *
+ * @return Number of frames.
+ */
+static uint64_t
+tad_eth_sap_if_pkts(const tad_eth_sap *sap, unsigned int mode)
+{
+    static const char * const counters[] = { "rx_packets", "tx_packets" };
+
+    char            path[TAD_ETH_SAP_IFNAME_SIZE + 64];
+    uint64_t        total = 0;
+    uint64_t        val;
+    unsigned int    i;
+    FILE           *f;
+
+    for (i = 0; i < TE_ARRAY_LEN(counters); ++i)
+    {
+        if (i > 0 && (mode & TAD_ETH_RECV_OUT) == 0)
+            break;
+
+        snprintf(path, sizeof(path), "/sys/class/net/%s/statistics/%s",
+                 sap->name, counters[i]);
+        f = fopen(path, "r");
+        if (f == NULL)
+            continue;
+        if (fscanf(f, "%" SCNu64, &val) == 1)
+            total += val;
+        fclose(f);
+    }
+
+    return total;
+}
+
+/**
+ * Attach filter compiled from the traffic pattern of the CSAP to
+ * the input socket. Frames which are not filtered in the kernel are
+ * matched in user space anyway, so failures are not fatal.
+ *
+ * @param sap           SAP description structure
+ * @param mode          Receive mode
+ */
+static void
+tad_eth_sap_filter_attach(tad_eth_sap *sap, unsigned int mode)
+{
+    tad_eth_sap_data   *data = sap->data;
+    struct sock_fprog   prog;
+    te_errno            rc;
+
+    data->filter = FALSE;
+    if (sap->csap == NULL)
+        return;
+
+    rc = tad_eth_bpf_compile(sap->csap, mode, &prog);
+    if (rc != 0)
+    {
+        INFO("%s(): receive pattern is not filtered in the kernel: %r",
+             __FUNCTION__, rc);
+        return;
+    }
+
+    if (setsockopt(data->in, SOL_SOCKET, SO_ATTACH_FILTER,
+                   &prog, sizeof(prog)) != 0)
+    {
+        rc = TE_OS_RC(TE_TAD_PF_PACKET, errno);
+        WARN("%s(): setsockopt(SO_ATTACH_FILTER) failed, frames are "
+             "filtered in user space: %r", __FUNCTION__, rc);
+    }
+    else
+    {
+        INFO("Filter of %u instructions attached to PF_PACKET socket %d",
+             (unsigned int)prog.len, data->in);
+        data->filter = TRUE;
+        data->if_pkts = tad_eth_sap_if_pkts(sap, mode);
+    }
+
+    free(prog.filter);
+}
+
+/**
+ * Estimate number of frames filtered out in the kernel as number of
+ * frames passed through the interface which have not been passed by
+ * the filter and store it in the receive context of the CSAP.
+ *
+ * @param sap           SAP description structure
+ * @param st            Statistics of the input socket
+ */
+static void
+tad_eth_sap_filter_stats(tad_eth_sap *sap, const struct tpacket_stats *st)
+{
+    tad_eth_sap_data       *data = sap->data;
+    uint64_t                if_pkts;
+    unsigned int            kern_no_match = 0;
+
+    if (!data->filter)
+        return;
+    data->filter = FALSE;
+
+    if_pkts = tad_eth_sap_if_pkts(sap, data->recv_mode) - data->if_pkts;
+    if (if_pkts > st->tp_packets)
+        kern_no_match = if_pkts - st->tp_packets;
+
+    if (sap->csap->state & CSAP_STATE_RECV)
+        csap_get_recv_context(sap->csap)->kern_no_match_pkts =
+            kern_no_match;
+
+    INFO("CSAP %d: about %u frames filtered out in the kernel",
+         sap->csap->id, kern_no_match);
+}
+#endif /* TAD_ETH_SAP_BPF */
+
+#ifdef USE_PF_PACKET
+/**
+ * Log receive rate and drop rate of the input socket since it has
+ * been opened and update the filter statistics.
+ *
+ * @param sap           SAP description structure
+ */
+static void
+tad_eth_sap_recv_stats(tad_eth_sap *sap)
+{
+    tad_eth_sap_data       *data = sap->data;
+    struct tpacket_stats    st;
+    socklen_t               len = sizeof(st);
+    struct timeval          now;
+    uint64_t                elapsed_us;
+    unsigned int            drop_rate;
+
+    /* Passed frames are counted including dropped because of overflow */
+    if (getsockopt(data->in, SOL_PACKET, PACKET_STATISTICS,
+                   &st, &len) != 0)
+    {
+        WARN("%s(): getsockopt(PACKET_STATISTICS) failed: %r",
+             __FUNCTION__, TE_OS_RC(TE_TAD_PF_PACKET, errno));
+#ifdef TAD_ETH_SAP_BPF
+        data->filter = FALSE;
+#endif
+        return;
+    }
+
+    gettimeofday(&now, NULL);
+    elapsed_us = TE_SEC2US((uint64_t)(now.tv_sec - data->recv_start.tv_sec)) +
+                 now.tv_usec - data->recv_start.tv_usec;
+    /* Drop rate in hundredths of percent */
+    drop_rate = (st.tp_packets == 0) ? 0 :
+                (unsigned int)((uint64_t)st.tp_drops * 10000 /
+                               st.tp_packets);
+
+    RING("CSAP %d: %u frames passed to user space in %u.%03u s "
+         "(%u frames/s), %u dropped (%u.%02u%%)",
+         (sap->csap == NULL) ? -1 : sap->csap->id, st.tp_packets,
+         (unsigned int)(elapsed_us / 1000000),
+         (unsigned int)(elapsed_us / 1000 % 1000),
+         (elapsed_us == 0) ? 0 :
+             (unsigned int)((uint64_t)st.tp_packets * 1000000 /
+                            elapsed_us),
+         st.tp_drops, drop_rate / 100, drop_rate % 100);
+
+#ifdef TAD_ETH_SAP_BPF
+    tad_eth_sap_filter_stats(sap, &st);
+#endif
+}
+#endif /* USE_PF_PACKET */
+
 /* See the description in tad_eth_sap.h */
 te_errno
 tad_eth_sap_recv_open(tad_eth_sap *sap, unsigned int mode)
@@ -1101,6 +1578,14 @@ tad_eth_sap_recv_open(tad_eth_sap *sap, unsigned int mode)
         }
     }
 
+#ifdef TAD_ETH_SAP_BPF
+    /*
+     * Attach the filter before bind to avoid receiving of frames
+     * which do not match the pattern.
+     */
+    tad_eth_sap_filter_attach(sap, mode);
+#endif
+
     /*
      * Bind PF_PACKET socket:
      *  - sll_protocol: ETH_P_ALL - receive everything
@@ -1124,6 +1609,8 @@ tad_eth_sap_recv_open(tad_eth_sap *sap, unsigned int mode)
     if (rc != 0)
         goto error_exit;
 #endif /* WITH_PACKET_MMAP_RX_RING */
+
+    gettimeofday(&data->recv_start, NULL);
 #else
     /*  Obtain a packet capture descriptor */
     data->in = pcap_open_live(sap->name, TAD_ETH_SAP_SNAP_LEN,
@@ -1154,10 +1641,73 @@ error_exit:
     if (close(data->in) < 0)
         assert(FALSE);
     data->in = -1;
+#ifdef TAD_ETH_SAP_BPF
+    data->filter = FALSE;
+#endif
     return rc;
 #endif
 }
 
+/* See the description in tad_eth_sap.h */
+te_errno
+tad_eth_sap_recv_fanout(tad_eth_sap *sap, unsigned int group,
+                        unsigned int fanout)
+{
+#if defined(USE_PF_PACKET) && defined(PACKET_FANOUT)
+    tad_eth_sap_data   *data;
+    int                 arg;
+    te_errno            rc;
+
+    assert(sap != NULL);
+    data = sap->data;
+    assert(data != NULL);
+    assert(data->in >= 0);
+
+    switch (fanout)
+    {
+        case TAD_RECV_FANOUT_HASH:
+            /*
+             * PACKET_FANOUT_FLAG_DEFRAG is not used: CSAP must get
+             * IP fragments as they are on the wire. Fragments of one
+             * datagram may be hashed to different workers then, but
+             * they are matched independently and the merge stage
+             * reports them in the order of reception anyway.
+             */
+            arg = PACKET_FANOUT_HASH;
+            break;
+
+        case TAD_RECV_FANOUT_CPU:
+            arg = PACKET_FANOUT_CPU;
+            break;
+
+        default:
+            ERROR("%s(): Unknown fan-out mode %u", __FUNCTION__, fanout);
+            return TE_RC(TE_TAD_PF_PACKET, TE_EINVAL);
+    }
+    arg = (arg << 16) | (group & 0xffff);
+
+    if (setsockopt(data->in, SOL_PACKET, PACKET_FANOUT,
+                   &arg, sizeof(arg)) != 0)
+    {
+        rc = TE_OS_RC(TE_TAD_PF_PACKET, errno);
+        ERROR("%s(): setsockopt(PACKET_FANOUT, %u) failed: %r",
+              __FUNCTION__, group & 0xffff, rc);
+        return rc;
+    }
+
+    INFO("PF_PACKET socket %d joined fan-out group %u",
+         data->in, group & 0xffff);
+
+    return 0;
+#else
+    UNUSED(sap);
+    UNUSED(group);
+    UNUSED(fanout);
+
+    return TE_RC(TE_TAD_CSAP, TE_EOPNOTSUPP);
+#endif
+}
+
 #if defined(USE_PF_PACKET) && !defined(WITH_PACKET_MMAP_RX_RING)
 static int
 tad_eth_sap_parse_ancillary_data(int msg_flags, tad_pkt *pkt, size_t *pkt_len,
@@ -1399,6 +1949,7 @@ tad_eth_sap_recv_close(tad_eth_sap *sap)
     data = sap->data;
     assert(data != NULL);
 #ifdef USE_PF_PACKET
+    tad_eth_sap_recv_stats(sap);
 #ifdef WITH_PACKET_MMAP_RX_RING
     tad_eth_sap_pkt_rx_ring_release(sap);
 #endif /* WITH_PACKET_MMAP_RX_RING */
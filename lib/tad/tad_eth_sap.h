@@ -97,6 +97,23 @@ extern te_errno tad_eth_sap_send_open(tad_eth_sap  *sap,
  */
 extern te_errno tad_eth_sap_send(tad_eth_sap *sap, const tad_pkt *pkt);
 
+/**
+ * Send a batch of Ethernet frames using service access point opened
+ * for sending. Frames are passed to the kernel by sendmmsg() in
+ * chunks where it is available, one by one otherwise.
+ *
+ * @param sap           SAP description structure
+ * @param pkts          Frames to be sent
+ * @param sent          Location for number of frames sent
+ *
+ * @return Status code.
+ *
+ * @sa tad_eth_sap_send()
+ */
+extern te_errno tad_eth_sap_send_pkts(tad_eth_sap *sap,
+                                      const tad_pkts *pkts,
+                                      unsigned int *sent);
+
 /**
  * Close Ethernet service access point for sending.
  *
@@ -122,6 +139,23 @@ extern te_errno tad_eth_sap_send_close(tad_eth_sap *sap);
 extern te_errno tad_eth_sap_recv_open(tad_eth_sap  *sap,
                                       unsigned int  mode);
 
+/**
+ * Join service access point opened for receiving to a fan-out group.
+ * Frames received on the interface are spread over access points
+ * of the group instead of being received by each of them.
+ *
+ * @param sap           SAP description structure
+ * @param group         Fan-out group ID (unique for the host)
+ * @param fanout        Fan-out mode (see enum tad_recv_fanout in
+ *                      tad_common.h)
+ *
+ * @return Status code.
+ * @retval TE_EOPNOTSUPP    Fan-out is not supported by the provider
+ */
+extern te_errno tad_eth_sap_recv_fanout(tad_eth_sap  *sap,
+                                        unsigned int  group,
+                                        unsigned int  fanout);
+
 /**
  * Receive Ethernet frame using service access point opened for
  * receiving.
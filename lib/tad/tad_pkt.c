@@ -29,11 +29,17 @@
 #include "te_errno.h"
 #include "logger_api.h"
 #include "logger_ta_fast.h"
+#include "te_simd.h"
 
 #include "tad_common.h"
 #include "tad_pkt.h"
 
 
+/** Swap bytes of 16-bit checksum */
+#define TAD_PKT_CSUM_SWAP(_sum) \
+    ((uint16_t)(((_sum) << 8) | ((_sum) >> 8)))
+
+
 #undef assert
 #define assert(x) \
     ( { do {                    \
@@ -1224,7 +1230,6 @@ tad_pkt_match_mask(const tad_pkt *pkt, size_t len, const uint8_t *mask,
 {
     const tad_pkt_seg  *seg;
     size_t              slen;
-    const uint8_t      *d, *m, *v;
 
     if (exact_len && (tad_pkt_len(pkt) != len))
     {
@@ -1239,21 +1244,18 @@ tad_pkt_match_mask(const tad_pkt *pkt, size_t len, const uint8_t *mask,
     F_VERB("%s(): length to be matched is %u", __FUNCTION__,
            (unsigned)len);
 
-    m = mask; v = value;
     TAD_PKT_FOR_EACH_SEG_FWD(&pkt->segs, seg)
     {
-        for (slen = seg->data_len, d = seg->data_ptr;
-             (len > 0) && (slen > 0);
-             d++, m++, v++, len--, slen--)
-        {
-            F_VERB("d: %x & m: %x ?= v: %x & m: %x", *d, *m, *v, *m);
-            if ((*d & *m) != (*v & *m))
-            {
-                return TE_ETADNOTMATCH;
-            }
-        }
         if (len == 0)
             break;
+
+        slen = MIN(seg->data_len, len);
+        if (!te_simd_match_mask(seg->data_ptr, mask, value, slen))
+            return TE_ETADNOTMATCH;
+
+        mask += slen;
+        value += slen;
+        len -= slen;
     }
     assert(len == 0);
 
@@ -1265,17 +1267,68 @@ te_errno
 tad_pkt_match_bytes(const tad_pkt *pkt, size_t len,
                     const uint8_t *payload, te_bool exact_len)
 {
-    uint8_t   *mask;
-    te_errno   rv;
+    const tad_pkt_seg  *seg;
+    size_t              slen;
+
+    if (exact_len && (tad_pkt_len(pkt) != len))
+        return TE_ETADNOTMATCH;
+
+    if (len > tad_pkt_len(pkt))
+        len = tad_pkt_len(pkt);
+
+    TAD_PKT_FOR_EACH_SEG_FWD(&pkt->segs, seg)
+    {
+        if (len == 0)
+            break;
+
+        slen = MIN(seg->data_len, len);
+        if (memcmp(seg->data_ptr, payload, slen) != 0)
+            return TE_ETADNOTMATCH;
+
+        payload += slen;
+        len -= slen;
+    }
+    assert(len == 0);
+
+    return 0;
+}
+
+/* See description in tad_pkt.h */
+uint16_t
+tad_pkt_csum_part(const tad_pkt *pkt, uint32_t checksum)
+{
+    const tad_pkt_seg  *seg;
+    te_bool             odd = FALSE;
+    uint16_t            sum;
+
+    sum = te_simd_csum_part(checksum, NULL, 0);
 
-    if ((mask = malloc(len)) == NULL)
-        return TE_ENOMEM;
+    TAD_PKT_FOR_EACH_SEG_FWD(&pkt->segs, seg)
+    {
+        if (seg->data_len == 0)
+            continue;
 
-    memset(mask, 0xFF, len);
-    rv = tad_pkt_match_mask(pkt, len, mask, payload, exact_len);
-    free(mask);
+        /*
+         * Data of a segment starting at odd offset are summed up with
+         * bytes swapped, so the sum is swapped before and after that
+         * (one's complement sum does not depend on byte order).
+         */
+        if (odd)
+        {
+            sum = te_simd_csum_part(TAD_PKT_CSUM_SWAP(sum), seg->data_ptr,
+                                    seg->data_len);
+            sum = TAD_PKT_CSUM_SWAP(sum);
+        }
+        else
+        {
+            sum = te_simd_csum_part(sum, seg->data_ptr, seg->data_len);
+        }
+
+        if (seg->data_len & 1)
+            odd = !odd;
+    }
 
-    return rv;
+    return sum;
 }
 
 /* See description in tad_pkt.h */
@@ -706,6 +706,18 @@ extern te_errno tad_pkt_match_bytes(const tad_pkt *pkt, size_t len,
                                     const uint8_t *payload,
                                     te_bool exact_len);
 
+/**
+ * Add packet data to Internet checksum (16-bit one's complement sum
+ * of 16-bit words). Segments may have any length, the packet is
+ * summed up as contiguous data padded to even length.
+ *
+ * @param pkt           Packet
+ * @param checksum      Sum to start from
+ *
+ * @return Folded 16-bit sum, the same as ip_csum_part() of the data.
+ */
+extern uint16_t tad_pkt_csum_part(const tad_pkt *pkt, uint32_t checksum);
+
 /**
  * Alloc additional segments for the packet
  *
@@ -21,6 +21,7 @@
 #include <netinet/in.h>
 #include <unistd.h>
 
+#include "te_alloc.h"
 #include "logger_api.h"
 #include "logger_ta_fast.h"
 #include "rcf_ch_api.h"
@@ -30,6 +31,7 @@
 #include "tad_csap_support.h"
 #include "tad_utils.h"
 #include "tad_recv.h"
+#include "tad_recv_index.h"
 
 
 #define ANS_BUF 100
@@ -439,6 +441,23 @@ tad_recv_preprocess_pattern(csap_p csap, asn_value *pattern,
         }
     }
 
+    /*
+     * Pattern sequence is matched unit by unit, so there is nothing
+     * to select units for.
+     */
+    if (rc == 0 && (csap->state & CSAP_STATE_RECV_SEQ_MATCH) == 0)
+    {
+        te_errno rc_index;
+
+        rc_index = tad_recv_index_build(csap, data, &data->index);
+        if (rc_index != 0 && TE_RC_GET_ERROR(rc_index) != TE_ENOENT)
+        {
+            WARN(CSAP_LOG_FMT "Failed to build dispatch index of pattern "
+                 "units, all units are tried: %r", CSAP_LOG_ARGS(csap),
+                 rc_index);
+        }
+    }
+
     return rc;
 }
 
@@ -483,6 +502,8 @@ tad_recv_free_pattern_data(csap_p csap, tad_recv_pattern_data *data)
         tad_recv_free_pattern_unit_data(csap, data->units + i);
     data->n_units = 0;
 
+    tad_recv_index_free(data->index);
+    data->index = NULL;
     free(data->units);
     data->units = NULL;
     asn_free_value(data->nds);
@@ -512,6 +533,57 @@ tad_recv_init_context(tad_recv_context *context)
     TAILQ_INIT(&context->packets);
 }
 
+/**
+ * Get number of workers to receive and match packets by.
+ *
+ * Packets are received by a number of workers if it is requested in
+ * CSAP parameters, the read/write layer supports receive queues and
+ * result of matching of a packet does not depend on packets matched
+ * before it (pattern sequence is not matched and there are no actions).
+ *
+ * @param csap          CSAP instance
+ * @param ptrn_data     Preprocessed pattern data
+ *
+ * @return Number of workers.
+ */
+static unsigned int
+tad_recv_n_workers(csap_p csap, const tad_recv_pattern_data *ptrn_data)
+{
+    csap_spt_type_p rw_spt;
+    unsigned int    unit;
+
+    if (csap->recv_workers <= 1)
+        return 1;
+
+    rw_spt = csap_get_proto_support(csap, csap_get_rw_layer(csap));
+    if (rw_spt->prepare_recv_queues_cb == NULL ||
+        rw_spt->read_queue_cb == NULL)
+    {
+        WARN(CSAP_LOG_FMT "Receive queues are not supported, receive by "
+             "one thread", CSAP_LOG_ARGS(csap));
+        return 1;
+    }
+
+    if (csap->state & CSAP_STATE_RECV_SEQ_MATCH)
+    {
+        WARN(CSAP_LOG_FMT "Pattern sequence is matched by one thread",
+             CSAP_LOG_ARGS(csap));
+        return 1;
+    }
+
+    for (unit = 0; unit < ptrn_data->n_units; ++unit)
+    {
+        if (ptrn_data->units[unit].n_actions > 0)
+        {
+            WARN(CSAP_LOG_FMT "Pattern with actions is matched by one "
+                 "thread", CSAP_LOG_ARGS(csap));
+            return 1;
+        }
+    }
+
+    return csap->recv_workers;
+}
+
 /* See description in tad_recv.h */
 te_errno
 tad_recv_prepare(csap_p csap, asn_value *pattern, unsigned int num,
@@ -529,6 +601,7 @@ tad_recv_prepare(csap_p csap, asn_value *pattern, unsigned int num,
     my_ctx->status = 0;
     my_ctx->wait_pkts = num;
     my_ctx->match_pkts = my_ctx->got_pkts = my_ctx->no_match_pkts = 0;
+    my_ctx->kern_no_match_pkts = 0;
 
     if (timeout == TAD_TIMEOUT_INF)
     {
@@ -578,6 +651,21 @@ tad_recv_prepare(csap_p csap, asn_value *pattern, unsigned int num,
         return rc;
     }
 
+    my_ctx->n_workers = tad_recv_n_workers(csap, &my_ctx->ptrn_data);
+    if (my_ctx->n_workers > 1)
+    {
+        rc = csap_get_proto_support(csap, csap_get_rw_layer(csap))->
+                 prepare_recv_queues_cb(csap, my_ctx->n_workers,
+                                        csap->recv_fanout);
+        if (rc != 0)
+        {
+            WARN(CSAP_LOG_FMT "Failed to prepare %u receive queues, "
+                 "receive by one thread: %r", CSAP_LOG_ARGS(csap),
+                 my_ctx->n_workers, rc);
+            my_ctx->n_workers = 1;
+        }
+    }
+
     return 0;
 }
 
@@ -1030,11 +1118,16 @@ static te_errno
 tad_recv_match(csap_p csap, tad_recv_pattern_data *ptrn_data,
                tad_recv_pkt *meta_pkt, size_t pkt_len, te_bool *no_report)
 {
-    te_bool         clean_bottom_layer = FALSE;
-    unsigned int    unit;
-    te_errno        rc;
+    te_bool             clean_bottom_layer = FALSE;
+    const unsigned int *cand = NULL;
+    unsigned int        n_cand;
+    unsigned int        first;
+    unsigned int        unit;
+    unsigned int        i;
+    te_errno            rc;
 
-    unit = (csap->state & CSAP_STATE_RECV_SEQ_MATCH) ? ptrn_data->cur_unit : 0;
+    unit = first = (csap->state & CSAP_STATE_RECV_SEQ_MATCH) ?
+                       ptrn_data->cur_unit : 0;
 
     /* Create a packet with received data only for the bottom layer */
     rc = tad_pkt_get_frag(
@@ -1057,7 +1150,21 @@ tad_recv_match(csap_p csap, tad_recv_pattern_data *ptrn_data,
     }
 
     assert(ptrn_data->n_units > 0);
-    do {
+
+    /* Try only units which may match by fixed fields of the packet */
+    n_cand = ptrn_data->n_units - first;
+    if (ptrn_data->index != NULL)
+    {
+        n_cand = tad_recv_index_lookup(ptrn_data->index,
+                                       tad_pkts_first_pkt(&meta_pkt->raw),
+                                       pkt_len, &cand);
+    }
+
+    rc = TE_ETADNOTMATCH;
+    for (i = 0; i < n_cand; ++i)
+    {
+        unit = (cand != NULL) ? cand[i] : first + i;
+
         /* Cleanup artifacts of the previous pattern unit match attempt */
         tad_recv_pkt_cleanup_upper(csap, meta_pkt);
 
@@ -1099,8 +1206,7 @@ tad_recv_match(csap_p csap, tad_recv_pattern_data *ptrn_data,
         }
         if (rc != 0)
             break;
-
-    } while (++unit < ptrn_data->n_units);
+    }
 
 out:
     if (rc == TE_ETADNOTMATCH && clean_bottom_layer)
@@ -1116,6 +1222,10 @@ out:
 /**
  * Add packet into the queue of received packet.
  *
+ * If the read-write layer lends packet data, the data are copied
+ * since the packet outlives the next read. The packet is dropped if
+ * copying fails.
+ *
  * @param csap          CSAP instance
  * @param pkts          Queue of received packets
  * @param pkt           Receiver meta packet
@@ -1123,14 +1233,23 @@ out:
 static void
 tad_recv_pkt_enqueue(csap_p csap, tad_recv_pkts *pkts, tad_recv_pkt *pkt)
 {
-    int ret;
+    int         ret;
+    te_errno    rc;
+
+    if (csap->layers[csap_get_rw_layer(csap)].rw_borrowed_pkt_data &&
+        (rc = tad_recv_pkt_own_data(csap, pkt)) != 0)
+    {
+        ERROR(CSAP_LOG_FMT "Failed to copy received packet data - "
+              "packet is dropped: %r", CSAP_LOG_ARGS(csap), rc);
+        tad_recv_pkt_free(csap, pkt);
+        return;
+    }
 
     CSAP_LOCK(csap);
     TAILQ_INSERT_TAIL(pkts, pkt, links);
     if ((ret = pthread_cond_broadcast(&csap->event)) != 0)
     {
-        te_errno rc = TE_OS_RC(TE_TAD_CH, ret);
-
+        rc = TE_OS_RC(TE_TAD_CH, ret);
         assert(rc != 0);
         ERROR(CSAP_LOG_FMT "Failed to broadcast CSAP event - received "
               "packet: %r - ignore", CSAP_LOG_ARGS(csap), rc);
@@ -1139,6 +1258,470 @@ tad_recv_pkt_enqueue(csap_p csap, tad_recv_pkts *pkts, tad_recv_pkt *pkt)
 }
 
 
+
+/*
+ * Parallel receive by a number of workers.
+ *
+ * Each worker reads packets from its own receive queue of the read/write
+ * layer, matches them and puts matched packets into its queue in order of
+ * receive. The merge stage in the Receiver thread takes packets from
+ * queues of workers in order of their timestamps, counts them and puts
+ * into the queue of received packets. A packet is taken when no worker
+ * can have an earlier packet: either it has an earlier one queued or
+ * its watermark (time of return of the last read) is later. So packets
+ * of the same flow, which are received by the same worker in hash
+ * fan-out mode, keep their order.
+ */
+
+/**
+ * Timeout of waiting for packets in receive workers and in the merge
+ * stage, in microseconds. Idle worker advances its watermark at least
+ * once per the timeout, so it bounds delay of packets in the merge stage.
+ */
+#define TAD_RECV_WORKER_TIMEOUT     10000
+
+struct tad_recv_merge;
+
+/** Receive worker */
+typedef struct tad_recv_worker {
+    struct tad_recv_merge  *merge;      /**< Parallel receive data */
+    unsigned int            queue;      /**< Receive queue to read */
+    pthread_t               thread;     /**< Worker thread */
+    te_bool                 started;    /**< Is the thread started? */
+
+    tad_recv_pkts           pkts;       /**< Packets to be merged */
+    uint64_t                watermark;  /**< Packets which are not queued
+                                             yet are received after
+                                             the moment (microseconds
+                                             since the Epoch) */
+    te_bool                 done;       /**< Is the worker finished? */
+    te_errno                status;     /**< Status of the finished
+                                             worker */
+} tad_recv_worker;
+
+/** Parallel receive data */
+typedef struct tad_recv_merge {
+    csap_p              csap;       /**< CSAP instance */
+    pthread_mutex_t     lock;       /**< Lock of queues and state of
+                                         workers */
+    pthread_cond_t      event;      /**< Packet is queued or worker is
+                                         finished */
+    te_bool             stop;       /**< Workers are requested to stop */
+    unsigned int        n_workers;  /**< Number of workers */
+    tad_recv_worker     workers[];  /**< Workers */
+} tad_recv_merge;
+
+/**
+ * Convert timestamp to microseconds since the Epoch.
+ *
+ * @param tv            Timestamp
+ *
+ * @return Number of microseconds.
+ */
+static inline uint64_t
+tad_recv_tv2us(const struct timeval *tv)
+{
+    return (uint64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+}
+
+/**
+ * Receive worker thread: read packets from the queue of the worker,
+ * match them and pass to the merge stage.
+ *
+ * Workers share the pattern units and the layers protocol data (only
+ * the matching position is copied), so everything reached from
+ * tad_recv_match() must be read-only after CSAP layers and the pattern
+ * are initialized. E.g. compiled paths of BPS fragments are prepared
+ * by tad_bps_pkt_frag_init_paths() in layer init callbacks; per-packet
+ * state lives in the meta-packet.
+ *
+ * @param arg           Receive worker
+ *
+ * @return @c NULL
+ */
+static void *
+tad_recv_worker_thread(void *arg)
+{
+    tad_recv_worker        *worker = arg;
+    tad_recv_merge         *merge = worker->merge;
+    csap_p                  csap = merge->csap;
+    tad_recv_context       *context = csap_get_recv_context(csap);
+    tad_recv_pattern_data   ptrn_data = context->ptrn_data;
+    csap_read_queue_cb_t    read_queue_cb;
+    unsigned int            timeout;
+    tad_recv_pkt           *meta_pkt = NULL;
+    size_t                  read_len;
+    te_bool                 no_report = FALSE;
+    te_bool                 report;
+    te_bool                 wake;
+    te_errno                rc = 0;
+
+    read_queue_cb = csap_get_proto_support(csap,
+                        csap_get_rw_layer(csap))->read_queue_cb;
+    timeout = MIN(csap->stop_latency_timeout, TAD_RECV_WORKER_TIMEOUT);
+
+    while (!__atomic_load_n(&merge->stop, __ATOMIC_RELAXED) &&
+           (csap->state & (CSAP_STATE_COMPLETE | CSAP_STATE_STOP)) == 0)
+    {
+        if ((meta_pkt == NULL) &&
+            ((meta_pkt = tad_recv_pkt_alloc(csap)) == NULL))
+        {
+            ERROR(CSAP_LOG_FMT "Failed to initialize Receiver meta-packet",
+                  CSAP_LOG_ARGS(csap));
+            rc = TE_RC(TE_TAD_CH, TE_ENOMEM);
+            break;
+        }
+
+        rc = read_queue_cb(csap, worker->queue, timeout,
+                           tad_pkts_first_pkt(&meta_pkt->raw), &read_len);
+        gettimeofday(&meta_pkt->ts, NULL);
+        if (TE_RC_GET_ERROR(rc) == TE_ETIMEDOUT)
+        {
+            __atomic_store_n(&worker->watermark,
+                             tad_recv_tv2us(&meta_pkt->ts),
+                             __ATOMIC_RELEASE);
+            rc = 0;
+            continue;
+        }
+        if (rc != 0)
+        {
+            WARN(CSAP_LOG_FMT "Read callback of queue %u failed: %r",
+                 CSAP_LOG_ARGS(csap), worker->queue, rc);
+            break;
+        }
+
+        rc = tad_recv_match(csap, &ptrn_data, meta_pkt, read_len,
+                            &no_report);
+        if (rc == 0)
+        {
+            meta_pkt->match_unit = ptrn_data.cur_unit;
+            report = (csap->state & CSAP_STATE_RESULTS) && !no_report;
+        }
+        else if (TE_RC_GET_ERROR(rc) == TE_ETADNOTMATCH)
+        {
+            __atomic_add_fetch(&context->no_match_pkts, 1,
+                               __ATOMIC_RELAXED);
+            if ((csap->state & CSAP_STATE_RECV_MISMATCH) == 0)
+            {
+                /* Nothing is owned by match routine */
+                tad_recv_pkt_cleanup(csap, meta_pkt);
+                __atomic_store_n(&worker->watermark,
+                                 tad_recv_tv2us(&meta_pkt->ts),
+                                 __ATOMIC_RELEASE);
+                continue;
+            }
+            meta_pkt->match_unit = -1;
+            report = TRUE;
+        }
+        else if (TE_RC_GET_ERROR(rc) == TE_ETADLESSDATA)
+        {
+            /*
+             * Receiver meta packet is owned by match and outlives
+             * the next read, so it should own its data.
+             */
+            if (csap->layers[csap_get_rw_layer(csap)].rw_borrowed_pkt_data)
+                rc = tad_recv_pkt_own_data(csap, meta_pkt);
+            else
+                rc = 0;
+            meta_pkt = NULL;
+            if (rc != 0)
+            {
+                ERROR(CSAP_LOG_FMT "Failed to copy received packet "
+                      "data: %r", CSAP_LOG_ARGS(csap), rc);
+                break;
+            }
+            continue;
+        }
+        else
+        {
+            /* Nothing is owned by match routine */
+            ERROR(CSAP_LOG_FMT "Match unexpectedly failed: %r",
+                  CSAP_LOG_ARGS(csap), rc);
+            break;
+        }
+
+        /*
+         * Packet to be reported outlives the next read, others are
+         * passed to the merge stage to be counted only.
+         */
+        if (!report)
+        {
+            no_report = FALSE;
+            tad_recv_pkt_cleanup(csap, meta_pkt);
+        }
+        else if (csap->layers[csap_get_rw_layer(csap)].rw_borrowed_pkt_data &&
+                 (rc = tad_recv_pkt_own_data(csap, meta_pkt)) != 0)
+        {
+            ERROR(CSAP_LOG_FMT "Failed to copy received packet data: %r",
+                  CSAP_LOG_ARGS(csap), rc);
+            break;
+        }
+
+        pthread_mutex_lock(&merge->lock);
+        wake = TAILQ_EMPTY(&worker->pkts);
+        TAILQ_INSERT_TAIL(&worker->pkts, meta_pkt, links);
+        __atomic_store_n(&worker->watermark, tad_recv_tv2us(&meta_pkt->ts),
+                         __ATOMIC_RELEASE);
+        if (wake)
+            pthread_cond_signal(&merge->event);
+        pthread_mutex_unlock(&merge->lock);
+        meta_pkt = NULL;
+    }
+
+    tad_recv_pkt_free(csap, meta_pkt);
+
+    pthread_mutex_lock(&merge->lock);
+    worker->status = rc;
+    worker->done = TRUE;
+    __atomic_store_n(&worker->watermark, UINT64_MAX, __ATOMIC_RELEASE);
+    pthread_cond_signal(&merge->event);
+    pthread_mutex_unlock(&merge->lock);
+
+    return NULL;
+}
+
+/**
+ * Take the next packet in order of receive from queues of workers.
+ * Workers should be locked or stopped.
+ *
+ * @param merge         Parallel receive data
+ * @param flush         Take packets regardless of progress of workers
+ *
+ * @return Packet or @c NULL if there is no packet which can be taken.
+ */
+static tad_recv_pkt *
+tad_recv_merge_next(tad_recv_merge *merge, te_bool flush)
+{
+    tad_recv_worker    *next = NULL;
+    uint64_t            next_ts = 0;
+    uint64_t            watermark = UINT64_MAX;
+    uint64_t            ts;
+    tad_recv_pkt       *pkt;
+    unsigned int        i;
+
+    for (i = 0; i < merge->n_workers; ++i)
+    {
+        tad_recv_worker *worker = &merge->workers[i];
+
+        pkt = TAILQ_FIRST(&worker->pkts);
+        if (pkt == NULL)
+        {
+            ts = __atomic_load_n(&worker->watermark, __ATOMIC_ACQUIRE);
+            watermark = MIN(watermark, ts);
+            continue;
+        }
+
+        ts = tad_recv_tv2us(&pkt->ts);
+        if (next == NULL || ts < next_ts)
+        {
+            next = worker;
+            next_ts = ts;
+        }
+    }
+
+    if (next == NULL || (!flush && next_ts > watermark))
+        return NULL;
+
+    pkt = TAILQ_FIRST(&next->pkts);
+    TAILQ_REMOVE(&next->pkts, pkt, links);
+
+    return pkt;
+}
+
+/**
+ * Count packet taken from workers and put it into the queue of received
+ * packets if it should be reported.
+ *
+ * @param csap          CSAP instance
+ * @param context       Receiver context
+ * @param pkt           Packet taken from workers
+ *
+ * @return Are all packets to wait for received?
+ */
+static te_bool
+tad_recv_merge_pkt(csap_p csap, tad_recv_context *context,
+                    tad_recv_pkt *pkt)
+{
+    /* Mismatch packets are passed by workers to be reported only */
+    if (pkt->match_unit < 0)
+    {
+        tad_recv_pkt_enqueue(csap, &context->packets, pkt);
+        return FALSE;
+    }
+
+    csap->last_pkt = pkt->ts;
+    if (context->match_pkts == 0)
+        csap->first_pkt = csap->last_pkt;
+    context->match_pkts++;
+
+    if ((csap->state & CSAP_STATE_RESULTS) &&
+        !context->ptrn_data.units[pkt->match_unit].no_report)
+    {
+        F_VERB(CSAP_LOG_FMT "put packet into the queue",
+               CSAP_LOG_ARGS(csap));
+        tad_recv_pkt_enqueue(csap, &context->packets, pkt);
+    }
+    else
+    {
+        tad_recv_pkt_free(csap, pkt);
+    }
+
+    return (context->wait_pkts != 0) &&
+           (context->match_pkts >= context->wait_pkts);
+}
+
+/**
+ * Receive packets by a number of workers and merge them.
+ *
+ * @param csap          CSAP instance
+ * @param context       Receiver context
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_recv_merge_do(csap_p csap, tad_recv_context *context)
+{
+    tad_recv_merge     *merge;
+    tad_recv_worker    *worker;
+    tad_recv_pkt       *pkt;
+    struct timeval      current;
+    struct timeval      deadline;
+    struct timespec     abstime;
+    te_bool             stop_on_timeout = FALSE;
+    te_bool             all_done;
+    te_bool             done = FALSE;
+    unsigned int        i;
+    int                 ret;
+    te_errno            rc = 0;
+
+    merge = TE_ALLOC(sizeof(*merge) +
+                      context->n_workers * sizeof(merge->workers[0]));
+    if (merge == NULL)
+        return TE_RC(TE_TAD_CH, TE_ENOMEM);
+
+    merge->csap = csap;
+    merge->n_workers = context->n_workers;
+    pthread_mutex_init(&merge->lock, NULL);
+    pthread_cond_init(&merge->event, NULL);
+
+    for (i = 0; i < merge->n_workers; ++i)
+    {
+        worker = &merge->workers[i];
+        worker->merge = merge;
+        worker->queue = i;
+        TAILQ_INIT(&worker->pkts);
+    }
+
+    for (i = 0; i < merge->n_workers; ++i)
+    {
+        worker = &merge->workers[i];
+        ret = pthread_create(&worker->thread, NULL,
+                             tad_recv_worker_thread, worker);
+        if (ret != 0)
+        {
+            rc = TE_OS_RC(TE_TAD_CH, ret);
+            ERROR(CSAP_LOG_FMT "Failed to start receive worker %u: %r",
+                  CSAP_LOG_ARGS(csap), i, rc);
+            break;
+        }
+        worker->started = TRUE;
+    }
+
+    INFO(CSAP_LOG_FMT "receive by %u workers", CSAP_LOG_ARGS(csap), i);
+
+    pthread_mutex_lock(&merge->lock);
+    while (rc == 0)
+    {
+        pkt = tad_recv_merge_next(merge, FALSE);
+        if (pkt != NULL)
+        {
+            pthread_mutex_unlock(&merge->lock);
+            done = tad_recv_merge_pkt(csap, context, pkt);
+            pthread_mutex_lock(&merge->lock);
+            if (done)
+            {
+                INFO(CSAP_LOG_FMT "received all packets",
+                     CSAP_LOG_ARGS(csap));
+                break;
+            }
+            continue;
+        }
+
+        if (csap->state & CSAP_STATE_COMPLETE)
+        {
+            INFO(CSAP_LOG_FMT "Receive operation completed",
+                 CSAP_LOG_ARGS(csap));
+            break;
+        }
+        if (csap->state & CSAP_STATE_STOP)
+        {
+            INFO(CSAP_LOG_FMT "Receive operation terminated",
+                 CSAP_LOG_ARGS(csap));
+            rc = TE_RC(TE_TAD_CH, TE_EINTR);
+            break;
+        }
+
+        all_done = TRUE;
+        for (i = 0; i < merge->n_workers && rc == 0; ++i)
+        {
+            all_done = all_done && merge->workers[i].done;
+            rc = merge->workers[i].status;
+        }
+        if (rc != 0 || all_done)
+            break;
+
+        gettimeofday(&current, NULL);
+        deadline = current;
+        deadline.tv_usec += TAD_RECV_WORKER_TIMEOUT;
+        deadline.tv_sec += deadline.tv_usec / 1000000;
+        deadline.tv_usec %= 1000000;
+
+        if (csap->wait_for.tv_sec != 0)
+        {
+            if (timercmp(&current, &csap->wait_for, >) && stop_on_timeout)
+            {
+                INFO(CSAP_LOG_FMT "status complete by timeout",
+                     CSAP_LOG_ARGS(csap));
+                rc = TE_RC(TE_TAD_CH, TE_ETIMEDOUT);
+                break;
+            }
+            if (timercmp(&csap->wait_for, &deadline, <))
+                deadline = csap->wait_for;
+        }
+        /* Workers have certainly read something when waiting is over */
+        stop_on_timeout = TRUE;
+
+        abstime.tv_sec = deadline.tv_sec;
+        abstime.tv_nsec = deadline.tv_usec * 1000;
+        (void)pthread_cond_timedwait(&merge->event, &merge->lock,
+                                     &abstime);
+    }
+    __atomic_store_n(&merge->stop, TRUE, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&merge->lock);
+
+    for (i = 0; i < merge->n_workers; ++i)
+    {
+        if (merge->workers[i].started)
+            pthread_join(merge->workers[i].thread, NULL);
+    }
+
+    /* Packets received before stop are counted and reported as well */
+    while (!done && (pkt = tad_recv_merge_next(merge, TRUE)) != NULL)
+        done = tad_recv_merge_pkt(csap, context, pkt);
+    if (done && TE_RC_GET_ERROR(rc) == TE_ETIMEDOUT)
+        rc = 0;
+
+    for (i = 0; i < merge->n_workers; ++i)
+        tad_recv_pkts_free(csap, &merge->workers[i].pkts);
+
+    pthread_cond_destroy(&merge->event);
+    pthread_mutex_destroy(&merge->lock);
+    free(merge);
+
+    return rc;
+}
+
+
 /* See description in tad_api.h */
 te_errno
 tad_recv_do(csap_p csap)
@@ -1200,6 +1783,12 @@ tad_recv_do(csap_p csap)
             goto exit;
     }
 
+    if (context->n_workers > 1)
+    {
+        rc = tad_recv_merge_do(csap, context);
+        goto exit;
+    }
+
     /*
      * Allocate Receiver packet to avoid extra memory allocation on
      * failed match path.
@@ -1330,7 +1919,21 @@ tad_recv_do(csap_p csap)
             VERB(CSAP_LOG_FMT "received packet does not match since "
                  "more data are available", CSAP_LOG_ARGS(csap));
 
-            /* Receiver meta packet is owned by match */
+            /*
+             * Receiver meta packet is owned by match and outlives
+             * the next read, so it should own its data.
+             */
+            if (csap->layers[csap_get_rw_layer(csap)].rw_borrowed_pkt_data)
+            {
+                rc = tad_recv_pkt_own_data(csap, meta_pkt);
+                if (rc != 0)
+                {
+                    ERROR(CSAP_LOG_FMT "Failed to copy received packet "
+                          "data: %r", CSAP_LOG_ARGS(csap), rc);
+                    meta_pkt = NULL;
+                    break;
+                }
+            }
             meta_pkt = NULL;
 
             /*
@@ -1483,6 +2086,7 @@ tad_recv_get_packets(csap_p csap, tad_reply_context *reply_ctx, te_bool wait,
 {
     te_errno        rc;
     tad_recv_pkt   *pkt = NULL;
+    asn_arena      *arena;
     asn_value      *pdus;
     asn_value      *pdu;
     unsigned int    layer;
@@ -1494,6 +2098,11 @@ tad_recv_get_packets(csap_p csap, tad_reply_context *reply_ctx, te_bool wait,
 
     while ((rc = tad_recv_get_packet(csap, wait, &pkt)) == 0)
     {
+        /*
+         * NDS of the packet is built by layers and freed as soon as it
+         * is reported, so all its values are allocated from one arena.
+         */
+        arena = asn_arena_open();
 
         /* Process packet */
         pkt->nds = asn_init_value(ndn_raw_packet);
@@ -1567,6 +2176,8 @@ tad_recv_get_packets(csap_p csap, tad_reply_context *reply_ctx, te_bool wait,
             }
         }
 
+        asn_arena_close(arena);
+
         rc = tad_reply_pkt(reply_ctx, pkt->nds);
         if (rc != 0)
         {
@@ -110,6 +110,8 @@ typedef struct tad_recv_pattern_data {
                                                  processing unit in pattern */
     tad_recv_ptrn_unit_data    *units;      /**< Array with per-unit
                                                  unit data */
+    struct tad_recv_index      *index;      /**< Dispatch index of units
+                                                 or @c NULL */
 } tad_recv_pattern_data;
 
 
@@ -127,6 +129,13 @@ typedef struct tad_recv_context {
     unsigned int    got_pkts;   /**< Number of matched packets got via
                                      traffic receive get operation */
     unsigned int    no_match_pkts;   /**< Number of unmatched packets */
+    unsigned int    kern_no_match_pkts; /**< Number of packets filtered
+                                             out in the kernel (estimation
+                                             made when receive is
+                                             finished) */
+    unsigned int    n_workers;  /**< Number of receive workers, @c 1
+                                     if packets are received and matched
+                                     by the Receiver thread itself */
 } tad_recv_context;
 
 
@@ -0,0 +1,830 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD Receiver pattern units dispatch index
+ *
+ * Pattern units which have exact values of the same fixed fields are
+ * put into a hash table keyed by these values. The key is extracted
+ * from the received frame and only units found by it plus units which
+ * do not specify the key are tried.
+ *
+ * The index must never reject a unit which may match, so the frame is
+ * parsed conservatively: if the layout of the frame is ambiguous for
+ * the matching code (LLC, 802.1ad and double tags, IPv4 fragments,
+ * IPv6 extension headers, truncated frames), all units are tried.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "TAD Recv Index"
+
+#include "te_config.h"
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#if HAVE_LINUX_IF_ETHER_H
+#include <linux/if_ether.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_alloc.h"
+#include "logger_api.h"
+
+#include "ndn.h"
+#include "ndn_eth.h"
+#include "ndn_ipstack.h"
+
+#include "tad_csap_inst.h"
+#include "tad_bps.h"
+#include "tad_recv.h"
+#include "tad_utils.h"
+#include "tad_recv_index.h"
+
+
+/** Maximum length of a field in octets */
+#define TAD_RECV_INDEX_FIELD_MAX    16
+
+/** Maximum number of octets of the frame parsed to get the key */
+#define TAD_RECV_INDEX_HDRS_MAX \
+    (ETH_HLEN + 4 /* VLAN tag */ + 60 /* IPv4 */ + 4 /* ports */)
+
+/** Minimum number of hash table buckets (power of 2) */
+#define TAD_RECV_INDEX_BUCKETS_MIN  16
+
+/** Fields the index may be built on */
+typedef enum tad_recv_index_field {
+    TAD_RECV_INDEX_ETH_DST,
+    TAD_RECV_INDEX_ETH_SRC,
+    TAD_RECV_INDEX_ETH_VID,
+    TAD_RECV_INDEX_ETH_TYPE,
+    TAD_RECV_INDEX_IP4_PROTO,
+    TAD_RECV_INDEX_IP_SRC,
+    TAD_RECV_INDEX_IP_DST,
+    TAD_RECV_INDEX_L4_SRC,
+    TAD_RECV_INDEX_L4_DST,
+
+    TAD_RECV_INDEX_FIELDS       /**< Number of fields */
+} tad_recv_index_field;
+
+/** Values of fixed fields of a pattern unit or a frame */
+typedef struct tad_recv_index_values {
+    /** Pointers to field values or @c NULL if the field is not exact */
+    const uint8_t  *fld[TAD_RECV_INDEX_FIELDS];
+    /** Storage for field values */
+    uint8_t         buf[TAD_RECV_INDEX_FIELDS][TAD_RECV_INDEX_FIELD_MAX];
+} tad_recv_index_values;
+
+/** Hash table entry: units with the same key */
+typedef struct tad_recv_index_entry {
+    struct tad_recv_index_entry    *next;       /**< Next in the bucket */
+    uint32_t                        hash;       /**< Hash of the key */
+    unsigned int                    n_units;    /**< Number of units */
+    unsigned int                   *units;      /**< Units to try in
+                                                     order of pattern */
+    uint8_t                         key[];      /**< Key */
+} tad_recv_index_entry;
+
+/** Pattern units dispatch index */
+struct tad_recv_index {
+    uint16_t                l3;         /**< Network layer Ethernet type
+                                             or @c 0 */
+    te_bool                 l4;         /**< Is there UDP/TCP layer? */
+    unsigned int            n_units;    /**< Number of pattern units */
+
+    unsigned int            n_fields;   /**< Number of key fields */
+    tad_recv_index_field    fields[TAD_RECV_INDEX_FIELDS]; /**< Key
+                                                                fields */
+    size_t                  key_len;    /**< Length of the key */
+
+    unsigned int            n_buckets;  /**< Number of buckets */
+    tad_recv_index_entry  **buckets;    /**< Hash table */
+
+    unsigned int            n_any;      /**< Number of units without
+                                             the key */
+    unsigned int           *any;        /**< Units without the key */
+    te_bool                 mismatch;   /**< Are mismatch packets
+                                             reported? */
+};
+
+/**
+ * Get length of the field.
+ *
+ * @param index         Dispatch index (to know network layer)
+ * @param field         Field
+ *
+ * @return Length in octets.
+ */
+static size_t
+tad_recv_index_field_len(const tad_recv_index *index,
+                         tad_recv_index_field field)
+{
+    switch (field)
+    {
+        case TAD_RECV_INDEX_ETH_DST:
+        case TAD_RECV_INDEX_ETH_SRC:
+            return ETH_ALEN;
+
+        case TAD_RECV_INDEX_IP4_PROTO:
+            return 1;
+
+        case TAD_RECV_INDEX_IP_SRC:
+        case TAD_RECV_INDEX_IP_DST:
+            return (index->l3 == ETH_P_IP) ? 4 : 16;
+
+        default:
+            return 2;
+    }
+}
+
+/**
+ * Calculate hash of the key (FNV-1a).
+ *
+ * @param key           Key
+ * @param len           Length of the key
+ *
+ * @return Hash value.
+ */
+static uint32_t
+tad_recv_index_hash(const uint8_t *key, size_t len)
+{
+    uint32_t hash = 2166136261U;
+
+    while (len-- > 0)
+        hash = (hash ^ *key++) * 16777619U;
+
+    return hash;
+}
+
+/**
+ * Get exact value of the pattern unit field. Values with partial
+ * masks are not exact.
+ *
+ * @param pdu           PDU of the pattern unit or @c NULL
+ * @param tag           Tag of the field in the PDU
+ * @param value         Location for value
+ * @param len           Length of the field
+ *
+ * @return Is there an exact value?
+ */
+static te_bool
+tad_recv_index_ptrn_field(const asn_value *pdu, asn_tag_value tag,
+                          uint8_t *value, size_t len)
+{
+    uint8_t mask[TAD_RECV_INDEX_FIELD_MAX];
+    size_t  i;
+
+    if (!tad_du_get_value_mask(pdu, NULL, tag, ASN_TAG_INVALID,
+                               value, mask, len))
+        return FALSE;
+
+    for (i = 0; i < len; ++i)
+    {
+        if (mask[i] != 0xff)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * Get exact VLAN ID of Ethernet PDU of the pattern unit.
+ *
+ * @param pdu           Ethernet PDU of the pattern unit or @c NULL
+ * @param value         Location for VLAN ID in network byte order
+ *
+ * @return Is there an exact VLAN ID?
+ */
+static te_bool
+tad_recv_index_ptrn_vid(const asn_value *pdu, uint8_t *value)
+{
+    const asn_value    *tagged;
+    asn_value          *tag_hdr;
+    asn_tag_value       tagged_tag;
+    uint8_t             mask[2];
+
+    if (pdu == NULL ||
+        asn_get_child_value(pdu, &tagged, PRIVATE,
+                            NDN_TAG_VLAN_TAGGED) != 0 ||
+        asn_get_choice_value(tagged, &tag_hdr, NULL, &tagged_tag) != 0 ||
+        tagged_tag != NDN_TAG_VLAN_TAG_HEADER ||
+        !tad_du_get_value_mask(tag_hdr, NULL, NDN_TAG_VLAN_TAG_HEADER_VID,
+                               ASN_TAG_INVALID, value, mask, 2) ||
+        (mask[0] & 0x0f) != 0x0f || mask[1] != 0xff)
+        return FALSE;
+
+    value[0] &= 0x0f;
+    return TRUE;
+}
+
+/**
+ * Get PDU of the pattern unit.
+ *
+ * @param pdus          Sequence of PDUs of the pattern unit or @c NULL
+ * @param layer         Layer index
+ *
+ * @return PDU or @c NULL.
+ */
+static const asn_value *
+tad_recv_index_layer_pdu(const asn_value *pdus, unsigned int layer)
+{
+    asn_value *gen_pdu;
+    asn_value *pdu;
+
+    if (pdus == NULL ||
+        asn_get_indexed(pdus, &gen_pdu, layer, NULL) != 0 ||
+        asn_get_choice_value(gen_pdu, &pdu, NULL, NULL) != 0)
+        return NULL;
+
+    return pdu;
+}
+
+/**
+ * Get exact values of fixed fields of the pattern unit.
+ *
+ * @param csap          CSAP instance
+ * @param index         Dispatch index being built
+ * @param unit          Pattern unit data
+ * @param vals          Location for values
+ */
+static void
+tad_recv_index_ptrn_values(csap_p csap, const tad_recv_index *index,
+                           const tad_recv_ptrn_unit_data *unit,
+                           tad_recv_index_values *vals)
+{
+    static const struct {
+        tad_recv_index_field    field;
+        unsigned int            level;  /**< Layer from the bottom */
+        asn_tag_value           tag;
+        asn_tag_value           tag6;   /**< Tag in IPv6 or TCP PDU */
+    } fields[] = {
+        { TAD_RECV_INDEX_ETH_DST, 0, NDN_TAG_802_3_DST,
+          NDN_TAG_802_3_DST },
+        { TAD_RECV_INDEX_ETH_SRC, 0, NDN_TAG_802_3_SRC,
+          NDN_TAG_802_3_SRC },
+        { TAD_RECV_INDEX_ETH_TYPE, 0, NDN_TAG_802_3_LENGTH_TYPE,
+          NDN_TAG_802_3_LENGTH_TYPE },
+        { TAD_RECV_INDEX_IP4_PROTO, 1, NDN_TAG_IP4_PROTOCOL,
+          ASN_TAG_INVALID },
+        { TAD_RECV_INDEX_IP_SRC, 1, NDN_TAG_IP4_SRC_ADDR,
+          NDN_TAG_IP6_SRC_ADDR },
+        { TAD_RECV_INDEX_IP_DST, 1, NDN_TAG_IP4_DST_ADDR,
+          NDN_TAG_IP6_DST_ADDR },
+        { TAD_RECV_INDEX_L4_SRC, 2, NDN_TAG_UDP_SRC_PORT,
+          NDN_TAG_TCP_SRC_PORT },
+        { TAD_RECV_INDEX_L4_DST, 2, NDN_TAG_UDP_DST_PORT,
+          NDN_TAG_TCP_DST_PORT },
+    };
+    const asn_value    *pdus = NULL;
+    const asn_value    *pdu;
+    unsigned int        layer;
+    te_bool             alt;
+    asn_tag_value       tag;
+    unsigned int        i;
+
+    memset(vals->fld, 0, sizeof(vals->fld));
+
+    if (asn_get_child_value(unit->nds, &pdus, PRIVATE, NDN_PU_PDUS) != 0)
+        return;
+
+    for (i = 0; i < TE_ARRAY_LEN(fields); ++i)
+    {
+        if ((fields[i].level >= 1 && index->l3 == 0) ||
+            (fields[i].level >= 2 && !index->l4))
+            continue;
+
+        layer = csap->depth - 1 - fields[i].level;
+        switch (fields[i].level)
+        {
+            case 1:
+                alt = (index->l3 == ETH_P_IPV6);
+                break;
+            case 2:
+                alt = (csap->layers[layer].proto_tag == TE_PROTO_TCP);
+                break;
+            default:
+                alt = FALSE;
+                break;
+        }
+        tag = alt ? fields[i].tag6 : fields[i].tag;
+        if (tag == ASN_TAG_INVALID)
+            continue;
+
+        pdu = tad_recv_index_layer_pdu(pdus, layer);
+        if (pdu != NULL &&
+            tad_recv_index_ptrn_field(pdu, tag,
+                vals->buf[fields[i].field],
+                tad_recv_index_field_len(index, fields[i].field)))
+            vals->fld[fields[i].field] = vals->buf[fields[i].field];
+    }
+
+    pdu = tad_recv_index_layer_pdu(pdus, csap->depth - 1);
+    if (tad_recv_index_ptrn_vid(pdu, vals->buf[TAD_RECV_INDEX_ETH_VID]))
+    {
+        vals->fld[TAD_RECV_INDEX_ETH_VID] =
+            vals->buf[TAD_RECV_INDEX_ETH_VID];
+    }
+}
+
+/** Field value of a pattern unit to be sorted */
+typedef struct tad_recv_index_sort_item {
+    const uint8_t  *value;  /**< Value */
+    size_t          len;    /**< Length of the value */
+} tad_recv_index_sort_item;
+
+/** Compare field values, qsort() callback */
+static int
+tad_recv_index_sort_cmp(const void *a, const void *b)
+{
+    const tad_recv_index_sort_item *x = a;
+    const tad_recv_index_sort_item *y = b;
+
+    return memcmp(x->value, y->value, x->len);
+}
+
+/**
+ * Count distinct exact values of the field in pattern units.
+ *
+ * @param index         Dispatch index being built
+ * @param vals          Values of fields of units
+ * @param n_units       Number of units
+ * @param field         Field
+ * @param items         Array of @p n_units items for sorting
+ *
+ * @return Number of distinct values.
+ */
+static unsigned int
+tad_recv_index_distinct(const tad_recv_index *index,
+                        const tad_recv_index_values *vals,
+                        unsigned int n_units, tad_recv_index_field field,
+                        tad_recv_index_sort_item *items)
+{
+    size_t          len = tad_recv_index_field_len(index, field);
+    unsigned int    n = 0;
+    unsigned int    distinct;
+    unsigned int    i;
+
+    for (i = 0; i < n_units; ++i)
+    {
+        if (vals[i].fld[field] != NULL)
+        {
+            items[n].value = vals[i].fld[field];
+            items[n].len = len;
+            n++;
+        }
+    }
+    if (n == 0)
+        return 0;
+
+    qsort(items, n, sizeof(*items), tad_recv_index_sort_cmp);
+    for (distinct = 1, i = 1; i < n; ++i)
+    {
+        if (memcmp(items[i - 1].value, items[i].value, len) != 0)
+            distinct++;
+    }
+
+    return distinct;
+}
+
+/**
+ * Make the key of the index from field values.
+ *
+ * @param index         Dispatch index
+ * @param vals          Field values
+ * @param key           Location for the key
+ *
+ * @return @c FALSE if some key field has no value.
+ */
+static te_bool
+tad_recv_index_make_key(const tad_recv_index *index,
+                        const tad_recv_index_values *vals, uint8_t *key)
+{
+    unsigned int    i;
+    size_t          len;
+
+    for (i = 0; i < index->n_fields; ++i)
+    {
+        if (vals->fld[index->fields[i]] == NULL)
+            return FALSE;
+
+        len = tad_recv_index_field_len(index, index->fields[i]);
+        memcpy(key, vals->fld[index->fields[i]], len);
+        key += len;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Find hash table entry by key.
+ *
+ * @param index         Dispatch index
+ * @param key           Key
+ * @param hash          Hash of the key
+ *
+ * @return Entry or @c NULL.
+ */
+static tad_recv_index_entry *
+tad_recv_index_find(const tad_recv_index *index, const uint8_t *key,
+                    uint32_t hash)
+{
+    tad_recv_index_entry *entry;
+
+    for (entry = index->buckets[hash & (index->n_buckets - 1)];
+         entry != NULL; entry = entry->next)
+    {
+        if (entry->hash == hash &&
+            memcmp(entry->key, key, index->key_len) == 0)
+            return entry;
+    }
+
+    return NULL;
+}
+
+/**
+ * Add the unit to the entry with the key, create the entry if there is
+ * no such one yet. Units are added in order of the pattern.
+ *
+ * @param index         Dispatch index being built
+ * @param key           Key
+ * @param unit          Index of the unit in the pattern
+ * @param max_units     Maximum number of units in the entry
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_recv_index_add(tad_recv_index *index, const uint8_t *key,
+                   unsigned int unit, unsigned int max_units)
+{
+    uint32_t                hash = tad_recv_index_hash(key, index->key_len);
+    tad_recv_index_entry   *entry;
+
+    entry = tad_recv_index_find(index, key, hash);
+    if (entry == NULL)
+    {
+        entry = TE_ALLOC(sizeof(*entry) + index->key_len);
+        if (entry == NULL)
+            return TE_RC(TE_TAD_CH, TE_ENOMEM);
+        entry->units = TE_ALLOC(max_units * sizeof(*entry->units));
+        if (entry->units == NULL)
+        {
+            free(entry);
+            return TE_RC(TE_TAD_CH, TE_ENOMEM);
+        }
+
+        entry->hash = hash;
+        memcpy(entry->key, key, index->key_len);
+        entry->next = index->buckets[hash & (index->n_buckets - 1)];
+        index->buckets[hash & (index->n_buckets - 1)] = entry;
+    }
+
+    entry->units[entry->n_units++] = unit;
+    return 0;
+}
+
+/**
+ * Merge units without the key into units of each entry keeping
+ * order of the pattern.
+ *
+ * @param index         Dispatch index being built
+ */
+static void
+tad_recv_index_merge_any(tad_recv_index *index)
+{
+    tad_recv_index_entry   *entry;
+    unsigned int            bucket;
+    unsigned int            i;
+    unsigned int            j;
+    unsigned int            k;
+
+    if (index->n_any == 0)
+        return;
+
+    for (bucket = 0; bucket < index->n_buckets; ++bucket)
+    {
+        for (entry = index->buckets[bucket]; entry != NULL;
+             entry = entry->next)
+        {
+            /*
+             * The array is allocated for all units, so merge from
+             * the end in place.
+             */
+            i = entry->n_units;
+            j = index->n_any;
+            k = i + j;
+            while (j > 0)
+            {
+                if (i > 0 && entry->units[i - 1] > index->any[j - 1])
+                    entry->units[--k] = entry->units[--i];
+                else
+                    entry->units[--k] = index->any[--j];
+            }
+            entry->n_units += index->n_any;
+        }
+    }
+}
+
+/* See description in tad_recv_index.h */
+te_errno
+tad_recv_index_build(csap_p csap,
+                     const struct tad_recv_pattern_data *ptrn_data,
+                     tad_recv_index **index)
+{
+    tad_recv_index             *idx;
+    tad_recv_index_values      *vals = NULL;
+    tad_recv_index_sort_item   *items = NULL;
+    uint8_t                     key[TAD_RECV_INDEX_FIELDS *
+                                    TAD_RECV_INDEX_FIELD_MAX];
+    unsigned int                n_units = ptrn_data->n_units;
+    unsigned int                distinct;
+    unsigned int                best = 0;
+    tad_recv_index_field        field;
+    tad_recv_index_field        primary = TAD_RECV_INDEX_ETH_DST;
+    unsigned int                i;
+    te_errno                    rc;
+
+    *index = NULL;
+
+    if (n_units < 2 || csap->depth == 0 ||
+        csap->layers[csap->depth - 1].proto_tag != TE_PROTO_ETH)
+        return TE_RC(TE_TAD_CH, TE_ENOENT);
+
+    idx = TE_ALLOC(sizeof(*idx));
+    if (idx == NULL)
+        return TE_RC(TE_TAD_CH, TE_ENOMEM);
+    idx->n_units = n_units;
+    idx->mismatch = (csap->state & CSAP_STATE_RECV_MISMATCH) != 0;
+
+    if (csap->depth >= 2)
+    {
+        switch (csap->layers[csap->depth - 2].proto_tag)
+        {
+            case TE_PROTO_IP4:
+                idx->l3 = ETH_P_IP;
+                break;
+            case TE_PROTO_IP6:
+                idx->l3 = ETH_P_IPV6;
+                break;
+            default:
+                break;
+        }
+    }
+    if (idx->l3 != 0 && csap->depth >= 3)
+    {
+        idx->l4 = (csap->layers[csap->depth - 3].proto_tag ==
+                       TE_PROTO_UDP ||
+                   csap->layers[csap->depth - 3].proto_tag ==
+                       TE_PROTO_TCP);
+    }
+
+    vals = TE_ALLOC(n_units * sizeof(*vals));
+    items = TE_ALLOC(n_units * sizeof(*items));
+    if (vals == NULL || items == NULL)
+    {
+        rc = TE_RC(TE_TAD_CH, TE_ENOMEM);
+        goto fail;
+    }
+
+    for (i = 0; i < n_units; ++i)
+        tad_recv_index_ptrn_values(csap, idx, ptrn_data->units + i,
+                                   vals + i);
+
+    /* The primary field is the one which distinguishes most units */
+    for (field = 0; field < TAD_RECV_INDEX_FIELDS; ++field)
+    {
+        distinct = tad_recv_index_distinct(idx, vals, n_units, field,
+                                           items);
+        if (distinct > best)
+        {
+            best = distinct;
+            primary = field;
+        }
+    }
+    if (best < 2)
+    {
+        rc = TE_RC(TE_TAD_CH, TE_ENOENT);
+        goto fail;
+    }
+
+    /* Other fields given in all units with the primary one */
+    idx->fields[idx->n_fields++] = primary;
+    idx->key_len = tad_recv_index_field_len(idx, primary);
+    for (field = 0; field < TAD_RECV_INDEX_FIELDS; ++field)
+    {
+        if (field == primary)
+            continue;
+
+        for (i = 0; i < n_units; ++i)
+        {
+            if (vals[i].fld[primary] != NULL && vals[i].fld[field] == NULL)
+                break;
+        }
+        if (i == n_units)
+        {
+            idx->fields[idx->n_fields++] = field;
+            idx->key_len += tad_recv_index_field_len(idx, field);
+        }
+    }
+
+    for (idx->n_buckets = TAD_RECV_INDEX_BUCKETS_MIN;
+         idx->n_buckets < best; idx->n_buckets <<= 1);
+    idx->buckets = TE_ALLOC(idx->n_buckets * sizeof(*idx->buckets));
+    idx->any = TE_ALLOC(n_units * sizeof(*idx->any));
+    if (idx->buckets == NULL || idx->any == NULL)
+    {
+        rc = TE_RC(TE_TAD_CH, TE_ENOMEM);
+        goto fail;
+    }
+
+    for (i = 0; i < n_units; ++i)
+    {
+        if (!tad_recv_index_make_key(idx, vals + i, key))
+        {
+            idx->any[idx->n_any++] = i;
+            continue;
+        }
+
+        rc = tad_recv_index_add(idx, key, i, n_units);
+        if (rc != 0)
+            goto fail;
+    }
+    tad_recv_index_merge_any(idx);
+
+    VERB(CSAP_LOG_FMT "Dispatch index on %u fields: %u keys, %u units "
+         "without key", CSAP_LOG_ARGS(csap), idx->n_fields, best,
+         idx->n_any);
+
+    free(vals);
+    free(items);
+    *index = idx;
+    return 0;
+
+fail:
+    free(vals);
+    free(items);
+    tad_recv_index_free(idx);
+    return rc;
+}
+
+/**
+ * Get values of fixed fields of the received frame. Only fields of
+ * headers which layout is not ambiguous are got.
+ *
+ * @param index         Dispatch index
+ * @param hdrs          Headers of the frame
+ * @param len           Length of headers
+ * @param vals          Location for values
+ */
+static void
+tad_recv_index_pkt_values(const tad_recv_index *index, const uint8_t *hdrs,
+                          size_t len, tad_recv_index_values *vals)
+{
+    size_t      l3_off = ETH_HLEN;
+    size_t      l4_off;
+    uint16_t    type;
+
+    memset(vals->fld, 0, sizeof(vals->fld));
+
+    if (len < ETH_HLEN)
+        return;
+
+    vals->fld[TAD_RECV_INDEX_ETH_DST] = hdrs;
+    vals->fld[TAD_RECV_INDEX_ETH_SRC] = hdrs + ETH_ALEN;
+
+    /*
+     * 802.1Q tag is always parsed by Ethernet layer, other tags are
+     * parsed depending on the pattern unit.
+     */
+    type = (hdrs[2 * ETH_ALEN] << 8) | hdrs[2 * ETH_ALEN + 1];
+    if (type == ETH_P_8021Q)
+    {
+        if (len < ETH_HLEN + 4)
+            return;
+
+        vals->buf[TAD_RECV_INDEX_ETH_VID][0] = hdrs[ETH_HLEN - 2] & 0x0f;
+        vals->buf[TAD_RECV_INDEX_ETH_VID][1] = hdrs[ETH_HLEN - 1];
+        vals->fld[TAD_RECV_INDEX_ETH_VID] =
+            vals->buf[TAD_RECV_INDEX_ETH_VID];
+
+        l3_off += 4;
+        type = (hdrs[l3_off - 2] << 8) | hdrs[l3_off - 1];
+    }
+    if (type < ETH_P_802_3_MIN || type == ETH_P_8021Q ||
+        type == ETH_P_8021AD || type == ETH_P_QINQ1)
+        return;
+    vals->fld[TAD_RECV_INDEX_ETH_TYPE] = hdrs + l3_off - 2;
+
+    if (type != index->l3)
+        return;
+
+    if (type == ETH_P_IP)
+    {
+        if (len < l3_off + 20 || (hdrs[l3_off] >> 4) != 4)
+            return;
+
+        vals->fld[TAD_RECV_INDEX_IP4_PROTO] = hdrs + l3_off + 9;
+        vals->fld[TAD_RECV_INDEX_IP_SRC] = hdrs + l3_off + 12;
+        vals->fld[TAD_RECV_INDEX_IP_DST] = hdrs + l3_off + 16;
+
+        /* Fragments may be reassembled, do not select units by them */
+        if ((hdrs[l3_off + 6] & 0x3f) != 0 || hdrs[l3_off + 7] != 0)
+            return;
+
+        l4_off = l3_off + ((hdrs[l3_off] & 0xf) << 2);
+        if (hdrs[l3_off + 9] != IPPROTO_UDP &&
+            hdrs[l3_off + 9] != IPPROTO_TCP)
+            return;
+    }
+    else
+    {
+        if (len < l3_off + 40 || (hdrs[l3_off] >> 4) != 6)
+            return;
+
+        vals->fld[TAD_RECV_INDEX_IP_SRC] = hdrs + l3_off + 8;
+        vals->fld[TAD_RECV_INDEX_IP_DST] = hdrs + l3_off + 24;
+
+        /* Extension headers are not parsed */
+        l4_off = l3_off + 40;
+        if (hdrs[l3_off + 6] != IPPROTO_UDP &&
+            hdrs[l3_off + 6] != IPPROTO_TCP)
+            return;
+    }
+
+    if (!index->l4 || len < l4_off + 4)
+        return;
+
+    vals->fld[TAD_RECV_INDEX_L4_SRC] = hdrs + l4_off;
+    vals->fld[TAD_RECV_INDEX_L4_DST] = hdrs + l4_off + 2;
+}
+
+/* See description in tad_recv_index.h */
+unsigned int
+tad_recv_index_lookup(const tad_recv_index *index, const tad_pkt *pkt,
+                      size_t pkt_len, const unsigned int **units)
+{
+    uint8_t                 hdrs[TAD_RECV_INDEX_HDRS_MAX];
+    uint8_t                 key[TAD_RECV_INDEX_FIELDS *
+                                TAD_RECV_INDEX_FIELD_MAX];
+    tad_recv_index_values   vals;
+    tad_recv_index_entry   *entry;
+    size_t                  len;
+
+    *units = NULL;
+
+    len = MIN(MIN(pkt_len, tad_pkt_len(pkt)), sizeof(hdrs));
+    if (len == 0)
+        return index->n_units;
+    tad_pkt_read(pkt, tad_pkt_first_seg(pkt), 0, len, hdrs);
+
+    tad_recv_index_pkt_values(index, hdrs, len, &vals);
+    if (!tad_recv_index_make_key(index, &vals, key))
+        return index->n_units;
+
+    entry = tad_recv_index_find(index, key,
+                                tad_recv_index_hash(key, index->key_len));
+    if (entry == NULL)
+    {
+        /*
+         * Mismatch packet is reported with the payload from the layer
+         * which does not match, so units are tried as without index.
+         */
+        if (index->n_any == 0 && index->mismatch)
+            return index->n_units;
+
+        *units = index->any;
+        return index->n_any;
+    }
+
+    *units = entry->units;
+    return entry->n_units;
+}
+
+/* See description in tad_recv_index.h */
+void
+tad_recv_index_free(tad_recv_index *index)
+{
+    tad_recv_index_entry   *entry;
+    unsigned int            bucket;
+
+    if (index == NULL)
+        return;
+
+    for (bucket = 0; bucket < index->n_buckets && index->buckets != NULL;
+         ++bucket)
+    {
+        while ((entry = index->buckets[bucket]) != NULL)
+        {
+            index->buckets[bucket] = entry->next;
+            free(entry->units);
+            free(entry);
+        }
+    }
+    free(index->buckets);
+    free(index->any);
+    free(index);
+}
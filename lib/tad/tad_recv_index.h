@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD Receiver pattern units dispatch index
+ *
+ * Declarations of the index which allows to find pattern units which
+ * may match a received packet by fixed fields of the packet instead
+ * of trying all units of the pattern one by one.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_TAD_RECV_INDEX_H__
+#define __TE_TAD_RECV_INDEX_H__
+
+#include "te_errno.h"
+#include "tad_types.h"
+#include "tad_pkt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct tad_recv_pattern_data;
+
+/** Pattern units dispatch index (opaque) */
+typedef struct tad_recv_index tad_recv_index;
+
+/**
+ * Build dispatch index of preprocessed traffic pattern.
+ *
+ * The index is built on fixed fields of frames received by Ethernet
+ * CSAPs (Ethernet addresses, VLAN ID, length/type, IPv4/IPv6 addresses
+ * and protocol, UDP/TCP ports) which have exact values in pattern
+ * units. The field with the most distinct values is chosen and other
+ * fields which have exact values in all units indexed by it are added
+ * to the key. Units which do not specify the key are tried for any
+ * packet.
+ *
+ * @param csap          CSAP instance
+ * @param ptrn_data     Preprocessed traffic pattern
+ * @param index         Location for the index
+ *
+ * @return Status code.
+ * @retval TE_ENOENT    Pattern units cannot be distinguished by fixed
+ *                      fields or the CSAP is not Ethernet-based
+ */
+extern te_errno tad_recv_index_build(
+                    csap_p                              csap,
+                    const struct tad_recv_pattern_data *ptrn_data,
+                    tad_recv_index                    **index);
+
+/**
+ * Find pattern units which may match the received packet. Units are
+ * returned in order of the pattern, so the first matching unit is
+ * the same as if all units are tried. If no unit may match and
+ * the CSAP reports mismatch packets, all units are tried.
+ *
+ * The index is not changed by lookup, so it may be done by many
+ * threads concurrently.
+ *
+ * @param index         Dispatch index
+ * @param pkt           Received packet
+ * @param pkt_len       Length of received data in the packet
+ * @param units         Location for array of indices of units or
+ *                      @c NULL if all units should be tried (the key
+ *                      cannot be found in the packet)
+ *
+ * @return Number of units to try.
+ */
+extern unsigned int tad_recv_index_lookup(const tad_recv_index *index,
+                                          const tad_pkt *pkt,
+                                          size_t pkt_len,
+                                          const unsigned int **units);
+
+/**
+ * Free dispatch index.
+ *
+ * @param index         Dispatch index or @c NULL
+ */
+extern void tad_recv_index_free(tad_recv_index *index);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_TAD_RECV_INDEX_H__ */
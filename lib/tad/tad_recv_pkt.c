@@ -14,6 +14,13 @@
 
 #include "te_config.h"
 
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
 #include "logger_api.h"
 #include "logger_ta_fast.h"
 #include "asn_usr.h"
@@ -213,3 +220,69 @@ tad_recv_pkt_cleanup(csap_p csap, tad_recv_pkt *pkt)
     pkt->nds = NULL;
 }
 
+
+/**
+ * Move segments of the packet which refer to the old data location
+ * to the new one.
+ *
+ * @param pkt           Packet
+ * @param old_ptr       Old data location
+ * @param len           Length of data
+ * @param new_ptr       New data location
+ */
+static void
+tad_recv_pkt_rebase_segs(tad_pkt *pkt, const uint8_t *old_ptr, size_t len,
+                         uint8_t *new_ptr)
+{
+    tad_pkt_seg    *seg;
+    const uint8_t  *ptr;
+
+    TAD_PKT_FOR_EACH_SEG_FWD(&pkt->segs, seg)
+    {
+        ptr = seg->data_ptr;
+        if (ptr >= old_ptr && ptr < old_ptr + len)
+            seg->data_ptr = new_ptr + (ptr - old_ptr);
+    }
+}
+
+/* See the description in tad_recv_pkt.h */
+te_errno
+tad_recv_pkt_own_data(csap_p csap, tad_recv_pkt *pkt)
+{
+    tad_pkt        *raw;
+    tad_pkt        *p;
+    tad_pkt_seg    *seg;
+    uint8_t        *data;
+    unsigned int    layer;
+
+    assert(csap != NULL);
+    assert(pkt != NULL);
+
+    TAD_PKT_FOR_EACH_PKT_FWD(&pkt->raw.pkts, raw)
+    {
+        TAD_PKT_FOR_EACH_SEG_FWD(&raw->segs, seg)
+        {
+            if (seg->data_free != NULL || seg->data_len == 0)
+                continue;
+
+            data = malloc(seg->data_len);
+            if (data == NULL)
+                return TE_RC(TE_TAD_CH, TE_ENOMEM);
+            memcpy(data, seg->data_ptr, seg->data_len);
+
+            for (layer = 0; layer < csap->depth; ++layer)
+            {
+                TAD_PKT_FOR_EACH_PKT_FWD(&pkt->layers[layer].pkts.pkts, p)
+                    tad_recv_pkt_rebase_segs(p, seg->data_ptr,
+                                             seg->data_len, data);
+            }
+            tad_recv_pkt_rebase_segs(&pkt->payload, seg->data_ptr,
+                                     seg->data_len, data);
+
+            seg->data_ptr = data;
+            seg->data_free = tad_pkt_seg_data_free;
+        }
+    }
+
+    return 0;
+}
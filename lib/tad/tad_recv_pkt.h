@@ -66,6 +66,20 @@ extern tad_recv_pkt *tad_recv_pkt_alloc(csap_p csap);
 extern void tad_recv_pkt_cleanup_upper(csap_p csap, tad_recv_pkt *pkt);
 extern void tad_recv_pkt_cleanup(csap_p csap, tad_recv_pkt *pkt);
 
+/**
+ * Make received packet own its data. Segments of raw packets without
+ * data free function may refer to memory of the read-write layer which
+ * is valid until the next read only (e.g. to the receive ring). Such
+ * data are copied and segments of layer packets and payload which
+ * refer to them are moved to the copy.
+ *
+ * @param csap          CSAP instance
+ * @param pkt           Received packet
+ *
+ * @return Status code.
+ */
+extern te_errno tad_recv_pkt_own_data(csap_p csap, tad_recv_pkt *pkt);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
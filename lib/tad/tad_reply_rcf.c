@@ -50,13 +50,15 @@ typedef struct tad_reply_rcf_ctx  {
                                              command */
     size_t  prefix_len;                 /**< Length of the Test Protocol
                                              answer prefix */
+    unsigned int    bin_version;        /**< Version of binary encoding
+                                             of packets or @c 0 */
 } tad_reply_rcf_ctx;
 
 
 static te_errno
 tad_reply_rfc_ctx_alloc(rcf_comm_connection *rcfc,
                         const char *answer_pfx, size_t pfx_len,
-                        tad_reply_rcf_ctx **ctxp)
+                        unsigned int bin_version, tad_reply_rcf_ctx **ctxp)
 {
     tad_reply_rcf_ctx  *ctx;
 
@@ -73,6 +75,7 @@ tad_reply_rfc_ctx_alloc(rcf_comm_connection *rcfc,
 
     ctx->rcfc = rcfc;
     ctx->prefix_len = pfx_len;
+    ctx->bin_version = bin_version;
     memcpy(ctx->answer_buf, answer_pfx, pfx_len);
 
     *ctxp = ctx;
@@ -146,7 +149,20 @@ tad_reply_rcf_pkt(void *opaque, const asn_value *pkt)
 
     assert(pkt != NULL);
 
-    attach_len = asn_count_txt_len(pkt, 0) + 1;
+    if (ctx->bin_version != 0)
+    {
+        rc = asn_count_bin_len(pkt, &attach_len);
+        if (rc != 0)
+        {
+            ERROR("%s(): failed to count length of binary encoding of "
+                  "packet: %r", __FUNCTION__, rc);
+            return rc;
+        }
+    }
+    else
+    {
+        attach_len = asn_count_txt_len(pkt, 0) + 1;
+    }
     VERB("%s(): attach len %u", __FUNCTION__, (unsigned)attach_len);
 
     buffer = calloc(1, ctx->prefix_len + EXTRA_BUF_SPACE + attach_len);
@@ -165,7 +181,21 @@ tad_reply_rcf_pkt(void *opaque, const asn_value *pkt)
     }
     cmd_len = strlen(buffer) + 1;
 
-    if ((attach_rlen =
+    if (ctx->bin_version != 0)
+    {
+        size_t bin_len = attach_len;
+
+        rc = asn_encode_bin(pkt, buffer + cmd_len, &bin_len);
+        if (rc != 0 || bin_len != attach_len)
+        {
+            ERROR("%s(): asn_encode_bin() failed: %r, expected length "
+                  "%u, got %u", __FUNCTION__, rc, (unsigned)attach_len,
+                  (unsigned)bin_len);
+            free(buffer);
+            return rc != 0 ? rc : TE_EFAULT;
+        }
+    }
+    else if ((attach_rlen =
          asn_sprint_value(pkt, buffer + cmd_len, attach_len, 0))
         != (int)(attach_len - 1))
     {
@@ -199,12 +229,14 @@ static const tad_reply_spec tad_reply_rfc = {
 /* See the description in tad_reply_rcf.h */
 te_errno
 tad_reply_rcf_init(tad_reply_context *ctx, rcf_comm_connection *rcfc,
-                   const char *answer_pfx, size_t pfx_len)
+                   const char *answer_pfx, size_t pfx_len,
+                   unsigned int bin_version)
 {
     te_errno            rc;
     tad_reply_rcf_ctx  *rcf_ctx = NULL; /* Just to make compiler happy */
 
-    rc = tad_reply_rfc_ctx_alloc(rcfc, answer_pfx, pfx_len, &rcf_ctx);
+    rc = tad_reply_rfc_ctx_alloc(rcfc, answer_pfx, pfx_len, bin_version,
+                                 &rcf_ctx);
     if (rc != 0)
         return rc;
 
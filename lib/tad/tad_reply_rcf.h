@@ -30,13 +30,16 @@ extern "C" {
  * @param rcfc          RCF connection handle
  * @param answer_pfx    Answer prefix
  * @param pfx           Answer prefix length
+ * @param bin_version   Version of binary encoding of reported packets
+ *                      or @c 0 to report packets in text
  *
  * @return Status code.
  */
 extern te_errno tad_reply_rcf_init(tad_reply_context   *ctx,
                                    rcf_comm_connection *rcfc,
                                    const char          *answer_pfx,
-                                   size_t               pfx_len);
+                                   size_t               pfx_len,
+                                   unsigned int         bin_version);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -44,6 +44,12 @@
 /* buffer for send answer */
 #define RBUF 100
 
+/**
+ * Maximum number of template iterations which packets are collected
+ * to be passed to the CSAP write callback for a batch of packets.
+ */
+#define TAD_SEND_BATCH  64
+
 
 /**
  * Preprocess traffic template sequence of PDUs using protocol-specific
@@ -661,6 +667,8 @@ tad_send_cb(tad_pkt *pkt, void *opaque)
         csap->first_pkt = csap->last_pkt;
 
     csap->sender.sent_pkts++;
+    csap->sender.sent_bytes += tad_pkt_len(pkt);
+    csap->sender.send_calls++;
 
     F_VERB(CSAP_LOG_FMT "write callback OK, sent %u packets",
            CSAP_LOG_ARGS(csap), csap->sender.sent_pkts);
@@ -672,14 +680,59 @@ tad_send_cb(tad_pkt *pkt, void *opaque)
 /**
  * Send list of packets.
  *
+ * If the CSAP read/write layer supports sending of a batch of packets,
+ * whole list is passed to it at once, otherwise packets are sent
+ * one by one.
+ *
  * @param csap      CSAP instance
+ * @param pkts      List of packets to send
  *
  * @return Status code.
  */
 static te_errno
 tad_send_packets(csap_p csap, tad_pkts *pkts)
 {
-    return tad_pkt_enumerate(pkts, tad_send_cb, csap);
+    csap_write_pkts_cb_t    write_pkts_cb;
+    unsigned int            sent = 0;
+    tad_pkt                *pkt;
+    te_errno                rc;
+
+    write_pkts_cb = csap_get_proto_support(csap,
+                        csap_get_rw_layer(csap))->write_pkts_cb;
+    if (write_pkts_cb == NULL)
+        return tad_pkt_enumerate(pkts, tad_send_cb, csap);
+
+    if (pkts->n_pkts == 0)
+        return 0;
+
+    rc = write_pkts_cb(csap, pkts, &sent);
+    if (rc != 0)
+    {
+        F_ERROR(CSAP_LOG_FMT "Write packets callback error after %u "
+                "of %u packets: %r", CSAP_LOG_ARGS(csap), sent,
+                pkts->n_pkts, rc);
+    }
+    csap->sender.send_calls++;
+
+    if (sent > 0)
+    {
+        gettimeofday(&csap->last_pkt, NULL);
+        if (csap->sender.sent_pkts == 0)
+            csap->first_pkt = csap->last_pkt;
+
+        csap->sender.sent_pkts += sent;
+        TAD_PKT_FOR_EACH_PKT_FWD(&pkts->pkts, pkt)
+        {
+            if (sent-- == 0)
+                break;
+            csap->sender.sent_bytes += tad_pkt_len(pkt);
+        }
+    }
+
+    F_VERB(CSAP_LOG_FMT "write packets callback done, sent %u packets",
+           CSAP_LOG_ARGS(csap), csap->sender.sent_pkts);
+
+    return rc;
 }
 
 
@@ -713,6 +766,11 @@ tad_send_by_template_unit(csap_p csap, tad_send_tmpl_unit_data *tu_data)
 {
     te_errno        rc;
     tad_pkts       *pkts;
+    tad_pkts       *iter_pkts;
+    tad_pkts        batch;
+    unsigned int    batch_max;
+    unsigned int    batch_len = 0;
+    te_bool         more;
     unsigned int    i;
 
 #if 1 /* FIXME: More part of this processing to prepare stage */
@@ -723,15 +781,6 @@ tad_send_by_template_unit(csap_p csap, tad_send_tmpl_unit_data *tu_data)
 
     F_ENTRY();
 
-    pkts = malloc((csap->depth + 1) * sizeof(*pkts));
-    if (pkts == NULL)
-        return TE_RC(TE_TAD_CH, TE_ENOMEM);
-
-    for (i = 0; i <= csap->depth; i++)
-    {
-        tad_pkts_init(&pkts[i]);
-    }
-
 #if 1 /* FIXME: More part of this processing to prepare stage */
     rc = asn_read_string(tu_data->nds, &send_cb_name, "send-func");
     if (rc == 0)
@@ -753,6 +802,30 @@ tad_send_by_template_unit(csap_p csap, tad_send_tmpl_unit_data *tu_data)
 #endif
         rc = 0;
 
+    /*
+     * Packets generated by several iterations are collected to be
+     * sent at once if the CSAP is able to send a batch of packets.
+     * Packets of all layers are kept until the batch is sent, since
+     * lower layer packets may refer to data of upper layer ones.
+     */
+    batch_max = (send_cb == NULL &&
+                 csap_get_proto_support(csap,
+                     csap_get_rw_layer(csap))->write_pkts_cb != NULL) ?
+                TAD_SEND_BATCH : 1;
+
+    pkts = malloc(batch_max * (csap->depth + 1) * sizeof(*pkts));
+    if (pkts == NULL)
+    {
+        free(send_cb_name);
+        return TE_RC(TE_TAD_CH, TE_ENOMEM);
+    }
+
+    for (i = 0; i < batch_max * (csap->depth + 1); i++)
+    {
+        tad_pkts_init(&pkts[i]);
+    }
+    tad_pkts_init(&batch);
+
     do {
 
         /* Check CSAP state */
@@ -765,14 +838,21 @@ tad_send_by_template_unit(csap_p csap, tad_send_tmpl_unit_data *tu_data)
         }
 
         /* Generate packets to be send */
+        iter_pkts = pkts + batch_len * (csap->depth + 1);
+        batch_len++;
         rc = tad_send_prepare_bin(csap, tu_data->nds,
                                   tu_data->arg_iterated,
                                   tu_data->arg_num,
                                   &tu_data->pld_spec,
                                   tu_data->layer_opaque,
-                                  pkts);
+                                  iter_pkts);
         F_VERB("send_prepare_bin rc: %r", rc);
 
+        more = (rc == 0 &&
+                tad_iterate_tmpl_args(tu_data->arg_specs,
+                                      tu_data->arg_num,
+                                      tu_data->arg_iterated) > 0);
+
         /* Delay requested amount of time between iterations */
         if (rc == 0)
         {
@@ -784,26 +864,42 @@ tad_send_by_template_unit(csap_p csap, tad_send_tmpl_unit_data *tu_data)
         /* Send generated packets */
         if (rc == 0)
         {
-            if (send_cb == NULL)
-                rc = tad_send_packets(csap, pkts);
+            if (send_cb != NULL)
+            {
+                rc = send_cb(csap, send_cb_userdata, iter_pkts);
+            }
             else
-                rc = send_cb(csap, send_cb_userdata, pkts);
+            {
+                tad_pkts_move(&batch, iter_pkts);
+                if (more && batch_len < batch_max)
+                    continue;
+
+                rc = tad_send_packets(csap, &batch);
+            }
             F_VERB(CSAP_LOG_FMT "send done for a template unit "
                    "iteration: %r", CSAP_LOG_ARGS(csap), rc);
         }
+        else if (batch.n_pkts > 0)
+        {
+            /*
+             * Packets of preceding iterations are prepared successfully
+             * and would have been sent already without batching, so
+             * send them before reporting failure of this iteration.
+             * Send errors are logged, but preparation error is returned.
+             */
+            (void)tad_send_packets(csap, &batch);
+        }
 
         /* Free resources allocated for packets */
-        tad_send_free_packets(pkts, csap->depth + 1);
+        tad_free_pkts(&batch);
+        tad_send_free_packets(pkts, batch_len * (csap->depth + 1));
+        batch_len = 0;
 
-    } while (rc == 0 &&
-             tad_iterate_tmpl_args(tu_data->arg_specs,
-                                   tu_data->arg_num,
-                                   tu_data->arg_iterated) > 0);
+    } while (rc == 0 && more);
 
-#if 0
-    /* Looks like double free */
-    tad_send_free_packets(pkts, csap->depth + 1);
-#endif
+    /* Free packets collected before the operation is terminated */
+    tad_free_pkts(&batch);
+    tad_send_free_packets(pkts, batch_len * (csap->depth + 1));
     free(pkts);
     free(send_cb_name);
 
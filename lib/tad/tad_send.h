@@ -65,6 +65,9 @@ typedef struct tad_send_context {
     te_errno                status;     /**< Status of the send operation
                                              to be returned on stop */
     unsigned int            sent_pkts;  /**< Number of sent packets */
+    uint64_t                sent_bytes; /**< Number of sent octets */
+    unsigned int            send_calls; /**< Number of calls of write
+                                             callbacks of the CSAP */
 } tad_send_context;
 
 
@@ -66,6 +66,29 @@ typedef enum {
     TAD_EXPR_ARG_RAND,     /**< Random integer value */
 } tad_expr_node_type;
 
+/**
+ * Instruction of expression compiled to code of a stack machine.
+ */
+typedef struct tad_int_expr_insn {
+    tad_expr_node_type  op;     /**< Operation: constant, argument and
+                                     random value are pushed to the
+                                     stack, arithmetic operations
+                                     replace their operands on the top
+                                     of the stack with the result */
+    int64_t             val;    /**< Constant value or number of
+                                     referenced argument */
+} tad_int_expr_insn;
+
+/**
+ * Expression compiled to code of a stack machine, instructions
+ * are operations of the expression tree in post-order with constant
+ * subexpressions folded.
+ */
+typedef struct tad_int_expr_code {
+    unsigned int        n_insns;    /**< Number of instructions */
+    tad_int_expr_insn   insns[];    /**< Instructions */
+} tad_int_expr_code;
+
 /**
  * Type for expression presentation struct
  */
@@ -89,6 +112,8 @@ struct tad_int_expr_t {
         int     arg_num;        /**< number of referenced argument */
         tad_int_expr_t *exprs;  /**< array with operands */
     };
+    tad_int_expr_code  *code;   /**< compiled expression in the root
+                                     node or @c NULL to walk the tree */
 };
 
 /**
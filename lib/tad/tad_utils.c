@@ -36,6 +36,7 @@
 
 #include "tad_csap_inst.h"
 #include "tad_csap_support.h"
+#include "tad_bps.h"
 #include "tad_utils.h"
 #include "asn_usr.h"
 #include "ndn.h"
@@ -46,6 +47,9 @@
 /** Name of the function to generate random number in TAD expression */
 #define TAD_EXPR_FUNC_RAND  "rand()"
 
+/** Maximum depth of the stack to evaluate compiled expression */
+#define TAD_INT_EXPR_STACK_MAX  32
+
 /**
  * Description see in tad_utils.h
  */
@@ -337,8 +341,9 @@ tad_univ_match_field(const tad_data_unit_t *pattern, asn_value *pkt_pdu,
  *
  * @return status code.
  */
-int
-tad_int_expr_parse(const char *string, tad_int_expr_t **expr, int *syms)
+static int
+tad_int_expr_parse_node(const char *string, tad_int_expr_t **expr,
+                        int *syms)
 {
     const char *p = string;
     int rc = 0;
@@ -381,7 +386,7 @@ tad_int_expr_parse(const char *string, tad_int_expr_t **expr, int *syms)
 
         (*expr)->exprs = calloc((*expr)->d_len, sizeof(tad_int_expr_t));
 
-        rc = tad_int_expr_parse(p, &sub_expr, &sub_expr_parsed);
+        rc = tad_int_expr_parse_node(p, &sub_expr, &sub_expr_parsed);
         VERB("first subexpr parsed, rc %r, syms %d", rc, sub_expr_parsed);
         if (rc)
             goto parse_error;
@@ -419,7 +424,7 @@ tad_int_expr_parse(const char *string, tad_int_expr_t **expr, int *syms)
             while (isspace(*p))
                 p++;
 
-            rc = tad_int_expr_parse(p, &sub_expr, &sub_expr_parsed);
+            rc = tad_int_expr_parse_node(p, &sub_expr, &sub_expr_parsed);
             VERB("second subexpr parsed, rc %r, syms %d",
                  rc, sub_expr_parsed);
             if (rc)
@@ -513,6 +518,311 @@ parse_error:
     return rc;
 }
 
+/**
+ * Get value of constant expression node.
+ *
+ * @param expr          Constant node
+ *
+ * @return Value of the constant.
+ */
+static int64_t
+tad_int_expr_const_val(const tad_int_expr_t *expr)
+{
+    return (expr->d_len == 8) ? expr->val_i64 : expr->val_i32;
+}
+
+/**
+ * Apply arithmetic operation to operands.
+ *
+ * @param op            Operation
+ * @param r1            The first operand
+ * @param r2            The second operand (ignored for unary minus)
+ * @param result        Location for the result
+ *
+ * @return status code.
+ */
+static int
+tad_int_expr_op(tad_expr_node_type op, int64_t r1, int64_t r2,
+                int64_t *result)
+{
+    switch (op)
+    {
+        case TAD_EXPR_ADD:
+            *result = r1 + r2;
+            break;
+        case TAD_EXPR_SUBSTR:
+            *result = r1 - r2;
+            break;
+        case TAD_EXPR_MULT:
+            *result = r1 * r2;
+            break;
+        case TAD_EXPR_DIV:
+        case TAD_EXPR_MOD:
+            if (r2 == 0)
+            {
+                ERROR("%s(): division by zero", __FUNCTION__);
+                return TE_EINVAL;
+            }
+            if (r1 == INT64_MIN && r2 == -1)
+            {
+                ERROR("%s(): division overflow", __FUNCTION__);
+                return TE_EINVAL;
+            }
+            *result = (op == TAD_EXPR_DIV) ? r1 / r2 : r1 % r2;
+            break;
+        case TAD_EXPR_U_MINUS:
+            *result = - r1;
+            break;
+        default:
+            ERROR("%s(): unknown type of expr node: %d",
+                  __FUNCTION__, op);
+            return TE_EINVAL;
+    }
+    return 0;
+}
+
+/**
+ * Count nodes of expression tree.
+ *
+ * @param expr          Expression (sub)tree
+ *
+ * @return Number of nodes.
+ */
+static unsigned int
+tad_int_expr_count_nodes(const tad_int_expr_t *expr)
+{
+    unsigned int    n = 1;
+    unsigned int    i;
+
+    if (expr->n_type != TAD_EXPR_CONSTANT &&
+        expr->n_type != TAD_EXPR_ARG_LINK &&
+        expr->n_type != TAD_EXPR_ARG_RAND)
+    {
+        for (i = 0; i < expr->d_len; i++)
+            n += tad_int_expr_count_nodes(expr->exprs + i);
+    }
+
+    return n;
+}
+
+/**
+ * Emit code of expression subtree in post-order. Operations on
+ * constants are folded into constants.
+ *
+ * @param expr          Expression (sub)tree
+ * @param code          Code to append instructions to
+ * @param depth         Depth of the stack before the subtree code
+ *
+ * @return status code.
+ * @retval TE_E2BIG     Stack depth exceeds TAD_INT_EXPR_STACK_MAX
+ */
+static int
+tad_int_expr_emit(const tad_int_expr_t *expr, tad_int_expr_code *code,
+                  unsigned int depth)
+{
+    unsigned int        start = code->n_insns;
+    tad_int_expr_insn  *insn;
+    unsigned int        i;
+    int64_t             val;
+    int                 rc;
+
+    if (depth >= TAD_INT_EXPR_STACK_MAX)
+        return TE_E2BIG;
+
+    switch (expr->n_type)
+    {
+        case TAD_EXPR_CONSTANT:
+            insn = &code->insns[code->n_insns++];
+            insn->op = TAD_EXPR_CONSTANT;
+            insn->val = tad_int_expr_const_val(expr);
+            return 0;
+
+        case TAD_EXPR_ARG_LINK:
+        case TAD_EXPR_ARG_RAND:
+            insn = &code->insns[code->n_insns++];
+            insn->op = expr->n_type;
+            insn->val = expr->arg_num;
+            return 0;
+
+        default:
+            break;
+    }
+
+    for (i = 0; i < expr->d_len; i++)
+    {
+        rc = tad_int_expr_emit(expr->exprs + i, code, depth + i);
+        if (rc != 0)
+            return rc;
+    }
+
+    /*
+     * Fold the operation if all operands are constants, division by
+     * zero is left to be reported on evaluation.
+     */
+    insn = &code->insns[start];
+    if (code->n_insns - start == expr->d_len &&
+        insn[0].op == TAD_EXPR_CONSTANT &&
+        (expr->d_len == 1 ||
+         (insn[1].op == TAD_EXPR_CONSTANT &&
+          (insn[1].val != 0 || (expr->n_type != TAD_EXPR_DIV &&
+                                expr->n_type != TAD_EXPR_MOD)))) &&
+        tad_int_expr_op(expr->n_type, insn[0].val,
+                        expr->d_len == 1 ? 0 : insn[1].val, &val) == 0)
+    {
+        code->n_insns = start + 1;
+        insn[0].val = val;
+        return 0;
+    }
+
+    insn = &code->insns[code->n_insns++];
+    insn->op = expr->n_type;
+    insn->val = 0;
+
+    return 0;
+}
+
+/**
+ * Compile expression tree to code of a stack machine which is used
+ * by tad_int_expr_calculate() instead of walking the tree. If the
+ * expression cannot be compiled, the tree is kept to be walked.
+ *
+ * @param expr          Root of expression tree
+ *
+ * @return status code.
+ */
+static int
+tad_int_expr_compile(tad_int_expr_t *expr)
+{
+    tad_int_expr_code  *code;
+    int                 rc;
+
+    code = malloc(sizeof(*code) + tad_int_expr_count_nodes(expr) *
+                                  sizeof(code->insns[0]));
+    if (code == NULL)
+        return TE_ENOMEM;
+
+    code->n_insns = 0;
+    rc = tad_int_expr_emit(expr, code, 0);
+    if (rc != 0)
+    {
+        free(code);
+        return rc;
+    }
+
+    free(expr->code);
+    expr->code = code;
+
+    return 0;
+}
+
+/* See description in tad_utils.h */
+int
+tad_int_expr_parse(const char *string, tad_int_expr_t **expr, int *syms)
+{
+    int rc;
+
+    rc = tad_int_expr_parse_node(string, expr, syms);
+    if (rc != 0)
+        return rc;
+
+    rc = tad_int_expr_compile(*expr);
+    if (rc != 0)
+    {
+        WARN("%s(): failed to compile expression '%s', it is evaluated "
+             "walking the tree: %r", __FUNCTION__, string, rc);
+    }
+
+    return 0;
+}
+
+/**
+ * Evaluate expression compiled to code of a stack machine.
+ *
+ * @param code          Compiled expression
+ * @param args          Array with arguments
+ * @param num_args      Length of arguments array
+ * @param result        Location for result (OUT)
+ *
+ * @return status code.
+ */
+static int
+tad_int_expr_run(const tad_int_expr_code *code,
+                 const tad_tmpl_arg_t *args, size_t num_args,
+                 int64_t *result)
+{
+    int64_t                     stack[TAD_INT_EXPR_STACK_MAX];
+    int64_t                    *sp = stack;
+    int64_t                     top = 0;
+    const tad_int_expr_insn    *insn = code->insns;
+    const tad_int_expr_insn    *end = insn + code->n_insns;
+    int                         rc;
+
+    /* The top of the stack is kept in @p top, the rest is in @p stack */
+    for (; insn < end; insn++)
+    {
+        switch (insn->op)
+        {
+            case TAD_EXPR_CONSTANT:
+                *sp++ = top;
+                top = insn->val;
+                break;
+
+            case TAD_EXPR_ARG_LINK:
+                if (args == NULL)
+                    return TE_EWRONGPTR;
+
+                if (insn->val < 0 || (uint64_t)insn->val >= num_args)
+                {
+                    ERROR("%s(): wrong arg ref: %d, num of iter. args: %d",
+                          __FUNCTION__, (int)insn->val, num_args);
+                    return TE_ETADWRONGNDS;
+                }
+
+                if (args[insn->val].type != TAD_TMPL_ARG_INT)
+                {
+                    ERROR("%s(): wrong arg %d type: %d, not integer",
+                          __FUNCTION__, (int)insn->val,
+                          args[insn->val].type);
+                    return TE_ETADWRONGNDS;
+                }
+                *sp++ = top;
+                top = args[insn->val].arg_int;
+                break;
+
+            case TAD_EXPR_ARG_RAND:
+                *sp++ = top;
+                top = rand();
+                break;
+
+            case TAD_EXPR_ADD:
+                top = *--sp + top;
+                break;
+
+            case TAD_EXPR_SUBSTR:
+                top = *--sp - top;
+                break;
+
+            case TAD_EXPR_MULT:
+                top = *--sp * top;
+                break;
+
+            case TAD_EXPR_U_MINUS:
+                top = - top;
+                break;
+
+            default:
+                sp--;
+                rc = tad_int_expr_op(insn->op, *sp, top, &top);
+                if (rc != 0)
+                    return rc;
+                break;
+        }
+    }
+
+    *result = top;
+    return 0;
+}
+
 static void
 tad_int_expr_free_subtree(tad_int_expr_t *expr)
 {
@@ -538,6 +848,7 @@ tad_int_expr_free(tad_int_expr_t *expr)
     if(expr == NULL)
         return;
     tad_int_expr_free_subtree(expr);
+    free(expr->code);
     free(expr);
 }
 
@@ -560,6 +871,9 @@ tad_int_expr_calculate(const tad_int_expr_t *expr,
     if (expr == NULL || result == NULL)
         return TE_EWRONGPTR;
 
+    if (expr->code != NULL)
+        return tad_int_expr_run(expr->code, args, num_args, result);
+
     switch (expr->n_type)
     {
         case TAD_EXPR_CONSTANT:
@@ -601,7 +915,7 @@ tad_int_expr_calculate(const tad_int_expr_t *expr,
 
         default:
         {
-            int64_t r1, r2;
+            int64_t r1, r2 = 0;
 
             rc = tad_int_expr_calculate(expr->exprs, args, num_args, &r1);
             if (rc != 0)
@@ -618,31 +932,9 @@ tad_int_expr_calculate(const tad_int_expr_t *expr,
             VERB("%s(): left %d, right %d, op %d",
                  __FUNCTION__, (int)r1, (int)r2, (int)expr->n_type);
 
-            switch (expr->n_type)
-            {
-                case TAD_EXPR_ADD:
-                    *result = r1 + r2;
-                    break;
-                case TAD_EXPR_SUBSTR:
-                    *result = r1 - r2;
-                    break;
-                case TAD_EXPR_MULT:
-                    *result = r1 * r2;
-                    break;
-                case TAD_EXPR_DIV:
-                    *result = r1 / r2;
-                    break;
-                case TAD_EXPR_MOD:
-                    *result = r1 % r2;
-                    break;
-                case TAD_EXPR_U_MINUS:
-                    *result = - r1;
-                    break;
-                default:
-                    ERROR("%s(): unknown type of expr node: %d",
-                          __FUNCTION__, expr->n_type);
-                    return TE_EINVAL;
-            }
+            rc = tad_int_expr_op(expr->n_type, r1, r2, result);
+            if (rc != 0)
+                return rc;
             VERB("%s(): arythm result %d", __FUNCTION__, (int)(*result));
         } /* end of 'default' sub-block */
     }
@@ -2088,3 +2380,74 @@ tad_du_get_cksum_str_code(tad_data_unit_t *du)
         return TAD_CKSUM_STR_CODE_NONE;
     }
 }
+
+/* See description in 'tad_utils.h' */
+te_bool
+tad_du_get_value_mask(const asn_value *pdu, const asn_value *csap_pdu,
+                      asn_tag_value tag, asn_tag_value rx_def_tag,
+                      uint8_t *value, uint8_t *mask, size_t len)
+{
+    const asn_value    *du = NULL;
+    asn_value          *du_val;
+    asn_tag_value       du_tag;
+    int32_t             val_i32;
+    size_t              val_len;
+    size_t              i;
+
+    if (pdu == NULL ||
+        asn_get_child_value(pdu, &du, PRIVATE, tag) != 0)
+    {
+        if (csap_pdu == NULL || rx_def_tag == ASN_TAG_INVALID ||
+            asn_get_child_value(csap_pdu, &du, PRIVATE, rx_def_tag) != 0)
+            return FALSE;
+    }
+
+    if (asn_get_choice_value(du, &du_val, NULL, &du_tag) != 0)
+        return FALSE;
+
+    switch (du_tag)
+    {
+        case NDN_DU_PLAIN:
+            switch (asn_get_syntax(du_val, ""))
+            {
+                case INTEGER:
+                case UINTEGER:
+                case ENUMERATED:
+                    if (len > sizeof(val_i32) ||
+                        asn_read_int32(du_val, &val_i32, "") != 0)
+                        return FALSE;
+                    for (i = len; i-- > 0; val_i32 >>= 8)
+                        value[i] = val_i32 & 0xff;
+                    break;
+
+                case OCT_STRING:
+                    val_len = len;
+                    if (asn_get_length(du_val, "") != (int)len ||
+                        asn_read_value_field(du_val, value, &val_len,
+                                             "") != 0)
+                        return FALSE;
+                    break;
+
+                default:
+                    return FALSE;
+            }
+            memset(mask, 0xff, len);
+            return TRUE;
+
+        case NDN_DU_MASK:
+            if (asn_get_length(du_val, "v") != (int)len ||
+                asn_get_length(du_val, "m") != (int)len)
+                return FALSE;
+
+            val_len = len;
+            if (asn_read_value_field(du_val, value, &val_len, "v") != 0)
+                return FALSE;
+            val_len = len;
+            if (asn_read_value_field(du_val, mask, &val_len, "m") != 0)
+                return FALSE;
+            return TRUE;
+
+        default:
+            return FALSE;
+    }
+}
@@ -129,6 +129,10 @@ extern void tad_payload_spec_clear(tad_payload_spec_t *pld_spec);
  * Parse textual presentation of expression. Syntax is Perl-like, references
  * to template arguments noted as $1, $2, etc.
  *
+ * Parsed expression is compiled to flat code of a stack machine with
+ * constant subexpressions folded, so tad_int_expr_calculate() does
+ * not walk the tree.
+ *
  * @param string        Text with expression.
  * @param expr          Place where pointer to new expression will
  *                      be put (OUT).
@@ -466,6 +470,28 @@ extern te_errno tad_du_realloc(tad_data_unit_t *du, size_t size);
  */
 extern tad_cksum_str_code tad_du_get_cksum_str_code(tad_data_unit_t *du);
 
+/**
+ * Get value and mask of the DATA-UNIT field to match it as a fixed
+ * binary field. Only plain values and masks are supported.
+ *
+ * @param pdu           PDU of the pattern unit or @c NULL
+ * @param csap_pdu      CSAP layer specification or @c NULL
+ * @param tag           Tag of the field in the PDU
+ * @param rx_def_tag    Tag of the field in the CSAP layer specification
+ *                      with receive default or @c ASN_TAG_INVALID
+ * @param value         Location for value in network byte order
+ * @param mask          Location for mask
+ * @param len           Length of the field in octets
+ *
+ * @return Is there a value which may be matched?
+ */
+extern te_bool tad_du_get_value_mask(const asn_value *pdu,
+                                     const asn_value *csap_pdu,
+                                     asn_tag_value tag,
+                                     asn_tag_value rx_def_tag,
+                                     uint8_t *value, uint8_t *mask,
+                                     size_t len);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,199 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD checksum benchmark
+ *
+ * Benchmark of Internet checksum and masked comparison of jumbo
+ * frames split into segments the way TAD builds packets (headers
+ * and payload in separate segments, odd segment lengths included).
+ *
+ * Per-byte scalar code (ip_csum_part() and byte loop comparison) is
+ * measured as a reference, then tad_pkt_csum_part() and
+ * tad_pkt_match_mask() with every SIMD instruction set extension
+ * supported by the host. Time per frame and throughput are reported.
+ *
+ * Usage: csum_bench [<number of frames>]
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_simd.h"
+#include "tad_common.h"
+#include "tad_pkt.h"
+
+/** Default number of frames */
+#define BENCH_FRAMES    200000
+
+/** Length of a jumbo frame (9000 bytes MTU) */
+#define BENCH_FRAME_LEN 9014
+
+/** Lengths of segments of the frame: Ethernet, IPv4, UDP, payload */
+static const size_t bench_segs[] = { 14, 20, 8, 8971, 1 };
+
+/** Names of instruction set extensions */
+static const char *bench_levels[] = {
+    [TE_SIMD_SCALAR] = "scalar",
+    [TE_SIMD_SSE42] = "sse4.2",
+    [TE_SIMD_AVX2] = "avx2",
+};
+
+static uint8_t bench_data[BENCH_FRAME_LEN];
+static uint8_t bench_mask[BENCH_FRAME_LEN];
+static uint8_t bench_value[BENCH_FRAME_LEN];
+
+/** Result to be used to prevent calculations elimination */
+static volatile unsigned int bench_sink;
+
+/**
+ * Get time difference in nanoseconds.
+ *
+ * @param start     Start time
+ * @param end       End time
+ *
+ * @return Difference in nanoseconds.
+ */
+static double
+bench_ns(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 +
+           (end->tv_nsec - start->tv_nsec);
+}
+
+/**
+ * Report time per frame.
+ *
+ * @param label     Label of the measurement
+ * @param frames    Number of frames
+ * @param ns        Total time in nanoseconds
+ */
+static void
+bench_report(const char *label, unsigned int frames, double ns)
+{
+    printf("%-20s %8.0f ns/frame %7.2f GB/s\n", label, ns / frames,
+           (double)BENCH_FRAME_LEN * frames / ns);
+}
+
+/**
+ * Measure per-byte scalar code on contiguous frame.
+ *
+ * @param frames    Number of frames
+ */
+static void
+bench_ref(unsigned int frames)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned int    i;
+    size_t          j;
+    unsigned int    sum = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < frames; i++)
+        sum += ip_csum_part(i, bench_data, BENCH_FRAME_LEN);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    bench_report("csum ip_csum_part", frames, bench_ns(&start, &end));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < frames; i++)
+    {
+        for (j = 0; j < BENCH_FRAME_LEN; j++)
+        {
+            if (((bench_data[j] ^ bench_value[j]) & bench_mask[j]) != 0)
+                break;
+        }
+        sum += j;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    bench_report("match byte loop", frames, bench_ns(&start, &end));
+
+    bench_sink = sum;
+}
+
+/**
+ * Measure TAD packet functions with current SIMD kernels.
+ *
+ * @param pkt       Frame
+ * @param frames    Number of frames
+ */
+static void
+bench_pkt(const tad_pkt *pkt, unsigned int frames)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned int    i;
+    unsigned int    sum = 0;
+    char            label[32];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < frames; i++)
+        sum += tad_pkt_csum_part(pkt, i);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    snprintf(label, sizeof(label), "csum %s",
+             bench_levels[te_simd_get_level()]);
+    bench_report(label, frames, bench_ns(&start, &end));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < frames; i++)
+        sum += tad_pkt_match_mask(pkt, BENCH_FRAME_LEN, bench_mask,
+                                  bench_value, TRUE);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    snprintf(label, sizeof(label), "match %s",
+             bench_levels[te_simd_get_level()]);
+    bench_report(label, frames, bench_ns(&start, &end));
+
+    bench_sink = sum;
+}
+
+int
+main(int argc, char *argv[])
+{
+    unsigned int    frames;
+    tad_pkt        *pkt;
+    tad_pkt_seg    *seg;
+    uint8_t        *data = bench_data;
+    unsigned int    i;
+    te_simd_level   level;
+    te_simd_level   supported = te_simd_level_supported();
+
+    frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : BENCH_FRAMES;
+    frames = MAX(frames, 1);
+
+    for (i = 0; i < BENCH_FRAME_LEN; i++)
+    {
+        bench_data[i] = bench_value[i] = rand();
+        bench_mask[i] = rand();
+    }
+
+    pkt = tad_pkt_alloc(0, 0);
+    for (i = 0; pkt != NULL && i < TE_ARRAY_LEN(bench_segs); i++)
+    {
+        seg = tad_pkt_alloc_seg(data, bench_segs[i], NULL);
+        if (seg == NULL)
+            break;
+        tad_pkt_append_seg(pkt, seg);
+        data += bench_segs[i];
+    }
+    if (pkt == NULL || tad_pkt_len(pkt) != BENCH_FRAME_LEN)
+    {
+        fprintf(stderr, "Failed to allocate frame\n");
+        return EXIT_FAILURE;
+    }
+
+    bench_ref(frames);
+    for (level = TE_SIMD_SCALAR; level <= supported; level++)
+    {
+        te_simd_set_level(level);
+        bench_pkt(pkt, frames);
+    }
+
+    tad_pkt_free(pkt);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD integer expressions benchmark
+ *
+ * Micro-benchmark of evaluation of TAD integer expressions.
+ *
+ * Each expression is parsed with tad_int_expr_parse() and evaluated
+ * over iterated template arguments using compiled code and walking
+ * the tree (with the code detached from the parsed expression).
+ * Results of both are checked to be equal, time per evaluation is
+ * reported.
+ *
+ * Usage: int_expr_bench [<number of evaluations> [<expression>...]]
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Bench"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "tad_types.h"
+#include "tad_utils.h"
+
+/** Default number of evaluations of each expression */
+#define BENCH_EVALS     10000000
+
+/** Number of template arguments */
+#define BENCH_ARGS      2
+
+/** Default expressions */
+static const char *bench_exprs[] = {
+    "$0",
+    "($0 + 1)",
+    "(($0 * 4) + (1 + 2))",
+    "((($0 + $1) * ((2 * 3) + 1)) - (-(10 % 3)))",
+    "(((($0 * 2) + ($1 / 3)) - ((100 - 1) * (4 + 4))) % 65536)",
+};
+
+/**
+ * Evaluate expression and report time per evaluation.
+ *
+ * @param label     Label of the evaluation method
+ * @param expr      Expression
+ * @param evals     Number of evaluations
+ * @param sum       Location for sum of results
+ *
+ * @return Status code.
+ */
+static te_errno
+bench_eval(const char *label, const tad_int_expr_t *expr,
+           unsigned int evals, int64_t *sum)
+{
+    tad_tmpl_arg_t  args[BENCH_ARGS];
+    struct timespec start;
+    struct timespec end;
+    int64_t         result;
+    unsigned int    i;
+    int             rc;
+
+    args[0].type = args[1].type = TAD_TMPL_ARG_INT;
+    args[1].arg_int = 7;
+
+    *sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < evals; i++)
+    {
+        /* Arithmetic progression as tad_iterate_tmpl_args() does */
+        args[0].arg_int = i;
+        rc = tad_int_expr_calculate(expr, args, BENCH_ARGS, &result);
+        if (rc != 0)
+            return rc;
+        *sum += result;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("  %-8s %6.2f ns/eval\n", label,
+           ((end.tv_sec - start.tv_sec) * 1e9 +
+            (end.tv_nsec - start.tv_nsec)) / evals);
+
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char        **exprs = bench_exprs;
+    unsigned int        n_exprs = TE_ARRAY_LEN(bench_exprs);
+    unsigned int        evals;
+    tad_int_expr_t     *expr;
+    tad_int_expr_code  *code;
+    int64_t             sum_code;
+    int64_t             sum_tree;
+    unsigned int        i;
+    int                 syms;
+    int                 rc;
+    int                 result = EXIT_SUCCESS;
+
+    evals = (argc > 1) ? strtoul(argv[1], NULL, 0) : BENCH_EVALS;
+    if (argc > 2)
+    {
+        exprs = (const char **)argv + 2;
+        n_exprs = argc - 2;
+    }
+
+    for (i = 0; i < n_exprs; i++)
+    {
+        rc = tad_int_expr_parse(exprs[i], &expr, &syms);
+        if (rc != 0)
+        {
+            fprintf(stderr, "Failed to parse '%s' at %d: %s\n",
+                    exprs[i], syms, te_rc_err2str(rc));
+            return EXIT_FAILURE;
+        }
+
+        code = expr->code;
+        printf("%s: %u instructions\n", exprs[i],
+               code == NULL ? 0 : code->n_insns);
+
+        rc = bench_eval("code:", expr, evals, &sum_code);
+        if (rc == 0)
+        {
+            expr->code = NULL;
+            rc = bench_eval("tree:", expr, evals, &sum_tree);
+            expr->code = code;
+        }
+        tad_int_expr_free(expr);
+
+        if (rc != 0)
+        {
+            fprintf(stderr, "Failed to evaluate '%s': %s\n",
+                    exprs[i], te_rc_err2str(rc));
+            return EXIT_FAILURE;
+        }
+        if (sum_code != sum_tree)
+        {
+            fprintf(stderr, "Results of '%s' differ\n", exprs[i]);
+            result = EXIT_FAILURE;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,372 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/**
+ * Test for compiler of traffic patterns to in-kernel filters.
+ *
+ * Compile patterns of Ethernet-based CSAPs and run the programs on
+ * frames using simple classic BPF interpreter.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+#include "asn_usr.h"
+#include "ndn.h"
+#include "ndn_eth.h"
+#include "ndn_ipstack.h"
+
+#include "tad_csap_inst.h"
+#include "tad_eth_bpf.h"
+
+/** Frame being filtered */
+typedef struct test_frame {
+    uint8_t         data[128];  /**< Frame data */
+    unsigned int    len;        /**< Frame length */
+    unsigned int    pkttype;    /**< Packet type */
+    int             vlan;       /**< VLAN TCI extracted by the kernel
+                                     or @c -1 */
+} test_frame;
+
+int result = 0;
+
+/**
+ * Run classic BPF program on the frame.
+ *
+ * @param prog      Program
+ * @param frame     Frame
+ *
+ * @return Value returned by the program.
+ */
+static uint32_t
+test_bpf_run(const struct sock_fprog *prog, const test_frame *frame)
+{
+    const struct sock_filter   *insn;
+    unsigned int                pc = 0;
+    uint32_t                    a = 0;
+    uint32_t                    x = 0;
+    uint32_t                    off;
+    unsigned int                size;
+    unsigned int                i;
+
+    while (pc < prog->len)
+    {
+        insn = prog->filter + pc++;
+        switch (BPF_CLASS(insn->code))
+        {
+            case BPF_LD:
+            case BPF_LDX:
+                if (BPF_MODE(insn->code) == BPF_LEN)
+                {
+                    a = frame->len;
+                    break;
+                }
+                if (BPF_MODE(insn->code) == BPF_ABS &&
+                    insn->k >= (uint32_t)SKF_AD_OFF)
+                {
+                    switch (insn->k - SKF_AD_OFF)
+                    {
+                        case SKF_AD_PKTTYPE:
+                            a = frame->pkttype;
+                            break;
+                        case SKF_AD_VLAN_TAG:
+                            a = frame->vlan & 0xefff;
+                            break;
+                        case SKF_AD_VLAN_TAG_PRESENT:
+                            a = (frame->vlan >= 0);
+                            break;
+                        default:
+                            return 0;
+                    }
+                    break;
+                }
+
+                off = insn->k;
+                if (BPF_MODE(insn->code) == BPF_IND)
+                    off += x;
+                size = (BPF_SIZE(insn->code) == BPF_W) ? 4 :
+                       (BPF_SIZE(insn->code) == BPF_H) ? 2 : 1;
+                if (off + size > frame->len)
+                    return 0;
+                if (BPF_MODE(insn->code) == BPF_MSH)
+                {
+                    x = (frame->data[off] & 0xf) << 2;
+                    break;
+                }
+                for (a = 0, i = 0; i < size; ++i)
+                    a = (a << 8) | frame->data[off + i];
+                break;
+
+            case BPF_ALU:
+                if (BPF_OP(insn->code) != BPF_AND)
+                    return 0;
+                a &= insn->k;
+                break;
+
+            case BPF_JMP:
+                switch (BPF_OP(insn->code))
+                {
+                    case BPF_JEQ:
+                        pc += (a == insn->k) ? insn->jt : insn->jf;
+                        break;
+                    case BPF_JGE:
+                        pc += (a >= insn->k) ? insn->jt : insn->jf;
+                        break;
+                    case BPF_JSET:
+                        pc += (a & insn->k) ? insn->jt : insn->jf;
+                        break;
+                    default:
+                        return 0;
+                }
+                break;
+
+            case BPF_RET:
+                return insn->k;
+
+            default:
+                return 0;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Make Ethernet frame with IPv4 and UDP headers.
+ *
+ * @param frame     Frame to fill in
+ * @param dst_port  UDP destination port
+ * @param frag_off  IPv4 fragment offset
+ */
+static void
+test_frame_udp4(test_frame *frame, uint16_t dst_port, uint16_t frag_off)
+{
+    static const uint8_t hdrs[] = {
+        /* Ethernet */
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+        0x00, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+        0x08, 0x00,
+        /* IPv4 */
+        0x45, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00,
+        0x40, 0x11, 0x00, 0x00,
+        0x0a, 0x00, 0x00, 0x02,
+        0x0a, 0x00, 0x00, 0x01,
+        /* UDP */
+        0x04, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+        /* Payload */
+        0xde, 0xad, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04,
+    };
+
+    memset(frame, 0, sizeof(*frame));
+    memcpy(frame->data, hdrs, sizeof(hdrs));
+    frame->data[20] = frag_off >> 8;
+    frame->data[21] = frag_off & 0xff;
+    frame->data[36] = dst_port >> 8;
+    frame->data[37] = dst_port & 0xff;
+    frame->len = 60;
+    frame->pkttype = PACKET_HOST;
+    frame->vlan = -1;
+}
+
+/**
+ * Compile the pattern for the CSAP and check the program on frames.
+ *
+ * @param protos    Protocols of the CSAP from the upper one
+ * @param csap_spec CSAP layers specifications from the upper one
+ * @param depth     Number of CSAP layers
+ * @param ptrn_str  Traffic pattern
+ * @param mode      Receive mode
+ * @param pld       Payload specification of the first pattern unit
+ * @param frames    Frames to check
+ * @param expected  Expected results (@c TRUE if frame is accepted)
+ * @param n_frames  Number of frames
+ */
+static void
+test_eth_bpf(const te_tad_protocols_t *protos, const char **csap_spec,
+             unsigned int depth, const char *ptrn_str, unsigned int mode,
+             const tad_payload_spec_t *pld, const test_frame *frames,
+             const te_bool *expected, unsigned int n_frames)
+{
+    static const asn_type * const *csap_types[] = {
+        [TE_PROTO_ETH] = &ndn_eth_csap,
+        [TE_PROTO_IP4] = &ndn_ip4_csap,
+        [TE_PROTO_UDP] = &ndn_udp_csap,
+    };
+    struct csap_instance    csap;
+    csap_layer_t            layers[depth];
+    tad_recv_ptrn_unit_data units[4];
+    struct sock_fprog       prog;
+    asn_value              *pattern;
+    unsigned int            i;
+    int                     syms;
+    te_errno                rc;
+
+    memset(&csap, 0, sizeof(csap));
+    memset(layers, 0, sizeof(layers));
+    memset(units, 0, sizeof(units));
+
+    for (i = 0; i < depth; ++i)
+    {
+        layers[i].proto_tag = protos[i];
+        if (csap_spec[i] != NULL &&
+            asn_parse_value_text(csap_spec[i], *csap_types[protos[i]],
+                                 &layers[i].nds, &syms) != 0)
+        {
+            printf("failed to parse CSAP spec '%s'\n", csap_spec[i]);
+            result = 1;
+            return;
+        }
+    }
+    csap.depth = depth;
+    csap.layers = layers;
+    csap.state = CSAP_STATE_RECV;
+
+    rc = asn_parse_value_text(ptrn_str, ndn_traffic_pattern, &pattern,
+                              &syms);
+    if (rc != 0)
+    {
+        printf("failed to parse pattern '%s': %x at %d\n", ptrn_str,
+               rc, syms);
+        result = 1;
+        return;
+    }
+    csap.receiver.ptrn_data.nds = pattern;
+    csap.receiver.ptrn_data.n_units = asn_get_length(pattern, "");
+    csap.receiver.ptrn_data.units = units;
+    for (i = 0; i < csap.receiver.ptrn_data.n_units; ++i)
+        asn_get_indexed(pattern, &units[i].nds, i, NULL);
+    if (pld != NULL)
+        units[0].pld_spec = *pld;
+
+    rc = tad_eth_bpf_compile(&csap, mode, &prog);
+    if (rc != 0)
+    {
+        printf("pattern '%s': compile failed: %x\n", ptrn_str, rc);
+        result = 1;
+        return;
+    }
+
+    for (i = 0; i < n_frames; ++i)
+    {
+        te_bool accepted = (test_bpf_run(&prog, frames + i) != 0);
+
+        if (accepted != expected[i])
+        {
+            printf("pattern '%s': frame %u is %s\n", ptrn_str, i,
+                   accepted ? "accepted" : "rejected");
+            result = 1;
+        }
+    }
+    printf("pattern '%s': %u instructions\n", ptrn_str, prog.len);
+
+    free(prog.filter);
+    asn_free_value(pattern);
+    for (i = 0; i < depth; ++i)
+        asn_free_value(layers[i].nds);
+}
+
+int
+main(void)
+{
+    static const te_tad_protocols_t udp4[] = {
+        TE_PROTO_UDP, TE_PROTO_IP4, TE_PROTO_ETH
+    };
+    static const te_tad_protocols_t eth[] = { TE_PROTO_ETH };
+    static uint8_t pld_value[] = { 0x45 };
+    static uint8_t pld_mask[] = { 0xf0 };
+    const char     *udp4_spec[] = {
+        NULL, "{ local-addr plain:'0a 00 00 01'H }", NULL
+    };
+    const char     *eth_spec[] = { NULL };
+    tad_payload_spec_t pld;
+    test_frame      frames[8];
+    te_bool         expected[8];
+
+    /* Port in pattern, address in CSAP specification */
+    test_frame_udp4(&frames[0], 5000, 0);
+    expected[0] = TRUE;
+    test_frame_udp4(&frames[1], 5001, 0);
+    expected[1] = FALSE;
+    test_frame_udp4(&frames[2], 5000, 0);
+    frames[2].data[33] = 3;
+    expected[2] = FALSE;
+    /* Non-first fragment is matched in user space */
+    test_frame_udp4(&frames[3], 5001, 0x10);
+    expected[3] = TRUE;
+    /* In-line VLAN tag is matched in user space */
+    test_frame_udp4(&frames[4], 5001, 0);
+    frames[4].data[12] = 0x81;
+    expected[4] = TRUE;
+    /* Not IPv4 */
+    test_frame_udp4(&frames[5], 5000, 0);
+    frames[5].data[13] = 0x06;
+    expected[5] = FALSE;
+    /* IPv4 options */
+    test_frame_udp4(&frames[6], 5001, 0);
+    frames[6].data[14] = 0x46;
+    frames[6].data[40] = 5000 >> 8;
+    frames[6].data[41] = 5000 & 0xff;
+    expected[6] = TRUE;
+    /* Packet type */
+    test_frame_udp4(&frames[7], 5000, 0);
+    frames[7].pkttype = PACKET_OTHERHOST;
+    expected[7] = FALSE;
+
+    test_eth_bpf(udp4, udp4_spec, 3,
+                 "{ { pdus { udp:{ dst-port plain:5000 }, ip4:{ }, "
+                 "eth:{ } } } }", TAD_ETH_RECV_HOST, NULL,
+                 frames, expected, 8);
+
+    /* Several units */
+    expected[0] = TRUE;
+    expected[1] = TRUE;
+    expected[7] = TRUE;
+    test_eth_bpf(udp4, udp4_spec, 3,
+                 "{ { pdus { udp:{ dst-port plain:5000 }, ip4:{ }, "
+                 "eth:{ } } }, "
+                 "{ pdus { udp:{ dst-port plain:5001 }, ip4:{ }, "
+                 "eth:{ } } } }", TAD_ETH_RECV_DEF, NULL,
+                 frames, expected, 8);
+
+    /* Ethernet addresses, VLAN tag and payload mask */
+    test_frame_udp4(&frames[0], 5000, 0);
+    frames[0].vlan = 10;
+    expected[0] = TRUE;
+    test_frame_udp4(&frames[1], 5000, 0);
+    frames[1].vlan = 11;
+    expected[1] = FALSE;
+    test_frame_udp4(&frames[2], 5000, 0);
+    expected[2] = FALSE;
+    test_frame_udp4(&frames[3], 5000, 0);
+    frames[3].vlan = 10;
+    frames[3].data[14] = 0x46;
+    expected[3] = TRUE;
+    test_frame_udp4(&frames[4], 5000, 0);
+    frames[4].vlan = 10;
+    frames[4].data[14] = 0x65;
+    expected[4] = FALSE;
+    test_frame_udp4(&frames[5], 5000, 0);
+    frames[5].vlan = 10;
+    frames[5].data[0] = 0x01;
+    expected[5] = FALSE;
+
+    memset(&pld, 0, sizeof(pld));
+    pld.type = TAD_PLD_MASK;
+    pld.mask.length = sizeof(pld_value);
+    pld.mask.value = pld_value;
+    pld.mask.mask = pld_mask;
+    test_eth_bpf(eth, eth_spec, 1,
+                 "{ { pdus { eth:{ dst-addr plain:'00 01 02 03 04 05'H, "
+                 "tagged tagged:{ vlan-id plain:10 } } } } }",
+                 TAD_ETH_RECV_ALL, &pld, frames, expected, 6);
+
+    return result;
+}
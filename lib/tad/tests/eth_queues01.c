@@ -0,0 +1,166 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/**
+ * Test for receive queues of Ethernet CSAP.
+ *
+ * Open additional receive queues of Ethernet CSAP on the loopback
+ * interface and check that the CSAP keeps receiving by the first queue
+ * (receive is done by one thread) if opening of queues fails, in
+ * particular that the data of packets read from its Rx ring are still
+ * treated as borrowed from the ring.
+ *
+ * The test requires CAP_NET_RAW and is skipped without it.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "tad_csap_inst.h"
+#include "tad_eth_sap.h"
+#include "tad_eth_impl.h"
+
+/** Number of receive queues to open */
+#define TEST_QUEUES     3
+
+int result = 0;
+
+/**
+ * Check number of receive queues which borrow packet data.
+ *
+ * @param csap      CSAP instance
+ * @param expected  Expected number
+ * @param what      Description of the check
+ */
+static void
+test_check_borrowed(csap_p csap, unsigned int expected, const char *what)
+{
+    unsigned int borrowed = csap->layers[csap_get_rw_layer(csap)].
+                                rw_borrowed_pkt_data;
+
+    if (borrowed != expected)
+    {
+        printf("%s: %u queues borrow packet data instead of %u\n",
+               what, borrowed, expected);
+        result = 1;
+    }
+}
+
+int
+main(void)
+{
+    struct csap_instance    csap;
+    csap_layer_t            layer;
+    tad_eth_rw_data         spec_data;
+    struct rlimit           rlim;
+    struct rlimit           rlim_saved;
+    unsigned int            rings;
+    int                     fd;
+    te_errno                rc;
+
+    memset(&csap, 0, sizeof(csap));
+    memset(&layer, 0, sizeof(layer));
+    memset(&spec_data, 0, sizeof(spec_data));
+
+    layer.proto_tag = TE_PROTO_ETH;
+    csap.id = 1;
+    csap.depth = 1;
+    csap.layers = &layer;
+    csap.rw_layer = 0;
+    csap.rw_data = &spec_data;
+    csap.state = CSAP_STATE_RECV;
+    spec_data.recv_mode = TAD_ETH_RECV_ALL;
+
+    rc = tad_eth_sap_attach("lo", &spec_data.sap);
+    if (rc != 0)
+    {
+        printf("failed to attach to loopback: %x\n", rc);
+        return 1;
+    }
+    spec_data.sap.csap = &csap;
+
+    rc = tad_eth_prepare_recv(&csap);
+    if (rc != 0)
+    {
+        printf("test is skipped, failed to open receive socket: %x\n", rc);
+        (void)tad_eth_sap_detach(&spec_data.sap);
+        return 0;
+    }
+    /* The first queue uses Rx ring if it is supported */
+    rings = layer.rw_borrowed_pkt_data;
+
+    /* All queues are opened */
+    rc = tad_eth_prepare_recv_queues(&csap, TEST_QUEUES,
+                                     TAD_RECV_FANOUT_HASH);
+    if (rc != 0)
+    {
+        printf("failed to open %u receive queues: %x\n", TEST_QUEUES, rc);
+        result = 1;
+    }
+    else
+    {
+        test_check_borrowed(&csap, rings * TEST_QUEUES, "queues opened");
+    }
+    (void)tad_eth_shutdown_recv(&csap);
+    test_check_borrowed(&csap, 0, "receive shut down");
+
+    /*
+     * Opening of the second additional queue fails since only one file
+     * descriptor is available, so the first one is closed and receive
+     * falls back to the first queue.
+     */
+    rc = tad_eth_prepare_recv(&csap);
+    if (rc != 0)
+    {
+        printf("failed to reopen receive socket: %x\n", rc);
+        result = 1;
+        goto detach;
+    }
+
+    fd = dup(0);
+    if (fd < 0 || getrlimit(RLIMIT_NOFILE, &rlim_saved) != 0)
+    {
+        perror("failed to get the limit of open files");
+        result = 1;
+        goto shutdown;
+    }
+    close(fd);
+    rlim = rlim_saved;
+    rlim.rlim_cur = fd + 1;
+    if (setrlimit(RLIMIT_NOFILE, &rlim) != 0)
+    {
+        perror("failed to set the limit of open files");
+        result = 1;
+        goto shutdown;
+    }
+
+    rc = tad_eth_prepare_recv_queues(&csap, TEST_QUEUES,
+                                     TAD_RECV_FANOUT_HASH);
+    (void)setrlimit(RLIMIT_NOFILE, &rlim_saved);
+    if (rc == 0)
+    {
+        printf("receive queues are opened despite the limit\n");
+        result = 1;
+    }
+    else if (spec_data.n_queues != 0)
+    {
+        printf("%u receive queues are left after failure\n",
+               spec_data.n_queues);
+        result = 1;
+    }
+    test_check_borrowed(&csap, rings, "fallback to the first queue");
+
+shutdown:
+    (void)tad_eth_shutdown_recv(&csap);
+    test_check_borrowed(&csap, 0, "receive shut down after fallback");
+
+detach:
+    (void)tad_eth_sap_detach(&spec_data.sap);
+
+    return result;
+}
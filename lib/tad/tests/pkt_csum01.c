@@ -0,0 +1,173 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD packets checksum and matching test
+ *
+ * Random data are split into random segments (including empty and
+ * odd-length ones) and Internet checksum and masked comparison of
+ * the packet are checked against scalar code over contiguous data
+ * with every SIMD instruction set extension supported by the host.
+ *
+ * Usage: pkt_csum01 [<number of iterations>]
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_simd.h"
+#include "tad_common.h"
+#include "tad_pkt.h"
+
+/** Default number of iterations */
+#define TEST_ITERS      10000
+
+/** Maximum length of data (jumbo frame) */
+#define TEST_MAX_LEN    9018
+
+/** Maximum number of segments */
+#define TEST_MAX_SEGS   8
+
+/**
+ * Create packet with segments referring to the data.
+ *
+ * @param data      Data
+ * @param len       Length of the data
+ *
+ * @return Packet or @c NULL.
+ */
+static tad_pkt *
+test_pkt(uint8_t *data, size_t len)
+{
+    tad_pkt        *pkt = tad_pkt_alloc(0, 0);
+    tad_pkt_seg    *seg;
+    unsigned int    n_segs = 1 + rand() % TEST_MAX_SEGS;
+    size_t          seg_len;
+
+    for (; pkt != NULL && n_segs > 0; n_segs--)
+    {
+        seg_len = (n_segs == 1) ? len : (size_t)rand() % (len + 1);
+        seg = tad_pkt_alloc_seg(data, seg_len, NULL);
+        if (seg == NULL)
+        {
+            tad_pkt_free(pkt);
+            return NULL;
+        }
+        tad_pkt_append_seg(pkt, seg);
+        data += seg_len;
+        len -= seg_len;
+    }
+
+    return pkt;
+}
+
+/**
+ * Compare data by mask byte by byte.
+ */
+static te_bool
+test_match_mask(const uint8_t *data, const uint8_t *mask,
+                const uint8_t *value, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((data[i] & mask[i]) != (value[i] & mask[i]))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static uint8_t  data[TEST_MAX_LEN];
+    static uint8_t  mask[TEST_MAX_LEN];
+    static uint8_t  value[TEST_MAX_LEN];
+    unsigned int    iters;
+    unsigned int    i;
+    size_t          j;
+    te_simd_level   supported = te_simd_level_supported();
+    te_simd_level   level;
+
+    iters = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_ITERS;
+    srand(1);
+
+    for (level = TE_SIMD_SCALAR; level <= supported; level++)
+    {
+        if (te_simd_set_level(level) != level)
+        {
+            fprintf(stderr, "Failed to set SIMD level %d\n", level);
+            return EXIT_FAILURE;
+        }
+
+        for (i = 0; i < iters; i++)
+        {
+            size_t      len = rand() % (TEST_MAX_LEN + 1);
+            uint32_t    start = rand() % 0x10000;
+            tad_pkt    *pkt;
+            uint16_t    exp;
+            uint16_t    got;
+            te_bool     exp_match;
+            te_bool     got_match;
+
+            for (j = 0; j < len; j++)
+            {
+                data[j] = value[j] = rand();
+                mask[j] = rand();
+            }
+            if (len > 0 && (rand() & 1))
+                value[rand() % len] ^= 1 << (rand() % 8);
+
+            pkt = test_pkt(data, len);
+            if (pkt == NULL)
+            {
+                fprintf(stderr, "Failed to allocate packet\n");
+                return EXIT_FAILURE;
+            }
+
+            exp = ip_csum_part(start, data, len);
+            got = tad_pkt_csum_part(pkt, start);
+            if (got != exp)
+            {
+                fprintf(stderr, "Level %d: checksum of %zu bytes in %u "
+                        "segments is 0x%04x instead of 0x%04x\n", level,
+                        len, tad_pkt_seg_num(pkt), got, exp);
+                return EXIT_FAILURE;
+            }
+
+            exp_match = test_match_mask(data, mask, value, len);
+            got_match = (tad_pkt_match_mask(pkt, len, mask, value,
+                                            TRUE) == 0);
+            if (got_match != exp_match)
+            {
+                fprintf(stderr, "Level %d: masked comparison of %zu bytes "
+                        "in %u segments is wrong\n", level, len,
+                        tad_pkt_seg_num(pkt));
+                return EXIT_FAILURE;
+            }
+
+            exp_match = (memcmp(data, value, len) == 0);
+            got_match = (tad_pkt_match_bytes(pkt, len, value, TRUE) == 0);
+            if (got_match != exp_match)
+            {
+                fprintf(stderr, "Level %d: comparison of %zu bytes "
+                        "in %u segments is wrong\n", level, len,
+                        tad_pkt_seg_num(pkt));
+                return EXIT_FAILURE;
+            }
+
+            tad_pkt_free(pkt);
+        }
+
+        printf("Level %d: %u packets OK\n", level, iters);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,318 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/**
+ * Test for dispatch index of traffic pattern units.
+ *
+ * Build indices of patterns of Ethernet-based CSAPs and check that
+ * lookup of frames returns units which may match them in order of
+ * the pattern.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asn_usr.h"
+#include "ndn.h"
+#include "ndn_eth.h"
+#include "ndn_ipstack.h"
+
+#include "tad_csap_inst.h"
+#include "tad_pkt.h"
+#include "tad_recv_index.h"
+
+/** Maximum number of pattern units in the test */
+#define TEST_UNITS_MAX  8
+
+/** Frame being looked up */
+typedef struct test_frame {
+    uint8_t         data[128];  /**< Frame data */
+    unsigned int    len;        /**< Frame length */
+    int             units[TEST_UNITS_MAX + 1]; /**< Expected units
+                                                    terminated by @c -1
+                                                    or @c -2 if all
+                                                    units are tried */
+} test_frame;
+
+int result = 0;
+
+/**
+ * Make Ethernet frame with IPv4 and UDP headers.
+ *
+ * @param frame     Frame to fill in
+ * @param dst_port  UDP destination port
+ * @param frag_off  IPv4 fragment offset
+ */
+static void
+test_frame_udp4(test_frame *frame, uint16_t dst_port, uint16_t frag_off)
+{
+    static const uint8_t hdrs[] = {
+        /* Ethernet */
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+        0x00, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+        0x08, 0x00,
+        /* IPv4 */
+        0x45, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00,
+        0x40, 0x11, 0x00, 0x00,
+        0x0a, 0x00, 0x00, 0x02,
+        0x0a, 0x00, 0x00, 0x01,
+        /* UDP */
+        0x04, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+        /* Payload */
+        0xde, 0xad, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04,
+    };
+
+    memset(frame, 0, sizeof(*frame));
+    memcpy(frame->data, hdrs, sizeof(hdrs));
+    frame->data[20] = frag_off >> 8;
+    frame->data[21] = frag_off & 0xff;
+    frame->data[36] = dst_port >> 8;
+    frame->data[37] = dst_port & 0xff;
+    frame->len = 60;
+}
+
+/**
+ * Insert 802.1Q tag into the frame.
+ *
+ * @param frame     Frame
+ * @param vid       VLAN ID
+ */
+static void
+test_frame_vlan(test_frame *frame, uint16_t vid)
+{
+    memmove(frame->data + 16, frame->data + 12, frame->len - 12);
+    frame->data[12] = 0x81;
+    frame->data[13] = 0x00;
+    frame->data[14] = vid >> 8;
+    frame->data[15] = vid & 0xff;
+    frame->len += 4;
+}
+
+/**
+ * Set expected units of the frame.
+ *
+ * @param frame     Frame
+ * @param units     Units terminated by @c -1 or @c -2 for all units
+ */
+static void
+test_frame_units(test_frame *frame, const int *units)
+{
+    unsigned int i = 0;
+
+    do {
+        frame->units[i] = units[i];
+    } while (units[i++] >= 0);
+}
+
+/**
+ * Build the index for the CSAP and check lookup of frames.
+ *
+ * @param protos    Protocols of the CSAP from the upper one
+ * @param depth     Number of CSAP layers
+ * @param mismatch  Does the CSAP report mismatch packets?
+ * @param ptrn_str  Traffic pattern
+ * @param frames    Frames to check or @c NULL if the index must not
+ *                  be built
+ * @param n_frames  Number of frames
+ */
+static void
+test_recv_index(const te_tad_protocols_t *protos, unsigned int depth,
+                te_bool mismatch, const char *ptrn_str, const test_frame *frames,
+                unsigned int n_frames)
+{
+    struct csap_instance    csap;
+    csap_layer_t            layers[depth];
+    tad_recv_ptrn_unit_data units[TEST_UNITS_MAX];
+    tad_recv_pattern_data   ptrn_data;
+    tad_recv_index         *index;
+    asn_value              *pattern;
+    tad_pkt                *pkt;
+    const unsigned int     *found;
+    unsigned int            n_found;
+    unsigned int            i;
+    unsigned int            j;
+    int                     syms;
+    te_errno                rc;
+
+    memset(&csap, 0, sizeof(csap));
+    memset(layers, 0, sizeof(layers));
+    memset(units, 0, sizeof(units));
+    memset(&ptrn_data, 0, sizeof(ptrn_data));
+
+    for (i = 0; i < depth; ++i)
+        layers[i].proto_tag = protos[i];
+    csap.depth = depth;
+    csap.layers = layers;
+    csap.state = CSAP_STATE_RECV;
+    if (mismatch)
+        csap.state |= CSAP_STATE_RECV_MISMATCH;
+
+    rc = asn_parse_value_text(ptrn_str, ndn_traffic_pattern, &pattern,
+                              &syms);
+    if (rc != 0)
+    {
+        printf("failed to parse pattern '%s': %x at %d\n", ptrn_str,
+               rc, syms);
+        result = 1;
+        return;
+    }
+    ptrn_data.nds = pattern;
+    ptrn_data.n_units = asn_get_length(pattern, "");
+    ptrn_data.units = units;
+    for (i = 0; i < ptrn_data.n_units; ++i)
+        asn_get_indexed(pattern, &units[i].nds, i, NULL);
+
+    rc = tad_recv_index_build(&csap, &ptrn_data, &index);
+    if (frames == NULL)
+    {
+        if (TE_RC_GET_ERROR(rc) != TE_ENOENT)
+        {
+            printf("pattern '%s': index is built unexpectedly: %x\n",
+                   ptrn_str, rc);
+            result = 1;
+        }
+        tad_recv_index_free(index);
+        asn_free_value(pattern);
+        return;
+    }
+    if (rc != 0)
+    {
+        printf("pattern '%s': build failed: %x\n", ptrn_str, rc);
+        result = 1;
+        asn_free_value(pattern);
+        return;
+    }
+
+    for (i = 0; i < n_frames; ++i)
+    {
+        pkt = tad_pkt_alloc(1, frames[i].len);
+        if (pkt == NULL)
+        {
+            printf("failed to allocate packet\n");
+            result = 1;
+            break;
+        }
+        memcpy(tad_pkt_first_seg(pkt)->data_ptr, frames[i].data,
+               frames[i].len);
+
+        n_found = tad_recv_index_lookup(index, pkt, frames[i].len, &found);
+        if (frames[i].units[0] == -2)
+        {
+            if (found != NULL || n_found != ptrn_data.n_units)
+            {
+                printf("pattern '%s': frame %u: not all units are "
+                       "tried\n", ptrn_str, i);
+                result = 1;
+            }
+        }
+        else
+        {
+            for (j = 0; j < n_found && frames[i].units[j] >= 0; ++j)
+            {
+                if (found == NULL || found[j] != (unsigned)frames[i].units[j])
+                    break;
+            }
+            if (j != n_found || frames[i].units[j] >= 0)
+            {
+                printf("pattern '%s': frame %u: unexpected units\n",
+                       ptrn_str, i);
+                result = 1;
+            }
+        }
+
+        tad_pkt_free(pkt);
+    }
+
+    tad_recv_index_free(index);
+    asn_free_value(pattern);
+}
+
+int
+main(void)
+{
+    static const te_tad_protocols_t udp4[] = {
+        TE_PROTO_UDP, TE_PROTO_IP4, TE_PROTO_ETH
+    };
+    static const te_tad_protocols_t eth[] = { TE_PROTO_ETH };
+    test_frame  frames[6];
+
+    /* Ports of flows and a unit without port in the middle */
+    test_frame_udp4(&frames[0], 5000, 0);
+    test_frame_units(&frames[0], (const int[]){ 0, 2, -1 });
+    test_frame_udp4(&frames[1], 5001, 0);
+    test_frame_units(&frames[1], (const int[]){ 1, 2, -1 });
+    test_frame_udp4(&frames[2], 5003, 0);
+    test_frame_units(&frames[2], (const int[]){ 2, 3, -1 });
+    test_frame_udp4(&frames[3], 6000, 0);
+    test_frame_units(&frames[3], (const int[]){ 2, -1 });
+    /* Fragments are passed to all units */
+    test_frame_udp4(&frames[4], 5000, 0x2000);
+    test_frame_units(&frames[4], (const int[]){ -2 });
+    /* Not IPv4 */
+    test_frame_udp4(&frames[5], 5000, 0);
+    frames[5].data[13] = 0x06;
+    test_frame_units(&frames[5], (const int[]){ -2 });
+
+    test_recv_index(udp4, 3, FALSE,
+                    "{ { pdus { udp:{ dst-port plain:5000 }, ip4:{ }, "
+                    "eth:{ } } }, "
+                    "{ pdus { udp:{ dst-port plain:5001 }, ip4:{ }, "
+                    "eth:{ } } }, "
+                    "{ pdus { udp:{ }, ip4:{ }, eth:{ } } }, "
+                    "{ pdus { udp:{ dst-port plain:5003 }, ip4:{ }, "
+                    "eth:{ } } } }",
+                    frames, 6);
+
+    /* Masks are not exact values */
+    test_recv_index(udp4, 3, FALSE,
+                    "{ { pdus { udp:{ dst-port plain:5000 }, ip4:{ }, "
+                    "eth:{ } } }, "
+                    "{ pdus { udp:{ dst-port mask:{ v '13 89'H, "
+                    "m 'ff 00'H } }, ip4:{ }, eth:{ } } } }",
+                    NULL, 0);
+
+    /* The same value in all units */
+    test_recv_index(udp4, 3, FALSE,
+                    "{ { pdus { udp:{ dst-port plain:5000 }, ip4:{ }, "
+                    "eth:{ } } }, "
+                    "{ pdus { udp:{ dst-port plain:5000 }, ip4:{ }, "
+                    "eth:{ } } } }",
+                    NULL, 0);
+
+    /* VLAN ID and Ethernet type */
+    test_frame_udp4(&frames[0], 5000, 0);
+    test_frame_vlan(&frames[0], 10);
+    test_frame_units(&frames[0], (const int[]){ 0, -1 });
+    test_frame_udp4(&frames[1], 5000, 0);
+    test_frame_vlan(&frames[1], 0x100b);
+    test_frame_units(&frames[1], (const int[]){ 1, -1 });
+    test_frame_udp4(&frames[2], 5000, 0);
+    test_frame_vlan(&frames[2], 10);
+    frames[2].data[17] = 0x06;
+    test_frame_units(&frames[2], (const int[]){ -1 });
+    /* Untagged frame has no key */
+    test_frame_udp4(&frames[3], 5000, 0);
+    test_frame_units(&frames[3], (const int[]){ -2 });
+
+    test_recv_index(eth, 1, FALSE,
+                    "{ { pdus { eth:{ length-type plain:2048, "
+                    "tagged tagged:{ vlan-id plain:10 } } } }, "
+                    "{ pdus { eth:{ length-type plain:2048, "
+                    "tagged tagged:{ vlan-id plain:11 } } } } }",
+                    frames, 4);
+
+    /* Frame which matches no unit is passed to all units in mismatch mode */
+    test_frame_units(&frames[2], (const int[]){ -2 });
+
+    test_recv_index(eth, 1, TRUE,
+                    "{ { pdus { eth:{ length-type plain:2048, "
+                    "tagged tagged:{ vlan-id plain:10 } } } }, "
+                    "{ pdus { eth:{ length-type plain:2048, "
+                    "tagged tagged:{ vlan-id plain:11 } } } } }",
+                    frames, 4);
+
+    return result;
+}
@@ -0,0 +1,313 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test API for RPC
+ *
+ * TAPI for batches of remote calls.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "te_str.h"
+#include "te_string.h"
+#include "rpc_xdr.h"
+#include "tapi_rpc_internal.h"
+#include "tapi_rpc_batch.h"
+
+
+/* See description in tapi_rpc_batch.h */
+void
+tapi_rpc_batch_init(tapi_rpc_batch *batch)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->stop_on_errno = TRUE;
+}
+
+/* See description in tapi_rpc_batch.h */
+te_errno
+tapi_rpc_batch_add(tapi_rpc_batch *batch, const char *func,
+                   void *in, void *out, tapi_rpc_batch_log_func log)
+{
+    tapi_rpc_batch_call *calls;
+
+    if (rpc_find_info(func) == NULL)
+    {
+        ERROR("%s(): unknown RPC '%s'", __FUNCTION__, func);
+        return TE_RC(TE_TAPI, TE_ENOENT);
+    }
+
+    if (batch->n_calls == batch->size)
+    {
+        unsigned int size = (batch->size == 0) ? 8 : batch->size * 2;
+
+        calls = realloc(batch->calls, size * sizeof(*calls));
+        if (calls == NULL)
+            return TE_RC(TE_TAPI, TE_ENOMEM);
+
+        batch->calls = calls;
+        batch->size = size;
+    }
+
+    batch->calls[batch->n_calls].func = func;
+    batch->calls[batch->n_calls].in = in;
+    batch->calls[batch->n_calls].out = out;
+    batch->calls[batch->n_calls].log = log;
+    batch->n_calls++;
+
+    return 0;
+}
+
+/**
+ * Encode a call of the batch to a buffer allocated by the function.
+ *
+ * @param call      Call
+ * @param enc       Location for the encoded call
+ *
+ * @return Status code.
+ */
+static te_errno
+batch_encode_call(const tapi_rpc_batch_call *call,
+                  struct tarpc_batch_call *enc)
+{
+    size_t  buf_len;
+    size_t  len;
+    char   *buf = NULL;
+    char   *tmp;
+    int     rc = TE_ESUNRPC;
+
+    for (buf_len = RCF_RPC_BUF_LEN;
+         TE_RC_GET_ERROR(rc) == TE_ESUNRPC &&
+         buf_len <= RCF_RPC_HUGE_BUF_LEN;
+         buf_len <<= 1)
+    {
+        tmp = realloc(buf, buf_len);
+        if (tmp == NULL)
+        {
+            free(buf);
+            return TE_RC(TE_TAPI, TE_ENOMEM);
+        }
+        buf = tmp;
+
+        len = buf_len;
+        rc = rpc_xdr_encode_call(call->func, buf, &len, call->in);
+    }
+    if (rc != 0)
+    {
+        ERROR("Failed to encode %s() call of the batch: %r",
+              call->func, rc);
+        free(buf);
+        return TE_RC(TE_TAPI, TE_E2BIG);
+    }
+
+    enc->call.call_val = buf;
+    enc->call.call_len = len;
+
+    return 0;
+}
+
+/**
+ * Log a call executed in the batch in the same way as TAPI_RPC_LOG()
+ * logs a separate call.
+ *
+ * @param rpcs      RPC server handle
+ * @param call      Call
+ * @param common    Common output parameters of the call
+ */
+static void
+batch_log_call(rcf_rpc_server *rpcs, const tapi_rpc_batch_call *call,
+               const struct tarpc_out_arg *common)
+{
+    te_string   args = TE_STRING_INIT;
+    te_string   ret = TE_STRING_INIT;
+    te_bool     err;
+
+    /*
+     * Return values are not known here, so a call which changes errno
+     * is considered failed and is logged as an error unless failures
+     * are expected by the caller.
+     */
+    err = !RPC_IS_ERRNO_RPC(common->_errno) ||
+          (rpcs->iut_err_jump && rpcs->errno_change_check &&
+           common->errno_changed);
+
+    if (rpcs->silent && !err && !TEST_BEHAVIOUR(log_all_rpc))
+        return;
+
+    if (call->log != NULL)
+        call->log(call->in, call->out, &args, &ret);
+
+    LOG_MSG(err ? TE_LL_ERROR : TE_LL_RING,
+            "RPC (%s,%s[%" PRIu16 "]) batch%s: %s(%s) -> %s (%r%s%s%s)",
+            rpcs->ta, rpcs->name, rpcs->seqno,
+            (rpcs->last_use_libc || rpcs->use_libc) ? " libc" : "",
+            call->func, te_string_value(&args), te_string_value(&ret),
+            common->_errno,
+            common->err_str.err_str_len > 0 ? " (error message '" : "",
+            common->err_str.err_str_len > 0 ?
+                common->err_str.err_str_val : "",
+            common->err_str.err_str_len > 0 ? "')" : "");
+
+    te_string_free(&args);
+    te_string_free(&ret);
+}
+
+/* See description in tapi_rpc_batch.h */
+int
+rpc_batch(rcf_rpc_server *rpcs, tapi_rpc_batch *batch)
+{
+    tarpc_rpc_batch_in      in;
+    tarpc_rpc_batch_out     out;
+    struct tarpc_in_arg    *common_in;
+    struct tarpc_out_arg   *common_out;
+    rpc_info               *info;
+    unsigned int            i;
+    int                     rc = -1;
+    te_errno                err;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    if (rpcs == NULL)
+    {
+        ERROR("%s(): Invalid RPC server handle", __FUNCTION__);
+        RETVAL_INT(rpc_batch, -1);
+    }
+
+    batch->n_done = 0;
+
+    if (rpcs->op != RCF_RPC_CALL_WAIT)
+    {
+        ERROR("%s(): only blocking execution of a batch is supported",
+              __FUNCTION__);
+        rpcs->_errno = TE_RC(TE_TAPI, TE_EOPNOTSUPP);
+        RETVAL_INT(rpc_batch, -1);
+    }
+
+    in.calls.calls_val = calloc(batch->n_calls,
+                                sizeof(*in.calls.calls_val));
+    if (in.calls.calls_val == NULL && batch->n_calls > 0)
+    {
+        rpcs->_errno = TE_RC(TE_TAPI, TE_ENOMEM);
+        RETVAL_INT(rpc_batch, -1);
+    }
+    in.calls.calls_len = batch->n_calls;
+    in.stop_on_errno = batch->stop_on_errno;
+
+    for (i = 0; i < batch->n_calls; i++)
+    {
+        /* Fill in the common part in the same way as rcf_rpc_call() */
+        common_in = batch->calls[i].in;
+        memset(common_in, 0, sizeof(*common_in));
+        common_in->op = RCF_RPC_CALL_WAIT;
+        common_in->seqno = rpcs->seqno + 1;
+        common_in->lib_flags = TARPC_LIB_DEFAULT;
+        if (rpcs->use_libc || rpcs->use_libc_once)
+            common_in->lib_flags |= TARPC_LIB_USE_LIBC;
+        if (rpcs->use_syscall)
+            common_in->lib_flags |= TARPC_LIB_USE_SYSCALL;
+
+        err = batch_encode_call(&batch->calls[i], &in.calls.calls_val[i]);
+        if (err != 0)
+        {
+            rpcs->_errno = err;
+            break;
+        }
+    }
+
+    if (i == batch->n_calls)
+    {
+        /*
+         * The batch lasts as long as all its calls: unless the timeout
+         * is set by the caller, it is the sum of default timeouts.
+         */
+        if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        {
+            uint64_t timeout = (uint64_t)rpcs->def_timeout *
+                               MAX(batch->n_calls, 1);
+
+            rpcs->timeout = MIN(timeout, UINT32_MAX);
+        }
+
+        rcf_rpc_call(rpcs, "rpc_batch", &in, &out);
+
+        if (RPC_IS_CALL_OK(rpcs))
+            rc = 0;
+
+        for (i = 0; i < out.results.results_len; i++)
+        {
+            tapi_rpc_batch_call *call = &batch->calls[i];
+
+            info = rpc_find_info(call->func);
+            memset(call->out, 0, info->out_len);
+            err = rpc_xdr_decode_result(call->func,
+                                        out.results.results_val[i].
+                                            result.result_val,
+                                        out.results.results_val[i].
+                                            result.result_len,
+                                        call->out);
+            if (err != 0)
+            {
+                ERROR("Failed to decode %s() result of the batch: %r",
+                      call->func, err);
+                rpc_xdr_free(info->out, call->out);
+                rpcs->_errno = TE_RC(TE_TAPI, TE_EINVAL);
+                rc = -1;
+                break;
+            }
+            batch->n_done++;
+
+            common_out = call->out;
+            batch_log_call(rpcs, call, common_out);
+
+            /* Errno of the batch is the one of the last executed call */
+            if (rc == 0)
+            {
+                rpcs->_errno = common_out->_errno;
+                rpcs->err_msg[0] = '\0';
+                if (common_out->err_str.err_str_len > 0)
+                {
+                    TE_STRLCPY(rpcs->err_msg,
+                               common_out->err_str.err_str_val,
+                               RPC_ERROR_MAX_LEN);
+                }
+            }
+        }
+        if (rc == 0)
+            rc = batch->n_done;
+    }
+
+    for (i = 0; i < in.calls.calls_len; i++)
+        free(in.calls.calls_val[i].call.call_val);
+    free(in.calls.calls_val);
+
+    TAPI_RPC_LOG(rpcs, rpc_batch, "%u calls", "%d", batch->n_calls, rc);
+    TAPI_RPC_OUT(rpc_batch, rc < 0 || batch->n_done < batch->n_calls);
+
+    return rc;
+}
+
+/* See description in tapi_rpc_batch.h */
+void
+tapi_rpc_batch_free(tapi_rpc_batch *batch)
+{
+    rpc_info     *info;
+    unsigned int  i;
+
+    for (i = 0; i < batch->n_done; i++)
+    {
+        info = rpc_find_info(batch->calls[i].func);
+        rpc_xdr_free(info->out, batch->calls[i].out);
+    }
+
+    free(batch->calls);
+    tapi_rpc_batch_init(batch);
+}
@@ -1549,7 +1549,6 @@ void
 rpc_set_buf_gen(rcf_rpc_server *rpcs, const uint8_t *src_buf,
             size_t len, rpc_ptr dst_buf, size_t dst_off)
 {
-    char               *src_buf_cpy;
     tarpc_set_buf_in    in;
     tarpc_set_buf_out   out;
 
@@ -1565,35 +1564,17 @@ rpc_set_buf_gen(rcf_rpc_server *rpcs, const uint8_t *src_buf,
     in.dst_buf = dst_buf;
     in.dst_off = dst_off;
 
-    if (src_buf == NULL)
+    if (src_buf == NULL || len == 0 ||
+        !rcf_rpc_shm_copy(rpcs, "set_buf", dst_buf, dst_off,
+                          (void *)src_buf, len, TRUE))
     {
-        src_buf_cpy = NULL;
-        in.src_buf.src_buf_val = NULL;
-        in.src_buf.src_buf_len = 0;
-    }
-    else
-    {
-        /*
-         * Duplicate input buffer, because it could be constant and may need
-         * to be modified.
-         */
-        src_buf_cpy = malloc(len);
-        if (src_buf_cpy == NULL)
-        {
-            ERROR("%s(): Failed to allocate %u bytes of memory",
-                  __FUNCTION__, len);
-            RETVAL_VOID(set_buf);
-        }
-        memcpy(src_buf_cpy, src_buf, len);
+        /* Encoding does not modify the data, so there is no need to copy */
+        in.src_buf.src_buf_val = (char *)src_buf;
+        in.src_buf.src_buf_len = src_buf == NULL ? 0 : len;
 
-        in.src_buf.src_buf_val = src_buf_cpy;
-        in.src_buf.src_buf_len = len;
+        rcf_rpc_call(rpcs, "set_buf", &in, &out);
     }
 
-    rcf_rpc_call(rpcs, "set_buf", &in, &out);
-
-    free(src_buf_cpy);
-
     TAPI_RPC_LOG(rpcs, set_buf, "%p, %u, %u (off %u)", "",
                  src_buf, len, dst_buf, dst_off);
     RETVAL_VOID(set_buf);
@@ -1622,7 +1603,12 @@ rpc_get_buf_gen(rcf_rpc_server *rpcs, rpc_ptr src_buf, size_t src_off,
     in.src_off = src_off;
     in.len = len;
 
-    rcf_rpc_call(rpcs, "get_buf", &in, &out);
+    if (dst_buf == NULL || len == 0 ||
+        !rcf_rpc_shm_copy(rpcs, "get_buf", src_buf, src_off,
+                          dst_buf, len, FALSE))
+    {
+        rcf_rpc_call(rpcs, "get_buf", &in, &out);
+    }
 
     TAPI_RPC_LOG(rpcs, get_buf, "%p, %u, %u (off %u)", "",
                  src_buf, len, src_buf, src_off);
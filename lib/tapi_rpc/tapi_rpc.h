@@ -36,6 +36,7 @@
 #include "tapi_rpc_ifnameindex.h"
 #include "tapi_rpc_netdb.h"
 #include "tapi_rpc_aio.h"
+#include "tapi_rpc_batch.h"
 #include "tapi_rpc_winsock2.h"
 #include "tapi_rpc_dlfcn.h"
 #include "tapi_rpc_misc.h"
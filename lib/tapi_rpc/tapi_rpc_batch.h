@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test API - RPC
+ *
+ * Definition of TAPI for batches of remote calls executed by
+ * the RPC server in a single round trip.
+ *
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_TAPI_RPC_BATCH_H__
+#define __TE_TAPI_RPC_BATCH_H__
+
+#include "rcf_rpc.h"
+#include "te_rpc_types.h"
+#include "te_string.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup te_lib_rpc_batch TAPI for batches of remote calls
+ * @ingroup te_lib_rpc_tapi
+ * @{
+ *
+ * Input structures of several RPCs are queued to the batch and sent
+ * to the RPC server in one call. The server executes them in order and
+ * returns outputs of all executed calls at once. Calls are executed
+ * as blocking ones (#RCF_RPC_CALL_WAIT), execution stops after the
+ * first failed call.
+ *
+ * Unless the timeout is set for the batch as for any other call
+ * (rcf_rpc_server::timeout), it is the sum of default timeouts of
+ * its calls.
+ *
+ * @code
+ * tapi_rpc_batch       batch;
+ * tarpc_socket_in      in;
+ * tarpc_socket_out     out;
+ *
+ * tapi_rpc_batch_init(&batch);
+ * ... fill in @p in ...
+ * tapi_rpc_batch_add(&batch, "socket", &in, &out, socket_log);
+ * ... add more calls ...
+ * rpc_batch(rpcs, &batch);
+ * ... check outputs of batch.n_done calls ...
+ * tapi_rpc_batch_free(&batch);
+ * @endcode
+ */
+
+/**
+ * Function describing a call of the batch in the log in the same way
+ * as TAPI RPC functions do it.
+ *
+ * @param in        Input parameters of the call
+ * @param out       Output parameters of the call
+ * @param args      String to append arguments of the call to
+ * @param ret       String to append return value of the call to
+ */
+typedef void (*tapi_rpc_batch_log_func)(const void *in, const void *out,
+                                        te_string *args, te_string *ret);
+
+/** Call queued to the batch */
+typedef struct tapi_rpc_batch_call {
+    const char *func;   /**< RPC name, e.g. "socket" */
+    void       *in;     /**< Input parameters, e.g. tarpc_socket_in */
+    void       *out;    /**< Location for output parameters,
+                             e.g. tarpc_socket_out */
+    tapi_rpc_batch_log_func log;    /**< Function describing the call
+                                         in the log (may be @c NULL) */
+} tapi_rpc_batch_call;
+
+/** Batch of remote calls */
+typedef struct tapi_rpc_batch {
+    tapi_rpc_batch_call    *calls;          /**< Queued calls */
+    unsigned int            n_calls;        /**< Number of queued calls */
+    unsigned int            size;           /**< Number of allocated
+                                                 entries in @p calls */
+    unsigned int            n_done;         /**< Number of calls executed
+                                                 by the last rpc_batch() */
+    te_bool                 stop_on_errno;  /**< Stop execution if a call
+                                                 changes errno (default
+                                                 is @c TRUE) */
+} tapi_rpc_batch;
+
+/**
+ * Initialize an empty batch.
+ *
+ * @param batch     Batch
+ */
+extern void tapi_rpc_batch_init(tapi_rpc_batch *batch);
+
+/**
+ * Queue a call to the batch. Common input parameters of the call are
+ * filled in by rpc_batch().
+ *
+ * @param batch     Batch
+ * @param func      RPC name
+ * @param in        Input parameters (should be valid until rpc_batch())
+ * @param out       Location for output parameters (should be valid until
+ *                  tapi_rpc_batch_free())
+ * @param log       Function describing arguments and return value of
+ *                  the call in the log or @c NULL (only errno is
+ *                  logged then)
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_rpc_batch_add(tapi_rpc_batch *batch, const char *func,
+                                   void *in, void *out,
+                                   tapi_rpc_batch_log_func log);
+
+/**
+ * Execute calls of the batch on the RPC server.
+ *
+ * Outputs of executed calls are decoded to locations passed to
+ * tapi_rpc_batch_add(), each call is logged as a separate one.
+ * RPC server errno is set to errno of the last executed call.
+ *
+ * @param rpcs      RPC server handle
+ * @param batch     Batch
+ *
+ * @return Number of executed calls or @c -1 if the batch is not executed.
+ */
+extern int rpc_batch(rcf_rpc_server *rpcs, tapi_rpc_batch *batch);
+
+/**
+ * Free resources of the batch including outputs of executed calls.
+ *
+ * @param batch     Batch
+ */
+extern void tapi_rpc_batch_free(tapi_rpc_batch *batch);
+
+/**@} <!-- END te_lib_rpc_batch --> */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_TAPI_RPC_BATCH_H__ */
@@ -1171,6 +1171,24 @@ extern rpc_ptr rpc_malloc(rcf_rpc_server *rpcs, size_t size);
  */
 extern void rpc_free(rcf_rpc_server *rpcs, rpc_ptr buf);
 
+/**
+ * Allocate a buffer of specified size in TA address space backed by
+ * POSIX shared memory. If the test runs on the same host as RPC server,
+ * the buffer is also mapped to the test address space, so that
+ * rpc_set_buf() and rpc_get_buf() copy data directly without RPC and
+ * only the buffer identifier is passed to RPCs working with it
+ * (e.g. rpc_readbuf(), rpc_writebuf()). Otherwise the buffer behaves
+ * as one allocated by rpc_malloc().
+ *
+ * @param rpcs    RPC server handle
+ * @param size    size of the buffer to be allocated
+ *
+ * @return  Allocated buffer identifier or RPC_NULL.
+ *
+ * @note The buffer must be released with rpc_free().
+ */
+extern rpc_ptr rpc_malloc_shm(rcf_rpc_server *rpcs, size_t size);
+
 /**
  * Get address in the TA address space by its ID.
  *
@@ -2595,12 +2595,49 @@ rpc_free(rcf_rpc_server *rpcs, rpc_ptr buf)
 
     in.buf = (tarpc_ptr)buf;
 
+    rcf_rpc_shm_unmap(rpcs, buf);
     rcf_rpc_call(rpcs, "free", &in, &out);
 
     TAPI_RPC_LOG(rpcs, free, "%u", "", buf);
     RETVAL_VOID(free);
 }
 
+/* See description in tapi_rpc_unistd.h */
+rpc_ptr
+rpc_malloc_shm(rcf_rpc_server *rpcs, size_t size)
+{
+    tarpc_malloc_shm_in     in;
+    tarpc_malloc_shm_out    out;
+    te_errno                rc;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    if (rpcs == NULL)
+    {
+        ERROR("%s(): Invalid RPC server handle", __FUNCTION__);
+        RETVAL_RPC_PTR(malloc_shm, 0);
+    }
+
+    in.size = size;
+
+    rcf_rpc_call(rpcs, "malloc_shm", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && out.retval != 0)
+    {
+        rc = rcf_rpc_shm_map(rpcs, out.retval, out.name, size);
+        if (rc != 0)
+        {
+            VERB("%s(): buffer %s is accessed via RPC: %r",
+                 __FUNCTION__, out.name, rc);
+        }
+    }
+
+    TAPI_RPC_LOG(rpcs, malloc_shm, "%" TE_PRINTF_SIZE_T "u", "%u",
+                 size, out.retval);
+    RETVAL_RPC_PTR(malloc_shm, (rpc_ptr)out.retval);
+}
+
 /**
  * Get address in the TA address space by its ID.
  *
@@ -254,11 +254,41 @@ tapi_tad_csap_create(const char *ta_name, int session,
     te_errno    rc;
     char        tmp_name[] = "/tmp/te_tapi_tad_csap_create.XXXXXX";
     char       *stack_id_by_spec = NULL;
+    asn_value  *spec_bin = NULL;
+    int32_t     bin_reports;
 
     if ((rc = te_make_tmp_file(tmp_name)) != 0)
         return TE_RC(TE_TAPI, rc);
 
-    rc = asn_save_to_file(csap_spec, tmp_name);
+    /*
+     * Ask Test Agent to report received packets in binary encoding
+     * (packet handlers decode it by asn_parse_dvalue_in_file()),
+     * unless the caller specified it explicitly.
+     */
+    rc = asn_read_int32(csap_spec, &bin_reports, "params.binary-reports");
+    if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        spec_bin = asn_copy_value(csap_spec);
+        if (spec_bin == NULL)
+        {
+            (void)unlink(tmp_name);
+            return TE_RC(TE_TAPI, TE_ENOMEM);
+        }
+        rc = asn_write_int32(spec_bin, ASN_BIN_VERSION,
+                             "params.binary-reports");
+        if (rc != 0)
+        {
+            ERROR("%s(): failed to request binary reports: %r",
+                  __FUNCTION__, rc);
+            asn_free_value(spec_bin);
+            (void)unlink(tmp_name);
+            return rc;
+        }
+    }
+
+    rc = asn_save_to_file(spec_bin != NULL ? spec_bin : csap_spec,
+                          tmp_name);
+    asn_free_value(spec_bin);
     if (rc != 0)
     {
         ERROR("%s(): asn_save_to_file() failed: %r", __FUNCTION__, rc);
@@ -403,14 +433,20 @@ tapi_tad_trrecv_pkt_handler(const char *filename, void *my_data)
     te_errno    rc;
     int         syms = 0;
     asn_value  *packet;
+    asn_arena  *arena;
 
     tapi_tad_trrecv_cb_data *cb_data =
         (tapi_tad_trrecv_cb_data *)my_data;
 
 
-    /* Parse file in any case to check that it is OK */
+    /*
+     * Parse file in any case to check that it is OK. Values of the packet
+     * are allocated from arena and are freed at once with the packet.
+     */
+    arena = asn_arena_open();
     rc = asn_parse_dvalue_in_file(filename, ndn_raw_packet,
                                   &packet, &syms);
+    asn_arena_close(arena);
     if (rc != 0)
     {
         ERROR("Parse packet from file failed on symbol %d : %r\n%Tf",
@@ -636,6 +672,76 @@ tapi_tad_csap_get_no_match_pkts(const char *ta_name, int session,
     RETURN_RC(0);
 }
 
+/* See the description in tapi_tad.h */
+te_errno
+tapi_tad_csap_get_kern_no_match_pkts(const char *ta_name, int session,
+                                     csap_handle_t csap_id,
+                                     unsigned int *val)
+{
+    int         rc;
+    int64_t     tmp;
+
+    ENTRY("TA=%s, SID=%d, CSAP=%d, location=0x%08x",
+          ta_name, session, csap_id, val);
+
+    rc = tapi_csap_param_get_llint(ta_name, session, csap_id,
+                                   CSAP_PARAM_KERN_NO_MATCH_PKTS, &tmp);
+    if (rc != 0)
+    {
+        RETURN_RC(rc);
+    }
+
+    *val = (unsigned int)tmp;
+
+    RETURN_RC(0);
+}
+
+/* See the description in tapi_tad.h */
+te_errno
+tapi_tad_csap_get_sent_pkts(const char *ta_name, int session,
+                            csap_handle_t csap_id, unsigned int *val)
+{
+    int         rc;
+    int64_t     tmp;
+
+    ENTRY("TA=%s, SID=%d, CSAP=%d, location=0x%08x",
+          ta_name, session, csap_id, val);
+
+    rc = tapi_csap_param_get_llint(ta_name, session, csap_id,
+                                   CSAP_PARAM_TOTAL_SENT, &tmp);
+    if (rc != 0)
+    {
+        RETURN_RC(rc);
+    }
+
+    *val = (unsigned int)tmp;
+
+    RETURN_RC(0);
+}
+
+/* See the description in tapi_tad.h */
+te_errno
+tapi_tad_csap_get_send_calls(const char *ta_name, int session,
+                             csap_handle_t csap_id, unsigned int *val)
+{
+    int         rc;
+    int64_t     tmp;
+
+    ENTRY("TA=%s, SID=%d, CSAP=%d, location=0x%08x",
+          ta_name, session, csap_id, val);
+
+    rc = tapi_csap_param_get_llint(ta_name, session, csap_id,
+                                   CSAP_PARAM_SEND_CALLS, &tmp);
+    if (rc != 0)
+    {
+        RETURN_RC(rc);
+    }
+
+    *val = (unsigned int)tmp;
+
+    RETURN_RC(0);
+}
+
 /**
  * Destroy CSAP by its Configurator handle using RCF.
  *
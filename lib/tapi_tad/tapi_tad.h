@@ -366,6 +366,58 @@ extern te_errno tapi_tad_csap_get_no_match_pkts(const char *ta_name,
                                                 csap_handle_t csap_id,
                                                 unsigned int *val);
 
+/**
+ * Get number of packets filtered out in the kernel before matching
+ * in user space using a parameter of CSAP. The number is estimated
+ * when receive operation is finished and is zero if the traffic
+ * pattern is not filtered in the kernel.
+ *
+ * @param ta_name   - name of the Test Agent
+ * @param session   - session identifier to be used
+ * @param csap_id   - CSAP handle
+ * @param val       - location for number of packets (OUT)
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_tad_csap_get_kern_no_match_pkts(const char *ta_name,
+                                                     int session,
+                                                     csap_handle_t csap_id,
+                                                     unsigned int *val);
+
+/**
+ * Get total number of packets sent by CSAP using a parameter of CSAP.
+ *
+ * @param ta_name   - name of the Test Agent
+ * @param session   - session identifier to be used
+ * @param csap_id   - CSAP handle
+ * @param val       - location for number of packets (OUT)
+ *
+ * @return Status code.
+ *
+ * @sa tapi_csap_get_total_bytes()
+ */
+extern te_errno tapi_tad_csap_get_sent_pkts(const char *ta_name,
+                                            int session,
+                                            csap_handle_t csap_id,
+                                            unsigned int *val);
+
+/**
+ * Get number of calls of the low-level write routine made by CSAP
+ * to send packets using a parameter of CSAP. It is less than number
+ * of sent packets if the CSAP sends packets in batches.
+ *
+ * @param ta_name   - name of the Test Agent
+ * @param session   - session identifier to be used
+ * @param csap_id   - CSAP handle
+ * @param val       - location for number of calls (OUT)
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_tad_csap_get_send_calls(const char *ta_name,
+                                             int session,
+                                             csap_handle_t csap_id,
+                                             unsigned int *val);
+
 /**
  * Finalise all CSAP instances on all Test Agents using RCF.
  *
@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Log-linear histograms
+ *
+ * Implementation of log-linear histograms.
+ *
+ * Values less than 2^(TE_HIST_SUB_BITS + 1) have a bucket each.
+ * A greater value with the most significant bit number @a m is
+ * counted in the bucket (s << TE_HIST_SUB_BITS) + (value >> s), where
+ * s = m - TE_HIST_SUB_BITS and the second term is in
+ * [2^TE_HIST_SUB_BITS, 2^(TE_HIST_SUB_BITS + 1)), so buckets of
+ * neighbouring octaves follow each other without gaps.
+ *
+ * Copyright (C) 2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Histogram"
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "te_hist.h"
+
+/** Values which have a bucket each */
+#define TE_HIST_LINEAR  (1ULL << (TE_HIST_SUB_BITS + 1))
+
+/** Percentiles reported in summaries */
+static const double te_hist_percentiles[] = { 50, 90, 99, 99.9 };
+
+/**
+ * Get number of the most significant bit of a non-zero value.
+ *
+ * @param value     Value
+ *
+ * @return Bit number.
+ */
+static inline unsigned int
+te_hist_msb(uint64_t value)
+{
+#ifdef __GNUC__
+    return 63 - __builtin_clzll(value);
+#else
+    unsigned int m = 0;
+
+    while (value >>= 1)
+        m++;
+
+    return m;
+#endif
+}
+
+/**
+ * Get bucket of a value.
+ *
+ * @param value     Value
+ *
+ * @return Bucket index.
+ */
+static inline unsigned int
+te_hist_bucket(uint64_t value)
+{
+    unsigned int shift;
+
+    if (value < TE_HIST_LINEAR)
+        return value;
+
+    if (value >= (1ULL << TE_HIST_MAX_BITS))
+        return TE_HIST_N_BUCKETS - 1;
+
+    shift = te_hist_msb(value) - TE_HIST_SUB_BITS;
+
+    return (shift << TE_HIST_SUB_BITS) + (value >> shift);
+}
+
+/**
+ * Get the highest value counted in a bucket.
+ *
+ * @param bucket    Bucket index
+ *
+ * @return Value.
+ */
+static uint64_t
+te_hist_bucket_high(unsigned int bucket)
+{
+    unsigned int shift;
+    uint64_t     mant;
+
+    if (bucket < TE_HIST_LINEAR)
+        return bucket;
+
+    shift = (bucket >> TE_HIST_SUB_BITS) - 1;
+    mant = (1U << TE_HIST_SUB_BITS) |
+           (bucket & ((1U << TE_HIST_SUB_BITS) - 1));
+
+    return ((mant + 1) << shift) - 1;
+}
+
+/* See description in te_hist.h */
+void
+te_hist_init(te_hist *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+/* See description in te_hist.h */
+void
+te_hist_add(te_hist *hist, uint64_t value)
+{
+    hist->count++;
+    hist->sum += value;
+    if (value < hist->min)
+        hist->min = value;
+    if (value > hist->max)
+        hist->max = value;
+    hist->buckets[te_hist_bucket(value)]++;
+}
+
+/* See description in te_hist.h */
+void
+te_hist_merge(te_hist *dst, const te_hist *src)
+{
+    unsigned int i;
+
+    if (src->count == 0)
+        return;
+
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min)
+        dst->min = src->min;
+    if (src->max > dst->max)
+        dst->max = src->max;
+
+    for (i = 0; i < TE_HIST_N_BUCKETS; i++)
+        dst->buckets[i] += src->buckets[i];
+}
+
+/* See description in te_hist.h */
+uint64_t
+te_hist_percentile(const te_hist *hist, double percentile)
+{
+    uint64_t     rank;
+    uint64_t     seen = 0;
+    unsigned int i;
+
+    if (hist->count == 0)
+        return 0;
+
+    if (percentile <= 0)
+        return hist->min;
+    if (percentile >= 100)
+        return hist->max;
+
+    rank = (uint64_t)(percentile * hist->count / 100);
+    if ((double)rank * 100 < percentile * hist->count)
+        rank++;
+
+    for (i = 0; i < TE_HIST_N_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= rank)
+            break;
+    }
+
+    return MIN(MAX(te_hist_bucket_high(i), hist->min), hist->max);
+}
+
+/* See description in te_hist.h */
+double
+te_hist_mean(const te_hist *hist)
+{
+    return hist->count == 0 ? 0 : (double)hist->sum / hist->count;
+}
+
+/* See description in te_hist.h */
+te_errno
+te_hist_summary(const te_hist *hist, te_string *str)
+{
+    unsigned int i;
+    te_errno     rc;
+
+    if (hist->count == 0)
+        return te_string_append(str, "n=0");
+
+    rc = te_string_append(str, "n=%llu min=%llu avg=%.1f",
+                          (unsigned long long)hist->count,
+                          (unsigned long long)hist->min,
+                          te_hist_mean(hist));
+
+    for (i = 0; rc == 0 && i < TE_ARRAY_LEN(te_hist_percentiles); i++)
+    {
+        rc = te_string_append(str, " p%g=%llu", te_hist_percentiles[i],
+                              (unsigned long long)
+                                  te_hist_percentile(hist,
+                                                     te_hist_percentiles[i]));
+    }
+
+    if (rc == 0)
+        rc = te_string_append(str, " max=%llu",
+                              (unsigned long long)hist->max);
+
+    return rc;
+}
+
+/* See description in te_hist.h */
+void
+te_hist_mi_add(te_mi_logger *logger, te_errno *retval, const te_hist *hist,
+               te_mi_meas_type type, const char *name,
+               te_mi_meas_multiplier multiplier)
+{
+    te_string    pname = TE_STRING_INIT;
+    unsigned int i;
+
+    if (hist->count == 0)
+        return;
+
+    te_mi_logger_add_meas(logger, retval, type, name, TE_MI_MEAS_AGGR_MIN,
+                          hist->min, multiplier);
+    te_mi_logger_add_meas(logger, retval, type, name, TE_MI_MEAS_AGGR_MEAN,
+                          te_hist_mean(hist), multiplier);
+    te_mi_logger_add_meas(logger, retval, type, name, TE_MI_MEAS_AGGR_MAX,
+                          hist->max, multiplier);
+
+    for (i = 0; i < TE_ARRAY_LEN(te_hist_percentiles); i++)
+    {
+        te_string_reset(&pname);
+        te_string_append(&pname, "%s p%g", name, te_hist_percentiles[i]);
+        te_mi_logger_add_meas(logger, retval, type, pname.ptr,
+                              TE_MI_MEAS_AGGR_PERCENTILE,
+                              te_hist_percentile(hist,
+                                                 te_hist_percentiles[i]),
+                              multiplier);
+    }
+
+    te_string_free(&pname);
+}
@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Log-linear histograms
+ *
+ * @defgroup te_tools_te_hist Log-linear histograms
+ * @ingroup te_tools
+ * @{
+ *
+ * Fixed-size histograms of non-negative integer values (e.g. latencies
+ * in microseconds) with bounded relative error in the spirit of
+ * HdrHistogram: every power of two range is split into
+ * 2^#TE_HIST_SUB_BITS equal buckets, so percentiles are reported with
+ * less than 1/2^#TE_HIST_SUB_BITS relative error while adding a value
+ * takes constant time and does not allocate memory.
+ *
+ * Copyright (C) 2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_HIST_H__
+#define __TE_HIST_H__
+
+#include "te_defs.h"
+#include "te_stdint.h"
+#include "te_errno.h"
+#include "te_string.h"
+#include "te_mi_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of bits of a value used to choose a bucket inside its octave */
+#define TE_HIST_SUB_BITS    4
+
+/**
+ * Values not less than 2^TE_HIST_MAX_BITS are counted in the last
+ * bucket (but still taken into account in maximum and mean).
+ */
+#define TE_HIST_MAX_BITS    40
+
+/** Number of buckets in a histogram */
+#define TE_HIST_N_BUCKETS \
+    ((TE_HIST_MAX_BITS - TE_HIST_SUB_BITS + 1) << TE_HIST_SUB_BITS)
+
+/** Histogram */
+typedef struct te_hist {
+    uint64_t count;                         /**< Number of values */
+    uint64_t sum;                           /**< Sum of values */
+    uint64_t min;                           /**< Minimum value */
+    uint64_t max;                           /**< Maximum value */
+    uint64_t buckets[TE_HIST_N_BUCKETS];    /**< Counters of buckets */
+} te_hist;
+
+/**
+ * Initialize an empty histogram.
+ *
+ * @param hist      Histogram
+ */
+extern void te_hist_init(te_hist *hist);
+
+/**
+ * Add a value to a histogram.
+ *
+ * @param hist      Histogram
+ * @param value     Value
+ */
+extern void te_hist_add(te_hist *hist, uint64_t value);
+
+/**
+ * Add all values of a histogram to another one.
+ *
+ * @param dst       Histogram to add values to
+ * @param src       Histogram to take values from
+ */
+extern void te_hist_merge(te_hist *dst, const te_hist *src);
+
+/**
+ * Get value at a percentile: the highest value which is counted in the
+ * same bucket as the value below which @p percentile percents of values
+ * fall (it is never greater than the maximum).
+ *
+ * @param hist          Histogram
+ * @param percentile    Percentile from @c 0 to @c 100
+ *
+ * @return Value or @c 0 if the histogram is empty.
+ */
+extern uint64_t te_hist_percentile(const te_hist *hist, double percentile);
+
+/**
+ * Get mean of values in a histogram.
+ *
+ * @param hist      Histogram
+ *
+ * @return Mean or @c 0 if the histogram is empty.
+ */
+extern double te_hist_mean(const te_hist *hist);
+
+/**
+ * Append a short human-readable summary of a histogram
+ * (number of values, minimum, mean, some percentiles and maximum).
+ *
+ * @param hist      Histogram
+ * @param str       String to append the summary to
+ *
+ * @return Status code.
+ */
+extern te_errno te_hist_summary(const te_hist *hist, te_string *str);
+
+/**
+ * Add summary of a histogram to MI measurements: minimum, mean and
+ * maximum are added under @p name, percentiles are added under
+ * "<name> p<N>" names.
+ *
+ * @param logger        MI logger
+ * @param retval        Return code (see te_mi_logger_add_meas())
+ * @param hist          Histogram
+ * @param type          Type of measurements
+ * @param name          Name of measurements
+ * @param multiplier    Scale of values in the histogram
+ */
+extern void te_hist_mi_add(te_mi_logger *logger, te_errno *retval,
+                           const te_hist *hist, te_mi_meas_type type,
+                           const char *name,
+                           te_mi_meas_multiplier multiplier);
+
+/**@} <!-- END te_tools_te_hist --> */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_HIST_H__ */
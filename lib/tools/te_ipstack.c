@@ -17,6 +17,7 @@
 
 #include "te_ipstack.h"
 #include "te_sockaddr.h"
+#include "te_simd.h"
 #include "logger_api.h"
 #include "tad_common.h"
 #include "te_defs.h"
@@ -49,10 +50,14 @@ te_ipstack_calc_l4_cksum(const struct sockaddr  *ip_dst_addr,
                          uint16_t               *cksum_out)
 {
     te_errno    rc = 0;
-    uint8_t    *pseudo_packet;
-    size_t      pseudo_packet_len;
+    size_t      pseudo_hdr_len;
     uint16_t    cksum;
 
+    union {
+        struct te_ipstack_pseudo_header_ip  ip;
+        struct te_ipstack_pseudo_header_ip6 ip6;
+    } pseudo_hdr;
+
     if (datagram == NULL)
     {
         rc = TE_EINVAL;
@@ -60,59 +65,40 @@ te_ipstack_calc_l4_cksum(const struct sockaddr  *ip_dst_addr,
         goto out;
     }
 
-    pseudo_packet_len = ((ip_dst_addr->sa_family == AF_INET) ?
-                         sizeof(struct te_ipstack_pseudo_header_ip) :
-                         sizeof(struct te_ipstack_pseudo_header_ip6)) +
-                         datagram_len;
-
-    pseudo_packet = calloc(1, pseudo_packet_len);
-    if (pseudo_packet == NULL)
-    {
-        rc = TE_ENOMEM;
-        ERROR("%s(): failed to allocate memory for a 'pseudo_packet'; rc = %d",
-              __FUNCTION__, rc);
-        goto out;
-    }
+    memset(&pseudo_hdr, 0, sizeof(pseudo_hdr));
 
     if (ip_dst_addr->sa_family == AF_INET)
     {
-        struct te_ipstack_pseudo_header_ip *pseudo_ih;
+        pseudo_hdr_len = sizeof(pseudo_hdr.ip);
 
-        pseudo_ih = (struct te_ipstack_pseudo_header_ip *)pseudo_packet;
-
-        pseudo_ih->src_addr = CONST_SIN(ip_src_addr)->sin_addr.s_addr;
-        pseudo_ih->dst_addr = CONST_SIN(ip_dst_addr)->sin_addr.s_addr;
-        pseudo_ih->next_hdr = next_hdr;
-        pseudo_ih->data_len = htons(datagram_len);
+        pseudo_hdr.ip.src_addr = CONST_SIN(ip_src_addr)->sin_addr.s_addr;
+        pseudo_hdr.ip.dst_addr = CONST_SIN(ip_dst_addr)->sin_addr.s_addr;
+        pseudo_hdr.ip.next_hdr = next_hdr;
+        pseudo_hdr.ip.data_len = htons(datagram_len);
     }
     else
     {
-        struct te_ipstack_pseudo_header_ip6 *pseudo_i6h;
-
-        pseudo_i6h = (struct te_ipstack_pseudo_header_ip6 *)pseudo_packet;
+        pseudo_hdr_len = sizeof(pseudo_hdr.ip6);
 
-        memcpy(&pseudo_i6h->src_addr, &CONST_SIN6(ip_src_addr)->sin6_addr,
+        memcpy(&pseudo_hdr.ip6.src_addr, &CONST_SIN6(ip_src_addr)->sin6_addr,
                sizeof(struct in6_addr));
 
-        memcpy(&pseudo_i6h->dst_addr, &CONST_SIN6(ip_dst_addr)->sin6_addr,
+        memcpy(&pseudo_hdr.ip6.dst_addr, &CONST_SIN6(ip_dst_addr)->sin6_addr,
                sizeof(struct in6_addr));
 
-        pseudo_i6h->data_len = htonl(datagram_len);
-        pseudo_i6h->next_hdr = next_hdr;
+        pseudo_hdr.ip6.data_len = htonl(datagram_len);
+        pseudo_hdr.ip6.next_hdr = next_hdr;
     }
 
-    memcpy(pseudo_packet + (pseudo_packet_len - datagram_len),
-           datagram, datagram_len);
-
     /*
-     * We don't care about 16-bit word padding here and rely on
-     * calculate_checksum() behaviour which should keep an eye on it
+     * Pseudo-header length is even, so the datagram is summed up
+     * in place continuing from the pseudo-header sum. Odd datagram
+     * length is padded by te_simd_csum_part().
      */
-    cksum = calculate_checksum((void *)pseudo_packet, pseudo_packet_len);
+    cksum = te_simd_csum_part(0, &pseudo_hdr, pseudo_hdr_len);
+    cksum = te_simd_csum_part(cksum, datagram, datagram_len);
     cksum = ~cksum;
 
-    free(pseudo_packet);
-
     /*
      * For UDP checksum=0 means no checksum, and zero checksum value
      * should be instead represented as 0xffff (see RFC 768).
@@ -0,0 +1,320 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief SIMD-accelerated data processing kernels
+ *
+ * Implementation of Internet checksum and masked comparison kernels
+ * with AVX2, SSE4.2 and scalar variants chosen at run time.
+ *
+ * Checksum kernels sum the data as 32-bit words into 64-bit
+ * accumulators: since 2^16 is 1 modulo 0xffff, the sum folded to
+ * 16 bits is the same as one's complement sum of 16-bit words.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "SIMD"
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "te_simd.h"
+
+#if defined(__GNUC__) && HAVE_IMMINTRIN_H && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+/** x86 SIMD kernels are built */
+#define TE_SIMD_X86     1
+#endif
+
+/** Checksum kernel: sum of 32-bit words (zero-padded tail) of the data */
+typedef uint64_t (*te_simd_csum_kernel)(const uint8_t *data, size_t length);
+
+/** Masked comparison kernel */
+typedef te_bool (*te_simd_match_mask_kernel)(const uint8_t *data,
+                                             const uint8_t *mask,
+                                             const uint8_t *value,
+                                             size_t length);
+
+/**
+ * Sum the data as 32-bit words in scalar code.
+ *
+ * @param data      Data
+ * @param length    Length of the data
+ *
+ * @return Sum of 32-bit words.
+ */
+static uint64_t
+te_simd_csum_scalar(const uint8_t *data, size_t length)
+{
+    uint64_t    sum = 0;
+    uint32_t    word;
+    uint16_t    half;
+
+    for (; length >= sizeof(word); data += sizeof(word),
+                                   length -= sizeof(word))
+    {
+        memcpy(&word, data, sizeof(word));
+        sum += word;
+    }
+
+    if (length >= sizeof(half))
+    {
+        memcpy(&half, data, sizeof(half));
+        sum += half;
+        data += sizeof(half);
+        length -= sizeof(half);
+    }
+
+    if (length == 1)
+    {
+        union {uint8_t bytes[2]; uint16_t num;} a;
+
+        a.bytes[0] = *data;
+        a.bytes[1] = 0;
+        sum += a.num;
+    }
+
+    return sum;
+}
+
+/**
+ * Compare data with value by mask in scalar code.
+ *
+ * @param data      Data
+ * @param mask      Mask
+ * @param value     Value
+ * @param length    Length of the data
+ *
+ * @return @c TRUE if data match.
+ */
+static te_bool
+te_simd_match_mask_scalar(const uint8_t *data, const uint8_t *mask,
+                          const uint8_t *value, size_t length)
+{
+    uint64_t    d, m, v;
+    size_t      i = 0;
+
+    for (; i + sizeof(d) <= length; i += sizeof(d))
+    {
+        memcpy(&d, data + i, sizeof(d));
+        memcpy(&m, mask + i, sizeof(m));
+        memcpy(&v, value + i, sizeof(v));
+        if (((d ^ v) & m) != 0)
+            return FALSE;
+    }
+
+    for (; i < length; i++)
+    {
+        if (((data[i] ^ value[i]) & mask[i]) != 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+#ifdef TE_SIMD_X86
+/** Sum 32-bit words of the data using SSE4.2 */
+__attribute__((target("sse4.2")))
+static uint64_t
+te_simd_csum_sse42(const uint8_t *data, size_t length)
+{
+    const __m128i   zero = _mm_setzero_si128();
+    __m128i         acc0 = zero;
+    __m128i         acc1 = zero;
+    __m128i         v0;
+    __m128i         v1;
+    uint64_t        lanes[2];
+
+    for (; length >= 2 * sizeof(v0); data += 2 * sizeof(v0),
+                                     length -= 2 * sizeof(v0))
+    {
+        v0 = _mm_loadu_si128((const __m128i *)data);
+        v1 = _mm_loadu_si128((const __m128i *)(data + sizeof(v0)));
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v0, zero));
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v0, zero));
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v1, zero));
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v1, zero));
+    }
+
+    _mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(acc0, acc1));
+
+    return lanes[0] + lanes[1] + te_simd_csum_scalar(data, length);
+}
+
+/** Compare data with value by mask using SSE4.2 */
+__attribute__((target("sse4.2")))
+static te_bool
+te_simd_match_mask_sse42(const uint8_t *data, const uint8_t *mask,
+                         const uint8_t *value, size_t length)
+{
+    __m128i d0, m0, v0;
+    __m128i d1, m1, v1;
+    size_t  i = 0;
+
+    /* Differences of two vectors are checked at once */
+    for (; i + 2 * sizeof(d0) <= length; i += 2 * sizeof(d0))
+    {
+        d0 = _mm_loadu_si128((const __m128i *)(data + i));
+        m0 = _mm_loadu_si128((const __m128i *)(mask + i));
+        v0 = _mm_loadu_si128((const __m128i *)(value + i));
+        d1 = _mm_loadu_si128((const __m128i *)(data + i + sizeof(d0)));
+        m1 = _mm_loadu_si128((const __m128i *)(mask + i + sizeof(d0)));
+        v1 = _mm_loadu_si128((const __m128i *)(value + i + sizeof(d0)));
+        d0 = _mm_and_si128(_mm_xor_si128(d0, v0), m0);
+        d1 = _mm_and_si128(_mm_xor_si128(d1, v1), m1);
+        d0 = _mm_or_si128(d0, d1);
+        if (!_mm_testz_si128(d0, d0))
+            return FALSE;
+    }
+
+    return te_simd_match_mask_scalar(data + i, mask + i, value + i,
+                                     length - i);
+}
+
+/** Sum 32-bit words of the data using AVX2 */
+__attribute__((target("avx2")))
+static uint64_t
+te_simd_csum_avx2(const uint8_t *data, size_t length)
+{
+    const __m256i   zero = _mm256_setzero_si256();
+    __m256i         acc0 = zero;
+    __m256i         acc1 = zero;
+    __m256i         v0;
+    __m256i         v1;
+    uint64_t        lanes[4];
+
+    for (; length >= 2 * sizeof(v0); data += 2 * sizeof(v0),
+                                     length -= 2 * sizeof(v0))
+    {
+        v0 = _mm256_loadu_si256((const __m256i *)data);
+        v1 = _mm256_loadu_si256((const __m256i *)(data + sizeof(v0)));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v0, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v0, zero));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v1, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v1, zero));
+    }
+
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi64(acc0, acc1));
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+           te_simd_csum_sse42(data, length);
+}
+
+/** Compare data with value by mask using AVX2 */
+__attribute__((target("avx2")))
+static te_bool
+te_simd_match_mask_avx2(const uint8_t *data, const uint8_t *mask,
+                        const uint8_t *value, size_t length)
+{
+    __m256i d0, m0, v0;
+    __m256i d1, m1, v1;
+    size_t  i = 0;
+
+    /* Differences of two vectors are checked at once */
+    for (; i + 2 * sizeof(d0) <= length; i += 2 * sizeof(d0))
+    {
+        d0 = _mm256_loadu_si256((const __m256i *)(data + i));
+        m0 = _mm256_loadu_si256((const __m256i *)(mask + i));
+        v0 = _mm256_loadu_si256((const __m256i *)(value + i));
+        d1 = _mm256_loadu_si256((const __m256i *)(data + i + sizeof(d0)));
+        m1 = _mm256_loadu_si256((const __m256i *)(mask + i + sizeof(d0)));
+        v1 = _mm256_loadu_si256((const __m256i *)(value + i + sizeof(d0)));
+        d0 = _mm256_and_si256(_mm256_xor_si256(d0, v0), m0);
+        d1 = _mm256_and_si256(_mm256_xor_si256(d1, v1), m1);
+        d0 = _mm256_or_si256(d0, d1);
+        if (!_mm256_testz_si256(d0, d0))
+            return FALSE;
+    }
+
+    return te_simd_match_mask_sse42(data + i, mask + i, value + i,
+                                    length - i);
+}
+#endif /* TE_SIMD_X86 */
+
+/** Kernels of an instruction set extension */
+typedef struct te_simd_kernels {
+    te_simd_csum_kernel         csum;       /**< Checksum */
+    te_simd_match_mask_kernel   match_mask; /**< Masked comparison */
+} te_simd_kernels;
+
+/** Kernels indexed by instruction set extension */
+static const te_simd_kernels te_simd_kernels_by_level[] = {
+    [TE_SIMD_SCALAR] = { te_simd_csum_scalar, te_simd_match_mask_scalar },
+#ifdef TE_SIMD_X86
+    [TE_SIMD_SSE42] = { te_simd_csum_sse42, te_simd_match_mask_sse42 },
+    [TE_SIMD_AVX2] = { te_simd_csum_avx2, te_simd_match_mask_avx2 },
+#endif
+};
+
+/** Kernels in use or @c NULL if CPU features are not checked yet */
+static const te_simd_kernels *te_simd_cur = NULL;
+
+/* See description in te_simd.h */
+te_simd_level
+te_simd_level_supported(void)
+{
+#ifdef TE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return TE_SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return TE_SIMD_SSE42;
+#endif
+    return TE_SIMD_SCALAR;
+}
+
+/**
+ * Get kernels in use choosing them by CPU features on the first call.
+ *
+ * @return Kernels.
+ */
+static inline const te_simd_kernels *
+te_simd_kernels_get(void)
+{
+    if (te_simd_cur == NULL)
+        te_simd_cur = &te_simd_kernels_by_level[te_simd_level_supported()];
+
+    return te_simd_cur;
+}
+
+/* See description in te_simd.h */
+te_simd_level
+te_simd_get_level(void)
+{
+    return te_simd_kernels_get() - te_simd_kernels_by_level;
+}
+
+/* See description in te_simd.h */
+te_simd_level
+te_simd_set_level(te_simd_level level)
+{
+    level = MIN(level, te_simd_level_supported());
+    te_simd_cur = &te_simd_kernels_by_level[level];
+
+    return level;
+}
+
+/* See description in te_simd.h */
+uint16_t
+te_simd_csum_part(uint32_t checksum, const void *data, size_t length)
+{
+    uint64_t sum;
+
+    sum = checksum + te_simd_kernels_get()->csum(data, length);
+
+    while ((sum >> 16) != 0)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    return sum;
+}
+
+/* See description in te_simd.h */
+te_bool
+te_simd_match_mask(const uint8_t *data, const uint8_t *mask,
+                   const uint8_t *value, size_t length)
+{
+    return te_simd_kernels_get()->match_mask(data, mask, value, length);
+}
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief SIMD-accelerated data processing kernels
+ *
+ * @defgroup te_tools_te_simd SIMD kernels
+ * @ingroup te_tools
+ * @{
+ *
+ * Kernels to calculate Internet checksum and to compare data by mask
+ * using SIMD instructions. Implementation is chosen at run time by
+ * features of the CPU, portable scalar code is used if no suitable
+ * instructions are supported.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_TOOLS_SIMD_H__
+#define __TE_TOOLS_SIMD_H__
+
+#include "te_config.h"
+#include "te_defs.h"
+#include "te_stdint.h"
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Instruction set extensions used by kernels */
+typedef enum te_simd_level {
+    TE_SIMD_SCALAR = 0,     /**< No SIMD, portable scalar code */
+    TE_SIMD_SSE42,          /**< SSE4.2 */
+    TE_SIMD_AVX2,           /**< AVX2 */
+} te_simd_level;
+
+/**
+ * Get the best instruction set extension supported by the CPU and
+ * the library build.
+ *
+ * @return Instruction set extension.
+ */
+extern te_simd_level te_simd_level_supported(void);
+
+/**
+ * Get instruction set extension used by kernels.
+ *
+ * @return Instruction set extension.
+ */
+extern te_simd_level te_simd_get_level(void);
+
+/**
+ * Limit instruction set extension used by kernels, e.g. to compare
+ * results and performance of implementations. It is not thread-safe
+ * with respect to kernels called concurrently.
+ *
+ * @param level     Maximum instruction set extension to use
+ *
+ * @return Instruction set extension which is used from now on (it is
+ *         less than @p level if @p level is not supported).
+ */
+extern te_simd_level te_simd_set_level(te_simd_level level);
+
+/**
+ * Add data to 16-bit one's complement sum of 16-bit words (Internet
+ * checksum). The result is the same as of ip_csum_part().
+ *
+ * @param checksum  Sum to start from
+ * @param data      Data (no alignment is required)
+ * @param length    Length of the data
+ *
+ * @return Folded 16-bit sum (one's complement of it should be written
+ *         to checksum field of IP/TCP/UDP headers).
+ */
+extern uint16_t te_simd_csum_part(uint32_t checksum, const void *data,
+                                  size_t length);
+
+/**
+ * Compare data with value by mask.
+ *
+ * @param data      Data
+ * @param mask      Mask (bits which are set are compared)
+ * @param value     Value
+ * @param length    Length of the data, mask and value
+ *
+ * @return @c TRUE if data match the value by mask.
+ */
+extern te_bool te_simd_match_mask(const uint8_t *data, const uint8_t *mask,
+                                  const uint8_t *value, size_t length);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_TOOLS_SIMD_H__ */
+/**@} <!-- END te_tools_te_simd --> */
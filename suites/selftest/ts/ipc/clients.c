@@ -0,0 +1,166 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2022 OKTET Labs. All rights reserved. */
+/** @file
+ * @brief Test for many clients of connection-oriented IPC server.
+ *
+ * Serving more clients than select() can watch.
+ */
+
+/** @page ipc_clients Many clients of connection-oriented IPC server
+ *
+ * @objective Check that connection-oriented IPC server serves clients
+ *            whose sockets do not fit into @c fd_set, i.e. more than
+ *            @c FD_SETSIZE clients connected at the same time.
+ *
+ * @param n_extra       Number of clients in addition to @c FD_SETSIZE
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "ipc/clients"
+
+#include "te_config.h"
+
+#include <pthread.h>
+#if HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+#include "tapi_test.h"
+#include "tapi_mem.h"
+#include "ipc_client.h"
+#include "ipc_server.h"
+
+/** Number of descriptors reserved for other needs of the test */
+#define CLIENTS_RESERVED_FDS    64
+
+/** Name of the IPC server */
+static char server_name[64];
+
+/**
+ * Echo server: receive messages and send them back until an empty
+ * message is received.
+ *
+ * @param arg       IPC server
+ *
+ * @return Status code.
+ */
+static void *
+clients_echo_server(void *arg)
+{
+    struct ipc_server          *srv = arg;
+    struct ipc_server_client   *client;
+    unsigned int                msg;
+    size_t                      len;
+    uintptr_t                   rc;
+
+    while (TRUE)
+    {
+        client = NULL;
+        len = sizeof(msg);
+        rc = ipc_receive_message(srv, &msg, &len, &client);
+        if (rc != 0 || len == 0)
+            break;
+
+        rc = ipc_send_answer(srv, client, &msg, len);
+        if (rc != 0)
+            break;
+    }
+
+    return (void *)rc;
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned int        n_extra;
+    unsigned int        n_clients;
+    struct rlimit       rlim;
+    struct ipc_server  *srv = NULL;
+    struct ipc_client **clients = NULL;
+    pthread_t           thread;
+    te_bool             thread_started = FALSE;
+    void               *thread_rc;
+    unsigned int        answer;
+    size_t              len;
+    unsigned int        i;
+
+    TEST_START;
+    TEST_GET_UINT_PARAM(n_extra);
+
+    n_clients = FD_SETSIZE + n_extra;
+    clients = tapi_calloc(n_clients, sizeof(*clients));
+
+    TEST_STEP("Raise the limit of open files to fit both ends of "
+              "connections of all clients.");
+    if (getrlimit(RLIMIT_NOFILE, &rlim) != 0)
+        TEST_FAIL("getrlimit() failed: %s", strerror(errno));
+    if (rlim.rlim_max != RLIM_INFINITY &&
+        rlim.rlim_max < 2 * n_clients + CLIENTS_RESERVED_FDS)
+        TEST_SKIP("Limit of open files is too low");
+    if (rlim.rlim_cur != RLIM_INFINITY &&
+        rlim.rlim_cur < 2 * n_clients + CLIENTS_RESERVED_FDS)
+    {
+        rlim.rlim_cur = 2 * n_clients + CLIENTS_RESERVED_FDS;
+        if (setrlimit(RLIMIT_NOFILE, &rlim) != 0)
+            TEST_FAIL("setrlimit() failed: %s", strerror(errno));
+    }
+
+    TEST_STEP("Register connection-oriented IPC server and start "
+              "a thread which echoes received messages.");
+    TE_SPRINTF(server_name, "te_selftest_ipc_%u", (unsigned int)getpid());
+    CHECK_RC(ipc_register_server(server_name, TRUE, &srv));
+    CHECK_RC(pthread_create(&thread, NULL, clients_echo_server, srv));
+    thread_started = TRUE;
+
+    TEST_STEP("Create @c FD_SETSIZE + @p n_extra clients using sockets "
+              "and send a message from each of them without waiting "
+              "for answers, so that all of them are connected at "
+              "the same time.");
+    CHECK_RC(setenv(IPC_SHM_ENV, "no", 1));
+    for (i = 0; i < n_clients; i++)
+    {
+        char name[64];
+
+        TE_SPRINTF(name, "te_selftest_ipc_client_%u", i);
+        CHECK_RC(ipc_init_client(name, TRUE, &clients[i]));
+        CHECK_RC(ipc_send_message(clients[i], server_name, &i, sizeof(i)));
+    }
+
+    TEST_STEP("Receive answers of all clients in the reverse order "
+              "and check them.");
+    for (i = n_clients; i-- > 0; )
+    {
+        len = sizeof(answer);
+        CHECK_RC(ipc_receive_answer(clients[i], server_name,
+                                    &answer, &len));
+        if (len != sizeof(answer) || answer != i)
+            TEST_VERDICT("Client %u received a wrong answer", i);
+    }
+
+    TEST_STEP("Stop the server with an empty message.");
+    CHECK_RC(ipc_send_message(clients[0], server_name, NULL, 0));
+    thread_started = FALSE;
+    CHECK_RC(pthread_join(thread, &thread_rc));
+    if (thread_rc != NULL)
+        TEST_VERDICT("Server failed: %r", (te_errno)(uintptr_t)thread_rc);
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (clients != NULL)
+    {
+        for (i = 0; i < n_clients; i++)
+            CLEANUP_CHECK_RC(ipc_close_client(clients[i]));
+    }
+    if (thread_started)
+    {
+        pthread_cancel(thread);
+        pthread_join(thread, NULL);
+    }
+    CLEANUP_CHECK_RC(ipc_close_server(srv));
+    unsetenv(IPC_SHM_ENV);
+    free(clients);
+    TEST_END;
+}
@@ -0,0 +1,142 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2022 OKTET Labs. All rights reserved. */
+/** @file
+ * @brief Test for logging over connection-oriented IPC.
+ *
+ * Logging from many processes to Logger over a socket and over shared
+ * memory.
+ */
+
+/** @page ipc_logger Logging over connection-oriented IPC
+ *
+ * @objective Check that processes which log synchronously (i.e. send
+ *            messages under the lock of Logger TEN library) pass their
+ *            messages to Logger both over a socket and over shared
+ *            memory rings and terminate successfully.
+ *
+ * @param shm           Request shared memory transport
+ * @param n_children    Number of processes logging at the same time
+ * @param n_messages    Number of messages logged by each process
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "ipc/logger"
+
+#include "te_config.h"
+
+#if HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#include "tapi_test.h"
+#include "tapi_mem.h"
+#include "ipc_client.h"
+#include "logger_ten.h"
+
+/** Maximum length of logged strings */
+#define LOGGER_MAX_LEN  3001
+
+/**
+ * Log messages of various lengths and terminate the process.
+ * Messages are sent synchronously since the flusher thread of
+ * the parent does not exist in the child.
+ *
+ * @param shm           Request shared memory transport
+ * @param id            Identifier of the process
+ * @param n_messages    Number of messages to log
+ */
+static void
+logger_child(te_bool shm, unsigned int id, unsigned int n_messages)
+{
+    static char     str[LOGGER_MAX_LEN + 1];
+    unsigned int    i;
+
+    if (setenv(IPC_SHM_ENV, shm ? "yes" : "no", 1) != 0)
+        _exit(EXIT_FAILURE);
+
+    memset(str, 'a' + id % 26, sizeof(str) - 1);
+    for (i = 0; i < n_messages; i++)
+    {
+        RING("Process %u, message %u: %s", id, i,
+             str + LOGGER_MAX_LEN - (i * 7919) % LOGGER_MAX_LEN);
+    }
+
+    /*
+     * Close Logger client explicitly instead of calling exit handlers
+     * of the test inherited from the parent.
+     */
+    log_client_close();
+    _exit(EXIT_SUCCESS);
+}
+
+int
+main(int argc, char **argv)
+{
+    te_bool         shm;
+    unsigned int    n_children;
+    unsigned int    n_messages;
+    pid_t          *pids = NULL;
+    int             status;
+    unsigned int    failed = 0;
+    unsigned int    i;
+
+    TEST_START;
+    TEST_GET_BOOL_PARAM(shm);
+    TEST_GET_UINT_PARAM(n_children);
+    TEST_GET_UINT_PARAM(n_messages);
+
+    pids = tapi_calloc(n_children, sizeof(*pids));
+
+    TEST_STEP("Start @p n_children processes each of which requests "
+              "shared memory transport if @p shm is @c TRUE and logs "
+              "@p n_messages messages of various lengths.");
+    for (i = 0; i < n_children; i++)
+    {
+        pids[i] = fork();
+        if (pids[i] < 0)
+            TEST_FAIL("fork() failed: %s", strerror(errno));
+        if (pids[i] == 0)
+            logger_child(shm, i, n_messages);
+    }
+
+    TEST_STEP("Wait for termination of the processes and check that "
+              "all of them succeed.");
+    for (i = 0; i < n_children; i++)
+    {
+        if (waitpid(pids[i], &status, 0) < 0)
+            TEST_FAIL("waitpid() failed: %s", strerror(errno));
+        pids[i] = 0;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        {
+            ERROR("Process %u terminated abnormally, status 0x%x",
+                  i, status);
+            failed++;
+        }
+    }
+    if (failed > 0)
+        TEST_VERDICT("Logging process terminated abnormally");
+
+    TEST_STEP("Log a message from the test itself to check that Logger "
+              "still accepts messages.");
+    RING("All %u processes logged %u messages each",
+         n_children, n_messages);
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (pids != NULL)
+    {
+        for (i = 0; i < n_children; i++)
+        {
+            if (pids[i] > 0)
+            {
+                kill(pids[i], SIGKILL);
+                waitpid(pids[i], NULL, 0);
+            }
+        }
+    }
+    free(pids);
+    TEST_END;
+}
@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2022 OKTET Labs. All rights reserved. */
+/** @file
+ * @brief Test for connection-oriented IPC transports.
+ *
+ * Passing messages of connection-oriented IPC over a socket and over
+ * shared memory.
+ */
+
+/** @page ipc_shm Connection-oriented IPC transports
+ *
+ * @objective Check that messages and answers of connection-oriented
+ *            IPC are passed intact both over a socket and over shared
+ *            memory rings, including messages which do not fit into
+ *            a ring and messages crossing the end of a ring.
+ *
+ * @param shm           Request shared memory transport
+ * @param n_messages    Number of messages to check wraparound of rings
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "ipc/shm"
+
+#include "te_config.h"
+
+#include <pthread.h>
+
+#include "tapi_test.h"
+#include "tapi_mem.h"
+#include "te_bufs.h"
+#include "ipc_client.h"
+#include "ipc_server.h"
+
+/** Length of a message which does not fit into a ring */
+#define SHM_BIG_LEN     (1024 * 1024 + 13)
+
+/** Maximum length of messages to check wraparound */
+#define SHM_MAX_LEN     5003
+
+/** Buffer length used by the server to read messages by parts */
+#define SHM_SERVER_BUF  4096
+
+/** Name of the IPC server */
+static char server_name[64];
+
+/**
+ * Echo server: receive messages by parts and send them back until
+ * an empty message is received.
+ *
+ * @param arg       IPC server
+ *
+ * @return Status code.
+ */
+static void *
+shm_echo_server(void *arg)
+{
+    struct ipc_server          *srv = arg;
+    struct ipc_server_client   *client;
+    uint8_t                    *msg = NULL;
+    size_t                      total;
+    size_t                      chunk;
+    size_t                      len;
+    uintptr_t                   rc = 0;
+
+    msg = malloc(SHM_BIG_LEN);
+    if (msg == NULL)
+        return (void *)(uintptr_t)TE_RC(TE_IPC, TE_ENOMEM);
+
+    while (TRUE)
+    {
+        client = NULL;
+        total = 0;
+        do {
+            chunk = len = MIN(SHM_SERVER_BUF, SHM_BIG_LEN - total);
+            rc = ipc_receive_message(srv, msg + total, &len, &client);
+            if (rc == 0)
+                total += len;
+            else if (rc == TE_RC(TE_IPC, TE_ESMALLBUF))
+                total += chunk;     /* The whole buffer is filled in */
+            else
+                goto out;
+        } while (rc != 0);
+
+        if (total == 0)
+            break;
+
+        rc = ipc_send_answer(srv, client, msg, total);
+        if (rc != 0)
+            break;
+    }
+
+out:
+    free(msg);
+    return (void *)rc;
+}
+
+/**
+ * Send a message and check that the same data is received back.
+ *
+ * @param ipcc      IPC client
+ * @param msg       Message
+ * @param answer    Buffer for the answer
+ * @param len       Length of the message
+ */
+static void
+shm_check_echo(struct ipc_client *ipcc, const uint8_t *msg,
+               uint8_t *answer, size_t len)
+{
+    size_t answer_len = len;
+
+    CHECK_RC(ipc_send_message_with_answer(ipcc, server_name, msg, len,
+                                          answer, &answer_len));
+    if (answer_len != len || memcmp(msg, answer, len) != 0)
+    {
+        ERROR("%zu bytes are sent, %zu bytes are received back",
+              len, answer_len);
+        TEST_VERDICT("Answer does not match the message");
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    te_bool             shm;
+    unsigned int        n_messages;
+    struct ipc_server  *srv = NULL;
+    struct ipc_client  *ipcc = NULL;
+    pthread_t           thread;
+    te_bool             thread_started = FALSE;
+    void               *thread_rc;
+    uint8_t            *msg = NULL;
+    uint8_t            *answer = NULL;
+    unsigned int        i;
+
+    TEST_START;
+    TEST_GET_BOOL_PARAM(shm);
+    TEST_GET_UINT_PARAM(n_messages);
+
+    msg = te_make_buf_by_len(SHM_BIG_LEN);
+    answer = tapi_malloc(SHM_BIG_LEN);
+
+    TEST_STEP("Register connection-oriented IPC server and start "
+              "a thread which echoes received messages.");
+    TE_SPRINTF(server_name, "te_selftest_ipc_%u", (unsigned int)getpid());
+    CHECK_RC(ipc_register_server(server_name, TRUE, &srv));
+    CHECK_RC(pthread_create(&thread, NULL, shm_echo_server, srv));
+    thread_started = TRUE;
+
+    TEST_STEP("Create IPC client requesting shared memory transport "
+              "if @p shm is @c TRUE.");
+    CHECK_RC(setenv(IPC_SHM_ENV, shm ? "yes" : "no", 1));
+    CHECK_RC(ipc_init_client("te_selftest_ipc_client", TRUE, &ipcc));
+
+    TEST_STEP("Send the first message and check that shared memory is "
+              "attached by the server if it is requested.");
+    shm_check_echo(ipcc, msg, answer, 1);
+    if (ipc_client_shm_used(ipcc, server_name) != shm)
+    {
+        TEST_VERDICT("Shared memory transport is %sused",
+                     shm ? "not " : "");
+    }
+
+    TEST_STEP("Send a message which is longer than a ring, so that the "
+              "writer waits until the reader frees space in it.");
+    shm_check_echo(ipcc, msg, answer, SHM_BIG_LEN);
+
+    TEST_STEP("Send @p n_messages messages of various lengths, so that "
+              "data cross the end of rings many times.");
+    for (i = 0; i < n_messages; i++)
+        shm_check_echo(ipcc, msg + i % 97, answer,
+                       1 + (i * 7919) % SHM_MAX_LEN);
+
+    TEST_STEP("Stop the server with an empty message.");
+    CHECK_RC(ipc_send_message(ipcc, server_name, NULL, 0));
+    thread_started = FALSE;
+    CHECK_RC(pthread_join(thread, &thread_rc));
+    if (thread_rc != NULL)
+        TEST_VERDICT("Server failed: %r", (te_errno)(uintptr_t)thread_rc);
+
+    TEST_SUCCESS;
+
+cleanup:
+    CLEANUP_CHECK_RC(ipc_close_client(ipcc));
+    if (thread_started)
+    {
+        pthread_cancel(thread);
+        pthread_join(thread, NULL);
+    }
+    CLEANUP_CHECK_RC(ipc_close_server(srv));
+    unsetenv(IPC_SHM_ENV);
+    free(msg);
+    free(answer);
+    TEST_END;
+}
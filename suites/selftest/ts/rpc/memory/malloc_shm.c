@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief
+ * Access buffers allocated in shared memory.
+ *
+ * Copyright (C) 2022 OKTET Labs Ltd., St. Petersburg, Russia
+ */
+
+/** @page memory_malloc_shm Buffers allocated in shared memory
+ *
+ * @objective Check that data copied by rpc_set_buf() and rpc_get_buf()
+ *            to/from a buffer allocated by rpc_malloc_shm() is the
+ *            same data RPC server reads and writes in it, both when
+ *            the buffer is mapped to the test address space and when
+ *            it is not.
+ *
+ * @param env       Testing environment:
+ *                  - IUT RPC server
+ * @param mapped    Whether the buffer should stay mapped to the test
+ *                  address space; if @c FALSE, the local mapping is
+ *                  dropped as if the shared memory object could not
+ *                  be mapped
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME "memory/malloc_shm"
+
+#include "memory_suite.h"
+#include "tapi_rpc_misc.h"
+#include "tapi_rpcsock_macros.h"
+#include "te_bufs.h"
+
+/** Size of the buffer (less than PIPE_BUF, so pipe I/O is atomic) */
+#define MALLOC_SHM_SIZE 1024
+
+/**
+ * Check that two buffers have the same data.
+ *
+ * @param _exp      Expected data
+ * @param _got      Obtained data
+ * @param _len      Length of data
+ * @param _what     Description of the check
+ */
+#define MALLOC_SHM_CHECK(_exp, _got, _len, _what) \
+    do {                                                        \
+        if (memcmp((_exp), (_got), (_len)) != 0)                \
+            TEST_VERDICT("%s: data does not match", (_what));   \
+    } while (0)
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    te_bool         mapped;
+    rpc_ptr         shm = RPC_NULL;
+    rpc_ptr         plain = RPC_NULL;
+    int             fds[2] = { -1, -1 };
+    uint8_t         tx[MALLOC_SHM_SIZE];
+    uint8_t         rx[MALLOC_SHM_SIZE];
+    uint8_t         probe;
+    te_bool         is_mapped;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_BOOL_PARAM(mapped);
+
+    TEST_STEP("Allocate a buffer in shared memory and an ordinary one "
+              "on IUT, create a pipe to move data between them.");
+    shm = rpc_malloc_shm(pco_iut, MALLOC_SHM_SIZE);
+    plain = rpc_malloc(pco_iut, MALLOC_SHM_SIZE);
+    rpc_pipe(pco_iut, fds);
+
+    if (!mapped)
+    {
+        TEST_STEP("If @p mapped is @c FALSE, drop the local mapping of "
+                  "the shared memory buffer.");
+        rcf_rpc_shm_unmap(pco_iut, shm);
+    }
+
+    TEST_STEP("Check whether the buffer is accessed locally.");
+    is_mapped = rcf_rpc_shm_copy(pco_iut, "get_buf", shm, 0, &probe,
+                                 sizeof(probe), FALSE);
+    if (is_mapped != mapped)
+    {
+        if (mapped)
+            TEST_SKIP("Shared memory of IUT cannot be mapped locally");
+        TEST_VERDICT("Buffer is accessed locally after unmapping");
+    }
+
+    TEST_STEP("Write data to the shared memory buffer with rpc_set_buf(), "
+              "pass it with rpc_writebuf() and rpc_readbuf() to the "
+              "ordinary buffer and check that it is not changed.");
+    te_fill_buf(tx, sizeof(tx));
+    rpc_set_buf(pco_iut, tx, sizeof(tx), shm);
+    if (rpc_writebuf(pco_iut, fds[1], shm, sizeof(tx)) !=
+            MALLOC_SHM_SIZE ||
+        rpc_readbuf(pco_iut, fds[0], plain, sizeof(tx)) != MALLOC_SHM_SIZE)
+        TEST_FAIL("Failed to pass data via the pipe");
+    rpc_get_buf(pco_iut, plain, sizeof(rx), rx);
+    MALLOC_SHM_CHECK(tx, rx, sizeof(tx), "rpc_set_buf() to shared memory");
+
+    TEST_STEP("Write data to the ordinary buffer, pass it with "
+              "rpc_writebuf() and rpc_readbuf() to the shared memory "
+              "buffer and check it with rpc_get_buf().");
+    te_fill_buf(tx, sizeof(tx));
+    rpc_set_buf(pco_iut, tx, sizeof(tx), plain);
+    if (rpc_writebuf(pco_iut, fds[1], plain, sizeof(tx)) !=
+            MALLOC_SHM_SIZE ||
+        rpc_readbuf(pco_iut, fds[0], shm, sizeof(tx)) != MALLOC_SHM_SIZE)
+        TEST_FAIL("Failed to pass data via the pipe");
+    rpc_get_buf(pco_iut, shm, sizeof(rx), rx);
+    MALLOC_SHM_CHECK(tx, rx, sizeof(tx), "rpc_get_buf() from shared memory");
+
+    TEST_STEP("Check that rpc_get_buf() at an offset returns the tail "
+              "of the data written by RPC server.");
+    memset(rx, 0, sizeof(rx));
+    rpc_get_buf_gen(pco_iut, shm, sizeof(rx) / 2, sizeof(rx) / 2, rx);
+    MALLOC_SHM_CHECK(tx + sizeof(tx) / 2, rx, sizeof(rx) / 2,
+                     "rpc_get_buf() at an offset from shared memory");
+
+    TEST_SUCCESS;
+
+cleanup:
+    CLEANUP_RPC_FREE(pco_iut, shm);
+    CLEANUP_RPC_FREE(pco_iut, plain);
+    CLEANUP_RPC_CLOSE(pco_iut, fds[0]);
+    CLEANUP_RPC_CLOSE(pco_iut, fds[1]);
+
+    TEST_END;
+}
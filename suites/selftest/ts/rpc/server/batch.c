@@ -0,0 +1,189 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RPC Test Suite
+ *
+ * Batch of remote calls.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page batch Batch of remote calls
+ *
+ * @objective Check that calls of a batch are executed in order,
+ *            execution stops on error if requested and results of
+ *            executed calls are returned.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param stop_on_errno Stop execution if a call changes errno
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME    "batch"
+
+#include "rpc_suite.h"
+#include "tapi_rpc_batch.h"
+#include "tapi_file.h"
+
+/** Number of calls in the batch */
+#define BATCH_CALLS 5
+
+/** Index of the call which fails */
+#define BATCH_FAILED 3
+
+/** Set path in input parameters of a call */
+#define BATCH_SET_PATH(_in, _path) \
+    do {                                                \
+        (_in).path.path_val = (_path);                  \
+        (_in).path.path_len = strlen(_path) + 1;        \
+    } while (0)
+
+/**
+ * Describe a call taking a path and returning an integer in the log.
+ *
+ * @param in        Input parameters (starting with the path)
+ * @param out       Output parameters
+ * @param args      String to append arguments to
+ * @param ret       String to append return value to
+ */
+static void
+batch_path_log(const void *in, const void *out,
+               te_string *args, te_string *ret)
+{
+    const tarpc_rmdir_in       *path_in = in;
+    const tarpc_int_retval_out *int_out = out;
+
+    te_string_append(args, "%s", path_in->path.path_val);
+    te_string_append(ret, "%d", int_out->retval);
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server         *pco_iut = NULL;
+    te_bool                 stop_on_errno;
+    char                   *rdir = NULL;
+    tapi_rpc_batch          batch;
+    tarpc_mkdir_in          mkdir_in;
+    tarpc_mkdir_out         mkdir_out;
+    tarpc_access_in         access_in;
+    tarpc_access_out        access_out;
+    tarpc_rmdir_in          rmdir_in;
+    tarpc_rmdir_out         rmdir_out;
+    tarpc_access_in         access2_in;
+    tarpc_access_out        access2_out;
+    tarpc_mkdir_in          mkdir2_in;
+    tarpc_mkdir_out         mkdir2_out;
+    struct tarpc_out_arg   *common;
+    int                     exp_done;
+    int                     done;
+    int                     i;
+
+    tapi_rpc_batch_init(&batch);
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_BOOL_PARAM(stop_on_errno);
+
+    rdir = tapi_file_make_name(NULL);
+
+    memset(&mkdir_in, 0, sizeof(mkdir_in));
+    memset(&access_in, 0, sizeof(access_in));
+    memset(&rmdir_in, 0, sizeof(rmdir_in));
+    memset(&access2_in, 0, sizeof(access2_in));
+    memset(&mkdir2_in, 0, sizeof(mkdir2_in));
+
+    BATCH_SET_PATH(mkdir_in, rdir);
+    BATCH_SET_PATH(access_in, rdir);
+    BATCH_SET_PATH(rmdir_in, rdir);
+    BATCH_SET_PATH(access2_in, rdir);
+    BATCH_SET_PATH(mkdir2_in, rdir);
+    mkdir_in.mode = mkdir2_in.mode = RPC_S_IRWXU;
+    access_in.mode = access2_in.mode = RPC_F_OK;
+
+    TEST_STEP("Queue to the batch calls which create a directory, check "
+              "that it exists, remove it, check that it exists (which "
+              "fails) and create it again.");
+    CHECK_RC(tapi_rpc_batch_add(&batch, "mkdir", &mkdir_in, &mkdir_out,
+                                batch_path_log));
+    CHECK_RC(tapi_rpc_batch_add(&batch, "access", &access_in, &access_out,
+                                batch_path_log));
+    CHECK_RC(tapi_rpc_batch_add(&batch, "rmdir", &rmdir_in, &rmdir_out,
+                                batch_path_log));
+    CHECK_RC(tapi_rpc_batch_add(&batch, "access", &access2_in,
+                                &access2_out, batch_path_log));
+    CHECK_RC(tapi_rpc_batch_add(&batch, "mkdir", &mkdir2_in, &mkdir2_out,
+                                batch_path_log));
+    batch.stop_on_errno = stop_on_errno;
+
+    TEST_STEP("Execute the batch and check the number of executed calls: "
+              "the last call should be skipped if @p stop_on_errno is "
+              "@c TRUE.");
+    exp_done = stop_on_errno ? BATCH_FAILED + 1 : BATCH_CALLS;
+    RPC_AWAIT_ERROR(pco_iut);
+    done = rpc_batch(pco_iut, &batch);
+    if (done < 0)
+        TEST_VERDICT("Batch is not executed: %r", RPC_ERRNO(pco_iut));
+    if (done != exp_done || (int)batch.n_done != done)
+    {
+        TEST_VERDICT("%d calls are executed instead of %d (%u decoded)",
+                     done, exp_done, batch.n_done);
+    }
+    common = batch.calls[done - 1].out;
+    if (RPC_ERRNO(pco_iut) != common->_errno)
+    {
+        TEST_VERDICT("Errno of the batch is not the one of the last "
+                     "executed call: %r", RPC_ERRNO(pco_iut));
+    }
+
+    TEST_STEP("Check results of executed calls: the directory should "
+              "exist after the first call and should not after the third "
+              "one.");
+    for (i = 0; i < done; i++)
+    {
+        common = batch.calls[i].out;
+        if (i == BATCH_FAILED)
+        {
+            if (access2_out.retval != -1 ||
+                common->_errno != RPC_ENOENT)
+            {
+                TEST_VERDICT("access() of the removed directory returned "
+                             "%d with errno %r instead of failure with "
+                             "ENOENT", access2_out.retval,
+                             common->_errno);
+            }
+        }
+        else if (((tarpc_int_retval_out *)common)->retval != 0)
+        {
+            TEST_VERDICT("Call %d (%s) of the batch failed: %r", i,
+                         batch.calls[i].func, common->_errno);
+        }
+    }
+
+    TEST_STEP("Check that the directory exists only if the last call "
+              "is executed.");
+    RPC_AWAIT_ERROR(pco_iut);
+    if ((rpc_access(pco_iut, rdir, RPC_F_OK) == 0) != !stop_on_errno)
+        TEST_VERDICT("Calls skipped by the batch are executed");
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (pco_iut != NULL && rdir != NULL)
+    {
+        RPC_AWAIT_ERROR(pco_iut);
+        if (rpc_access(pco_iut, rdir, RPC_F_OK) == 0)
+        {
+            RPC_AWAIT_ERROR(pco_iut);
+            if (rpc_rmdir(pco_iut, rdir) != 0)
+                MACRO_TEST_ERROR;
+        }
+    }
+
+    tapi_rpc_batch_free(&batch);
+    free(rdir);
+
+    TEST_END;
+}
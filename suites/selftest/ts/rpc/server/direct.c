@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RPC Test Suite
+ *
+ * Remote calls over direct streams to RPC servers.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page direct Remote calls over direct streams
+ *
+ * @objective Check that blocking calls passed over direct streams to
+ *            RPC servers (bypassing RCF) return results and errors of
+ *            the called functions and that streams follow changes of
+ *            RPC servers.
+ *
+ * @param direct        Enable direct streams
+ * @param n_calls       Number of calls to measure the call rate
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME    "direct"
+
+#include "te_config.h"
+
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "tapi_test.h"
+#include "tapi_rpc.h"
+#include "tapi_rpc_unistd.h"
+#include "tapi_file.h"
+#include "te_time.h"
+
+/**
+ * Environment variable which enables direct streams to RPC servers.
+ * It is checked on the first call, so the test creates RPC servers
+ * itself instead of getting them from the environment.
+ */
+#define DIRECT_ENV      "TE_RCF_RPC_DIRECT"
+
+int
+main(int argc, char **argv)
+{
+    te_bool             direct;
+    unsigned int        n_calls;
+    char                ta[RCF_MAX_NAME];
+    size_t              len = sizeof(ta);
+    rcf_rpc_server     *pco = NULL;
+    rcf_rpc_server     *pco_child = NULL;
+    char               *path = NULL;
+    struct timeval      tv_start;
+    struct timeval      tv_end;
+    struct timeval      tv_diff;
+    pid_t               pid;
+    pid_t               child_pid;
+    unsigned int        i;
+
+    TEST_START;
+    TEST_GET_BOOL_PARAM(direct);
+    TEST_GET_UINT_PARAM(n_calls);
+
+    TEST_STEP("Enable direct streams to RPC servers if @p direct is "
+              "@c TRUE and create RPC server on the first Test Agent.");
+    CHECK_RC(setenv(DIRECT_ENV, direct ? "yes" : "no", 1));
+    CHECK_RC(rcf_get_ta_list(ta, &len));
+    CHECK_RC(rcf_rpc_server_create(ta, "pco_direct", &pco));
+
+    TEST_STEP("Call getpid() @p n_calls times and check that the same "
+              "process answers all calls.");
+    pid = rpc_getpid(pco);
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < n_calls; i++)
+    {
+        if (rpc_getpid(pco) != pid)
+            TEST_VERDICT("getpid() returned another process ID");
+    }
+    gettimeofday(&tv_end, NULL);
+    te_timersub(&tv_end, &tv_start, &tv_diff);
+    RING("%u calls %s direct stream took %ld.%06ld seconds",
+         n_calls, direct ? "over" : "without", (long)tv_diff.tv_sec,
+         (long)tv_diff.tv_usec);
+
+    TEST_STEP("Call access() of a missing file and check that the failure "
+              "and errno are reported.");
+    path = tapi_file_make_name(NULL);
+    RPC_AWAIT_ERROR(pco);
+    if (rpc_access(pco, path, RPC_F_OK) != -1)
+        TEST_VERDICT("access() of a missing file succeeded");
+    if (RPC_ERRNO(pco) != RPC_ENOENT)
+    {
+        TEST_VERDICT("access() of a missing file failed with %r instead "
+                     "of ENOENT", RPC_ERRNO(pco));
+    }
+
+    TEST_STEP("Fork RPC server, check that its child answers calls and "
+              "destroy it.");
+    CHECK_RC(rcf_rpc_server_fork(pco, "pco_direct_child", &pco_child));
+    child_pid = rpc_getpid(pco_child);
+    if (child_pid == pid)
+        TEST_VERDICT("Forked RPC server is answered by its parent");
+    CHECK_RC(rcf_rpc_server_destroy(pco_child));
+    pco_child = NULL;
+    if (rpc_getpid(pco) != pid)
+        TEST_VERDICT("RPC server is changed by destroying its child");
+
+    TEST_STEP("Restart RPC server and check that calls are answered by "
+              "the new process.");
+    CHECK_RC(rcf_rpc_server_restart(pco));
+    if (rpc_getpid(pco) == pid)
+        TEST_VERDICT("Calls are answered by the process before restart");
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (pco_child != NULL)
+        CLEANUP_CHECK_RC(rcf_rpc_server_destroy(pco_child));
+    if (pco != NULL)
+        CLEANUP_CHECK_RC(rcf_rpc_server_destroy(pco));
+    unsetenv(DIRECT_ENV);
+    free(path);
+
+    TEST_END;
+}
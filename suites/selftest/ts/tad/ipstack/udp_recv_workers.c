@@ -0,0 +1,257 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment
+ *
+ * Check receive of UDP/IP4/ETH CSAP by a number of workers
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page ipstack-udp_recv_workers Receive UDP/IP4 datagrams via udp.ip4.eth CSAP by a number of workers
+ *
+ * @objective Check that udp.ip4.eth CSAP receiving by a number of
+ *            workers over fan-out receive queues reports all datagrams
+ *            and keeps order of datagrams of each flow.
+ *
+ * @param host_csap     TA with CSAP
+ * @param pco           TA with UDP sockets
+ * @param csap_addr     CSAP local IPv4 address
+ * @param sock_addr     CSAP remote IPv4 address
+ * @param csap_hwaddr   CSAP local MAC address
+ * @param sock_hwaddr   CSAP remote MAC address
+ * @param workers       Number of receive workers of the CSAP
+ *                      (@c 1 to receive by the Receiver thread)
+ * @param fanout        Mode of spreading packets over workers:
+ *                      - hash
+ *                      - cpu
+ * @param n_flows       Number of flows (UDP sockets)
+ * @param n_packets     Number of datagrams sent by each socket
+ *
+ * @par Scenario:
+ *
+ * -# Create udp.ip4.eth CSAP on @p host_csap with @p workers receive
+ *    workers and @p fanout mode and start receiving.
+ * -# Create @p n_flows UDP sockets on @p pco bound to different ports.
+ * -# Send @p n_packets datagrams with sequence numbers from each socket
+ *    interleaving sockets.
+ * -# Stop receiving and check that all datagrams are received and
+ *    sequence numbers of each flow are increasing.
+ * -# Destroy CSAP and close sockets.
+ *
+ */
+
+#ifndef DOXYGEN_TEST_SPEC
+
+#define TE_TEST_NAME    "ipstack/udp_recv_workers"
+
+#define TEST_START_VARS         TEST_START_ENV_VARS
+#define TEST_START_SPECIFIC     TEST_START_ENV
+#define TEST_END_SPECIFIC       TEST_END_ENV
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "tad_common.h"
+#include "rcf_rpc.h"
+#include "asn_usr.h"
+#include "ndn_eth.h"
+#include "ndn_ipstack.h"
+#include "tapi_ndn.h"
+#include "tapi_eth.h"
+#include "tapi_ip4.h"
+#include "tapi_udp.h"
+#include "tapi_env.h"
+#include "tapi_mem.h"
+#include "tapi_rpcsock_macros.h"
+#include "tapi_test.h"
+#include "tapi_sockaddr.h"
+
+/** Mapping of fan-out modes for TEST_GET_ENUM_PARAM() */
+#define FANOUT_MAPPING_LIST \
+    { "hash", TAD_RECV_FANOUT_HASH }, \
+    { "cpu",  TAD_RECV_FANOUT_CPU }
+
+/** Received flow */
+typedef struct recv_flow {
+    uint16_t        port;       /**< Source port in host byte order */
+    unsigned int    received;   /**< Number of received datagrams */
+    unsigned int    reordered;  /**< Number of datagrams received out
+                                     of order */
+} recv_flow;
+
+/** Data of the callback processing received datagrams */
+typedef struct recv_data {
+    recv_flow      *flows;      /**< Flows */
+    unsigned int    n_flows;    /**< Number of flows */
+} recv_data;
+
+/**
+ * Account received datagram in its flow.
+ *
+ * @param pkt       Received datagram
+ * @param userdata  Data of the callback (recv_data)
+ */
+static void
+recv_dgram_cb(const udp4_datagram *pkt, void *userdata)
+{
+    recv_data      *data = userdata;
+    recv_flow      *flow;
+    uint32_t        seq;
+    unsigned int    i;
+
+    for (i = 0; i < data->n_flows; i++)
+    {
+        if (data->flows[i].port == pkt->src_port)
+            break;
+    }
+    if (i == data->n_flows || pkt->payload_len != sizeof(seq))
+        return;
+
+    flow = &data->flows[i];
+    memcpy(&seq, pkt->payload, sizeof(seq));
+    if (ntohl(seq) != flow->received + flow->reordered)
+        flow->reordered++;
+    else
+        flow->received++;
+}
+
+int
+main(int argc, char *argv[])
+{
+    tapi_env_host              *host_csap = NULL;
+    rcf_rpc_server             *pco = NULL;
+    rcf_rpc_server             *pco_a = NULL;
+    const struct sockaddr      *csap_addr;
+    const struct sockaddr      *sock_addr;
+    const struct sockaddr      *csap_hwaddr;
+    const struct sockaddr      *sock_hwaddr;
+    const struct if_nameindex  *csap_if;
+    int                         workers;
+    int                         fanout;
+    unsigned int                n_flows;
+    unsigned int                n_packets;
+
+    csap_handle_t               csap = CSAP_INVALID_HANDLE;
+    asn_value                  *csap_spec = NULL;
+    int                        *socks = NULL;
+    recv_data                   data = { NULL, 0 };
+    struct sockaddr_storage     addr;
+    socklen_t                   addr_len;
+    unsigned int                num;
+    unsigned int                i;
+    unsigned int                j;
+
+    TEST_START;
+
+    TEST_GET_HOST(host_csap);
+    TEST_GET_PCO(pco);
+    TEST_GET_PCO(pco_a);
+    TEST_GET_ADDR(pco_a, csap_addr);
+    TEST_GET_ADDR(pco, sock_addr);
+    TEST_GET_LINK_ADDR(csap_hwaddr);
+    TEST_GET_LINK_ADDR(sock_hwaddr);
+    TEST_GET_IF(csap_if);
+    TEST_GET_INT_PARAM(workers);
+    TEST_GET_ENUM_PARAM(fanout, FANOUT_MAPPING_LIST);
+    TEST_GET_UINT_PARAM(n_flows);
+    TEST_GET_UINT_PARAM(n_packets);
+
+    socks = tapi_calloc(n_flows, sizeof(*socks));
+    for (i = 0; i < n_flows; i++)
+        socks[i] = -1;
+    data.flows = tapi_calloc(n_flows, sizeof(*data.flows));
+
+    TEST_STEP("Create udp.ip4.eth CSAP with @p workers receive workers "
+              "and @p fanout mode.");
+    CHECK_RC(tapi_udp_add_csap_layer(&csap_spec, -1, -1));
+    CHECK_RC(tapi_ip4_add_csap_layer(&csap_spec,
+                                     SIN(csap_addr)->sin_addr.s_addr,
+                                     SIN(sock_addr)->sin_addr.s_addr,
+                                     -1, -1, -1));
+    CHECK_RC(tapi_eth_add_csap_layer(&csap_spec, csap_if->if_name,
+                                     TAD_ETH_RECV_DEF,
+                                     (const uint8_t *)sock_hwaddr->sa_data,
+                                     (const uint8_t *)csap_hwaddr->sa_data,
+                                     NULL, TE_BOOL3_ANY, TE_BOOL3_ANY));
+    CHECK_RC(asn_write_int32(csap_spec, workers, "params.receive-workers"));
+    CHECK_RC(asn_write_int32(csap_spec, fanout, "params.receive-fanout"));
+    CHECK_RC(tapi_tad_csap_create(host_csap->ta, 0, "udp.ip4.eth",
+                                  csap_spec, &csap));
+
+    TEST_STEP("Start receiving of UDP datagrams.");
+    CHECK_RC(tapi_udp_ip4_eth_recv_start(host_csap->ta, 0, csap,
+                                         RCF_TRRECV_PACKETS));
+
+    TEST_STEP("Create @p n_flows UDP sockets bound to different ports.");
+    for (i = 0; i < n_flows; i++)
+    {
+        tapi_sockaddr_clone_exact(sock_addr, &addr);
+        te_sockaddr_set_port(SA(&addr), 0);
+
+        socks[i] = rpc_socket(pco, RPC_PF_INET, RPC_SOCK_DGRAM,
+                              RPC_IPPROTO_UDP);
+        rpc_bind(pco, socks[i], SA(&addr));
+
+        addr_len = sizeof(addr);
+        rpc_getsockname(pco, socks[i], SA(&addr), &addr_len);
+        data.flows[i].port = ntohs(te_sockaddr_get_port(SA(&addr)));
+    }
+    data.n_flows = n_flows;
+
+    TEST_STEP("Send @p n_packets datagrams with sequence numbers from "
+              "each socket interleaving sockets.");
+    for (j = 0; j < n_packets; j++)
+    {
+        uint32_t seq = htonl(j);
+
+        for (i = 0; i < n_flows; i++)
+        {
+            if (rpc_sendto(pco, socks[i], &seq, sizeof(seq), 0,
+                           csap_addr) != sizeof(seq))
+                TEST_FAIL("Failed to send a datagram");
+        }
+    }
+
+    TEST_STEP("Stop receiving and check that all datagrams are received "
+              "and datagrams of each flow are in order.");
+    MSLEEP(500);
+    CHECK_RC(tapi_tad_trrecv_stop(host_csap->ta, 0, csap,
+                                  tapi_udp_ip4_eth_trrecv_cb_data(
+                                      recv_dgram_cb, &data),
+                                  &num));
+
+    for (i = 0; i < n_flows; i++)
+    {
+        RING("Flow %u: %u datagrams received in order, %u reordered",
+             i, data.flows[i].received, data.flows[i].reordered);
+        if (data.flows[i].reordered != 0)
+            TEST_VERDICT("Datagrams of a flow are reordered");
+        if (data.flows[i].received != n_packets)
+            TEST_VERDICT("Not all datagrams of a flow are received");
+    }
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    if (socks != NULL)
+    {
+        for (i = 0; i < n_flows; i++)
+            CLEANUP_RPC_CLOSE(pco, socks[i]);
+    }
+
+    asn_free_value(csap_spec);
+
+    if (host_csap != NULL)
+        CLEANUP_CHECK_RC(tapi_tad_csap_destroy(host_csap->ta, 0, csap));
+
+    free(socks);
+    free(data.flows);
+
+    TEST_END;
+}
+
+#endif /* !DOXYGEN_TEST_SPEC */
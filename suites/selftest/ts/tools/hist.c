@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2022 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Test for te_hist.h functions
+ *
+ * Testing log-linear histograms
+ */
+
+/** @page tools_hist te_hist.h test
+ *
+ * @objective Check that histograms report percentiles with bounded
+ *            relative error.
+ *
+ * Fill a histogram with random values of random magnitude, sort the
+ * same values and compare percentiles reported by the histogram with
+ * exact ones.
+ *
+ * @param n_values      Number of values
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "tools/hist"
+
+#include "te_config.h"
+
+#include "tapi_test.h"
+#include "tapi_mem.h"
+#include "te_hist.h"
+
+/** Percentiles to check */
+static const double percentiles[] = { 1, 10, 50, 90, 99, 99.9 };
+
+static int
+compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned int n_values;
+    unsigned int i;
+    uint64_t *values = NULL;
+    te_hist hist;
+    te_hist half1;
+    te_hist half2;
+    te_string summary = TE_STRING_INIT;
+
+    TEST_START;
+
+    TEST_GET_UINT_PARAM(n_values);
+
+    values = tapi_calloc(n_values, sizeof(*values));
+
+    TEST_STEP("Fill histograms with random values of random magnitude");
+    te_hist_init(&hist);
+    te_hist_init(&half1);
+    te_hist_init(&half2);
+    for (i = 0; i < n_values; i++)
+    {
+        unsigned int bits = rand_range(0, TE_HIST_MAX_BITS - 1);
+
+        values[i] = (((uint64_t)rand_range(0, INT_MAX) << 31) |
+                     rand_range(0, INT_MAX)) & ((1ULL << bits) - 1);
+        te_hist_add(&hist, values[i]);
+        te_hist_add(i % 2 == 0 ? &half1 : &half2, values[i]);
+    }
+    qsort(values, n_values, sizeof(*values), compare_u64);
+
+    TEST_STEP("Check minimum and maximum");
+    if (hist.count != n_values || hist.min != values[0] ||
+        hist.max != values[n_values - 1])
+        TEST_VERDICT("Wrong number of values, minimum or maximum");
+
+    TEST_STEP("Check that percentiles are within relative error");
+    for (i = 0; i < TE_ARRAY_LEN(percentiles); i++)
+    {
+        size_t rank = (size_t)(percentiles[i] * n_values / 100);
+        uint64_t exp;
+        uint64_t got = te_hist_percentile(&hist, percentiles[i]);
+
+        if ((double)rank * 100 < percentiles[i] * n_values)
+            rank++;
+        exp = values[rank == 0 ? 0 : rank - 1];
+
+        if (got < exp || got - exp > exp >> TE_HIST_SUB_BITS)
+        {
+            ERROR("p%g is %" PRIu64 " instead of %" PRIu64,
+                  percentiles[i], got, exp);
+            TEST_VERDICT("Percentile is out of the error bounds");
+        }
+    }
+
+    TEST_STEP("Check that merged halves are the same as the whole");
+    te_hist_merge(&half1, &half2);
+    if (memcmp(&half1, &hist, sizeof(hist)) != 0)
+        TEST_VERDICT("Merged histogram differs");
+
+    CHECK_RC(te_hist_summary(&hist, &summary));
+    RING("Histogram: %s", summary.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+    te_string_free(&summary);
+    free(values);
+
+    TEST_END;
+}
@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2022 OKTET Labs. All rights reserved. */
+/** @file
+ * @brief Test for SIMD kernels.
+ *
+ * Testing SIMD kernels against scalar code.
+ */
+
+/** @page tools_simd SIMD kernels test
+ *
+ * @objective Check that SIMD kernels give the same results as scalar code.
+ *
+ * Test te_simd_csum_part() and te_simd_match_mask() with every
+ * instruction set extension supported by the host on random data of
+ * random length and alignment.
+ *
+ * @param n_iterations  Number of random buffers per extension
+ * @param max_len       Maximum length of a buffer
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "tools/simd"
+
+#include "te_config.h"
+
+#include "tapi_test.h"
+#include "tapi_mem.h"
+#include "te_bufs.h"
+#include "te_simd.h"
+#include "tad_common.h"
+
+/** Maximum offset of data in a buffer to check unaligned access */
+#define MAX_OFFSET  31
+
+/** Names of instruction set extensions */
+static const char *level_names[] = {
+    [TE_SIMD_SCALAR] = "scalar",
+    [TE_SIMD_SSE42] = "SSE4.2",
+    [TE_SIMD_AVX2] = "AVX2",
+};
+
+/* Compare data by mask byte by byte */
+static te_bool
+match_mask_ref(const uint8_t *data, const uint8_t *mask,
+               const uint8_t *value, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((data[i] & mask[i]) != (value[i] & mask[i]))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned int n_iterations;
+    unsigned int max_len;
+    unsigned int i;
+    te_simd_level supported = te_simd_level_supported();
+    te_simd_level level;
+    uint8_t *data = NULL;
+    uint8_t *mask = NULL;
+    uint8_t *value = NULL;
+
+    TEST_START;
+
+    TEST_GET_UINT_PARAM(n_iterations);
+    TEST_GET_UINT_PARAM(max_len);
+
+    RING("Supported instruction set extension: %s",
+         level_names[supported]);
+
+    mask = tapi_malloc(max_len + MAX_OFFSET);
+    value = tapi_malloc(max_len + MAX_OFFSET);
+
+    for (level = TE_SIMD_SCALAR; level <= supported; level++)
+    {
+        TEST_STEP("Check %s kernels", level_names[level]);
+        if (te_simd_set_level(level) != level ||
+            te_simd_get_level() != level)
+            TEST_VERDICT("Failed to choose supported kernels");
+
+        for (i = 0; i < n_iterations; i++)
+        {
+            size_t len = rand_range(0, max_len);
+            size_t off = rand_range(0, MAX_OFFSET);
+            uint32_t start = rand_range(0, UINT16_MAX);
+            uint16_t exp;
+            uint16_t got;
+            te_bool exp_match;
+
+            free(data);
+            data = te_make_buf_by_len(len + MAX_OFFSET);
+
+            exp = ip_csum_part(start, data + off, len);
+            got = te_simd_csum_part(start, data + off, len);
+            if (got != exp)
+            {
+                ERROR("Checksum of %zu bytes at offset %zu: "
+                      "0x%04x instead of 0x%04x", len, off, got, exp);
+                TEST_VERDICT("%s checksum differs from scalar one",
+                             level_names[level]);
+            }
+
+            te_fill_buf(mask, len + MAX_OFFSET);
+            memcpy(value, data, len + MAX_OFFSET);
+            if (len > 0 && rand_range(0, 1) == 1)
+                value[off + rand_range(0, len - 1)] ^= 1 << rand_range(0, 7);
+
+            exp_match = match_mask_ref(data + off, mask + off, value + off,
+                                       len);
+            if (te_simd_match_mask(data + off, mask + off, value + off,
+                                   len) != exp_match)
+            {
+                ERROR("Comparison of %zu bytes at offset %zu: "
+                      "match is expected %s", len, off,
+                      exp_match ? "TRUE" : "FALSE");
+                TEST_VERDICT("%s masked comparison differs from scalar one",
+                             level_names[level]);
+            }
+        }
+    }
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    te_simd_set_level(supported);
+    free(data);
+    free(mask);
+    free(value);
+    TEST_END;
+}